@@ -1,3 +1,6 @@
+import org.gradle.process.ExecOperations
+import javax.inject.Inject
+
 plugins {
     alias(libs.plugins.android.application)
     alias(libs.plugins.kotlin.android)
@@ -53,4 +56,101 @@ dependencies {
     testImplementation(libs.junit)
     androidTestImplementation(libs.androidx.junit)
     androidTestImplementation(libs.androidx.espresso.core)
-}
\ No newline at end of file
+}
+
+// ============================================
+// Shaders
+// ============================================
+// 滤镜的 GLSL 在 src/src/main/assets/shaders 下（与加载它们的 Kotlin / native 代码同一棵树），
+// 构建时用 NDK 自带的 glslc 编译成 SPIR-V（affine.frag -> shaders/affine_frag.spv），
+// 输出目录作为生成的 assets 目录打包；.spv 必须由 glslc 生成，不能手写或手改。
+// 找得到 spirv-val（Vulkan SDK：PATH 或 $VULKAN_SDK/bin）时逐个校验，校验失败则构建失败。
+// 桌面上 cmake -S src/src/main/cpp 用同一份列表编译和校验（bench/CMakeLists.txt 的 vkfilter_shaders）。
+// src/src/main 目前不是本模块的 source set，那棵树直接从自己的 assets/shaders 加载，
+// 其中 affine_frag.spv / b_frag.spv 是 glslc 编译的基线版本（不含特化常量，行为等于默认值）。
+val shaderSourceDir = "src/src/main/assets/shaders"
+val compiledShaders = mapOf(
+    // 源文件（shaderSourceDir 下）到 glslc --target-env
+    "affine.frag" to "vulkan1.0",
+    "affine.comp" to "vulkan1.0",
+    "b.frag" to "vulkan1.0",
+    // bindless 路径只在 Vulkan 1.1 + descriptor indexing 的设备上使用；回退路径要能在 1.0 设备上加载
+    "composite.frag" to "vulkan1.1",
+    "composite_single.frag" to "vulkan1.0",
+    "scale.comp" to "vulkan1.0",
+)
+
+abstract class CompileShadersTask : DefaultTask() {
+    @get:InputFiles
+    @get:PathSensitive(PathSensitivity.RELATIVE)
+    abstract val sources: ConfigurableFileCollection
+
+    // 源文件名 -> --target-env
+    @get:Input
+    abstract val targetEnvs: MapProperty<String, String>
+
+    @get:Input
+    abstract val glslc: Property<String>
+
+    @get:Input
+    @get:Optional
+    abstract val spirvVal: Property<String>
+
+    @get:OutputDirectory
+    abstract val outputDir: DirectoryProperty
+
+    @get:Inject
+    abstract val execOperations: ExecOperations
+
+    @TaskAction
+    fun compile() {
+        val shaderDir = outputDir.get().dir("shaders").asFile
+        shaderDir.deleteRecursively()
+        shaderDir.mkdirs()
+        if (!spirvVal.isPresent) {
+            logger.warn("spirv-val not found (Vulkan SDK), shaders are compiled without validation")
+        }
+        for (source in sources.files.sortedBy { it.name }) {
+            val targetEnv = targetEnvs.get().getValue(source.name)
+            val output = File(shaderDir, source.name.replace('.', '_') + ".spv")
+            execOperations.exec {
+                commandLine(glslc.get(), "--target-env=$targetEnv", "-o", output.absolutePath, source.absolutePath)
+            }
+            if (spirvVal.isPresent) {
+                execOperations.exec {
+                    commandLine(spirvVal.get(), "--target-env", targetEnv, output.absolutePath)
+                }
+            }
+        }
+    }
+}
+
+fun executableName(name: String): String =
+    if (System.getProperty("os.name").startsWith("Windows")) "$name.exe" else name
+
+// NDK 的 shader-tools/<host>/glslc；找不到时退回 PATH 中的 glslc
+fun findGlslc(): String {
+    val hosts = android.ndkDirectory.resolve("shader-tools").listFiles().orEmpty()
+    return hosts.map { it.resolve(executableName("glslc")) }.firstOrNull { it.canExecute() }?.absolutePath
+        ?: executableName("glslc")
+}
+
+fun findSpirvVal(): String? {
+    val dirs = listOfNotNull(System.getenv("VULKAN_SDK")?.let { File(it, "bin") }) +
+            System.getenv("PATH").orEmpty().split(File.pathSeparator).filter { it.isNotEmpty() }.map(::File)
+    return dirs.map { it.resolve(executableName("spirv-val")) }.firstOrNull { it.canExecute() }?.absolutePath
+}
+
+val compileShaders = tasks.register<CompileShadersTask>("compileShaders") {
+    sources.from(compiledShaders.keys.map { file("$shaderSourceDir/$it") })
+    targetEnvs.set(compiledShaders)
+    glslc.set(providers.provider { findGlslc() })
+    spirvVal.set(providers.provider { findSpirvVal() })
+    outputDir.set(layout.buildDirectory.dir("generated/shaderAssets"))
+}
+
+androidComponents {
+    onVariants { variant ->
+        variant.sources.assets?.addGeneratedSourceDirectory(compileShaders, CompileShadersTask::outputDir)
+    }
+}
@@ -9,11 +9,16 @@ layout(location = 0) out vec4 outColor;
 // 采样器：绑定到描述符集
 layout(set = 0, binding = 0) uniform sampler2D texSampler;
 
+// 特化常量：变换后的纹理坐标不可能超出 [0, 1] 时（如恒等变换、放大裁剪），
+// 滤镜以 false 创建 pipeline，驱动直接去掉下面的边界检查分支
+layout(constant_id = 0) const bool CLIP_OUT_OF_RANGE = true;
+
 void main() {
     // 检查纹理坐标是否在有效范围内 [0, 1]
     // 超出范围的像素显示为透明黑色（实现裁剪效果）
-    if (fragTexCoord.x < 0.0 || fragTexCoord.x > 1.0 ||
-        fragTexCoord.y < 0.0 || fragTexCoord.y > 1.0) {
+    if (CLIP_OUT_OF_RANGE &&
+        (fragTexCoord.x < 0.0 || fragTexCoord.x > 1.0 ||
+         fragTexCoord.y < 0.0 || fragTexCoord.y > 1.0)) {
         outColor = vec4(0.0, 0.0, 0.0, 0.0);  // 透明
         return;
     }
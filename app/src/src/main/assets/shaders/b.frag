@@ -11,13 +11,14 @@ layout(push_constant) uniform PushConstants {
     float _padding;
 } pc;
 
-// ========== 配置选项 ==========
-// 取消注释以显示平铺效果
-// #define SHOW_TILING
+// ========== 特化常量 ==========
+// 创建 pipeline 时通过 VkSpecializationInfo 指定，驱动按常量值编译（循环展开、分支消除），
+// 不同画质档位不需要额外的 SPIR-V
+layout(constant_id = 0) const int MAX_ITER = 5;          // 湍流迭代次数（画质档位）
+layout(constant_id = 1) const bool SHOW_TILING = false;  // 显示平铺效果
 
 // ========== 常量定义 ==========
 #define TAU 6.28318530718
-#define MAX_ITER 5
 
 // ========== 主函数 ==========
 void main()
@@ -27,11 +28,8 @@ void main()
     // 🔥 fragCoord 是像素坐标，需要除以分辨率得到 0-1 的 UV
     vec2 uv = fragCoord / pc.iResolution.xy;
 
-#ifdef SHOW_TILING
-    vec2 p = mod(uv * TAU * 2.0, TAU) - 250.0;
-#else
-    vec2 p = mod(uv * TAU, TAU) - 250.0;
-#endif
+    float tiles = SHOW_TILING ? 2.0 : 1.0;
+    vec2 p = mod(uv * TAU * tiles, TAU) - 250.0;
 
     vec2 i = vec2(p);
     float c = 1.0;
@@ -56,19 +54,19 @@ void main()
     vec3 colour = vec3(pow(abs(c), 8.0));
     colour = clamp(colour + vec3(0.0, 0.35, 0.5), 0.0, 1.0);
 
-#ifdef SHOW_TILING
-    // 闪烁瓷砖边框
-    vec2 pixel = 2.0 / pc.iResolution.xy;
-    uv *= 2.0;
-    float f = floor(mod(pc.iTime * 0.5, 2.0));     // 闪烁值
-    vec2 first = step(pixel, uv) * f;              // 排除首屏像素并闪烁
-    uv = step(fract(uv), pixel);                   // 每个瓷砖添加一行像素
-    colour = mix(
-        colour,
-        vec3(1.0, 1.0, 0.0),
-        (uv.x + uv.y) * first.x * first.y
-    ); // 黄色线条
-#endif
+    if (SHOW_TILING) {
+        // 闪烁瓷砖边框
+        vec2 pixel = 2.0 / pc.iResolution.xy;
+        uv *= 2.0;
+        float f = floor(mod(pc.iTime * 0.5, 2.0));     // 闪烁值
+        vec2 first = step(pixel, uv) * f;              // 排除首屏像素并闪烁
+        uv = step(fract(uv), pixel);                   // 每个瓷砖添加一行像素
+        colour = mix(
+            colour,
+            vec3(1.0, 1.0, 0.0),
+            (uv.x + uv.y) * first.x * first.y
+        ); // 黄色线条
+    }
 
     fragColor = vec4(colour, 1.0);
 }
@@ -0,0 +1,27 @@
+#version 450
+#extension GL_EXT_nonuniform_qualifier : require
+
+// 多源合成（CompositeVulkanFilter）的 bindless 路径，顶点着色器复用 affine.vert：
+// fragTexCoord = tex_matrix * user_matrix * 输出 uv，user_matrix 把输出映射到本层的 [0, 1]
+layout(location = 0) in vec2 fragTexCoord;
+
+layout(location = 0) out vec4 outColor;
+
+// 设备级纹理表（Vulkanbindless.h）：每个输入纹理占一个固定槽位，未使用的槽位可以为空
+layout(set = 0, binding = 0) uniform sampler2D sources[];
+
+// 前 128 字节是 affine.vert 的两个矩阵
+layout(push_constant) uniform PushConstants {
+    layout(offset = 128) int source;  // 本层的槽位
+} pc;
+
+void main() {
+    // 层外的像素保留下面各层的结果
+    if (fragTexCoord.x < 0.0 || fragTexCoord.x > 1.0 ||
+        fragTexCoord.y < 0.0 || fragTexCoord.y > 1.0) {
+        discard;
+    }
+
+    // 槽位来自 push constant，整个 draw 内一致，不需要 nonuniformEXT
+    outColor = texture(sources[pc.source], fragTexCoord);
+}
\ No newline at end of file
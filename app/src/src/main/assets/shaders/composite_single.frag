@@ -0,0 +1,19 @@
+#version 450
+
+// 多源合成（CompositeVulkanFilter）在不支持 descriptor indexing 的设备上的回退：
+// 每层绑定自己的 descriptor set，其余与 composite.frag 相同
+layout(location = 0) in vec2 fragTexCoord;
+
+layout(location = 0) out vec4 outColor;
+
+layout(set = 0, binding = 0) uniform sampler2D texSampler;
+
+void main() {
+    // 层外的像素保留下面各层的结果
+    if (fragTexCoord.x < 0.0 || fragTexCoord.x > 1.0 ||
+        fragTexCoord.y < 0.0 || fragTexCoord.y > 1.0) {
+        discard;
+    }
+
+    outColor = texture(texSampler, fragTexCoord);
+}
\ No newline at end of file
@@ -8,44 +8,32 @@
 #include <android/log.h>
 #include <set>
 #include <sstream>
+#include <cstring>
+#include "Vulkantypes.h"
+#include "Vulkandamage.h"
+#include "Vulkanpipelineregistry.h"
+#include "Vulkanpipelinecompiler.h"
+#include "Vulkanlayoutcache.h"
+#include "Vulkanrendering.h"
+#include "Vulkancompute.h"
+#include "Vulkanbarriers.h"
+#include "Vulkanmips.h"
+#include "Vulkandescriptors.h"
+#include "Vulkansamplers.h"
+#include "Vulkanbindless.h"
+#include "Vulkanprofiler.h"
+#include "Vulkantracegpu.h"
+#include "Vulkanframestats.h"
+#include "Vulkanshaderstats.h"
+#include "Vulkanlog.h"
 #define LOG_TAG "VulkanRenderer"
-#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
-#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+#define LOGI(...) VLOGI(LOG_TAG, __VA_ARGS__)
+#define LOGE(...) VLOGE(LOG_TAG, __VA_ARGS__)
+#define LOGD(...) VLOGD(LOG_TAG, __VA_ARGS__)
 
 extern uint32_t findMemoryType(VkPhysicalDevice physicalDevice, uint32_t typeFilter, VkMemoryPropertyFlags properties);
 extern uint32_t findQueueFamily(VkPhysicalDevice physicalDevice, VkQueueFlags flags, VkSurfaceKHR surface);
 
-// 结构体定义
-struct SwapchainInfo {
-    VkSwapchainKHR swapchain;
-    std::vector<VkImage> images;
-    std::vector<VkImageView> imageViews;
-    std::vector<VkFramebuffer> framebuffers;
-    VkSurfaceFormatKHR format;
-    VkExtent2D extent;
-};
-
-// 设备详情
-struct DeviceInfo {
-    VkDevice device;
-    VkPhysicalDevice physicalDevice;
-    VkQueue graphicsQueue;
-    VkQueue presentQueue;
-    uint32_t graphicsQueueFamily;
-    uint32_t presentQueueFamily;
-    VkSurfaceKHR surface;
-};
-
-// 辅助结构体：保存纹理的完整信息
-struct TextureInfo {
-    VkImage image;
-    VkDeviceMemory memory;
-    VkImageView imageView;
-    VkSampler sampler;
-    uint32_t width;
-    uint32_t height;
-};
-
 // 全局变量存储
 static std::vector<const char*> instanceExtensions = {
         VK_KHR_SURFACE_EXTENSION_NAME,
@@ -56,6 +44,39 @@ static std::vector<const char*> deviceExtensions = {
         VK_KHR_SWAPCHAIN_EXTENSION_NAME
 };
 
+// 录制整张纹理的上传：覆盖前等待之前的采样（旧内容直接丢弃，与纹理当前的布局无关），
+// 写入后对片段/计算着色器的采样可见。barrier 由跟踪的状态生成（见 Vulkanbarriers.h）。
+// 纹理带 mip 链时（mipLevels > 1）写入第 0 级后逐级重新生成（见 Vulkanmips.h）
+static void recordTextureUpload(DeviceInfo* deviceInfo, VkCommandBuffer commandBuffer,
+                                VkBuffer stagingBuffer, VkImage image, uint32_t width, uint32_t height,
+                                uint32_t mipLevels = 1) {
+    ImageBarrierBatch barriers;
+    requireImageUse(deviceInfo, &barriers, image, ImageUses::kCopyDst, true);
+    flushImageBarriers(deviceInfo, &barriers, commandBuffer);
+
+    VkBufferImageCopy region{};
+    region.bufferOffset = 0;
+    region.bufferRowLength = 0;
+    region.bufferImageHeight = 0;
+    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    region.imageSubresource.mipLevel = 0;
+    region.imageSubresource.baseArrayLayer = 0;
+    region.imageSubresource.layerCount = 1;
+    region.imageOffset = {0, 0, 0};
+    region.imageExtent = {width, height, 1};
+
+    checkImageCommand(deviceInfo, image, ImageUses::kCopyDst, "vkCmdCopyBufferToImage");
+    vkCmdCopyBufferToImage(commandBuffer, stagingBuffer, image,
+                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+    if (mipLevels > 1) {
+        recordMipGeneration(deviceInfo, commandBuffer, image, {width, height}, mipLevels);
+        return;
+    }
+    requireImageUse(deviceInfo, &barriers, image, ImageUses::kSampled);
+    flushImageBarriers(deviceInfo, &barriers, commandBuffer);
+}
+
 
 extern "C" JNIEXPORT jboolean JNICALL
 Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeCreateFramebuffers(
@@ -122,23 +143,21 @@ Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeCreateFramebuffers(
 
 
 // 3. 创建RenderPass
-extern "C" JNIEXPORT jlong JNICALL
-Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeCreateRenderPass(
-        JNIEnv* env, jobject /* this */, jlong deviceHandle) {
-
-    DeviceInfo* deviceInfo = reinterpret_cast<DeviceInfo*>(deviceHandle);
-
-    LOGI("=== Creating RenderPass ===");
+// loadOp = CLEAR: 整帧重绘；loadOp = LOAD: 增量重绘，保留图像上次呈现的内容（只画脏矩形）。
+// 两者只有 loadOp/initialLayout 不同，属于兼容的 render pass，可以共用 framebuffer 和 pipeline。
+static VkRenderPass createRenderPass(DeviceInfo* deviceInfo, VkAttachmentLoadOp loadOp) {
+    const bool load = loadOp == VK_ATTACHMENT_LOAD_OP_LOAD;
 
     // Color attachment
     VkAttachmentDescription colorAttachment{};
-    colorAttachment.format = VK_FORMAT_B8G8R8A8_UNORM;
+    colorAttachment.format = deviceInfo->colorFormat;  // 与交换链一致
     colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
-    colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    colorAttachment.loadOp = loadOp;
     colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;  // 必须是 STORE！
     colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
     colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-    colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    // LOAD 时图像必须已经被渲染并呈现过一次
+    colorAttachment.initialLayout = load ? VK_IMAGE_LAYOUT_PRESENT_SRC_KHR : VK_IMAGE_LAYOUT_UNDEFINED;
     colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;  // 用于呈现
 
     LOGI("Color attachment: format=%d, samples=%d, loadOp=%d, storeOp=%d",
@@ -166,6 +185,9 @@ Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeCreateRenderPass(
     dependency.srcAccessMask = 0;
     dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
     dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    if (load) {
+        dependency.dstAccessMask |= VK_ACCESS_COLOR_ATTACHMENT_READ_BIT;
+    }
 
     // Create render pass
     VkRenderPassCreateInfo renderPassInfo{};
@@ -182,11 +204,33 @@ Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeCreateRenderPass(
 
     if (result != VK_SUCCESS) {
         LOGE("Failed to create render pass: %d", result);
-        return 0;
+        return VK_NULL_HANDLE;
     }
+    registerRenderPass(deviceInfo, renderPass, &renderPassInfo);
 
-    LOGI("✓ RenderPass created: %p", (void*)renderPass);
-    return reinterpret_cast<jlong>(renderPass);
+    LOGI("✓ RenderPass created: %p (loadOp=%s)", (void*)renderPass, load ? "LOAD" : "CLEAR");
+    return renderPass;
+}
+
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeCreateRenderPass(
+        JNIEnv* env, jobject /* this */, jlong deviceHandle) {
+
+    DeviceInfo* deviceInfo = reinterpret_cast<DeviceInfo*>(deviceHandle);
+
+    LOGI("=== Creating RenderPass ===");
+    return reinterpret_cast<jlong>(createRenderPass(deviceInfo, VK_ATTACHMENT_LOAD_OP_CLEAR));
+}
+
+// 3.1 创建增量重绘用的 RenderPass（loadOp = LOAD）
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeCreateLoadRenderPass(
+        JNIEnv* env, jobject /* this */, jlong deviceHandle) {
+
+    DeviceInfo* deviceInfo = reinterpret_cast<DeviceInfo*>(deviceHandle);
+
+    LOGI("=== Creating incremental RenderPass ===");
+    return reinterpret_cast<jlong>(createRenderPass(deviceInfo, VK_ATTACHMENT_LOAD_OP_LOAD));
 }
 
 // 4. 创建Swapchain
@@ -214,6 +258,14 @@ Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeCreateSwapchain(
         }
     }
 
+    // 计算滤镜输出：可能改选 R8G8B8A8 格式并添加 STORAGE / TRANSFER_DST 用途
+    VkImageUsageFlags imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+            selectComputeSwapchainUsage(deviceInfo, capabilities, formats, &surfaceFormat);
+    // 轴对齐变换直接 copy/blit 到交换链图像（见 Vulkantransfer.h）
+    if ((capabilities.supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_DST_BIT) != 0) {
+        imageUsage |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+    }
+
     // 选择present mode
     VkPresentModeKHR presentMode = VK_PRESENT_MODE_FIFO_KHR;
 
@@ -237,7 +289,7 @@ Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeCreateSwapchain(
     createInfo.imageColorSpace = surfaceFormat.colorSpace;       // 颜色空间
     createInfo.imageExtent = extent;                             // 图像尺寸(宽高)
     createInfo.imageArrayLayers = 1;                             // 图层数(2D总是1)
-    createInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT; // 图像用途 作为颜色附件（可渲染）
+    createInfo.imageUsage = imageUsage;                          // 图像用途 作为颜色附件（可渲染）
 
     uint32_t queueFamilyIndices[] = {deviceInfo->graphicsQueueFamily, deviceInfo->presentQueueFamily};
 
@@ -298,6 +350,8 @@ Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeCreateSwapchain(
     swapchainInfo->imageViews = swapchainImageViews;
     swapchainInfo->format = surfaceFormat;
     swapchainInfo->extent = extent;
+    swapchainInfo->usage = imageUsage;
+    deviceInfo->colorFormat = surfaceFormat.format;
 
     LOGI("Swapchain created successfully with %d images", swapchainImageCount);
     return reinterpret_cast<jlong>(swapchainInfo);
@@ -405,7 +459,7 @@ Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeBeginRenderPass(
     VkRenderPass renderPass = reinterpret_cast<VkRenderPass>(renderPassHandle);
     SwapchainInfo* swapchainInfo = reinterpret_cast<SwapchainInfo*>(swapchainHandle);
 
-    LOGI("BeginRenderPass: imageIndex=%d, framebuffer count=%zu",
+    LOGD("BeginRenderPass: imageIndex=%d, framebuffer count=%zu",
          imageIndex, swapchainInfo->framebuffers.size());
 
     if (imageIndex < 0 || imageIndex >= swapchainInfo->framebuffers.size()) {
@@ -427,7 +481,7 @@ Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeBeginRenderPass(
 
     vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
 
-    LOGI("✓ Render pass begun with red clear color");
+    LOGD("✓ Render pass begun with red clear color");
     // 设置动态 viewport 和 scissor（重要！）
     VkViewport viewport{};
     viewport.x = 0.0f;
@@ -443,7 +497,7 @@ Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeBeginRenderPass(
     scissor.extent = swapchainInfo->extent;
     vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
 
-    LOGI("✓ Render pass begun: %dx%d",
+    LOGD("✓ Render pass begun: %dx%d",
          swapchainInfo->extent.width, swapchainInfo->extent.height);
 }
 
@@ -475,9 +529,9 @@ Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeSubmitCommandBuffer(
     DeviceInfo* deviceInfo = reinterpret_cast<DeviceInfo*>(deviceHandle);
     VkCommandBuffer commandBuffer = reinterpret_cast<VkCommandBuffer>(commandBufferHandle);
 
-    LOGI("=== Submitting Command Buffer ===");
-    LOGI("CommandBuffer: %p", (void*)commandBuffer);
-    LOGI("Queue: %p", (void*)deviceInfo->graphicsQueue);
+    LOGD("=== Submitting Command Buffer ===");
+    LOGD("CommandBuffer: %p", (void*)commandBuffer);
+    LOGD("Queue: %p", (void*)deviceInfo->graphicsQueue);
 
     VkSubmitInfo submitInfo{};
     submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
@@ -499,14 +553,14 @@ Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeSubmitCommandBuffer(
         return;
     }
 
-    LOGI("✓ Command buffer submitted");
+    LOGD("✓ Command buffer submitted");
 
     // 同步等待（测试用，生产环境应该用fence）
     result = vkQueueWaitIdle(deviceInfo->graphicsQueue);
     if (result != VK_SUCCESS) {
         LOGE("Failed to wait for queue idle: %d", result);
     } else {
-        LOGI("✓ Queue wait idle completed");
+        LOGD("✓ Queue wait idle completed");
     }
 }
 // 13. Present图像
@@ -636,7 +690,7 @@ Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeResizeSwapchain(
     createInfo.imageColorSpace = swapchainInfo->format.colorSpace;
     createInfo.imageExtent = newExtent;
     createInfo.imageArrayLayers = 1;
-    createInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+    createInfo.imageUsage = swapchainInfo->usage;
     createInfo.imageSharingMode = VK_SHARING_MODE_EXCLUSIVE;
     createInfo.preTransform = surfaceCapabilities.currentTransform;
     createInfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
@@ -684,6 +738,7 @@ Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeResizeSwapchain(
     );
 
     LOGI("  Swapchain image count: %u", actualImageCount);
+    swapchainInfo->images = images;
 
     // 11. 创建image views
     swapchainInfo->imageViews.resize(actualImageCount);
@@ -716,7 +771,11 @@ Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeResizeSwapchain(
         }
     }
 
-    // 12. 创建framebuffers
+    // 12. 创建framebuffers（动态渲染直接使用 image view，不需要重建）
+    if (renderPass == VK_NULL_HANDLE) {
+        LOGI("=== nativeResizeSwapchain SUCCESS (dynamic rendering) ===");
+        return JNI_TRUE;
+    }
     swapchainInfo->framebuffers.resize(actualImageCount);
     for (size_t i = 0; i < actualImageCount; i++) {
         VkImageView attachments[] = { swapchainInfo->imageViews[i] };
@@ -769,6 +828,7 @@ Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeDestroyRenderPass(
 
     DeviceInfo* deviceInfo = reinterpret_cast<DeviceInfo*>(deviceHandle);
     VkRenderPass renderPass = reinterpret_cast<VkRenderPass>(renderPassHandle);
+    unregisterRenderPass(deviceInfo, renderPass);
     vkDestroyRenderPass(deviceInfo->device, renderPass, nullptr);
 }
 
@@ -797,6 +857,15 @@ Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeDestroyDevice(
         JNIEnv* env, jobject /* this */, jlong deviceHandle) {
 
     DeviceInfo* deviceInfo = reinterpret_cast<DeviceInfo*>(deviceHandle);
+    destroyGpuProfiler(deviceInfo);
+    destroyFrameStats(deviceInfo);
+    destroyPipelineCompiler(deviceInfo);
+    destroyLayoutCache(deviceInfo);
+    destroyBindlessTable(deviceInfo);
+    destroySamplerCache(deviceInfo);
+    destroyPipelineRegistry(deviceInfo);
+    destroyShaderStatistics(deviceInfo);
+    destroyImageStateTracker(deviceInfo);
     vkDestroyDevice(deviceInfo->device, nullptr);
     delete deviceInfo;
 }
@@ -830,7 +899,6 @@ Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeCreateTestTexture(
     VkDeviceMemory stagingBufferMemory = VK_NULL_HANDLE;
     VkCommandPool tempCommandPool = VK_NULL_HANDLE;
     VkImageView imageView = VK_NULL_HANDLE;
-    VkSampler sampler = VK_NULL_HANDLE;
 
     // 1. 创建图像
     VkImageCreateInfo imageInfo{};
@@ -873,6 +941,7 @@ Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeCreateTestTexture(
     }
 
     vkBindImageMemory(deviceInfo->device, image, imageMemory, 0);
+    registerTrackedImage(deviceInfo, image, imageInfo.usage);
 
     // 3-9. 用作用域包裹所有临时变量
     {
@@ -950,68 +1019,7 @@ Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeCreateTestTexture(
 
         vkBeginCommandBuffer(commandBuffer, &beginInfo);
 
-        // 转换图像布局 (UNDEFINED -> TRANSFER_DST_OPTIMAL)
-        VkImageMemoryBarrier barrier{};
-        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-        barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        barrier.image = image;
-        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        barrier.subresourceRange.baseMipLevel = 0;
-        barrier.subresourceRange.levelCount = 1;
-        barrier.subresourceRange.baseArrayLayer = 0;
-        barrier.subresourceRange.layerCount = 1;
-        barrier.srcAccessMask = 0;
-        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-
-        vkCmdPipelineBarrier(
-                commandBuffer,
-                VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
-                VK_PIPELINE_STAGE_TRANSFER_BIT,
-                0,
-                0, nullptr,
-                0, nullptr,
-                1, &barrier
-        );
-
-        // 复制buffer到image
-        VkBufferImageCopy region{};
-        region.bufferOffset = 0;
-        region.bufferRowLength = 0;
-        region.bufferImageHeight = 0;
-        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        region.imageSubresource.mipLevel = 0;
-        region.imageSubresource.baseArrayLayer = 0;
-        region.imageSubresource.layerCount = 1;
-        region.imageOffset = {0, 0, 0};
-        region.imageExtent = {width, height, 1};
-
-        vkCmdCopyBufferToImage(
-                commandBuffer,
-                stagingBuffer,
-                image,
-                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                1,
-                &region
-        );
-
-        // 转换图像布局 (TRANSFER_DST_OPTIMAL -> SHADER_READ_ONLY_OPTIMAL)
-        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-        barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-
-        vkCmdPipelineBarrier(
-                commandBuffer,
-                VK_PIPELINE_STAGE_TRANSFER_BIT,
-                VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-                0,
-                0, nullptr,
-                0, nullptr,
-                1, &barrier
-        );
+        recordTextureUpload(deviceInfo, commandBuffer, stagingBuffer, image, width, height);
 
         vkEndCommandBuffer(commandBuffer);
 
@@ -1046,34 +1054,10 @@ Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeCreateTestTexture(
     result = vkCreateImageView(deviceInfo->device, &viewInfo, nullptr, &imageView);
     if (result != VK_SUCCESS) {
         LOGE("Failed to create image view: %d", result);
-    }
-
-    // 11. 创建 Sampler
-    VkSamplerCreateInfo samplerInfo{};
-    samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
-    samplerInfo.magFilter = VK_FILTER_LINEAR;
-    samplerInfo.minFilter = VK_FILTER_LINEAR;
-    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
-    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
-    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
-    samplerInfo.anisotropyEnable = VK_FALSE;
-    samplerInfo.maxAnisotropy = 1.0f;
-    samplerInfo.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
-    samplerInfo.unnormalizedCoordinates = VK_FALSE;
-    samplerInfo.compareEnable = VK_FALSE;
-    samplerInfo.compareOp = VK_COMPARE_OP_ALWAYS;
-    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
-    samplerInfo.mipLodBias = 0.0f;
-    samplerInfo.minLod = 0.0f;
-    samplerInfo.maxLod = 0.0f;
-
-    result = vkCreateSampler(deviceInfo->device, &samplerInfo, nullptr, &sampler);
-    if (result != VK_SUCCESS) {
-        LOGE("Failed to create sampler: %d", result);
         goto cleanup;
     }
 
-    // 12. 清理staging资源
+    // 11. 清理staging资源（采样由滤镜自己的 sampler 完成，测试纹理不再单独创建）
     if (stagingBuffer != VK_NULL_HANDLE) {
         vkDestroyBuffer(deviceInfo->device, stagingBuffer, nullptr);
     }
@@ -1084,7 +1068,7 @@ Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeCreateTestTexture(
         vkDestroyCommandPool(deviceInfo->device, tempCommandPool, nullptr);
     }
 
-    // 13. 保存纹理信息
+    // 12. 保存纹理信息
     {
         TextureInfo* textureInfo = new TextureInfo();
         textureInfo->image = image;
@@ -1100,9 +1084,6 @@ Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeCreateTestTexture(
 
     cleanup:
     // 清理所有可能已分配的资源
-    if (sampler != VK_NULL_HANDLE) {
-        vkDestroySampler(deviceInfo->device, sampler, nullptr);
-    }
     if (imageView != VK_NULL_HANDLE) {
         vkDestroyImageView(deviceInfo->device, imageView, nullptr);
     }
@@ -1116,6 +1097,7 @@ Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeCreateTestTexture(
         vkDestroyCommandPool(deviceInfo->device, tempCommandPool, nullptr);
     }
     if (image != VK_NULL_HANDLE) {
+        unregisterTrackedImage(deviceInfo, image);
         vkDestroyImage(deviceInfo->device, image, nullptr);
     }
     if (imageMemory != VK_NULL_HANDLE) {
@@ -1232,10 +1214,13 @@ Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeWaitForFence(
         jlong deviceHandle,
         jlong fenceHandle) {
 
+    TraceScope trace("wait_fence");
     DeviceInfo* deviceInfo = reinterpret_cast<DeviceInfo*>(deviceHandle);
     VkFence fence = reinterpret_cast<VkFence>(fenceHandle);
 
+    const uint64_t beginNs = traceNowNs();
     vkWaitForFences(deviceInfo->device, 1, &fence, VK_TRUE, UINT64_MAX);
+    frameStatsFenceWait(deviceInfo, beginNs, traceNowNs());
 }
 
 // ========== 新增：重置 Fence ==========
@@ -1281,11 +1266,13 @@ Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeAcquireNextImageWithSemapho
         jlong swapchainHandle,
         jlong semaphoreHandle) {
 
+    TraceScope trace("acquire");
     DeviceInfo* deviceInfo = reinterpret_cast<DeviceInfo*>(deviceHandle);
     SwapchainInfo* swapchainInfo = reinterpret_cast<SwapchainInfo*>(swapchainHandle);
     VkSemaphore semaphore = reinterpret_cast<VkSemaphore>(semaphoreHandle);
 
     uint32_t imageIndex;
+    const uint64_t beginNs = traceNowNs();
     VkResult result = vkAcquireNextImageKHR(
             deviceInfo->device,
             swapchainInfo->swapchain,
@@ -1294,6 +1281,7 @@ Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeAcquireNextImageWithSemapho
             VK_NULL_HANDLE,
             &imageIndex
     );
+    frameStatsAcquire(deviceInfo, beginNs, traceNowNs(), result);
 
     // 返回 (resultCode << 32) | imageIndex
     jlong returnValue = (static_cast<jlong>(result) << 32) | static_cast<jlong>(imageIndex);
@@ -1310,6 +1298,7 @@ Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeSubmitCommandBufferWithSync
         jlong signalSemaphoreHandle,
         jlong fenceHandle) {
 
+    TraceScope trace("submit");
     DeviceInfo* deviceInfo = reinterpret_cast<DeviceInfo*>(deviceHandle);
     VkCommandBuffer commandBuffer = reinterpret_cast<VkCommandBuffer>(commandBufferHandle);
     VkSemaphore waitSemaphore = reinterpret_cast<VkSemaphore>(waitSemaphoreHandle);
@@ -1328,7 +1317,9 @@ Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeSubmitCommandBufferWithSync
     submitInfo.signalSemaphoreCount = 1;
     submitInfo.pSignalSemaphores = &signalSemaphore;  // 🔥 通知渲染完成
 
+    const uint64_t beginNs = traceNowNs();
     VkResult result = vkQueueSubmit(deviceInfo->graphicsQueue, 1, &submitInfo, fence);  // 🔥 使用 fence
+    frameStatsSubmit(deviceInfo, beginNs, traceNowNs());
 
     if (result != VK_SUCCESS) {
         LOGE("Failed to submit command buffer with sync: %d", result);
@@ -1402,6 +1393,7 @@ struct InputTextureInfo {
     VkImageView imageView;
     uint32_t width;
     uint32_t height;
+    uint32_t mipLevels;  // 1：不带 mip 链；否则每次上传后重新生成（见 Vulkanmips.h）
 
     // HardwareBuffer 相关
     AHardwareBuffer* hardwareBuffer;
@@ -1428,6 +1420,20 @@ void LogPhysicalDevices(const std::vector<VkPhysicalDevice>& devices) {
     LOGI("%s", oss.str().c_str());
 }
 
+static bool isDeviceExtensionSupported(VkPhysicalDevice physicalDevice, const char* name) {
+    uint32_t count = 0;
+    vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &count, nullptr);
+    std::vector<VkExtensionProperties> extensions(count);
+    vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &count, extensions.data());
+
+    for (const auto& extension : extensions) {
+        if (strcmp(extension.extensionName, name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
 // ========== 基础 Vulkan 创建函数 ==========
 // (保留之前的 nativeCreateInstance, nativeCreateDevice, nativeCreateRenderPass,
 //  nativeCreateSwapchain, nativeCreateCommandPool, nativeCreateFramebuffers 等)
@@ -1465,7 +1471,8 @@ Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeCreateInstance(
 
 extern "C" JNIEXPORT jlong JNICALL
 Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeCreateDevice(
-        JNIEnv* env, jobject /* this */, jlong instanceHandle, jobject surface) {
+        JNIEnv* env, jobject /* this */, jlong instanceHandle, jobject surface,
+        jboolean allowDynamicRendering, jboolean shaderStatistics) {
 
     VkInstance instance = reinterpret_cast<VkInstance>(instanceHandle);
 
@@ -1509,13 +1516,80 @@ Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeCreateDevice(
 
     VkPhysicalDeviceFeatures deviceFeatures{};
 
+    // 可选扩展：支持才启用
+    std::vector<const char*> enabledExtensions = deviceExtensions;
+    const bool incrementalPresent = isDeviceExtensionSupported(
+            physicalDevice, VK_KHR_INCREMENTAL_PRESENT_EXTENSION_NAME);
+    if (incrementalPresent) {
+        enabledExtensions.push_back(VK_KHR_INCREMENTAL_PRESENT_EXTENSION_NAME);
+    }
+    LOGI("VK_KHR_incremental_present: %s", incrementalPresent ? "supported" : "not supported");
+
+    // 依赖 VK_KHR_get_physical_device_properties2：与 synchronization2 相同，要求设备支持 Vulkan 1.1
+    VkPhysicalDeviceProperties physicalDeviceProperties;
+    vkGetPhysicalDeviceProperties(physicalDevice, &physicalDeviceProperties);
+    const bool pushDescriptors = physicalDeviceProperties.apiVersion >= VK_API_VERSION_1_1 &&
+            isDeviceExtensionSupported(physicalDevice, VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME);
+    if (pushDescriptors) {
+        enabledExtensions.push_back(VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME);
+    }
+    LOGI("VK_KHR_push_descriptor: %s", pushDescriptors ? "enabled" : "not supported, cached descriptor sets");
+
+    VkPhysicalDeviceDynamicRenderingFeaturesKHR dynamicRenderingFeatures{};
+    const bool dynamicRendering = allowDynamicRendering &&
+            queryDynamicRenderingSupport(physicalDevice, &enabledExtensions, &dynamicRenderingFeatures);
+    LOGI("VK_KHR_dynamic_rendering: %s", dynamicRendering ? "enabled" : "not used, render pass fallback");
+
+    VkPhysicalDeviceSynchronization2FeaturesKHR synchronization2Features{};
+    const bool synchronization2 =
+            querySynchronization2Support(physicalDevice, &enabledExtensions, &synchronization2Features);
+    LOGI("VK_KHR_synchronization2: %s", synchronization2 ? "enabled" : "not supported, vkCmdPipelineBarrier fallback");
+
+    VkPhysicalDeviceDescriptorIndexingFeaturesEXT descriptorIndexingFeatures{};
+    const bool descriptorIndexing = queryDescriptorIndexingSupport(
+            physicalDevice, &enabledExtensions, &descriptorIndexingFeatures, &deviceFeatures);
+    LOGI("VK_EXT_descriptor_indexing: %s", descriptorIndexing ? "enabled" : "not supported, per-source descriptor sets");
+
+    const bool calibratedTimestamps = queryCalibratedTimestampSupport(instance, physicalDevice, &enabledExtensions);
+    LOGI("VK_EXT_calibrated_timestamps: %s", calibratedTimestamps ? "enabled" : "not supported, no GPU trace track");
+
+    // 只在 runner 以 shaderStatistics 启动时启用（见 Vulkanshaderstats.h）
+    const bool pipelineStatistics = queryPipelineStatisticsSupport(physicalDevice, shaderStatistics, &deviceFeatures);
+    VkPhysicalDevicePipelineExecutablePropertiesFeaturesKHR executableFeatures{};
+    const bool executableInfo = queryPipelineExecutableInfoSupport(
+            physicalDevice, shaderStatistics, &enabledExtensions, &executableFeatures);
+    if (shaderStatistics) {
+        LOGI("pipelineStatisticsQuery: %s", pipelineStatistics ? "enabled" : "not supported");
+        LOGI("VK_KHR_pipeline_executable_properties: %s", executableInfo ? "enabled" : "not supported");
+    }
+
+    // 启用的特性结构串成 pNext 链
+    void* featureChain = nullptr;
+    if (synchronization2) {
+        synchronization2Features.pNext = featureChain;
+        featureChain = &synchronization2Features;
+    }
+    if (dynamicRendering) {
+        dynamicRenderingFeatures.pNext = featureChain;
+        featureChain = &dynamicRenderingFeatures;
+    }
+    if (descriptorIndexing) {
+        descriptorIndexingFeatures.pNext = featureChain;
+        featureChain = &descriptorIndexingFeatures;
+    }
+    if (executableInfo) {
+        executableFeatures.pNext = featureChain;
+        featureChain = &executableFeatures;
+    }
+
     VkDeviceCreateInfo deviceCreateInfo{};
     deviceCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+    deviceCreateInfo.pNext = featureChain;
     deviceCreateInfo.queueCreateInfoCount = queueCreateInfos.size();
     deviceCreateInfo.pQueueCreateInfos = queueCreateInfos.data();
     deviceCreateInfo.pEnabledFeatures = &deviceFeatures;
-    deviceCreateInfo.enabledExtensionCount = deviceExtensions.size();
-    deviceCreateInfo.ppEnabledExtensionNames = deviceExtensions.data();
+    deviceCreateInfo.enabledExtensionCount = enabledExtensions.size();
+    deviceCreateInfo.ppEnabledExtensionNames = enabledExtensions.data();
 
     VkDevice device;
     VkResult result = vkCreateDevice(physicalDevice, &deviceCreateInfo, nullptr, &device);
@@ -1531,6 +1605,18 @@ Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeCreateDevice(
     deviceInfo->graphicsQueueFamily = graphicsFamily;
     deviceInfo->presentQueueFamily = presentFamily;
     deviceInfo->surface = vkSurface;
+    deviceInfo->incrementalPresentSupported = incrementalPresent;
+    initDynamicRendering(deviceInfo, dynamicRendering);
+    initSynchronization2(deviceInfo, synchronization2);
+    initPushDescriptors(deviceInfo, pushDescriptors);
+    createPipelineRegistry(deviceInfo);
+    createPipelineCompiler(deviceInfo);
+    createLayoutCache(deviceInfo);
+    createSamplerCache(deviceInfo);
+    initBindlessTable(deviceInfo, descriptorIndexing);
+    initCalibratedTimestamps(deviceInfo, calibratedTimestamps);
+    initShaderStatistics(deviceInfo, pipelineStatistics, executableInfo);
+    createFrameStats(deviceInfo);
 
     vkGetDeviceQueue(device, graphicsFamily, 0, &deviceInfo->graphicsQueue);
     vkGetDeviceQueue(device, presentFamily, 0, &deviceInfo->presentQueue);
@@ -1615,7 +1701,8 @@ Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeCreateInputTexture(
         JNIEnv* env, jobject /* this */,
         jlong deviceHandle,
         jint width,
-        jint height) {
+        jint height,
+        jboolean mipmapped) {
 
     DeviceInfo* deviceInfo = reinterpret_cast<DeviceInfo*>(deviceHandle);
 
@@ -1624,6 +1711,16 @@ Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeCreateInputTexture(
 
     const VkFormat format = VK_FORMAT_R8G8B8A8_UNORM;
 
+    // 大幅缩小时滤镜可以用三线性采样读 mip 链；格式不支持 blit 时退回单级
+    uint32_t mipLevels = 1;
+    if (mipmapped == JNI_TRUE) {
+        if (isMipGenerationSupported(deviceInfo, format)) {
+            mipLevels = fullMipLevelCount(width, height);
+        } else {
+            LOGI("Mip generation not supported for input format, using a single level");
+        }
+    }
+
     VkImage image = VK_NULL_HANDLE;
     VkDeviceMemory imageMemory = VK_NULL_HANDLE;
     VkImageView imageView = VK_NULL_HANDLE;
@@ -1636,12 +1733,13 @@ Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeCreateInputTexture(
     imageInfo.extent.width = width;
     imageInfo.extent.height = height;
     imageInfo.extent.depth = 1;
-    imageInfo.mipLevels = 1;
+    imageInfo.mipLevels = mipLevels;
     imageInfo.arrayLayers = 1;
     imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
     imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
-    // 🔥 关键：作为采样纹理和传输目标
-    imageInfo.usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+    // 🔥 关键：作为采样纹理和传输目标；传输源用于 copy/blit 快速路径（Vulkantransfer.h）和逐级生成 mip
+    imageInfo.usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT |
+                      VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
     imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
     imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 
@@ -1681,7 +1779,7 @@ Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeCreateInputTexture(
     viewInfo.format = format;
     viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
     viewInfo.subresourceRange.baseMipLevel = 0;
-    viewInfo.subresourceRange.levelCount = 1;
+    viewInfo.subresourceRange.levelCount = mipLevels;
     viewInfo.subresourceRange.baseArrayLayer = 0;
     viewInfo.subresourceRange.layerCount = 1;
 
@@ -1693,6 +1791,8 @@ Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeCreateInputTexture(
         return 0;
     }
 
+    registerTrackedImage(deviceInfo, image, imageInfo.usage, mipLevels);
+
     // 4. 初始化纹理为绿色（用于测试）
     // 使用临时命令缓冲区填充纹理
     {
@@ -1761,52 +1861,7 @@ Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeCreateInputTexture(
 
         vkBeginCommandBuffer(cmdBuffer, &beginInfo);
 
-        // 转换布局：UNDEFINED -> TRANSFER_DST
-        VkImageMemoryBarrier barrier{};
-        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-        barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        barrier.image = image;
-        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        barrier.subresourceRange.baseMipLevel = 0;
-        barrier.subresourceRange.levelCount = 1;
-        barrier.subresourceRange.baseArrayLayer = 0;
-        barrier.subresourceRange.layerCount = 1;
-        barrier.srcAccessMask = 0;
-        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-
-        vkCmdPipelineBarrier(cmdBuffer,
-                             VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
-                             VK_PIPELINE_STAGE_TRANSFER_BIT,
-                             0, 0, nullptr, 0, nullptr, 1, &barrier);
-
-        // 复制数据
-        VkBufferImageCopy region{};
-        region.bufferOffset = 0;
-        region.bufferRowLength = 0;
-        region.bufferImageHeight = 0;
-        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        region.imageSubresource.mipLevel = 0;
-        region.imageSubresource.baseArrayLayer = 0;
-        region.imageSubresource.layerCount = 1;
-        region.imageOffset = {0, 0, 0};
-        region.imageExtent = {(uint32_t)width, (uint32_t)height, 1};
-
-        vkCmdCopyBufferToImage(cmdBuffer, stagingBuffer, image,
-                               VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
-
-        // 转换布局：TRANSFER_DST -> SHADER_READ_ONLY
-        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-        barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-
-        vkCmdPipelineBarrier(cmdBuffer,
-                             VK_PIPELINE_STAGE_TRANSFER_BIT,
-                             VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-                             0, 0, nullptr, 0, nullptr, 1, &barrier);
+        recordTextureUpload(deviceInfo, cmdBuffer, stagingBuffer, image, width, height, mipLevels);
 
         vkEndCommandBuffer(cmdBuffer);
 
@@ -1833,6 +1888,7 @@ Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeCreateInputTexture(
     textureInfo->imageView = imageView;
     textureInfo->width = width;
     textureInfo->height = height;
+    textureInfo->mipLevels = mipLevels;
     textureInfo->hardwareBuffer = nullptr;  // 不使用 HardwareBuffer
     textureInfo->window = nullptr;
     textureInfo->timestamp = 0;
@@ -1847,7 +1903,7 @@ Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeCreateInputTexture(
     // 保存 JavaVM
     env->GetJavaVM(&textureInfo->jvm);
 
-    LOGI("✓ Input texture created: %dx%d", width, height);
+    LOGI("✓ Input texture created: %dx%d, %u mip levels", width, height, mipLevels);
     return reinterpret_cast<jlong>(textureInfo);
 }
 
@@ -1950,6 +2006,49 @@ Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeGetTextureImageView(
     return 0;
 }
 
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeGetTextureImage(
+        JNIEnv* env, jobject /* this */,
+        jlong textureHandle) {
+
+    InputTextureInfo* textureInfo = reinterpret_cast<InputTextureInfo*>(textureHandle);
+    if (textureInfo) {
+        return reinterpret_cast<jlong>(textureInfo->image);
+    }
+    return 0;
+}
+
+// 1 表示不带 mip 链（未请求或设备不支持）
+extern "C" JNIEXPORT jint JNICALL
+Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeGetTextureMipLevels(
+        JNIEnv* env, jobject /* this */,
+        jlong textureHandle) {
+
+    InputTextureInfo* textureInfo = reinterpret_cast<InputTextureInfo*>(textureHandle);
+    if (textureInfo) {
+        return static_cast<jint>(textureInfo->mipLevels);
+    }
+    return 0;
+}
+
+// 在给定命令缓冲中重新生成 mip 链（基准测试用；上传路径会自动生成）
+extern "C" JNIEXPORT void JNICALL
+Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeRecordTextureMips(
+        JNIEnv* env, jobject /* this */,
+        jlong deviceHandle,
+        jlong textureHandle,
+        jlong commandBufferHandle) {
+
+    DeviceInfo* deviceInfo = reinterpret_cast<DeviceInfo*>(deviceHandle);
+    InputTextureInfo* textureInfo = reinterpret_cast<InputTextureInfo*>(textureHandle);
+    VkCommandBuffer commandBuffer = reinterpret_cast<VkCommandBuffer>(commandBufferHandle);
+    if (!deviceInfo || !textureInfo || commandBuffer == VK_NULL_HANDLE || textureInfo->mipLevels <= 1) {
+        return;
+    }
+    recordMipGeneration(deviceInfo, commandBuffer, textureInfo->image,
+                        {textureInfo->width, textureInfo->height}, textureInfo->mipLevels);
+}
+
 extern "C" JNIEXPORT jfloatArray JNICALL
 Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeGetTextureTransformMatrix(
         JNIEnv* env, jobject /* this */,
@@ -2075,6 +2174,7 @@ Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeDestroyTexture(
             vkDestroyImageView(deviceInfo->device, textureInfo->imageView, nullptr);
         }
         if (textureInfo->image != VK_NULL_HANDLE) {
+            unregisterTrackedImage(deviceInfo, textureInfo->image);
             vkDestroyImage(deviceInfo->device, textureInfo->image, nullptr);
         }
         if (textureInfo->memory != VK_NULL_HANDLE) {
@@ -2102,6 +2202,7 @@ jlong deviceHandle,
         jlong textureHandle,
 jbyteArray dataArray) {
 
+TraceScope trace("upload");
 DeviceInfo* deviceInfo = reinterpret_cast<DeviceInfo*>(deviceHandle);
 InputTextureInfo* textureInfo = reinterpret_cast<InputTextureInfo*>(textureHandle);
 
@@ -2192,52 +2293,11 @@ beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
 
 vkBeginCommandBuffer(cmdBuffer, &beginInfo);
 
-// 转换布局：SHADER_READ_ONLY -> TRANSFER_DST
-VkImageMemoryBarrier barrier{};
-barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-barrier.oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-barrier.image = textureInfo->image;
-barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-barrier.subresourceRange.baseMipLevel = 0;
-barrier.subresourceRange.levelCount = 1;
-barrier.subresourceRange.baseArrayLayer = 0;
-barrier.subresourceRange.layerCount = 1;
-barrier.srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
-barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-
-vkCmdPipelineBarrier(cmdBuffer,
-        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-        VK_PIPELINE_STAGE_TRANSFER_BIT,
-0, 0, nullptr, 0, nullptr, 1, &barrier);
-
-// 复制数据
-VkBufferImageCopy region{};
-region.bufferOffset = 0;
-region.bufferRowLength = 0;
-region.bufferImageHeight = 0;
-region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-region.imageSubresource.mipLevel = 0;
-region.imageSubresource.baseArrayLayer = 0;
-region.imageSubresource.layerCount = 1;
-region.imageOffset = {0, 0, 0};
-region.imageExtent = {textureInfo->width, textureInfo->height, 1};
-
-vkCmdCopyBufferToImage(cmdBuffer, stagingBuffer, textureInfo->image,
-VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
-
-// 转换布局：TRANSFER_DST -> SHADER_READ_ONLY
-barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-
-vkCmdPipelineBarrier(cmdBuffer,
-        VK_PIPELINE_STAGE_TRANSFER_BIT,
-        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-0, 0, nullptr, 0, nullptr, 1, &barrier);
+// 纹理当前的布局由跟踪器记录（不再假设为 SHADER_READ_ONLY）
+const int32_t uploadScope = beginImmediateGpuScope(deviceInfo, cmdBuffer, gpuScopeId(deviceInfo, "upload"));
+recordTextureUpload(deviceInfo, cmdBuffer, stagingBuffer, textureInfo->image,
+                    textureInfo->width, textureInfo->height, textureInfo->mipLevels);
+endImmediateGpuScope(deviceInfo, cmdBuffer, uploadScope);
 
 vkEndCommandBuffer(cmdBuffer);
 
@@ -2249,6 +2309,7 @@ submitInfo.pCommandBuffers = &cmdBuffer;
 
 vkQueueSubmit(deviceInfo->graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
 vkQueueWaitIdle(deviceInfo->graphicsQueue);
+collectImmediateGpuScopes(deviceInfo);
 
 // 清理
 vkFreeCommandBuffers(deviceInfo->device, tempPool, 1, &cmdBuffer);
@@ -2256,7 +2317,7 @@ vkDestroyCommandPool(deviceInfo->device, tempPool, nullptr);
 vkDestroyBuffer(deviceInfo->device, stagingBuffer, nullptr);
 vkFreeMemory(deviceInfo->device, stagingMemory, nullptr);
 
-LOGI("✓ Texture updated");
+LOGD("✓ Texture updated");
 }
 
 // ========== 便捷方法：使用纯色更新纹理 ==========
@@ -2268,6 +2329,7 @@ jlong deviceHandle,
         jlong textureHandle,
 jint r, jint g, jint b, jint a) {
 
+TraceScope trace("upload");
 DeviceInfo* deviceInfo = reinterpret_cast<DeviceInfo*>(deviceHandle);
 InputTextureInfo* textureInfo = reinterpret_cast<InputTextureInfo*>(textureHandle);
 
@@ -2341,52 +2403,11 @@ beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
 
 vkBeginCommandBuffer(cmdBuffer, &beginInfo);
 
-// 转换布局：SHADER_READ_ONLY -> TRANSFER_DST
-VkImageMemoryBarrier barrier{};
-barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-barrier.oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-barrier.image = textureInfo->image;
-barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-barrier.subresourceRange.baseMipLevel = 0;
-barrier.subresourceRange.levelCount = 1;
-barrier.subresourceRange.baseArrayLayer = 0;
-barrier.subresourceRange.layerCount = 1;
-barrier.srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
-barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-
-vkCmdPipelineBarrier(cmdBuffer,
-        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-        VK_PIPELINE_STAGE_TRANSFER_BIT,
-0, 0, nullptr, 0, nullptr, 1, &barrier);
-
-// 复制数据
-VkBufferImageCopy region{};
-region.bufferOffset = 0;
-region.bufferRowLength = 0;
-region.bufferImageHeight = 0;
-region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-region.imageSubresource.mipLevel = 0;
-region.imageSubresource.baseArrayLayer = 0;
-region.imageSubresource.layerCount = 1;
-region.imageOffset = {0, 0, 0};
-region.imageExtent = {textureInfo->width, textureInfo->height, 1};
-
-vkCmdCopyBufferToImage(cmdBuffer, stagingBuffer, textureInfo->image,
-VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
-
-// 转换布局：TRANSFER_DST -> SHADER_READ_ONLY
-barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-
-vkCmdPipelineBarrier(cmdBuffer,
-        VK_PIPELINE_STAGE_TRANSFER_BIT,
-        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-0, 0, nullptr, 0, nullptr, 1, &barrier);
+// 纹理当前的布局由跟踪器记录（不再假设为 SHADER_READ_ONLY）
+const int32_t uploadScope = beginImmediateGpuScope(deviceInfo, cmdBuffer, gpuScopeId(deviceInfo, "upload"));
+recordTextureUpload(deviceInfo, cmdBuffer, stagingBuffer, textureInfo->image,
+                    textureInfo->width, textureInfo->height, textureInfo->mipLevels);
+endImmediateGpuScope(deviceInfo, cmdBuffer, uploadScope);
 
 vkEndCommandBuffer(cmdBuffer);
 
@@ -2398,10 +2419,220 @@ submitInfo.pCommandBuffers = &cmdBuffer;
 
 vkQueueSubmit(deviceInfo->graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
 vkQueueWaitIdle(deviceInfo->graphicsQueue);
+collectImmediateGpuScopes(deviceInfo);
 
 // 清理
 vkFreeCommandBuffers(deviceInfo->device, tempPool, 1, &cmdBuffer);
 vkDestroyCommandPool(deviceInfo->device, tempPool, nullptr);
 vkDestroyBuffer(deviceInfo->device, stagingBuffer, nullptr);
 vkFreeMemory(deviceInfo->device, stagingMemory, nullptr);
+}
+
+// ========== 增量呈现：脏矩形跟踪 ==========
+
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeCreateDamageTracker(
+        JNIEnv* env, jobject /* this */,
+        jlong swapchainHandle,
+        jint inputWidth,
+        jint inputHeight) {
+
+    SwapchainInfo* swapchainInfo = reinterpret_cast<SwapchainInfo*>(swapchainHandle);
+    if (!swapchainInfo) {
+        LOGE("Invalid swapchain handle");
+        return 0;
+    }
+
+    DamageTracker* tracker = new DamageTracker(
+            static_cast<uint32_t>(swapchainInfo->images.size()),
+            swapchainInfo->extent.width,
+            swapchainInfo->extent.height,
+            static_cast<uint32_t>(inputWidth),
+            static_cast<uint32_t>(inputHeight));
+
+    LOGI("✓ Damage tracker created: %zu images, output %ux%u, input %dx%d",
+         swapchainInfo->images.size(), swapchainInfo->extent.width, swapchainInfo->extent.height,
+         inputWidth, inputHeight);
+    return reinterpret_cast<jlong>(tracker);
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeDestroyDamageTracker(
+        JNIEnv* env, jobject /* this */, jlong trackerHandle) {
+
+    delete reinterpret_cast<DamageTracker*>(trackerHandle);
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeSetDamageTransform(
+        JNIEnv* env, jobject /* this */,
+        jlong trackerHandle,
+        jfloatArray matrixArray) {
+
+    DamageTracker* tracker = reinterpret_cast<DamageTracker*>(trackerHandle);
+    if (!tracker) return;
+
+    if (matrixArray == nullptr || env->GetArrayLength(matrixArray) < 16) {
+        tracker->setTransform(nullptr);
+        return;
+    }
+
+    jfloat matrix[16];
+    env->GetFloatArrayRegion(matrixArray, 0, 16, matrix);
+    tracker->setTransform(matrix);
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeAddInputDamage(
+        JNIEnv* env, jobject /* this */,
+        jlong trackerHandle,
+        jint x, jint y, jint width, jint height) {
+
+    DamageTracker* tracker = reinterpret_cast<DamageTracker*>(trackerHandle);
+    if (tracker) {
+        tracker->addInputDamage(x, y, width, height);
+    }
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeInvalidateDamage(
+        JNIEnv* env, jobject /* this */, jlong trackerHandle) {
+
+    DamageTracker* tracker = reinterpret_cast<DamageTracker*>(trackerHandle);
+    if (tracker) {
+        tracker->invalidateAll();
+    }
+}
+
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeHasPendingDamage(
+        JNIEnv* env, jobject /* this */, jlong trackerHandle) {
+
+    DamageTracker* tracker = reinterpret_cast<DamageTracker*>(trackerHandle);
+    return (tracker == nullptr || tracker->hasPendingDamage()) ? JNI_TRUE : JNI_FALSE;
+}
+
+// 返回 [full, x0, y0, w0, h0, x1, y1, w1, h1, ...]
+// full = 1 表示整帧重绘（使用 CLEAR render pass），否则只重绘列出的矩形（LOAD render pass）
+extern "C" JNIEXPORT jintArray JNICALL
+Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeBeginDamageFrame(
+        JNIEnv* env, jobject /* this */,
+        jlong trackerHandle,
+        jlong swapchainHandle,
+        jint imageIndex) {
+
+    DamageTracker* tracker = reinterpret_cast<DamageTracker*>(trackerHandle);
+    SwapchainInfo* swapchainInfo = reinterpret_cast<SwapchainInfo*>(swapchainHandle);
+
+    std::vector<DamageRect> rects;
+    bool full = true;
+
+    if (tracker && swapchainInfo) {
+        // 交换链被重建过：之前的内容全部无效
+        if (tracker->imageCount() != swapchainInfo->images.size() ||
+            tracker->outputWidth() != swapchainInfo->extent.width ||
+            tracker->outputHeight() != swapchainInfo->extent.height) {
+            tracker->reset(static_cast<uint32_t>(swapchainInfo->images.size()),
+                           swapchainInfo->extent.width, swapchainInfo->extent.height);
+        }
+        full = tracker->beginFrame(static_cast<uint32_t>(imageIndex), rects);
+    }
+
+    std::vector<jint> values;
+    values.reserve(1 + rects.size() * 4);
+    values.push_back(full ? 1 : 0);
+    for (const auto& rect : rects) {
+        values.push_back(rect.x);
+        values.push_back(rect.y);
+        values.push_back(rect.width);
+        values.push_back(rect.height);
+    }
+
+    jintArray result = env->NewIntArray(static_cast<jsize>(values.size()));
+    if (result) {
+        env->SetIntArrayRegion(result, 0, static_cast<jsize>(values.size()), values.data());
+    }
+    return result;
+}
+
+extern "C" JNIEXPORT jfloat JNICALL
+Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeGetShadedFraction(
+        JNIEnv* env, jobject /* this */, jlong trackerHandle) {
+
+    DamageTracker* tracker = reinterpret_cast<DamageTracker*>(trackerHandle);
+    return tracker ? tracker->lastShadedFraction() : 1.0f;
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeSetScissor(
+        JNIEnv* env, jobject /* this */,
+        jlong commandBufferHandle,
+        jint x, jint y, jint width, jint height) {
+
+    VkCommandBuffer commandBuffer = reinterpret_cast<VkCommandBuffer>(commandBufferHandle);
+
+    VkRect2D scissor{};
+    scissor.offset = {x, y};
+    scissor.extent = {static_cast<uint32_t>(width), static_cast<uint32_t>(height)};
+    vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+}
+
+// 带脏区域的 Present：设备支持时通过 VK_KHR_incremental_present 告诉合成器哪些区域变化了
+extern "C" JNIEXPORT void JNICALL
+Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativePresentImageWithDamage(
+        JNIEnv* env, jobject /* this */,
+        jlong deviceHandle,
+        jlong swapchainHandle,
+        jint imageIndex,
+        jlong waitSemaphoreHandle,
+        jlong trackerHandle) {
+
+    TraceScope trace("present");
+    DeviceInfo* deviceInfo = reinterpret_cast<DeviceInfo*>(deviceHandle);
+    SwapchainInfo* swapchainInfo = reinterpret_cast<SwapchainInfo*>(swapchainHandle);
+    VkSemaphore waitSemaphore = reinterpret_cast<VkSemaphore>(waitSemaphoreHandle);
+    DamageTracker* tracker = reinterpret_cast<DamageTracker*>(trackerHandle);
+
+    uint32_t index = static_cast<uint32_t>(imageIndex);
+
+    VkPresentInfoKHR presentInfo{};
+    presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+    presentInfo.waitSemaphoreCount = 1;
+    presentInfo.pWaitSemaphores = &waitSemaphore;
+    presentInfo.swapchainCount = 1;
+    presentInfo.pSwapchains = &swapchainInfo->swapchain;
+    presentInfo.pImageIndices = &index;
+
+    std::vector<VkRectLayerKHR> rectangles;
+    VkPresentRegionKHR region{};
+    VkPresentRegionsKHR regions{};
+
+    // 整帧重绘时不附加区域（rectangleCount = 0 也表示整帧变化）
+    if (deviceInfo->incrementalPresentSupported && tracker && !tracker->lastFrameFull()) {
+        for (const auto& rect : tracker->lastFrameRects()) {
+            VkRectLayerKHR layerRect{};
+            layerRect.offset = {rect.x, rect.y};
+            layerRect.extent = {static_cast<uint32_t>(rect.width), static_cast<uint32_t>(rect.height)};
+            layerRect.layer = 0;
+            rectangles.push_back(layerRect);
+        }
+
+        if (!rectangles.empty()) {
+            region.rectangleCount = static_cast<uint32_t>(rectangles.size());
+            region.pRectangles = rectangles.data();
+
+            regions.sType = VK_STRUCTURE_TYPE_PRESENT_REGIONS_KHR;
+            regions.swapchainCount = 1;
+            regions.pRegions = &region;
+            presentInfo.pNext = &regions;
+        }
+    }
+
+    const uint64_t beginNs = traceNowNs();
+    VkResult result = vkQueuePresentKHR(deviceInfo->presentQueue, &presentInfo);
+    frameStatsPresent(deviceInfo, beginNs, traceNowNs(), result);
+
+    if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) {
+        LOGE("Failed to present image: %d", result);
+    }
 }
\ No newline at end of file
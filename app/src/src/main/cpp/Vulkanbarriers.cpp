@@ -0,0 +1,612 @@
+//
+// Resource state tracking and batched image barriers (VK_KHR_synchronization2 with fallback).
+//
+#include "Vulkanjni.h"
+#include "Vulkanbarriers.h"
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+
+// 调试检查：默认只在 debug 构建中开启，可以在编译选项中显式指定 0/1
+#ifndef VULKAN_BARRIER_VALIDATION
+#ifdef NDEBUG
+#define VULKAN_BARRIER_VALIDATION 0
+#else
+#define VULKAN_BARRIER_VALIDATION 1
+#endif
+#endif
+
+using namespace VulkanJNI;
+
+// 单个子资源（mip × layer）的状态
+struct SubresourceState {
+    VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+    // 最近一次写入（或布局转换）所在的阶段，以及尚未 available 的写访问
+    VkPipelineStageFlags2KHR writeStages = VK_PIPELINE_STAGE_2_NONE_KHR;
+    VkAccessFlags2KHR writeAccess = VK_ACCESS_2_NONE_KHR;
+
+    // 写入之后读取过它的阶段：下一次写入/布局转换只需要等待它们（它们已经排在写入之后）
+    VkPipelineStageFlags2KHR readStages = VK_PIPELINE_STAGE_2_NONE_KHR;
+
+    // 写入已经对这些阶段的这些访问可见（由同一个 barrier 的目标范围得到）
+    VkPipelineStageFlags2KHR visibleStages = VK_PIPELINE_STAGE_2_NONE_KHR;
+    VkAccessFlags2KHR visibleAccess = VK_ACCESS_2_NONE_KHR;
+
+    // 自上次写入以来声明过的使用（调试检查用）
+    VkPipelineStageFlags2KHR declaredStages = VK_PIPELINE_STAGE_2_NONE_KHR;
+    VkAccessFlags2KHR declaredAccess = VK_ACCESS_2_NONE_KHR;
+
+    bool pending = false;  // 已记录 barrier，尚未 flush
+};
+
+struct TrackedImage {
+    VkImageUsageFlags usage = 0;
+    uint32_t mipLevels = 1;
+    uint32_t arrayLayers = 1;
+    std::vector<SubresourceState> subresources;  // [mip * arrayLayers + layer]
+};
+
+struct ImageStateTracker {
+    std::mutex mutex;
+    std::unordered_map<VkImage, TrackedImage> images;
+};
+
+namespace {
+
+    constexpr VkAccessFlags2KHR kWriteAccess =
+            VK_ACCESS_2_SHADER_WRITE_BIT_KHR |
+            VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR |
+            VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT_KHR |
+            VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT_KHR |
+            VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR |
+            VK_ACCESS_2_HOST_WRITE_BIT_KHR |
+            VK_ACCESS_2_MEMORY_WRITE_BIT_KHR;
+
+    constexpr VkPipelineStageFlags2KHR kTransferStages =
+            VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR |
+            VK_PIPELINE_STAGE_2_COPY_BIT_KHR |
+            VK_PIPELINE_STAGE_2_BLIT_BIT_KHR |
+            VK_PIPELINE_STAGE_2_RESOLVE_BIT_KHR |
+            VK_PIPELINE_STAGE_2_CLEAR_BIT_KHR;
+
+    constexpr VkPipelineStageFlags2KHR kShaderStages =
+            VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT_KHR |
+            VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR |
+            VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR |
+            VK_PIPELINE_STAGE_2_ALL_GRAPHICS_BIT_KHR;
+
+    constexpr uint64_t kLegacyMask = 0xFFFFFFFFull;
+
+    // 一个子资源需要的 barrier（needed 为 false 时不需要）
+    struct PlannedBarrier {
+        bool needed = false;
+        VkImageLayout oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        VkPipelineStageFlags2KHR srcStages = VK_PIPELINE_STAGE_2_NONE_KHR;
+        VkAccessFlags2KHR srcAccess = VK_ACCESS_2_NONE_KHR;
+        VkPipelineStageFlags2KHR dstStages = VK_PIPELINE_STAGE_2_NONE_KHR;
+        VkAccessFlags2KHR dstAccess = VK_ACCESS_2_NONE_KHR;
+
+        bool operator==(const PlannedBarrier& other) const {
+            return needed == other.needed && oldLayout == other.oldLayout &&
+                   srcStages == other.srcStages && srcAccess == other.srcAccess &&
+                   dstStages == other.dstStages && dstAccess == other.dstAccess;
+        }
+    };
+
+    bool hasExtension(const std::vector<VkExtensionProperties>& available, const char* name) {
+        for (const auto& extension : available) {
+            if (strcmp(extension.extensionName, name) == 0) return true;
+        }
+        return false;
+    }
+
+    // 计算 use 需要的 barrier 并更新状态（状态表示命令执行之后的情况）
+    PlannedBarrier planBarrier(SubresourceState* state, const ImageUse& use, bool discard) {
+        const bool write = (use.access & kWriteAccess) != 0;
+        const bool transition = use.layout != state->layout;
+
+        // discard 只影响布局转换（从 UNDEFINED 转换，不保留内容）；布局不变时只是内存依赖
+        PlannedBarrier barrier;
+        barrier.oldLayout = discard && transition ? VK_IMAGE_LAYOUT_UNDEFINED : state->layout;
+        barrier.dstStages = use.stages;
+        barrier.dstAccess = use.access;
+
+        if (transition || write) {
+            // 布局转换本身是一次读写：与写入相同，等待之前的读取者（已经排在上次写入之后），
+            // 没有读取者时等待上次写入。读取之前的 RAW barrier 已经让写入 available
+            barrier.srcStages = state->readStages ? state->readStages : state->writeStages;
+            barrier.srcAccess = state->writeAccess;
+            barrier.needed = transition || barrier.srcStages != VK_PIPELINE_STAGE_2_NONE_KHR;
+
+            state->layout = use.layout;
+            state->declaredStages = use.stages;
+            state->declaredAccess = use.access;
+            if (write) {
+                state->writeStages = use.stages;
+                state->writeAccess = use.access & kWriteAccess;
+                state->readStages = VK_PIPELINE_STAGE_2_NONE_KHR;
+                state->visibleStages = VK_PIPELINE_STAGE_2_NONE_KHR;
+                state->visibleAccess = VK_ACCESS_2_NONE_KHR;
+            } else {
+                // 只读的布局转换：转换（视为写入）在 use.stages 之前完成并对其可见，
+                // 之后其他阶段的读取从 use.stages 串联
+                state->writeStages = use.stages;
+                state->writeAccess = VK_ACCESS_2_NONE_KHR;
+                state->readStages = use.stages;
+                state->visibleStages = use.stages;
+                state->visibleAccess = use.access;
+            }
+            return barrier;
+        }
+
+        // 同布局读取
+        state->declaredStages |= use.stages;
+        state->declaredAccess |= use.access;
+        const bool visible = (use.stages & ~state->visibleStages) == 0 &&
+                             (use.access & ~state->visibleAccess) == 0;
+        if (state->writeStages == VK_PIPELINE_STAGE_2_NONE_KHR || visible) {
+            state->readStages |= use.stages;
+            return barrier;
+        }
+
+        // RAW：目标范围取已可见部分与本次使用的并集，使并集整体可见
+        barrier.needed = true;
+        barrier.srcStages = state->writeStages;
+        barrier.srcAccess = state->writeAccess;
+        barrier.dstStages = state->visibleStages | use.stages;
+        barrier.dstAccess = state->visibleAccess | use.access;
+
+        state->writeAccess = VK_ACCESS_2_NONE_KHR;
+        state->readStages |= use.stages;
+        state->visibleStages = barrier.dstStages;
+        state->visibleAccess = barrier.dstAccess;
+        return barrier;
+    }
+
+    // ====== 调试检查 ======
+
+    VkImageUsageFlags requiredUsage(VkAccessFlags2KHR access) {
+        VkImageUsageFlags usage = 0;
+        if (access & VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR) usage |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+        if (access & VK_ACCESS_2_TRANSFER_READ_BIT_KHR) usage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+        if (access & VK_ACCESS_2_SHADER_SAMPLED_READ_BIT_KHR) usage |= VK_IMAGE_USAGE_SAMPLED_BIT;
+        if (access & (VK_ACCESS_2_SHADER_STORAGE_READ_BIT_KHR | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR)) {
+            usage |= VK_IMAGE_USAGE_STORAGE_BIT;
+        }
+        if (access & (VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT_KHR | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT_KHR)) {
+            usage |= VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+        }
+        return usage;
+    }
+
+    bool layoutAllowsAccess(VkImageLayout layout, VkAccessFlags2KHR access) {
+        switch (layout) {
+            case VK_IMAGE_LAYOUT_GENERAL:
+                return true;
+            case VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL:
+                return (access & ~VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR) == 0;
+            case VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL:
+                return (access & ~VK_ACCESS_2_TRANSFER_READ_BIT_KHR) == 0;
+            case VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL:
+                return (access & ~(VK_ACCESS_2_SHADER_READ_BIT_KHR | VK_ACCESS_2_SHADER_SAMPLED_READ_BIT_KHR |
+                                   VK_ACCESS_2_INPUT_ATTACHMENT_READ_BIT_KHR)) == 0;
+            case VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL:
+                return (access & ~(VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT_KHR |
+                                   VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT_KHR)) == 0;
+            case VK_IMAGE_LAYOUT_PRESENT_SRC_KHR:
+                return access == VK_ACCESS_2_NONE_KHR;
+            default:
+                return false;  // UNDEFINED 不能作为使用时的布局
+        }
+    }
+
+    bool stagesAllowAccess(VkPipelineStageFlags2KHR stages, VkAccessFlags2KHR access) {
+        if (stages & VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT_KHR) return true;
+        if ((access & (VK_ACCESS_2_TRANSFER_READ_BIT_KHR | VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR)) &&
+            !(stages & kTransferStages)) {
+            return false;
+        }
+        if ((access & (VK_ACCESS_2_SHADER_READ_BIT_KHR | VK_ACCESS_2_SHADER_WRITE_BIT_KHR |
+                       VK_ACCESS_2_SHADER_SAMPLED_READ_BIT_KHR | VK_ACCESS_2_SHADER_STORAGE_READ_BIT_KHR |
+                       VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR)) &&
+            !(stages & kShaderStages)) {
+            return false;
+        }
+        if ((access & (VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT_KHR | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT_KHR)) &&
+            !(stages & VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR)) {
+            return false;
+        }
+        return true;
+    }
+
+    void validateUse(const TrackedImage& tracked, VkImage image, const ImageUse& use) {
+        const VkImageUsageFlags missing = requiredUsage(use.access) & ~tracked.usage;
+        if (missing) {
+            LOGE("Barrier validation: image 0x%llx used with access 0x%llx but created without usage 0x%x",
+                 (unsigned long long)image, (unsigned long long)use.access, missing);
+        }
+        if (!layoutAllowsAccess(use.layout, use.access)) {
+            LOGE("Barrier validation: image 0x%llx access 0x%llx not allowed in layout %d",
+                 (unsigned long long)image, (unsigned long long)use.access, use.layout);
+        }
+        if (!stagesAllowAccess(use.stages, use.access)) {
+            LOGE("Barrier validation: image 0x%llx access 0x%llx not performed by stages 0x%llx",
+                 (unsigned long long)image, (unsigned long long)use.access, (unsigned long long)use.stages);
+        }
+    }
+
+    // ====== 回退到 vkCmdPipelineBarrier ======
+
+    VkPipelineStageFlags toLegacyStages(VkPipelineStageFlags2KHR stages) {
+        VkPipelineStageFlags legacy = static_cast<VkPipelineStageFlags>(stages & kLegacyMask);
+        const VkPipelineStageFlags2KHR extended = stages & ~kLegacyMask;
+        if (extended & kTransferStages) {
+            legacy |= VK_PIPELINE_STAGE_TRANSFER_BIT;
+        }
+        if (extended & (VK_PIPELINE_STAGE_2_INDEX_INPUT_BIT_KHR | VK_PIPELINE_STAGE_2_VERTEX_ATTRIBUTE_INPUT_BIT_KHR)) {
+            legacy |= VK_PIPELINE_STAGE_VERTEX_INPUT_BIT;
+        }
+        if (extended & ~(kTransferStages | VK_PIPELINE_STAGE_2_INDEX_INPUT_BIT_KHR |
+                         VK_PIPELINE_STAGE_2_VERTEX_ATTRIBUTE_INPUT_BIT_KHR)) {
+            legacy |= VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;  // 其他扩展阶段：最保守
+        }
+        return legacy;
+    }
+
+    VkAccessFlags toLegacyAccess(VkAccessFlags2KHR access) {
+        VkAccessFlags legacy = static_cast<VkAccessFlags>(access & kLegacyMask);
+        const VkAccessFlags2KHR extended = access & ~kLegacyMask;
+        if (extended & (VK_ACCESS_2_SHADER_SAMPLED_READ_BIT_KHR | VK_ACCESS_2_SHADER_STORAGE_READ_BIT_KHR)) {
+            legacy |= VK_ACCESS_SHADER_READ_BIT;
+        }
+        if (extended & VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR) {
+            legacy |= VK_ACCESS_SHADER_WRITE_BIT;
+        }
+        if (extended & ~(VK_ACCESS_2_SHADER_SAMPLED_READ_BIT_KHR | VK_ACCESS_2_SHADER_STORAGE_READ_BIT_KHR |
+                         VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR)) {
+            legacy |= VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+        }
+        return legacy;
+    }
+
+    void recordLegacyBarriers(VkCommandBuffer commandBuffer, const std::vector<VkImageMemoryBarrier2KHR>& barriers) {
+        std::vector<VkImageMemoryBarrier> legacyBarriers;
+        legacyBarriers.reserve(barriers.size());
+        VkPipelineStageFlags srcStages = 0;
+        VkPipelineStageFlags dstStages = 0;
+
+        for (const auto& barrier2 : barriers) {
+            VkImageMemoryBarrier barrier{};
+            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            barrier.oldLayout = barrier2.oldLayout;
+            barrier.newLayout = barrier2.newLayout;
+            barrier.srcQueueFamilyIndex = barrier2.srcQueueFamilyIndex;
+            barrier.dstQueueFamilyIndex = barrier2.dstQueueFamilyIndex;
+            barrier.image = barrier2.image;
+            barrier.subresourceRange = barrier2.subresourceRange;
+            barrier.srcAccessMask = toLegacyAccess(barrier2.srcAccessMask);
+            barrier.dstAccessMask = toLegacyAccess(barrier2.dstAccessMask);
+            legacyBarriers.push_back(barrier);
+
+            srcStages |= toLegacyStages(barrier2.srcStageMask);
+            dstStages |= toLegacyStages(barrier2.dstStageMask);
+        }
+
+        // 旧接口的阶段掩码不能为 0
+        if (srcStages == 0) srcStages = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+        if (dstStages == 0) dstStages = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+
+        vkCmdPipelineBarrier(commandBuffer, srcStages, dstStages, 0,
+                             0, nullptr, 0, nullptr,
+                             static_cast<uint32_t>(legacyBarriers.size()), legacyBarriers.data());
+    }
+
+    VkImageMemoryBarrier2KHR makeBarrier(VkImage image, VkImageLayout oldLayout, VkImageLayout newLayout,
+                                         VkPipelineStageFlags2KHR srcStages, VkAccessFlags2KHR srcAccess,
+                                         VkPipelineStageFlags2KHR dstStages, VkAccessFlags2KHR dstAccess) {
+        VkImageMemoryBarrier2KHR barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2_KHR;
+        barrier.srcStageMask = srcStages;
+        barrier.srcAccessMask = srcAccess;
+        barrier.dstStageMask = dstStages;
+        barrier.dstAccessMask = dstAccess;
+        barrier.oldLayout = oldLayout;
+        barrier.newLayout = newLayout;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = image;
+        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        barrier.subresourceRange.baseMipLevel = 0;
+        barrier.subresourceRange.levelCount = 1;
+        barrier.subresourceRange.baseArrayLayer = 0;
+        barrier.subresourceRange.layerCount = 1;
+        return barrier;
+    }
+
+    // 与批次中最后一个 barrier 合并（同一图像、相同 layer 范围、相邻 mip、参数相同）
+    bool mergeWithLast(ImageBarrierBatch* batch, const VkImageMemoryBarrier2KHR& barrier) {
+        if (batch->barriers.empty()) return false;
+        VkImageMemoryBarrier2KHR& last = batch->barriers.back();
+        const VkImageSubresourceRange& a = last.subresourceRange;
+        const VkImageSubresourceRange& b = barrier.subresourceRange;
+        if (last.image != barrier.image ||
+            last.oldLayout != barrier.oldLayout || last.newLayout != barrier.newLayout ||
+            last.srcStageMask != barrier.srcStageMask || last.srcAccessMask != barrier.srcAccessMask ||
+            last.dstStageMask != barrier.dstStageMask || last.dstAccessMask != barrier.dstAccessMask ||
+            a.aspectMask != b.aspectMask || a.baseArrayLayer != b.baseArrayLayer || a.layerCount != b.layerCount ||
+            a.baseMipLevel + a.levelCount != b.baseMipLevel) {
+            return false;
+        }
+        last.subresourceRange.levelCount += b.levelCount;
+        return true;
+    }
+
+} // anonymous namespace
+
+// ============================================
+// Device Setup
+// ============================================
+bool querySynchronization2Support(VkPhysicalDevice physicalDevice,
+                                  std::vector<const char*>* extensions,
+                                  VkPhysicalDeviceSynchronization2FeaturesKHR* features) {
+    // 与动态渲染相同：实例为 Vulkan 1.1，通过扩展使用；vkGetPhysicalDeviceFeatures2 需要 1.1
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+    if (properties.apiVersion < VK_API_VERSION_1_1) return false;
+
+    uint32_t count = 0;
+    vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &count, nullptr);
+    std::vector<VkExtensionProperties> available(count);
+    vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &count, available.data());
+    if (!hasExtension(available, VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME)) return false;
+
+    *features = VkPhysicalDeviceSynchronization2FeaturesKHR{};
+    features->sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES_KHR;
+
+    VkPhysicalDeviceFeatures2 features2{};
+    features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features2.pNext = features;
+    vkGetPhysicalDeviceFeatures2(physicalDevice, &features2);
+    if (features->synchronization2 != VK_TRUE) return false;
+
+    extensions->push_back(VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME);
+    return true;
+}
+
+void initSynchronization2(DeviceInfo* deviceInfo, bool enabled) {
+    deviceInfo->imageStates = new ImageStateTracker();
+    deviceInfo->synchronization2 = false;
+    if (!enabled) return;
+
+    deviceInfo->cmdPipelineBarrier2 = reinterpret_cast<PFN_vkCmdPipelineBarrier2KHR>(
+            vkGetDeviceProcAddr(deviceInfo->device, "vkCmdPipelineBarrier2KHR"));
+    if (!deviceInfo->cmdPipelineBarrier2) {
+        LOGE("vkCmdPipelineBarrier2KHR not found, falling back to vkCmdPipelineBarrier");
+        return;
+    }
+    deviceInfo->synchronization2 = true;
+}
+
+void destroyImageStateTracker(DeviceInfo* deviceInfo) {
+    if (!deviceInfo->imageStates) return;
+    if (!deviceInfo->imageStates->images.empty()) {
+        LOGD("Image state tracker destroyed with %zu images still registered",
+             deviceInfo->imageStates->images.size());
+    }
+    delete deviceInfo->imageStates;
+    deviceInfo->imageStates = nullptr;
+}
+
+// ============================================
+// Registration
+// ============================================
+void registerTrackedImage(DeviceInfo* deviceInfo, VkImage image, VkImageUsageFlags usage,
+                          uint32_t mipLevels, uint32_t arrayLayers) {
+    ImageStateTracker* tracker = deviceInfo->imageStates;
+    if (!tracker || image == VK_NULL_HANDLE) return;
+
+    std::lock_guard<std::mutex> lock(tracker->mutex);
+    TrackedImage& tracked = tracker->images[image];
+    tracked.usage = usage;
+    tracked.mipLevels = mipLevels;
+    tracked.arrayLayers = arrayLayers;
+    tracked.subresources.assign(static_cast<size_t>(mipLevels) * arrayLayers, SubresourceState{});
+}
+
+void unregisterTrackedImage(DeviceInfo* deviceInfo, VkImage image) {
+    ImageStateTracker* tracker = deviceInfo->imageStates;
+    if (!tracker || image == VK_NULL_HANDLE) return;
+
+    std::lock_guard<std::mutex> lock(tracker->mutex);
+    tracker->images.erase(image);
+}
+
+// ============================================
+// Barrier Recording
+// ============================================
+void requireImageUse(DeviceInfo* deviceInfo, ImageBarrierBatch* batch, VkImage image,
+                     const ImageUse& use, bool discard) {
+    VkImageSubresourceRange range{};
+    range.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    range.baseMipLevel = 0;
+    range.levelCount = VK_REMAINING_MIP_LEVELS;
+    range.baseArrayLayer = 0;
+    range.layerCount = VK_REMAINING_ARRAY_LAYERS;
+    requireImageUse(deviceInfo, batch, image, range, use, discard);
+}
+
+void requireImageUse(DeviceInfo* deviceInfo, ImageBarrierBatch* batch, VkImage image,
+                     const VkImageSubresourceRange& range, const ImageUse& use, bool discard) {
+    ImageStateTracker* tracker = deviceInfo->imageStates;
+    if (!tracker) return;
+
+    std::lock_guard<std::mutex> lock(tracker->mutex);
+    auto it = tracker->images.find(image);
+    if (it == tracker->images.end()) {
+        LOGE("requireImageUse: image 0x%llx is not tracked", (unsigned long long)image);
+        return;
+    }
+    TrackedImage& tracked = it->second;
+
+    const uint32_t levelCount = range.levelCount == VK_REMAINING_MIP_LEVELS
+            ? tracked.mipLevels - range.baseMipLevel : range.levelCount;
+    const uint32_t layerCount = range.layerCount == VK_REMAINING_ARRAY_LAYERS
+            ? tracked.arrayLayers - range.baseArrayLayer : range.layerCount;
+    if (range.baseMipLevel + levelCount > tracked.mipLevels ||
+        range.baseArrayLayer + layerCount > tracked.arrayLayers) {
+        LOGE("requireImageUse: range out of bounds for image 0x%llx", (unsigned long long)image);
+        return;
+    }
+
+#if VULKAN_BARRIER_VALIDATION
+    validateUse(tracked, image, use);
+#endif
+
+    for (uint32_t mip = range.baseMipLevel; mip < range.baseMipLevel + levelCount; mip++) {
+        // 同一 mip 中参数相同的相邻 layer 组成一个 barrier
+        PlannedBarrier run;
+        uint32_t runStart = range.baseArrayLayer;
+        const uint32_t layerEnd = range.baseArrayLayer + layerCount;
+
+        for (uint32_t layer = range.baseArrayLayer; layer <= layerEnd; layer++) {
+            PlannedBarrier planned;
+            if (layer < layerEnd) {
+                SubresourceState& state = tracked.subresources[mip * tracked.arrayLayers + layer];
+#if VULKAN_BARRIER_VALIDATION
+                if (state.pending) {
+                    LOGE("Barrier validation: image 0x%llx (mip %u, layer %u) declared twice without flush",
+                         (unsigned long long)image, mip, layer);
+                }
+#endif
+                planned = planBarrier(&state, use, discard);
+                state.pending = state.pending || planned.needed;
+                if (layer == range.baseArrayLayer) {
+                    run = planned;
+                    continue;
+                }
+                if (planned == run) continue;
+            }
+
+            if (run.needed) {
+                VkImageMemoryBarrier2KHR barrier = makeBarrier(image, run.oldLayout, use.layout,
+                                                               run.srcStages, run.srcAccess,
+                                                               run.dstStages, run.dstAccess);
+                barrier.subresourceRange.aspectMask = range.aspectMask;
+                barrier.subresourceRange.baseMipLevel = mip;
+                barrier.subresourceRange.baseArrayLayer = runStart;
+                barrier.subresourceRange.layerCount = layer - runStart;
+                if (!mergeWithLast(batch, barrier)) {
+                    batch->barriers.push_back(barrier);
+                }
+            }
+            run = planned;
+            runStart = layer;
+        }
+    }
+}
+
+void addImageTransition(ImageBarrierBatch* batch, VkImage image, VkImageLayout oldLayout,
+                        VkPipelineStageFlags2KHR srcStages, VkAccessFlags2KHR srcAccess,
+                        const ImageUse& use) {
+    batch->barriers.push_back(makeBarrier(image, oldLayout, use.layout,
+                                          srcStages, srcAccess, use.stages, use.access));
+}
+
+void flushImageBarriers(DeviceInfo* deviceInfo, ImageBarrierBatch* batch, VkCommandBuffer commandBuffer) {
+    if (batch->barriers.empty()) return;
+
+    ImageStateTracker* tracker = deviceInfo->imageStates;
+    if (tracker) {
+        std::lock_guard<std::mutex> lock(tracker->mutex);
+        for (const auto& barrier : batch->barriers) {
+            auto it = tracker->images.find(barrier.image);
+            if (it == tracker->images.end()) continue;  // 未跟踪的图像（交换链）
+
+            TrackedImage& tracked = it->second;
+            const VkImageSubresourceRange& range = barrier.subresourceRange;
+            for (uint32_t mip = range.baseMipLevel; mip < range.baseMipLevel + range.levelCount; mip++) {
+                for (uint32_t layer = range.baseArrayLayer; layer < range.baseArrayLayer + range.layerCount; layer++) {
+                    tracked.subresources[mip * tracked.arrayLayers + layer].pending = false;
+                }
+            }
+        }
+    }
+
+    if (deviceInfo->synchronization2) {
+        VkDependencyInfoKHR dependencyInfo{};
+        dependencyInfo.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO_KHR;
+        dependencyInfo.imageMemoryBarrierCount = static_cast<uint32_t>(batch->barriers.size());
+        dependencyInfo.pImageMemoryBarriers = batch->barriers.data();
+        deviceInfo->cmdPipelineBarrier2(commandBuffer, &dependencyInfo);
+    } else {
+        recordLegacyBarriers(commandBuffer, batch->barriers);
+    }
+    batch->barriers.clear();
+}
+
+// ============================================
+// Validation
+// ============================================
+void checkImageCommand(DeviceInfo* deviceInfo, VkImage image, const ImageUse& use, const char* command) {
+    VkImageSubresourceRange range{};
+    range.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    range.baseMipLevel = 0;
+    range.levelCount = VK_REMAINING_MIP_LEVELS;
+    range.baseArrayLayer = 0;
+    range.layerCount = VK_REMAINING_ARRAY_LAYERS;
+    checkImageCommand(deviceInfo, image, range, use, command);
+}
+
+void checkImageCommand(DeviceInfo* deviceInfo, VkImage image, const VkImageSubresourceRange& range,
+                       const ImageUse& use, const char* command) {
+#if VULKAN_BARRIER_VALIDATION
+    ImageStateTracker* tracker = deviceInfo->imageStates;
+    if (!tracker) return;
+
+    std::lock_guard<std::mutex> lock(tracker->mutex);
+    auto it = tracker->images.find(image);
+    if (it == tracker->images.end()) {
+        LOGE("Barrier validation: %s uses untracked image 0x%llx", command, (unsigned long long)image);
+        return;
+    }
+
+    // 每次调用只报告第一个问题，避免逐个子资源刷屏
+    const TrackedImage& tracked = it->second;
+    const uint32_t levelEnd = range.levelCount == VK_REMAINING_MIP_LEVELS
+            ? tracked.mipLevels : std::min(tracked.mipLevels, range.baseMipLevel + range.levelCount);
+    const uint32_t layerEnd = range.layerCount == VK_REMAINING_ARRAY_LAYERS
+            ? tracked.arrayLayers : std::min(tracked.arrayLayers, range.baseArrayLayer + range.layerCount);
+    for (uint32_t mip = range.baseMipLevel; mip < levelEnd; mip++) {
+        for (uint32_t layer = range.baseArrayLayer; layer < layerEnd; layer++) {
+            const SubresourceState& state = tracked.subresources[mip * tracked.arrayLayers + layer];
+
+            if (state.pending) {
+                LOGE("Barrier validation: %s records before the barrier for image 0x%llx (mip %u, layer %u) is flushed",
+                     command, (unsigned long long)image, mip, layer);
+                return;
+            }
+            if (state.layout != use.layout) {
+                LOGE("Barrier validation: %s expects image 0x%llx (mip %u, layer %u) in layout %d, tracked layout is %d",
+                     command, (unsigned long long)image, mip, layer, use.layout, state.layout);
+                return;
+            }
+            if ((use.stages & ~state.declaredStages) != 0 || (use.access & ~state.declaredAccess) != 0) {
+                LOGE("Barrier validation: %s uses image 0x%llx (mip %u, layer %u) with stages 0x%llx access 0x%llx, "
+                     "declared stages 0x%llx access 0x%llx",
+                     command, (unsigned long long)image, mip, layer,
+                     (unsigned long long)use.stages, (unsigned long long)use.access,
+                     (unsigned long long)state.declaredStages, (unsigned long long)state.declaredAccess);
+                return;
+            }
+        }
+    }
+#else
+    (void)deviceInfo;
+    (void)image;
+    (void)range;
+    (void)use;
+    (void)command;
+#endif
+}
@@ -0,0 +1,111 @@
+//
+// Resource state tracking and batched image barriers (VK_KHR_synchronization2 with fallback).
+//
+// 之前每个上传函数都手写 barrier（TOP_OF_PIPE / FRAGMENT_SHADER 这类粗粒度阶段），并假设输入纹理
+// 总是处于 SHADER_READ_ONLY_OPTIMAL。现在由设备级的跟踪器记录每张图像每个子资源（mip × layer）
+// 当前的布局、最近一次写入的阶段/访问、之后读取它的阶段，以及写入已对哪些阶段可见：
+//
+// - requireImageUse 声明接下来的命令如何使用图像，只在需要时记录 barrier：
+//   布局变化 → 等待之前所有访问；写（WAR/WAW）→ 只等待之前的读取者（没有读取者时等待上一次写入）；
+//   读（RAW）→ 写入尚未对该阶段/访问可见时才需要，同布局的连续读取不插 barrier。
+// - 记录的 barrier 延迟到 flushImageBarriers，一次 vkCmdPipelineBarrier2KHR 提交整批；
+//   相邻 mip 的相同 barrier 合并为一个范围。设备不支持 synchronization2 时转换为
+//   vkCmdPipelineBarrier（扩展阶段/访问位折算回对应的旧位）。
+// - 交换链图像的状态由 acquire/present 决定，不跟踪：用 addImageTransition 显式加入同一批次。
+//
+// 调试模式（VULKAN_BARRIER_VALIDATION，未定义 NDEBUG 时默认开启）：
+// - requireImageUse 检查使用方式是否与图像创建时声明的 usage、布局和阶段匹配；
+// - checkImageCommand 在录制命令前检查图像的跟踪状态是否满足该命令（布局一致、
+//   已声明对应的阶段/访问、barrier 已 flush），不满足时 LOGE。
+//
+// 跟踪器只记录状态，不负责队列间同步：状态按命令录制顺序更新，要求命令缓冲按录制顺序提交到同一队列。
+//
+#ifndef VULKAN_BARRIERS_H
+#define VULKAN_BARRIERS_H
+
+#include <vulkan/vulkan.h>
+#include <vector>
+#include "Vulkantypes.h"
+
+// 一次使用：命令执行时图像应处于的布局，以及访问它的阶段和方式（sync2 掩码）
+struct ImageUse {
+    VkImageLayout layout;
+    VkPipelineStageFlags2KHR stages;
+    VkAccessFlags2KHR access;
+};
+
+namespace ImageUses {
+    // vkCmdCopyBufferToImage 的目标
+    constexpr ImageUse kCopyDst = {
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            VK_PIPELINE_STAGE_2_COPY_BIT_KHR, VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR};
+
+    // vkCmdCopyImage / vkCmdBlitImage 的源（输入纹理直接复制到交换链，见 Vulkantransfer.h）
+    constexpr ImageUse kCopySrc = {
+            VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            VK_PIPELINE_STAGE_2_COPY_BIT_KHR, VK_ACCESS_2_TRANSFER_READ_BIT_KHR};
+    constexpr ImageUse kBlitSrc = {
+            VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            VK_PIPELINE_STAGE_2_BLIT_BIT_KHR, VK_ACCESS_2_TRANSFER_READ_BIT_KHR};
+
+    // vkCmdBlitImage 的目标（生成 mip 链时逐级写入，见 Vulkanmips.h）
+    constexpr ImageUse kBlitDst = {
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            VK_PIPELINE_STAGE_2_BLIT_BIT_KHR, VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR};
+
+    // 片段或计算着色器采样（输入纹理可能被光栅化或计算滤镜读取）
+    constexpr ImageUse kSampled = {
+            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR,
+            VK_ACCESS_2_SHADER_SAMPLED_READ_BIT_KHR};
+
+    // 计算着色器 imageStore
+    constexpr ImageUse kStorageWrite = {
+            VK_IMAGE_LAYOUT_GENERAL,
+            VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR};
+
+    // 交给呈现引擎（由信号量同步，不需要目标阶段）
+    constexpr ImageUse kPresent = {
+            VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, VK_PIPELINE_STAGE_2_NONE_KHR, VK_ACCESS_2_NONE_KHR};
+}
+
+// 待提交的一批 barrier；只在一个命令缓冲的录制过程中使用
+struct ImageBarrierBatch {
+    std::vector<VkImageMemoryBarrier2KHR> barriers;
+};
+
+// 检测物理设备是否支持 synchronization2；支持时追加扩展并填好特性结构（链到 VkDeviceCreateInfo::pNext）
+bool querySynchronization2Support(VkPhysicalDevice physicalDevice,
+                                  std::vector<const char*>* extensions,
+                                  VkPhysicalDeviceSynchronization2FeaturesKHR* features);
+
+// 创建设备后调用：加载 vkCmdPipelineBarrier2KHR（失败时回退）并创建跟踪器
+void initSynchronization2(DeviceInfo* deviceInfo, bool enabled);
+void destroyImageStateTracker(DeviceInfo* deviceInfo);
+
+// 创建图像后登记（初始布局 UNDEFINED）；同一句柄再次登记会重置状态。usage 用于调试检查
+void registerTrackedImage(DeviceInfo* deviceInfo, VkImage image, VkImageUsageFlags usage,
+                          uint32_t mipLevels = 1, uint32_t arrayLayers = 1);
+void unregisterTrackedImage(DeviceInfo* deviceInfo, VkImage image);
+
+// 声明接下来的命令对整张图像（或 range）的使用。discard 为 true 时不保留旧内容（整张覆盖），
+// 需要布局转换时从 UNDEFINED 转换。同一批次中同一子资源只能声明一次（中间需要 flush）
+void requireImageUse(DeviceInfo* deviceInfo, ImageBarrierBatch* batch, VkImage image,
+                     const ImageUse& use, bool discard = false);
+void requireImageUse(DeviceInfo* deviceInfo, ImageBarrierBatch* batch, VkImage image,
+                     const VkImageSubresourceRange& range, const ImageUse& use, bool discard = false);
+
+// 未跟踪图像（交换链图像）的显式转换，与跟踪图像的 barrier 一起提交
+void addImageTransition(ImageBarrierBatch* batch, VkImage image, VkImageLayout oldLayout,
+                        VkPipelineStageFlags2KHR srcStages, VkAccessFlags2KHR srcAccess,
+                        const ImageUse& use);
+
+// 把整批 barrier 录制为一次调用并清空批次；批次为空时什么都不做
+void flushImageBarriers(DeviceInfo* deviceInfo, ImageBarrierBatch* batch, VkCommandBuffer commandBuffer);
+
+// 调试模式：录制 command 之前检查整张图像已按 use 准备好
+void checkImageCommand(DeviceInfo* deviceInfo, VkImage image, const ImageUse& use, const char* command);
+void checkImageCommand(DeviceInfo* deviceInfo, VkImage image, const VkImageSubresourceRange& range,
+                       const ImageUse& use, const char* command);
+
+#endif // VULKAN_BARRIERS_H
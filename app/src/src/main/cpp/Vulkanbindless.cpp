@@ -0,0 +1,381 @@
+//
+// Bindless input texture table: one partially-bound sampler2D array per device (VK_EXT_descriptor_indexing).
+//
+#include "Vulkanjni.h"
+#include "Vulkanbindless.h"
+#include "Vulkanpipelineregistry.h"
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+using namespace VulkanJNI;
+
+struct BindlessTable {
+    std::mutex mutex;
+
+    VkDescriptorSetLayout setLayout = VK_NULL_HANDLE;
+    VkDescriptorPool pool = VK_NULL_HANDLE;
+    VkDescriptorSet set = VK_NULL_HANDLE;
+    uint32_t capacity = 0;
+
+    struct Slot {
+        VkImageView view = VK_NULL_HANDLE;
+        VkSampler sampler = VK_NULL_HANDLE;
+        uint32_t refCount = 0;
+        uint64_t retiredFrame = 0;  // 引用计数归零时的帧序号
+        bool written = false;
+    };
+    std::vector<Slot> slots;
+    std::map<std::pair<uint64_t, uint64_t>, uint32_t> liveSlots;  // (视图, sampler) → 槽号，只含引用中的槽
+    uint32_t nextSlot = 0;                                         // 轮转查找空闲槽的起点
+
+    uint32_t hits = 0;
+    uint32_t writes = 0;
+    uint32_t peak = 0;
+};
+
+namespace {
+
+    // 表的上限：合成的来源数远小于此，描述符池按容量一次分配
+    constexpr uint32_t kMaxBindlessSlots = 1024;
+
+    BindlessTable* getTable(DeviceInfo* deviceInfo) {
+        return deviceInfo ? deviceInfo->bindlessTable : nullptr;
+    }
+
+    std::pair<uint64_t, uint64_t> slotKey(VkImageView view, VkSampler sampler) {
+        return {static_cast<uint64_t>(toHandle(view)), static_cast<uint64_t>(toHandle(sampler))};
+    }
+
+    bool hasExtension(VkPhysicalDevice physicalDevice, const char* name) {
+        uint32_t count = 0;
+        vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &count, nullptr);
+        std::vector<VkExtensionProperties> available(count);
+        vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &count, available.data());
+        for (const VkExtensionProperties& extension : available) {
+            if (strcmp(extension.extensionName, name) == 0) return true;
+        }
+        return false;
+    }
+
+    // update-after-bind 池中每个 stage / 每个 set 可用的 sampler 与 sampled image 数
+    uint32_t queryCapacity(VkPhysicalDevice physicalDevice) {
+        VkPhysicalDeviceDescriptorIndexingPropertiesEXT indexing{};
+        indexing.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES_EXT;
+        VkPhysicalDeviceProperties2 properties{};
+        properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+        properties.pNext = &indexing;
+        vkGetPhysicalDeviceProperties2(physicalDevice, &properties);
+
+        return std::min({kMaxBindlessSlots,
+                         indexing.maxPerStageDescriptorUpdateAfterBindSamplers,
+                         indexing.maxPerStageDescriptorUpdateAfterBindSampledImages,
+                         indexing.maxDescriptorSetUpdateAfterBindSamplers,
+                         indexing.maxDescriptorSetUpdateAfterBindSampledImages});
+    }
+
+    bool createTable(DeviceInfo* deviceInfo, BindlessTable* table) {
+        VkDescriptorSetLayoutBinding binding{};
+        binding.binding = 0;
+        binding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        binding.descriptorCount = table->capacity;
+        binding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT;
+
+        const VkDescriptorBindingFlagsEXT bindingFlags = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT |
+                VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT |
+                VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT_EXT;
+        VkDescriptorSetLayoutBindingFlagsCreateInfoEXT flagsInfo{};
+        flagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT;
+        flagsInfo.bindingCount = 1;
+        flagsInfo.pBindingFlags = &bindingFlags;
+
+        VkDescriptorSetLayoutCreateInfo layoutInfo{};
+        layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        layoutInfo.pNext = &flagsInfo;
+        layoutInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT;
+        layoutInfo.bindingCount = 1;
+        layoutInfo.pBindings = &binding;
+
+        VkResult result = vkCreateDescriptorSetLayout(deviceInfo->device, &layoutInfo, nullptr, &table->setLayout);
+        if (!validateResult(result, "vkCreateDescriptorSetLayout (bindless)")) {
+            table->setLayout = VK_NULL_HANDLE;
+            return false;
+        }
+        registerDescriptorSetLayout(deviceInfo, table->setLayout, &layoutInfo);
+
+        VkDescriptorPoolSize poolSize{};
+        poolSize.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        poolSize.descriptorCount = table->capacity;
+
+        VkDescriptorPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT;
+        poolInfo.maxSets = 1;
+        poolInfo.poolSizeCount = 1;
+        poolInfo.pPoolSizes = &poolSize;
+
+        result = vkCreateDescriptorPool(deviceInfo->device, &poolInfo, nullptr, &table->pool);
+        if (!validateResult(result, "vkCreateDescriptorPool (bindless)")) {
+            table->pool = VK_NULL_HANDLE;
+            return false;
+        }
+
+        VkDescriptorSetAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocInfo.descriptorPool = table->pool;
+        allocInfo.descriptorSetCount = 1;
+        allocInfo.pSetLayouts = &table->setLayout;
+
+        result = vkAllocateDescriptorSets(deviceInfo->device, &allocInfo, &table->set);
+        if (!validateResult(result, "vkAllocateDescriptorSets (bindless)")) {
+            table->set = VK_NULL_HANDLE;
+            return false;
+        }
+
+        table->slots.resize(table->capacity);
+        return true;
+    }
+
+    void destroyTableObjects(DeviceInfo* deviceInfo, BindlessTable* table) {
+        // set 随池一起释放
+        if (table->pool != VK_NULL_HANDLE) {
+            vkDestroyDescriptorPool(deviceInfo->device, table->pool, nullptr);
+        }
+        if (table->setLayout != VK_NULL_HANDLE) {
+            unregisterDescriptorSetLayout(deviceInfo, table->setLayout);
+            vkDestroyDescriptorSetLayout(deviceInfo->device, table->setLayout, nullptr);
+        }
+    }
+
+    // 从未写过、或引用计数归零已超过 framesInFlight 帧的槽；没有时返回 -1
+    int32_t findFreeSlot(const DeviceInfo* deviceInfo, BindlessTable* table) {
+        for (uint32_t i = 0; i < table->capacity; i++) {
+            const uint32_t index = (table->nextSlot + i) % table->capacity;
+            const BindlessTable::Slot& slot = table->slots[index];
+            if (slot.refCount > 0) continue;
+            if (slot.written && slot.retiredFrame + deviceInfo->framesInFlight > deviceInfo->frameSerial) continue;
+            table->nextSlot = (index + 1) % table->capacity;
+            return static_cast<int32_t>(index);
+        }
+        return -1;
+    }
+
+} // anonymous namespace
+
+// ============================================
+// Device Setup
+// ============================================
+bool queryDescriptorIndexingSupport(VkPhysicalDevice physicalDevice,
+                                    std::vector<const char*>* extensions,
+                                    VkPhysicalDeviceDescriptorIndexingFeaturesEXT* features,
+                                    VkPhysicalDeviceFeatures* coreFeatures) {
+    // 与 synchronization2 相同：实例为 Vulkan 1.1，vkGetPhysicalDeviceFeatures2 需要 1.1
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+    if (properties.apiVersion < VK_API_VERSION_1_1) return false;
+    if (!hasExtension(physicalDevice, VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME)) return false;
+
+    VkPhysicalDeviceDescriptorIndexingFeaturesEXT supported{};
+    supported.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+
+    VkPhysicalDeviceFeatures2 features2{};
+    features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features2.pNext = &supported;
+    vkGetPhysicalDeviceFeatures2(physicalDevice, &features2);
+    if (supported.runtimeDescriptorArray != VK_TRUE ||
+        supported.descriptorBindingPartiallyBound != VK_TRUE ||
+        supported.descriptorBindingSampledImageUpdateAfterBind != VK_TRUE ||
+        supported.descriptorBindingUpdateUnusedWhilePending != VK_TRUE ||
+        features2.features.shaderSampledImageArrayDynamicIndexing != VK_TRUE) {
+        return false;
+    }
+    if (queryCapacity(physicalDevice) == 0) return false;
+
+    // 只启用用到的特性；下标来自 push constant（动态一致），不需要 nonUniform 索引
+    *features = VkPhysicalDeviceDescriptorIndexingFeaturesEXT{};
+    features->sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+    features->runtimeDescriptorArray = VK_TRUE;
+    features->descriptorBindingPartiallyBound = VK_TRUE;
+    features->descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+    features->descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+    coreFeatures->shaderSampledImageArrayDynamicIndexing = VK_TRUE;
+
+    extensions->push_back(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
+    return true;
+}
+
+void initBindlessTable(DeviceInfo* deviceInfo, bool enabled) {
+    deviceInfo->bindlessTable = nullptr;
+    if (!enabled) return;
+
+    auto* table = new BindlessTable();
+    table->capacity = queryCapacity(deviceInfo->physicalDevice);
+    if (table->capacity == 0 || !createTable(deviceInfo, table)) {
+        LOGE("Bindless table creation failed, falling back to per-source descriptor sets");
+        destroyTableObjects(deviceInfo, table);
+        delete table;
+        return;
+    }
+    deviceInfo->bindlessTable = table;
+    LOGI("✓ Bindless table created: %u slots", table->capacity);
+}
+
+void destroyBindlessTable(DeviceInfo* deviceInfo) {
+    BindlessTable* table = getTable(deviceInfo);
+    if (!table) return;
+
+    LOGI("Bindless table: %u slot writes, %u hits, peak %u slots", table->writes, table->hits, table->peak);
+    if (!table->liveSlots.empty()) {
+        LOGE("Bindless table: %zu slots still referenced at device destruction", table->liveSlots.size());
+    }
+    destroyTableObjects(deviceInfo, table);
+    delete table;
+    deviceInfo->bindlessTable = nullptr;
+}
+
+VkDescriptorSetLayout bindlessSetLayout(DeviceInfo* deviceInfo) {
+    BindlessTable* table = getTable(deviceInfo);
+    return table ? table->setLayout : VK_NULL_HANDLE;
+}
+
+uint32_t bindlessCapacity(DeviceInfo* deviceInfo) {
+    BindlessTable* table = getTable(deviceInfo);
+    return table ? table->capacity : 0;
+}
+
+// ============================================
+// Slots
+// ============================================
+int32_t acquireBindlessSlot(DeviceInfo* deviceInfo, VkImageView view, VkSampler sampler) {
+    BindlessTable* table = getTable(deviceInfo);
+    if (!table || view == VK_NULL_HANDLE || sampler == VK_NULL_HANDLE) return -1;
+
+    std::lock_guard<std::mutex> lock(table->mutex);
+    auto it = table->liveSlots.find(slotKey(view, sampler));
+    if (it != table->liveSlots.end()) {
+        table->hits++;
+        table->slots[it->second].refCount++;
+        return static_cast<int32_t>(it->second);
+    }
+
+    const int32_t index = findFreeSlot(deviceInfo, table);
+    if (index < 0) {
+        LOGE("Bindless table full (%u slots in use or retiring)", table->capacity);
+        return -1;
+    }
+
+    // UPDATE_AFTER_BIND：表可以已经绑定在未完成的命令缓冲里，这个槽本身没有被它们使用
+    VkDescriptorImageInfo imageInfo{};
+    imageInfo.sampler = sampler;
+    imageInfo.imageView = view;
+    imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+    VkWriteDescriptorSet write{};
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = table->set;
+    write.dstBinding = 0;
+    write.dstArrayElement = static_cast<uint32_t>(index);
+    write.descriptorCount = 1;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    write.pImageInfo = &imageInfo;
+    vkUpdateDescriptorSets(deviceInfo->device, 1, &write, 0, nullptr);
+
+    BindlessTable::Slot& slot = table->slots[index];
+    slot.view = view;
+    slot.sampler = sampler;
+    slot.refCount = 1;
+    slot.written = true;
+    table->liveSlots[slotKey(view, sampler)] = static_cast<uint32_t>(index);
+    table->writes++;
+    table->peak = std::max(table->peak, static_cast<uint32_t>(table->liveSlots.size()));
+    return index;
+}
+
+void releaseBindlessSlot(DeviceInfo* deviceInfo, int32_t slot) {
+    BindlessTable* table = getTable(deviceInfo);
+    if (!table || slot < 0 || static_cast<uint32_t>(slot) >= table->capacity) return;
+
+    std::lock_guard<std::mutex> lock(table->mutex);
+    BindlessTable::Slot& entry = table->slots[slot];
+    if (entry.refCount == 0) return;
+    if (--entry.refCount > 0) return;
+
+    // 视图随后可能被销毁、句柄被复用，归零后不再按 (视图, sampler) 命中
+    table->liveSlots.erase(slotKey(entry.view, entry.sampler));
+    entry.retiredFrame = deviceInfo->frameSerial;
+}
+
+bool bindBindlessTable(DeviceInfo* deviceInfo, VkCommandBuffer commandBuffer, VkPipelineBindPoint bindPoint,
+                       VkPipelineLayout pipelineLayout, uint32_t set) {
+    BindlessTable* table = getTable(deviceInfo);
+    if (!table) return false;
+
+    vkCmdBindDescriptorSets(commandBuffer, bindPoint, pipelineLayout, set, 1, &table->set, 0, nullptr);
+    return true;
+}
+
+// ============================================
+// JNI: BindlessTable
+// ============================================
+
+// 没有表（设备不支持描述符索引）时返回 0
+extern "C" JNIEXPORT jint JNICALL
+Java_com_genymobile_scrcpy_vulkan_BindlessTable_nativeCapacity(
+        JNIEnv* env, jobject /* this */, jlong deviceHandle) {
+
+    DeviceInfo* deviceInfo = getDeviceInfo(deviceHandle);
+    if (!validateHandle(deviceInfo, "device")) {
+        return 0;
+    }
+    return static_cast<jint>(bindlessCapacity(deviceInfo));
+}
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_genymobile_scrcpy_vulkan_BindlessTable_nativeAcquire(
+        JNIEnv* env, jobject /* this */, jlong deviceHandle, jlong viewHandle, jlong samplerHandle) {
+
+    DeviceInfo* deviceInfo = getDeviceInfo(deviceHandle);
+    VkImageView view = fromHandle<VkImageView>(viewHandle);
+    VkSampler sampler = fromHandle<VkSampler>(samplerHandle);
+    if (!validateHandle(deviceInfo, "device") || !validateHandle(view, "imageView") ||
+        !validateHandle(sampler, "sampler")) {
+        return -1;
+    }
+    return acquireBindlessSlot(deviceInfo, view, sampler);
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_genymobile_scrcpy_vulkan_BindlessTable_nativeRelease(
+        JNIEnv* env, jobject /* this */, jlong deviceHandle, jint slot) {
+
+    DeviceInfo* deviceInfo = getDeviceInfo(deviceHandle);
+    if (validateHandle(deviceInfo, "device")) {
+        releaseBindlessSlot(deviceInfo, slot);
+    }
+}
+
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_genymobile_scrcpy_vulkan_BindlessTable_nativeBind(
+        JNIEnv* env, jobject /* this */,
+        jlong deviceHandle,
+        jlong commandBufferHandle,
+        jboolean compute,
+        jlong pipelineLayoutHandle,
+        jint set) {
+
+    DeviceInfo* deviceInfo = getDeviceInfo(deviceHandle);
+    VkCommandBuffer commandBuffer = fromHandle<VkCommandBuffer>(commandBufferHandle);
+    VkPipelineLayout pipelineLayout = fromHandle<VkPipelineLayout>(pipelineLayoutHandle);
+    if (!validateHandle(deviceInfo, "device") || !validateHandle(commandBuffer, "commandBuffer") ||
+        !validateHandle(pipelineLayout, "pipelineLayout") || set < 0) {
+        return JNI_FALSE;
+    }
+
+    const VkPipelineBindPoint bindPoint = compute == JNI_TRUE ? VK_PIPELINE_BIND_POINT_COMPUTE
+                                                              : VK_PIPELINE_BIND_POINT_GRAPHICS;
+    return bindBindlessTable(deviceInfo, commandBuffer, bindPoint, pipelineLayout, static_cast<uint32_t>(set))
+           ? JNI_TRUE : JNI_FALSE;
+}
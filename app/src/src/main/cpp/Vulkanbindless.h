@@ -0,0 +1,55 @@
+//
+// Bindless input texture table: one partially-bound sampler2D array per device (VK_EXT_descriptor_indexing).
+//
+// 多路输入合成（画中画、拼接）按 DescriptorManager 的方式每个来源各绑定一个 set：N 个来源每帧
+// N 次 vkCmdBindDescriptorSets，来源增减时还要改写 set。设备支持描述符索引时改为每个设备一张表：
+// - 一个 set，binding 0 为 COMBINED_IMAGE_SAMPLER 数组（capacity 个，PARTIALLY_BOUND，
+//   没写过的槽只要着色器不访问就合法）；
+// - 每个输入纹理（视图 + sampler）占一个稳定的槽，着色器通过 push constant 里的下标选择来源，
+//   合成任意多个来源每次绘制只绑定一次 set；
+// - 槽以 UPDATE_AFTER_BIND | UPDATE_UNUSED_WHILE_PENDING 创建：新来源写入空闲槽时不需要等待
+//   已提交的命令缓冲。释放的槽要等 framesInFlight 帧之后才会被改写（与 DescriptorManager 相同的
+//   帧序号，见 Vulkandescriptors.h），所以从不改写 GPU 可能仍在读取的描述符。
+//
+// 着色器以 `layout(set = N, binding = 0) uniform sampler2D sources[];` 声明表，acquireReflectedLayout
+// 把这样的 set 替换为表的 layout（见 Vulkanlayoutcache.h 的 bindlessSet）。
+// 设备不支持时不建表，调用方回退到每个来源一个 set（CompositeVulkanFilter 的 composite_single.frag）。
+//
+#ifndef VULKAN_BINDLESS_H
+#define VULKAN_BINDLESS_H
+
+#include <vulkan/vulkan.h>
+#include <vector>
+#include "Vulkantypes.h"
+
+// 创建设备前调用：需要 Vulkan 1.1、VK_EXT_descriptor_indexing 以及 runtimeDescriptorArray、
+// descriptorBindingPartiallyBound、descriptorBindingSampledImageUpdateAfterBind、
+// descriptorBindingUpdateUnusedWhilePending。支持时追加扩展、填好要启用的 features
+// （串进 VkDeviceCreateInfo 的 pNext），并在 coreFeatures 中打开 shaderSampledImageArrayDynamicIndexing
+bool queryDescriptorIndexingSupport(VkPhysicalDevice physicalDevice,
+                                    std::vector<const char*>* extensions,
+                                    VkPhysicalDeviceDescriptorIndexingFeaturesEXT* features,
+                                    VkPhysicalDeviceFeatures* coreFeatures);
+
+// 创建设备后调用；enabled 为 false 或建表失败时 deviceInfo->bindlessTable 保持为空
+void initBindlessTable(DeviceInfo* deviceInfo, bool enabled);
+
+// 在 destroyLayoutCache 之后、destroySamplerCache 之前调用（表里的描述符引用缓存的 sampler）
+void destroyBindlessTable(DeviceInfo* deviceInfo);
+
+// 表的 set layout / 槽数；没有表时为 VK_NULL_HANDLE / 0
+VkDescriptorSetLayout bindlessSetLayout(DeviceInfo* deviceInfo);
+uint32_t bindlessCapacity(DeviceInfo* deviceInfo);
+
+// 为 (view, sampler) 取得槽号，引用计数 +1：组合已经占有槽时直接返回，否则写入一个空闲槽。
+// view 在采样时必须处于 SHADER_READ_ONLY_OPTIMAL。表满或没有表时返回 -1
+int32_t acquireBindlessSlot(DeviceInfo* deviceInfo, VkImageView view, VkSampler sampler);
+
+// 引用计数 -1；归零后槽在 framesInFlight 帧之后才会被改写，视图可以在这之后销毁
+void releaseBindlessSlot(DeviceInfo* deviceInfo, int32_t slot);
+
+// 把表绑定到 pipelineLayout 的 set（该 set 必须是表的 layout）；没有表时返回 false
+bool bindBindlessTable(DeviceInfo* deviceInfo, VkCommandBuffer commandBuffer, VkPipelineBindPoint bindPoint,
+                       VkPipelineLayout pipelineLayout, uint32_t set);
+
+#endif // VULKAN_BINDLESS_H
@@ -2,13 +2,13 @@
 // Created by 31483 on 2025/11/28.
 //
 #include <jni.h>
-#include <android/log.h>
+#include "Vulkanlog.h"
 #include <vulkan/vulkan.h>
 #include "VulkanTypes.h"
 
 #define LOG_TAG "VulkanCommand"
-#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
-#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+#define LOGI(...) VLOGI(LOG_TAG, __VA_ARGS__)
+#define LOGE(...) VLOGE(LOG_TAG, __VA_ARGS__)
 
 // 创建CommandPool
 extern "C" JNIEXPORT jlong JNICALL
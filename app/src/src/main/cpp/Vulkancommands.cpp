@@ -22,41 +22,6 @@ Java_com_genymobile_scrcpy_vulkan_SimpleVulkanFilter_nativeBindPipeline(
     }
 
     vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
-    LOGD("✓ Pipeline bound");
-}
-
-// ============================================
-// Descriptor Sets Binding
-// ============================================
-extern "C" JNIEXPORT void JNICALL
-Java_com_genymobile_scrcpy_vulkan_SimpleVulkanFilter_nativeBindDescriptorSets(
-        JNIEnv* env, jobject /* this */,
-        jlong commandBufferHandle,
-        jlong pipelineLayoutHandle,
-        jlong descriptorSetHandle) {
-
-    VkCommandBuffer commandBuffer = fromHandle<VkCommandBuffer>(commandBufferHandle);
-    VkPipelineLayout pipelineLayout = fromHandle<VkPipelineLayout>(pipelineLayoutHandle);
-    VkDescriptorSet descriptorSet = fromHandle<VkDescriptorSet>(descriptorSetHandle);
-
-    if (!validateHandle(commandBuffer, "commandBuffer") ||
-        !validateHandle(pipelineLayout, "pipelineLayout") ||
-        !validateHandle(descriptorSet, "descriptorSet")) {
-        return;
-    }
-
-    vkCmdBindDescriptorSets(
-            commandBuffer,
-            VK_PIPELINE_BIND_POINT_GRAPHICS,
-            pipelineLayout,
-            0,  // firstSet
-            1,  // descriptorSetCount
-            &descriptorSet,
-            0,  // dynamicOffsetCount
-            nullptr
-    );
-
-    LOGD("✓ Descriptor sets bound");
 }
 
 // ============================================
@@ -67,6 +32,7 @@ Java_com_genymobile_scrcpy_vulkan_SimpleVulkanFilter_nativePushConstants(
         JNIEnv* env, jobject /* this */,
         jlong commandBufferHandle,
         jlong pipelineLayoutHandle,
+        jint stageFlags,
         jfloatArray dataArray) {
 
     VkCommandBuffer commandBuffer = fromHandle<VkCommandBuffer>(commandBufferHandle);
@@ -97,18 +63,12 @@ Java_com_genymobile_scrcpy_vulkan_SimpleVulkanFilter_nativePushConstants(
     vkCmdPushConstants(
             commandBuffer,
             pipelineLayout,
-            VK_SHADER_STAGE_FRAGMENT_BIT,
+            static_cast<VkShaderStageFlags>(stageFlags),  // 与反射出的 push constant 范围一致
             0,  // offset
             dataSize * sizeof(float),
             data
     );
 
-    // Periodic logging for debugging
-    static int logCounter = 0;
-    if (logCounter++ % 100 == 0) {
-        LOGD("Push constants: res=(%.0f, %.0f), time=%.2f", data[0], data[1], data[2]);
-    }
-
     env->ReleaseFloatArrayElements(dataArray, data, JNI_ABORT);
 }
 
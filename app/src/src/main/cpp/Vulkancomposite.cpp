@@ -0,0 +1,175 @@
+//
+// Multi-source compositor: JNI for CompositeVulkanFilter (bindless table or one descriptor set per layer).
+//
+#include "Vulkanjni.h"
+#include "Vulkanpipelineregistry.h"
+#include "Vulkansamplers.h"
+#include <algorithm>
+#include <vector>
+
+using namespace VulkanJNI;
+
+namespace {
+
+    constexpr uint32_t kSpirvMagic = 0x07230203;
+
+    // affine.vert 的 push constant 块：tex_matrix + user_matrix；composite.frag 在其后加一个 int 槽号
+    constexpr uint32_t kMatrixBytes = 16 * sizeof(float);
+
+    struct CompositePushConstants {
+        float texMatrix[16];
+        float userMatrix[16];
+        int32_t source;
+    };
+    static_assert(sizeof(CompositePushConstants) == 132, "composite.frag push constant block");
+
+} // anonymous namespace
+
+// ============================================
+// JNI: CompositeVulkanFilter
+// ============================================
+
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_genymobile_scrcpy_vulkan_CompositeVulkanFilter_nativeCreateShaderModule(
+        JNIEnv* env, jobject /* this */, jlong deviceHandle, jbyteArray codeArray) {
+
+    DeviceInfo* deviceInfo = getDeviceInfo(deviceHandle);
+    if (!validateHandle(deviceInfo, "device") || !codeArray) {
+        return 0;
+    }
+    const jsize size = env->GetArrayLength(codeArray);
+    if (size < 20 || size % 4 != 0) {
+        LOGE("Invalid SPIR-V size: %d bytes", size);
+        return 0;
+    }
+
+    // 按 uint32_t 对齐复制
+    std::vector<uint32_t> code(size / 4);
+    env->GetByteArrayRegion(codeArray, 0, size, reinterpret_cast<jbyte*>(code.data()));
+    if (code[0] != kSpirvMagic) {
+        LOGE("Invalid SPIR-V magic: 0x%08x", code[0]);
+        return 0;
+    }
+
+    VkShaderModuleCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    createInfo.codeSize = static_cast<size_t>(size);
+    createInfo.pCode = code.data();
+
+    VkShaderModule shaderModule = VK_NULL_HANDLE;
+    VkResult result = vkCreateShaderModule(deviceInfo->device, &createInfo, nullptr, &shaderModule);
+    if (!validateResult(result, "vkCreateShaderModule (composite)")) {
+        return 0;
+    }
+    registerShaderModule(deviceInfo, shaderModule, code.data(), static_cast<size_t>(size));
+    return toHandle(shaderModule);
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_genymobile_scrcpy_vulkan_CompositeVulkanFilter_nativeDestroyShaderModule(
+        JNIEnv* env, jobject /* this */, jlong deviceHandle, jlong shaderModuleHandle) {
+
+    DeviceInfo* deviceInfo = getDeviceInfo(deviceHandle);
+    VkShaderModule shaderModule = fromHandle<VkShaderModule>(shaderModuleHandle);
+    if (validateHandle(deviceInfo, "device") && shaderModule != VK_NULL_HANDLE) {
+        unregisterShaderModule(deviceInfo, shaderModule);
+        vkDestroyShaderModule(deviceInfo->device, shaderModule, nullptr);
+    }
+}
+
+// 双线性 + CLAMP_TO_EDGE：层外的像素由 composite.frag 丢弃
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_genymobile_scrcpy_vulkan_CompositeVulkanFilter_nativeCreateSampler(
+        JNIEnv* env, jobject /* this */, jlong deviceHandle) {
+
+    DeviceInfo* deviceInfo = getDeviceInfo(deviceHandle);
+    if (!validateHandle(deviceInfo, "device")) {
+        return 0;
+    }
+
+    VkSamplerCreateInfo samplerInfo{};
+    samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerInfo.magFilter = VK_FILTER_LINEAR;
+    samplerInfo.minFilter = VK_FILTER_LINEAR;
+    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.maxAnisotropy = 1.0f;
+    samplerInfo.compareOp = VK_COMPARE_OP_ALWAYS;
+    samplerInfo.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
+
+    return toHandle(acquireSampler(deviceInfo, samplerInfo));
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_genymobile_scrcpy_vulkan_CompositeVulkanFilter_nativeDestroySampler(
+        JNIEnv* env, jobject /* this */, jlong deviceHandle, jlong samplerHandle) {
+
+    DeviceInfo* deviceInfo = getDeviceInfo(deviceHandle);
+    VkSampler sampler = fromHandle<VkSampler>(samplerHandle);
+    if (validateHandle(deviceInfo, "device")) {
+        releaseSampler(deviceInfo, sampler);
+    }
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_genymobile_scrcpy_vulkan_CompositeVulkanFilter_nativeBindPipeline(
+        JNIEnv* env, jobject /* this */, jlong commandBufferHandle, jlong pipelineHandle) {
+
+    VkCommandBuffer commandBuffer = fromHandle<VkCommandBuffer>(commandBufferHandle);
+    VkPipeline pipeline = fromHandle<VkPipeline>(pipelineHandle);
+    if (!validateHandle(commandBuffer, "commandBuffer") || !validateHandle(pipeline, "pipeline")) {
+        return;
+    }
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+}
+
+// 每层推送自己的 tex_matrix + user_matrix（matrices 中每层 32 个 float），并画全屏三角形。
+// slots 不为 null 时（bindless 路径）在矩阵之后推送该层的槽号，所有层在一次 JNI 调用里录制完；
+// 为 null 时只推送矩阵，调用方每层绑定自己的 descriptor set 后逐层调用
+extern "C" JNIEXPORT void JNICALL
+Java_com_genymobile_scrcpy_vulkan_CompositeVulkanFilter_nativeDrawLayers(
+        JNIEnv* env, jobject /* this */,
+        jlong commandBufferHandle,
+        jlong pipelineLayoutHandle,
+        jint stageFlags,
+        jfloatArray matrixArray,
+        jintArray slotArray) {
+
+    VkCommandBuffer commandBuffer = fromHandle<VkCommandBuffer>(commandBufferHandle);
+    VkPipelineLayout pipelineLayout = fromHandle<VkPipelineLayout>(pipelineLayoutHandle);
+    if (!validateHandle(commandBuffer, "commandBuffer") || !validateHandle(pipelineLayout, "pipelineLayout") ||
+        !matrixArray) {
+        return;
+    }
+
+    const jsize layerCount = env->GetArrayLength(matrixArray) / 32;
+    std::vector<jfloat> matrices(static_cast<size_t>(layerCount) * 32);
+    env->GetFloatArrayRegion(matrixArray, 0, layerCount * 32, matrices.data());
+
+    std::vector<jint> slots;
+    if (slotArray) {
+        if (env->GetArrayLength(slotArray) < layerCount) {
+            LOGE("Composite: %d layers but only %d slots", layerCount, env->GetArrayLength(slotArray));
+            return;
+        }
+        slots.resize(static_cast<size_t>(layerCount));
+        env->GetIntArrayRegion(slotArray, 0, layerCount, slots.data());
+    }
+
+    CompositePushConstants constants{};
+    const uint32_t size = slotArray ? sizeof(CompositePushConstants) : 2 * kMatrixBytes;
+    const auto stages = static_cast<VkShaderStageFlags>(stageFlags);
+
+    for (jsize layer = 0; layer < layerCount; layer++) {
+        // 槽号为负的层（来源尚未就绪）跳过
+        if (slotArray && slots[layer] < 0) continue;
+        const jfloat* layerMatrices = matrices.data() + layer * 32;
+        std::copy(layerMatrices, layerMatrices + 16, constants.texMatrix);
+        std::copy(layerMatrices + 16, layerMatrices + 32, constants.userMatrix);
+        constants.source = slotArray ? slots[layer] : 0;
+        vkCmdPushConstants(commandBuffer, pipelineLayout, stages, 0, size, &constants);
+        vkCmdDraw(commandBuffer, 3, 1, 0, 0);
+    }
+}
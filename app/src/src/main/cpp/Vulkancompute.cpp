@@ -0,0 +1,670 @@
+//
+// Compute-shader output path: filters write storage images instead of rasterizing.
+//
+#include "Vulkanjni.h"
+#include "Vulkancompute.h"
+#include "Vulkanrendertarget.h"
+#include "Vulkanbarriers.h"
+#include <algorithm>
+
+using namespace VulkanJNI;
+
+extern uint32_t findMemoryType(VkPhysicalDevice physicalDevice, uint32_t typeFilter, VkMemoryPropertyFlags properties);
+
+namespace {
+
+    // 计算着色器声明的存储格式（affine.comp: layout(rgba8)）
+    constexpr VkFormat kStorageFormat = VK_FORMAT_R8G8B8A8_UNORM;
+
+    bool hasFormatFeatures(DeviceInfo* deviceInfo, VkFormat format, VkFormatFeatureFlags features) {
+        VkFormatProperties properties;
+        vkGetPhysicalDeviceFormatProperties(deviceInfo->physicalDevice, format, &properties);
+        return (properties.optimalTilingFeatures & features) == features;
+    }
+
+} // anonymous namespace
+
+// ============================================
+// Storage Images
+// ============================================
+bool createStorageImage(DeviceInfo* deviceInfo, uint32_t width, uint32_t height, VkImageUsageFlags extraUsage,
+                        VkImage* image, VkDeviceMemory* memory, VkImageView* imageView) {
+    VkDevice device = deviceInfo->device;
+
+    VkImageCreateInfo imageInfo{};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.extent = {width, height, 1};
+    imageInfo.mipLevels = 1;
+    imageInfo.arrayLayers = 1;
+    imageInfo.format = kStorageFormat;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    imageInfo.usage = VK_IMAGE_USAGE_STORAGE_BIT | extraUsage;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    VkResult result = vkCreateImage(device, &imageInfo, nullptr, image);
+    if (!validateResult(result, "vkCreateImage (storage)")) return false;
+
+    VkMemoryRequirements memRequirements;
+    vkGetImageMemoryRequirements(device, *image, &memRequirements);
+
+    VkMemoryAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.allocationSize = memRequirements.size;
+    allocInfo.memoryTypeIndex = findMemoryType(deviceInfo->physicalDevice,
+                                               memRequirements.memoryTypeBits,
+                                               VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+    result = vkAllocateMemory(device, &allocInfo, nullptr, memory);
+    if (!validateResult(result, "vkAllocateMemory (storage)")) return false;
+    vkBindImageMemory(device, *image, *memory, 0);
+    registerTrackedImage(deviceInfo, *image, imageInfo.usage);
+
+    VkImageViewCreateInfo viewInfo{};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image = *image;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format = kStorageFormat;
+    viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    viewInfo.subresourceRange.baseMipLevel = 0;
+    viewInfo.subresourceRange.levelCount = 1;
+    viewInfo.subresourceRange.baseArrayLayer = 0;
+    viewInfo.subresourceRange.layerCount = 1;
+
+    result = vkCreateImageView(device, &viewInfo, nullptr, imageView);
+    return validateResult(result, "vkCreateImageView (storage)");
+}
+
+void destroyStorageImage(DeviceInfo* deviceInfo, VkImage* image, VkDeviceMemory* memory, VkImageView* imageView) {
+    VkDevice device = deviceInfo->device;
+    if (*imageView != VK_NULL_HANDLE) vkDestroyImageView(device, *imageView, nullptr);
+    if (*image != VK_NULL_HANDLE) {
+        unregisterTrackedImage(deviceInfo, *image);
+        vkDestroyImage(device, *image, nullptr);
+    }
+    if (*memory != VK_NULL_HANDLE) vkFreeMemory(device, *memory, nullptr);
+    *imageView = VK_NULL_HANDLE;
+    *image = VK_NULL_HANDLE;
+    *memory = VK_NULL_HANDLE;
+}
+
+namespace {
+
+    bool createIntermediateImage(DeviceInfo* deviceInfo, ComputeOutput* output, VkExtent2D extent) {
+        destroyStorageImage(deviceInfo, &output->image, &output->memory, &output->imageView);
+        output->extent = extent;
+        return createStorageImage(deviceInfo, extent.width, extent.height, VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+                                  &output->image, &output->memory, &output->imageView);
+    }
+
+} // anonymous namespace
+
+// ============================================
+// Swapchain Setup
+// ============================================
+VkImageUsageFlags selectComputeSwapchainUsage(DeviceInfo* deviceInfo,
+                                              const VkSurfaceCapabilitiesKHR& capabilities,
+                                              const std::vector<VkSurfaceFormatKHR>& formats,
+                                              VkSurfaceFormatKHR* surfaceFormat) {
+    if (!deviceInfo->computeOutputRequested) return 0;
+
+    // 直接写交换链：格式必须与 shader 的 rgba8 一致
+    if ((capabilities.supportedUsageFlags & VK_IMAGE_USAGE_STORAGE_BIT) != 0 &&
+        hasFormatFeatures(deviceInfo, kStorageFormat, VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT)) {
+        for (const auto& format : formats) {
+            if (format.format == kStorageFormat && format.colorSpace == VK_COLOR_SPACE_SRGB_NONLINEAR_KHR) {
+                *surfaceFormat = format;
+                LOGI("Compute output: swapchain images used as storage images");
+                return VK_IMAGE_USAGE_STORAGE_BIT;
+            }
+        }
+    }
+
+    // 回退：中间图像复制到交换链
+    if ((capabilities.supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_DST_BIT) != 0) {
+        LOGI("Compute output: storage swapchain unavailable, using intermediate image");
+        return VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+    }
+    LOGE("Compute output: swapchain supports neither STORAGE nor TRANSFER_DST usage");
+    return 0;
+}
+
+// ============================================
+// Compute Output
+// ============================================
+ComputeOutput* createComputeOutput(DeviceInfo* deviceInfo, SwapchainInfo* swapchainInfo) {
+    ComputeOutput* output = new ComputeOutput();
+
+    if ((swapchainInfo->usage & VK_IMAGE_USAGE_STORAGE_BIT) != 0 &&
+        swapchainInfo->format.format == kStorageFormat) {
+        output->direct = true;
+        LOGI("✓ Compute output created: direct, %ux%u",
+             swapchainInfo->extent.width, swapchainInfo->extent.height);
+        return output;
+    }
+
+    if ((swapchainInfo->usage & VK_IMAGE_USAGE_TRANSFER_DST_BIT) == 0) {
+        LOGE("Swapchain was created without TRANSFER_DST usage, compute output unavailable");
+        delete output;
+        return nullptr;
+    }
+
+    // 格式相同时直接 copy；不同（通常是 BGRA）时用 blit 做通道转换
+    output->blit = swapchainInfo->format.format != kStorageFormat;
+    if (output->blit &&
+        (!hasFormatFeatures(deviceInfo, kStorageFormat, VK_FORMAT_FEATURE_BLIT_SRC_BIT) ||
+         !hasFormatFeatures(deviceInfo, swapchainInfo->format.format, VK_FORMAT_FEATURE_BLIT_DST_BIT))) {
+        LOGE("Blit from R8G8B8A8 to swapchain format %d not supported", swapchainInfo->format.format);
+        delete output;
+        return nullptr;
+    }
+
+    if (!createIntermediateImage(deviceInfo, output, swapchainInfo->extent)) {
+        destroyComputeOutput(deviceInfo, output);
+        return nullptr;
+    }
+    LOGI("✓ Compute output created: intermediate %ux%u (%s)",
+         output->extent.width, output->extent.height, output->blit ? "blit" : "copy");
+    return output;
+}
+
+void destroyComputeOutput(DeviceInfo* deviceInfo, ComputeOutput* output) {
+    if (!output) return;
+    destroyStorageImage(deviceInfo, &output->image, &output->memory, &output->imageView);
+    delete output;
+}
+
+VkImageView beginComputeOutput(DeviceInfo* deviceInfo, VkCommandBuffer commandBuffer,
+                               SwapchainInfo* swapchainInfo, uint32_t imageIndex,
+                               ComputeOutput* output, bool load) {
+    ImageBarrierBatch barriers;
+    if (output->direct) {
+        // LOAD：保留上次呈现的内容（PRESENT_SRC → GENERAL 不丢弃数据）
+        addImageTransition(&barriers, swapchainInfo->images[imageIndex],
+                           load ? VK_IMAGE_LAYOUT_PRESENT_SRC_KHR : VK_IMAGE_LAYOUT_UNDEFINED,
+                           VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR, VK_ACCESS_2_NONE_KHR,
+                           ImageUses::kStorageWrite);
+        flushImageBarriers(deviceInfo, &barriers, commandBuffer);
+        return swapchainInfo->imageViews[imageIndex];
+    }
+
+    // 交换链重建后尺寸变化：中间图像可能仍被上一帧使用，等待队列空闲后重建（很少发生）
+    if (output->extent.width != swapchainInfo->extent.width ||
+        output->extent.height != swapchainInfo->extent.height) {
+        vkQueueWaitIdle(deviceInfo->graphicsQueue);
+        if (!createIntermediateImage(deviceInfo, output, swapchainInfo->extent)) {
+            return VK_NULL_HANDLE;
+        }
+    }
+
+    // 上一帧的 copy/blit 读完后才能覆盖（第一次使用时从 UNDEFINED 转换）
+    requireImageUse(deviceInfo, &barriers, output->image, ImageUses::kStorageWrite, true);
+    flushImageBarriers(deviceInfo, &barriers, commandBuffer);
+    return output->imageView;
+}
+
+void endComputeOutput(DeviceInfo* deviceInfo, VkCommandBuffer commandBuffer,
+                      SwapchainInfo* swapchainInfo, uint32_t imageIndex,
+                      ComputeOutput* output, bool load, const std::vector<VkRect2D>& rects) {
+    VkImage swapchainImage = swapchainInfo->images[imageIndex];
+    ImageBarrierBatch barriers;
+
+    // present 由信号量同步，这里不需要目标阶段
+    if (output->direct) {
+        addImageTransition(&barriers, swapchainImage, VK_IMAGE_LAYOUT_GENERAL,
+                           VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR,
+                           ImageUses::kPresent);
+        flushImageBarriers(deviceInfo, &barriers, commandBuffer);
+        return;
+    }
+
+    // 中间图像留在 GENERAL 作为源，交换链图像转换为目标：两个 barrier 一次提交
+    const VkPipelineStageFlags2KHR transferStage =
+            output->blit ? VK_PIPELINE_STAGE_2_BLIT_BIT_KHR : VK_PIPELINE_STAGE_2_COPY_BIT_KHR;
+    const ImageUse sourceUse = {VK_IMAGE_LAYOUT_GENERAL, transferStage, VK_ACCESS_2_TRANSFER_READ_BIT_KHR};
+    const ImageUse targetUse = {VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, transferStage, VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR};
+    requireImageUse(deviceInfo, &barriers, output->image, sourceUse);
+    addImageTransition(&barriers, swapchainImage,
+                       load ? VK_IMAGE_LAYOUT_PRESENT_SRC_KHR : VK_IMAGE_LAYOUT_UNDEFINED,
+                       VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR, VK_ACCESS_2_NONE_KHR,
+                       targetUse);
+    flushImageBarriers(deviceInfo, &barriers, commandBuffer);
+
+    VkImageSubresourceLayers subresource{};
+    subresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    subresource.mipLevel = 0;
+    subresource.baseArrayLayer = 0;
+    subresource.layerCount = 1;
+
+    const int32_t maxX = static_cast<int32_t>(std::min(output->extent.width, swapchainInfo->extent.width));
+    const int32_t maxY = static_cast<int32_t>(std::min(output->extent.height, swapchainInfo->extent.height));
+
+    if (output->blit) {
+        std::vector<VkImageBlit> regions;
+        regions.reserve(rects.size());
+        for (const VkRect2D& rect : rects) {
+            const int32_t x0 = std::max(rect.offset.x, 0);
+            const int32_t y0 = std::max(rect.offset.y, 0);
+            const int32_t x1 = std::min(rect.offset.x + static_cast<int32_t>(rect.extent.width), maxX);
+            const int32_t y1 = std::min(rect.offset.y + static_cast<int32_t>(rect.extent.height), maxY);
+            if (x1 <= x0 || y1 <= y0) continue;
+
+            VkImageBlit region{};
+            region.srcSubresource = subresource;
+            region.srcOffsets[0] = {x0, y0, 0};
+            region.srcOffsets[1] = {x1, y1, 1};
+            region.dstSubresource = subresource;
+            region.dstOffsets[0] = {x0, y0, 0};
+            region.dstOffsets[1] = {x1, y1, 1};
+            regions.push_back(region);
+        }
+        if (!regions.empty()) {
+            // 1:1 blit，只做格式转换，NEAREST 即可
+            checkImageCommand(deviceInfo, output->image, sourceUse, "vkCmdBlitImage");
+            vkCmdBlitImage(commandBuffer, output->image, VK_IMAGE_LAYOUT_GENERAL,
+                           swapchainImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                           static_cast<uint32_t>(regions.size()), regions.data(), VK_FILTER_NEAREST);
+        }
+    } else {
+        std::vector<VkImageCopy> regions;
+        regions.reserve(rects.size());
+        for (const VkRect2D& rect : rects) {
+            const int32_t x0 = std::max(rect.offset.x, 0);
+            const int32_t y0 = std::max(rect.offset.y, 0);
+            const int32_t x1 = std::min(rect.offset.x + static_cast<int32_t>(rect.extent.width), maxX);
+            const int32_t y1 = std::min(rect.offset.y + static_cast<int32_t>(rect.extent.height), maxY);
+            if (x1 <= x0 || y1 <= y0) continue;
+
+            VkImageCopy region{};
+            region.srcSubresource = subresource;
+            region.srcOffset = {x0, y0, 0};
+            region.dstSubresource = subresource;
+            region.dstOffset = {x0, y0, 0};
+            region.extent = {static_cast<uint32_t>(x1 - x0), static_cast<uint32_t>(y1 - y0), 1};
+            regions.push_back(region);
+        }
+        if (!regions.empty()) {
+            checkImageCommand(deviceInfo, output->image, sourceUse, "vkCmdCopyImage");
+            vkCmdCopyImage(commandBuffer, output->image, VK_IMAGE_LAYOUT_GENERAL,
+                           swapchainImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                           static_cast<uint32_t>(regions.size()), regions.data());
+        }
+    }
+
+    addImageTransition(&barriers, swapchainImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                       transferStage, VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR, ImageUses::kPresent);
+    flushImageBarriers(deviceInfo, &barriers, commandBuffer);
+}
+
+// ============================================
+// Compute vs Raster Benchmark
+// ============================================
+// 同一个滤镜在离屏目标上分别用光栅化（全屏三角形 → RenderTarget）和计算（dispatch →
+// 存储图像）各执行 N 次，用 timestamp 分别统计两段的 GPU 时间。
+// 两个目标尺寸相同；每次迭代之间都有 barrier，避免驱动把多次写入合并或重叠执行。
+// 也可以两段都用光栅化目标（nativeMarkBenchmarkSplit 手动分段），对比两种滤镜实现。
+struct ComputeBenchmark {
+    DeviceInfo* deviceInfo = nullptr;
+    RenderTarget* renderTarget = nullptr;
+
+    VkImage storageImage = VK_NULL_HANDLE;
+    VkDeviceMemory storageMemory = VK_NULL_HANDLE;
+    VkImageView storageView = VK_NULL_HANDLE;
+    bool splitWritten = false;  // 本次录制已写入分段 timestamp（第二段已开始）
+
+    uint32_t width = 0;
+    uint32_t height = 0;
+
+    VkCommandPool commandPool = VK_NULL_HANDLE;
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+    VkFence fence = VK_NULL_HANDLE;
+
+    // [开始, 光栅化结束/计算开始, 计算结束]
+    VkQueryPool queryPool = VK_NULL_HANDLE;
+    float timestampPeriod = 0.0f;
+};
+
+namespace {
+
+    void destroyComputeBenchmark(DeviceInfo* deviceInfo, ComputeBenchmark* bench) {
+        if (!bench) return;
+        VkDevice device = deviceInfo->device;
+
+        if (bench->queryPool != VK_NULL_HANDLE) vkDestroyQueryPool(device, bench->queryPool, nullptr);
+        if (bench->fence != VK_NULL_HANDLE) vkDestroyFence(device, bench->fence, nullptr);
+        if (bench->commandPool != VK_NULL_HANDLE) vkDestroyCommandPool(device, bench->commandPool, nullptr);
+        destroyStorageImage(deviceInfo, &bench->storageImage, &bench->storageMemory, &bench->storageView);
+        destroyRenderTarget(deviceInfo, bench->renderTarget);
+        delete bench;
+    }
+
+    ComputeBenchmark* createComputeBenchmark(DeviceInfo* deviceInfo, uint32_t width, uint32_t height) {
+        VkDevice device = deviceInfo->device;
+        ComputeBenchmark* bench = new ComputeBenchmark();
+        bench->deviceInfo = deviceInfo;
+        bench->width = width;
+        bench->height = height;
+
+        // 光栅化目标使用交换链格式，与滤镜 pipeline 兼容
+        bench->renderTarget = createRenderTarget(deviceInfo, width, height, deviceInfo->colorFormat);
+        if (!bench->renderTarget ||
+            !createStorageImage(deviceInfo, width, height, 0,
+                                &bench->storageImage, &bench->storageMemory, &bench->storageView)) {
+            destroyComputeBenchmark(deviceInfo, bench);
+            return nullptr;
+        }
+
+        VkCommandPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+        poolInfo.queueFamilyIndex = deviceInfo->graphicsQueueFamily;
+        VkResult result = vkCreateCommandPool(device, &poolInfo, nullptr, &bench->commandPool);
+        if (!validateResult(result, "vkCreateCommandPool (benchmark)")) {
+            destroyComputeBenchmark(deviceInfo, bench);
+            return nullptr;
+        }
+
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.commandPool = bench->commandPool;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandBufferCount = 1;
+        result = vkAllocateCommandBuffers(device, &allocInfo, &bench->commandBuffer);
+        if (!validateResult(result, "vkAllocateCommandBuffers (benchmark)")) {
+            destroyComputeBenchmark(deviceInfo, bench);
+            return nullptr;
+        }
+
+        VkFenceCreateInfo fenceInfo{};
+        fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+        result = vkCreateFence(device, &fenceInfo, nullptr, &bench->fence);
+        if (!validateResult(result, "vkCreateFence (benchmark)")) {
+            destroyComputeBenchmark(deviceInfo, bench);
+            return nullptr;
+        }
+
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(deviceInfo->physicalDevice, &properties);
+        bench->timestampPeriod = properties.limits.timestampPeriod;
+
+        VkQueryPoolCreateInfo queryPoolInfo{};
+        queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        queryPoolInfo.queryCount = 3;
+        result = vkCreateQueryPool(device, &queryPoolInfo, nullptr, &bench->queryPool);
+        if (!validateResult(result, "vkCreateQueryPool (benchmark)")) {
+            destroyComputeBenchmark(deviceInfo, bench);
+            return nullptr;
+        }
+
+        LOGI("✓ Compute benchmark created: %ux%u", width, height);
+        return bench;
+    }
+
+    // 第一段到此结束；每次录制只写一次
+    void writeBenchmarkSplit(ComputeBenchmark* bench) {
+        if (!bench->splitWritten) {
+            vkCmdWriteTimestamp(bench->commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, bench->queryPool, 1);
+            bench->splitWritten = true;
+        }
+    }
+
+} // anonymous namespace
+
+// ============================================
+// JNI: VulkanRunner
+// ============================================
+extern "C" JNIEXPORT void JNICALL
+Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeRequestComputeOutput(
+        JNIEnv* env, jobject /* this */, jlong deviceHandle, jboolean enabled) {
+
+    DeviceInfo* deviceInfo = getDeviceInfo(deviceHandle);
+    if (validateHandle(deviceInfo, "device")) {
+        deviceInfo->computeOutputRequested = enabled == JNI_TRUE;
+    }
+}
+
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeCreateComputeOutput(
+        JNIEnv* env, jobject /* this */, jlong deviceHandle, jlong swapchainHandle) {
+
+    DeviceInfo* deviceInfo = getDeviceInfo(deviceHandle);
+    SwapchainInfo* swapchainInfo = fromHandle<SwapchainInfo*>(swapchainHandle);
+    if (!validateHandle(deviceInfo, "device") || !validateHandle(swapchainInfo, "swapchain")) {
+        return 0;
+    }
+    return toHandle(createComputeOutput(deviceInfo, swapchainInfo));
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeDestroyComputeOutput(
+        JNIEnv* env, jobject /* this */, jlong deviceHandle, jlong outputHandle) {
+
+    DeviceInfo* deviceInfo = getDeviceInfo(deviceHandle);
+    if (validateHandle(deviceInfo, "device")) {
+        destroyComputeOutput(deviceInfo, fromHandle<ComputeOutput*>(outputHandle));
+    }
+}
+
+// 返回计算着色器要写入的存储视图，失败返回 0
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeBeginComputeOutput(
+        JNIEnv* env, jobject /* this */,
+        jlong deviceHandle,
+        jlong commandBufferHandle,
+        jlong swapchainHandle,
+        jint imageIndex,
+        jlong outputHandle,
+        jboolean load) {
+
+    DeviceInfo* deviceInfo = getDeviceInfo(deviceHandle);
+    VkCommandBuffer commandBuffer = fromHandle<VkCommandBuffer>(commandBufferHandle);
+    SwapchainInfo* swapchainInfo = fromHandle<SwapchainInfo*>(swapchainHandle);
+    ComputeOutput* output = fromHandle<ComputeOutput*>(outputHandle);
+    if (!validateHandle(deviceInfo, "device") || !validateHandle(commandBuffer, "commandBuffer") ||
+        !validateHandle(swapchainInfo, "swapchain") || !validateHandle(output, "computeOutput")) {
+        return 0;
+    }
+    if (imageIndex < 0 || static_cast<size_t>(imageIndex) >= swapchainInfo->images.size()) {
+        LOGE("Invalid image index: %d", imageIndex);
+        return 0;
+    }
+
+    return toHandle(beginComputeOutput(deviceInfo, commandBuffer, swapchainInfo,
+                                       static_cast<uint32_t>(imageIndex), output, load == JNI_TRUE));
+}
+
+// rects: [x0, y0, w0, h0, ...]，为 null 表示整张图像
+extern "C" JNIEXPORT void JNICALL
+Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeEndComputeOutput(
+        JNIEnv* env, jobject /* this */,
+        jlong deviceHandle,
+        jlong commandBufferHandle,
+        jlong swapchainHandle,
+        jint imageIndex,
+        jlong outputHandle,
+        jboolean load,
+        jintArray rectArray) {
+
+    DeviceInfo* deviceInfo = getDeviceInfo(deviceHandle);
+    VkCommandBuffer commandBuffer = fromHandle<VkCommandBuffer>(commandBufferHandle);
+    SwapchainInfo* swapchainInfo = fromHandle<SwapchainInfo*>(swapchainHandle);
+    ComputeOutput* output = fromHandle<ComputeOutput*>(outputHandle);
+    if (!validateHandle(deviceInfo, "device") || !validateHandle(commandBuffer, "commandBuffer") ||
+        !validateHandle(swapchainInfo, "swapchain") || !validateHandle(output, "computeOutput")) {
+        return;
+    }
+    if (imageIndex < 0 || static_cast<size_t>(imageIndex) >= swapchainInfo->images.size()) {
+        LOGE("Invalid image index: %d", imageIndex);
+        return;
+    }
+
+    std::vector<VkRect2D> rects;
+    if (rectArray != nullptr) {
+        jsize count = env->GetArrayLength(rectArray);
+        std::vector<jint> values(count);
+        env->GetIntArrayRegion(rectArray, 0, count, values.data());
+        for (jsize i = 0; i + 3 < count; i += 4) {
+            if (values[i + 2] <= 0 || values[i + 3] <= 0) continue;
+            VkRect2D rect{};
+            rect.offset = {values[i], values[i + 1]};
+            rect.extent = {static_cast<uint32_t>(values[i + 2]), static_cast<uint32_t>(values[i + 3])};
+            rects.push_back(rect);
+        }
+    } else {
+        VkRect2D rect{};
+        rect.offset = {0, 0};
+        rect.extent = swapchainInfo->extent;
+        rects.push_back(rect);
+    }
+
+    endComputeOutput(deviceInfo, commandBuffer, swapchainInfo, static_cast<uint32_t>(imageIndex),
+                     output, load == JNI_TRUE, rects);
+}
+
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_genymobile_scrcpy_vulkan_VulkanBenchmarks_nativeCreateComputeBenchmark(
+        JNIEnv* env, jobject /* this */, jlong deviceHandle, jint width, jint height) {
+
+    DeviceInfo* deviceInfo = getDeviceInfo(deviceHandle);
+    if (!validateHandle(deviceInfo, "device")) {
+        return 0;
+    }
+    if (width <= 0 || height <= 0) {
+        LOGE("Invalid benchmark size: %dx%d", width, height);
+        return 0;
+    }
+    return toHandle(createComputeBenchmark(deviceInfo, static_cast<uint32_t>(width),
+                                           static_cast<uint32_t>(height)));
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_genymobile_scrcpy_vulkan_VulkanBenchmarks_nativeDestroyComputeBenchmark(
+        JNIEnv* env, jobject /* this */, jlong deviceHandle, jlong benchHandle) {
+
+    DeviceInfo* deviceInfo = getDeviceInfo(deviceHandle);
+    if (validateHandle(deviceInfo, "device")) {
+        destroyComputeBenchmark(deviceInfo, fromHandle<ComputeBenchmark*>(benchHandle));
+    }
+}
+
+// 开始录制，返回命令缓冲
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_genymobile_scrcpy_vulkan_VulkanBenchmarks_nativeBeginComputeBenchmark(
+        JNIEnv* env, jobject /* this */, jlong benchHandle) {
+
+    ComputeBenchmark* bench = fromHandle<ComputeBenchmark*>(benchHandle);
+    if (!validateHandle(bench, "benchmark")) {
+        return 0;
+    }
+
+    vkResetCommandBuffer(bench->commandBuffer, 0);
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    vkBeginCommandBuffer(bench->commandBuffer, &beginInfo);
+
+    vkCmdResetQueryPool(bench->commandBuffer, bench->queryPool, 0, 3);
+    vkCmdWriteTimestamp(bench->commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, bench->queryPool, 0);
+    return toHandle(bench->commandBuffer);
+}
+
+// 一次光栅化迭代的开始/结束：离屏 pass（viewport/scissor 为整个目标）
+extern "C" JNIEXPORT void JNICALL
+Java_com_genymobile_scrcpy_vulkan_VulkanBenchmarks_nativeBeginBenchmarkRasterPass(
+        JNIEnv* env, jobject /* this */, jlong benchHandle) {
+
+    ComputeBenchmark* bench = fromHandle<ComputeBenchmark*>(benchHandle);
+    if (validateHandle(bench, "benchmark")) {
+        beginRenderTargetPass(bench->commandBuffer, bench->renderTarget, bench->width, bench->height);
+    }
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_genymobile_scrcpy_vulkan_VulkanBenchmarks_nativeEndBenchmarkRasterPass(
+        JNIEnv* env, jobject /* this */, jlong benchHandle) {
+
+    ComputeBenchmark* bench = fromHandle<ComputeBenchmark*>(benchHandle);
+    if (validateHandle(bench, "benchmark")) {
+        endRenderTargetPass(bench->commandBuffer, bench->renderTarget);
+    }
+}
+
+// 一次计算迭代之前调用：等上一次写入完成（WAW），返回存储视图
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_genymobile_scrcpy_vulkan_VulkanBenchmarks_nativeBeginBenchmarkComputePass(
+        JNIEnv* env, jobject /* this */, jlong benchHandle) {
+
+    ComputeBenchmark* bench = fromHandle<ComputeBenchmark*>(benchHandle);
+    if (!validateHandle(bench, "benchmark")) {
+        return 0;
+    }
+
+    // 第一次计算迭代前写入分段 timestamp：光栅化部分到此结束
+    writeBenchmarkSplit(bench);
+
+    // 每次迭代整张覆盖：等待上一次迭代的写入（WAW），第一次从 UNDEFINED 转换
+    ImageBarrierBatch barriers;
+    requireImageUse(bench->deviceInfo, &barriers, bench->storageImage, ImageUses::kStorageWrite, true);
+    flushImageBarriers(bench->deviceInfo, &barriers, bench->commandBuffer);
+    return toHandle(bench->storageView);
+}
+
+// 两段都是光栅化时（例如融合/逐级对比）手动分段：之前录制的迭代计入第一段
+extern "C" JNIEXPORT void JNICALL
+Java_com_genymobile_scrcpy_vulkan_VulkanBenchmarks_nativeMarkBenchmarkSplit(
+        JNIEnv* env, jobject /* this */, jlong benchHandle) {
+
+    ComputeBenchmark* bench = fromHandle<ComputeBenchmark*>(benchHandle);
+    if (validateHandle(bench, "benchmark")) {
+        writeBenchmarkSplit(bench);
+    }
+}
+
+// 提交并等待，返回 [第一段（光栅化）ms, 第二段（计算）ms]（总时间，调用方除以迭代次数）；失败返回 null
+extern "C" JNIEXPORT jdoubleArray JNICALL
+Java_com_genymobile_scrcpy_vulkan_VulkanBenchmarks_nativeFinishComputeBenchmark(
+        JNIEnv* env, jobject /* this */, jlong deviceHandle, jlong benchHandle) {
+
+    DeviceInfo* deviceInfo = getDeviceInfo(deviceHandle);
+    ComputeBenchmark* bench = fromHandle<ComputeBenchmark*>(benchHandle);
+    if (!validateHandle(deviceInfo, "device") || !validateHandle(bench, "benchmark")) {
+        return nullptr;
+    }
+
+    writeBenchmarkSplit(bench);
+    vkCmdWriteTimestamp(bench->commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, bench->queryPool, 2);
+    vkEndCommandBuffer(bench->commandBuffer);
+    bench->splitWritten = false;
+
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &bench->commandBuffer;
+
+    vkResetFences(deviceInfo->device, 1, &bench->fence);
+    VkResult result = vkQueueSubmit(deviceInfo->graphicsQueue, 1, &submitInfo, bench->fence);
+    if (!validateResult(result, "vkQueueSubmit (benchmark)")) {
+        return nullptr;
+    }
+    vkWaitForFences(deviceInfo->device, 1, &bench->fence, VK_TRUE, UINT64_MAX);
+
+    uint64_t timestamps[3] = {0, 0, 0};
+    result = vkGetQueryPoolResults(deviceInfo->device, bench->queryPool, 0, 3,
+                                   sizeof(timestamps), timestamps, sizeof(uint64_t),
+                                   VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT);
+    if (!validateResult(result, "vkGetQueryPoolResults (benchmark)")) {
+        return nullptr;
+    }
+
+    const double tickMs = bench->timestampPeriod / 1e6;
+    jdouble values[2] = {
+            static_cast<double>(timestamps[1] - timestamps[0]) * tickMs,
+            static_cast<double>(timestamps[2] - timestamps[1]) * tickMs,
+    };
+    jdoubleArray array = env->NewDoubleArray(2);
+    env->SetDoubleArrayRegion(array, 0, 2, values);
+    return array;
+}
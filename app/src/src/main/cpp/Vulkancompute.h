@@ -0,0 +1,59 @@
+//
+// Compute-shader output path: filters write storage images instead of rasterizing.
+//
+// 计算滤镜（见 affine.comp）按 16x16 工作组直接写 rgba8 存储图像，有两种输出方式：
+// - 直接：交换链为 R8G8B8A8_UNORM 且 surface 支持 STORAGE 用途时，直接写交换链图像；
+// - 中间图像：否则（例如 B8G8R8A8 交换链）写一张常驻 GENERAL 布局的中间图像，
+//   再按脏矩形 blit/copy 到交换链图像（交换链需要 TRANSFER_DST 用途）。
+// 交换链的 STORAGE 用途在一些 GPU 上会关闭帧缓冲压缩，所以只有请求了计算输出才会添加。
+//
+// 同步：acquire 信号量的等待阶段是 COLOR_ATTACHMENT_OUTPUT，这里的第一个 barrier
+// 以该阶段为源，与信号量构成执行依赖链。
+//
+#ifndef VULKAN_COMPUTE_H
+#define VULKAN_COMPUTE_H
+
+#include <vulkan/vulkan.h>
+#include <vector>
+#include "Vulkantypes.h"
+
+struct ComputeOutput {
+    bool direct = false;  // true：直接写交换链图像
+
+    // 中间图像（direct 为 false 时）
+    VkImage image = VK_NULL_HANDLE;
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    VkImageView imageView = VK_NULL_HANDLE;
+    VkExtent2D extent = {0, 0};
+    bool blit = false;         // 格式不同，需要 blit 转换（否则 copy）
+};
+
+// R8G8B8A8 存储图像（计算输出的中间图像、benchmark 目标、缩放器的中间结果），创建后登记到布局跟踪器。
+// 失败时已创建的部分留在输出参数中，由 destroyStorageImage 清理
+bool createStorageImage(DeviceInfo* deviceInfo, uint32_t width, uint32_t height, VkImageUsageFlags extraUsage,
+                        VkImage* image, VkDeviceMemory* memory, VkImageView* imageView);
+void destroyStorageImage(DeviceInfo* deviceInfo, VkImage* image, VkDeviceMemory* memory, VkImageView* imageView);
+
+// 创建交换链时调用：请求了计算输出（DeviceInfo::computeOutputRequested）时选择格式并
+// 返回需要额外添加的图像用途
+VkImageUsageFlags selectComputeSwapchainUsage(DeviceInfo* deviceInfo,
+                                              const VkSurfaceCapabilitiesKHR& capabilities,
+                                              const std::vector<VkSurfaceFormatKHR>& formats,
+                                              VkSurfaceFormatKHR* surfaceFormat);
+
+// 两种方式都不可用时返回 nullptr（runner 继续使用光栅化路径）
+ComputeOutput* createComputeOutput(DeviceInfo* deviceInfo, SwapchainInfo* swapchainInfo);
+void destroyComputeOutput(DeviceInfo* deviceInfo, ComputeOutput* output);
+
+// 把输出图像转换到 GENERAL 供计算着色器写入，返回存储视图。
+// load 为 true 时保留交换链图像上次呈现的内容（只重绘脏矩形）
+VkImageView beginComputeOutput(DeviceInfo* deviceInfo, VkCommandBuffer commandBuffer,
+                               SwapchainInfo* swapchainInfo, uint32_t imageIndex,
+                               ComputeOutput* output, bool load);
+
+// 计算写入完成后转换到 PRESENT_SRC；中间图像方式下只复制 rects（x, y, w, h）覆盖的区域
+void endComputeOutput(DeviceInfo* deviceInfo, VkCommandBuffer commandBuffer,
+                      SwapchainInfo* swapchainInfo, uint32_t imageIndex,
+                      ComputeOutput* output, bool load, const std::vector<VkRect2D>& rects);
+
+#endif // VULKAN_COMPUTE_H
@@ -0,0 +1,259 @@
+//
+// Damage tracking for incremental present.
+//
+#include "Vulkandamage.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+DamageTracker::DamageTracker(uint32_t imageCount, uint32_t outputWidth, uint32_t outputHeight,
+                             uint32_t inputWidth, uint32_t inputHeight)
+        : outputWidth_(outputWidth),
+          outputHeight_(outputHeight),
+          inputWidth_(inputWidth),
+          inputHeight_(inputHeight) {
+    images_.resize(imageCount);
+}
+
+void DamageTracker::reset(uint32_t imageCount, uint32_t outputWidth, uint32_t outputHeight) {
+    images_.assign(imageCount, ImageDamage{});
+    outputWidth_ = outputWidth;
+    outputHeight_ = outputHeight;
+    dirty_ = true;
+}
+
+void DamageTracker::setTransform(const float* outputToInput) {
+    if (outputToInput == nullptr) {
+        if (hasTransform_) {
+            hasTransform_ = false;
+            invertible_ = false;
+            invalidateAll();
+        }
+        return;
+    }
+
+    if (hasTransform_ && std::memcmp(transform_, outputToInput, sizeof(transform_)) == 0) {
+        return;
+    }
+
+    std::memcpy(transform_, outputToInput, sizeof(transform_));
+    hasTransform_ = true;
+
+    // 列主序 4x4 中的 2D 仿射部分
+    const double a = transform_[0];
+    const double b = transform_[1];
+    const double c = transform_[4];
+    const double d = transform_[5];
+    const double e = transform_[12];
+    const double f = transform_[13];
+
+    const double det = a * d - c * b;
+    invertible_ = std::fabs(det) > 1e-12;
+    if (invertible_) {
+        // 与 AffineMatrix.invert() 相同的公式
+        inverse_[0] = d / det;
+        inverse_[1] = -b / det;
+        inverse_[2] = -c / det;
+        inverse_[3] = a / det;
+        inverse_[4] = (c * f - d * e) / det;
+        inverse_[5] = (b * e - a * f) / det;
+    }
+
+    // 变换改变：之前渲染的内容全部失效
+    invalidateAll();
+}
+
+void DamageTracker::addInputDamage(int32_t x, int32_t y, int32_t width, int32_t height) {
+    if (width <= 0 || height <= 0) {
+        return;
+    }
+
+    if (!hasTransform_ || !invertible_ || inputWidth_ == 0 || inputHeight_ == 0) {
+        invalidateAll();
+        return;
+    }
+
+    // 输入像素 -> 输入纹理坐标 -> 输出纹理坐标 -> 输出像素，取四个角的包围盒
+    const double corners[4][2] = {
+            {static_cast<double>(x), static_cast<double>(y)},
+            {static_cast<double>(x + width), static_cast<double>(y)},
+            {static_cast<double>(x), static_cast<double>(y + height)},
+            {static_cast<double>(x + width), static_cast<double>(y + height)},
+    };
+
+    double minX = std::numeric_limits<double>::max();
+    double minY = std::numeric_limits<double>::max();
+    double maxX = std::numeric_limits<double>::lowest();
+    double maxY = std::numeric_limits<double>::lowest();
+
+    for (const auto& corner : corners) {
+        const double u = corner[0] / inputWidth_;
+        const double v = corner[1] / inputHeight_;
+        const double ou = inverse_[0] * u + inverse_[2] * v + inverse_[4];
+        const double ov = inverse_[1] * u + inverse_[3] * v + inverse_[5];
+        const double px = ou * outputWidth_;
+        const double py = ov * outputHeight_;
+        minX = std::min(minX, px);
+        minY = std::min(minY, py);
+        maxX = std::max(maxX, px);
+        maxY = std::max(maxY, py);
+    }
+
+    // 双线性采样会影响相邻像素，向外扩 1 像素
+    const double limit = 1e7;
+    minX = std::max(std::floor(minX) - 1.0, -limit);
+    minY = std::max(std::floor(minY) - 1.0, -limit);
+    maxX = std::min(std::ceil(maxX) + 1.0, limit);
+    maxY = std::min(std::ceil(maxY) + 1.0, limit);
+
+    DamageRect rect{};
+    rect.x = static_cast<int32_t>(minX);
+    rect.y = static_cast<int32_t>(minY);
+    rect.width = static_cast<int32_t>(maxX - minX);
+    rect.height = static_cast<int32_t>(maxY - minY);
+    addOutputDamage(rect);
+}
+
+void DamageTracker::addOutputDamage(const DamageRect& rect) {
+    DamageRect clipped = rect;
+    if (!clip(clipped)) {
+        return;
+    }
+
+    for (auto& image : images_) {
+        if (!image.full) {
+            addRect(image.rects, clipped);
+        }
+    }
+    dirty_ = true;
+}
+
+void DamageTracker::invalidateAll() {
+    for (auto& image : images_) {
+        image.full = true;
+        image.rects.clear();
+    }
+    dirty_ = true;
+}
+
+bool DamageTracker::beginFrame(uint32_t imageIndex, std::vector<DamageRect>& rects) {
+    rects.clear();
+    dirty_ = false;
+
+    const uint64_t totalArea = static_cast<uint64_t>(outputWidth_) * outputHeight_;
+
+    if (imageIndex >= images_.size() || images_[imageIndex].full || totalArea == 0) {
+        if (imageIndex < images_.size()) {
+            images_[imageIndex].full = false;
+            images_[imageIndex].rects.clear();
+        }
+        lastFull_ = true;
+        lastRects_.clear();
+        lastShadedFraction_ = 1.0f;
+        return true;
+    }
+
+    ImageDamage& image = images_[imageIndex];
+    rects.swap(image.rects);
+    image.rects.clear();
+
+    lastFull_ = false;
+    lastRects_ = rects;
+    lastShadedFraction_ = static_cast<float>(
+            static_cast<double>(unionArea(rects)) / static_cast<double>(totalArea));
+    return false;
+}
+
+uint64_t DamageTracker::unionArea(const std::vector<DamageRect>& rects) {
+    if (rects.empty()) {
+        return 0;
+    }
+
+    std::vector<int32_t> xs;
+    std::vector<int32_t> ys;
+    xs.reserve(rects.size() * 2);
+    ys.reserve(rects.size() * 2);
+    for (const auto& r : rects) {
+        xs.push_back(r.x);
+        xs.push_back(r.x + r.width);
+        ys.push_back(r.y);
+        ys.push_back(r.y + r.height);
+    }
+    std::sort(xs.begin(), xs.end());
+    xs.erase(std::unique(xs.begin(), xs.end()), xs.end());
+    std::sort(ys.begin(), ys.end());
+    ys.erase(std::unique(ys.begin(), ys.end()), ys.end());
+
+    uint64_t area = 0;
+    for (size_t i = 0; i + 1 < xs.size(); i++) {
+        for (size_t j = 0; j + 1 < ys.size(); j++) {
+            for (const auto& r : rects) {
+                if (xs[i] >= r.x && xs[i + 1] <= r.x + r.width &&
+                    ys[j] >= r.y && ys[j + 1] <= r.y + r.height) {
+                    area += static_cast<uint64_t>(xs[i + 1] - xs[i]) *
+                            static_cast<uint64_t>(ys[j + 1] - ys[j]);
+                    break;
+                }
+            }
+        }
+    }
+    return area;
+}
+
+bool DamageTracker::clip(DamageRect& rect) const {
+    const int32_t x0 = std::max(rect.x, 0);
+    const int32_t y0 = std::max(rect.y, 0);
+    const int32_t x1 = std::min(rect.x + rect.width, static_cast<int32_t>(outputWidth_));
+    const int32_t y1 = std::min(rect.y + rect.height, static_cast<int32_t>(outputHeight_));
+    if (x1 <= x0 || y1 <= y0) {
+        return false;
+    }
+    rect = {x0, y0, x1 - x0, y1 - y0};
+    return true;
+}
+
+void DamageTracker::addRect(std::vector<DamageRect>& rects, const DamageRect& rect) {
+    auto boundingBox = [](const DamageRect& l, const DamageRect& r) {
+        const int32_t x0 = std::min(l.x, r.x);
+        const int32_t y0 = std::min(l.y, r.y);
+        const int32_t x1 = std::max(l.x + l.width, r.x + r.width);
+        const int32_t y1 = std::max(l.y + l.height, r.y + r.height);
+        return DamageRect{x0, y0, x1 - x0, y1 - y0};
+    };
+    auto area = [](const DamageRect& r) {
+        return static_cast<int64_t>(r.width) * r.height;
+    };
+
+    // 已被某个矩形包含则忽略
+    for (const auto& r : rects) {
+        if (rect.x >= r.x && rect.y >= r.y &&
+            rect.x + rect.width <= r.x + r.width &&
+            rect.y + rect.height <= r.y + r.height) {
+            return;
+        }
+    }
+
+    rects.push_back(rect);
+
+    // 超出上限：合并包围盒面积增量最小的一对
+    while (rects.size() > kMaxRectsPerImage) {
+        size_t bestI = 0;
+        size_t bestJ = 1;
+        int64_t bestCost = std::numeric_limits<int64_t>::max();
+        for (size_t i = 0; i < rects.size(); i++) {
+            for (size_t j = i + 1; j < rects.size(); j++) {
+                const int64_t cost = area(boundingBox(rects[i], rects[j])) -
+                                     area(rects[i]) - area(rects[j]);
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    bestI = i;
+                    bestJ = j;
+                }
+            }
+        }
+        rects[bestI] = boundingBox(rects[bestI], rects[bestJ]);
+        rects.erase(rects.begin() + static_cast<std::ptrdiff_t>(bestJ));
+    }
+}
@@ -0,0 +1,92 @@
+//
+// Damage tracking for incremental present.
+//
+// 输入纹理的脏矩形（输入像素坐标）经过滤镜的仿射变换映射到输出像素坐标，
+// 按交换链图像分别累积：某张图像再次被获取时，只需重绘自它上次渲染以来的所有脏区域。
+//
+#ifndef VULKAN_DAMAGE_H
+#define VULKAN_DAMAGE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct DamageRect {
+    int32_t x;
+    int32_t y;
+    int32_t width;
+    int32_t height;
+};
+
+class DamageTracker {
+public:
+    // 每张图像最多保留的矩形数，超出时合并代价最小的两个
+    static constexpr size_t kMaxRectsPerImage = 8;
+
+    DamageTracker(uint32_t imageCount, uint32_t outputWidth, uint32_t outputHeight,
+                  uint32_t inputWidth, uint32_t inputHeight);
+
+    // 交换链重建后调用：所有图像内容失效
+    void reset(uint32_t imageCount, uint32_t outputWidth, uint32_t outputHeight);
+
+    uint32_t imageCount() const { return static_cast<uint32_t>(images_.size()); }
+    uint32_t outputWidth() const { return outputWidth_; }
+    uint32_t outputHeight() const { return outputHeight_; }
+
+    // 输出纹理坐标 -> 输入纹理坐标的 4x4 列主序矩阵（即 shader 中的 tex_matrix * user_matrix）。
+    // 传入 nullptr 表示输入任意变化都会影响整个输出。变换改变时整帧失效。
+    void setTransform(const float* outputToInput);
+
+    // 输入像素坐标的脏矩形
+    void addInputDamage(int32_t x, int32_t y, int32_t width, int32_t height);
+
+    // 输出像素坐标的脏矩形（例如动态滤镜）
+    void addOutputDamage(const DamageRect& rect);
+
+    void invalidateAll();
+
+    // 自上一帧以来是否有新的脏区域；没有则可以跳过本帧
+    bool hasPendingDamage() const { return dirty_; }
+
+    // 开始渲染 imageIndex：返回 true 表示需要整帧重绘（CLEAR），
+    // 否则 rects 为需要重绘的区域（LOAD + scissor）
+    bool beginFrame(uint32_t imageIndex, std::vector<DamageRect>& rects);
+
+    // 上一次 beginFrame 的结果，用于 VK_KHR_incremental_present
+    bool lastFrameFull() const { return lastFull_; }
+    const std::vector<DamageRect>& lastFrameRects() const { return lastRects_; }
+
+    // 上一帧实际着色的像素比例 [0, 1]
+    float lastShadedFraction() const { return lastShadedFraction_; }
+
+    // 矩形并集面积（矩形数量很少，坐标压缩即可）
+    static uint64_t unionArea(const std::vector<DamageRect>& rects);
+
+private:
+    struct ImageDamage {
+        bool full = true;  // 图像内容未定义（刚创建）或整帧失效
+        std::vector<DamageRect> rects;
+    };
+
+    bool clip(DamageRect& rect) const;
+    static void addRect(std::vector<DamageRect>& rects, const DamageRect& rect);
+
+    std::vector<ImageDamage> images_;
+    uint32_t outputWidth_;
+    uint32_t outputHeight_;
+    uint32_t inputWidth_;
+    uint32_t inputHeight_;
+
+    bool hasTransform_ = false;
+    float transform_[16] = {};
+    // 逆变换（输入纹理坐标 -> 输出纹理坐标），仅 2D 仿射部分 {a, b, c, d, e, f}
+    double inverse_[6] = {1.0, 0.0, 0.0, 1.0, 0.0, 0.0};
+    bool invertible_ = false;
+
+    bool dirty_ = true;
+    bool lastFull_ = true;
+    std::vector<DamageRect> lastRects_;
+    float lastShadedFraction_ = 1.0f;
+};
+
+#endif // VULKAN_DAMAGE_H
@@ -0,0 +1,317 @@
+//
+// Descriptor sets for filter passes: per-frame-safe cache keyed by the bound images, push descriptor fast path.
+//
+#include "Vulkanjni.h"
+#include "Vulkandescriptors.h"
+#include <vector>
+
+using namespace VulkanJNI;
+
+namespace {
+
+    // 每个池块的 set 数；常见情况（2 帧 in flight × 2~3 个输入槽）一块就够
+    constexpr uint32_t kSetsPerPool = 8;
+
+    struct CachedSet {
+        VkDescriptorSet set = VK_NULL_HANDLE;
+        VkImageView inputView = VK_NULL_HANDLE;
+        VkSampler sampler = VK_NULL_HANDLE;
+        VkImageView storageView = VK_NULL_HANDLE;
+        uint64_t lastUsedFrame = 0;
+        bool valid = false;  // 缓存的组合是否可以直接使用（resetDescriptorCache 之后为 false）
+    };
+
+} // anonymous namespace
+
+struct DescriptorManager {
+    DeviceInfo* deviceInfo = nullptr;
+    VkDescriptorSetLayout setLayout = VK_NULL_HANDLE;
+    bool pushDescriptors = false;
+
+    std::vector<VkDescriptorPool> pools;
+    uint32_t poolRemaining = 0;        // 最后一块池中还能分配的 set 数
+    std::vector<CachedSet> sets;       // 数量很少，线性查找
+
+    uint32_t hits = 0;
+    uint32_t updates = 0;
+};
+
+namespace {
+
+    bool sameKey(const CachedSet& entry, VkImageView inputView, VkSampler sampler, VkImageView storageView) {
+        return entry.valid && entry.inputView == inputView && entry.sampler == sampler &&
+               entry.storageView == storageView;
+    }
+
+    // 该 set 最后一次绑定所在的帧已经完成（runner 等待过对应的 fence）
+    bool isRetired(const DeviceInfo* deviceInfo, const CachedSet& entry) {
+        return entry.lastUsedFrame + deviceInfo->framesInFlight <= deviceInfo->frameSerial;
+    }
+
+    bool addPool(DescriptorManager* manager) {
+        VkDescriptorPoolSize poolSizes[2] = {};
+        poolSizes[0].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        poolSizes[0].descriptorCount = kSetsPerPool;
+        poolSizes[1].type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+        poolSizes[1].descriptorCount = kSetsPerPool;
+
+        VkDescriptorPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        poolInfo.maxSets = kSetsPerPool;
+        poolInfo.poolSizeCount = 2;
+        poolInfo.pPoolSizes = poolSizes;
+
+        VkDescriptorPool pool = VK_NULL_HANDLE;
+        VkResult result = vkCreateDescriptorPool(manager->deviceInfo->device, &poolInfo, nullptr, &pool);
+        if (!validateResult(result, "vkCreateDescriptorPool (descriptor manager)")) {
+            return false;
+        }
+        manager->pools.push_back(pool);
+        manager->poolRemaining = kSetsPerPool;
+        return true;
+    }
+
+    CachedSet* allocateSet(DescriptorManager* manager) {
+        if (manager->poolRemaining == 0 && !addPool(manager)) {
+            return nullptr;
+        }
+
+        VkDescriptorSetAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocInfo.descriptorPool = manager->pools.back();
+        allocInfo.descriptorSetCount = 1;
+        allocInfo.pSetLayouts = &manager->setLayout;
+
+        VkDescriptorSet set = VK_NULL_HANDLE;
+        VkResult result = vkAllocateDescriptorSets(manager->deviceInfo->device, &allocInfo, &set);
+        if (!validateResult(result, "vkAllocateDescriptorSets (descriptor manager)")) {
+            return nullptr;
+        }
+        manager->poolRemaining--;
+
+        CachedSet entry;
+        entry.set = set;
+        manager->sets.push_back(entry);
+        return &manager->sets.back();
+    }
+
+    // binding 0：输入纹理（SHADER_READ_ONLY）；binding 1：输出存储图像（GENERAL，可选）
+    uint32_t fillWrites(VkDescriptorSet set, VkImageView inputView, VkSampler sampler, VkImageView storageView,
+                        VkDescriptorImageInfo imageInfos[2], VkWriteDescriptorSet writes[2]) {
+        imageInfos[0] = VkDescriptorImageInfo{};
+        imageInfos[0].sampler = sampler;
+        imageInfos[0].imageView = inputView;
+        imageInfos[0].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        imageInfos[1] = VkDescriptorImageInfo{};
+        imageInfos[1].imageView = storageView;
+        imageInfos[1].imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+        for (uint32_t i = 0; i < 2; ++i) {
+            writes[i] = VkWriteDescriptorSet{};
+            writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writes[i].dstSet = set;
+            writes[i].dstBinding = i;
+            writes[i].descriptorCount = 1;
+            writes[i].pImageInfo = &imageInfos[i];
+        }
+        writes[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        writes[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+
+        return storageView != VK_NULL_HANDLE ? 2 : 1;
+    }
+
+    // 命中的组合，或者可以安全改写的 set（优先最久未用的），都没有时新分配
+    CachedSet* acquireSet(DescriptorManager* manager, VkImageView inputView, VkSampler sampler,
+                          VkImageView storageView, bool* needsUpdate) {
+        CachedSet* reusable = nullptr;
+        for (CachedSet& entry : manager->sets) {
+            if (sameKey(entry, inputView, sampler, storageView)) {
+                *needsUpdate = false;
+                return &entry;
+            }
+            if (isRetired(manager->deviceInfo, entry) &&
+                (!reusable || entry.lastUsedFrame < reusable->lastUsedFrame)) {
+                reusable = &entry;
+            }
+        }
+        *needsUpdate = true;
+        return reusable ? reusable : allocateSet(manager);
+    }
+
+} // anonymous namespace
+
+// ============================================
+// Device
+// ============================================
+void initPushDescriptors(DeviceInfo* deviceInfo, bool enabled) {
+    deviceInfo->pushDescriptors = false;
+    if (!enabled) return;
+
+    deviceInfo->cmdPushDescriptorSet = reinterpret_cast<PFN_vkCmdPushDescriptorSetKHR>(
+            vkGetDeviceProcAddr(deviceInfo->device, "vkCmdPushDescriptorSetKHR"));
+    if (!deviceInfo->cmdPushDescriptorSet) {
+        LOGE("vkCmdPushDescriptorSetKHR not found, falling back to descriptor sets");
+        return;
+    }
+    deviceInfo->pushDescriptors = true;
+}
+
+void beginDescriptorFrame(DeviceInfo* deviceInfo, uint32_t framesInFlight) {
+    deviceInfo->framesInFlight = framesInFlight;
+    deviceInfo->frameSerial++;
+}
+
+// ============================================
+// Manager
+// ============================================
+DescriptorManager* createDescriptorManager(DeviceInfo* deviceInfo, VkDescriptorSetLayout setLayout,
+                                           bool pushDescriptors) {
+    if (pushDescriptors && !deviceInfo->pushDescriptors) {
+        LOGE("Descriptor manager: push descriptors requested but not enabled on the device");
+        return nullptr;
+    }
+
+    auto* manager = new DescriptorManager();
+    manager->deviceInfo = deviceInfo;
+    manager->setLayout = setLayout;
+    manager->pushDescriptors = pushDescriptors;
+    return manager;
+}
+
+void destroyDescriptorManager(DescriptorManager* manager) {
+    if (!manager) return;
+    if (!manager->pushDescriptors) {
+        LOGD("Descriptor manager: %zu sets in %zu pools, %u hits, %u updates",
+             manager->sets.size(), manager->pools.size(), manager->hits, manager->updates);
+    }
+    for (VkDescriptorPool pool : manager->pools) {
+        vkDestroyDescriptorPool(manager->deviceInfo->device, pool, nullptr);
+    }
+    delete manager;
+}
+
+void resetDescriptorCache(DescriptorManager* manager) {
+    for (CachedSet& entry : manager->sets) {
+        entry.valid = false;
+    }
+}
+
+bool usesPushDescriptors(DescriptorManager* manager) {
+    return manager->pushDescriptors;
+}
+
+bool bindImageDescriptors(DescriptorManager* manager, VkCommandBuffer commandBuffer,
+                          VkPipelineBindPoint bindPoint, VkPipelineLayout pipelineLayout,
+                          VkImageView inputView, VkSampler sampler, VkImageView storageView) {
+    VkDescriptorImageInfo imageInfos[2];
+    VkWriteDescriptorSet writes[2];
+
+    if (manager->pushDescriptors) {
+        const uint32_t writeCount = fillWrites(VK_NULL_HANDLE, inputView, sampler, storageView, imageInfos, writes);
+        manager->deviceInfo->cmdPushDescriptorSet(commandBuffer, bindPoint, pipelineLayout, 0, writeCount, writes);
+        return true;
+    }
+
+    bool needsUpdate = false;
+    CachedSet* entry = acquireSet(manager, inputView, sampler, storageView, &needsUpdate);
+    if (!entry) return false;
+
+    if (needsUpdate) {
+        const uint32_t writeCount = fillWrites(entry->set, inputView, sampler, storageView, imageInfos, writes);
+        vkUpdateDescriptorSets(manager->deviceInfo->device, writeCount, writes, 0, nullptr);
+        entry->inputView = inputView;
+        entry->sampler = sampler;
+        entry->storageView = storageView;
+        entry->valid = true;
+        manager->updates++;
+    } else {
+        manager->hits++;
+    }
+    entry->lastUsedFrame = manager->deviceInfo->frameSerial;
+
+    vkCmdBindDescriptorSets(commandBuffer, bindPoint, pipelineLayout, 0, 1, &entry->set, 0, nullptr);
+    return true;
+}
+
+// ============================================
+// JNI: DescriptorManager
+// ============================================
+
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_genymobile_scrcpy_vulkan_DescriptorManager_nativeCreate(
+        JNIEnv* env, jobject /* this */, jlong deviceHandle, jlong setLayoutHandle, jboolean pushDescriptors) {
+
+    DeviceInfo* deviceInfo = getDeviceInfo(deviceHandle);
+    VkDescriptorSetLayout setLayout = fromHandle<VkDescriptorSetLayout>(setLayoutHandle);
+    if (!validateHandle(deviceInfo, "device") || !validateHandle(setLayout, "descriptorSetLayout")) {
+        return 0;
+    }
+    return toHandle(createDescriptorManager(deviceInfo, setLayout, pushDescriptors == JNI_TRUE));
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_genymobile_scrcpy_vulkan_DescriptorManager_nativeDestroy(
+        JNIEnv* env, jobject /* this */, jlong managerHandle) {
+    destroyDescriptorManager(fromHandle<DescriptorManager*>(managerHandle));
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_genymobile_scrcpy_vulkan_DescriptorManager_nativeReset(
+        JNIEnv* env, jobject /* this */, jlong managerHandle) {
+
+    DescriptorManager* manager = fromHandle<DescriptorManager*>(managerHandle);
+    if (validateHandle(manager, "descriptorManager")) {
+        resetDescriptorCache(manager);
+    }
+}
+
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_genymobile_scrcpy_vulkan_DescriptorManager_nativeUsesPushDescriptors(
+        JNIEnv* env, jobject /* this */, jlong managerHandle) {
+
+    DescriptorManager* manager = fromHandle<DescriptorManager*>(managerHandle);
+    return validateHandle(manager, "descriptorManager") && usesPushDescriptors(manager) ? JNI_TRUE : JNI_FALSE;
+}
+
+// compute 为 true 时绑定到计算 bind point；outputView 为 0 时只写 binding 0
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_genymobile_scrcpy_vulkan_DescriptorManager_nativeBind(
+        JNIEnv* env, jobject /* this */,
+        jlong managerHandle,
+        jlong commandBufferHandle,
+        jboolean compute,
+        jlong pipelineLayoutHandle,
+        jlong inputViewHandle,
+        jlong samplerHandle,
+        jlong storageViewHandle) {
+
+    DescriptorManager* manager = fromHandle<DescriptorManager*>(managerHandle);
+    VkCommandBuffer commandBuffer = fromHandle<VkCommandBuffer>(commandBufferHandle);
+    VkPipelineLayout pipelineLayout = fromHandle<VkPipelineLayout>(pipelineLayoutHandle);
+    VkImageView inputView = fromHandle<VkImageView>(inputViewHandle);
+    VkSampler sampler = fromHandle<VkSampler>(samplerHandle);
+    if (!validateHandle(manager, "descriptorManager") || !validateHandle(commandBuffer, "commandBuffer") ||
+        !validateHandle(pipelineLayout, "pipelineLayout") || !validateHandle(inputView, "inputView") ||
+        !validateHandle(sampler, "sampler")) {
+        return JNI_FALSE;
+    }
+
+    const VkPipelineBindPoint bindPoint = compute == JNI_TRUE ? VK_PIPELINE_BIND_POINT_COMPUTE
+                                                              : VK_PIPELINE_BIND_POINT_GRAPHICS;
+    return bindImageDescriptors(manager, commandBuffer, bindPoint, pipelineLayout, inputView, sampler,
+                                fromHandle<VkImageView>(storageViewHandle)) ? JNI_TRUE : JNI_FALSE;
+}
+
+// ============================================
+// JNI: VulkanRunner
+// ============================================
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeBeginDescriptorFrame(
+        JNIEnv* env, jobject /* this */, jlong deviceHandle, jint framesInFlight) {
+
+    DeviceInfo* deviceInfo = getDeviceInfo(deviceHandle);
+    if (validateHandle(deviceInfo, "device") && framesInFlight > 0) {
+        beginDescriptorFrame(deviceInfo, static_cast<uint32_t>(framesInFlight));
+    }
+}
@@ -0,0 +1,54 @@
+//
+// Descriptor sets for filter passes: per-frame-safe cache keyed by the bound images, push descriptor fast path.
+//
+// 之前每个滤镜只有一个 descriptor set（maxSets = 1），输入纹理或 sampler 变化时直接 vkUpdateDescriptorSets，
+// 而前一两帧的命令缓冲可能还在 GPU 上读这个 set（MAX_FRAMES_IN_FLIGHT = 2）。规范不允许更新
+// 被未完成命令引用的 set，驱动可能读到一半新一半旧的描述符。
+//
+// DescriptorManager 按 (输入视图, sampler, 存储视图) 缓存 set：
+// - 命中：直接绑定，不写描述符。输入在 input ring 的几个槽之间切换时每个组合各有一个 set；
+// - 未命中：改写一个至少 framesInFlight 帧没有绑定过的 set（那一帧的 fence 已经等待过），
+//   没有这样的 set 时从池中分配（每块 kSetsPerPool 个，用完再建一块）。
+// 因此绑定时从不更新可能仍被 GPU 读取的 set。帧序号由 runner 在等待本帧 fence 之后推进
+// （beginDescriptorFrame）；同一帧内多次绑定同一组合只占用一个 set。
+//
+// 设备支持 VK_KHR_push_descriptor、且 layout 把 set 0 创建为 push set 时（acquireReflectedLayout 的
+// pushDescriptorSet），描述符直接写进命令缓冲（vkCmdPushDescriptorSetKHR），没有池也没有 set。
+//
+// 缓存按句柄比较：视图销毁后新视图可能拿到同一个句柄，输入/输出重建时调用 resetDescriptorCache。
+//
+#ifndef VULKAN_DESCRIPTORS_H
+#define VULKAN_DESCRIPTORS_H
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include "Vulkantypes.h"
+
+// 创建设备后调用；enabled 表示 VK_KHR_push_descriptor 已经启用
+void initPushDescriptors(DeviceInfo* deviceInfo, bool enabled);
+
+// 每帧等待 in-flight fence 之后、录制之前调用
+void beginDescriptorFrame(DeviceInfo* deviceInfo, uint32_t framesInFlight);
+
+struct DescriptorManager;
+
+// setLayout：binding 0 为采样输入（COMBINED_IMAGE_SAMPLER），可选的 binding 1 为存储输出（STORAGE_IMAGE）。
+// pushDescriptors 为 true 时 setLayout 必须以 PUSH_DESCRIPTOR 标志创建
+DescriptorManager* createDescriptorManager(DeviceInfo* deviceInfo, VkDescriptorSetLayout setLayout,
+                                           bool pushDescriptors);
+
+// 调用前 GPU 不能再使用它的 set
+void destroyDescriptorManager(DescriptorManager* manager);
+
+// 忘记所有缓存的组合（set 本身保留，仍按帧序号等待复用）
+void resetDescriptorCache(DescriptorManager* manager);
+
+bool usesPushDescriptors(DescriptorManager* manager);
+
+// 把 (inputView, sampler[, storageView]) 绑定到 set 0。storageView 为 VK_NULL_HANDLE 时只写 binding 0；
+// 否则由调用方保证它处于 GENERAL。失败返回 false（不绑定任何东西）
+bool bindImageDescriptors(DescriptorManager* manager, VkCommandBuffer commandBuffer,
+                          VkPipelineBindPoint bindPoint, VkPipelineLayout pipelineLayout,
+                          VkImageView inputView, VkSampler sampler, VkImageView storageView);
+
+#endif // VULKAN_DESCRIPTORS_H
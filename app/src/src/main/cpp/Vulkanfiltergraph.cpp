@@ -0,0 +1,420 @@
+//
+// Multi-pass filter graph with pooled intermediate images.
+//
+#include "Vulkanjni.h"
+#include "Vulkanfiltergraph.h"
+#include "Vulkanprofiler.h"
+#include <algorithm>
+#include <string>
+
+using namespace VulkanJNI;
+
+namespace {
+
+    // 中间图像都是离屏 RenderTarget：颜色附件 + 采样
+    constexpr VkImageUsageFlags kIntermediateUsage =
+            VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+
+    // 池中图像超过这么多帧没有使用才销毁（大于 runner 的 MAX_FRAMES_IN_FLIGHT，保证 GPU 已经用完）
+    constexpr uint64_t kRetireFrames = 3;
+
+} // anonymous namespace
+
+struct FilterGraphResource {
+    VkFormat format = VK_FORMAT_UNDEFINED;
+    VkImageUsageFlags usage = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    int32_t writer = -1;     // 写入它的 pass
+    int32_t lastRead = -1;   // 最后读取它的有效 pass（compile 计算）
+    int32_t image = -1;      // 池下标（compile 分配）
+};
+
+struct FilterGraphPass {
+    std::vector<int32_t> inputs;
+    int32_t output = kGraphOutput;
+    bool active = false;
+    int32_t gpuScope = -1;  // 录制中的 GPU profiler token（Vulkanprofiler.h）
+};
+
+struct FilterGraphImage {
+    VkFormat format = VK_FORMAT_UNDEFINED;
+    VkImageUsageFlags usage = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    RenderTarget* target = nullptr;
+    uint64_t lastUsedFrame = 0;
+    int32_t busyUntil = -1;  // compile 时：当前持有者最后被读取的 pass
+};
+
+struct FilterGraph {
+    DeviceInfo* deviceInfo = nullptr;
+    std::vector<FilterGraphResource> resources;  // [0] 为图的输入
+    std::vector<FilterGraphPass> passes;
+    std::vector<FilterGraphImage> pool;
+    int32_t firstActivePass = -1;
+    uint64_t frame = 0;
+    bool compiled = false;
+};
+
+// ============================================
+// Graph Construction
+// ============================================
+FilterGraph* createFilterGraph(DeviceInfo* deviceInfo) {
+    FilterGraph* graph = new FilterGraph();
+    graph->deviceInfo = deviceInfo;
+    graph->resources.emplace_back();  // kGraphInput
+    return graph;
+}
+
+void destroyFilterGraph(FilterGraph* graph) {
+    if (!graph) return;
+    for (FilterGraphImage& image : graph->pool) {
+        destroyRenderTarget(graph->deviceInfo, image.target);
+    }
+    delete graph;
+}
+
+void resetFilterGraph(FilterGraph* graph) {
+    graph->resources.resize(1);
+    graph->resources[0] = FilterGraphResource();
+    graph->passes.clear();
+    graph->firstActivePass = -1;
+    graph->compiled = false;
+}
+
+int32_t addGraphResource(FilterGraph* graph, uint32_t width, uint32_t height) {
+    if (width == 0 || height == 0) {
+        LOGE("Invalid graph resource size: %ux%u", width, height);
+        return -1;
+    }
+    FilterGraphResource resource;
+    // 与交换链格式相同，滤镜为交换链创建的 pipeline 可以直接写入
+    resource.format = graph->deviceInfo->colorFormat;
+    resource.usage = kIntermediateUsage;
+    resource.width = width;
+    resource.height = height;
+    graph->resources.push_back(resource);
+    graph->compiled = false;
+    return static_cast<int32_t>(graph->resources.size() - 1);
+}
+
+int32_t addGraphPass(FilterGraph* graph, const std::vector<int32_t>& inputs, int32_t output) {
+    const int32_t passIndex = static_cast<int32_t>(graph->passes.size());
+    const int32_t resourceCount = static_cast<int32_t>(graph->resources.size());
+
+    if (output == kGraphOutput) {
+        for (const FilterGraphPass& pass : graph->passes) {
+            if (pass.output == kGraphOutput) {
+                LOGE("Graph pass %d: output already written by another pass", passIndex);
+                return -1;
+            }
+        }
+    } else if (output <= kGraphInput || output >= resourceCount) {
+        LOGE("Graph pass %d: invalid output resource %d", passIndex, output);
+        return -1;
+    } else if (graph->resources[output].writer >= 0) {
+        LOGE("Graph pass %d: resource %d already written by pass %d",
+             passIndex, output, graph->resources[output].writer);
+        return -1;
+    }
+
+    for (int32_t input : inputs) {
+        if (input < kGraphInput || input >= resourceCount || input == output) {
+            LOGE("Graph pass %d: invalid input resource %d", passIndex, input);
+            return -1;
+        }
+        // 只能读取前面的 pass 写入的资源，保证声明顺序就是执行顺序
+        if (input != kGraphInput && graph->resources[input].writer < 0) {
+            LOGE("Graph pass %d: resource %d is read before it is written", passIndex, input);
+            return -1;
+        }
+    }
+
+    FilterGraphPass pass;
+    pass.inputs = inputs;
+    pass.output = output;
+    graph->passes.push_back(pass);
+    if (output != kGraphOutput) {
+        graph->resources[output].writer = passIndex;
+    }
+    graph->compiled = false;
+    return passIndex;
+}
+
+// ============================================
+// Compilation
+// ============================================
+namespace {
+
+    // 从后往前：写入 kGraphOutput 或写入被有效 pass 读取的资源的 pass 才有效
+    bool cullPasses(FilterGraph* graph) {
+        std::vector<bool> needed(graph->resources.size(), false);
+        bool hasOutput = false;
+
+        for (int32_t i = static_cast<int32_t>(graph->passes.size()) - 1; i >= 0; --i) {
+            FilterGraphPass& pass = graph->passes[i];
+            pass.active = pass.output == kGraphOutput || needed[pass.output];
+            if (!pass.active) {
+                LOGI("Graph pass %d culled: result never reaches the output", i);
+                continue;
+            }
+            hasOutput |= pass.output == kGraphOutput;
+            for (int32_t input : pass.inputs) {
+                needed[input] = true;
+            }
+        }
+        return hasOutput;
+    }
+
+    void computeLifetimes(FilterGraph* graph) {
+        for (FilterGraphResource& resource : graph->resources) {
+            resource.lastRead = -1;
+            resource.image = -1;
+        }
+        graph->firstActivePass = -1;
+        for (int32_t i = 0; i < static_cast<int32_t>(graph->passes.size()); ++i) {
+            const FilterGraphPass& pass = graph->passes[i];
+            if (!pass.active) continue;
+            if (graph->firstActivePass < 0) graph->firstActivePass = i;
+            for (int32_t input : pass.inputs) {
+                graph->resources[input].lastRead = std::max(graph->resources[input].lastRead, i);
+            }
+        }
+    }
+
+    // 按 pass 顺序分配：同 key、且上一个持有者在本 pass 之前已经读完的图像可以复用
+    bool allocateImages(FilterGraph* graph) {
+        std::vector<bool> assigned(graph->pool.size(), false);
+        for (FilterGraphImage& image : graph->pool) {
+            image.busyUntil = -1;
+        }
+
+        for (int32_t i = 0; i < static_cast<int32_t>(graph->passes.size()); ++i) {
+            const FilterGraphPass& pass = graph->passes[i];
+            if (!pass.active || pass.output == kGraphOutput) continue;
+            FilterGraphResource& resource = graph->resources[pass.output];
+
+            int32_t found = -1;
+            for (size_t p = 0; p < graph->pool.size(); ++p) {
+                const FilterGraphImage& image = graph->pool[p];
+                if (image.busyUntil < i && image.format == resource.format && image.usage == resource.usage &&
+                    image.width == resource.width && image.height == resource.height) {
+                    found = static_cast<int32_t>(p);
+                    break;
+                }
+            }
+
+            if (found < 0) {
+                RenderTarget* target = createRenderTarget(graph->deviceInfo, resource.width, resource.height,
+                                                          resource.format);
+                if (!target) {
+                    return false;
+                }
+                FilterGraphImage image;
+                image.format = resource.format;
+                image.usage = resource.usage;
+                image.width = resource.width;
+                image.height = resource.height;
+                image.target = target;
+                image.lastUsedFrame = graph->frame;
+                graph->pool.push_back(image);
+                assigned.push_back(false);
+                found = static_cast<int32_t>(graph->pool.size() - 1);
+            }
+
+            graph->pool[found].busyUntil = resource.lastRead;
+            assigned[found] = true;
+            resource.image = found;
+        }
+
+        // 很久没有使用的图像（例如尺寸变化前的）才销毁，避免销毁正在执行的帧引用的图像
+        for (size_t p = graph->pool.size(); p-- > 0;) {
+            if (!assigned[p] && graph->frame - graph->pool[p].lastUsedFrame > kRetireFrames) {
+                destroyRenderTarget(graph->deviceInfo, graph->pool[p].target);
+                graph->pool.erase(graph->pool.begin() + p);
+                for (FilterGraphResource& resource : graph->resources) {
+                    if (resource.image > static_cast<int32_t>(p)) resource.image--;
+                }
+            }
+        }
+        return true;
+    }
+
+} // anonymous namespace
+
+bool compileFilterGraph(FilterGraph* graph) {
+    graph->compiled = false;
+    if (!cullPasses(graph)) {
+        LOGE("Filter graph has no pass writing the output");
+        return false;
+    }
+    computeLifetimes(graph);
+    if (!allocateImages(graph)) {
+        LOGE("Failed to allocate filter graph images");
+        return false;
+    }
+
+    size_t activePasses = 0;
+    for (const FilterGraphPass& pass : graph->passes) {
+        if (pass.active) activePasses++;
+    }
+    LOGI("✓ Filter graph compiled: %zu/%zu passes, %zu resources, %zu pooled images",
+         activePasses, graph->passes.size(), graph->resources.size() - 1, graph->pool.size());
+    graph->compiled = true;
+    return true;
+}
+
+bool isGraphPassActive(const FilterGraph* graph, int32_t pass) {
+    return graph->compiled && pass >= 0 && pass < static_cast<int32_t>(graph->passes.size()) &&
+           graph->passes[pass].active;
+}
+
+VkImageView getGraphResourceView(const FilterGraph* graph, int32_t resource) {
+    if (!graph->compiled || resource <= kGraphInput ||
+        resource >= static_cast<int32_t>(graph->resources.size())) {
+        return VK_NULL_HANDLE;
+    }
+    const int32_t image = graph->resources[resource].image;
+    return image >= 0 ? graph->pool[image].target->imageView : VK_NULL_HANDLE;
+}
+
+// ============================================
+// Recording
+// ============================================
+void beginGraphPass(FilterGraph* graph, VkCommandBuffer commandBuffer, int32_t pass) {
+    if (!isGraphPassActive(graph, pass) || graph->passes[pass].output == kGraphOutput) {
+        return;
+    }
+    if (pass == graph->firstActivePass) {
+        graph->frame++;
+    }
+
+    const FilterGraphResource& resource = graph->resources[graph->passes[pass].output];
+    FilterGraphImage& image = graph->pool[resource.image];
+    image.lastUsedFrame = graph->frame;
+
+    // 离屏 pass 各自计时；写入输出的 pass 在 runner 的输出 pass 里，由 runner 计时
+    const std::string scope = "graph pass " + std::to_string(pass);
+    graph->passes[pass].gpuScope = beginGpuScope(graph->deviceInfo, commandBuffer,
+                                                 gpuScopeId(graph->deviceInfo, scope.c_str()));
+    beginRenderTargetPass(commandBuffer, image.target, resource.width, resource.height);
+}
+
+void endGraphPass(FilterGraph* graph, VkCommandBuffer commandBuffer, int32_t pass) {
+    if (!isGraphPassActive(graph, pass) || graph->passes[pass].output == kGraphOutput) {
+        return;
+    }
+    const FilterGraphResource& resource = graph->resources[graph->passes[pass].output];
+    endRenderTargetPass(commandBuffer, graph->pool[resource.image].target);
+    endGpuScope(graph->deviceInfo, commandBuffer, graph->passes[pass].gpuScope);
+    graph->passes[pass].gpuScope = -1;
+}
+
+// ============================================
+// JNI: FilterGraph
+// ============================================
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_genymobile_scrcpy_vulkan_FilterGraph_nativeCreate(
+        JNIEnv* env, jobject /* this */, jlong deviceHandle) {
+
+    DeviceInfo* deviceInfo = getDeviceInfo(deviceHandle);
+    if (!validateHandle(deviceInfo, "device")) {
+        return 0;
+    }
+    return toHandle(createFilterGraph(deviceInfo));
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_genymobile_scrcpy_vulkan_FilterGraph_nativeDestroy(
+        JNIEnv* env, jobject /* this */, jlong graphHandle) {
+
+    destroyFilterGraph(fromHandle<FilterGraph*>(graphHandle));
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_genymobile_scrcpy_vulkan_FilterGraph_nativeReset(
+        JNIEnv* env, jobject /* this */, jlong graphHandle) {
+
+    FilterGraph* graph = fromHandle<FilterGraph*>(graphHandle);
+    if (validateHandle(graph, "filterGraph")) {
+        resetFilterGraph(graph);
+    }
+}
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_genymobile_scrcpy_vulkan_FilterGraph_nativeAddResource(
+        JNIEnv* env, jobject /* this */, jlong graphHandle, jint width, jint height) {
+
+    FilterGraph* graph = fromHandle<FilterGraph*>(graphHandle);
+    if (!validateHandle(graph, "filterGraph") || width <= 0 || height <= 0) {
+        return -1;
+    }
+    return addGraphResource(graph, static_cast<uint32_t>(width), static_cast<uint32_t>(height));
+}
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_genymobile_scrcpy_vulkan_FilterGraph_nativeAddPass(
+        JNIEnv* env, jobject /* this */, jlong graphHandle, jintArray inputArray, jint output) {
+
+    FilterGraph* graph = fromHandle<FilterGraph*>(graphHandle);
+    if (!validateHandle(graph, "filterGraph") || inputArray == nullptr) {
+        return -1;
+    }
+
+    jsize count = env->GetArrayLength(inputArray);
+    std::vector<jint> values(count);
+    env->GetIntArrayRegion(inputArray, 0, count, values.data());
+    return addGraphPass(graph, std::vector<int32_t>(values.begin(), values.end()), output);
+}
+
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_genymobile_scrcpy_vulkan_FilterGraph_nativeCompile(
+        JNIEnv* env, jobject /* this */, jlong graphHandle) {
+
+    FilterGraph* graph = fromHandle<FilterGraph*>(graphHandle);
+    if (!validateHandle(graph, "filterGraph")) {
+        return JNI_FALSE;
+    }
+    return compileFilterGraph(graph) ? JNI_TRUE : JNI_FALSE;
+}
+
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_genymobile_scrcpy_vulkan_FilterGraph_nativeIsPassActive(
+        JNIEnv* env, jobject /* this */, jlong graphHandle, jint pass) {
+
+    FilterGraph* graph = fromHandle<FilterGraph*>(graphHandle);
+    return graph && isGraphPassActive(graph, pass) ? JNI_TRUE : JNI_FALSE;
+}
+
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_genymobile_scrcpy_vulkan_FilterGraph_nativeGetResourceView(
+        JNIEnv* env, jobject /* this */, jlong graphHandle, jint resource) {
+
+    FilterGraph* graph = fromHandle<FilterGraph*>(graphHandle);
+    return graph ? toHandle(getGraphResourceView(graph, resource)) : 0;
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_genymobile_scrcpy_vulkan_FilterGraph_nativeBeginPass(
+        JNIEnv* env, jobject /* this */, jlong commandBufferHandle, jlong graphHandle, jint pass) {
+
+    VkCommandBuffer commandBuffer = fromHandle<VkCommandBuffer>(commandBufferHandle);
+    FilterGraph* graph = fromHandle<FilterGraph*>(graphHandle);
+    if (!validateHandle(commandBuffer, "commandBuffer") || !validateHandle(graph, "filterGraph")) {
+        return;
+    }
+    beginGraphPass(graph, commandBuffer, pass);
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_genymobile_scrcpy_vulkan_FilterGraph_nativeEndPass(
+        JNIEnv* env, jobject /* this */, jlong commandBufferHandle, jlong graphHandle, jint pass) {
+
+    VkCommandBuffer commandBuffer = fromHandle<VkCommandBuffer>(commandBufferHandle);
+    FilterGraph* graph = fromHandle<FilterGraph*>(graphHandle);
+    if (!validateHandle(commandBuffer, "commandBuffer") || !validateHandle(graph, "filterGraph")) {
+        return;
+    }
+    endGraphPass(graph, commandBuffer, pass);
+}
@@ -0,0 +1,59 @@
+//
+// Multi-pass filter graph with pooled intermediate images.
+//
+// 滤镜链（例如 缩放 → 锐化 → 调色）：每个 pass 声明读取的资源和写入的资源，
+// 资源 0 是图的输入纹理（外部），kGraphOutput 是交换链（最后一个 pass 在 runner 的输出 pass 中绘制），
+// 其余是中间图像。pass 按声明顺序执行，输入必须由前面的 pass 写入，因此一定是 DAG。
+//
+// compileFilterGraph：
+// - 剔除结果不会到达 kGraphOutput 的 pass；
+// - 计算每个中间资源的生命周期 [首次写入, 最后读取]，从按 (format, extent, usage) 分组的池中分配图像，
+//   生命周期不重叠的资源共用一张图像（链式滤镜只需要两张来回使用）；
+// - 每张中间图像只在写入时同步一次：写入前等待之前对它的采样/写入（WAR/WAW），
+//   写入后转换到 SHADER_READ_ONLY 并对片段着色器可见（RAW）。读取不需要额外 barrier，
+//   同一资源被多个 pass 读取时也只有这一次。render pass 路径由离屏 render pass 的 subpass 依赖完成，
+//   动态渲染路径由 begin/end 中的 barrier 完成（见 Vulkanrendertarget.h）。
+//
+// 所有 pass 录制在 runner 的同一个命令缓冲中，一次提交。
+//
+#ifndef VULKAN_FILTER_GRAPH_H
+#define VULKAN_FILTER_GRAPH_H
+
+#include <vulkan/vulkan.h>
+#include <vector>
+#include "Vulkantypes.h"
+#include "Vulkanrendertarget.h"
+
+struct FilterGraph;
+
+constexpr int32_t kGraphInput = 0;
+constexpr int32_t kGraphOutput = -1;
+
+FilterGraph* createFilterGraph(DeviceInfo* deviceInfo);
+
+// 销毁图和池中所有图像；调用前 GPU 不能再使用它们
+void destroyFilterGraph(FilterGraph* graph);
+
+// 清空 pass 和资源，保留池中的图像（尺寸变化后重新声明，相同 key 的图像直接复用）
+void resetFilterGraph(FilterGraph* graph);
+
+// 声明中间图像（颜色附件格式，可被采样），返回资源 id；失败返回 -1
+int32_t addGraphResource(FilterGraph* graph, uint32_t width, uint32_t height);
+
+// 声明 pass，返回 pass 下标；输入未被写入、输出重复写入等错误返回 -1
+int32_t addGraphPass(FilterGraph* graph, const std::vector<int32_t>& inputs, int32_t output);
+
+// 剔除无用 pass、分配图像；失败返回 false
+bool compileFilterGraph(FilterGraph* graph);
+
+// pass 是否参与执行（compile 之后有效）
+bool isGraphPassActive(const FilterGraph* graph, int32_t pass);
+
+// 资源的 image view（kGraphInput / kGraphOutput 返回 VK_NULL_HANDLE，由调用方提供）
+VkImageView getGraphResourceView(const FilterGraph* graph, int32_t resource);
+
+// 开始/结束写入中间资源的 pass；输出为 kGraphOutput 的 pass 由 runner 的输出 pass 录制
+void beginGraphPass(FilterGraph* graph, VkCommandBuffer commandBuffer, int32_t pass);
+void endGraphPass(FilterGraph* graph, VkCommandBuffer commandBuffer, int32_t pass);
+
+#endif // VULKAN_FILTER_GRAPH_H
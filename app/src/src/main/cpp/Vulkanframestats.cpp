@@ -0,0 +1,301 @@
+//
+// Frame statistics: fixed-memory latency histograms for every stage of the runner's frame loop.
+//
+#include "Vulkanjni.h"
+#include "Vulkanframestats.h"
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+
+using namespace VulkanJNI;
+
+// ============================================
+// FrameStats
+// ============================================
+
+struct FrameStats {
+    std::mutex mutex;  // 快照和 markFrameInput 可能在其他线程
+    FrameHistogram histograms[FRAME_METRIC_COUNT];
+
+    uint64_t presentedFrames = 0;
+    uint64_t firstPresentNs = 0;
+    uint64_t lastPresentNs = 0;
+    uint64_t inputFrames = 0;
+    uint64_t coalescedInputs = 0;
+    uint64_t acquireFailures = 0;
+    uint64_t presentSuboptimal = 0;
+    uint64_t presentOutOfDate = 0;
+    uint64_t presentErrors = 0;
+
+    uint64_t pendingInputNs = 0;  // 最早一个还没有 present 的输入帧，0 表示没有
+    uint64_t acquiredNs = 0;      // 本帧 acquire 返回的时间（录制开始），0 表示没有成功 acquire
+};
+
+namespace {
+
+    FrameStats* getFrameStats(DeviceInfo* deviceInfo) {
+        return deviceInfo ? deviceInfo->frameStats : nullptr;
+    }
+
+    void recordNs(FrameStats* stats, FrameMetric metric, uint64_t beginNs, uint64_t endNs) {
+        const uint64_t ns = endNs > beginNs ? endNs - beginNs : 0;
+        stats->histograms[metric].record((ns + 500) / 1000);
+    }
+
+    double usToMs(uint64_t us) {
+        return static_cast<double>(us) / 1000.0;
+    }
+
+    FrameMetricSummary summarize(const FrameHistogram& histogram) {
+        FrameMetricSummary summary;
+        summary.count = histogram.count();
+        if (summary.count == 0) return summary;
+        summary.minMs = usToMs(histogram.min());
+        summary.avgMs = histogram.mean() / 1000.0;
+        summary.p50Ms = usToMs(histogram.percentile(50.0));
+        summary.p90Ms = usToMs(histogram.percentile(90.0));
+        summary.p99Ms = usToMs(histogram.percentile(99.0));
+        summary.maxMs = usToMs(histogram.max());
+        return summary;
+    }
+
+    void fillSnapshot(const FrameStats* stats, FrameStatsSnapshot* snapshot) {
+        snapshot->presentedFrames = stats->presentedFrames;
+        snapshot->elapsedSeconds = stats->presentedFrames > 1 ?
+                static_cast<double>(stats->lastPresentNs - stats->firstPresentNs) / 1e9 : 0.0;
+        snapshot->fps = snapshot->elapsedSeconds > 0.0 ?
+                static_cast<double>(stats->presentedFrames - 1) / snapshot->elapsedSeconds : 0.0;
+        snapshot->inputFrames = stats->inputFrames;
+        snapshot->coalescedInputs = stats->coalescedInputs;
+        snapshot->acquireFailures = stats->acquireFailures;
+        snapshot->presentSuboptimal = stats->presentSuboptimal;
+        snapshot->presentOutOfDate = stats->presentOutOfDate;
+        snapshot->presentErrors = stats->presentErrors;
+        snapshot->droppedFrames = stats->coalescedInputs + stats->acquireFailures +
+                                  stats->presentOutOfDate + stats->presentErrors;
+        for (uint32_t i = 0; i < FRAME_METRIC_COUNT; i++) {
+            snapshot->metrics[i] = summarize(stats->histograms[i]);
+        }
+    }
+
+    void logStats(const FrameStats* stats) {
+        FrameStatsSnapshot snapshot;
+        fillSnapshot(stats, &snapshot);
+        const FrameMetricSummary* m = snapshot.metrics;
+        LOGI("Frames: %llu presented, %.1f fps, %llu dropped; p99 ms: fence %.2f acquire %.2f record %.2f "
+             "submit %.2f present %.2f gpu %.2f input->present %.2f",
+             static_cast<unsigned long long>(snapshot.presentedFrames), snapshot.fps,
+             static_cast<unsigned long long>(snapshot.droppedFrames),
+             m[FRAME_METRIC_FENCE_WAIT].p99Ms, m[FRAME_METRIC_ACQUIRE_WAIT].p99Ms,
+             m[FRAME_METRIC_CPU_RECORD].p99Ms, m[FRAME_METRIC_CPU_SUBMIT].p99Ms,
+             m[FRAME_METRIC_PRESENT].p99Ms, m[FRAME_METRIC_GPU].p99Ms,
+             m[FRAME_METRIC_INPUT_TO_PRESENT].p99Ms);
+    }
+
+} // anonymous namespace
+
+// ============================================
+// Lifetime
+// ============================================
+
+void createFrameStats(DeviceInfo* deviceInfo) {
+    if (deviceInfo->frameStats == nullptr) {
+        deviceInfo->frameStats = new FrameStats();
+    }
+}
+
+void destroyFrameStats(DeviceInfo* deviceInfo) {
+    delete deviceInfo->frameStats;
+    deviceInfo->frameStats = nullptr;
+}
+
+// ============================================
+// Recording
+// ============================================
+
+void frameStatsFenceWait(DeviceInfo* deviceInfo, uint64_t beginNs, uint64_t endNs) {
+    FrameStats* stats = getFrameStats(deviceInfo);
+    if (!stats) return;
+    std::lock_guard<std::mutex> lock(stats->mutex);
+    recordNs(stats, FRAME_METRIC_FENCE_WAIT, beginNs, endNs);
+}
+
+void frameStatsAcquire(DeviceInfo* deviceInfo, uint64_t beginNs, uint64_t endNs, VkResult result) {
+    FrameStats* stats = getFrameStats(deviceInfo);
+    if (!stats) return;
+    std::lock_guard<std::mutex> lock(stats->mutex);
+    recordNs(stats, FRAME_METRIC_ACQUIRE_WAIT, beginNs, endNs);
+    // 与 runner 一致：SUBOPTIMAL 仍然渲染，负的结果码放弃本帧
+    if (result < 0) {
+        stats->acquireFailures++;
+        stats->acquiredNs = 0;
+    } else {
+        stats->acquiredNs = endNs;
+    }
+}
+
+void frameStatsSubmit(DeviceInfo* deviceInfo, uint64_t beginNs, uint64_t endNs) {
+    FrameStats* stats = getFrameStats(deviceInfo);
+    if (!stats) return;
+    std::lock_guard<std::mutex> lock(stats->mutex);
+    if (stats->acquiredNs != 0) {
+        recordNs(stats, FRAME_METRIC_CPU_RECORD, stats->acquiredNs, beginNs);
+        stats->acquiredNs = 0;
+    }
+    recordNs(stats, FRAME_METRIC_CPU_SUBMIT, beginNs, endNs);
+}
+
+void frameStatsPresent(DeviceInfo* deviceInfo, uint64_t beginNs, uint64_t endNs, VkResult result) {
+    FrameStats* stats = getFrameStats(deviceInfo);
+    if (!stats) return;
+    std::lock_guard<std::mutex> lock(stats->mutex);
+    recordNs(stats, FRAME_METRIC_PRESENT, beginNs, endNs);
+
+    if (result == VK_ERROR_OUT_OF_DATE_KHR) {
+        stats->presentOutOfDate++;
+        return;
+    }
+    if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) {
+        stats->presentErrors++;
+        return;
+    }
+    if (result == VK_SUBOPTIMAL_KHR) {
+        stats->presentSuboptimal++;
+    }
+
+    if (stats->presentedFrames > 0) {
+        recordNs(stats, FRAME_METRIC_FRAME_INTERVAL, stats->lastPresentNs, endNs);
+    } else {
+        stats->firstPresentNs = endNs;
+    }
+    stats->lastPresentNs = endNs;
+    stats->presentedFrames++;
+
+    if (stats->pendingInputNs != 0) {
+        recordNs(stats, FRAME_METRIC_INPUT_TO_PRESENT, stats->pendingInputNs, endNs);
+        stats->pendingInputNs = 0;
+    }
+
+    if (stats->presentedFrames % kFrameStatsLogInterval == 0) {
+        logStats(stats);
+    }
+}
+
+void frameStatsGpuTime(DeviceInfo* deviceInfo, double gpuMs) {
+    FrameStats* stats = getFrameStats(deviceInfo);
+    if (!stats || gpuMs < 0.0) return;
+    std::lock_guard<std::mutex> lock(stats->mutex);
+    stats->histograms[FRAME_METRIC_GPU].record(static_cast<uint64_t>(gpuMs * 1000.0 + 0.5));
+}
+
+void markFrameInput(DeviceInfo* deviceInfo, uint64_t timeNs) {
+    FrameStats* stats = getFrameStats(deviceInfo);
+    if (!stats) return;
+    std::lock_guard<std::mutex> lock(stats->mutex);
+    stats->inputFrames++;
+    if (stats->pendingInputNs == 0) {
+        stats->pendingInputNs = timeNs;
+    } else {
+        // 上一个输入帧还没显示就被覆盖了
+        stats->coalescedInputs++;
+    }
+}
+
+// ============================================
+// Queries
+// ============================================
+
+bool getFrameStatsSnapshot(DeviceInfo* deviceInfo, FrameStatsSnapshot* snapshot) {
+    FrameStats* stats = getFrameStats(deviceInfo);
+    if (!stats) return false;
+    std::lock_guard<std::mutex> lock(stats->mutex);
+    fillSnapshot(stats, snapshot);
+    return true;
+}
+
+void resetFrameStats(DeviceInfo* deviceInfo) {
+    FrameStats* stats = getFrameStats(deviceInfo);
+    if (!stats) return;
+    std::lock_guard<std::mutex> lock(stats->mutex);
+    for (FrameHistogram& histogram : stats->histograms) {
+        histogram.reset();
+    }
+    stats->presentedFrames = 0;
+    stats->firstPresentNs = 0;
+    stats->lastPresentNs = 0;
+    stats->inputFrames = 0;
+    stats->coalescedInputs = 0;
+    stats->acquireFailures = 0;
+    stats->presentSuboptimal = 0;
+    stats->presentOutOfDate = 0;
+    stats->presentErrors = 0;
+    // pendingInputNs / acquiredNs 属于正在进行的帧，保留
+}
+
+// ============================================
+// JNI: VulkanRunner
+// ============================================
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeMarkFrameInput(
+        JNIEnv* env, jobject /* this */, jlong deviceHandle, jlong timeNanos) {
+
+    DeviceInfo* deviceInfo = getDeviceInfo(deviceHandle);
+    if (deviceInfo && timeNanos > 0) {
+        markFrameInput(deviceInfo, static_cast<uint64_t>(timeNanos));
+    }
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeResetFrameStats(
+        JNIEnv* env, jobject /* this */, jlong deviceHandle) {
+
+    DeviceInfo* deviceInfo = getDeviceInfo(deviceHandle);
+    if (deviceInfo) {
+        resetFrameStats(deviceInfo);
+    }
+}
+
+// [presentedFrames, elapsedSeconds, fps, inputFrames, coalescedInputs, acquireFailures,
+//  presentSuboptimal, presentOutOfDate, presentErrors, droppedFrames,
+//  然后按 FrameMetric 顺序每项 7 个值：count, minMs, avgMs, p50Ms, p90Ms, p99Ms, maxMs]
+extern "C" JNIEXPORT jdoubleArray JNICALL
+Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeGetFrameStats(
+        JNIEnv* env, jobject /* this */, jlong deviceHandle) {
+
+    DeviceInfo* deviceInfo = getDeviceInfo(deviceHandle);
+    FrameStatsSnapshot snapshot;
+    if (!deviceInfo || !getFrameStatsSnapshot(deviceInfo, &snapshot)) {
+        return nullptr;
+    }
+
+    constexpr size_t kHeaderValues = 10;
+    constexpr size_t kMetricValues = 7;
+    jdouble values[kHeaderValues + FRAME_METRIC_COUNT * kMetricValues];
+    size_t n = 0;
+    values[n++] = static_cast<jdouble>(snapshot.presentedFrames);
+    values[n++] = snapshot.elapsedSeconds;
+    values[n++] = snapshot.fps;
+    values[n++] = static_cast<jdouble>(snapshot.inputFrames);
+    values[n++] = static_cast<jdouble>(snapshot.coalescedInputs);
+    values[n++] = static_cast<jdouble>(snapshot.acquireFailures);
+    values[n++] = static_cast<jdouble>(snapshot.presentSuboptimal);
+    values[n++] = static_cast<jdouble>(snapshot.presentOutOfDate);
+    values[n++] = static_cast<jdouble>(snapshot.presentErrors);
+    values[n++] = static_cast<jdouble>(snapshot.droppedFrames);
+    for (const FrameMetricSummary& metric : snapshot.metrics) {
+        values[n++] = static_cast<jdouble>(metric.count);
+        values[n++] = metric.minMs;
+        values[n++] = metric.avgMs;
+        values[n++] = metric.p50Ms;
+        values[n++] = metric.p90Ms;
+        values[n++] = metric.p99Ms;
+        values[n++] = metric.maxMs;
+    }
+
+    jdoubleArray array = env->NewDoubleArray(static_cast<jsize>(n));
+    if (array) {
+        env->SetDoubleArrayRegion(array, 0, static_cast<jsize>(n), values);
+    }
+    return array;
+}
@@ -0,0 +1,84 @@
+//
+// Frame statistics: fixed-memory latency histograms for every stage of the runner's frame loop.
+//
+// VulkanRunner 之前看不出实际帧率、丢了多少帧、每帧时间花在哪一段。这里在渲染线程已有的 JNI 调用里
+// 直接计时，不增加 JNI 往返：
+// - fence 等待（nativeWaitForFence）、acquire 等待（nativeAcquireNextImageWithSemaphore）；
+// - CPU 录制：acquire 返回到提交开始之间（Kotlin 侧 recordCommandBuffer 的全部 JNI 调用）；
+// - 提交（vkQueueSubmit）、present 调用本身，以及 present 的返回码计数；
+// - GPU 整帧时间：来自 GPU profiler 的 "frame" scope（runner 以 gpuProfiling 启动时才有）；
+// - 输入到 present 的延迟：新输入帧到达（markFrameInput）到包含它的帧 vkQueuePresentKHR 返回，
+//   两次 present 之间到达多个输入时从最早的一个算起，其余计为被合并（丢弃）的输入帧；
+// - 相邻两次成功 present 的间隔（帧率）。
+//
+// 每项一个 FrameHistogram（Vulkanhistogram.h），单位微秒；
+// 所有计数在创建时一次分配好，记录一次是 O(1) 的几条整数运算，每帧不分配内存。
+// 统计一直开启；录制函数只在渲染线程调用，markFrameInput 和快照可以在任意线程调用。
+//
+#ifndef VULKAN_FRAME_STATS_H
+#define VULKAN_FRAME_STATS_H
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include "Vulkantypes.h"
+#include "Vulkanhistogram.h"
+
+constexpr uint32_t kFrameStatsLogInterval = 600;  // 每多少帧写一次日志
+
+enum FrameMetric : uint32_t {
+    FRAME_METRIC_FENCE_WAIT,
+    FRAME_METRIC_ACQUIRE_WAIT,
+    FRAME_METRIC_CPU_RECORD,
+    FRAME_METRIC_CPU_SUBMIT,
+    FRAME_METRIC_PRESENT,
+    FRAME_METRIC_GPU,
+    FRAME_METRIC_INPUT_TO_PRESENT,
+    FRAME_METRIC_FRAME_INTERVAL,
+    FRAME_METRIC_COUNT
+};
+
+// 快照中每项的分布（毫秒）
+struct FrameMetricSummary {
+    uint64_t count = 0;
+    double minMs = 0.0;
+    double avgMs = 0.0;
+    double p50Ms = 0.0;
+    double p90Ms = 0.0;
+    double p99Ms = 0.0;
+    double maxMs = 0.0;
+};
+
+struct FrameStatsSnapshot {
+    uint64_t presentedFrames = 0;    // present 返回 SUCCESS 或 SUBOPTIMAL
+    double elapsedSeconds = 0.0;     // 第一次到最近一次成功 present
+    double fps = 0.0;
+    uint64_t inputFrames = 0;        // markFrameInput 次数
+    uint64_t coalescedInputs = 0;    // 被更新的输入覆盖、没有单独 present 的输入帧
+    uint64_t acquireFailures = 0;
+    uint64_t presentSuboptimal = 0;
+    uint64_t presentOutOfDate = 0;
+    uint64_t presentErrors = 0;      // 其他错误码
+    uint64_t droppedFrames = 0;      // coalescedInputs + acquireFailures + presentOutOfDate + presentErrors
+    FrameMetricSummary metrics[FRAME_METRIC_COUNT];
+};
+
+// nativeCreateDevice 中创建，nativeDestroyDevice 中销毁；未创建时所有调用都是空操作
+void createFrameStats(DeviceInfo* deviceInfo);
+void destroyFrameStats(DeviceInfo* deviceInfo);
+
+// 渲染线程：各阶段的开始/结束时间为 CLOCK_MONOTONIC 纳秒（traceNowNs）
+void frameStatsFenceWait(DeviceInfo* deviceInfo, uint64_t beginNs, uint64_t endNs);
+void frameStatsAcquire(DeviceInfo* deviceInfo, uint64_t beginNs, uint64_t endNs, VkResult result);
+void frameStatsSubmit(DeviceInfo* deviceInfo, uint64_t beginNs, uint64_t endNs);
+void frameStatsPresent(DeviceInfo* deviceInfo, uint64_t beginNs, uint64_t endNs, VkResult result);
+
+// GPU profiler 读取到一帧的整帧时间时调用
+void frameStatsGpuTime(DeviceInfo* deviceInfo, double gpuMs);
+
+// 新的输入帧到达（timeNs 与 System.nanoTime() 同一时钟）
+void markFrameInput(DeviceInfo* deviceInfo, uint64_t timeNs);
+
+bool getFrameStatsSnapshot(DeviceInfo* deviceInfo, FrameStatsSnapshot* snapshot);
+void resetFrameStats(DeviceInfo* deviceInfo);
+
+#endif // VULKAN_FRAME_STATS_H
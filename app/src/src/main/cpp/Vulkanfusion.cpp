@@ -0,0 +1,575 @@
+//
+// Filter fusion: per-pixel filter chains compiled into a single shader at runtime.
+//
+#include "Vulkanjni.h"
+#include "Vulkanfusion.h"
+#include "Vulkanpipelineregistry.h"
+#include "Vulkansamplers.h"
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+#include <unistd.h>
+
+#include <shaderc/shaderc.h>
+
+using namespace VulkanJNI;
+
+namespace {
+
+    constexpr uint32_t kSpirvMagic = 0x07230203;
+
+    // 编译器配置变化（版本、目标环境、优化级别）时修改，旧的磁盘缓存自然失效
+    constexpr const char* kCompilerTag = "shaderc/vulkan1.1/performance/2";
+
+    // 与 Vulkanfusion.h 中 kFusionPushConstantSize 对应的 push constant 块
+    const char* const kCommonDeclarations = R"(
+layout(push_constant) uniform PushConstants {
+    vec4 tex_transform[2];  // 纹理坐标 = (dot(row0.xyz, (uv, 1)), dot(row1.xyz, (uv, 1)))
+    ivec4 region;           // 计算路径：本次 dispatch 覆盖的输出区域 x, y, width, height
+    vec4 params[5];         // 各阶段的参数，param(i) 读取
+} pc;
+
+layout(set = 0, binding = 0) uniform sampler2D texSampler;
+
+bool outsideUnit(vec2 p) {
+    return any(lessThan(p, vec2(0.0))) || any(greaterThan(p, vec2(1.0)));
+}
+
+// 第一级读取输入纹理：越界为透明黑色（与 affine.frag 的 CLIP_OUT_OF_RANGE 一致）
+vec4 sampleInput(vec2 p) {
+    if (outsideUnit(p)) {
+        return vec4(0.0);
+    }
+    vec3 q = vec3(p, 1.0);
+    return textureLod(texSampler, vec2(dot(pc.tex_transform[0].xyz, q), dot(pc.tex_transform[1].xyz, q)), 0.0);
+}
+)";
+
+    const char* const kVertexShader = R"(#version 450
+
+// 全屏三角形：顶点 0/1/2 -> uv (0, 0) / (2, 0) / (0, 2)
+layout(location = 0) out vec2 fragTexCoord;
+
+void main() {
+    vec2 uv = vec2((gl_VertexIndex << 1) & 2, gl_VertexIndex & 2);
+    gl_Position = vec4(uv * 2.0 - 1.0, 0.0, 1.0);
+    fragTexCoord = uv;
+}
+)";
+
+    // 阶段函数 + runChain(uv)：uv 为最后一级输出像素的坐标
+    void appendChain(std::string& out, const std::vector<FusionStage>& stages) {
+        const size_t count = stages.size();
+        char line[160];
+
+        for (size_t k = 0; k < count; ++k) {
+            const FusionStage& stage = stages[k];
+            snprintf(line, sizeof(line), "\n// ---- stage %zu ----\n#define param(i) pc.params[%u + (i)]\n",
+                     k, stage.paramOffset);
+            out += line;
+            if (!stage.uv.empty()) {
+                snprintf(line, sizeof(line), "vec2 stage%zu_uv(vec2 uv) {\n", k);
+                out += line;
+                out += stage.uv;
+                out += "\n}\n";
+            }
+            if (!stage.color.empty()) {
+                snprintf(line, sizeof(line), "vec4 stage%zu_color(vec4 color, vec2 uv) {\n", k);
+                out += line;
+                out += stage.color;
+                out += "\n}\n";
+            }
+            out += "#undef param\n";
+        }
+
+        // 坐标逆序：p{k} 是阶段 k 输出像素的坐标，阶段 k 读取 p{k-1}
+        out += "\nvec4 runChain(vec2 uv) {\n";
+        snprintf(line, sizeof(line), "    vec2 p%zu = uv;\n", count - 1);
+        out += line;
+        for (size_t k = count - 1; k > 0; --k) {
+            if (stages[k].uv.empty()) {
+                snprintf(line, sizeof(line), "    vec2 p%zu = p%zu;\n", k - 1, k);
+            } else {
+                snprintf(line, sizeof(line), "    vec2 p%zu = stage%zu_uv(p%zu);\n", k - 1, k, k);
+            }
+            out += line;
+        }
+        if (stages[0].uv.empty()) {
+            out += "    vec4 color = sampleInput(p0);\n";
+        } else {
+            out += "    vec4 color = sampleInput(stage0_uv(p0));\n";
+        }
+
+        // 颜色顺序执行。阶段 k+1 自己变换了坐标时，它读到的 p{k} 可能越界 -> 透明黑色；
+        // 没有变换时 p{k} 与后面的坐标相同，越界会在更后面被清零，结果一样
+        for (size_t k = 0; k < count; ++k) {
+            if (k > 0 && !stages[k].uv.empty()) {
+                snprintf(line, sizeof(line), "    if (outsideUnit(p%zu)) color = vec4(0.0);\n", k - 1);
+                out += line;
+            }
+            if (!stages[k].color.empty()) {
+                snprintf(line, sizeof(line), "    color = stage%zu_color(color, p%zu);\n", k, k);
+                out += line;
+            }
+        }
+        out += "    return color;\n}\n";
+    }
+
+    uint64_t fnv1a(uint64_t hash, const void* data, size_t size) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= bytes[i];
+            hash *= 0x100000001b3ULL;
+        }
+        return hash;
+    }
+
+    bool isValidSpirv(const std::vector<uint32_t>& code) {
+        return code.size() >= 5 && code[0] == kSpirvMagic;
+    }
+
+    // ====== SPIR-V 缓存 ======
+
+    std::mutex gCacheMutex;
+    std::unordered_map<uint64_t, std::vector<uint32_t>> gSpirvCache;
+
+    std::string cacheFilePath(const char* cacheDir, uint64_t hash) {
+        char name[32];
+        snprintf(name, sizeof(name), "/%016" PRIx64 ".spv", hash);
+        return std::string(cacheDir) + name;
+    }
+
+    bool loadCachedSpirv(const std::string& path, std::vector<uint32_t>* spirv) {
+        FILE* file = fopen(path.c_str(), "rb");
+        if (!file) {
+            return false;
+        }
+        fseek(file, 0, SEEK_END);
+        long size = ftell(file);
+        fseek(file, 0, SEEK_SET);
+
+        bool ok = size > 0 && size % 4 == 0;
+        if (ok) {
+            spirv->resize(static_cast<size_t>(size) / 4);
+            ok = fread(spirv->data(), 1, static_cast<size_t>(size), file) == static_cast<size_t>(size);
+        }
+        fclose(file);
+
+        if (!ok || !isValidSpirv(*spirv)) {
+            LOGE("Ignoring corrupt fused shader cache %s", path.c_str());
+            spirv->clear();
+            unlink(path.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    // 先写临时文件再 rename；多个线程同时编译同一条链时各自写自己的临时文件
+    void saveCachedSpirv(const std::string& path, const std::vector<uint32_t>& spirv) {
+        const std::string tmpPath = path + "." + std::to_string(gettid()) + ".tmp";
+        FILE* file = fopen(tmpPath.c_str(), "wb");
+        if (!file) {
+            LOGE("Failed to open %s for writing", tmpPath.c_str());
+            return;
+        }
+        const size_t size = spirv.size() * sizeof(uint32_t);
+        bool ok = fwrite(spirv.data(), 1, size, file) == size;
+        ok = (fclose(file) == 0) && ok;
+        if (!ok || rename(tmpPath.c_str(), path.c_str()) != 0) {
+            LOGE("Failed to write fused shader cache %s", path.c_str());
+            unlink(tmpPath.c_str());
+        }
+    }
+
+    // ====== 运行时编译 ======
+
+    bool compileGlsl(const std::string& source, FusionShaderKind kind, std::vector<uint32_t>* spirv) {
+        // 编译器对象可以被多个线程同时使用（options 不被修改的前提下）
+        static shaderc_compiler_t compiler = shaderc_compiler_initialize();
+        if (!compiler) {
+            LOGE("shaderc_compiler_initialize failed");
+            return false;
+        }
+
+        shaderc_shader_kind shaderKind = shaderc_glsl_vertex_shader;
+        if (kind == FusionShaderKind::Fragment) shaderKind = shaderc_glsl_fragment_shader;
+        if (kind == FusionShaderKind::Compute) shaderKind = shaderc_glsl_compute_shader;
+
+        shaderc_compile_options_t options = shaderc_compile_options_initialize();
+        shaderc_compile_options_set_target_env(options, shaderc_target_env_vulkan,
+                                               shaderc_env_version_vulkan_1_1);
+        shaderc_compile_options_set_optimization_level(options, shaderc_optimization_level_performance);
+
+        shaderc_compilation_result_t result = shaderc_compile_into_spv(
+                compiler, source.data(), source.size(), shaderKind, "fused", "main", options);
+        shaderc_compile_options_release(options);
+
+        bool ok = shaderc_result_get_compilation_status(result) == shaderc_compilation_status_success;
+        if (ok) {
+            const size_t length = shaderc_result_get_length(result);
+            spirv->resize(length / sizeof(uint32_t));
+            memcpy(spirv->data(), shaderc_result_get_bytes(result), spirv->size() * sizeof(uint32_t));
+        } else {
+            LOGE("Fused shader compilation failed:\n%s", shaderc_result_get_error_message(result));
+            LOGD("Fused shader source:\n%s", source.c_str());
+        }
+        shaderc_result_release(result);
+        return ok && isValidSpirv(*spirv);
+    }
+
+} // anonymous namespace
+
+std::string generateFusedShader(const std::vector<FusionStage>& stages, FusionShaderKind kind) {
+    if (kind == FusionShaderKind::Vertex) {
+        return kVertexShader;
+    }
+    if (stages.empty()) {
+        LOGE("Cannot fuse an empty filter chain");
+        return std::string();
+    }
+    for (const FusionStage& stage : stages) {
+        // 分开比较，避免 paramOffset + paramCount 回绕
+        if (stage.paramOffset > kFusionMaxParams || stage.paramCount > kFusionMaxParams - stage.paramOffset) {
+            LOGE("Fusion stage parameters [%u, %u + %u) out of range (max %u)",
+                 stage.paramOffset, stage.paramOffset, stage.paramCount, kFusionMaxParams);
+            return std::string();
+        }
+    }
+
+    std::string source = "#version 450\n";
+    if (kind == FusionShaderKind::Compute) {
+        source += "\nlayout(local_size_x = 16, local_size_y = 16, local_size_z = 1) in;\n"
+                  "layout(set = 0, binding = 1, rgba8) uniform writeonly image2D outImage;\n";
+    } else {
+        source += "\nlayout(location = 0) in vec2 fragTexCoord;\n"
+                  "layout(location = 0) out vec4 outColor;\n";
+    }
+    source += kCommonDeclarations;
+    appendChain(source, stages);
+
+    if (kind == FusionShaderKind::Compute) {
+        source += R"(
+void main() {
+    ivec2 outSize = imageSize(outImage);
+    ivec2 pixel = pc.region.xy + ivec2(gl_GlobalInvocationID.xy);
+    ivec2 regionEnd = min(pc.region.xy + pc.region.zw, outSize);
+    if (any(greaterThanEqual(pixel, regionEnd))) {
+        return;
+    }
+    imageStore(outImage, pixel, runChain((vec2(pixel) + 0.5) / vec2(outSize)));
+}
+)";
+    } else {
+        source += R"(
+void main() {
+    outColor = runChain(fragTexCoord);
+}
+)";
+    }
+    return source;
+}
+
+uint64_t hashFusedShader(const std::string& source, FusionShaderKind kind) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    const int32_t kindValue = static_cast<int32_t>(kind);
+    hash = fnv1a(hash, &kindValue, sizeof(kindValue));
+    hash = fnv1a(hash, kCompilerTag, strlen(kCompilerTag));
+    return fnv1a(hash, source.data(), source.size());
+}
+
+bool compileFusedShader(const std::vector<FusionStage>& stages, FusionShaderKind kind,
+                        const char* cacheDir, std::vector<uint32_t>* spirv) {
+    const std::string source = generateFusedShader(stages, kind);
+    if (source.empty()) {
+        return false;
+    }
+    const uint64_t hash = hashFusedShader(source, kind);
+
+    {
+        std::lock_guard<std::mutex> lock(gCacheMutex);
+        auto it = gSpirvCache.find(hash);
+        if (it != gSpirvCache.end()) {
+            *spirv = it->second;
+            return true;
+        }
+    }
+
+    const std::string path = cacheDir ? cacheFilePath(cacheDir, hash) : std::string();
+    if (!path.empty() && loadCachedSpirv(path, spirv)) {
+        LOGD("Fused shader %016" PRIx64 " loaded from disk cache", hash);
+    } else {
+        if (!compileGlsl(source, kind, spirv)) {
+            return false;
+        }
+        LOGI("Fused shader %016" PRIx64 " compiled: %zu stages, %zu bytes",
+             hash, stages.size(), spirv->size() * sizeof(uint32_t));
+        if (!path.empty()) {
+            saveCachedSpirv(path, *spirv);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(gCacheMutex);
+    gSpirvCache.emplace(hash, *spirv);
+    return true;
+}
+
+// ============================================
+// JNI: FusedVulkanFilter
+// ============================================
+// shaderc 随 native 库一起构建（见 CMakeLists.txt），nativeIsCompilerAvailable 总是 true
+namespace {
+
+    // 与 kCommonDeclarations 中的 push constant 块一致；Kotlin 端按 float 打包，region 在这里填
+    struct FusionPushConstants {
+        float texTransform[8];
+        int32_t region[4];
+        float params[kFusionMaxParams * 4];
+    };
+    static_assert(sizeof(FusionPushConstants) == kFusionPushConstantSize, "push constant layout");
+
+    constexpr jsize kPushConstantFloats = kFusionPushConstantSize / sizeof(float);
+
+    bool readPushConstants(JNIEnv* env, jfloatArray constantArray, FusionPushConstants* constants) {
+        if (!constantArray || env->GetArrayLength(constantArray) != kPushConstantFloats) {
+            LOGE("Invalid fusion push constants (expected %d floats)", kPushConstantFloats);
+            return false;
+        }
+        env->GetFloatArrayRegion(constantArray, 0, kPushConstantFloats, reinterpret_cast<jfloat*>(constants));
+        return true;
+    }
+
+} // anonymous namespace
+
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_genymobile_scrcpy_vulkan_FusedVulkanFilter_nativeIsCompilerAvailable(
+        JNIEnv* env, jclass /* clazz */) {
+    return JNI_TRUE;
+}
+
+// uvSnippets / colorSnippets 的元素可以为 null（该阶段不做这一步）；失败返回 null
+extern "C" JNIEXPORT jbyteArray JNICALL
+Java_com_genymobile_scrcpy_vulkan_FusedVulkanFilter_nativeCompile(
+        JNIEnv* env, jobject /* this */,
+        jstring cacheDirString,
+        jobjectArray uvSnippets,
+        jobjectArray colorSnippets,
+        jintArray paramOffsetArray,
+        jintArray paramCountArray,
+        jint kind) {
+
+    if (!uvSnippets || !colorSnippets || !paramOffsetArray || !paramCountArray) {
+        LOGE("Invalid fusion stage arrays");
+        return nullptr;
+    }
+    const jsize count = env->GetArrayLength(uvSnippets);
+    if (env->GetArrayLength(colorSnippets) != count || env->GetArrayLength(paramOffsetArray) != count ||
+        env->GetArrayLength(paramCountArray) != count) {
+        LOGE("Fusion stage arrays have different lengths");
+        return nullptr;
+    }
+    if (kind < static_cast<jint>(FusionShaderKind::Vertex) || kind > static_cast<jint>(FusionShaderKind::Compute)) {
+        LOGE("Invalid fused shader kind: %d", kind);
+        return nullptr;
+    }
+
+    auto toString = [env](jobjectArray array, jsize index) {
+        jstring value = static_cast<jstring>(env->GetObjectArrayElement(array, index));
+        std::string result;
+        if (value) {
+            const char* chars = env->GetStringUTFChars(value, nullptr);
+            result = chars;
+            env->ReleaseStringUTFChars(value, chars);
+            env->DeleteLocalRef(value);
+        }
+        return result;
+    };
+
+    std::vector<jint> offsets(count);
+    std::vector<jint> paramCounts(count);
+    env->GetIntArrayRegion(paramOffsetArray, 0, count, offsets.data());
+    env->GetIntArrayRegion(paramCountArray, 0, count, paramCounts.data());
+
+    std::vector<FusionStage> stages(count);
+    for (jsize i = 0; i < count; ++i) {
+        stages[i].uv = toString(uvSnippets, i);
+        stages[i].color = toString(colorSnippets, i);
+        if (offsets[i] < 0 || paramCounts[i] < 0) {
+            LOGE("Negative fusion stage parameter offset or count");
+            return nullptr;
+        }
+        stages[i].paramOffset = static_cast<uint32_t>(offsets[i]);
+        stages[i].paramCount = static_cast<uint32_t>(paramCounts[i]);
+    }
+
+    std::string cacheDir;
+    if (cacheDirString) {
+        const char* chars = env->GetStringUTFChars(cacheDirString, nullptr);
+        cacheDir = chars;
+        env->ReleaseStringUTFChars(cacheDirString, chars);
+    }
+
+    std::vector<uint32_t> spirv;
+    if (!compileFusedShader(stages, static_cast<FusionShaderKind>(kind),
+                            cacheDir.empty() ? nullptr : cacheDir.c_str(), &spirv)) {
+        return nullptr;
+    }
+
+    const jsize size = static_cast<jsize>(spirv.size() * sizeof(uint32_t));
+    jbyteArray array = env->NewByteArray(size);
+    env->SetByteArrayRegion(array, 0, size, reinterpret_cast<const jbyte*>(spirv.data()));
+    return array;
+}
+
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_genymobile_scrcpy_vulkan_FusedVulkanFilter_nativeCreateShaderModule(
+        JNIEnv* env, jobject /* this */, jlong deviceHandle, jbyteArray codeArray) {
+
+    DeviceInfo* deviceInfo = getDeviceInfo(deviceHandle);
+    if (!validateHandle(deviceInfo, "device") || !codeArray) {
+        return 0;
+    }
+    const jsize size = env->GetArrayLength(codeArray);
+    if (size < 20 || size % 4 != 0) {
+        LOGE("Invalid SPIR-V size: %d bytes", size);
+        return 0;
+    }
+
+    // 按 uint32_t 对齐复制
+    std::vector<uint32_t> code(size / 4);
+    env->GetByteArrayRegion(codeArray, 0, size, reinterpret_cast<jbyte*>(code.data()));
+    if (!isValidSpirv(code)) {
+        LOGE("Invalid SPIR-V magic: 0x%08x", code[0]);
+        return 0;
+    }
+
+    VkShaderModuleCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    createInfo.codeSize = static_cast<size_t>(size);
+    createInfo.pCode = code.data();
+
+    VkShaderModule shaderModule = VK_NULL_HANDLE;
+    VkResult result = vkCreateShaderModule(deviceInfo->device, &createInfo, nullptr, &shaderModule);
+    if (!validateResult(result, "vkCreateShaderModule (fused)")) {
+        return 0;
+    }
+    registerShaderModule(deviceInfo, shaderModule, code.data(), static_cast<size_t>(size));
+    return toHandle(shaderModule);
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_genymobile_scrcpy_vulkan_FusedVulkanFilter_nativeDestroyShaderModule(
+        JNIEnv* env, jobject /* this */, jlong deviceHandle, jlong shaderModuleHandle) {
+
+    DeviceInfo* deviceInfo = getDeviceInfo(deviceHandle);
+    VkShaderModule shaderModule = fromHandle<VkShaderModule>(shaderModuleHandle);
+    if (validateHandle(deviceInfo, "device") && shaderModule != VK_NULL_HANDLE) {
+        unregisterShaderModule(deviceInfo, shaderModule);
+        vkDestroyShaderModule(deviceInfo->device, shaderModule, nullptr);
+    }
+}
+
+// 双线性 + CLAMP_TO_EDGE：越界由着色器自己处理（sampleInput）
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_genymobile_scrcpy_vulkan_FusedVulkanFilter_nativeCreateSampler(
+        JNIEnv* env, jobject /* this */, jlong deviceHandle) {
+
+    DeviceInfo* deviceInfo = getDeviceInfo(deviceHandle);
+    if (!validateHandle(deviceInfo, "device")) {
+        return 0;
+    }
+
+    VkSamplerCreateInfo samplerInfo{};
+    samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerInfo.magFilter = VK_FILTER_LINEAR;
+    samplerInfo.minFilter = VK_FILTER_LINEAR;
+    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.maxAnisotropy = 1.0f;
+    samplerInfo.compareOp = VK_COMPARE_OP_ALWAYS;
+    samplerInfo.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
+
+    return toHandle(acquireSampler(deviceInfo, samplerInfo));
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_genymobile_scrcpy_vulkan_FusedVulkanFilter_nativeDestroySampler(
+        JNIEnv* env, jobject /* this */, jlong deviceHandle, jlong samplerHandle) {
+
+    DeviceInfo* deviceInfo = getDeviceInfo(deviceHandle);
+    VkSampler sampler = fromHandle<VkSampler>(samplerHandle);
+    if (validateHandle(deviceInfo, "device")) {
+        releaseSampler(deviceInfo, sampler);
+    }
+}
+
+// 绑定、推送常量并画全屏三角形：一次 JNI 调用完成整个 pass 的录制（descriptor 由 DescriptorManager 绑定）
+extern "C" JNIEXPORT void JNICALL
+Java_com_genymobile_scrcpy_vulkan_FusedVulkanFilter_nativeDraw(
+        JNIEnv* env, jobject /* this */,
+        jlong commandBufferHandle,
+        jlong pipelineHandle,
+        jlong pipelineLayoutHandle,
+        jint stageFlags,
+        jfloatArray constantArray) {
+
+    VkCommandBuffer commandBuffer = fromHandle<VkCommandBuffer>(commandBufferHandle);
+    VkPipeline pipeline = fromHandle<VkPipeline>(pipelineHandle);
+    VkPipelineLayout pipelineLayout = fromHandle<VkPipelineLayout>(pipelineLayoutHandle);
+    FusionPushConstants constants{};
+    if (!validateHandle(commandBuffer, "commandBuffer") || !validateHandle(pipeline, "pipeline") ||
+        !validateHandle(pipelineLayout, "pipelineLayout") ||
+        !readPushConstants(env, constantArray, &constants)) {
+        return;
+    }
+
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+    vkCmdPushConstants(commandBuffer, pipelineLayout, static_cast<VkShaderStageFlags>(stageFlags),
+                       0, sizeof(constants), &constants);
+    vkCmdDraw(commandBuffer, 3, 1, 0, 0);
+}
+
+// 每个矩形一次 dispatch（16x16 工作组），只覆盖脏区域
+extern "C" JNIEXPORT void JNICALL
+Java_com_genymobile_scrcpy_vulkan_FusedVulkanFilter_nativeDispatch(
+        JNIEnv* env, jobject /* this */,
+        jlong commandBufferHandle,
+        jlong pipelineHandle,
+        jlong pipelineLayoutHandle,
+        jint stageFlags,
+        jfloatArray constantArray,
+        jintArray rectArray) {
+
+    VkCommandBuffer commandBuffer = fromHandle<VkCommandBuffer>(commandBufferHandle);
+    VkPipeline pipeline = fromHandle<VkPipeline>(pipelineHandle);
+    VkPipelineLayout pipelineLayout = fromHandle<VkPipelineLayout>(pipelineLayoutHandle);
+    FusionPushConstants constants{};
+    if (!validateHandle(commandBuffer, "commandBuffer") || !validateHandle(pipeline, "pipeline") ||
+        !validateHandle(pipelineLayout, "pipelineLayout") ||
+        !readPushConstants(env, constantArray, &constants) || !rectArray) {
+        return;
+    }
+
+    const jsize count = env->GetArrayLength(rectArray);
+    std::vector<jint> rects(count);
+    env->GetIntArrayRegion(rectArray, 0, count, rects.data());
+
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+
+    for (jsize i = 0; i + 3 < count; i += 4) {
+        const int32_t width = rects[i + 2];
+        const int32_t height = rects[i + 3];
+        if (width <= 0 || height <= 0) continue;
+
+        constants.region[0] = rects[i];
+        constants.region[1] = rects[i + 1];
+        constants.region[2] = width;
+        constants.region[3] = height;
+        vkCmdPushConstants(commandBuffer, pipelineLayout, static_cast<VkShaderStageFlags>(stageFlags),
+                           0, sizeof(constants), &constants);
+        vkCmdDispatch(commandBuffer, (width + 15) / 16, (height + 15) / 16, 1);
+    }
+}
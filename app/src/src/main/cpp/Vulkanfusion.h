@@ -0,0 +1,58 @@
+//
+// Filter fusion: per-pixel filter chains compiled into a single shader at runtime.
+//
+// 调色 → 仿射 → 暗角这样的链如果每个滤镜一个 pass，每一级都要整帧写出再读回一次中间图像。
+// 逐像素滤镜（输出像素只依赖输入的一个采样点）可以合并为一个着色器：每个阶段由两段 GLSL 函数体描述
+// （见 FusionStage），这里把整条链拼成一个片段着色器（以及配套的全屏三角形顶点着色器）或计算着色器，
+// 只读一次输入、写一次输出。
+//
+// 生成的代码与逐级执行等价：
+// - 坐标从输出向输入逆序经过各阶段的 uv 变换，只在第一级采样一次输入；
+// - 颜色按阶段顺序经过各阶段的 color 函数，每个阶段拿到的是它自己输出像素的坐标；
+// - 某一级读取位置超出 [0, 1] 时，与单独执行时一样得到透明黑色，之后的阶段照常处理。
+// 区别只在精度：中间结果不再量化到 8 bit，也只做一次双线性重采样。
+//
+// 编译：运行时用 shaderc（CMakeLists.txt 固定版本，随 native 库一起构建）。
+// 生成的源码连同着色器类型和编译选项一起取 64 位 FNV-1a 作为链的 hash，SPIR-V 按 hash 缓存在进程内，
+// 给出目录时同时写入磁盘（<hash>.spv），之后启动直接加载，不再编译。
+//
+#ifndef VULKAN_FUSION_H
+#define VULKAN_FUSION_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 链中的一个阶段。两段都是 GLSL 函数体（需要 return），为空表示该阶段不做这一步：
+// - uv：   vec2 f(vec2 uv)            —— uv 为本阶段输出像素的坐标，返回它读取上一阶段的坐标
+// - color：vec4 f(vec4 color, vec2 uv) —— color 为读到的颜色，返回本阶段的输出
+// 函数体中用 param(i) 读取本阶段的第 i 个 vec4 参数（push constant 中从 paramOffset 开始，共 paramCount 个）
+struct FusionStage {
+    std::string uv;
+    std::string color;
+    uint32_t paramOffset = 0;
+    uint32_t paramCount = 0;
+};
+
+enum class FusionShaderKind : int32_t {
+    Vertex = 0,    // 全屏三角形，输出 [0, 1] 的 uv（与链无关）
+    Fragment = 1,  // 配合 Vertex 使用，光栅化路径
+    Compute = 2,   // 16x16 工作组直接写 rgba8 存储图像，与 affine.comp 的 dispatch 约定一致
+};
+
+// 所有阶段共用的 vec4 参数个数。push constant 块固定 128 字节：
+// vec4 tex_transform[2]（SurfaceTexture 变换的前两行）+ ivec4 region（计算路径）+ vec4 params[5]
+constexpr uint32_t kFusionMaxParams = 5;
+constexpr uint32_t kFusionPushConstantSize = 128;
+
+// 生成 GLSL 源码；阶段为空或参数越界时返回空字符串
+std::string generateFusedShader(const std::vector<FusionStage>& stages, FusionShaderKind kind);
+
+// 链的 hash：源码 + 着色器类型 + 编译器配置
+uint64_t hashFusedShader(const std::string& source, FusionShaderKind kind);
+
+// 生成、编译并缓存。cacheDir 为 nullptr 时只使用进程内缓存。可以在任意线程调用
+bool compileFusedShader(const std::vector<FusionStage>& stages, FusionShaderKind kind,
+                        const char* cacheDir, std::vector<uint32_t>* spirv);
+
+#endif // VULKAN_FUSION_H
@@ -0,0 +1,63 @@
+//
+// Log-linear latency histogram with fixed memory and O(1) recording.
+//
+#include "Vulkanhistogram.h"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+uint32_t FrameHistogram::bucketIndex(uint64_t valueUs) {
+    if (valueUs < kSubBuckets) return static_cast<uint32_t>(valueUs);
+    valueUs = std::min<uint64_t>(valueUs, (1ull << kMaxBits) - 1);
+
+    // 最高位 exponent ≥ kSubBucketBits：保留最高 kSubBucketBits 位，其中最高位固定为 1
+    const auto exponent = static_cast<uint32_t>(63 - __builtin_clzll(valueUs));
+    const uint32_t shift = exponent - (kSubBucketBits - 1);
+    const auto mantissa = static_cast<uint32_t>(valueUs >> shift);  // [kHalfSubBuckets, kSubBuckets)
+    return kSubBuckets + (exponent - kSubBucketBits) * kHalfSubBuckets + (mantissa - kHalfSubBuckets);
+}
+
+uint64_t FrameHistogram::bucketLowest(uint32_t index) {
+    if (index < kSubBuckets) return index;
+    const uint32_t exponent = kSubBucketBits + (index - kSubBuckets) / kHalfSubBuckets;
+    const uint64_t mantissa = kHalfSubBuckets + (index - kSubBuckets) % kHalfSubBuckets;
+    return mantissa << (exponent - (kSubBucketBits - 1));
+}
+
+uint64_t FrameHistogram::bucketWidth(uint32_t index) {
+    if (index < kSubBuckets) return 1;
+    const uint32_t exponent = kSubBucketBits + (index - kSubBuckets) / kHalfSubBuckets;
+    return 1ull << (exponent - (kSubBucketBits - 1));
+}
+
+void FrameHistogram::record(uint64_t valueUs) {
+    counts_[bucketIndex(valueUs)]++;
+    count_++;
+    sum_ += valueUs;
+    min_ = std::min(min_, valueUs);
+    max_ = std::max(max_, valueUs);
+}
+
+void FrameHistogram::reset() {
+    std::fill(std::begin(counts_), std::end(counts_), 0u);
+    count_ = 0;
+    sum_ = 0;
+    min_ = UINT64_MAX;
+    max_ = 0;
+}
+
+uint64_t FrameHistogram::percentile(double percentile) const {
+    if (count_ == 0) return 0;
+    const double clamped = std::min(std::max(percentile, 0.0), 100.0);
+    const auto target = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(clamped / 100.0 * count_)));
+
+    uint64_t seen = 0;
+    for (uint32_t i = 0; i < kBucketCount; i++) {
+        seen += counts_[i];
+        if (seen >= target) {
+            const uint64_t highest = bucketLowest(i) + bucketWidth(i) - 1;
+            return std::max(min_, std::min(highest, max_));
+        }
+    }
+    return max_;
+}
@@ -0,0 +1,45 @@
+//
+// Log-linear latency histogram with fixed memory and O(1) recording.
+//
+// 对数-线性分桶（HdrHistogram 的做法）：64 个线性桶之后每个 2 的幂区间 32 个桶，
+// 相对误差不超过 1/32，按微秒记录时上限约 19 小时。计数数组内嵌在对象里，记录和重置都不分配内存。
+// 不依赖 Vulkan / JNI，帧统计（Vulkanframestats.h）和桌面微基准（bench/）共用。不是线程安全的。
+//
+#ifndef VULKAN_HISTOGRAM_H
+#define VULKAN_HISTOGRAM_H
+
+#include <cstdint>
+
+class FrameHistogram {
+public:
+    static constexpr uint32_t kSubBucketBits = 6;
+    static constexpr uint32_t kSubBuckets = 1u << kSubBucketBits;  // 线性区间 [0, 64)
+    static constexpr uint32_t kHalfSubBuckets = kSubBuckets / 2;   // 之后每个 2 的幂区间的桶数
+    static constexpr uint32_t kMaxBits = 36;                       // 记录的值小于 2^36 微秒
+    static constexpr uint32_t kBucketCount = kSubBuckets + (kMaxBits - kSubBucketBits) * kHalfSubBuckets;
+
+    // 超出范围的值按最大值记录
+    void record(uint64_t valueUs);
+    void reset();
+
+    uint64_t count() const { return count_; }
+    uint64_t min() const { return count_ ? min_ : 0; }
+    uint64_t max() const { return max_; }
+    double mean() const { return count_ ? static_cast<double>(sum_) / static_cast<double>(count_) : 0.0; }
+
+    // percentile 为 0~100；返回所在桶内的最大值（不超过实际最大值）
+    uint64_t percentile(double percentile) const;
+
+    static uint32_t bucketIndex(uint64_t valueUs);
+    static uint64_t bucketLowest(uint32_t index);
+    static uint64_t bucketWidth(uint32_t index);
+
+private:
+    uint32_t counts_[kBucketCount] = {};
+    uint64_t count_ = 0;
+    uint64_t sum_ = 0;
+    uint64_t min_ = UINT64_MAX;
+    uint64_t max_ = 0;
+};
+
+#endif // VULKAN_HISTOGRAM_H
@@ -4,7 +4,7 @@
 #include <jni.h>
 #include <android/native_window.h>
 #include <android/native_window_jni.h>
-#include <android/log.h>
+#include "Vulkanlog.h"
 #include <vulkan/vulkan.h>
 #include <vulkan/vulkan_android.h>
 #include <vector>
@@ -13,8 +13,8 @@
 #include "VulkanTypes.h"
 
 #define LOG_TAG "VulkanInstance"
-#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
-#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+#define LOGI(...) VLOGI(LOG_TAG, __VA_ARGS__)
+#define LOGE(...) VLOGE(LOG_TAG, __VA_ARGS__)
 
 // 外部函数声明
 extern uint32_t findQueueFamily(VkPhysicalDevice, VkQueueFlags, VkSurfaceKHR);
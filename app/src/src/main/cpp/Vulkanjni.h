@@ -3,16 +3,17 @@
 
 #include <jni.h>
 #include <vulkan/vulkan.h>
-#include <android/log.h>
 #include "Vulkantypes.h"
+#include "Vulkanlog.h"
 
 // ============================================
 // Logging Utilities
 // ============================================
+// 异步、按调用点限流（见 Vulkanlog.h）；LOGD 在 release 构建中被裁剪
 #define LOG_TAG "VulkanRenderer"
-#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
-#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
-#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+#define LOGI(...) VLOGI(LOG_TAG, __VA_ARGS__)
+#define LOGE(...) VLOGE(LOG_TAG, __VA_ARGS__)
+#define LOGD(...) VLOGD(LOG_TAG, __VA_ARGS__)
 
 // ============================================
 // Type Conversion Helpers
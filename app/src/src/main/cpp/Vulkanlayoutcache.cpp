@@ -0,0 +1,408 @@
+//
+// Pipeline layouts built from SPIR-V reflection, deduplicated per device.
+//
+#include "Vulkanjni.h"
+#include "Vulkanlayoutcache.h"
+#include "Vulkanbindless.h"
+#include "Vulkanpipelineregistry.h"
+#include "Vulkansamplers.h"
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace VulkanJNI;
+
+struct LayoutCache {
+    std::mutex mutex;
+    std::unordered_map<std::string, std::unique_ptr<ReflectedLayout>> layouts;  // 签名 → layout
+    uint32_t hits = 0;
+    uint32_t misses = 0;
+};
+
+namespace {
+
+    LayoutCache* getCache(DeviceInfo* deviceInfo) {
+        return deviceInfo ? deviceInfo->layoutCache : nullptr;
+    }
+
+    void appendU32(std::string* key, uint32_t value) {
+        key->append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    // push set 最多使用的描述符数（maxPushDescriptors 保证的下限）
+    constexpr uint32_t kMaxPushDescriptors = 32;
+
+    void appendU64(std::string* key, uint64_t value) {
+        key->append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    const ImmutableSamplerBinding* findImmutableSampler(const std::vector<ImmutableSamplerBinding>& samplers,
+                                                        uint32_t set, uint32_t binding) {
+        for (const ImmutableSamplerBinding& entry : samplers) {
+            if (entry.set == set && entry.binding == binding) return &entry;
+        }
+        return nullptr;
+    }
+
+    // bindings 已按 (set, binding) 排序，签名与声明顺序、变量名无关；
+    // immutable sampler 按反射顺序逐个 binding 写入，与调用方传入的顺序无关
+    std::string signature(const ShaderReflection& reflection, int32_t pushDescriptorSet,
+                          const std::vector<ImmutableSamplerBinding>& immutableSamplers) {
+        std::string key;
+        appendU32(&key, static_cast<uint32_t>(reflection.bindings.size()));
+        for (const ReflectedBinding& binding : reflection.bindings) {
+            appendU32(&key, binding.set);
+            appendU32(&key, binding.binding);
+            appendU32(&key, binding.type);
+            appendU32(&key, binding.count);
+            appendU32(&key, binding.stages);
+            const ImmutableSamplerBinding* immutable =
+                    findImmutableSampler(immutableSamplers, binding.set, binding.binding);
+            appendU64(&key, immutable ? static_cast<uint64_t>(toHandle(immutable->sampler)) : 0);
+        }
+        appendU32(&key, reflection.pushConstantStages);
+        appendU32(&key, reflection.pushConstantSize);
+        appendU32(&key, static_cast<uint32_t>(pushDescriptorSet));
+        return key;
+    }
+
+    // 设备启用了 push descriptor、set 存在且不含动态缓冲、描述符总数在保证的上限内时才能作为 push set
+    int32_t resolvePushDescriptorSet(const DeviceInfo* deviceInfo, const ShaderReflection& reflection,
+                                     int32_t requested) {
+        if (requested < 0 || !deviceInfo->pushDescriptors) return -1;
+
+        uint32_t descriptorCount = 0;
+        for (const ReflectedBinding& binding : reflection.bindings) {
+            if (binding.set != static_cast<uint32_t>(requested)) continue;
+            if (binding.type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC ||
+                binding.type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC) {
+                return -1;
+            }
+            descriptorCount += binding.count;
+        }
+        return descriptorCount > 0 && descriptorCount <= kMaxPushDescriptors ? requested : -1;
+    }
+
+    // 运行时大小的数组所在的 set 只能是 bindless 表：set 内唯一的 binding 0、COMBINED_IMAGE_SAMPLER。
+    // 返回该 set 号；没有运行时数组时返回 -1，形式不符或设备没有表时返回 -2
+    int32_t resolveBindlessSet(DeviceInfo* deviceInfo, const ShaderReflection& reflection) {
+        int32_t bindlessSet = -1;
+        for (const ReflectedBinding& binding : reflection.bindings) {
+            if (binding.count != 0) continue;
+            if (bindlessSet >= 0 || binding.binding != 0 ||
+                binding.type != VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER) {
+                LOGE("Reflected layout: runtime-sized array at set %u binding %u is not supported",
+                     binding.set, binding.binding);
+                return -2;
+            }
+            bindlessSet = static_cast<int32_t>(binding.set);
+        }
+        if (bindlessSet < 0) return -1;
+
+        for (const ReflectedBinding& binding : reflection.bindings) {
+            if (binding.set == static_cast<uint32_t>(bindlessSet) && binding.count != 0) {
+                LOGE("Reflected layout: bindless set %d must contain only the texture array", bindlessSet);
+                return -2;
+            }
+        }
+        if (bindlessSetLayout(deviceInfo) == VK_NULL_HANDLE) {
+            LOGE("Reflected layout: set %d needs descriptor indexing, which the device does not support",
+                 bindlessSet);
+            return -2;
+        }
+        return bindlessSet;
+    }
+
+    // 每个 immutable sampler 必须落在单个 sampler 类 binding 上，且来自 sampler 缓存（保留到设备销毁）
+    bool validateImmutableSamplers(DeviceInfo* deviceInfo, const ShaderReflection& reflection,
+                                   const std::vector<ImmutableSamplerBinding>& immutableSamplers) {
+        for (const ImmutableSamplerBinding& entry : immutableSamplers) {
+            const ReflectedBinding* target = nullptr;
+            for (const ReflectedBinding& binding : reflection.bindings) {
+                if (binding.set == entry.set && binding.binding == entry.binding) target = &binding;
+            }
+            if (!target) {
+                LOGE("Reflected layout: immutable sampler for unused set %u binding %u", entry.set, entry.binding);
+                return false;
+            }
+            if ((target->type != VK_DESCRIPTOR_TYPE_SAMPLER &&
+                 target->type != VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER) || target->count != 1) {
+                LOGE("Reflected layout: set %u binding %u cannot take an immutable sampler", entry.set, entry.binding);
+                return false;
+            }
+            std::string samplerKey;
+            if (!getSamplerKey(deviceInfo, entry.sampler, &samplerKey)) {
+                LOGE("Reflected layout: immutable sampler %p is not from the sampler cache", (void*)entry.sampler);
+                return false;
+            }
+            if (findImmutableSampler(immutableSamplers, entry.set, entry.binding) != &entry) {
+                LOGE("Reflected layout: duplicate immutable sampler for set %u binding %u", entry.set, entry.binding);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void destroyLayout(DeviceInfo* deviceInfo, ReflectedLayout* layout) {
+        if (layout->pipelineLayout != VK_NULL_HANDLE) {
+            unregisterPipelineLayout(deviceInfo, layout->pipelineLayout);
+            vkDestroyPipelineLayout(deviceInfo->device, layout->pipelineLayout, nullptr);
+        }
+        for (uint32_t set = 0; set < layout->setLayouts.size(); set++) {
+            VkDescriptorSetLayout setLayout = layout->setLayouts[set];
+            // bindless 表的 layout 归表所有
+            if (setLayout == VK_NULL_HANDLE || static_cast<int32_t>(set) == layout->bindlessSet) continue;
+            unregisterDescriptorSetLayout(deviceInfo, setLayout);
+            vkDestroyDescriptorSetLayout(deviceInfo->device, setLayout, nullptr);
+        }
+    }
+
+    bool createLayout(DeviceInfo* deviceInfo, const ShaderReflection& reflection, int32_t pushDescriptorSet,
+                      int32_t bindlessSet, const std::vector<ImmutableSamplerBinding>& immutableSamplers,
+                      ReflectedLayout* layout) {
+        uint32_t setCount = 0;
+        for (const ReflectedBinding& binding : reflection.bindings) {
+            setCount = std::max(setCount, binding.set + 1);
+        }
+
+        layout->setLayouts.assign(setCount, VK_NULL_HANDLE);
+        layout->bindlessSet = bindlessSet;
+        for (uint32_t set = 0; set < setCount; set++) {
+            if (static_cast<int32_t>(set) == bindlessSet) {
+                layout->setLayouts[set] = bindlessSetLayout(deviceInfo);
+                continue;
+            }
+            std::vector<VkDescriptorSetLayoutBinding> bindings;
+            for (const ReflectedBinding& reflected : reflection.bindings) {
+                if (reflected.set != set) continue;
+                VkDescriptorSetLayoutBinding binding{};
+                binding.binding = reflected.binding;
+                binding.descriptorType = reflected.type;
+                binding.descriptorCount = reflected.count;
+                binding.stageFlags = reflected.stages;
+                const ImmutableSamplerBinding* immutable =
+                        findImmutableSampler(immutableSamplers, reflected.set, reflected.binding);
+                if (immutable) binding.pImmutableSamplers = &immutable->sampler;
+                bindings.push_back(binding);
+            }
+
+            VkDescriptorSetLayoutCreateInfo layoutInfo{};
+            layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+            if (static_cast<int32_t>(set) == pushDescriptorSet) {
+                layoutInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR;
+            }
+            layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+            layoutInfo.pBindings = bindings.data();
+
+            VkResult result = vkCreateDescriptorSetLayout(deviceInfo->device, &layoutInfo, nullptr,
+                                                          &layout->setLayouts[set]);
+            if (!validateResult(result, "vkCreateDescriptorSetLayout")) {
+                layout->setLayouts[set] = VK_NULL_HANDLE;
+                return false;
+            }
+            registerDescriptorSetLayout(deviceInfo, layout->setLayouts[set], &layoutInfo);
+        }
+
+        VkPushConstantRange pushConstantRange{};
+        pushConstantRange.stageFlags = reflection.pushConstantStages;
+        pushConstantRange.offset = 0;
+        pushConstantRange.size = reflection.pushConstantSize;
+
+        VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+        pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipelineLayoutInfo.setLayoutCount = setCount;
+        pipelineLayoutInfo.pSetLayouts = layout->setLayouts.data();
+        pipelineLayoutInfo.pushConstantRangeCount = reflection.pushConstantSize > 0 ? 1 : 0;
+        pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+
+        VkResult result = vkCreatePipelineLayout(deviceInfo->device, &pipelineLayoutInfo, nullptr,
+                                                 &layout->pipelineLayout);
+        if (!validateResult(result, "vkCreatePipelineLayout")) {
+            layout->pipelineLayout = VK_NULL_HANDLE;
+            return false;
+        }
+        registerPipelineLayout(deviceInfo, layout->pipelineLayout, &pipelineLayoutInfo);
+
+        layout->pushConstantStages = reflection.pushConstantStages;
+        layout->pushConstantSize = reflection.pushConstantSize;
+        layout->pushDescriptorSet = pushDescriptorSet;
+        return true;
+    }
+
+} // anonymous namespace
+
+// ============================================
+// Lifetime
+// ============================================
+void createLayoutCache(DeviceInfo* deviceInfo) {
+    if (deviceInfo->layoutCache == nullptr) {
+        deviceInfo->layoutCache = new LayoutCache();
+    }
+}
+
+void destroyLayoutCache(DeviceInfo* deviceInfo) {
+    LayoutCache* cache = getCache(deviceInfo);
+    if (!cache) return;
+
+    uint32_t referenced = 0;
+    for (auto& entry : cache->layouts) {
+        if (entry.second->refCount > 0) referenced++;
+        destroyLayout(deviceInfo, entry.second.get());
+    }
+    LOGI("Layout cache: %zu layouts, %u hits, %u misses", cache->layouts.size(), cache->hits, cache->misses);
+    if (referenced > 0) {
+        LOGE("Layout cache: %u layouts still referenced at device destruction", referenced);
+    }
+
+    delete cache;
+    deviceInfo->layoutCache = nullptr;
+}
+
+// ============================================
+// Layouts
+// ============================================
+ReflectedLayout* acquireReflectedLayout(DeviceInfo* deviceInfo, const ShaderReflection& reflection,
+                                        int32_t pushDescriptorSet,
+                                        const std::vector<ImmutableSamplerBinding>& immutableSamplers) {
+    LayoutCache* cache = getCache(deviceInfo);
+    if (!cache) return nullptr;
+
+    const int32_t bindlessSet = resolveBindlessSet(deviceInfo, reflection);
+    if (bindlessSet == -2) return nullptr;
+
+    if (!validateImmutableSamplers(deviceInfo, reflection, immutableSamplers)) return nullptr;
+
+    pushDescriptorSet = resolvePushDescriptorSet(deviceInfo, reflection, pushDescriptorSet);
+    std::string key = signature(reflection, pushDescriptorSet, immutableSamplers);
+    std::lock_guard<std::mutex> lock(cache->mutex);
+
+    auto it = cache->layouts.find(key);
+    if (it != cache->layouts.end()) {
+        cache->hits++;
+        it->second->refCount++;
+        LOGI("Layout cache hit: %p (refs=%u)", (void*)it->second->pipelineLayout, it->second->refCount);
+        return it->second.get();
+    }
+
+    std::unique_ptr<ReflectedLayout> layout(new ReflectedLayout());
+    if (!createLayout(deviceInfo, reflection, pushDescriptorSet, bindlessSet, immutableSamplers, layout.get())) {
+        destroyLayout(deviceInfo, layout.get());
+        return nullptr;
+    }
+
+    cache->misses++;
+    layout->refCount = 1;
+    LOGI("✓ Reflected layout created: %zu sets, %zu bindings, push constants %u bytes (stages 0x%x), push set %d, "
+         "%zu immutable samplers, bindless set %d",
+         layout->setLayouts.size(), reflection.bindings.size(),
+         layout->pushConstantSize, layout->pushConstantStages, layout->pushDescriptorSet, immutableSamplers.size(),
+         layout->bindlessSet);
+
+    ReflectedLayout* result = layout.get();
+    cache->layouts.emplace(std::move(key), std::move(layout));
+    return result;
+}
+
+void releaseReflectedLayout(DeviceInfo* deviceInfo, ReflectedLayout* layout) {
+    LayoutCache* cache = getCache(deviceInfo);
+    if (!cache || !layout) return;
+
+    std::lock_guard<std::mutex> lock(cache->mutex);
+    // 引用计数归零也保留，销毁设备时统一释放
+    if (layout->refCount > 0) layout->refCount--;
+}
+
+// ============================================
+// JNI: ReflectedLayout
+// ============================================
+
+// immutableSamplers：按 (set, binding, sampler) 三个一组展开，可为 null
+// 返回 [layout, pipelineLayout, pushConstantStages, pushConstantSize,
+//       setCount, setLayout0, ..., specCount, id0, default0, ..., pushDescriptorSet, bindlessSet]；失败返回 null
+extern "C" JNIEXPORT jlongArray JNICALL
+Java_com_genymobile_scrcpy_vulkan_ReflectedLayout_nativeAcquire(
+        JNIEnv* env, jobject /* this */,
+        jlong deviceHandle,
+        jobjectArray spirvModules,
+        jint pushDescriptorSet,
+        jlongArray immutableSamplers) {
+
+    DeviceInfo* deviceInfo = getDeviceInfo(deviceHandle);
+    if (!validateHandle(deviceInfo, "device") || spirvModules == nullptr) {
+        return nullptr;
+    }
+
+    ShaderReflection merged;
+    const jsize moduleCount = env->GetArrayLength(spirvModules);
+    for (jsize i = 0; i < moduleCount; i++) {
+        auto code = static_cast<jbyteArray>(env->GetObjectArrayElement(spirvModules, i));
+        if (code == nullptr) continue;
+
+        // SPIR-V 按 32 位字解析，复制到对齐的缓冲区
+        const jsize codeSize = env->GetArrayLength(code);
+        std::vector<uint32_t> words((codeSize + 3) / 4, 0);
+        env->GetByteArrayRegion(code, 0, codeSize, reinterpret_cast<jbyte*>(words.data()));
+        env->DeleteLocalRef(code);
+
+        ShaderReflection reflection;
+        if (!reflectSpirv(words.data(), static_cast<size_t>(codeSize), &reflection) ||
+            !mergeReflection(&merged, reflection)) {
+            LOGE("SPIR-V reflection failed for module %d", i);
+            return nullptr;
+        }
+    }
+
+    std::vector<ImmutableSamplerBinding> samplers;
+    if (immutableSamplers != nullptr) {
+        const jsize count = env->GetArrayLength(immutableSamplers);
+        std::vector<jlong> triples(static_cast<size_t>(count));
+        env->GetLongArrayRegion(immutableSamplers, 0, count, triples.data());
+        for (jsize i = 0; i + 2 < count; i += 3) {
+            ImmutableSamplerBinding entry;
+            entry.set = static_cast<uint32_t>(triples[i]);
+            entry.binding = static_cast<uint32_t>(triples[i + 1]);
+            entry.sampler = fromHandle<VkSampler>(triples[i + 2]);
+            samplers.push_back(entry);
+        }
+    }
+
+    ReflectedLayout* layout = acquireReflectedLayout(deviceInfo, merged, pushDescriptorSet, samplers);
+    if (!layout) return nullptr;
+
+    std::vector<jlong> values;
+    values.push_back(reinterpret_cast<jlong>(layout));
+    values.push_back(toHandle(layout->pipelineLayout));
+    values.push_back(layout->pushConstantStages);
+    values.push_back(layout->pushConstantSize);
+    values.push_back(static_cast<jlong>(layout->setLayouts.size()));
+    for (VkDescriptorSetLayout setLayout : layout->setLayouts) {
+        values.push_back(toHandle(setLayout));
+    }
+    values.push_back(static_cast<jlong>(merged.specConstants.size()));
+    for (const ReflectedSpecConstant& constant : merged.specConstants) {
+        values.push_back(constant.id);
+        values.push_back(constant.defaultValue);
+    }
+    values.push_back(layout->pushDescriptorSet);
+    values.push_back(layout->bindlessSet);
+
+    jlongArray result = env->NewLongArray(static_cast<jsize>(values.size()));
+    if (result) {
+        env->SetLongArrayRegion(result, 0, static_cast<jsize>(values.size()), values.data());
+    }
+    return result;
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_genymobile_scrcpy_vulkan_ReflectedLayout_nativeRelease(
+        JNIEnv* env, jobject /* this */, jlong deviceHandle, jlong layoutHandle) {
+
+    DeviceInfo* deviceInfo = getDeviceInfo(deviceHandle);
+    auto* layout = reinterpret_cast<ReflectedLayout*>(layoutHandle);
+    if (validateHandle(deviceInfo, "device") && layout) {
+        releaseReflectedLayout(deviceInfo, layout);
+    }
+}
@@ -0,0 +1,61 @@
+//
+// Pipeline layouts built from SPIR-V reflection, deduplicated per device.
+//
+// 滤镜不再手写 descriptor set layout / push constant 范围：把各 stage 的 SPIR-V 交给
+// acquireReflectedLayout，按反射出的接口（binding、描述符类型、数量、stage、push constant 范围）
+// 组成签名查找或创建。接口相同的滤镜拿到同一个 VkPipelineLayout，切换 pipeline 时已绑定的
+// descriptor set 和 push constant 仍然有效。
+//
+// 创建的 layout 会登记到 pipeline registry。引用计数归零后保留到设备销毁。
+//
+// pushDescriptorSet 指定的 set 在设备启用 VK_KHR_push_descriptor 时以 PUSH_DESCRIPTOR 标志创建
+// （见 Vulkandescriptors.h）；不支持时照常创建，ReflectedLayout::pushDescriptorSet 为 -1。
+//
+// immutableSamplers 把 sampler 固化进 set layout（sampler 固定不变的滤镜）：写描述符时不再需要 sampler，
+// 驱动可以把采样状态编进 shader。只接受 sampler 缓存中的 sampler（见 Vulkansamplers.h），
+// 它们保留到设备销毁，所以签名可以按句柄比较。
+//
+// 运行时大小的数组只接受 bindless 表的形式：set 内唯一的 binding 0、COMBINED_IMAGE_SAMPLER，
+// 且设备建有 bindless 表（见 Vulkanbindless.h）。该 set 直接使用表的 layout，ReflectedLayout::bindlessSet
+// 记录 set 号；表的 layout 归表所有，不随 layout 缓存销毁。
+//
+#ifndef VULKAN_LAYOUT_CACHE_H
+#define VULKAN_LAYOUT_CACHE_H
+
+#include <vulkan/vulkan.h>
+#include <vector>
+#include "Vulkantypes.h"
+#include "Vulkanreflection.h"
+
+struct ReflectedLayout {
+    std::vector<VkDescriptorSetLayout> setLayouts;  // 下标即 set 号；没有 binding 的 set 为空 layout
+    VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+    VkShaderStageFlags pushConstantStages = 0;      // vkCmdPushConstants 必须使用这组 stage
+    uint32_t pushConstantSize = 0;
+    int32_t pushDescriptorSet = -1;                 // 以 push descriptor 方式更新的 set，没有时为 -1
+    int32_t bindlessSet = -1;                       // 使用 bindless 表 layout 的 set，没有时为 -1
+    uint32_t refCount = 0;
+};
+
+// (set, binding) 上固化的 sampler；该 binding 必须是单个 SAMPLER 或 COMBINED_IMAGE_SAMPLER
+struct ImmutableSamplerBinding {
+    uint32_t set = 0;
+    uint32_t binding = 0;
+    VkSampler sampler = VK_NULL_HANDLE;
+};
+
+// 创建设备后调用
+void createLayoutCache(DeviceInfo* deviceInfo);
+
+// 销毁所有 layout；在 destroyPipelineRegistry 之前调用
+void destroyLayoutCache(DeviceInfo* deviceInfo);
+
+// 查找或创建与反射接口一致的 layout，引用计数 +1；失败返回 nullptr。
+// pushDescriptorSet >= 0 时尽量把该 set 创建为 push set
+ReflectedLayout* acquireReflectedLayout(DeviceInfo* deviceInfo, const ShaderReflection& reflection,
+                                        int32_t pushDescriptorSet = -1,
+                                        const std::vector<ImmutableSamplerBinding>& immutableSamplers = {});
+
+void releaseReflectedLayout(DeviceInfo* deviceInfo, ReflectedLayout* layout);
+
+#endif // VULKAN_LAYOUT_CACHE_H
@@ -0,0 +1,368 @@
+//
+// Asynchronous, rate-limited native logging.
+//
+#include "Vulkanlog.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <condition_variable>
+#include <cstdio>
+#include <ctime>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <pthread.h>
+
+#ifdef __ANDROID__
+#include <android/log.h>
+#endif
+
+namespace {
+
+    constexpr uint64_t kRateWindowNs = 1000000000ull;
+    constexpr auto kDrainInterval = std::chrono::milliseconds(20);
+
+    // 单生产者（所属线程）/ 单消费者（持有 drainMutex 的线程）
+    struct LogRing {
+        LogRecord records[kLogRingRecords];
+        std::atomic<uint32_t> head{0};   // 生产者写入
+        std::atomic<uint32_t> tail{0};   // 消费者写入
+        std::atomic<bool> closed{false}; // 所属线程已退出，排空后释放
+    };
+
+    // 从不析构：进程退出时后台线程可能仍在等待，静态对象析构后不能再被它访问
+    struct LogState {
+        std::mutex registryMutex;
+        std::vector<LogRing*> rings;
+
+        std::mutex drainMutex;
+        std::condition_variable drainWake;
+        std::once_flag drainStarted;
+        std::atomic<uint64_t> droppedRecords{0};
+        uint64_t reportedDrops = 0;  // drainMutex
+
+        FILE* logFile = nullptr;     // drainMutex；nullptr 为 stderr
+    };
+
+    LogState& state() {
+        static LogState* logState = new LogState();
+        return *logState;
+    }
+
+    // 线程退出时把缓冲交给后台线程释放
+    struct RingOwner {
+        LogRing* ring = nullptr;
+        ~RingOwner() {
+            if (ring) ring->closed.store(true, std::memory_order_release);
+        }
+    };
+    thread_local RingOwner threadRing;
+
+    uint64_t coarseNowNs() {
+        timespec now{};
+#ifdef CLOCK_MONOTONIC_COARSE
+        clock_gettime(CLOCK_MONOTONIC_COARSE, &now);
+#else
+        clock_gettime(CLOCK_MONOTONIC, &now);
+#endif
+        return static_cast<uint64_t>(now.tv_sec) * 1000000000ull + static_cast<uint64_t>(now.tv_nsec);
+    }
+
+    void drainOnce();
+
+    void drainLoop() {
+        pthread_setname_np(pthread_self(), "vk-log");
+        LogState& log = state();
+        std::unique_lock<std::mutex> lock(log.drainMutex);
+        for (;;) {
+            log.drainWake.wait_for(lock, kDrainInterval);
+            drainOnce();
+        }
+    }
+
+    void startDrainThread() {
+        std::call_once(state().drainStarted, [] {
+            std::thread(drainLoop).detach();
+            // 正常退出时写出还在缓冲里的日志
+            std::atexit(flushLog);
+        });
+    }
+
+    LogRing* currentRing() {
+        if (!threadRing.ring) {
+            startDrainThread();
+            auto* ring = new LogRing();
+            LogState& log = state();
+            std::lock_guard<std::mutex> lock(log.registryMutex);
+            log.rings.push_back(ring);
+            threadRing.ring = ring;
+        }
+        return threadRing.ring;
+    }
+
+    // ============================================
+    // 格式化（后台线程）
+    // ============================================
+    bool isFlag(char c) {
+        return c == '-' || c == '+' || c == ' ' || c == '#' || c == '0' || c == '.' || (c >= '0' && c <= '9');
+    }
+
+    bool isLengthModifier(char c) {
+        return c == 'h' || c == 'l' || c == 'j' || c == 'z' || c == 't' || c == 'L' || c == 'q';
+    }
+
+    // 按记录里的实际类型重建一个转换说明并格式化
+    void appendArg(std::string* out, const LogRecord& record, const std::string& flags, char conversion,
+                   const LogArg& arg) {
+        char buffer[256];
+        std::string spec = "%" + flags;
+        int written = 0;
+        switch (conversion) {
+            case 'd':
+            case 'i': {
+                const long long value = arg.type == LOG_ARG_UINT ? static_cast<long long>(arg.u) :
+                                        arg.type == LOG_ARG_DOUBLE ? static_cast<long long>(arg.d) :
+                                        arg.type == LOG_ARG_POINTER ? static_cast<long long>(reinterpret_cast<intptr_t>(arg.p)) :
+                                        static_cast<long long>(arg.i);
+                spec += "ll";
+                spec += conversion;
+                written = snprintf(buffer, sizeof(buffer), spec.c_str(), value);
+                break;
+            }
+            case 'u':
+            case 'x':
+            case 'X':
+            case 'o': {
+                const unsigned long long value =
+                        arg.type == LOG_ARG_INT ? static_cast<unsigned long long>(arg.i) :
+                        arg.type == LOG_ARG_DOUBLE ? static_cast<unsigned long long>(arg.d) :
+                        arg.type == LOG_ARG_POINTER ? static_cast<unsigned long long>(reinterpret_cast<uintptr_t>(arg.p)) :
+                        static_cast<unsigned long long>(arg.u);
+                spec += "ll";
+                spec += conversion;
+                written = snprintf(buffer, sizeof(buffer), spec.c_str(), value);
+                break;
+            }
+            case 'c':
+                spec += 'c';
+                written = snprintf(buffer, sizeof(buffer), spec.c_str(),
+                                   static_cast<int>(arg.type == LOG_ARG_UINT ? arg.u : arg.i));
+                break;
+            case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A': {
+                const double value = arg.type == LOG_ARG_INT ? static_cast<double>(arg.i) :
+                                     arg.type == LOG_ARG_UINT ? static_cast<double>(arg.u) : arg.d;
+                spec += conversion;
+                written = snprintf(buffer, sizeof(buffer), spec.c_str(), value);
+                break;
+            }
+            case 's':
+                spec += 's';
+                written = snprintf(buffer, sizeof(buffer), spec.c_str(),
+                                   arg.type == LOG_ARG_STRING ? record.strings + arg.offset : "(?)");
+                break;
+            case 'p':
+                spec += 'p';
+                written = snprintf(buffer, sizeof(buffer), spec.c_str(),
+                                   arg.type == LOG_ARG_POINTER ? arg.p :
+                                   reinterpret_cast<const void*>(static_cast<uintptr_t>(arg.u)));
+                break;
+            default:
+                out->append("%").append(flags).push_back(conversion);
+                return;
+        }
+        if (written > 0) {
+            out->append(buffer, std::min<size_t>(static_cast<size_t>(written), sizeof(buffer) - 1));
+        }
+    }
+
+    std::string formatRecord(const LogRecord& record) {
+        std::string out;
+        uint32_t argIndex = 0;
+        for (const char* c = record.format; *c; c++) {
+            if (*c != '%') {
+                out.push_back(*c);
+                continue;
+            }
+            if (c[1] == '%') {
+                out.push_back('%');
+                c++;
+                continue;
+            }
+
+            std::string flags;
+            const char* p = c + 1;
+            while (*p && isFlag(*p)) flags.push_back(*p++);
+            while (*p && isLengthModifier(*p)) p++;  // 长度由记录里的类型决定
+            if (!*p) {
+                out.append(c);
+                break;
+            }
+            if (argIndex < record.argCount) {
+                appendArg(&out, record, flags, *p, record.args[argIndex++]);
+            } else {
+                out.append(c, p + 1);
+            }
+            c = p;
+        }
+        if (record.suppressed > 0) {
+            out += " (" + std::to_string(record.suppressed) + " similar messages suppressed)";
+        }
+        return out;
+    }
+
+    // ============================================
+    // 后端
+    // ============================================
+    void writeLine(int level, const char* tag, uint64_t timeNs, const char* text) {
+#ifdef __ANDROID__
+        static const int priorities[] = {
+                ANDROID_LOG_VERBOSE, ANDROID_LOG_DEBUG, ANDROID_LOG_INFO, ANDROID_LOG_WARN, ANDROID_LOG_ERROR
+        };
+        (void) timeNs;
+        __android_log_write(priorities[level <= VULKAN_LOG_LEVEL_ERROR ? level : VULKAN_LOG_LEVEL_ERROR], tag, text);
+#else
+        static const char levels[] = "VDIWE";
+        FILE* out = state().logFile ? state().logFile : stderr;
+        fprintf(out, "%llu.%06llu %c/%s: %s\n",
+                static_cast<unsigned long long>(timeNs / 1000000000ull),
+                static_cast<unsigned long long>(timeNs / 1000ull % 1000000ull),
+                levels[level <= VULKAN_LOG_LEVEL_ERROR ? level : VULKAN_LOG_LEVEL_ERROR], tag, text);
+#endif
+    }
+
+    void flushBackend() {
+#ifndef __ANDROID__
+        fflush(state().logFile ? state().logFile : stderr);
+#endif
+    }
+
+    // 调用方持有 drainMutex
+    void drainOnce() {
+        LogState& log = state();
+        std::vector<LogRing*> snapshot;
+        {
+            std::lock_guard<std::mutex> lock(log.registryMutex);
+            snapshot = log.rings;
+        }
+
+        bool wrote = false;
+        for (LogRing* ring : snapshot) {
+            // 先读 closed：之后 head 不会再变，排空后可以释放
+            const bool closed = ring->closed.load(std::memory_order_acquire);
+            uint32_t tail = ring->tail.load(std::memory_order_relaxed);
+            const uint32_t head = ring->head.load(std::memory_order_acquire);
+            for (; tail != head; tail++) {
+                const LogRecord& record = ring->records[tail % kLogRingRecords];
+                writeLine(record.level, record.tag, record.timeNs, formatRecord(record).c_str());
+                wrote = true;
+            }
+            ring->tail.store(tail, std::memory_order_release);
+
+            if (closed) {
+                std::lock_guard<std::mutex> lock(log.registryMutex);
+                log.rings.erase(std::find(log.rings.begin(), log.rings.end(), ring));
+                delete ring;
+            }
+        }
+
+        const uint64_t dropped = log.droppedRecords.load(std::memory_order_relaxed);
+        if (dropped != log.reportedDrops) {
+            const std::string text = std::to_string(dropped - log.reportedDrops) + " log records dropped (buffer full)";
+            writeLine(VULKAN_LOG_LEVEL_WARN, "VulkanLog", coarseNowNs(), text.c_str());
+            log.reportedDrops = dropped;
+            wrote = true;
+        }
+        if (wrote) flushBackend();
+    }
+
+} // anonymous namespace
+
+// ============================================
+// 调用线程
+// ============================================
+LogRecord* beginLogRecord(LogSite* site, int level, const char* tag, const char* format) {
+    const uint64_t now = coarseNowNs();
+
+    // 限流：窗口过期时由抢到 CAS 的线程开启新窗口，并把上一个窗口的丢弃数带到这条日志上
+    uint32_t suppressed = 0;
+    uint64_t windowStart = site->windowStartNs.load(std::memory_order_relaxed);
+    if (now - windowStart >= kRateWindowNs &&
+        site->windowStartNs.compare_exchange_strong(windowStart, now, std::memory_order_relaxed)) {
+        site->count.store(0, std::memory_order_relaxed);
+        suppressed = site->suppressed.exchange(0, std::memory_order_relaxed);
+    }
+    if (site->count.fetch_add(1, std::memory_order_relaxed) >= kLogBurstPerSite) {
+        site->suppressed.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    LogRing* ring = currentRing();
+    const uint32_t head = ring->head.load(std::memory_order_relaxed);
+    if (level >= VULKAN_LOG_LEVEL_ERROR && head - ring->tail.load(std::memory_order_acquire) >= kLogRingRecords) {
+        // 错误不因缓冲满丢弃：先同步排空
+        flushLog();
+    }
+    if (head - ring->tail.load(std::memory_order_acquire) >= kLogRingRecords) {
+        state().droppedRecords.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    LogRecord* record = &ring->records[head % kLogRingRecords];
+    record->format = format;
+    record->tag = tag;
+    record->timeNs = now;
+    record->suppressed = suppressed;
+    record->level = static_cast<uint8_t>(level);
+    record->argCount = 0;
+    record->stringBytes = 0;
+    return record;
+}
+
+void commitLogRecord(LogRecord* record) {
+    LogRing* ring = threadRing.ring;
+    ring->head.store(ring->head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+
+    // 错误在调用线程上同步写出（连同之前缓冲的日志）：错误之后常常紧跟 abort，
+    // 等后台线程写就会丢掉最需要的那几行。错误本身受限流约束，不会拖慢正常路径
+    if (record->level >= VULKAN_LOG_LEVEL_ERROR) {
+        flushLog();
+        return;
+    }
+
+    // 缓冲过半时立即唤醒（不持锁通知；错过的唤醒最多延迟一个 kDrainInterval）
+    const uint32_t used = ring->head.load(std::memory_order_relaxed) - ring->tail.load(std::memory_order_relaxed);
+    if (used >= kLogRingRecords / 2) {
+        state().drainWake.notify_one();
+    }
+}
+
+// ============================================
+// 后台线程 / 后端
+// ============================================
+void flushLog() {
+    std::lock_guard<std::mutex> lock(state().drainMutex);
+    drainOnce();
+}
+
+bool setLogFile(const char* path) {
+#ifdef __ANDROID__
+    (void) path;
+    return false;
+#else
+    LogState& log = state();
+    std::lock_guard<std::mutex> lock(log.drainMutex);
+    drainOnce();
+    if (log.logFile) {
+        fclose(log.logFile);
+        log.logFile = nullptr;
+    }
+    if (!path) return true;
+    log.logFile = fopen(path, "a");
+    return log.logFile != nullptr;
+#endif
+}
+
+uint64_t droppedLogRecords() {
+    return state().droppedRecords.load(std::memory_order_relaxed);
+}
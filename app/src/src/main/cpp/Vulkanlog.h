@@ -0,0 +1,191 @@
+//
+// Asynchronous, rate-limited native logging (LOGI/LOGE/LOGD in Vulkanjni.h map onto VLOGx).
+//
+// 之前 LOGx 直接调用 __android_log_print：每条日志在调用线程上格式化并写 logd socket，渲染路径上
+// （开始 render pass、提交、更新纹理）每帧好几次，在 CPU profile 里很明显。现在：
+// - 编译期按级别裁剪：低于 VULKAN_LOG_MIN_LEVEL 的 VLOGx 展开为空语句（只保留格式检查）
+//   （默认 release 为 INFO，debug 为 DEBUG；可以在编译参数中覆盖）；
+// - 每个调用点单独限流：每秒最多 kLogBurstPerSite 条，多出的只计数，下一条放行的日志附带被丢弃的条数；
+// - 调用线程只记录格式串指针和参数（字符串参数复制到记录里），写入本线程的 SPSC 环形缓冲，
+//   不加锁、不格式化、不做系统调用；后台线程（"vk-log"）按需唤醒，格式化并写出。
+//   缓冲满时丢弃并计数；ERROR 在调用线程上同步写出（连同之前缓冲的日志），随后的 abort 不会丢掉它；
+// - 后端：Android 为 __android_log_write，其他平台（宿主机测试、benchmark）写 stderr 或 setLogFile 指定的文件。
+//
+// 格式串必须是字符串字面量（记录里只保存指针）；参数按 printf 规则，仍由编译器检查。
+// 支持 %d %i %u %x %X %o %c %s %p %f %e %g %a 及其标志/宽度/精度和长度修饰，不支持 * 宽度和 %n。
+//
+#ifndef VULKAN_LOG_H
+#define VULKAN_LOG_H
+
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+
+#define VULKAN_LOG_LEVEL_VERBOSE 0
+#define VULKAN_LOG_LEVEL_DEBUG   1
+#define VULKAN_LOG_LEVEL_INFO    2
+#define VULKAN_LOG_LEVEL_WARN    3
+#define VULKAN_LOG_LEVEL_ERROR   4
+
+#ifndef VULKAN_LOG_MIN_LEVEL
+#ifdef NDEBUG
+#define VULKAN_LOG_MIN_LEVEL VULKAN_LOG_LEVEL_INFO
+#else
+#define VULKAN_LOG_MIN_LEVEL VULKAN_LOG_LEVEL_DEBUG
+#endif
+#endif
+
+constexpr uint32_t kLogBurstPerSite = 32;   // 每个调用点每秒放行的条数
+constexpr uint32_t kLogRingRecords = 128;   // 每个线程的缓冲容量
+constexpr uint32_t kLogMaxArgs = 12;
+constexpr uint32_t kLogStringBytes = 192;   // 每条记录中字符串参数的总字节数（超出截断）
+
+// 调用点的限流状态（宏里的函数内 static）
+struct LogSite {
+    std::atomic<uint64_t> windowStartNs{0};
+    std::atomic<uint32_t> count{0};
+    std::atomic<uint32_t> suppressed{0};
+};
+
+enum LogArgType : uint8_t {
+    LOG_ARG_INT,
+    LOG_ARG_UINT,
+    LOG_ARG_DOUBLE,
+    LOG_ARG_POINTER,
+    LOG_ARG_STRING,
+};
+
+struct LogArg {
+    LogArgType type;
+    union {
+        int64_t i;
+        uint64_t u;
+        double d;
+        const void* p;
+        uint32_t offset;  // LOG_ARG_STRING：在 strings 中的偏移
+    };
+};
+
+struct LogRecord {
+    const char* format = nullptr;
+    const char* tag = nullptr;
+    uint64_t timeNs = 0;
+    uint32_t suppressed = 0;  // 该调用点上一个窗口内被限流丢弃的条数
+    uint8_t level = 0;
+    uint8_t argCount = 0;
+    uint16_t stringBytes = 0;
+    LogArg args[kLogMaxArgs];
+    char strings[kLogStringBytes];
+};
+
+// ============================================
+// 调用线程
+// ============================================
+
+// 限流检查并占用本线程缓冲中的一条记录；返回 nullptr 表示被限流或缓冲已满
+LogRecord* beginLogRecord(LogSite* site, int level, const char* tag, const char* format);
+
+// 提交 beginLogRecord 返回的记录
+void commitLogRecord(LogRecord* record);
+
+inline void captureLogArg(LogRecord* record, const char* value) {
+    LogArg& arg = record->args[record->argCount++];
+    arg.type = LOG_ARG_STRING;
+    arg.offset = record->stringBytes;
+    const char* text = value ? value : "(null)";
+    uint32_t length = 0;
+    while (text[length] && record->stringBytes + length + 1 < kLogStringBytes) length++;
+    for (uint32_t i = 0; i < length; i++) record->strings[record->stringBytes + i] = text[i];
+    // 空间用完时 offset 指向最后一个字节的 '\0'
+    record->strings[record->stringBytes + length] = '\0';
+    if (record->stringBytes + length + 1 < kLogStringBytes) record->stringBytes += length + 1;
+}
+
+inline void captureLogArg(LogRecord* record, char* value) {
+    captureLogArg(record, static_cast<const char*>(value));
+}
+
+template<typename T>
+inline void captureLogArg(LogRecord* record, T value) {
+    LogArg& arg = record->args[record->argCount++];
+    if constexpr (std::is_floating_point_v<T>) {
+        arg.type = LOG_ARG_DOUBLE;
+        arg.d = static_cast<double>(value);
+    } else if constexpr (std::is_pointer_v<T> || std::is_null_pointer_v<T>) {
+        arg.type = LOG_ARG_POINTER;
+        arg.p = reinterpret_cast<const void*>(value);
+    } else if constexpr (std::is_enum_v<T>) {
+        arg.type = LOG_ARG_INT;
+        arg.i = static_cast<int64_t>(value);
+    } else if constexpr (std::is_signed_v<T>) {
+        arg.type = LOG_ARG_INT;
+        arg.i = static_cast<int64_t>(value);
+    } else {
+        static_assert(std::is_integral_v<T>, "Unsupported log argument type");
+        arg.type = LOG_ARG_UINT;
+        arg.u = static_cast<uint64_t>(value);
+    }
+}
+
+// 只用于让编译器按 printf 检查格式串
+inline __attribute__((format(printf, 1, 2))) void checkLogFormat(const char* /* format */, ...) {}
+
+template<typename... Args>
+inline void logMessage(LogSite* site, int level, const char* tag, const char* format, Args... args) {
+    static_assert(sizeof...(Args) <= kLogMaxArgs, "Too many log arguments");
+    LogRecord* record = beginLogRecord(site, level, tag, format);
+    if (!record) return;
+    (captureLogArg(record, args), ...);
+    commitLogRecord(record);
+}
+
+#define VULKAN_LOG(level, tag, ...)                                        \
+    do {                                                                   \
+        if (false) checkLogFormat(__VA_ARGS__);                            \
+        static LogSite vulkanLogSite;                                      \
+        logMessage(&vulkanLogSite, (level), (tag), __VA_ARGS__);           \
+    } while (0)
+
+// 被裁剪的级别：只保留格式检查，不生成代码
+#define VULKAN_LOG_STRIPPED(...) do { if (false) checkLogFormat(__VA_ARGS__); } while (0)
+
+#if VULKAN_LOG_MIN_LEVEL <= VULKAN_LOG_LEVEL_VERBOSE
+#define VLOGV(tag, ...) VULKAN_LOG(VULKAN_LOG_LEVEL_VERBOSE, tag, __VA_ARGS__)
+#else
+#define VLOGV(tag, ...) VULKAN_LOG_STRIPPED(__VA_ARGS__)
+#endif
+
+#if VULKAN_LOG_MIN_LEVEL <= VULKAN_LOG_LEVEL_DEBUG
+#define VLOGD(tag, ...) VULKAN_LOG(VULKAN_LOG_LEVEL_DEBUG, tag, __VA_ARGS__)
+#else
+#define VLOGD(tag, ...) VULKAN_LOG_STRIPPED(__VA_ARGS__)
+#endif
+
+#if VULKAN_LOG_MIN_LEVEL <= VULKAN_LOG_LEVEL_INFO
+#define VLOGI(tag, ...) VULKAN_LOG(VULKAN_LOG_LEVEL_INFO, tag, __VA_ARGS__)
+#else
+#define VLOGI(tag, ...) VULKAN_LOG_STRIPPED(__VA_ARGS__)
+#endif
+
+#if VULKAN_LOG_MIN_LEVEL <= VULKAN_LOG_LEVEL_WARN
+#define VLOGW(tag, ...) VULKAN_LOG(VULKAN_LOG_LEVEL_WARN, tag, __VA_ARGS__)
+#else
+#define VLOGW(tag, ...) VULKAN_LOG_STRIPPED(__VA_ARGS__)
+#endif
+
+#define VLOGE(tag, ...) VULKAN_LOG(VULKAN_LOG_LEVEL_ERROR, tag, __VA_ARGS__)
+
+// ============================================
+// 后台线程 / 后端
+// ============================================
+
+// 立即在调用线程上写出所有线程缓冲中的日志（退出前、测试中调用）
+void flushLog();
+
+// 非 Android 平台：日志写入文件（追加），nullptr 恢复为 stderr；Android 上忽略
+bool setLogFile(const char* path);
+
+// 累计因缓冲满被丢弃的条数
+uint64_t droppedLogRecords();
+
+#endif // VULKAN_LOG_H
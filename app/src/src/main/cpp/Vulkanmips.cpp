@@ -0,0 +1,188 @@
+//
+// Mip chains for the input texture: blit-based generation after each upload, footprint estimate.
+//
+#include "Vulkanjni.h"
+#include "Vulkanmips.h"
+#include "Vulkanbarriers.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace VulkanJNI;
+
+namespace {
+
+    // 纹理缓存按 4x4 纹素块取数（常见移动 GPU 的 tile 布局；RGBA8 时为 64 字节）
+    constexpr uint32_t kCacheBlockSize = 4;
+    constexpr uint32_t kBytesPerTexel = 4;
+
+    // LOD 的小数部分低于此值时只读一级（硬件同样跳过权重为 0 的一级）
+    constexpr float kLodEpsilon = 1.0f / 256.0f;
+
+    VkImageSubresourceRange levelRange(uint32_t level) {
+        VkImageSubresourceRange range{};
+        range.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        range.baseMipLevel = level;
+        range.levelCount = 1;
+        range.baseArrayLayer = 0;
+        range.layerCount = 1;
+        return range;
+    }
+
+    // 单个坐标轴：双线性读取的不同纹素数和它们所在的缓存块数
+    struct AxisFootprint {
+        uint32_t texels = 0;
+        uint32_t blocks = 0;
+    };
+
+    // 输出像素 i 的中心映射到 (i + 0.5) * srcSize / dstSize，读取左右相邻的两个纹素（CLAMP_TO_EDGE）
+    AxisFootprint measureAxis(uint32_t srcSize, uint32_t dstSize) {
+        std::vector<bool> texels(srcSize, false);
+        std::vector<bool> blocks((srcSize + kCacheBlockSize - 1) / kCacheBlockSize, false);
+        const double step = static_cast<double>(srcSize) / dstSize;
+        const int32_t last = static_cast<int32_t>(srcSize) - 1;
+
+        AxisFootprint footprint;
+        for (uint32_t i = 0; i < dstSize; i++) {
+            const int32_t t0 = static_cast<int32_t>(std::floor((i + 0.5) * step - 0.5));
+            for (int32_t t = t0; t <= t0 + 1; t++) {
+                const uint32_t texel = static_cast<uint32_t>(std::clamp(t, 0, last));
+                if (!texels[texel]) {
+                    texels[texel] = true;
+                    footprint.texels++;
+                }
+                const uint32_t block = texel / kCacheBlockSize;
+                if (!blocks[block]) {
+                    blocks[block] = true;
+                    footprint.blocks++;
+                }
+            }
+        }
+        return footprint;
+    }
+
+} // anonymous namespace
+
+// ============================================
+// Mip Generation
+// ============================================
+uint32_t fullMipLevelCount(uint32_t width, uint32_t height) {
+    uint32_t size = std::max(width, height);
+    uint32_t levels = 1;
+    while (size > 1) {
+        size >>= 1;
+        levels++;
+    }
+    return levels;
+}
+
+bool isMipGenerationSupported(DeviceInfo* deviceInfo, VkFormat format) {
+    VkFormatProperties properties{};
+    vkGetPhysicalDeviceFormatProperties(deviceInfo->physicalDevice, format, &properties);
+    const VkFormatFeatureFlags required = VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT |
+                                          VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+    return (properties.optimalTilingFeatures & required) == required;
+}
+
+void recordMipGeneration(DeviceInfo* deviceInfo, VkCommandBuffer commandBuffer,
+                         VkImage image, VkExtent2D extent, uint32_t levels) {
+    ImageBarrierBatch barriers;
+    int32_t width = static_cast<int32_t>(extent.width);
+    int32_t height = static_cast<int32_t>(extent.height);
+
+    for (uint32_t level = 1; level < levels; level++) {
+        // 上一级：写入（上传或上一次 blit）→ 读取；这一级：旧内容整张丢弃
+        const VkImageSubresourceRange srcRange = levelRange(level - 1);
+        const VkImageSubresourceRange dstRange = levelRange(level);
+        requireImageUse(deviceInfo, &barriers, image, srcRange, ImageUses::kBlitSrc);
+        requireImageUse(deviceInfo, &barriers, image, dstRange, ImageUses::kBlitDst, true);
+        flushImageBarriers(deviceInfo, &barriers, commandBuffer);
+
+        const int32_t nextWidth = std::max(width / 2, 1);
+        const int32_t nextHeight = std::max(height / 2, 1);
+
+        VkImageBlit blit{};
+        blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        blit.srcSubresource.mipLevel = level - 1;
+        blit.srcSubresource.baseArrayLayer = 0;
+        blit.srcSubresource.layerCount = 1;
+        blit.srcOffsets[0] = {0, 0, 0};
+        blit.srcOffsets[1] = {width, height, 1};
+        blit.dstSubresource = blit.srcSubresource;
+        blit.dstSubresource.mipLevel = level;
+        blit.dstOffsets[0] = {0, 0, 0};
+        blit.dstOffsets[1] = {nextWidth, nextHeight, 1};
+
+        checkImageCommand(deviceInfo, image, srcRange, ImageUses::kBlitSrc, "vkCmdBlitImage (mip source)");
+        checkImageCommand(deviceInfo, image, dstRange, ImageUses::kBlitDst, "vkCmdBlitImage (mip target)");
+        vkCmdBlitImage(commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                       image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, VK_FILTER_LINEAR);
+
+        width = nextWidth;
+        height = nextHeight;
+    }
+
+    // 前面各级处于 TRANSFER_SRC、最后一级处于 TRANSFER_DST，一批转换到采样布局
+    requireImageUse(deviceInfo, &barriers, image, ImageUses::kSampled);
+    flushImageBarriers(deviceInfo, &barriers, commandBuffer);
+}
+
+// ============================================
+// Footprint Estimate
+// ============================================
+TextureFootprint estimateTextureFootprint(VkExtent2D srcExtent, VkExtent2D dstExtent, uint32_t mipLevels) {
+    TextureFootprint footprint;
+    if (srcExtent.width == 0 || srcExtent.height == 0 || dstExtent.width == 0 || dstExtent.height == 0) {
+        return footprint;
+    }
+
+    // GPU 按纹理坐标导数中较大的一个选择 LOD
+    const double rho = std::max(static_cast<double>(srcExtent.width) / dstExtent.width,
+                                static_cast<double>(srcExtent.height) / dstExtent.height);
+    const float maxLod = static_cast<float>(std::max(mipLevels, 1u) - 1);
+    footprint.lod = std::clamp(static_cast<float>(std::log2(rho)), 0.0f, maxLod);
+
+    const uint32_t baseLevel = static_cast<uint32_t>(footprint.lod);
+    const bool trilinear = footprint.lod - static_cast<float>(baseLevel) > kLodEpsilon &&
+                           baseLevel + 1 < mipLevels;
+
+    double usedTexels = 0.0;
+    double fetchedBlocks = 0.0;
+    for (uint32_t level = baseLevel; level <= baseLevel + (trilinear ? 1u : 0u); level++) {
+        const uint32_t levelWidth = std::max(srcExtent.width >> level, 1u);
+        const uint32_t levelHeight = std::max(srcExtent.height >> level, 1u);
+        const AxisFootprint x = measureAxis(levelWidth, dstExtent.width);
+        const AxisFootprint y = measureAxis(levelHeight, dstExtent.height);
+        usedTexels += static_cast<double>(x.texels) * y.texels;
+        fetchedBlocks += static_cast<double>(x.blocks) * y.blocks;
+    }
+
+    const double blockTexels = kCacheBlockSize * kCacheBlockSize;
+    const double pixels = static_cast<double>(dstExtent.width) * dstExtent.height;
+    footprint.bytesPerPixel = fetchedBlocks * blockTexels * kBytesPerTexel / pixels;
+    footprint.cacheEfficiency = usedTexels / (fetchedBlocks * blockTexels);
+    return footprint;
+}
+
+// ============================================
+// JNI: VulkanRunner
+// ============================================
+
+// 返回 [lod, 每个输出像素取入的字节数, 缓存利用率]；参数无效时返回 null
+extern "C" JNIEXPORT jdoubleArray JNICALL
+Java_com_genymobile_scrcpy_vulkan_VulkanBenchmarks_nativeEstimateTextureFootprint(
+        JNIEnv* env, jobject /* this */,
+        jint srcWidth, jint srcHeight, jint dstWidth, jint dstHeight, jint mipLevels) {
+
+    if (srcWidth <= 0 || srcHeight <= 0 || dstWidth <= 0 || dstHeight <= 0 || mipLevels <= 0) {
+        return nullptr;
+    }
+    const TextureFootprint footprint = estimateTextureFootprint(
+            {static_cast<uint32_t>(srcWidth), static_cast<uint32_t>(srcHeight)},
+            {static_cast<uint32_t>(dstWidth), static_cast<uint32_t>(dstHeight)},
+            static_cast<uint32_t>(mipLevels));
+    const jdouble values[3] = {footprint.lod, footprint.bytesPerPixel, footprint.cacheEfficiency};
+    jdoubleArray array = env->NewDoubleArray(3);
+    env->SetDoubleArrayRegion(array, 0, 3, values);
+    return array;
+}
@@ -0,0 +1,46 @@
+//
+// Mip chains for the input texture: blit-based generation after each upload, footprint estimate.
+//
+// 输入纹理原来只有一级（mipLevels = 1，sampler maxLod = 0）。AffineMatrix 把画面缩小到 1/4 时，
+// 双线性每个输出像素只读相邻的 2x2 个纹素，跨过的其余纹素既没有参与滤波（摩尔纹），又让纹理缓存
+// 每取入一块只用到其中一小部分（带宽浪费）。
+//
+// nativeCreateInputTexture 可以选择带完整 mip 链创建输入纹理：每次上传第 0 级之后，
+// recordMipGeneration 用 vkCmdBlitImage（LINEAR，逐级减半）生成其余各级，每级之间由跟踪器
+// 按子资源范围插入 barrier（上一级 BLIT 写入 → 下一次 BLIT 读取）。完成后整条链处于采样布局。
+// 采样时是否使用 mip 由滤镜决定：只有 maxLod > 0 的 sampler 才会读第 0 级以外的内容
+// （AffineVulkanFilter 在缩小超过 2 倍时换用三线性 sampler），其余滤镜的行为不变。
+//
+// 设备不支持该格式的 blit 或线性过滤时退回单级纹理。
+//
+// 没有可移植的纹理缓存计数器，estimateTextureFootprint 按纹理缓存以 4x4 纹素块（RGBA8 为 64 字节）
+// 为单位从显存取数据、每块只取一次（只计强制缺失）估算每帧的取数量和取入纹素的利用率。
+//
+#ifndef VULKAN_MIPS_H
+#define VULKAN_MIPS_H
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include "Vulkantypes.h"
+
+// 完整 mip 链的级数：floor(log2(max(width, height))) + 1
+uint32_t fullMipLevelCount(uint32_t width, uint32_t height);
+
+// 格式（optimal tiling）是否支持逐级 blit：BLIT_SRC、BLIT_DST 和线性过滤
+bool isMipGenerationSupported(DeviceInfo* deviceInfo, VkFormat format);
+
+// 第 0 级已经写入之后调用（任意跟踪状态），录制第 1 .. levels-1 级的生成；
+// 结束时所有级处于采样布局（ImageUses::kSampled）。levels <= 1 时只做布局转换
+void recordMipGeneration(DeviceInfo* deviceInfo, VkCommandBuffer commandBuffer,
+                         VkImage image, VkExtent2D extent, uint32_t levels);
+
+// 把 srcExtent 的纹理缩放到 dstExtent 时每帧的纹理取数（轴对齐、整张覆盖）。
+// mipLevels 为 1 时是双线性；否则按 GPU 的 LOD 选择（log2(缩小倍数)）三线性读取相邻两级
+struct TextureFootprint {
+    float lod = 0.0f;               // 实际使用的 LOD
+    double bytesPerPixel = 0.0;     // 每个输出像素从显存取入纹理缓存的字节数
+    double cacheEfficiency = 0.0;   // 取入的纹素中被滤波用到的比例（0 .. 1）
+};
+TextureFootprint estimateTextureFootprint(VkExtent2D srcExtent, VkExtent2D dstExtent, uint32_t mipLevels);
+
+#endif // VULKAN_MIPS_H
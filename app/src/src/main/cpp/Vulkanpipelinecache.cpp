@@ -0,0 +1,406 @@
+//
+// Persistent VkPipelineCache shared by all filters of a device.
+//
+#include "Vulkanjni.h"
+#include "Vulkanpipelinecache.h"
+#include "Vulkanpipelinecompiler.h"
+#include "Vulkanshaderstats.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <unistd.h>
+
+using namespace VulkanJNI;
+
+namespace {
+
+    constexpr uint32_t kCacheFileMagic = 0x43504B56;  // "VKPC"
+    constexpr uint32_t kCacheFileVersion = 1;
+
+    // 磁盘文件头，后面紧跟 vkGetPipelineCacheData 返回的数据
+    struct PipelineCacheFileHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t vendorID;
+        uint32_t deviceID;
+        uint32_t driverVersion;
+        uint8_t driverUUID[VK_UUID_SIZE];
+        uint8_t pipelineCacheUUID[VK_UUID_SIZE];
+        uint64_t dataSize;
+        uint64_t checksum;
+    };
+
+    struct DeviceIdentity {
+        uint32_t vendorID = 0;
+        uint32_t deviceID = 0;
+        uint32_t driverVersion = 0;
+        uint8_t driverUUID[VK_UUID_SIZE] = {};
+        uint8_t pipelineCacheUUID[VK_UUID_SIZE] = {};
+    };
+
+    uint64_t fnv1a64(const uint8_t* data, size_t size) {
+        uint64_t hash = 0xcbf29ce484222325ULL;
+        for (size_t i = 0; i < size; i++) {
+            hash ^= data[i];
+            hash *= 0x100000001b3ULL;
+        }
+        return hash;
+    }
+
+    DeviceIdentity queryDeviceIdentity(VkPhysicalDevice physicalDevice) {
+        DeviceIdentity identity;
+
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+        identity.vendorID = properties.vendorID;
+        identity.deviceID = properties.deviceID;
+        identity.driverVersion = properties.driverVersion;
+        memcpy(identity.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE);
+
+        // driverUUID 需要 Vulkan 1.1
+        if (properties.apiVersion >= VK_API_VERSION_1_1) {
+            VkPhysicalDeviceIDProperties idProperties{};
+            idProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ID_PROPERTIES;
+
+            VkPhysicalDeviceProperties2 properties2{};
+            properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+            properties2.pNext = &idProperties;
+            vkGetPhysicalDeviceProperties2(physicalDevice, &properties2);
+            memcpy(identity.driverUUID, idProperties.driverUUID, VK_UUID_SIZE);
+        }
+        return identity;
+    }
+
+    // 校验文件头以及 Vulkan 自身的缓存头（VkPipelineCacheHeaderVersionOne）
+    bool validateCacheFile(const std::vector<uint8_t>& file, const DeviceIdentity& identity) {
+        if (file.size() < sizeof(PipelineCacheFileHeader)) {
+            LOGI("Pipeline cache file too small, ignoring");
+            return false;
+        }
+
+        PipelineCacheFileHeader header;
+        memcpy(&header, file.data(), sizeof(header));
+
+        if (header.magic != kCacheFileMagic || header.version != kCacheFileVersion) {
+            LOGI("Pipeline cache file has unknown format, ignoring");
+            return false;
+        }
+        if (header.vendorID != identity.vendorID ||
+            header.deviceID != identity.deviceID ||
+            header.driverVersion != identity.driverVersion ||
+            memcmp(header.driverUUID, identity.driverUUID, VK_UUID_SIZE) != 0 ||
+            memcmp(header.pipelineCacheUUID, identity.pipelineCacheUUID, VK_UUID_SIZE) != 0) {
+            LOGI("Pipeline cache was written by another device/driver, ignoring");
+            return false;
+        }
+        if (header.dataSize != file.size() - sizeof(header)) {
+            LOGI("Pipeline cache file truncated, ignoring");
+            return false;
+        }
+
+        const uint8_t* data = file.data() + sizeof(header);
+        if (fnv1a64(data, header.dataSize) != header.checksum) {
+            LOGI("Pipeline cache checksum mismatch, ignoring");
+            return false;
+        }
+
+        if (header.dataSize < sizeof(VkPipelineCacheHeaderVersionOne)) {
+            return false;
+        }
+        VkPipelineCacheHeaderVersionOne vkHeader;
+        memcpy(&vkHeader, data, sizeof(vkHeader));
+        if (vkHeader.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE ||
+            vkHeader.vendorID != identity.vendorID ||
+            vkHeader.deviceID != identity.deviceID ||
+            memcmp(vkHeader.pipelineCacheUUID, identity.pipelineCacheUUID, VK_UUID_SIZE) != 0) {
+            LOGI("Pipeline cache data header mismatch, ignoring");
+            return false;
+        }
+        return true;
+    }
+
+    bool readFile(const std::string& path, std::vector<uint8_t>& out) {
+        FILE* file = fopen(path.c_str(), "rb");
+        if (!file) {
+            return false;
+        }
+
+        fseek(file, 0, SEEK_END);
+        long size = ftell(file);
+        fseek(file, 0, SEEK_SET);
+
+        bool ok = size > 0;
+        if (ok) {
+            out.resize(static_cast<size_t>(size));
+            ok = fread(out.data(), 1, out.size(), file) == out.size();
+        }
+        fclose(file);
+        return ok;
+    }
+
+    // 先写临时文件并 fsync，再 rename 覆盖
+    bool writeFileAtomically(const std::string& path, const PipelineCacheFileHeader& header,
+                             const std::vector<uint8_t>& data) {
+        const std::string tmpPath = path + ".tmp";
+        FILE* file = fopen(tmpPath.c_str(), "wb");
+        if (!file) {
+            LOGE("Failed to open %s for writing", tmpPath.c_str());
+            return false;
+        }
+
+        bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                  fwrite(data.data(), 1, data.size(), file) == data.size() &&
+                  fflush(file) == 0 &&
+                  fsync(fileno(file)) == 0;
+        ok = (fclose(file) == 0) && ok;
+
+        if (!ok || rename(tmpPath.c_str(), path.c_str()) != 0) {
+            LOGE("Failed to write pipeline cache %s", path.c_str());
+            unlink(tmpPath.c_str());
+            return false;
+        }
+        return true;
+    }
+
+} // anonymous namespace
+
+bool createPipelineCache(DeviceInfo* deviceInfo, const char* path) {
+    if (deviceInfo->pipelineCache) {
+        return true;
+    }
+
+    PipelineCacheInfo* info = new PipelineCacheInfo();
+    if (path) {
+        info->path = path;
+    }
+
+    std::vector<uint8_t> file;
+    const uint8_t* initialData = nullptr;
+    size_t initialSize = 0;
+
+    if (!info->path.empty() && readFile(info->path, file)) {
+        if (validateCacheFile(file, queryDeviceIdentity(deviceInfo->physicalDevice))) {
+            initialData = file.data() + sizeof(PipelineCacheFileHeader);
+            initialSize = file.size() - sizeof(PipelineCacheFileHeader);
+        }
+    }
+
+    VkPipelineCacheCreateInfo cacheInfo{};
+    cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    cacheInfo.initialDataSize = initialSize;
+    cacheInfo.pInitialData = initialData;
+
+    VkResult result = vkCreatePipelineCache(deviceInfo->device, &cacheInfo, nullptr, &info->cache);
+    if (result != VK_SUCCESS && initialData) {
+        // 驱动拒绝了数据：退回空缓存
+        LOGI("Driver rejected pipeline cache data (%d), starting cold", result);
+        cacheInfo.initialDataSize = 0;
+        cacheInfo.pInitialData = nullptr;
+        initialSize = 0;
+        result = vkCreatePipelineCache(deviceInfo->device, &cacheInfo, nullptr, &info->cache);
+    }
+    if (!validateResult(result, "vkCreatePipelineCache")) {
+        delete info;
+        return false;
+    }
+
+    info->warm = initialSize > 0;
+    info->loadedBytes = initialSize;
+    deviceInfo->pipelineCache = info;
+
+    LOGI("✓ Pipeline cache created: %s, %zu bytes loaded from %s",
+         info->warm ? "warm" : "cold", initialSize,
+         info->path.empty() ? "(memory only)" : info->path.c_str());
+    return true;
+}
+
+bool savePipelineCache(DeviceInfo* deviceInfo) {
+    PipelineCacheInfo* info = deviceInfo->pipelineCache;
+    if (!info || info->cache == VK_NULL_HANDLE || info->path.empty()) {
+        return false;
+    }
+
+    size_t size = 0;
+    VkResult result = vkGetPipelineCacheData(deviceInfo->device, info->cache, &size, nullptr);
+    if (!validateResult(result, "vkGetPipelineCacheData") || size == 0) {
+        return false;
+    }
+
+    std::vector<uint8_t> data(size);
+    result = vkGetPipelineCacheData(deviceInfo->device, info->cache, &size, data.data());
+    if (result != VK_SUCCESS && result != VK_INCOMPLETE) {
+        LOGE("vkGetPipelineCacheData failed with result: %d", result);
+        return false;
+    }
+    data.resize(size);
+
+    const DeviceIdentity identity = queryDeviceIdentity(deviceInfo->physicalDevice);
+
+    PipelineCacheFileHeader header{};
+    header.magic = kCacheFileMagic;
+    header.version = kCacheFileVersion;
+    header.vendorID = identity.vendorID;
+    header.deviceID = identity.deviceID;
+    header.driverVersion = identity.driverVersion;
+    memcpy(header.driverUUID, identity.driverUUID, VK_UUID_SIZE);
+    memcpy(header.pipelineCacheUUID, identity.pipelineCacheUUID, VK_UUID_SIZE);
+    header.dataSize = data.size();
+    header.checksum = fnv1a64(data.data(), data.size());
+
+    if (!writeFileAtomically(info->path, header, data)) {
+        return false;
+    }
+
+    LOGI("✓ Pipeline cache saved: %zu bytes to %s", data.size(), info->path.c_str());
+    return true;
+}
+
+void destroyPipelineCache(DeviceInfo* deviceInfo) {
+    PipelineCacheInfo* info = deviceInfo->pipelineCache;
+    if (!info) {
+        return;
+    }
+
+    LOGI("Pipeline creation (%s): %u pipelines, %.2f ms total",
+         info->warm ? "warm cache hit" : "cold cache", info->pipelinesCreated, info->totalCreateMs);
+
+    savePipelineCache(deviceInfo);
+
+    if (info->cache != VK_NULL_HANDLE) {
+        vkDestroyPipelineCache(deviceInfo->device, info->cache, nullptr);
+    }
+    delete info;
+    deviceInfo->pipelineCache = nullptr;
+}
+
+VkPipelineCache getPipelineCache(DeviceInfo* deviceInfo) {
+    return deviceInfo->pipelineCache ? deviceInfo->pipelineCache->cache : VK_NULL_HANDLE;
+}
+
+VkResult createGraphicsPipelineCached(DeviceInfo* deviceInfo,
+                                      const VkGraphicsPipelineCreateInfo* createInfo,
+                                      VkPipeline* pipeline) {
+    // 启用 pipeline 可执行体统计时需要在创建时捕获（见 Vulkanshaderstats.h）
+    VkGraphicsPipelineCreateInfo flaggedInfo = *createInfo;
+    flaggedInfo.flags |= shaderStatisticsCreateFlags(deviceInfo);
+
+    const auto start = std::chrono::steady_clock::now();
+
+    VkResult result = vkCreateGraphicsPipelines(
+            deviceInfo->device,
+            getPipelineCache(deviceInfo),
+            1,
+            &flaggedInfo,
+            nullptr,
+            pipeline
+    );
+
+    const double elapsedMs = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+
+    PipelineCacheInfo* info = deviceInfo->pipelineCache;
+    if (result == VK_SUCCESS && info) {
+        std::lock_guard<std::mutex> lock(info->statsMutex);
+        info->pipelinesCreated++;
+        info->totalCreateMs += elapsedMs;
+    }
+    LOGI("vkCreateGraphicsPipelines: %.3f ms (%s cache)", elapsedMs,
+         info == nullptr ? "no" : (info->warm ? "warm" : "cold"));
+    if (result == VK_SUCCESS) {
+        capturePipelineExecutableStatistics(deviceInfo, *pipeline, "graphics");
+    }
+    return result;
+}
+
+VkResult createComputePipelineCached(DeviceInfo* deviceInfo,
+                                     const VkComputePipelineCreateInfo* createInfo,
+                                     VkPipeline* pipeline) {
+    // 启用 pipeline 可执行体统计时需要在创建时捕获（见 Vulkanshaderstats.h）
+    VkComputePipelineCreateInfo flaggedInfo = *createInfo;
+    flaggedInfo.flags |= shaderStatisticsCreateFlags(deviceInfo);
+
+    const auto start = std::chrono::steady_clock::now();
+
+    VkResult result = vkCreateComputePipelines(
+            deviceInfo->device,
+            getPipelineCache(deviceInfo),
+            1,
+            &flaggedInfo,
+            nullptr,
+            pipeline
+    );
+
+    const double elapsedMs = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+
+    PipelineCacheInfo* info = deviceInfo->pipelineCache;
+    if (result == VK_SUCCESS && info) {
+        std::lock_guard<std::mutex> lock(info->statsMutex);
+        info->pipelinesCreated++;
+        info->totalCreateMs += elapsedMs;
+    }
+    LOGI("vkCreateComputePipelines: %.3f ms (%s cache)", elapsedMs,
+         info == nullptr ? "no" : (info->warm ? "warm" : "cold"));
+    if (result == VK_SUCCESS) {
+        capturePipelineExecutableStatistics(deviceInfo, *pipeline, "compute");
+    }
+    return result;
+}
+
+// ============================================
+// JNI: VulkanRunner
+// ============================================
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeCreatePipelineCache(
+        JNIEnv* env, jobject /* this */,
+        jlong deviceHandle,
+        jstring pathString) {
+
+    DeviceInfo* deviceInfo = getDeviceInfo(deviceHandle);
+    if (!validateHandle(deviceInfo, "device")) {
+        return JNI_FALSE;
+    }
+
+    const char* path = pathString ? env->GetStringUTFChars(pathString, nullptr) : nullptr;
+    bool ok = createPipelineCache(deviceInfo, path);
+    if (path) {
+        env->ReleaseStringUTFChars(pathString, path);
+    }
+    return ok ? JNI_TRUE : JNI_FALSE;
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeDestroyPipelineCache(
+        JNIEnv* env, jobject /* this */, jlong deviceHandle) {
+
+    DeviceInfo* deviceInfo = getDeviceInfo(deviceHandle);
+    if (validateHandle(deviceInfo, "device")) {
+        // 后台编译线程可能还在使用缓存
+        destroyPipelineCompiler(deviceInfo);
+        destroyPipelineCache(deviceInfo);
+    }
+}
+
+// 返回 [warm (0/1), pipelinesCreated, totalCreateMs, loadedBytes]
+extern "C" JNIEXPORT jdoubleArray JNICALL
+Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeGetPipelineCacheStats(
+        JNIEnv* env, jobject /* this */, jlong deviceHandle) {
+
+    DeviceInfo* deviceInfo = getDeviceInfo(deviceHandle);
+    jdouble values[4] = {0.0, 0.0, 0.0, 0.0};
+    if (deviceInfo && deviceInfo->pipelineCache) {
+        PipelineCacheInfo* info = deviceInfo->pipelineCache;
+        std::lock_guard<std::mutex> lock(info->statsMutex);
+        values[0] = info->warm ? 1.0 : 0.0;
+        values[1] = info->pipelinesCreated;
+        values[2] = info->totalCreateMs;
+        values[3] = static_cast<jdouble>(info->loadedBytes);
+    }
+
+    jdoubleArray result = env->NewDoubleArray(4);
+    if (result) {
+        env->SetDoubleArrayRegion(result, 0, 4, values);
+    }
+    return result;
+}
@@ -0,0 +1,49 @@
+//
+// Persistent VkPipelineCache shared by all filters of a device.
+//
+// 创建设备后从应用 cache 目录加载缓存数据，文件头记录 vendor/device/driver 信息，
+// 与当前设备不一致（驱动升级、换机恢复数据等）时丢弃。
+// 释放时先写入临时文件，再 rename 覆盖，保证不会留下半个文件。
+//
+#ifndef VULKAN_PIPELINE_CACHE_H
+#define VULKAN_PIPELINE_CACHE_H
+
+#include <vulkan/vulkan.h>
+#include <mutex>
+#include <string>
+#include "Vulkantypes.h"
+
+struct PipelineCacheInfo {
+    VkPipelineCache cache = VK_NULL_HANDLE;
+    std::string path;          // 为空表示只在内存中共享，不持久化
+
+    // 统计：冷启动 / 热启动的 pipeline 创建耗时（后台编译线程也会更新，由 statsMutex 保护）
+    std::mutex statsMutex;
+    bool warm = false;         // 是否成功加载了磁盘缓存
+    size_t loadedBytes = 0;
+    uint32_t pipelinesCreated = 0;
+    double totalCreateMs = 0.0;
+};
+
+// 创建设备后调用；path 可以为 nullptr
+bool createPipelineCache(DeviceInfo* deviceInfo, const char* path);
+
+// 写回磁盘（如果有路径）并销毁缓存；销毁设备前调用
+void destroyPipelineCache(DeviceInfo* deviceInfo);
+
+bool savePipelineCache(DeviceInfo* deviceInfo);
+
+// 没有缓存时返回 VK_NULL_HANDLE，vkCreate*Pipelines 仍可正常使用
+VkPipelineCache getPipelineCache(DeviceInfo* deviceInfo);
+
+// 所有滤镜统一通过这里创建图形 pipeline：使用共享缓存并记录耗时
+VkResult createGraphicsPipelineCached(DeviceInfo* deviceInfo,
+                                      const VkGraphicsPipelineCreateInfo* createInfo,
+                                      VkPipeline* pipeline);
+
+// 计算 pipeline 同样走共享缓存，统计合并计入
+VkResult createComputePipelineCached(DeviceInfo* deviceInfo,
+                                     const VkComputePipelineCreateInfo* createInfo,
+                                     VkPipeline* pipeline);
+
+#endif // VULKAN_PIPELINE_CACHE_H
@@ -0,0 +1,344 @@
+//
+// Background pipeline compilation.
+//
+#include "Vulkanjni.h"
+#include "Vulkanpipelinecompiler.h"
+#include "Vulkantrace.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <pthread.h>
+
+using namespace VulkanJNI;
+
+struct PipelineCompiler {
+    std::mutex mutex;
+    std::condition_variable workAvailable;
+    std::condition_variable jobDone;
+
+    std::deque<PipelineFuture*> queue;
+    PipelineFuture* running = nullptr;
+    bool stopping = false;
+
+    std::thread worker;
+    uint32_t compiled = 0;
+};
+
+struct PipelineFuture {
+    // 请求：specialization 持有常量数据，任务执行前一直有效
+    VkRenderPass renderPass = VK_NULL_HANDLE;
+    VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+    VkShaderModule vertShaderModule = VK_NULL_HANDLE;
+    VkShaderModule fragShaderModule = VK_NULL_HANDLE;
+    VkShaderModule computeShaderModule = VK_NULL_HANDLE;  // 非空表示计算 pipeline
+    SpecializationConstants specialization;
+
+    // 同步创建时为 nullptr
+    PipelineCompiler* compiler = nullptr;
+
+    // 结果：pipeline 在 state 发布之前写入
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    std::atomic<int> state{PIPELINE_PENDING};
+};
+
+namespace {
+
+    void compile(DeviceInfo* deviceInfo, PipelineFuture* future) {
+        TraceScope trace("compile_pipeline");
+        const auto start = std::chrono::steady_clock::now();
+
+        VkPipeline pipeline = VK_NULL_HANDLE;
+        VkResult result;
+        if (future->computeShaderModule != VK_NULL_HANDLE) {
+            result = acquireComputeShaderPipeline(deviceInfo, future->pipelineLayout,
+                                                  future->computeShaderModule,
+                                                  future->specialization.get(), &pipeline);
+        } else {
+            result = acquireFullscreenPipeline(deviceInfo, future->renderPass, future->pipelineLayout,
+                                               future->vertShaderModule, future->fragShaderModule,
+                                               future->specialization.get(), &pipeline);
+        }
+
+        const double elapsedMs = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - start).count();
+
+        if (result == VK_SUCCESS) {
+            future->pipeline = pipeline;
+            future->state.store(PIPELINE_READY, std::memory_order_release);
+            LOGI("✓ Pipeline compiled in background: %p (%.3f ms)", (void*)pipeline, elapsedMs);
+        } else {
+            future->state.store(PIPELINE_FAILED, std::memory_order_release);
+            LOGE("Background pipeline compilation failed: %d", result);
+        }
+    }
+
+    PipelineFuture* submit(DeviceInfo* deviceInfo, PipelineFuture* future) {
+        PipelineCompiler* compiler = deviceInfo->pipelineCompiler;
+        if (!compiler) {
+            compile(deviceInfo, future);
+            return future;
+        }
+
+        future->compiler = compiler;
+        std::lock_guard<std::mutex> lock(compiler->mutex);
+        compiler->queue.push_back(future);
+        compiler->workAvailable.notify_one();
+        return future;
+    }
+
+    void workerLoop(DeviceInfo* deviceInfo, PipelineCompiler* compiler) {
+        pthread_setname_np(pthread_self(), "PipelineCompile");
+
+        std::unique_lock<std::mutex> lock(compiler->mutex);
+        while (true) {
+            compiler->workAvailable.wait(lock, [compiler] {
+                return compiler->stopping || !compiler->queue.empty();
+            });
+            if (compiler->stopping) break;
+
+            PipelineFuture* future = compiler->queue.front();
+            compiler->queue.pop_front();
+            compiler->running = future;
+
+            // 编译期间不持有锁：渲染线程可以继续提交、查询、取消
+            lock.unlock();
+            compile(deviceInfo, future);
+            lock.lock();
+
+            compiler->running = nullptr;
+            compiler->compiled++;
+            compiler->jobDone.notify_all();
+        }
+    }
+
+} // anonymous namespace
+
+// ============================================
+// Lifetime
+// ============================================
+void createPipelineCompiler(DeviceInfo* deviceInfo) {
+    if (deviceInfo->pipelineCompiler != nullptr) return;
+
+    PipelineCompiler* compiler = new PipelineCompiler();
+    compiler->worker = std::thread(workerLoop, deviceInfo, compiler);
+    deviceInfo->pipelineCompiler = compiler;
+}
+
+void destroyPipelineCompiler(DeviceInfo* deviceInfo) {
+    PipelineCompiler* compiler = deviceInfo->pipelineCompiler;
+    if (!compiler) return;
+
+    size_t cancelled;
+    {
+        std::lock_guard<std::mutex> lock(compiler->mutex);
+        compiler->stopping = true;
+        cancelled = compiler->queue.size();
+        for (PipelineFuture* future : compiler->queue) {
+            future->state.store(PIPELINE_FAILED, std::memory_order_release);
+        }
+        compiler->queue.clear();
+        compiler->workAvailable.notify_all();
+        compiler->jobDone.notify_all();
+    }
+    // 正在编译的任务无法中断，等它完成
+    compiler->worker.join();
+
+    LOGI("Pipeline compiler: %u pipelines compiled, %zu cancelled", compiler->compiled, cancelled);
+    delete compiler;
+    deviceInfo->pipelineCompiler = nullptr;
+}
+
+// ============================================
+// Futures
+// ============================================
+PipelineFuture* compileFullscreenPipelineAsync(DeviceInfo* deviceInfo,
+                                               VkRenderPass renderPass,
+                                               VkPipelineLayout pipelineLayout,
+                                               VkShaderModule vertShaderModule,
+                                               VkShaderModule fragShaderModule,
+                                               const SpecializationConstants& specialization) {
+    PipelineFuture* future = new PipelineFuture();
+    future->renderPass = renderPass;
+    future->pipelineLayout = pipelineLayout;
+    future->vertShaderModule = vertShaderModule;
+    future->fragShaderModule = fragShaderModule;
+    future->specialization = specialization;
+    return submit(deviceInfo, future);
+}
+
+PipelineFuture* compileComputePipelineAsync(DeviceInfo* deviceInfo,
+                                            VkPipelineLayout pipelineLayout,
+                                            VkShaderModule computeShaderModule,
+                                            const SpecializationConstants& specialization) {
+    PipelineFuture* future = new PipelineFuture();
+    future->pipelineLayout = pipelineLayout;
+    future->computeShaderModule = computeShaderModule;
+    future->specialization = specialization;
+    return submit(deviceInfo, future);
+}
+
+PipelineFutureState getPipelineFutureState(const PipelineFuture* future) {
+    return static_cast<PipelineFutureState>(future->state.load(std::memory_order_acquire));
+}
+
+VkPipeline getFuturePipeline(const PipelineFuture* future) {
+    return getPipelineFutureState(future) == PIPELINE_READY ? future->pipeline : VK_NULL_HANDLE;
+}
+
+VkPipeline waitFuturePipeline(PipelineFuture* future) {
+    if (getPipelineFutureState(future) == PIPELINE_PENDING) {
+        PipelineCompiler* compiler = future->compiler;
+        std::unique_lock<std::mutex> lock(compiler->mutex);
+
+        auto it = std::find(compiler->queue.begin(), compiler->queue.end(), future);
+        if (it != compiler->queue.end() && it != compiler->queue.begin()) {
+            compiler->queue.erase(it);
+            compiler->queue.push_front(future);
+        }
+        compiler->jobDone.wait(lock, [future] {
+            return future->state.load(std::memory_order_acquire) != PIPELINE_PENDING;
+        });
+    }
+    return getFuturePipeline(future);
+}
+
+void destroyPipelineFuture(DeviceInfo* deviceInfo, PipelineFuture* future) {
+    // 已完成的任务不在队列中，也不会再被编译线程访问
+    if (getPipelineFutureState(future) == PIPELINE_PENDING) {
+        PipelineCompiler* compiler = future->compiler;
+        std::unique_lock<std::mutex> lock(compiler->mutex);
+
+        auto it = std::find(compiler->queue.begin(), compiler->queue.end(), future);
+        if (it != compiler->queue.end()) {
+            compiler->queue.erase(it);
+            future->state.store(PIPELINE_FAILED, std::memory_order_release);
+        } else {
+            compiler->jobDone.wait(lock, [compiler, future] { return compiler->running != future; });
+        }
+    }
+
+    if (getPipelineFutureState(future) == PIPELINE_READY) {
+        releaseGraphicsPipeline(deviceInfo, future->pipeline);
+    }
+    delete future;
+}
+
+// ============================================
+// JNI: PipelineFuture
+// ============================================
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_genymobile_scrcpy_vulkan_PipelineFuture_nativeCompileFullscreen(
+        JNIEnv* env, jobject /* this */,
+        jlong deviceHandle,
+        jlong renderPassHandle,
+        jlong pipelineLayoutHandle,
+        jlong vertShaderModuleHandle,
+        jlong fragShaderModuleHandle,
+        jintArray specConstants) {
+
+    DeviceInfo* deviceInfo = getDeviceInfo(deviceHandle);
+    VkRenderPass renderPass = fromHandle<VkRenderPass>(renderPassHandle);
+    VkPipelineLayout pipelineLayout = fromHandle<VkPipelineLayout>(pipelineLayoutHandle);
+    VkShaderModule vertShaderModule = fromHandle<VkShaderModule>(vertShaderModuleHandle);
+    VkShaderModule fragShaderModule = fromHandle<VkShaderModule>(fragShaderModuleHandle);
+
+    if (!validateHandle(deviceInfo, "device") ||
+        !validateHandle(pipelineLayout, "pipelineLayout") ||
+        !validateHandle(vertShaderModule, "vertShaderModule") ||
+        !validateHandle(fragShaderModule, "fragShaderModule")) {
+        return 0;
+    }
+    // renderPass 为 0 表示动态渲染
+    if (renderPass == VK_NULL_HANDLE && !deviceInfo->dynamicRendering) {
+        LOGE("Invalid renderPass handle: dynamic rendering is not enabled");
+        return 0;
+    }
+
+    // 特化常量 [id0, value0, id1, value1, ...]，可以为 null
+    SpecializationConstants specialization;
+    if (specConstants != nullptr) {
+        jsize count = env->GetArrayLength(specConstants);
+        std::vector<jint> pairs(count);
+        env->GetIntArrayRegion(specConstants, 0, count, pairs.data());
+        specialization.set(pairs.data(), pairs.size());
+    }
+
+    PipelineFuture* future = compileFullscreenPipelineAsync(deviceInfo, renderPass, pipelineLayout,
+                                                            vertShaderModule, fragShaderModule,
+                                                            specialization);
+    return reinterpret_cast<jlong>(future);
+}
+
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_genymobile_scrcpy_vulkan_PipelineFuture_nativeCompileCompute(
+        JNIEnv* env, jobject /* this */,
+        jlong deviceHandle,
+        jlong pipelineLayoutHandle,
+        jlong computeShaderModuleHandle,
+        jintArray specConstants) {
+
+    DeviceInfo* deviceInfo = getDeviceInfo(deviceHandle);
+    VkPipelineLayout pipelineLayout = fromHandle<VkPipelineLayout>(pipelineLayoutHandle);
+    VkShaderModule computeShaderModule = fromHandle<VkShaderModule>(computeShaderModuleHandle);
+
+    if (!validateHandle(deviceInfo, "device") ||
+        !validateHandle(pipelineLayout, "pipelineLayout") ||
+        !validateHandle(computeShaderModule, "computeShaderModule")) {
+        return 0;
+    }
+
+    SpecializationConstants specialization;
+    if (specConstants != nullptr) {
+        jsize count = env->GetArrayLength(specConstants);
+        std::vector<jint> pairs(count);
+        env->GetIntArrayRegion(specConstants, 0, count, pairs.data());
+        specialization.set(pairs.data(), pairs.size());
+    }
+
+    PipelineFuture* future = compileComputePipelineAsync(deviceInfo, pipelineLayout,
+                                                         computeShaderModule, specialization);
+    return reinterpret_cast<jlong>(future);
+}
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_genymobile_scrcpy_vulkan_PipelineFuture_nativeGetState(
+        JNIEnv* env, jobject /* this */, jlong futureHandle) {
+
+    auto* future = reinterpret_cast<PipelineFuture*>(futureHandle);
+    if (!future) return PIPELINE_FAILED;
+    return getPipelineFutureState(future);
+}
+
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_genymobile_scrcpy_vulkan_PipelineFuture_nativeGetPipeline(
+        JNIEnv* env, jobject /* this */, jlong futureHandle) {
+
+    auto* future = reinterpret_cast<PipelineFuture*>(futureHandle);
+    if (!future) return 0;
+    return toHandle(getFuturePipeline(future));
+}
+
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_genymobile_scrcpy_vulkan_PipelineFuture_nativeWait(
+        JNIEnv* env, jobject /* this */, jlong futureHandle) {
+
+    auto* future = reinterpret_cast<PipelineFuture*>(futureHandle);
+    if (!future) return 0;
+    return toHandle(waitFuturePipeline(future));
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_genymobile_scrcpy_vulkan_PipelineFuture_nativeDestroy(
+        JNIEnv* env, jobject /* this */, jlong deviceHandle, jlong futureHandle) {
+
+    DeviceInfo* deviceInfo = getDeviceInfo(deviceHandle);
+    auto* future = reinterpret_cast<PipelineFuture*>(futureHandle);
+    if (validateHandle(deviceInfo, "device") && future) {
+        destroyPipelineFuture(deviceInfo, future);
+    }
+}
@@ -0,0 +1,59 @@
+//
+// Background pipeline compilation.
+//
+// 每个设备一个编译线程，按提交顺序创建 pipeline（经由 pipeline registry，与同步创建的
+// pipeline 共享、共用持久化缓存）。滤镜 init 只提交任务，渲染线程不再等待驱动编译 shader；
+// 编译完成前 runner 用已经编译好的直通 pipeline 绘制。
+//
+// 任务引用的 render pass / pipeline layout / shader module 必须在任务完成
+// （或 destroyPipelineFuture 返回）之后才能销毁。
+//
+#ifndef VULKAN_PIPELINE_COMPILER_H
+#define VULKAN_PIPELINE_COMPILER_H
+
+#include <vulkan/vulkan.h>
+#include "Vulkantypes.h"
+#include "Vulkanpipelineregistry.h"
+
+struct PipelineFuture;
+
+enum PipelineFutureState {
+    PIPELINE_PENDING = 0,   // 排队或正在编译
+    PIPELINE_READY = 1,
+    PIPELINE_FAILED = 2     // 创建失败，或编译线程停止时被取消
+};
+
+// 创建设备后调用，启动编译线程
+void createPipelineCompiler(DeviceInfo* deviceInfo);
+
+// 取消排队的任务并等待正在编译的任务结束；可重复调用。
+// 编译线程会使用 pipeline 缓存和 registry，必须在两者销毁之前调用
+void destroyPipelineCompiler(DeviceInfo* deviceInfo);
+
+// 提交全屏滤镜 pipeline（参数同 acquireFullscreenPipeline），立即返回。
+// 没有编译线程时同步创建，返回的 future 已经完成
+PipelineFuture* compileFullscreenPipelineAsync(DeviceInfo* deviceInfo,
+                                               VkRenderPass renderPass,
+                                               VkPipelineLayout pipelineLayout,
+                                               VkShaderModule vertShaderModule,
+                                               VkShaderModule fragShaderModule,
+                                               const SpecializationConstants& specialization);
+
+// 提交计算滤镜 pipeline（参数同 acquireComputeShaderPipeline），其余行为同上
+PipelineFuture* compileComputePipelineAsync(DeviceInfo* deviceInfo,
+                                            VkPipelineLayout pipelineLayout,
+                                            VkShaderModule computeShaderModule,
+                                            const SpecializationConstants& specialization);
+
+PipelineFutureState getPipelineFutureState(const PipelineFuture* future);
+
+// 不阻塞：READY 时返回 pipeline，否则 VK_NULL_HANDLE。pipeline 归 future 所有
+VkPipeline getFuturePipeline(const PipelineFuture* future);
+
+// 阻塞直到完成；排队中的任务提到队首，不等前面的任务
+VkPipeline waitFuturePipeline(PipelineFuture* future);
+
+// 取消（还在排队）或等待（正在编译），然后释放 pipeline 和 future 本身
+void destroyPipelineFuture(DeviceInfo* deviceInfo, PipelineFuture* future);
+
+#endif // VULKAN_PIPELINE_COMPILER_H
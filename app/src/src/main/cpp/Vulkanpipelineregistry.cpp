@@ -0,0 +1,831 @@
+//
+// Pipeline registry: identical graphics and compute pipelines are created once per device and shared.
+//
+#include "Vulkanjni.h"
+#include "Vulkanpipelineregistry.h"
+#include "Vulkanpipelinecache.h"
+#include "Vulkansamplers.h"
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace VulkanJNI;
+
+struct PipelineRegistry {
+    std::mutex mutex;
+    std::condition_variable created;  // 某个 pipeline 创建完成（或失败）
+
+    // 句柄 → 内容键
+    std::unordered_map<uint64_t, std::string> shaderModules;
+    std::unordered_map<uint64_t, std::string> setLayouts;
+    std::unordered_map<uint64_t, std::string> pipelineLayouts;
+    std::unordered_map<uint64_t, std::string> renderPasses;
+
+    struct Entry {
+        VkPipeline pipeline = VK_NULL_HANDLE;  // VK_NULL_HANDLE 表示另一个线程正在创建
+        uint32_t refCount = 0;
+    };
+    std::unordered_map<std::string, Entry> pipelines;     // pipeline 键 → pipeline
+    std::unordered_map<uint64_t, std::string> pipelineKeys;  // VkPipeline → pipeline 键
+
+    uint32_t hits = 0;
+    uint32_t misses = 0;
+};
+
+namespace {
+
+    template<typename T>
+    uint64_t handleKey(T handle) {
+        return static_cast<uint64_t>(toHandle(handle));
+    }
+
+    // 按字节拼接键；每个变长字段都带长度前缀，保证不同结构不会拼出相同的字节串
+    class KeyBuilder {
+    public:
+        void u32(uint32_t value) { bytes(&value, sizeof(value)); }
+        void f32(float value) { bytes(&value, sizeof(value)); }
+        void flag(bool value) { u32(value ? 1u : 0u); }
+
+        void bytes(const void* data, size_t size) {
+            key_.append(static_cast<const char*>(data), size);
+        }
+
+        void str(const std::string& value) {
+            u32(static_cast<uint32_t>(value.size()));
+            key_ += value;
+        }
+
+        void cstr(const char* value) {
+            str(value ? std::string(value) : std::string());
+        }
+
+        std::string take() { return std::move(key_); }
+
+    private:
+        std::string key_;
+    };
+
+    uint64_t fnv1a64(const uint8_t* data, size_t size) {
+        uint64_t hash = 0xcbf29ce484222325ull;
+        for (size_t i = 0; i < size; i++) {
+            hash ^= data[i];
+            hash *= 0x100000001b3ull;
+        }
+        return hash;
+    }
+
+    bool lookup(const std::unordered_map<uint64_t, std::string>& map, uint64_t handle, std::string* key) {
+        auto it = map.find(handle);
+        if (it == map.end()) return false;
+        *key = it->second;
+        return true;
+    }
+
+    void addAttachmentReference(KeyBuilder& key, const VkAttachmentReference* ref) {
+        key.flag(ref != nullptr);
+        if (ref) key.u32(ref->attachment);  // layout 不影响兼容性
+    }
+
+    void addAttachmentReferences(KeyBuilder& key, uint32_t count, const VkAttachmentReference* refs) {
+        key.u32(refs ? count : 0);
+        for (uint32_t i = 0; refs && i < count; i++) {
+            key.u32(refs[i].attachment);
+        }
+    }
+
+    // render pass 兼容性：忽略 load/store op 和各种 layout，其余必须一致
+    std::string renderPassKey(const VkRenderPassCreateInfo* info) {
+        KeyBuilder key;
+        key.u32(info->flags);
+
+        key.u32(info->attachmentCount);
+        for (uint32_t i = 0; i < info->attachmentCount; i++) {
+            const VkAttachmentDescription& attachment = info->pAttachments[i];
+            key.u32(attachment.flags);
+            key.u32(attachment.format);
+            key.u32(attachment.samples);
+        }
+
+        key.u32(info->subpassCount);
+        for (uint32_t i = 0; i < info->subpassCount; i++) {
+            const VkSubpassDescription& subpass = info->pSubpasses[i];
+            key.u32(subpass.flags);
+            key.u32(subpass.pipelineBindPoint);
+            addAttachmentReferences(key, subpass.inputAttachmentCount, subpass.pInputAttachments);
+            addAttachmentReferences(key, subpass.colorAttachmentCount, subpass.pColorAttachments);
+            addAttachmentReferences(key, subpass.colorAttachmentCount, subpass.pResolveAttachments);
+            addAttachmentReference(key, subpass.pDepthStencilAttachment);
+            key.u32(subpass.preserveAttachmentCount);
+            key.bytes(subpass.pPreserveAttachments, subpass.preserveAttachmentCount * sizeof(uint32_t));
+        }
+
+        key.u32(info->dependencyCount);
+        for (uint32_t i = 0; i < info->dependencyCount; i++) {
+            const VkSubpassDependency& dependency = info->pDependencies[i];
+            key.u32(dependency.srcSubpass);
+            key.u32(dependency.dstSubpass);
+            key.u32(dependency.srcStageMask);
+            key.u32(dependency.dstStageMask);
+            key.u32(dependency.srcAccessMask);
+            key.u32(dependency.dstAccessMask);
+            key.u32(dependency.dependencyFlags);
+        }
+        return key.take();
+    }
+
+    bool addShaderStage(KeyBuilder& key, const PipelineRegistry& registry,
+                        const VkPipelineShaderStageCreateInfo& stage) {
+        std::string moduleKey;
+        if (stage.pNext != nullptr || !lookup(registry.shaderModules, handleKey(stage.module), &moduleKey)) {
+            return false;
+        }
+        key.u32(stage.flags);
+        key.u32(stage.stage);
+        key.str(moduleKey);
+        key.cstr(stage.pName);
+
+        const VkSpecializationInfo* specialization = stage.pSpecializationInfo;
+        key.flag(specialization != nullptr);
+        if (specialization) {
+            key.u32(specialization->mapEntryCount);
+            for (uint32_t i = 0; i < specialization->mapEntryCount; i++) {
+                const VkSpecializationMapEntry& entry = specialization->pMapEntries[i];
+                key.u32(entry.constantID);
+                key.u32(entry.offset);
+                key.u32(static_cast<uint32_t>(entry.size));
+            }
+            key.u32(static_cast<uint32_t>(specialization->dataSize));
+            key.bytes(specialization->pData, specialization->dataSize);
+        }
+        return true;
+    }
+
+    void addVertexInputState(KeyBuilder& key, const VkPipelineVertexInputStateCreateInfo* state) {
+        key.flag(state != nullptr);
+        if (!state) return;
+        key.u32(state->flags);
+        key.u32(state->vertexBindingDescriptionCount);
+        for (uint32_t i = 0; i < state->vertexBindingDescriptionCount; i++) {
+            const VkVertexInputBindingDescription& binding = state->pVertexBindingDescriptions[i];
+            key.u32(binding.binding);
+            key.u32(binding.stride);
+            key.u32(binding.inputRate);
+        }
+        key.u32(state->vertexAttributeDescriptionCount);
+        for (uint32_t i = 0; i < state->vertexAttributeDescriptionCount; i++) {
+            const VkVertexInputAttributeDescription& attribute = state->pVertexAttributeDescriptions[i];
+            key.u32(attribute.location);
+            key.u32(attribute.binding);
+            key.u32(attribute.format);
+            key.u32(attribute.offset);
+        }
+    }
+
+    void addViewportState(KeyBuilder& key, const VkPipelineViewportStateCreateInfo* state) {
+        key.flag(state != nullptr);
+        if (!state) return;
+        key.u32(state->flags);
+        key.u32(state->viewportCount);
+        key.flag(state->pViewports != nullptr);
+        for (uint32_t i = 0; state->pViewports && i < state->viewportCount; i++) {
+            const VkViewport& viewport = state->pViewports[i];
+            key.f32(viewport.x);
+            key.f32(viewport.y);
+            key.f32(viewport.width);
+            key.f32(viewport.height);
+            key.f32(viewport.minDepth);
+            key.f32(viewport.maxDepth);
+        }
+        key.u32(state->scissorCount);
+        key.flag(state->pScissors != nullptr);
+        for (uint32_t i = 0; state->pScissors && i < state->scissorCount; i++) {
+            const VkRect2D& scissor = state->pScissors[i];
+            key.u32(static_cast<uint32_t>(scissor.offset.x));
+            key.u32(static_cast<uint32_t>(scissor.offset.y));
+            key.u32(scissor.extent.width);
+            key.u32(scissor.extent.height);
+        }
+    }
+
+    void addRasterizationState(KeyBuilder& key, const VkPipelineRasterizationStateCreateInfo* state) {
+        key.flag(state != nullptr);
+        if (!state) return;
+        key.u32(state->flags);
+        key.u32(state->depthClampEnable);
+        key.u32(state->rasterizerDiscardEnable);
+        key.u32(state->polygonMode);
+        key.u32(state->cullMode);
+        key.u32(state->frontFace);
+        key.u32(state->depthBiasEnable);
+        key.f32(state->depthBiasConstantFactor);
+        key.f32(state->depthBiasClamp);
+        key.f32(state->depthBiasSlopeFactor);
+        key.f32(state->lineWidth);
+    }
+
+    void addMultisampleState(KeyBuilder& key, const VkPipelineMultisampleStateCreateInfo* state) {
+        key.flag(state != nullptr);
+        if (!state) return;
+        key.u32(state->flags);
+        key.u32(state->rasterizationSamples);
+        key.u32(state->sampleShadingEnable);
+        key.f32(state->minSampleShading);
+        key.flag(state->pSampleMask != nullptr);
+        if (state->pSampleMask) {
+            const uint32_t words = (static_cast<uint32_t>(state->rasterizationSamples) + 31) / 32;
+            key.bytes(state->pSampleMask, words * sizeof(VkSampleMask));
+        }
+        key.u32(state->alphaToCoverageEnable);
+        key.u32(state->alphaToOneEnable);
+    }
+
+    void addStencilOpState(KeyBuilder& key, const VkStencilOpState& state) {
+        key.u32(state.failOp);
+        key.u32(state.passOp);
+        key.u32(state.depthFailOp);
+        key.u32(state.compareOp);
+        key.u32(state.compareMask);
+        key.u32(state.writeMask);
+        key.u32(state.reference);
+    }
+
+    void addDepthStencilState(KeyBuilder& key, const VkPipelineDepthStencilStateCreateInfo* state) {
+        key.flag(state != nullptr);
+        if (!state) return;
+        key.u32(state->flags);
+        key.u32(state->depthTestEnable);
+        key.u32(state->depthWriteEnable);
+        key.u32(state->depthCompareOp);
+        key.u32(state->depthBoundsTestEnable);
+        key.u32(state->stencilTestEnable);
+        addStencilOpState(key, state->front);
+        addStencilOpState(key, state->back);
+        key.f32(state->minDepthBounds);
+        key.f32(state->maxDepthBounds);
+    }
+
+    void addColorBlendState(KeyBuilder& key, const VkPipelineColorBlendStateCreateInfo* state) {
+        key.flag(state != nullptr);
+        if (!state) return;
+        key.u32(state->flags);
+        key.u32(state->logicOpEnable);
+        key.u32(state->logicOp);
+        key.u32(state->attachmentCount);
+        for (uint32_t i = 0; i < state->attachmentCount; i++) {
+            const VkPipelineColorBlendAttachmentState& attachment = state->pAttachments[i];
+            key.u32(attachment.blendEnable);
+            key.u32(attachment.srcColorBlendFactor);
+            key.u32(attachment.dstColorBlendFactor);
+            key.u32(attachment.colorBlendOp);
+            key.u32(attachment.srcAlphaBlendFactor);
+            key.u32(attachment.dstAlphaBlendFactor);
+            key.u32(attachment.alphaBlendOp);
+            key.u32(attachment.colorWriteMask);
+        }
+        for (float constant : state->blendConstants) {
+            key.f32(constant);
+        }
+    }
+
+    void addDynamicState(KeyBuilder& key, const VkPipelineDynamicStateCreateInfo* state) {
+        key.flag(state != nullptr);
+        if (!state) return;
+        key.u32(state->flags);
+        key.u32(state->dynamicStateCount);
+        for (uint32_t i = 0; i < state->dynamicStateCount; i++) {
+            key.u32(state->pDynamicStates[i]);
+        }
+    }
+
+    // 动态渲染：附件格式代替 render pass 参与组键，只要格式相同 pipeline 就可以复用
+    std::string renderingKey(const VkPipelineRenderingCreateInfoKHR* info) {
+        KeyBuilder key;
+        key.u32(info->viewMask);
+        key.u32(info->colorAttachmentCount);
+        for (uint32_t i = 0; i < info->colorAttachmentCount; i++) {
+            key.u32(info->pColorAttachmentFormats[i]);
+        }
+        key.u32(info->depthAttachmentFormat);
+        key.u32(info->stencilAttachmentFormat);
+        return key.take();
+    }
+
+    // 任何无法按内容描述的部分（pNext 扩展链、未登记的对象、派生 pipeline）都返回 false，不共享。
+    // 唯一接受的 pNext 是动态渲染的 VkPipelineRenderingCreateInfoKHR（此时 renderPass 为空）
+    bool pipelineKey(const PipelineRegistry& registry, const VkGraphicsPipelineCreateInfo* info, std::string* out) {
+        if ((info->flags & VK_PIPELINE_CREATE_DERIVATIVE_BIT) != 0) {
+            return false;
+        }
+        const auto* rendering = static_cast<const VkPipelineRenderingCreateInfoKHR*>(info->pNext);
+        if (rendering != nullptr &&
+            (rendering->sType != VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO_KHR ||
+             rendering->pNext != nullptr || info->renderPass != VK_NULL_HANDLE)) {
+            return false;
+        }
+        const void* chains[] = {
+                info->pVertexInputState ? info->pVertexInputState->pNext : nullptr,
+                info->pInputAssemblyState ? info->pInputAssemblyState->pNext : nullptr,
+                info->pTessellationState ? info->pTessellationState->pNext : nullptr,
+                info->pViewportState ? info->pViewportState->pNext : nullptr,
+                info->pRasterizationState ? info->pRasterizationState->pNext : nullptr,
+                info->pMultisampleState ? info->pMultisampleState->pNext : nullptr,
+                info->pDepthStencilState ? info->pDepthStencilState->pNext : nullptr,
+                info->pColorBlendState ? info->pColorBlendState->pNext : nullptr,
+                info->pDynamicState ? info->pDynamicState->pNext : nullptr,
+        };
+        for (const void* chain : chains) {
+            if (chain != nullptr) return false;
+        }
+
+        std::string layoutKey;
+        std::string renderPassKey;
+        if (!lookup(registry.pipelineLayouts, handleKey(info->layout), &layoutKey)) {
+            return false;
+        }
+        if (rendering != nullptr) {
+            renderPassKey = renderingKey(rendering);
+        } else if (!lookup(registry.renderPasses, handleKey(info->renderPass), &renderPassKey)) {
+            return false;
+        }
+
+        KeyBuilder key;
+        key.u32(VK_PIPELINE_BIND_POINT_GRAPHICS);
+        key.u32(info->flags);
+        key.u32(info->stageCount);
+        for (uint32_t i = 0; i < info->stageCount; i++) {
+            if (!addShaderStage(key, registry, info->pStages[i])) return false;
+        }
+
+        addVertexInputState(key, info->pVertexInputState);
+
+        key.flag(info->pInputAssemblyState != nullptr);
+        if (info->pInputAssemblyState) {
+            key.u32(info->pInputAssemblyState->flags);
+            key.u32(info->pInputAssemblyState->topology);
+            key.u32(info->pInputAssemblyState->primitiveRestartEnable);
+        }
+
+        key.flag(info->pTessellationState != nullptr);
+        if (info->pTessellationState) {
+            key.u32(info->pTessellationState->flags);
+            key.u32(info->pTessellationState->patchControlPoints);
+        }
+
+        addViewportState(key, info->pViewportState);
+        addRasterizationState(key, info->pRasterizationState);
+        addMultisampleState(key, info->pMultisampleState);
+        addDepthStencilState(key, info->pDepthStencilState);
+        addColorBlendState(key, info->pColorBlendState);
+        addDynamicState(key, info->pDynamicState);
+
+        key.str(layoutKey);
+        key.flag(rendering != nullptr);
+        key.str(renderPassKey);
+        key.u32(info->subpass);
+
+        *out = key.take();
+        return true;
+    }
+
+    // 计算 pipeline 只有一个 stage 和 layout，没有固定功能状态
+    bool computePipelineKey(const PipelineRegistry& registry, const VkComputePipelineCreateInfo* info,
+                            std::string* out) {
+        if (info->pNext != nullptr || (info->flags & VK_PIPELINE_CREATE_DERIVATIVE_BIT) != 0) {
+            return false;
+        }
+        std::string layoutKey;
+        if (!lookup(registry.pipelineLayouts, handleKey(info->layout), &layoutKey)) {
+            return false;
+        }
+
+        KeyBuilder key;
+        key.u32(VK_PIPELINE_BIND_POINT_COMPUTE);
+        key.u32(info->flags);
+        if (!addShaderStage(key, registry, info->stage)) return false;
+        key.str(layoutKey);
+
+        *out = key.take();
+        return true;
+    }
+
+    PipelineRegistry* getRegistry(DeviceInfo* deviceInfo) {
+        return deviceInfo ? deviceInfo->pipelineRegistry : nullptr;
+    }
+
+    // 图形和计算 pipeline 共用的查找/创建逻辑，调用时持有 lock；create 在锁外执行
+    template<typename Create>
+    VkResult acquireShared(PipelineRegistry* registry, std::unique_lock<std::mutex>& lock,
+                           const std::string& key, Create create, VkPipeline* pipeline) {
+        // 同一状态正在其他线程（后台编译）创建：等待它完成，只创建一次
+        auto it = registry->pipelines.find(key);
+        while (it != registry->pipelines.end() && it->second.pipeline == VK_NULL_HANDLE) {
+            registry->created.wait(lock);
+            it = registry->pipelines.find(key);
+        }
+        if (it != registry->pipelines.end()) {
+            it->second.refCount++;
+            registry->hits++;
+            *pipeline = it->second.pipeline;
+            LOGI("Pipeline registry hit: %p (refs=%u)", (void*)*pipeline, it->second.refCount);
+            return VK_SUCCESS;
+        }
+
+        // 先占位再释放锁：驱动编译可能要几十毫秒，期间其他线程可以继续登记对象、创建其他 pipeline
+        registry->pipelines.emplace(key, PipelineRegistry::Entry());
+        lock.unlock();
+
+        VkResult result = create(pipeline);
+
+        lock.lock();
+        if (result != VK_SUCCESS) {
+            registry->pipelines.erase(key);
+        } else {
+            registry->misses++;
+            PipelineRegistry::Entry& entry = registry->pipelines[key];
+            entry.pipeline = *pipeline;
+            entry.refCount = 1;
+            registry->pipelineKeys[handleKey(*pipeline)] = key;
+        }
+        registry->created.notify_all();
+        return result;
+    }
+
+} // anonymous namespace
+
+// ============================================
+// Lifetime
+// ============================================
+void createPipelineRegistry(DeviceInfo* deviceInfo) {
+    if (deviceInfo->pipelineRegistry == nullptr) {
+        deviceInfo->pipelineRegistry = new PipelineRegistry();
+    }
+}
+
+void destroyPipelineRegistry(DeviceInfo* deviceInfo) {
+    PipelineRegistry* registry = getRegistry(deviceInfo);
+    if (!registry) return;
+
+    uint32_t referenced = 0;
+    for (auto& entry : registry->pipelines) {
+        if (entry.second.refCount > 0) referenced++;
+        vkDestroyPipeline(deviceInfo->device, entry.second.pipeline, nullptr);
+    }
+    LOGI("Pipeline registry: %zu pipelines, %u hits, %u misses",
+         registry->pipelines.size(), registry->hits, registry->misses);
+    if (referenced > 0) {
+        LOGE("Pipeline registry: %u pipelines still referenced at device destruction", referenced);
+    }
+
+    delete registry;
+    deviceInfo->pipelineRegistry = nullptr;
+}
+
+// ============================================
+// Object Registration
+// ============================================
+void registerShaderModule(DeviceInfo* deviceInfo, VkShaderModule module, const uint32_t* code, size_t codeSize) {
+    PipelineRegistry* registry = getRegistry(deviceInfo);
+    if (!registry || module == VK_NULL_HANDLE) return;
+
+    KeyBuilder key;
+    const uint64_t hash = fnv1a64(reinterpret_cast<const uint8_t*>(code), codeSize);
+    key.bytes(&hash, sizeof(hash));
+    key.u32(static_cast<uint32_t>(codeSize));
+
+    std::lock_guard<std::mutex> lock(registry->mutex);
+    registry->shaderModules[handleKey(module)] = key.take();
+}
+
+void registerDescriptorSetLayout(DeviceInfo* deviceInfo, VkDescriptorSetLayout layout,
+                                 const VkDescriptorSetLayoutCreateInfo* createInfo) {
+    PipelineRegistry* registry = getRegistry(deviceInfo);
+    if (!registry || layout == VK_NULL_HANDLE) return;
+
+    // pNext 上只认 binding flags（bindless 表，见 Vulkanbindless.h），其他结构不登记
+    const VkDescriptorBindingFlagsEXT* bindingFlags = nullptr;
+    if (createInfo->pNext != nullptr) {
+        auto* next = static_cast<const VkBaseInStructure*>(createInfo->pNext);
+        if (next->sType != VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT ||
+            next->pNext != nullptr) {
+            return;
+        }
+        auto* flagsInfo = reinterpret_cast<const VkDescriptorSetLayoutBindingFlagsCreateInfoEXT*>(next);
+        if (flagsInfo->bindingCount != createInfo->bindingCount) return;
+        bindingFlags = flagsInfo->pBindingFlags;
+    }
+
+    // binding 的顺序不影响 layout 的定义；flags 与 binding 一一对应，随之排序
+    std::vector<std::pair<VkDescriptorSetLayoutBinding, VkDescriptorBindingFlagsEXT>> bindings;
+    for (uint32_t i = 0; i < createInfo->bindingCount; i++) {
+        bindings.emplace_back(createInfo->pBindings[i], bindingFlags ? bindingFlags[i] : 0);
+    }
+    std::sort(bindings.begin(), bindings.end(),
+              [](const std::pair<VkDescriptorSetLayoutBinding, VkDescriptorBindingFlagsEXT>& a,
+                 const std::pair<VkDescriptorSetLayoutBinding, VkDescriptorBindingFlagsEXT>& b) {
+                  return a.first.binding < b.first.binding;
+              });
+
+    KeyBuilder key;
+    key.u32(createInfo->flags);
+    key.u32(static_cast<uint32_t>(bindings.size()));
+    for (const auto& entry : bindings) {
+        const VkDescriptorSetLayoutBinding& binding = entry.first;
+        key.u32(entry.second);
+        key.u32(binding.binding);
+        key.u32(binding.descriptorType);
+        key.u32(binding.descriptorCount);
+        key.u32(binding.stageFlags);
+        key.flag(binding.pImmutableSamplers != nullptr);
+        if (binding.pImmutableSamplers == nullptr) continue;
+        // immutable sampler 会被固化进 pipeline，而 sampler 句柄销毁后可能被复用，不能按句柄比较：
+        // 只登记来自 sampler 缓存的 sampler，按其内容键比较
+        for (uint32_t i = 0; i < binding.descriptorCount; i++) {
+            std::string samplerKey;
+            if (!getSamplerKey(deviceInfo, binding.pImmutableSamplers[i], &samplerKey)) return;
+            key.str(samplerKey);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(registry->mutex);
+    registry->setLayouts[handleKey(layout)] = key.take();
+}
+
+void registerPipelineLayout(DeviceInfo* deviceInfo, VkPipelineLayout layout,
+                            const VkPipelineLayoutCreateInfo* createInfo) {
+    PipelineRegistry* registry = getRegistry(deviceInfo);
+    if (!registry || layout == VK_NULL_HANDLE || createInfo->pNext != nullptr) return;
+
+    std::lock_guard<std::mutex> lock(registry->mutex);
+
+    KeyBuilder key;
+    key.u32(createInfo->flags);
+    key.u32(createInfo->setLayoutCount);
+    for (uint32_t i = 0; i < createInfo->setLayoutCount; i++) {
+        std::string setLayoutKey;
+        if (!lookup(registry->setLayouts, handleKey(createInfo->pSetLayouts[i]), &setLayoutKey)) return;
+        key.str(setLayoutKey);
+    }
+    key.u32(createInfo->pushConstantRangeCount);
+    for (uint32_t i = 0; i < createInfo->pushConstantRangeCount; i++) {
+        const VkPushConstantRange& range = createInfo->pPushConstantRanges[i];
+        key.u32(range.stageFlags);
+        key.u32(range.offset);
+        key.u32(range.size);
+    }
+    registry->pipelineLayouts[handleKey(layout)] = key.take();
+}
+
+void registerRenderPass(DeviceInfo* deviceInfo, VkRenderPass renderPass,
+                        const VkRenderPassCreateInfo* createInfo) {
+    PipelineRegistry* registry = getRegistry(deviceInfo);
+    if (!registry || renderPass == VK_NULL_HANDLE || createInfo->pNext != nullptr) return;
+
+    std::string key = renderPassKey(createInfo);
+    std::lock_guard<std::mutex> lock(registry->mutex);
+    registry->renderPasses[handleKey(renderPass)] = std::move(key);
+}
+
+void unregisterShaderModule(DeviceInfo* deviceInfo, VkShaderModule module) {
+    PipelineRegistry* registry = getRegistry(deviceInfo);
+    if (!registry) return;
+    std::lock_guard<std::mutex> lock(registry->mutex);
+    registry->shaderModules.erase(handleKey(module));
+}
+
+void unregisterDescriptorSetLayout(DeviceInfo* deviceInfo, VkDescriptorSetLayout layout) {
+    PipelineRegistry* registry = getRegistry(deviceInfo);
+    if (!registry) return;
+    std::lock_guard<std::mutex> lock(registry->mutex);
+    registry->setLayouts.erase(handleKey(layout));
+}
+
+void unregisterPipelineLayout(DeviceInfo* deviceInfo, VkPipelineLayout layout) {
+    PipelineRegistry* registry = getRegistry(deviceInfo);
+    if (!registry) return;
+    std::lock_guard<std::mutex> lock(registry->mutex);
+    registry->pipelineLayouts.erase(handleKey(layout));
+}
+
+void unregisterRenderPass(DeviceInfo* deviceInfo, VkRenderPass renderPass) {
+    PipelineRegistry* registry = getRegistry(deviceInfo);
+    if (!registry) return;
+    std::lock_guard<std::mutex> lock(registry->mutex);
+    registry->renderPasses.erase(handleKey(renderPass));
+}
+
+// ============================================
+// Pipelines
+// ============================================
+VkResult acquireGraphicsPipeline(DeviceInfo* deviceInfo,
+                                 const VkGraphicsPipelineCreateInfo* createInfo,
+                                 VkPipeline* pipeline) {
+    PipelineRegistry* registry = getRegistry(deviceInfo);
+    if (!registry) {
+        return createGraphicsPipelineCached(deviceInfo, createInfo, pipeline);
+    }
+
+    std::unique_lock<std::mutex> lock(registry->mutex);
+
+    std::string key;
+    if (!pipelineKey(*registry, createInfo, &key)) {
+        lock.unlock();
+        LOGD("Pipeline state not shareable, creating private pipeline");
+        return createGraphicsPipelineCached(deviceInfo, createInfo, pipeline);
+    }
+
+    return acquireShared(registry, lock, key, [&](VkPipeline* created) {
+        return createGraphicsPipelineCached(deviceInfo, createInfo, created);
+    }, pipeline);
+}
+
+VkResult acquireComputePipeline(DeviceInfo* deviceInfo,
+                                const VkComputePipelineCreateInfo* createInfo,
+                                VkPipeline* pipeline) {
+    PipelineRegistry* registry = getRegistry(deviceInfo);
+    if (!registry) {
+        return createComputePipelineCached(deviceInfo, createInfo, pipeline);
+    }
+
+    std::unique_lock<std::mutex> lock(registry->mutex);
+
+    std::string key;
+    if (!computePipelineKey(*registry, createInfo, &key)) {
+        lock.unlock();
+        LOGD("Compute pipeline state not shareable, creating private pipeline");
+        return createComputePipelineCached(deviceInfo, createInfo, pipeline);
+    }
+
+    return acquireShared(registry, lock, key, [&](VkPipeline* created) {
+        return createComputePipelineCached(deviceInfo, createInfo, created);
+    }, pipeline);
+}
+
+void releaseGraphicsPipeline(DeviceInfo* deviceInfo, VkPipeline pipeline) {
+    if (pipeline == VK_NULL_HANDLE) return;
+
+    PipelineRegistry* registry = getRegistry(deviceInfo);
+    if (registry) {
+        std::lock_guard<std::mutex> lock(registry->mutex);
+        auto keyIt = registry->pipelineKeys.find(handleKey(pipeline));
+        if (keyIt != registry->pipelineKeys.end()) {
+            PipelineRegistry::Entry& entry = registry->pipelines[keyIt->second];
+            if (entry.refCount > 0) entry.refCount--;
+            // 引用计数归零也保留，销毁设备时统一释放
+            return;
+        }
+    }
+    vkDestroyPipeline(deviceInfo->device, pipeline, nullptr);
+}
+
+// ============================================
+// Specialization Constants
+// ============================================
+void SpecializationConstants::set(const int32_t* pairs, size_t count) {
+    entries.clear();
+    data.clear();
+    for (size_t i = 0; i + 1 < count; i += 2) {
+        VkSpecializationMapEntry entry{};
+        entry.constantID = static_cast<uint32_t>(pairs[i]);
+        entry.offset = static_cast<uint32_t>(data.size() * sizeof(uint32_t));
+        entry.size = sizeof(uint32_t);
+        entries.push_back(entry);
+        data.push_back(static_cast<uint32_t>(pairs[i + 1]));
+    }
+}
+
+const VkSpecializationInfo* SpecializationConstants::get() {
+    if (entries.empty()) return nullptr;
+    info_.mapEntryCount = static_cast<uint32_t>(entries.size());
+    info_.pMapEntries = entries.data();
+    info_.dataSize = data.size() * sizeof(uint32_t);
+    info_.pData = data.data();
+    return &info_;
+}
+
+// ============================================
+// Fullscreen Filter Pipeline
+// ============================================
+VkResult acquireFullscreenPipeline(DeviceInfo* deviceInfo,
+                                   VkRenderPass renderPass,
+                                   VkPipelineLayout pipelineLayout,
+                                   VkShaderModule vertShaderModule,
+                                   VkShaderModule fragShaderModule,
+                                   const VkSpecializationInfo* fragSpecialization,
+                                   VkPipeline* pipeline) {
+    VkPipelineShaderStageCreateInfo shaderStages[2]{};
+    shaderStages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    shaderStages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+    shaderStages[0].module = vertShaderModule;
+    shaderStages[0].pName = "main";
+    shaderStages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    shaderStages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+    shaderStages[1].module = fragShaderModule;
+    shaderStages[1].pName = "main";
+    shaderStages[1].pSpecializationInfo = fragSpecialization;
+
+    // 顶点在 shader 中生成，没有顶点输入
+    VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
+    vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+
+    VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
+    inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+    inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    inputAssembly.primitiveRestartEnable = VK_FALSE;
+
+    // viewport/scissor 为动态状态，这里只给数量
+    VkPipelineViewportStateCreateInfo viewportState{};
+    viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+    viewportState.viewportCount = 1;
+    viewportState.scissorCount = 1;
+
+    VkPipelineRasterizationStateCreateInfo rasterizer{};
+    rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+    rasterizer.depthClampEnable = VK_FALSE;
+    rasterizer.rasterizerDiscardEnable = VK_FALSE;
+    rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
+    rasterizer.lineWidth = 1.0f;
+    rasterizer.cullMode = VK_CULL_MODE_NONE;
+    rasterizer.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+    rasterizer.depthBiasEnable = VK_FALSE;
+
+    VkPipelineMultisampleStateCreateInfo multisampling{};
+    multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+    multisampling.sampleShadingEnable = VK_FALSE;
+    multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+    VkPipelineDepthStencilStateCreateInfo depthStencil{};
+    depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+    depthStencil.depthTestEnable = VK_FALSE;
+    depthStencil.depthWriteEnable = VK_FALSE;
+    depthStencil.stencilTestEnable = VK_FALSE;
+
+    VkPipelineColorBlendAttachmentState colorBlendAttachment{};
+    colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
+                                          VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+    colorBlendAttachment.blendEnable = VK_FALSE;
+
+    VkPipelineColorBlendStateCreateInfo colorBlending{};
+    colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+    colorBlending.logicOpEnable = VK_FALSE;
+    colorBlending.logicOp = VK_LOGIC_OP_COPY;
+    colorBlending.attachmentCount = 1;
+    colorBlending.pAttachments = &colorBlendAttachment;
+
+    VkDynamicState dynamicStates[] = {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
+    VkPipelineDynamicStateCreateInfo dynamicState{};
+    dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+    dynamicState.dynamicStateCount = 2;
+    dynamicState.pDynamicStates = dynamicStates;
+
+    VkGraphicsPipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    pipelineInfo.stageCount = 2;
+    pipelineInfo.pStages = shaderStages;
+    pipelineInfo.pVertexInputState = &vertexInputInfo;
+    pipelineInfo.pInputAssemblyState = &inputAssembly;
+    pipelineInfo.pViewportState = &viewportState;
+    pipelineInfo.pRasterizationState = &rasterizer;
+    pipelineInfo.pMultisampleState = &multisampling;
+    pipelineInfo.pDepthStencilState = &depthStencil;
+    pipelineInfo.pColorBlendState = &colorBlending;
+    pipelineInfo.pDynamicState = &dynamicState;
+    // renderPass 为空：动态渲染，按设备的颜色附件格式创建
+    VkPipelineRenderingCreateInfoKHR renderingInfo{};
+    renderingInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO_KHR;
+    renderingInfo.colorAttachmentCount = 1;
+    renderingInfo.pColorAttachmentFormats = &deviceInfo->colorFormat;
+
+    pipelineInfo.pNext = renderPass == VK_NULL_HANDLE ? &renderingInfo : nullptr;
+    pipelineInfo.layout = pipelineLayout;
+    pipelineInfo.renderPass = renderPass;
+    pipelineInfo.subpass = 0;
+    pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
+
+    return acquireGraphicsPipeline(deviceInfo, &pipelineInfo, pipeline);
+}
+
+
+// ============================================
+// Compute Filter Pipeline
+// ============================================
+VkResult acquireComputeShaderPipeline(DeviceInfo* deviceInfo,
+                                      VkPipelineLayout pipelineLayout,
+                                      VkShaderModule computeShaderModule,
+                                      const VkSpecializationInfo* specialization,
+                                      VkPipeline* pipeline) {
+    VkComputePipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    pipelineInfo.stage.module = computeShaderModule;
+    pipelineInfo.stage.pName = "main";
+    pipelineInfo.stage.pSpecializationInfo = specialization;
+    pipelineInfo.layout = pipelineLayout;
+    pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
+    pipelineInfo.basePipelineIndex = -1;
+
+    return acquireComputePipeline(deviceInfo, &pipelineInfo, pipeline);
+}
@@ -0,0 +1,93 @@
+//
+// Pipeline registry: identical graphics and compute pipelines are created once per device and shared.
+//
+// 键由对象“内容”组成而不是句柄：SPIR-V 哈希、descriptor set / pipeline layout 的定义、
+// render pass 的兼容性信息（附件格式/采样数、subpass、依赖），以及所有固定功能状态
+// （光栅化、混合、动态状态等）。因此两个滤镜各自创建的 shader module / layout 只要内容相同，
+// 就会拿到同一个 VkPipeline（引用计数）。
+//
+// 引用计数归零的 pipeline 不立即销毁，保留到设备销毁：同一设备上滤镜重新 init 时直接复用，
+// 不再调用 vkCreateGraphicsPipelines。
+// 限制：registry 属于 VkDevice，而 runner 重启时会连同 instance / surface 一起重建设备，
+// registry 也随之销毁，所以重启后仍会调用 vkCreateGraphicsPipelines。跨重启的复用只来自持久化的
+// VkPipelineCache（Vulkanpipelinecache.h）：驱动命中缓存时跳过着色器编译，日志记为 "warm cache hit"。
+//
+// 参与组键的对象必须通过 register* 登记，并在销毁前 unregister*；
+// 使用未登记对象的 pipeline 不共享，release 时直接销毁。
+//
+#ifndef VULKAN_PIPELINE_REGISTRY_H
+#define VULKAN_PIPELINE_REGISTRY_H
+
+#include <vulkan/vulkan.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Vulkantypes.h"
+
+// 特化常量：Kotlin 端以 [id0, value0, id1, value1, ...] 传入，每个值 4 字节
+// （int、VkBool32 或 float 的位模式）。常量值是 pipeline 键的一部分，不同变体分别创建、分别共享。
+struct SpecializationConstants {
+    std::vector<VkSpecializationMapEntry> entries;
+    std::vector<uint32_t> data;
+
+    void set(const int32_t* pairs, size_t count);
+
+    // 没有常量时返回 nullptr；返回的指针在本对象被修改或销毁前有效
+    const VkSpecializationInfo* get();
+
+private:
+    VkSpecializationInfo info_{};
+};
+
+// 创建设备后调用
+void createPipelineRegistry(DeviceInfo* deviceInfo);
+
+// 销毁所有 pipeline（包括仍被引用的），vkDestroyDevice 之前调用
+void destroyPipelineRegistry(DeviceInfo* deviceInfo);
+
+void registerShaderModule(DeviceInfo* deviceInfo, VkShaderModule module, const uint32_t* code, size_t codeSize);
+void registerDescriptorSetLayout(DeviceInfo* deviceInfo, VkDescriptorSetLayout layout,
+                                 const VkDescriptorSetLayoutCreateInfo* createInfo);
+void registerPipelineLayout(DeviceInfo* deviceInfo, VkPipelineLayout layout,
+                            const VkPipelineLayoutCreateInfo* createInfo);
+void registerRenderPass(DeviceInfo* deviceInfo, VkRenderPass renderPass,
+                        const VkRenderPassCreateInfo* createInfo);
+
+void unregisterShaderModule(DeviceInfo* deviceInfo, VkShaderModule module);
+void unregisterDescriptorSetLayout(DeviceInfo* deviceInfo, VkDescriptorSetLayout layout);
+void unregisterPipelineLayout(DeviceInfo* deviceInfo, VkPipelineLayout layout);
+void unregisterRenderPass(DeviceInfo* deviceInfo, VkRenderPass renderPass);
+
+// 查找或创建 pipeline，引用计数 +1
+VkResult acquireGraphicsPipeline(DeviceInfo* deviceInfo,
+                                 const VkGraphicsPipelineCreateInfo* createInfo,
+                                 VkPipeline* pipeline);
+
+// 计算 pipeline：键为 shader stage（含特化常量）和 pipeline layout
+VkResult acquireComputePipeline(DeviceInfo* deviceInfo,
+                                const VkComputePipelineCreateInfo* createInfo,
+                                VkPipeline* pipeline);
+
+// 引用计数 -1；不是由 registry 共享的 pipeline 直接销毁。计算 pipeline 同样由这里释放
+void releaseGraphicsPipeline(DeviceInfo* deviceInfo, VkPipeline pipeline);
+
+// 全屏三角形滤镜的标准 pipeline：无顶点输入、无混合、viewport/scissor 为动态状态。
+// renderPass 为 VK_NULL_HANDLE 时用于动态渲染（颜色附件格式取 DeviceInfo::colorFormat）。
+// 各滤镜的 nativeCreateGraphicsPipeline 都通过这里创建，不再各自拼装固定功能状态。
+// fragSpecialization 可以为 nullptr（使用 shader 中的默认值）
+VkResult acquireFullscreenPipeline(DeviceInfo* deviceInfo,
+                                   VkRenderPass renderPass,
+                                   VkPipelineLayout pipelineLayout,
+                                   VkShaderModule vertShaderModule,
+                                   VkShaderModule fragShaderModule,
+                                   const VkSpecializationInfo* fragSpecialization,
+                                   VkPipeline* pipeline);
+
+// 计算滤镜的 pipeline，入口为 main；specialization 可以为 nullptr
+VkResult acquireComputeShaderPipeline(DeviceInfo* deviceInfo,
+                                      VkPipelineLayout pipelineLayout,
+                                      VkShaderModule computeShaderModule,
+                                      const VkSpecializationInfo* specialization,
+                                      VkPipeline* pipeline);
+
+#endif // VULKAN_PIPELINE_REGISTRY_H
@@ -0,0 +1,635 @@
+//
+// Per-pass GPU profiler: timestamp query ring per frame in flight, rolling min/avg/p99 per scope.
+//
+#include "Vulkanjni.h"
+#include "Vulkanprofiler.h"
+#include "Vulkantracegpu.h"
+#include "Vulkanframestats.h"
+#include "Vulkanshaderstats.h"
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace VulkanJNI;
+
+struct GpuProfiler {
+    float timestampPeriod = 0.0f;  // 每个 tick 的纳秒数
+    uint64_t timestampMask = ~0ull;
+
+    // 一次 scope：query、query + 1 为开始/结束 timestamp
+    struct Occurrence {
+        int32_t scopeId = -1;
+        uint32_t query = 0;
+        int32_t statisticsQuery = -1;  // 带 pipeline 统计查询时为 statisticsPool 中的下标
+        bool ended = false;
+    };
+
+    struct QuerySlot {
+        VkQueryPool pool = VK_NULL_HANDLE;
+        std::vector<Occurrence> occurrences;
+        bool pending = false;  // 已提交、结果还没读取
+
+        // pipeline 统计查询（见 Vulkanshaderstats.h），只有帧槽位有；同一时刻最多一个处于活动状态
+        VkQueryPool statisticsPool = VK_NULL_HANDLE;
+        uint32_t statisticsUsed = 0;
+        int32_t statisticsOpen = -1;  // 活动查询所属的 occurrence
+    };
+    std::vector<QuerySlot> frames;  // 每个 in-flight 帧一个
+    QuerySlot immediate;            // 单独提交并等待完成的命令缓冲
+    int32_t currentFrame = -1;      // 正在录制的槽位，不在帧内时为 -1
+    int32_t frameScope = -1;
+    int32_t frameToken = -1;
+    bool overflowReported = false;
+
+    // trace 的 GPU 轨道：设备时钟 ↔ CLOCK_MONOTONIC 的对应点（见 Vulkantracegpu.h）
+    uint64_t calibrationTicks = 0;
+    uint64_t calibrationCpuNs = 0;
+    uint64_t calibratedAtNs = 0;
+
+    // 统计（getGpuProfilerStats 可能在其他线程读取）
+    std::mutex mutex;
+    struct Scope {
+        std::string name;
+        const char* traceName = nullptr;  // trace 事件名（traceInternName）
+        float samples[kGpuProfilerWindow] = {};
+        uint32_t count = 0;  // 有效样本数（≤ kGpuProfilerWindow）
+        uint32_t next = 0;   // 下一个写入位置
+        double pendingMs = 0.0;
+        bool seen = false;   // 本次收集中出现过
+
+        // pipeline 统计：外层 scope 不收集（同类查询不能嵌套）
+        bool statistics = true;
+        uint64_t statisticSamples[kGpuProfilerWindow][kShaderStatisticsCounters] = {};
+        uint32_t statisticCount = 0;
+        uint32_t statisticNext = 0;
+        uint64_t pendingStatistics[kShaderStatisticsCounters] = {};
+        bool statisticsSeen = false;
+    };
+    std::vector<Scope> scopes;
+    std::unordered_map<std::string, int32_t> scopeIds;
+    uint64_t collectedFrames = 0;
+};
+
+namespace {
+
+    // 每个槽位的 timestamp 数（两个一组）；超过时多出的 scope 不计时
+    constexpr uint32_t kQueriesPerSlot = 128;
+
+    // 每个槽位的 pipeline 统计查询数
+    constexpr uint32_t kStatisticsQueriesPerSlot = 32;
+
+    // 记录 trace 期间重新校准 GPU 时钟的间隔（两个时钟会漂移）
+    constexpr uint64_t kCalibrationIntervalNs = 1000000000ull;
+
+    GpuProfiler* getProfiler(DeviceInfo* deviceInfo) {
+        return deviceInfo ? deviceInfo->gpuProfiler : nullptr;
+    }
+
+    bool createQueryPool(DeviceInfo* deviceInfo, VkQueryPool* pool,
+                         VkQueryType type = VK_QUERY_TYPE_TIMESTAMP, uint32_t count = kQueriesPerSlot) {
+        VkQueryPoolCreateInfo queryPoolInfo{};
+        queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        queryPoolInfo.queryType = type;
+        queryPoolInfo.queryCount = count;
+        if (type == VK_QUERY_TYPE_PIPELINE_STATISTICS) {
+            queryPoolInfo.pipelineStatistics = kShaderStatisticsFlags;
+        }
+
+        VkResult result = vkCreateQueryPool(deviceInfo->device, &queryPoolInfo, nullptr, pool);
+        if (!validateResult(result, "vkCreateQueryPool (profiler)")) {
+            *pool = VK_NULL_HANDLE;
+            return false;
+        }
+        return true;
+    }
+
+    int32_t registerScope(GpuProfiler* profiler, const std::string& name, bool statistics) {
+        std::lock_guard<std::mutex> lock(profiler->mutex);
+        auto it = profiler->scopeIds.find(name);
+        if (it != profiler->scopeIds.end()) return it->second;
+
+        const auto id = static_cast<int32_t>(profiler->scopes.size());
+        profiler->scopes.emplace_back();
+        profiler->scopes.back().name = name;
+        profiler->scopes.back().traceName = traceInternName(name.c_str());
+        profiler->scopes.back().statistics = statistics;
+        profiler->scopeIds.emplace(name, id);
+        return id;
+    }
+
+    bool scopeWantsStatistics(GpuProfiler* profiler, int32_t scopeId) {
+        std::lock_guard<std::mutex> lock(profiler->mutex);
+        return profiler->scopes[scopeId].statistics;
+    }
+
+    int32_t writeBegin(GpuProfiler* profiler, GpuProfiler::QuerySlot* slot, VkCommandBuffer commandBuffer,
+                       int32_t scopeId) {
+        const auto query = static_cast<uint32_t>(slot->occurrences.size() * 2);
+        if (query + 2 > kQueriesPerSlot) {
+            if (!profiler->overflowReported) {
+                profiler->overflowReported = true;
+                LOGE("GPU profiler: more than %u scopes in one frame, extra scopes are not timed", kQueriesPerSlot / 2);
+            }
+            return -1;
+        }
+
+        GpuProfiler::Occurrence occurrence;
+        occurrence.scopeId = scopeId;
+        occurrence.query = query;
+        slot->occurrences.push_back(occurrence);
+        const auto token = static_cast<int32_t>(slot->occurrences.size() - 1);
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, slot->pool, query);
+
+        if (slot->statisticsPool != VK_NULL_HANDLE && slot->statisticsOpen < 0 &&
+            slot->statisticsUsed < kStatisticsQueriesPerSlot && scopeWantsStatistics(profiler, scopeId)) {
+            const uint32_t statisticsQuery = slot->statisticsUsed++;
+            vkCmdBeginQuery(commandBuffer, slot->statisticsPool, statisticsQuery, 0);
+            slot->occurrences.back().statisticsQuery = static_cast<int32_t>(statisticsQuery);
+            slot->statisticsOpen = token;
+        }
+        return token;
+    }
+
+    void writeEnd(GpuProfiler::QuerySlot* slot, VkCommandBuffer commandBuffer, int32_t token) {
+        if (token < 0 || static_cast<size_t>(token) >= slot->occurrences.size()) return;
+        GpuProfiler::Occurrence& occurrence = slot->occurrences[token];
+        if (occurrence.ended) return;
+        if (occurrence.statisticsQuery >= 0 && slot->statisticsOpen == token) {
+            vkCmdEndQuery(commandBuffer, slot->statisticsPool, static_cast<uint32_t>(occurrence.statisticsQuery));
+            slot->statisticsOpen = -1;
+        }
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, slot->pool, occurrence.query + 1);
+        occurrence.ended = true;
+    }
+
+    // 记录 trace 时按需校准；返回 false 时不输出 GPU 事件
+    bool updateCalibration(DeviceInfo* deviceInfo, GpuProfiler* profiler) {
+        if (!traceEnabled() || !deviceInfo->getCalibratedTimestamps) return false;
+        const uint64_t now = traceNowNs();
+        if (profiler->calibratedAtNs == 0 || now - profiler->calibratedAtNs > kCalibrationIntervalNs) {
+            if (!calibrateGpuClock(deviceInfo, &profiler->calibrationTicks, &profiler->calibrationCpuNs)) {
+                return false;
+            }
+            profiler->calibratedAtNs = now;
+        }
+        return true;
+    }
+
+    // 设备 timestamp → CLOCK_MONOTONIC 纳秒；差值按有效位回绕，可以早于校准点
+    uint64_t gpuTicksToCpuNs(const GpuProfiler* profiler, uint64_t ticks) {
+        const uint64_t mask = profiler->timestampMask;
+        auto delta = static_cast<int64_t>((ticks - profiler->calibrationTicks) & mask);
+        if (mask != ~0ull && static_cast<uint64_t>(delta) > mask / 2) {
+            delta -= static_cast<int64_t>(mask) + 1;
+        }
+        return profiler->calibrationCpuNs +
+               static_cast<int64_t>(static_cast<double>(delta) * profiler->timestampPeriod);
+    }
+
+    void pushSample(GpuProfiler::Scope* scope, double ms) {
+        scope->samples[scope->next] = static_cast<float>(ms);
+        scope->next = (scope->next + 1) % kGpuProfilerWindow;
+        scope->count = std::min(scope->count + 1, kGpuProfilerWindow);
+    }
+
+    void pushStatistics(GpuProfiler::Scope* scope) {
+        std::copy(scope->pendingStatistics, scope->pendingStatistics + kShaderStatisticsCounters,
+                  scope->statisticSamples[scope->statisticNext]);
+        scope->statisticNext = (scope->statisticNext + 1) % kGpuProfilerWindow;
+        scope->statisticCount = std::min(scope->statisticCount + 1, kGpuProfilerWindow);
+    }
+
+    // 读取帧槽位的 pipeline 统计查询，累加到各 scope（调用方持有 profiler->mutex）
+    void collectStatistics(DeviceInfo* deviceInfo, GpuProfiler* profiler, GpuProfiler::QuerySlot* slot) {
+        if (slot->statisticsUsed == 0) return;
+
+        // 每个查询 kShaderStatisticsCounters 个计数 + 可用标志
+        constexpr uint32_t kStride = kShaderStatisticsCounters + 1;
+        uint64_t results[kStatisticsQueriesPerSlot * kStride] = {};
+        VkResult result = vkGetQueryPoolResults(
+                deviceInfo->device, slot->statisticsPool, 0, slot->statisticsUsed,
+                sizeof(results), results, kStride * sizeof(uint64_t),
+                VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+        slot->statisticsUsed = 0;
+        if (result != VK_SUCCESS && result != VK_NOT_READY) {
+            LOGE("GPU profiler: pipeline statistics query failed: %d", result);
+            return;
+        }
+
+        for (const GpuProfiler::Occurrence& occurrence : slot->occurrences) {
+            if (occurrence.statisticsQuery < 0 || !occurrence.ended) continue;
+            const uint64_t* counters = &results[occurrence.statisticsQuery * kStride];
+            if (counters[kShaderStatisticsCounters] == 0) continue;
+            GpuProfiler::Scope& scope = profiler->scopes[occurrence.scopeId];
+            for (uint32_t i = 0; i < kShaderStatisticsCounters; i++) {
+                scope.pendingStatistics[i] += counters[i];
+            }
+            scope.statisticsSeen = true;
+        }
+    }
+
+    // 读取已完成的查询；同名 scope 的多次出现累加为一个样本。不带 WAIT：结果不可用的 scope 直接丢弃
+    void collectSlot(DeviceInfo* deviceInfo, GpuProfiler* profiler, GpuProfiler::QuerySlot* slot) {
+        if (!slot->pending || slot->occurrences.empty()) {
+            slot->occurrences.clear();
+            slot->pending = false;
+            return;
+        }
+
+        // 每个 query 两个 uint64：值 + 可用标志
+        const auto queryCount = static_cast<uint32_t>(slot->occurrences.size() * 2);
+        std::vector<uint64_t> results(queryCount * 2, 0);
+        VkResult result = vkGetQueryPoolResults(
+                deviceInfo->device, slot->pool, 0, queryCount,
+                results.size() * sizeof(uint64_t), results.data(), 2 * sizeof(uint64_t),
+                VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+        if (result != VK_SUCCESS && result != VK_NOT_READY) {
+            LOGE("GPU profiler: vkGetQueryPoolResults failed: %d", result);
+            slot->occurrences.clear();
+            slot->pending = false;
+            return;
+        }
+
+        const double msPerTick = static_cast<double>(profiler->timestampPeriod) / 1e6;
+        const bool trace = updateCalibration(deviceInfo, profiler);
+        std::lock_guard<std::mutex> lock(profiler->mutex);
+        collectStatistics(deviceInfo, profiler, slot);
+        for (const GpuProfiler::Occurrence& occurrence : slot->occurrences) {
+            const uint64_t* begin = &results[occurrence.query * 2];
+            const uint64_t* end = &results[(occurrence.query + 1) * 2];
+            if (!occurrence.ended || begin[1] == 0 || end[1] == 0) continue;
+
+            const uint64_t ticks = ((end[0] & profiler->timestampMask) - (begin[0] & profiler->timestampMask)) &
+                                   profiler->timestampMask;
+            GpuProfiler::Scope& scope = profiler->scopes[occurrence.scopeId];
+            scope.pendingMs += static_cast<double>(ticks) * msPerTick;
+            scope.seen = true;
+
+            if (trace) {
+                const uint64_t beginNs = gpuTicksToCpuNs(profiler, begin[0]);
+                traceGpuEvent(scope.traceName, beginNs, beginNs + static_cast<uint64_t>(
+                        static_cast<double>(ticks) * profiler->timestampPeriod));
+            }
+        }
+        const GpuProfiler::Scope& frame = profiler->scopes[profiler->frameScope];
+        if (frame.seen && slot != &profiler->immediate) {
+            frameStatsGpuTime(deviceInfo, frame.pendingMs);
+        }
+        for (GpuProfiler::Scope& scope : profiler->scopes) {
+            if (scope.statisticsSeen) {
+                pushStatistics(&scope);
+                std::fill(scope.pendingStatistics, scope.pendingStatistics + kShaderStatisticsCounters, 0);
+                scope.statisticsSeen = false;
+            }
+            if (!scope.seen) continue;
+            pushSample(&scope, scope.pendingMs);
+            scope.pendingMs = 0.0;
+            scope.seen = false;
+        }
+
+        slot->occurrences.clear();
+        slot->pending = false;
+    }
+
+    GpuScopeStats computeStats(const GpuProfiler::Scope& scope) {
+        GpuScopeStats stats;
+        stats.name = scope.name;
+        stats.samples = scope.count;
+        if (scope.count == 0) return stats;
+
+        std::vector<float> sorted(scope.samples, scope.samples + scope.count);
+        std::sort(sorted.begin(), sorted.end());
+        double sum = 0.0;
+        for (float sample : sorted) sum += sample;
+
+        const uint32_t last = (scope.next + kGpuProfilerWindow - 1) % kGpuProfilerWindow;
+        const auto p99Index = static_cast<size_t>(std::ceil(0.99 * scope.count)) - 1;
+        stats.lastMs = scope.samples[last];
+        stats.minMs = sorted.front();
+        stats.avgMs = sum / scope.count;
+        stats.p99Ms = sorted[std::min(p99Index, sorted.size() - 1)];
+
+        stats.statisticsSamples = scope.statisticCount;
+        if (scope.statisticCount > 0) {
+            double sums[kShaderStatisticsCounters] = {};
+            for (uint32_t i = 0; i < scope.statisticCount; i++) {
+                for (uint32_t j = 0; j < kShaderStatisticsCounters; j++) {
+                    sums[j] += static_cast<double>(scope.statisticSamples[i][j]);
+                }
+            }
+            // 与 kShaderStatisticsFlags 的位顺序一致
+            stats.clippingPrimitives = sums[0] / scope.statisticCount;
+            stats.fragmentInvocations = sums[1] / scope.statisticCount;
+            stats.computeInvocations = sums[2] / scope.statisticCount;
+        }
+        return stats;
+    }
+
+    void logStats(GpuProfiler* profiler) {
+        std::lock_guard<std::mutex> lock(profiler->mutex);
+        for (const GpuProfiler::Scope& scope : profiler->scopes) {
+            if (scope.count == 0) continue;
+            GpuScopeStats stats = computeStats(scope);
+            if (stats.statisticsSamples > 0) {
+                LOGI("GPU %-16s min %.3f avg %.3f p99 %.3f ms (%u frames), avg frag %.0f comp %.0f clip prims %.0f",
+                     stats.name.c_str(), stats.minMs, stats.avgMs, stats.p99Ms, stats.samples,
+                     stats.fragmentInvocations, stats.computeInvocations, stats.clippingPrimitives);
+            } else {
+                LOGI("GPU %-16s min %.3f avg %.3f p99 %.3f ms (%u frames)",
+                     stats.name.c_str(), stats.minMs, stats.avgMs, stats.p99Ms, stats.samples);
+            }
+        }
+    }
+
+} // anonymous namespace
+
+// ============================================
+// Lifetime
+// ============================================
+bool enableGpuProfiler(DeviceInfo* deviceInfo, uint32_t framesInFlight) {
+    if (deviceInfo->gpuProfiler != nullptr) return true;
+    if (framesInFlight == 0) return false;
+
+    uint32_t queueFamilyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(deviceInfo->physicalDevice, &queueFamilyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(deviceInfo->physicalDevice, &queueFamilyCount, queueFamilies.data());
+    if (deviceInfo->graphicsQueueFamily >= queueFamilyCount ||
+        queueFamilies[deviceInfo->graphicsQueueFamily].timestampValidBits == 0) {
+        LOGE("GPU profiler: timestamps not supported on graphics queue");
+        return false;
+    }
+    const uint32_t validBits = queueFamilies[deviceInfo->graphicsQueueFamily].timestampValidBits;
+
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(deviceInfo->physicalDevice, &properties);
+
+    auto* profiler = new GpuProfiler();
+    profiler->timestampPeriod = properties.limits.timestampPeriod;
+    profiler->timestampMask = validBits >= 64 ? ~0ull : (1ull << validBits) - 1;
+    profiler->frames.resize(framesInFlight);
+    bool ok = createQueryPool(deviceInfo, &profiler->immediate.pool);
+    const bool statistics = pipelineStatisticsEnabled(deviceInfo);
+    for (GpuProfiler::QuerySlot& slot : profiler->frames) {
+        ok = ok && createQueryPool(deviceInfo, &slot.pool);
+        if (statistics) {
+            ok = ok && createQueryPool(deviceInfo, &slot.statisticsPool,
+                                       VK_QUERY_TYPE_PIPELINE_STATISTICS, kStatisticsQueriesPerSlot);
+        }
+    }
+    deviceInfo->gpuProfiler = profiler;
+    if (!ok) {
+        destroyGpuProfiler(deviceInfo);
+        return false;
+    }
+
+    profiler->frameScope = registerScope(profiler, "frame", false);
+    LOGI("✓ GPU profiler enabled: %u frames in flight, %.2f ns/tick, %u valid bits, pipeline statistics %s",
+         framesInFlight, profiler->timestampPeriod, validBits, statistics ? "on" : "off");
+    return true;
+}
+
+void destroyGpuProfiler(DeviceInfo* deviceInfo) {
+    GpuProfiler* profiler = getProfiler(deviceInfo);
+    if (!profiler) return;
+
+    logStats(profiler);
+    for (GpuProfiler::QuerySlot& slot : profiler->frames) {
+        if (slot.pool != VK_NULL_HANDLE) vkDestroyQueryPool(deviceInfo->device, slot.pool, nullptr);
+        if (slot.statisticsPool != VK_NULL_HANDLE) vkDestroyQueryPool(deviceInfo->device, slot.statisticsPool, nullptr);
+    }
+    if (profiler->immediate.pool != VK_NULL_HANDLE) {
+        vkDestroyQueryPool(deviceInfo->device, profiler->immediate.pool, nullptr);
+    }
+    delete profiler;
+    deviceInfo->gpuProfiler = nullptr;
+}
+
+// ============================================
+// Frames
+// ============================================
+void beginGpuProfilerFrame(DeviceInfo* deviceInfo, VkCommandBuffer commandBuffer, uint32_t frameSlot) {
+    GpuProfiler* profiler = getProfiler(deviceInfo);
+    if (!profiler || frameSlot >= profiler->frames.size()) return;
+
+    // 该槽位的 fence 已经等待过，上一次提交的查询全部完成
+    GpuProfiler::QuerySlot& slot = profiler->frames[frameSlot];
+    const bool collected = slot.pending;
+    collectSlot(deviceInfo, profiler, &slot);
+    if (collected && ++profiler->collectedFrames % kGpuProfilerLogInterval == 0) {
+        logStats(profiler);
+    }
+
+    // query reset 必须在 render pass 之外
+    vkCmdResetQueryPool(commandBuffer, slot.pool, 0, kQueriesPerSlot);
+    if (slot.statisticsPool != VK_NULL_HANDLE) {
+        vkCmdResetQueryPool(commandBuffer, slot.statisticsPool, 0, kStatisticsQueriesPerSlot);
+        slot.statisticsUsed = 0;
+        slot.statisticsOpen = -1;
+    }
+    profiler->currentFrame = static_cast<int32_t>(frameSlot);
+    profiler->frameToken = writeBegin(profiler, &slot, commandBuffer, profiler->frameScope);
+}
+
+void endGpuProfilerFrame(DeviceInfo* deviceInfo, VkCommandBuffer commandBuffer) {
+    GpuProfiler* profiler = getProfiler(deviceInfo);
+    if (!profiler || profiler->currentFrame < 0) return;
+
+    GpuProfiler::QuerySlot& slot = profiler->frames[profiler->currentFrame];
+    // 没有配对结束的统计查询（录制提前返回）必须在命令缓冲结束前关闭
+    if (slot.statisticsOpen >= 0) {
+        writeEnd(&slot, commandBuffer, slot.statisticsOpen);
+    }
+    writeEnd(&slot, commandBuffer, profiler->frameToken);
+    slot.pending = true;
+    profiler->currentFrame = -1;
+    profiler->frameToken = -1;
+}
+
+// ============================================
+// Scopes
+// ============================================
+int32_t gpuScopeId(DeviceInfo* deviceInfo, const char* name, bool statistics) {
+    GpuProfiler* profiler = getProfiler(deviceInfo);
+    if (!profiler || !name) return -1;
+    return registerScope(profiler, name, statistics);
+}
+
+int32_t beginGpuScope(DeviceInfo* deviceInfo, VkCommandBuffer commandBuffer, int32_t scopeId) {
+    GpuProfiler* profiler = getProfiler(deviceInfo);
+    if (!profiler || profiler->currentFrame < 0 || scopeId < 0) return -1;
+    return writeBegin(profiler, &profiler->frames[profiler->currentFrame], commandBuffer, scopeId);
+}
+
+void endGpuScope(DeviceInfo* deviceInfo, VkCommandBuffer commandBuffer, int32_t token) {
+    GpuProfiler* profiler = getProfiler(deviceInfo);
+    if (!profiler || profiler->currentFrame < 0) return;
+    writeEnd(&profiler->frames[profiler->currentFrame], commandBuffer, token);
+}
+
+int32_t beginImmediateGpuScope(DeviceInfo* deviceInfo, VkCommandBuffer commandBuffer, int32_t scopeId) {
+    GpuProfiler* profiler = getProfiler(deviceInfo);
+    if (!profiler || scopeId < 0) return -1;
+
+    GpuProfiler::QuerySlot& slot = profiler->immediate;
+    const auto query = static_cast<uint32_t>(slot.occurrences.size() * 2);
+    if (query + 2 <= kQueriesPerSlot) {
+        vkCmdResetQueryPool(commandBuffer, slot.pool, query, 2);
+    }
+    return writeBegin(profiler, &slot, commandBuffer, scopeId);
+}
+
+void endImmediateGpuScope(DeviceInfo* deviceInfo, VkCommandBuffer commandBuffer, int32_t token) {
+    GpuProfiler* profiler = getProfiler(deviceInfo);
+    if (!profiler) return;
+    writeEnd(&profiler->immediate, commandBuffer, token);
+    profiler->immediate.pending = true;
+}
+
+void collectImmediateGpuScopes(DeviceInfo* deviceInfo) {
+    GpuProfiler* profiler = getProfiler(deviceInfo);
+    if (!profiler) return;
+    collectSlot(deviceInfo, profiler, &profiler->immediate);
+}
+
+bool getGpuProfilerStats(DeviceInfo* deviceInfo, std::vector<GpuScopeStats>* stats) {
+    GpuProfiler* profiler = getProfiler(deviceInfo);
+    if (!profiler) return false;
+
+    std::lock_guard<std::mutex> lock(profiler->mutex);
+    stats->clear();
+    for (const GpuProfiler::Scope& scope : profiler->scopes) {
+        stats->push_back(computeStats(scope));
+    }
+    return true;
+}
+
+// ============================================
+// JNI: VulkanRunner
+// ============================================
+
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeEnableGpuProfiler(
+        JNIEnv* env, jobject /* this */, jlong deviceHandle, jint framesInFlight) {
+
+    DeviceInfo* deviceInfo = getDeviceInfo(deviceHandle);
+    if (!validateHandle(deviceInfo, "device") || framesInFlight <= 0) {
+        return JNI_FALSE;
+    }
+    return enableGpuProfiler(deviceInfo, static_cast<uint32_t>(framesInFlight)) ? JNI_TRUE : JNI_FALSE;
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeBeginGpuFrame(
+        JNIEnv* env, jobject /* this */, jlong deviceHandle, jlong commandBufferHandle, jint frameSlot) {
+
+    DeviceInfo* deviceInfo = getDeviceInfo(deviceHandle);
+    VkCommandBuffer commandBuffer = fromHandle<VkCommandBuffer>(commandBufferHandle);
+    if (deviceInfo && commandBuffer && frameSlot >= 0) {
+        beginGpuProfilerFrame(deviceInfo, commandBuffer, static_cast<uint32_t>(frameSlot));
+    }
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeEndGpuFrame(
+        JNIEnv* env, jobject /* this */, jlong deviceHandle, jlong commandBufferHandle) {
+
+    DeviceInfo* deviceInfo = getDeviceInfo(deviceHandle);
+    VkCommandBuffer commandBuffer = fromHandle<VkCommandBuffer>(commandBufferHandle);
+    if (deviceInfo && commandBuffer) {
+        endGpuProfilerFrame(deviceInfo, commandBuffer);
+    }
+}
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeGpuScopeId(
+        JNIEnv* env, jobject /* this */, jlong deviceHandle, jstring name, jboolean statistics) {
+
+    DeviceInfo* deviceInfo = getDeviceInfo(deviceHandle);
+    if (!deviceInfo || !name) {
+        return -1;
+    }
+    const char* chars = env->GetStringUTFChars(name, nullptr);
+    const int32_t id = gpuScopeId(deviceInfo, chars, statistics == JNI_TRUE);
+    env->ReleaseStringUTFChars(name, chars);
+    return id;
+}
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeBeginGpuScope(
+        JNIEnv* env, jobject /* this */, jlong deviceHandle, jlong commandBufferHandle, jint scopeId) {
+
+    DeviceInfo* deviceInfo = getDeviceInfo(deviceHandle);
+    VkCommandBuffer commandBuffer = fromHandle<VkCommandBuffer>(commandBufferHandle);
+    if (!deviceInfo || !commandBuffer) {
+        return -1;
+    }
+    return beginGpuScope(deviceInfo, commandBuffer, scopeId);
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeEndGpuScope(
+        JNIEnv* env, jobject /* this */, jlong deviceHandle, jlong commandBufferHandle, jint token) {
+
+    DeviceInfo* deviceInfo = getDeviceInfo(deviceHandle);
+    VkCommandBuffer commandBuffer = fromHandle<VkCommandBuffer>(commandBufferHandle);
+    if (deviceInfo && commandBuffer) {
+        endGpuScope(deviceInfo, commandBuffer, token);
+    }
+}
+
+// 按登记顺序的 scope 名字；与 nativeGetGpuProfileValues 的顺序一致（scope 只会追加）
+extern "C" JNIEXPORT jobjectArray JNICALL
+Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeGetGpuProfileNames(
+        JNIEnv* env, jobject /* this */, jlong deviceHandle) {
+
+    DeviceInfo* deviceInfo = getDeviceInfo(deviceHandle);
+    std::vector<GpuScopeStats> stats;
+    if (!deviceInfo || !getGpuProfilerStats(deviceInfo, &stats)) {
+        return nullptr;
+    }
+
+    jclass stringClass = env->FindClass("java/lang/String");
+    jobjectArray names = env->NewObjectArray(static_cast<jsize>(stats.size()), stringClass, nullptr);
+    for (size_t i = 0; names && i < stats.size(); i++) {
+        jstring name = env->NewStringUTF(stats[i].name.c_str());
+        env->SetObjectArrayElement(names, static_cast<jsize>(i), name);
+        env->DeleteLocalRef(name);
+    }
+    return names;
+}
+
+// 每个 scope 9 个值：[samples, lastMs, minMs, avgMs, p99Ms,
+//                     statisticsSamples, fragmentInvocations, computeInvocations, clippingPrimitives, ...]
+extern "C" JNIEXPORT jdoubleArray JNICALL
+Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeGetGpuProfileValues(
+        JNIEnv* env, jobject /* this */, jlong deviceHandle) {
+
+    DeviceInfo* deviceInfo = getDeviceInfo(deviceHandle);
+    std::vector<GpuScopeStats> stats;
+    if (!deviceInfo || !getGpuProfilerStats(deviceInfo, &stats)) {
+        return nullptr;
+    }
+
+    std::vector<jdouble> values;
+    values.reserve(stats.size() * 9);
+    for (const GpuScopeStats& scope : stats) {
+        values.push_back(scope.samples);
+        values.push_back(scope.lastMs);
+        values.push_back(scope.minMs);
+        values.push_back(scope.avgMs);
+        values.push_back(scope.p99Ms);
+        values.push_back(scope.statisticsSamples);
+        values.push_back(scope.fragmentInvocations);
+        values.push_back(scope.computeInvocations);
+        values.push_back(scope.clippingPrimitives);
+    }
+    jdoubleArray array = env->NewDoubleArray(static_cast<jsize>(values.size()));
+    if (array) {
+        env->SetDoubleArrayRegion(array, 0, static_cast<jsize>(values.size()), values.data());
+    }
+    return array;
+}
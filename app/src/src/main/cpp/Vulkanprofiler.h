@@ -0,0 +1,83 @@
+//
+// Per-pass GPU profiler: timestamp query ring per frame in flight, rolling min/avg/p99 per scope.
+//
+// 之前只有离屏 render target 和几个 benchmark 有 GPU 计时，看不出每帧 GPU 时间花在上传、
+// 滤镜的离屏 pass、交换链 pass 还是 copy/blit 上。
+//
+// 每个 in-flight 帧槽位一个 VkQueryPool（TIMESTAMP）：
+// - beginGpuProfilerFrame 在等待该槽位的 fence 之后、录制开始时调用：先读取这个槽位上一次提交的结果
+//   （fence 已经 signal，结果一定可用，不带 WAIT 标志，从不阻塞），再在命令缓冲开头重置查询；
+// - 录制期间 beginGpuScope/endGpuScope 成对写 timestamp，scope 按名字区分，可以嵌套；
+//   同一帧内同名 scope 多次出现（例如每个脏矩形一次 draw）时累加为一个样本；
+// - endGpuProfilerFrame 在结束命令缓冲之前调用，写入整帧 scope（"frame"）。
+// 差值按 timestampValidBits 截断后乘 timestampPeriod 换算成毫秒。每个 scope 保留最近 kGpuProfilerWindow
+// 帧的样本，查询时计算 min/avg/p99；每 kGpuProfilerLogInterval 帧写一次日志。
+//
+// 上传等在单独命令缓冲里提交、并且提交后等待队列空闲的工作用 immediate scope：独立的小查询池，
+// 在同一个命令缓冲里重置，vkQueueWaitIdle 之后 collectImmediateGpuScopes 直接读取。
+//
+// 记录 trace 时（Vulkantrace.h）读取结果的同时把每次出现的 scope 换算到 CPU 时钟，写入 GPU 轨道。
+//
+// 设备启用了 pipeline 统计查询时（Vulkanshaderstats.h），帧槽位另有一个 PIPELINE_STATISTICS 查询池，
+// 没有其他统计查询处于活动状态的 scope 同时开始一个统计查询，结果与 GPU 时间一起报告。
+//
+// 没有启用（enableGpuProfiler 未调用或队列不支持 timestamp）时所有调用都是空操作。
+// 所有录制函数只在渲染线程调用；getGpuProfilerStats 可以在任意线程调用。
+//
+#ifndef VULKAN_PROFILER_H
+#define VULKAN_PROFILER_H
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Vulkantypes.h"
+
+constexpr uint32_t kGpuProfilerWindow = 256;       // 每个 scope 保留的帧数
+constexpr uint32_t kGpuProfilerLogInterval = 300;  // 每多少帧写一次日志
+
+struct GpuScopeStats {
+    std::string name;
+    uint32_t samples = 0;  // 窗口内的帧数
+    double lastMs = 0.0;
+    double minMs = 0.0;
+    double avgMs = 0.0;
+    double p99Ms = 0.0;
+
+    // pipeline 统计（见 Vulkanshaderstats.h）：窗口内每帧的平均值，没有收集时 statisticsSamples 为 0
+    uint32_t statisticsSamples = 0;
+    double fragmentInvocations = 0.0;
+    double computeInvocations = 0.0;
+    double clippingPrimitives = 0.0;
+};
+
+// 创建设备后、开始渲染前调用；graphics 队列不支持 timestamp 时返回 false（profiler 保持关闭）
+bool enableGpuProfiler(DeviceInfo* deviceInfo, uint32_t framesInFlight);
+
+// 销毁设备前调用（GPU 空闲）
+void destroyGpuProfiler(DeviceInfo* deviceInfo);
+
+// 命令缓冲开始录制之后调用；frameSlot 对应刚等待过的 in-flight fence
+void beginGpuProfilerFrame(DeviceInfo* deviceInfo, VkCommandBuffer commandBuffer, uint32_t frameSlot);
+
+// 结束命令缓冲之前调用
+void endGpuProfilerFrame(DeviceInfo* deviceInfo, VkCommandBuffer commandBuffer);
+
+// scope 名字对应的 id（第一次出现时登记）；profiler 关闭时返回 -1。
+// statistics 为 false 的 scope 不带 pipeline 统计查询（用于包含其他 scope 的外层 scope）
+int32_t gpuScopeId(DeviceInfo* deviceInfo, const char* name, bool statistics = true);
+
+// 在当前帧的命令缓冲中开始/结束 scope；返回的 token 传给 endGpuScope。
+// 查询用完或不在帧内时返回 -1，endGpuScope 忽略 -1
+int32_t beginGpuScope(DeviceInfo* deviceInfo, VkCommandBuffer commandBuffer, int32_t scopeId);
+void endGpuScope(DeviceInfo* deviceInfo, VkCommandBuffer commandBuffer, int32_t token);
+
+// 单独提交并等待完成的命令缓冲（上传）：begin/end 之后提交，vkQueueWaitIdle 之后 collect
+int32_t beginImmediateGpuScope(DeviceInfo* deviceInfo, VkCommandBuffer commandBuffer, int32_t scopeId);
+void endImmediateGpuScope(DeviceInfo* deviceInfo, VkCommandBuffer commandBuffer, int32_t token);
+void collectImmediateGpuScopes(DeviceInfo* deviceInfo);
+
+// 所有出现过的 scope 的滚动统计（按登记顺序）；profiler 关闭时返回 false
+bool getGpuProfilerStats(DeviceInfo* deviceInfo, std::vector<GpuScopeStats>* stats);
+
+#endif // VULKAN_PROFILER_H
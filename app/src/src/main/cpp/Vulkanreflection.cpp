@@ -0,0 +1,451 @@
+//
+// SPIR-V reflection: descriptor bindings, push-constant block and specialization constants.
+//
+#include "Vulkanjni.h"
+#include "Vulkanreflection.h"
+#include <algorithm>
+#include <unordered_map>
+
+namespace {
+
+    // SPIR-V 规范中用到的编号
+    constexpr uint32_t kSpirvMagic = 0x07230203;
+
+    enum Op : uint32_t {
+        OpName = 5,
+        OpEntryPoint = 15,
+        OpTypeBool = 20,
+        OpTypeInt = 21,
+        OpTypeFloat = 22,
+        OpTypeVector = 23,
+        OpTypeMatrix = 24,
+        OpTypeImage = 25,
+        OpTypeSampler = 26,
+        OpTypeSampledImage = 27,
+        OpTypeArray = 28,
+        OpTypeRuntimeArray = 29,
+        OpTypeStruct = 30,
+        OpTypePointer = 32,
+        OpConstant = 43,
+        OpSpecConstantTrue = 48,
+        OpSpecConstantFalse = 49,
+        OpSpecConstant = 50,
+        OpVariable = 59,
+        OpDecorate = 71,
+        OpMemberDecorate = 72,
+    };
+
+    enum Decoration : uint32_t {
+        SpecId = 1,
+        Block = 2,
+        BufferBlock = 3,
+        RowMajor = 4,
+        ArrayStride = 6,
+        MatrixStride = 7,
+        Binding = 33,
+        DescriptorSet = 34,
+        Offset = 35,
+    };
+
+    enum StorageClass : uint32_t {
+        UniformConstant = 0,
+        Uniform = 2,
+        PushConstant = 9,
+        StorageBuffer = 12,
+    };
+
+    constexpr uint32_t kDimBuffer = 5;
+    constexpr uint32_t kDimSubpassData = 6;
+
+    struct Type {
+        uint32_t op = 0;
+        std::vector<uint32_t> operands;  // 去掉 result id 之后的操作数
+    };
+
+    struct MemberInfo {
+        uint32_t offset = 0;
+        uint32_t matrixStride = 0;
+        bool rowMajor = false;
+    };
+
+    struct Decorations {
+        bool hasBinding = false;
+        bool hasSet = false;
+        bool hasSpecId = false;
+        uint32_t binding = 0;
+        uint32_t set = 0;
+        uint32_t specId = 0;
+        uint32_t arrayStride = 0;
+        bool block = false;
+        bool bufferBlock = false;
+    };
+
+    struct Variable {
+        uint32_t id = 0;
+        uint32_t pointerType = 0;
+        uint32_t storageClass = 0;
+    };
+
+    struct Module {
+        std::unordered_map<uint32_t, Type> types;
+        std::unordered_map<uint32_t, uint32_t> constants;       // OpConstant 的低 32 位
+        std::unordered_map<uint32_t, Decorations> decorations;
+        std::unordered_map<uint32_t, std::vector<MemberInfo>> members;
+        std::unordered_map<uint32_t, std::string> names;
+        std::vector<Variable> variables;
+        std::vector<std::pair<uint32_t, uint32_t>> specConstants;  // (result id, 默认值)
+        VkShaderStageFlags stages = 0;
+    };
+
+    std::string readString(const uint32_t* words, size_t count) {
+        const char* chars = reinterpret_cast<const char*>(words);
+        size_t length = 0;
+        while (length < count * 4 && chars[length] != '\0') length++;
+        return std::string(chars, length);
+    }
+
+    VkShaderStageFlags stageFromExecutionModel(uint32_t model) {
+        switch (model) {
+            case 0: return VK_SHADER_STAGE_VERTEX_BIT;
+            case 1: return VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT;
+            case 2: return VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT;
+            case 3: return VK_SHADER_STAGE_GEOMETRY_BIT;
+            case 4: return VK_SHADER_STAGE_FRAGMENT_BIT;
+            case 5: return VK_SHADER_STAGE_COMPUTE_BIT;
+            default: return 0;
+        }
+    }
+
+    MemberInfo& memberInfo(Module& module, uint32_t structId, uint32_t member) {
+        std::vector<MemberInfo>& infos = module.members[structId];
+        if (infos.size() <= member) infos.resize(member + 1);
+        return infos[member];
+    }
+
+    bool parse(const uint32_t* code, size_t wordCount, Module* module) {
+        if (wordCount < 5 || code[0] != kSpirvMagic) {
+            LOGE("Reflection: not a SPIR-V module");
+            return false;
+        }
+
+        size_t i = 5;
+        while (i < wordCount) {
+            const uint32_t length = code[i] >> 16;
+            const uint32_t opcode = code[i] & 0xffff;
+            if (length == 0 || i + length > wordCount) {
+                LOGE("Reflection: truncated instruction at word %zu", i);
+                return false;
+            }
+            const uint32_t* ops = code + i + 1;
+            const size_t opCount = length - 1;
+
+            switch (opcode) {
+                case OpName:
+                    if (opCount >= 2) module->names[ops[0]] = readString(ops + 1, opCount - 1);
+                    break;
+                case OpEntryPoint:
+                    if (opCount >= 1) module->stages |= stageFromExecutionModel(ops[0]);
+                    break;
+                case OpTypeBool:
+                case OpTypeInt:
+                case OpTypeFloat:
+                case OpTypeVector:
+                case OpTypeMatrix:
+                case OpTypeImage:
+                case OpTypeSampler:
+                case OpTypeSampledImage:
+                case OpTypeArray:
+                case OpTypeRuntimeArray:
+                case OpTypeStruct:
+                    if (opCount >= 1) {
+                        Type& type = module->types[ops[0]];
+                        type.op = opcode;
+                        type.operands.assign(ops + 1, ops + opCount);
+                    }
+                    break;
+                case OpTypePointer:
+                    // [result, storage class, pointee]
+                    if (opCount >= 3) {
+                        Type& type = module->types[ops[0]];
+                        type.op = opcode;
+                        type.operands.assign(ops + 1, ops + opCount);
+                    }
+                    break;
+                case OpConstant:
+                    if (opCount >= 3) module->constants[ops[1]] = ops[2];
+                    break;
+                case OpSpecConstantTrue:
+                case OpSpecConstantFalse:
+                    if (opCount >= 2) {
+                        module->specConstants.emplace_back(ops[1], opcode == OpSpecConstantTrue ? 1u : 0u);
+                    }
+                    break;
+                case OpSpecConstant:
+                    if (opCount >= 3) module->specConstants.emplace_back(ops[1], ops[2]);
+                    break;
+                case OpVariable:
+                    if (opCount >= 3) {
+                        Variable variable;
+                        variable.pointerType = ops[0];
+                        variable.id = ops[1];
+                        variable.storageClass = ops[2];
+                        module->variables.push_back(variable);
+                    }
+                    break;
+                case OpDecorate:
+                    if (opCount >= 2) {
+                        Decorations& d = module->decorations[ops[0]];
+                        const uint32_t value = opCount >= 3 ? ops[2] : 0;
+                        switch (ops[1]) {
+                            case Binding: d.hasBinding = true; d.binding = value; break;
+                            case DescriptorSet: d.hasSet = true; d.set = value; break;
+                            case SpecId: d.hasSpecId = true; d.specId = value; break;
+                            case ArrayStride: d.arrayStride = value; break;
+                            case Block: d.block = true; break;
+                            case BufferBlock: d.bufferBlock = true; break;
+                            default: break;
+                        }
+                    }
+                    break;
+                case OpMemberDecorate:
+                    if (opCount >= 3) {
+                        MemberInfo& member = memberInfo(*module, ops[0], ops[1]);
+                        const uint32_t value = opCount >= 4 ? ops[3] : 0;
+                        switch (ops[2]) {
+                            case Offset: member.offset = value; break;
+                            case MatrixStride: member.matrixStride = value; break;
+                            case RowMajor: member.rowMajor = true; break;
+                            default: break;
+                        }
+                    }
+                    break;
+                default:
+                    break;
+            }
+            i += length;
+        }
+        return true;
+    }
+
+    const Type* findType(const Module& module, uint32_t id) {
+        auto it = module.types.find(id);
+        return it == module.types.end() ? nullptr : &it->second;
+    }
+
+    uint32_t arrayLength(const Module& module, const Type& array) {
+        if (array.operands.size() < 2) return 0;
+        auto it = module.constants.find(array.operands[1]);
+        return it == module.constants.end() ? 0 : it->second;
+    }
+
+    // push constant 块中成员的字节大小（std430 / 显式 Offset 布局）
+    uint32_t typeSize(const Module& module, uint32_t typeId, const MemberInfo* member) {
+        const Type* type = findType(module, typeId);
+        if (!type) return 0;
+
+        switch (type->op) {
+            case OpTypeBool:
+                return 4;
+            case OpTypeInt:
+            case OpTypeFloat:
+                return type->operands.empty() ? 0 : type->operands[0] / 8;
+            case OpTypeVector:
+                return type->operands.size() < 2 ? 0 : type->operands[1] * typeSize(module, type->operands[0], nullptr);
+            case OpTypeMatrix: {
+                if (type->operands.size() < 2) return 0;
+                const uint32_t columns = type->operands[1];
+                const Type* column = findType(module, type->operands[0]);
+                const uint32_t rows = (column && column->operands.size() >= 2) ? column->operands[1] : 0;
+                if (member && member->matrixStride > 0) {
+                    return (member->rowMajor ? rows : columns) * member->matrixStride;
+                }
+                return columns * typeSize(module, type->operands[0], nullptr);
+            }
+            case OpTypeArray: {
+                const uint32_t length = arrayLength(module, *type);
+                auto d = module.decorations.find(typeId);
+                const uint32_t stride = (d != module.decorations.end() && d->second.arrayStride > 0)
+                                        ? d->second.arrayStride
+                                        : typeSize(module, type->operands[0], member);
+                return length * stride;
+            }
+            case OpTypeStruct: {
+                auto membersIt = module.members.find(typeId);
+                uint32_t size = 0;
+                for (size_t m = 0; m < type->operands.size(); m++) {
+                    const MemberInfo* info = nullptr;
+                    if (membersIt != module.members.end() && m < membersIt->second.size()) {
+                        info = &membersIt->second[m];
+                    }
+                    const uint32_t offset = info ? info->offset : size;
+                    size = std::max(size, offset + typeSize(module, type->operands[m], info));
+                }
+                return size;
+            }
+            default:
+                return 0;
+        }
+    }
+
+    bool descriptorType(const Module& module, uint32_t storageClass, uint32_t typeId, VkDescriptorType* result) {
+        const Type* type = findType(module, typeId);
+        if (!type) return false;
+
+        if (storageClass == StorageBuffer) {
+            *result = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            return true;
+        }
+        if (storageClass == Uniform) {
+            auto d = module.decorations.find(typeId);
+            const bool bufferBlock = d != module.decorations.end() && d->second.bufferBlock;
+            *result = bufferBlock ? VK_DESCRIPTOR_TYPE_STORAGE_BUFFER : VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+            return true;
+        }
+
+        switch (type->op) {
+            case OpTypeSampler:
+                *result = VK_DESCRIPTOR_TYPE_SAMPLER;
+                return true;
+            case OpTypeSampledImage:
+                *result = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+                return true;
+            case OpTypeImage: {
+                // [sampled type, dim, depth, arrayed, ms, sampled, format, ...]
+                if (type->operands.size() < 6) return false;
+                const uint32_t dim = type->operands[1];
+                const uint32_t sampled = type->operands[5];
+                if (dim == kDimSubpassData) {
+                    *result = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+                } else if (dim == kDimBuffer) {
+                    *result = sampled == 2 ? VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER
+                                           : VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+                } else {
+                    *result = sampled == 2 ? VK_DESCRIPTOR_TYPE_STORAGE_IMAGE
+                                           : VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+                }
+                return true;
+            }
+            default:
+                return false;
+        }
+    }
+
+    bool bindingLess(const ReflectedBinding& a, const ReflectedBinding& b) {
+        return a.set != b.set ? a.set < b.set : a.binding < b.binding;
+    }
+
+} // anonymous namespace
+
+// ============================================
+// Reflection
+// ============================================
+bool reflectSpirv(const uint32_t* code, size_t codeSize, ShaderReflection* reflection) {
+    Module module;
+    if (!parse(code, codeSize / sizeof(uint32_t), &module)) {
+        return false;
+    }
+
+    *reflection = ShaderReflection();
+    reflection->stages = module.stages;
+
+    for (const Variable& variable : module.variables) {
+        const Type* pointer = findType(module, variable.pointerType);
+        if (!pointer || pointer->op != OpTypePointer || pointer->operands.size() < 2) continue;
+        const uint32_t pointee = pointer->operands[1];
+
+        if (variable.storageClass == PushConstant) {
+            reflection->pushConstantSize = std::max(reflection->pushConstantSize,
+                                                    typeSize(module, pointee, nullptr));
+            reflection->pushConstantStages = module.stages;
+            continue;
+        }
+
+        if (variable.storageClass != UniformConstant &&
+            variable.storageClass != Uniform &&
+            variable.storageClass != StorageBuffer) {
+            continue;
+        }
+
+        auto d = module.decorations.find(variable.id);
+        if (d == module.decorations.end() || !d->second.hasBinding) continue;
+
+        ReflectedBinding binding;
+        binding.set = d->second.hasSet ? d->second.set : 0;
+        binding.binding = d->second.binding;
+        binding.stages = module.stages;
+        auto name = module.names.find(variable.id);
+        if (name != module.names.end()) binding.name = name->second;
+
+        // 描述符数组：sampler2D textures[4] / sampler2D textures[]
+        uint32_t elementType = pointee;
+        const Type* type = findType(module, elementType);
+        if (type && type->op == OpTypeArray) {
+            binding.count = arrayLength(module, *type);
+            elementType = type->operands[0];
+        } else if (type && type->op == OpTypeRuntimeArray) {
+            binding.count = 0;
+            elementType = type->operands[0];
+        }
+
+        if (!descriptorType(module, variable.storageClass, elementType, &binding.type)) {
+            LOGE("Reflection: unsupported resource type for %s (set %u binding %u)",
+                 binding.name.c_str(), binding.set, binding.binding);
+            return false;
+        }
+        reflection->bindings.push_back(binding);
+    }
+    std::sort(reflection->bindings.begin(), reflection->bindings.end(), bindingLess);
+
+    for (const auto& spec : module.specConstants) {
+        auto d = module.decorations.find(spec.first);
+        if (d == module.decorations.end() || !d->second.hasSpecId) continue;
+        ReflectedSpecConstant constant;
+        constant.id = d->second.specId;
+        constant.defaultValue = spec.second;
+        auto name = module.names.find(spec.first);
+        if (name != module.names.end()) constant.name = name->second;
+        reflection->specConstants.push_back(constant);
+    }
+    std::sort(reflection->specConstants.begin(), reflection->specConstants.end(),
+              [](const ReflectedSpecConstant& a, const ReflectedSpecConstant& b) { return a.id < b.id; });
+
+    return true;
+}
+
+bool mergeReflection(ShaderReflection* into, const ShaderReflection& other) {
+    into->stages |= other.stages;
+
+    for (const ReflectedBinding& binding : other.bindings) {
+        auto it = std::find_if(into->bindings.begin(), into->bindings.end(),
+                               [&binding](const ReflectedBinding& b) {
+                                   return b.set == binding.set && b.binding == binding.binding;
+                               });
+        if (it == into->bindings.end()) {
+            into->bindings.push_back(binding);
+            continue;
+        }
+        if (it->type != binding.type || it->count != binding.count) {
+            LOGE("Reflection: set %u binding %u declared differently across stages",
+                 binding.set, binding.binding);
+            return false;
+        }
+        it->stages |= binding.stages;
+    }
+    std::sort(into->bindings.begin(), into->bindings.end(), bindingLess);
+
+    // 用一个从 0 开始、覆盖所有 stage 的块的范围
+    if (other.pushConstantSize > 0) {
+        into->pushConstantSize = std::max(into->pushConstantSize, other.pushConstantSize);
+        into->pushConstantStages |= other.pushConstantStages;
+    }
+
+    // 特化常量按 id 合并（同一 id 在不同 stage 中共用一个值）
+    for (const ReflectedSpecConstant& constant : other.specConstants) {
+        auto it = std::find_if(into->specConstants.begin(), into->specConstants.end(),
+                               [&constant](const ReflectedSpecConstant& c) { return c.id == constant.id; });
+        if (it == into->specConstants.end()) into->specConstants.push_back(constant);
+    }
+    std::sort(into->specConstants.begin(), into->specConstants.end(),
+              [](const ReflectedSpecConstant& a, const ReflectedSpecConstant& b) { return a.id < b.id; });
+    return true;
+}
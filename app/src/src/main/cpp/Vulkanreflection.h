@@ -0,0 +1,46 @@
+//
+// SPIR-V reflection: descriptor bindings, push-constant block and specialization constants.
+//
+// 只解析创建 layout 需要的指令（类型、装饰、全局变量），不依赖 SPIRV-Cross。
+// 多个 stage 的反射结果合并后交给 layout 缓存（Vulkanlayoutcache.h）创建 pipeline layout。
+//
+#ifndef VULKAN_REFLECTION_H
+#define VULKAN_REFLECTION_H
+
+#include <vulkan/vulkan.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct ReflectedBinding {
+    uint32_t set = 0;
+    uint32_t binding = 0;
+    VkDescriptorType type = VK_DESCRIPTOR_TYPE_SAMPLER;
+    uint32_t count = 1;              // 数组长度；0 表示运行时数组（不定长）
+    VkShaderStageFlags stages = 0;
+    std::string name;                // 调试用
+};
+
+struct ReflectedSpecConstant {
+    uint32_t id = 0;
+    uint32_t defaultValue = 0;       // 32 位位模式（int、VkBool32 或 float）
+    std::string name;
+};
+
+struct ShaderReflection {
+    VkShaderStageFlags stages = 0;
+    std::vector<ReflectedBinding> bindings;        // 按 (set, binding) 排序
+    uint32_t pushConstantSize = 0;                 // 0 表示没有 push constant 块
+    VkShaderStageFlags pushConstantStages = 0;
+    std::vector<ReflectedSpecConstant> specConstants;  // 按 id 排序
+};
+
+// 解析一个 SPIR-V 模块（codeSize 为字节数）。格式错误或使用了不支持的类型时返回 false
+bool reflectSpirv(const uint32_t* code, size_t codeSize, ShaderReflection* reflection);
+
+// 把另一个 stage 的反射结果合并进来：同一 binding 的 stage 标志取并集，
+// push constant 取最大范围。同一 binding 在两个 stage 中类型/数量不一致时返回 false
+bool mergeReflection(ShaderReflection* into, const ShaderReflection& other);
+
+#endif // VULKAN_REFLECTION_H
@@ -0,0 +1,229 @@
+//
+// Dynamic rendering (VK_KHR_dynamic_rendering) with render-pass fallback.
+//
+#include "Vulkanjni.h"
+#include "Vulkanrendering.h"
+#include <cstring>
+
+using namespace VulkanJNI;
+
+namespace {
+
+    bool hasExtension(const std::vector<VkExtensionProperties>& available, const char* name) {
+        for (const auto& extension : available) {
+            if (strcmp(extension.extensionName, name) == 0) return true;
+        }
+        return false;
+    }
+
+    void imageBarrier(VkCommandBuffer commandBuffer, VkImage image,
+                      VkImageLayout oldLayout, VkImageLayout newLayout,
+                      VkPipelineStageFlags srcStage, VkAccessFlags srcAccess,
+                      VkPipelineStageFlags dstStage, VkAccessFlags dstAccess) {
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.oldLayout = oldLayout;
+        barrier.newLayout = newLayout;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = image;
+        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        barrier.subresourceRange.baseMipLevel = 0;
+        barrier.subresourceRange.levelCount = 1;
+        barrier.subresourceRange.baseArrayLayer = 0;
+        barrier.subresourceRange.layerCount = 1;
+        barrier.srcAccessMask = srcAccess;
+        barrier.dstAccessMask = dstAccess;
+
+        vkCmdPipelineBarrier(commandBuffer, srcStage, dstStage, 0,
+                             0, nullptr, 0, nullptr, 1, &barrier);
+    }
+
+} // anonymous namespace
+
+// ============================================
+// Device Setup
+// ============================================
+bool queryDynamicRenderingSupport(VkPhysicalDevice physicalDevice,
+                                  std::vector<const char*>* extensions,
+                                  VkPhysicalDeviceDynamicRenderingFeaturesKHR* features) {
+    // 实例为 Vulkan 1.1，只能通过扩展使用（1.3 设备同样提供该扩展）；
+    // vkGetPhysicalDeviceFeatures2 需要设备支持 1.1
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+    if (properties.apiVersion < VK_API_VERSION_1_1) return false;
+
+    uint32_t count = 0;
+    vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &count, nullptr);
+    std::vector<VkExtensionProperties> available(count);
+    vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &count, available.data());
+
+    // VK_KHR_dynamic_rendering 依赖 depth_stencil_resolve → create_renderpass2（multiview、maintenance2 为 1.1 核心）
+    const char* required[] = {
+            VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME,
+            VK_KHR_DEPTH_STENCIL_RESOLVE_EXTENSION_NAME,
+            VK_KHR_CREATE_RENDERPASS_2_EXTENSION_NAME,
+    };
+    for (const char* name : required) {
+        if (!hasExtension(available, name)) return false;
+    }
+
+    *features = VkPhysicalDeviceDynamicRenderingFeaturesKHR{};
+    features->sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR;
+
+    VkPhysicalDeviceFeatures2 features2{};
+    features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features2.pNext = features;
+    vkGetPhysicalDeviceFeatures2(physicalDevice, &features2);
+    if (features->dynamicRendering != VK_TRUE) return false;
+
+    for (const char* name : required) {
+        extensions->push_back(name);
+    }
+    return true;
+}
+
+void initDynamicRendering(DeviceInfo* deviceInfo, bool enabled) {
+    deviceInfo->dynamicRendering = false;
+    if (!enabled) return;
+
+    deviceInfo->cmdBeginRendering = reinterpret_cast<PFN_vkCmdBeginRenderingKHR>(
+            vkGetDeviceProcAddr(deviceInfo->device, "vkCmdBeginRenderingKHR"));
+    deviceInfo->cmdEndRendering = reinterpret_cast<PFN_vkCmdEndRenderingKHR>(
+            vkGetDeviceProcAddr(deviceInfo->device, "vkCmdEndRenderingKHR"));
+
+    if (!deviceInfo->cmdBeginRendering || !deviceInfo->cmdEndRendering) {
+        LOGE("vkCmdBeginRenderingKHR not found, falling back to render passes");
+        return;
+    }
+    deviceInfo->dynamicRendering = true;
+}
+
+// ============================================
+// Command Recording
+// ============================================
+void beginDynamicRendering(DeviceInfo* deviceInfo, VkCommandBuffer commandBuffer,
+                           VkImage image, VkImageView imageView, VkExtent2D extent,
+                           VkImageLayout oldLayout, VkPipelineStageFlags srcStage, VkAccessFlags srcAccess,
+                           VkAttachmentLoadOp loadOp, const VkClearValue& clearValue) {
+    VkAccessFlags dstAccess = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    if (loadOp == VK_ATTACHMENT_LOAD_OP_LOAD) {
+        dstAccess |= VK_ACCESS_COLOR_ATTACHMENT_READ_BIT;
+    }
+    imageBarrier(commandBuffer, image, oldLayout, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+                 srcStage, srcAccess, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, dstAccess);
+
+    VkRenderingAttachmentInfoKHR colorAttachment{};
+    colorAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
+    colorAttachment.imageView = imageView;
+    colorAttachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    colorAttachment.resolveMode = VK_RESOLVE_MODE_NONE;
+    colorAttachment.loadOp = loadOp;
+    colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    colorAttachment.clearValue = clearValue;
+
+    VkRenderingInfoKHR renderingInfo{};
+    renderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR;
+    renderingInfo.renderArea.offset = {0, 0};
+    renderingInfo.renderArea.extent = extent;
+    renderingInfo.layerCount = 1;
+    renderingInfo.colorAttachmentCount = 1;
+    renderingInfo.pColorAttachments = &colorAttachment;
+
+    deviceInfo->cmdBeginRendering(commandBuffer, &renderingInfo);
+}
+
+void endDynamicRendering(DeviceInfo* deviceInfo, VkCommandBuffer commandBuffer, VkImage image,
+                         VkImageLayout newLayout, VkPipelineStageFlags dstStage, VkAccessFlags dstAccess) {
+    deviceInfo->cmdEndRendering(commandBuffer);
+
+    imageBarrier(commandBuffer, image, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, newLayout,
+                 VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+                 dstStage, dstAccess);
+}
+
+// ============================================
+// JNI: VulkanRunner
+// ============================================
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeIsDynamicRenderingEnabled(
+        JNIEnv* env, jobject /* this */, jlong deviceHandle) {
+
+    DeviceInfo* deviceInfo = getDeviceInfo(deviceHandle);
+    return deviceInfo && deviceInfo->dynamicRendering ? JNI_TRUE : JNI_FALSE;
+}
+
+// 对应 nativeBeginRenderPass：load = true 时保留图像上次呈现的内容（增量重绘）
+extern "C" JNIEXPORT void JNICALL
+Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeBeginRendering(
+        JNIEnv* env, jobject /* this */,
+        jlong deviceHandle,
+        jlong commandBufferHandle,
+        jlong swapchainHandle,
+        jint imageIndex,
+        jboolean load) {
+
+    DeviceInfo* deviceInfo = getDeviceInfo(deviceHandle);
+    VkCommandBuffer commandBuffer = fromHandle<VkCommandBuffer>(commandBufferHandle);
+    SwapchainInfo* swapchainInfo = fromHandle<SwapchainInfo*>(swapchainHandle);
+    if (!validateHandle(deviceInfo, "device") || !validateHandle(commandBuffer, "commandBuffer") ||
+        !validateHandle(swapchainInfo, "swapchain") || !deviceInfo->dynamicRendering) {
+        return;
+    }
+    if (imageIndex < 0 || static_cast<size_t>(imageIndex) >= swapchainInfo->imageViews.size()) {
+        LOGE("Invalid image index: %d", imageIndex);
+        return;
+    }
+
+    // 与 render pass 路径相同：红色清屏方便看到是否有渲染
+    VkClearValue clearColor = {{{1.0f, 0.0f, 0.0f, 1.0f}}};
+
+    // 等待 acquire 信号量（提交时等待阶段为 COLOR_ATTACHMENT_OUTPUT）后再转换布局；
+    // LOAD 时图像必须已经被渲染并呈现过一次
+    beginDynamicRendering(deviceInfo, commandBuffer,
+                          swapchainInfo->images[imageIndex], swapchainInfo->imageViews[imageIndex],
+                          swapchainInfo->extent,
+                          load ? VK_IMAGE_LAYOUT_PRESENT_SRC_KHR : VK_IMAGE_LAYOUT_UNDEFINED,
+                          VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, 0,
+                          load ? VK_ATTACHMENT_LOAD_OP_LOAD : VK_ATTACHMENT_LOAD_OP_CLEAR,
+                          clearColor);
+
+    VkViewport viewport{};
+    viewport.x = 0.0f;
+    viewport.y = 0.0f;
+    viewport.width = static_cast<float>(swapchainInfo->extent.width);
+    viewport.height = static_cast<float>(swapchainInfo->extent.height);
+    viewport.minDepth = 0.0f;
+    viewport.maxDepth = 1.0f;
+    vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+
+    VkRect2D scissor{};
+    scissor.offset = {0, 0};
+    scissor.extent = swapchainInfo->extent;
+    vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeEndRendering(
+        JNIEnv* env, jobject /* this */,
+        jlong deviceHandle,
+        jlong commandBufferHandle,
+        jlong swapchainHandle,
+        jint imageIndex) {
+
+    DeviceInfo* deviceInfo = getDeviceInfo(deviceHandle);
+    VkCommandBuffer commandBuffer = fromHandle<VkCommandBuffer>(commandBufferHandle);
+    SwapchainInfo* swapchainInfo = fromHandle<SwapchainInfo*>(swapchainHandle);
+    if (!validateHandle(deviceInfo, "device") || !validateHandle(commandBuffer, "commandBuffer") ||
+        !validateHandle(swapchainInfo, "swapchain") || !deviceInfo->dynamicRendering) {
+        return;
+    }
+    if (imageIndex < 0 || static_cast<size_t>(imageIndex) >= swapchainInfo->images.size()) {
+        LOGE("Invalid image index: %d", imageIndex);
+        return;
+    }
+
+    // present 由信号量同步，这里不需要目标阶段
+    endDynamicRendering(deviceInfo, commandBuffer, swapchainInfo->images[imageIndex],
+                        VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0);
+}
@@ -0,0 +1,39 @@
+//
+// Dynamic rendering (VK_KHR_dynamic_rendering) with render-pass fallback.
+//
+// 设备支持时不再创建 VkRenderPass / VkFramebuffer：直接在 image view 上
+// vkCmdBeginRenderingKHR，附件布局转换由这里的 barrier 完成（render pass 路径中由
+// initialLayout/finalLayout 和 subpass 依赖完成）。交换链重建时不需要重建 framebuffer；
+// pipeline 只依赖颜色附件格式（VkPipelineRenderingCreateInfoKHR），格式不变就一直有效。
+//
+// Kotlin 端用 renderPass = 0 表示动态渲染：滤镜 init 拿到 0，pipeline 按
+// DeviceInfo::colorFormat 创建。设备不支持时回退到原来的 render pass 路径。
+//
+#ifndef VULKAN_RENDERING_H
+#define VULKAN_RENDERING_H
+
+#include <vulkan/vulkan.h>
+#include <vector>
+#include "Vulkantypes.h"
+
+// 检测物理设备是否支持动态渲染；支持时把需要启用的扩展追加到 extensions，
+// 并把特性结构填好（链到 VkDeviceCreateInfo::pNext）
+bool queryDynamicRenderingSupport(VkPhysicalDevice physicalDevice,
+                                  std::vector<const char*>* extensions,
+                                  VkPhysicalDeviceDynamicRenderingFeaturesKHR* features);
+
+// 创建设备后调用：加载 vkCmdBeginRenderingKHR / vkCmdEndRenderingKHR，失败时回退
+void initDynamicRendering(DeviceInfo* deviceInfo, bool enabled);
+
+// 把 image 从 oldLayout 转到 COLOR_ATTACHMENT_OPTIMAL 并开始渲染。
+// srcStage/srcAccess 为 image 上一次使用的阶段（例如上一帧的采样）
+void beginDynamicRendering(DeviceInfo* deviceInfo, VkCommandBuffer commandBuffer,
+                           VkImage image, VkImageView imageView, VkExtent2D extent,
+                           VkImageLayout oldLayout, VkPipelineStageFlags srcStage, VkAccessFlags srcAccess,
+                           VkAttachmentLoadOp loadOp, const VkClearValue& clearValue);
+
+// 结束渲染并把 image 转到 newLayout，dstStage/dstAccess 为之后的使用者
+void endDynamicRendering(DeviceInfo* deviceInfo, VkCommandBuffer commandBuffer, VkImage image,
+                         VkImageLayout newLayout, VkPipelineStageFlags dstStage, VkAccessFlags dstAccess);
+
+#endif // VULKAN_RENDERING_H
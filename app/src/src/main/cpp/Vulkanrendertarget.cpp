@@ -0,0 +1,396 @@
+//
+// Offscreen render target with GPU timing.
+//
+#include "Vulkanjni.h"
+#include "Vulkanrendertarget.h"
+#include "Vulkanpipelineregistry.h"
+#include "Vulkanrendering.h"
+#include <vector>
+
+using namespace VulkanJNI;
+
+extern uint32_t findMemoryType(VkPhysicalDevice physicalDevice, uint32_t typeFilter, VkMemoryPropertyFlags properties);
+
+// ============================================
+// Render Target
+// ============================================
+namespace {
+
+    VkRenderPass createOffscreenRenderPass(DeviceInfo* deviceInfo, VkFormat format) {
+        VkAttachmentDescription colorAttachment{};
+        colorAttachment.format = format;
+        colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+        colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+        colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        colorAttachment.finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;  // 之后被采样
+
+        VkAttachmentReference colorAttachmentRef{};
+        colorAttachmentRef.attachment = 0;
+        colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+        VkSubpassDescription subpass{};
+        subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+        subpass.colorAttachmentCount = 1;
+        subpass.pColorAttachments = &colorAttachmentRef;
+
+        VkSubpassDependency dependencies[2]{};
+
+        // 上一帧对该图像的采样/写入完成后才能再次写入（只有一张离屏图像）
+        dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+        dependencies[0].dstSubpass = 0;
+        dependencies[0].srcStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
+                                       VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        dependencies[0].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        dependencies[0].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        dependencies[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+
+        // 写入完成后才能在交换链 pass 中采样
+        dependencies[1].srcSubpass = 0;
+        dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+        dependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        dependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        dependencies[1].dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+        dependencies[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+        VkRenderPassCreateInfo renderPassInfo{};
+        renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+        renderPassInfo.attachmentCount = 1;
+        renderPassInfo.pAttachments = &colorAttachment;
+        renderPassInfo.subpassCount = 1;
+        renderPassInfo.pSubpasses = &subpass;
+        renderPassInfo.dependencyCount = 2;
+        renderPassInfo.pDependencies = dependencies;
+
+        VkRenderPass renderPass;
+        VkResult result = vkCreateRenderPass(deviceInfo->device, &renderPassInfo, nullptr, &renderPass);
+        if (!validateResult(result, "vkCreateRenderPass (offscreen)")) return VK_NULL_HANDLE;
+        registerRenderPass(deviceInfo, renderPass, &renderPassInfo);
+        return renderPass;
+    }
+
+    bool createTimerQueryPool(DeviceInfo* deviceInfo, RenderTarget* target) {
+        uint32_t queueFamilyCount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(deviceInfo->physicalDevice, &queueFamilyCount, nullptr);
+        std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(deviceInfo->physicalDevice, &queueFamilyCount, queueFamilies.data());
+
+        if (deviceInfo->graphicsQueueFamily >= queueFamilyCount ||
+            queueFamilies[deviceInfo->graphicsQueueFamily].timestampValidBits == 0) {
+            LOGE("Timestamps not supported on graphics queue, GPU time unavailable");
+            return false;
+        }
+
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(deviceInfo->physicalDevice, &properties);
+        target->timestampPeriod = properties.limits.timestampPeriod;
+
+        VkQueryPoolCreateInfo queryPoolInfo{};
+        queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        queryPoolInfo.queryCount = RenderTarget::kTimerSlots * 2;
+
+        VkResult result = vkCreateQueryPool(deviceInfo->device, &queryPoolInfo, nullptr, &target->queryPool);
+        if (!validateResult(result, "vkCreateQueryPool")) {
+            target->queryPool = VK_NULL_HANDLE;
+            return false;
+        }
+        return true;
+    }
+
+} // anonymous namespace
+
+RenderTarget* createRenderTarget(DeviceInfo* deviceInfo, uint32_t width, uint32_t height, VkFormat format) {
+    VkDevice device = deviceInfo->device;
+    RenderTarget* target = new RenderTarget();
+    target->format = format;
+    target->width = width;
+    target->height = height;
+
+    // 1. Image
+    VkImageCreateInfo imageInfo{};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.extent = {width, height, 1};
+    imageInfo.mipLevels = 1;
+    imageInfo.arrayLayers = 1;
+    imageInfo.format = format;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    imageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    VkResult result = vkCreateImage(device, &imageInfo, nullptr, &target->image);
+    if (!validateResult(result, "vkCreateImage (render target)")) {
+        destroyRenderTarget(deviceInfo, target);
+        return nullptr;
+    }
+
+    // 2. Memory
+    VkMemoryRequirements memRequirements;
+    vkGetImageMemoryRequirements(device, target->image, &memRequirements);
+
+    VkMemoryAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.allocationSize = memRequirements.size;
+    allocInfo.memoryTypeIndex = findMemoryType(deviceInfo->physicalDevice,
+                                               memRequirements.memoryTypeBits,
+                                               VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+    result = vkAllocateMemory(device, &allocInfo, nullptr, &target->memory);
+    if (!validateResult(result, "vkAllocateMemory (render target)")) {
+        destroyRenderTarget(deviceInfo, target);
+        return nullptr;
+    }
+    vkBindImageMemory(device, target->image, target->memory, 0);
+
+    // 3. Image view
+    VkImageViewCreateInfo viewInfo{};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image = target->image;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format = format;
+    viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    viewInfo.subresourceRange.baseMipLevel = 0;
+    viewInfo.subresourceRange.levelCount = 1;
+    viewInfo.subresourceRange.baseArrayLayer = 0;
+    viewInfo.subresourceRange.layerCount = 1;
+
+    result = vkCreateImageView(device, &viewInfo, nullptr, &target->imageView);
+    if (!validateResult(result, "vkCreateImageView (render target)")) {
+        destroyRenderTarget(deviceInfo, target);
+        return nullptr;
+    }
+
+    // 4. Render pass + framebuffer（动态渲染时不需要，布局转换在 begin/end 中完成）
+    if (deviceInfo->dynamicRendering) {
+        target->dynamicRendering = deviceInfo;
+        createTimerQueryPool(deviceInfo, target);
+        LOGI("✓ Render target created: %ux%u, format=%d, dynamic rendering, timestamps=%s",
+             width, height, format, target->queryPool != VK_NULL_HANDLE ? "yes" : "no");
+        return target;
+    }
+
+    target->renderPass = createOffscreenRenderPass(deviceInfo, format);
+    if (target->renderPass == VK_NULL_HANDLE) {
+        destroyRenderTarget(deviceInfo, target);
+        return nullptr;
+    }
+
+    VkFramebufferCreateInfo framebufferInfo{};
+    framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+    framebufferInfo.renderPass = target->renderPass;
+    framebufferInfo.attachmentCount = 1;
+    framebufferInfo.pAttachments = &target->imageView;
+    framebufferInfo.width = width;
+    framebufferInfo.height = height;
+    framebufferInfo.layers = 1;
+
+    result = vkCreateFramebuffer(device, &framebufferInfo, nullptr, &target->framebuffer);
+    if (!validateResult(result, "vkCreateFramebuffer (render target)")) {
+        destroyRenderTarget(deviceInfo, target);
+        return nullptr;
+    }
+
+    // 5. GPU 计时（不支持时仍可正常渲染）
+    createTimerQueryPool(deviceInfo, target);
+
+    LOGI("✓ Render target created: %ux%u, format=%d, timestamps=%s",
+         width, height, format, target->queryPool != VK_NULL_HANDLE ? "yes" : "no");
+    return target;
+}
+
+void destroyRenderTarget(DeviceInfo* deviceInfo, RenderTarget* target) {
+    if (!target) return;
+    VkDevice device = deviceInfo->device;
+
+    if (target->queryPool != VK_NULL_HANDLE) vkDestroyQueryPool(device, target->queryPool, nullptr);
+    if (target->framebuffer != VK_NULL_HANDLE) vkDestroyFramebuffer(device, target->framebuffer, nullptr);
+    if (target->renderPass != VK_NULL_HANDLE) {
+        unregisterRenderPass(deviceInfo, target->renderPass);
+        vkDestroyRenderPass(device, target->renderPass, nullptr);
+    }
+    if (target->imageView != VK_NULL_HANDLE) vkDestroyImageView(device, target->imageView, nullptr);
+    if (target->image != VK_NULL_HANDLE) vkDestroyImage(device, target->image, nullptr);
+    if (target->memory != VK_NULL_HANDLE) vkFreeMemory(device, target->memory, nullptr);
+    delete target;
+}
+
+void beginRenderTargetPass(VkCommandBuffer commandBuffer, RenderTarget* target, uint32_t width, uint32_t height) {
+    if (width > target->width) width = target->width;
+    if (height > target->height) height = target->height;
+
+    // 开始计时：槽位还没读到结果就丢弃（query reset 必须在 render pass 之外）
+    if (target->queryPool != VK_NULL_HANDLE) {
+        const uint32_t slot = target->writeSlot;
+        if (target->slotPending[slot]) {
+            target->slotPending[slot] = false;
+            if (target->readSlot == slot) {
+                target->readSlot = (slot + 1) % RenderTarget::kTimerSlots;
+            }
+        }
+        vkCmdResetQueryPool(commandBuffer, target->queryPool, slot * 2, 2);
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, target->queryPool, slot * 2);
+    }
+
+    VkClearValue clearColor = {{{0.0f, 0.0f, 0.0f, 1.0f}}};
+
+    if (target->dynamicRendering) {
+        // 与离屏 render pass 的第一个依赖相同：等上一帧对该图像的采样/写入完成
+        beginDynamicRendering(target->dynamicRendering, commandBuffer, target->image, target->imageView,
+                              {width, height}, VK_IMAGE_LAYOUT_UNDEFINED,
+                              VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                              VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+                              VK_ATTACHMENT_LOAD_OP_CLEAR, clearColor);
+    } else {
+        VkRenderPassBeginInfo renderPassInfo{};
+        renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+        renderPassInfo.renderPass = target->renderPass;
+        renderPassInfo.framebuffer = target->framebuffer;
+        renderPassInfo.renderArea.offset = {0, 0};
+        renderPassInfo.renderArea.extent = {width, height};
+        renderPassInfo.clearValueCount = 1;
+        renderPassInfo.pClearValues = &clearColor;
+
+        vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+    }
+
+    VkViewport viewport{};
+    viewport.x = 0.0f;
+    viewport.y = 0.0f;
+    viewport.width = static_cast<float>(width);
+    viewport.height = static_cast<float>(height);
+    viewport.minDepth = 0.0f;
+    viewport.maxDepth = 1.0f;
+    vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+
+    VkRect2D scissor{};
+    scissor.offset = {0, 0};
+    scissor.extent = {width, height};
+    vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+}
+
+void endRenderTargetPass(VkCommandBuffer commandBuffer, RenderTarget* target) {
+    if (target->dynamicRendering) {
+        // 写入完成后才能在交换链 pass 中采样
+        endDynamicRendering(target->dynamicRendering, commandBuffer, target->image,
+                            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT);
+    } else {
+        vkCmdEndRenderPass(commandBuffer);
+    }
+
+    if (target->queryPool != VK_NULL_HANDLE) {
+        const uint32_t slot = target->writeSlot;
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, target->queryPool, slot * 2 + 1);
+        target->slotPending[slot] = true;
+        target->writeSlot = (slot + 1) % RenderTarget::kTimerSlots;
+    }
+}
+
+double readRenderTargetGpuTime(DeviceInfo* deviceInfo, RenderTarget* target) {
+    if (target->queryPool == VK_NULL_HANDLE) return -1.0;
+
+    double latest = -1.0;
+    while (target->slotPending[target->readSlot]) {
+        const uint32_t slot = target->readSlot;
+        uint64_t timestamps[2] = {0, 0};
+        VkResult result = vkGetQueryPoolResults(
+                deviceInfo->device, target->queryPool, slot * 2, 2,
+                sizeof(timestamps), timestamps, sizeof(uint64_t),
+                VK_QUERY_RESULT_64_BIT);
+        if (result == VK_NOT_READY) break;
+
+        target->slotPending[slot] = false;
+        target->readSlot = (slot + 1) % RenderTarget::kTimerSlots;
+        if (result == VK_SUCCESS && timestamps[1] >= timestamps[0]) {
+            latest = static_cast<double>(timestamps[1] - timestamps[0]) * target->timestampPeriod / 1e6;
+        }
+    }
+    return latest;
+}
+
+// ============================================
+// JNI: DynamicResolutionFilter
+// ============================================
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_genymobile_scrcpy_vulkan_DynamicResolutionFilter_nativeCreateRenderTarget(
+        JNIEnv* env, jobject /* this */,
+        jlong deviceHandle,
+        jint width,
+        jint height) {
+
+    DeviceInfo* deviceInfo = getDeviceInfo(deviceHandle);
+    if (!validateHandle(deviceInfo, "device") || width <= 0 || height <= 0) {
+        return 0;
+    }
+
+    // 与交换链使用相同格式，保证 render pass 兼容（动态渲染时 pipeline 按该格式创建）
+    RenderTarget* target = createRenderTarget(deviceInfo, static_cast<uint32_t>(width),
+                                              static_cast<uint32_t>(height), deviceInfo->colorFormat);
+    return toHandle(target);
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_genymobile_scrcpy_vulkan_DynamicResolutionFilter_nativeDestroyRenderTarget(
+        JNIEnv* env, jobject /* this */, jlong deviceHandle, jlong targetHandle) {
+
+    DeviceInfo* deviceInfo = getDeviceInfo(deviceHandle);
+    RenderTarget* target = fromHandle<RenderTarget*>(targetHandle);
+    if (validateHandle(deviceInfo, "device") && validateHandle(target, "renderTarget")) {
+        destroyRenderTarget(deviceInfo, target);
+    }
+}
+
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_genymobile_scrcpy_vulkan_DynamicResolutionFilter_nativeGetRenderTargetView(
+        JNIEnv* env, jobject /* this */, jlong targetHandle) {
+
+    RenderTarget* target = fromHandle<RenderTarget*>(targetHandle);
+    return target ? toHandle(target->imageView) : 0;
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_genymobile_scrcpy_vulkan_DynamicResolutionFilter_nativeBeginRenderTargetPass(
+        JNIEnv* env, jobject /* this */,
+        jlong commandBufferHandle,
+        jlong targetHandle,
+        jint width,
+        jint height) {
+
+    VkCommandBuffer commandBuffer = fromHandle<VkCommandBuffer>(commandBufferHandle);
+    RenderTarget* target = fromHandle<RenderTarget*>(targetHandle);
+    if (!validateHandle(commandBuffer, "commandBuffer") || !validateHandle(target, "renderTarget")) {
+        return;
+    }
+    beginRenderTargetPass(commandBuffer, target, static_cast<uint32_t>(width), static_cast<uint32_t>(height));
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_genymobile_scrcpy_vulkan_DynamicResolutionFilter_nativeEndRenderTargetPass(
+        JNIEnv* env, jobject /* this */,
+        jlong commandBufferHandle,
+        jlong targetHandle) {
+
+    VkCommandBuffer commandBuffer = fromHandle<VkCommandBuffer>(commandBufferHandle);
+    RenderTarget* target = fromHandle<RenderTarget*>(targetHandle);
+    if (!validateHandle(commandBuffer, "commandBuffer") || !validateHandle(target, "renderTarget")) {
+        return;
+    }
+    endRenderTargetPass(commandBuffer, target);
+}
+
+extern "C" JNIEXPORT jdouble JNICALL
+Java_com_genymobile_scrcpy_vulkan_DynamicResolutionFilter_nativeReadGpuTime(
+        JNIEnv* env, jobject /* this */, jlong deviceHandle, jlong targetHandle) {
+
+    DeviceInfo* deviceInfo = getDeviceInfo(deviceHandle);
+    RenderTarget* target = fromHandle<RenderTarget*>(targetHandle);
+    if (!deviceInfo || !target) {
+        return -1.0;
+    }
+    return readRenderTargetGpuTime(deviceInfo, target);
+}
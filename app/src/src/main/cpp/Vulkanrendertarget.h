@@ -0,0 +1,46 @@
+//
+// Offscreen render target with GPU timing.
+//
+// 滤镜先渲染到离屏图像（可能只使用其左上角的一部分，即动态分辨率），
+// 再在交换链 render pass 中采样该图像输出。
+// 离屏 render pass 与交换链 render pass 格式相同、单采样，因此二者兼容，
+// 为交换链创建的 pipeline 可以直接在离屏 pass 中使用。
+// 设备启用动态渲染时不创建 render pass / framebuffer，begin/end 中用 barrier 转换布局。
+//
+#ifndef VULKAN_RENDER_TARGET_H
+#define VULKAN_RENDER_TARGET_H
+
+#include <vulkan/vulkan.h>
+#include "Vulkantypes.h"
+
+struct RenderTarget {
+    VkImage image = VK_NULL_HANDLE;
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    VkImageView imageView = VK_NULL_HANDLE;
+    VkRenderPass renderPass = VK_NULL_HANDLE;
+    VkFramebuffer framebuffer = VK_NULL_HANDLE;
+    DeviceInfo* dynamicRendering = nullptr;  // 非空：动态渲染（没有 render pass / framebuffer）
+    VkFormat format = VK_FORMAT_UNDEFINED;
+    uint32_t width = 0;   // 分配尺寸（最大渲染尺寸）
+    uint32_t height = 0;
+
+    // GPU 计时：每个槽位两个 timestamp（pass 开始/结束），环形使用
+    static constexpr uint32_t kTimerSlots = 4;
+    VkQueryPool queryPool = VK_NULL_HANDLE;
+    float timestampPeriod = 0.0f;  // 每个 tick 的纳秒数
+    bool slotPending[kTimerSlots] = {};
+    uint32_t writeSlot = 0;
+    uint32_t readSlot = 0;
+};
+
+RenderTarget* createRenderTarget(DeviceInfo* deviceInfo, uint32_t width, uint32_t height, VkFormat format);
+void destroyRenderTarget(DeviceInfo* deviceInfo, RenderTarget* target);
+
+// 开始离屏 pass：渲染区域、viewport、scissor 均为 (0, 0, width, height)
+void beginRenderTargetPass(VkCommandBuffer commandBuffer, RenderTarget* target, uint32_t width, uint32_t height);
+void endRenderTargetPass(VkCommandBuffer commandBuffer, RenderTarget* target);
+
+// 读取已完成的 GPU 时间（毫秒），不等待；没有新结果返回 -1
+double readRenderTargetGpuTime(DeviceInfo* deviceInfo, RenderTarget* target);
+
+#endif // VULKAN_RENDER_TARGET_H
@@ -0,0 +1,183 @@
+//
+// Device-level sampler cache keyed by the full create info, shared immutable samplers.
+//
+#include "Vulkanjni.h"
+#include "Vulkansamplers.h"
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+using namespace VulkanJNI;
+
+struct SamplerCache {
+    std::mutex mutex;
+
+    struct Entry {
+        VkSampler sampler = VK_NULL_HANDLE;
+        uint32_t refCount = 0;
+    };
+    std::unordered_map<std::string, Entry> samplers;        // 内容键 → sampler
+    std::unordered_map<uint64_t, std::string> samplerKeys;  // VkSampler → 内容键
+
+    uint32_t hits = 0;
+    uint32_t misses = 0;
+};
+
+namespace {
+
+    SamplerCache* getCache(DeviceInfo* deviceInfo) {
+        return deviceInfo ? deviceInfo->samplerCache : nullptr;
+    }
+
+    uint64_t samplerHandleKey(VkSampler sampler) {
+        return static_cast<uint64_t>(toHandle(sampler));
+    }
+
+    void appendU32(std::string* key, uint32_t value) {
+        key->append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    void appendU64(std::string* key, uint64_t value) {
+        key->append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    // -0.0 与 0.0 等价
+    void appendF32(std::string* key, float value) {
+        if (value == 0.0f) value = 0.0f;
+        key->append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    bool usesBorder(const VkSamplerCreateInfo& info) {
+        return info.addressModeU == VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER ||
+               info.addressModeV == VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER ||
+               info.addressModeW == VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+    }
+
+    // 规范化的 create info；pNext 链上有不认识的结构时返回 false
+    bool buildKey(const VkSamplerCreateInfo& info, std::string* key) {
+        appendU32(key, info.flags);
+        appendU32(key, info.magFilter);
+        appendU32(key, info.minFilter);
+        // LOD 被钳制到 0 时只读第 0 级，mipmapMode 不起作用
+        const bool singleLevel = info.minLod == 0.0f && info.maxLod == 0.0f;
+        appendU32(key, singleLevel ? VK_SAMPLER_MIPMAP_MODE_NEAREST : info.mipmapMode);
+        appendU32(key, info.addressModeU);
+        appendU32(key, info.addressModeV);
+        appendU32(key, info.addressModeW);
+        appendF32(key, info.mipLodBias);
+        appendU32(key, info.anisotropyEnable ? 1u : 0u);
+        appendF32(key, info.anisotropyEnable ? info.maxAnisotropy : 1.0f);
+        appendU32(key, info.compareEnable ? 1u : 0u);
+        appendU32(key, info.compareEnable ? info.compareOp : VK_COMPARE_OP_NEVER);
+        appendF32(key, info.minLod);
+        appendF32(key, info.maxLod);
+        appendU32(key, usesBorder(info) ? info.borderColor : VK_BORDER_COLOR_FLOAT_TRANSPARENT_BLACK);
+        appendU32(key, info.unnormalizedCoordinates ? 1u : 0u);
+
+        for (auto* next = static_cast<const VkBaseInStructure*>(info.pNext); next; next = next->pNext) {
+            appendU32(key, next->sType);
+            switch (next->sType) {
+                case VK_STRUCTURE_TYPE_SAMPLER_YCBCR_CONVERSION_INFO: {
+                    // conversion 由调用方持有到设备销毁，按句柄比较
+                    auto* ycbcr = reinterpret_cast<const VkSamplerYcbcrConversionInfo*>(next);
+                    appendU64(key, static_cast<uint64_t>(toHandle(ycbcr->conversion)));
+                    break;
+                }
+                case VK_STRUCTURE_TYPE_SAMPLER_REDUCTION_MODE_CREATE_INFO: {
+                    auto* reduction = reinterpret_cast<const VkSamplerReductionModeCreateInfo*>(next);
+                    appendU32(key, reduction->reductionMode);
+                    break;
+                }
+                default:
+                    LOGE("Sampler cache: unsupported pNext structure (sType %d)", next->sType);
+                    return false;
+            }
+        }
+        return true;
+    }
+
+} // anonymous namespace
+
+// ============================================
+// Lifetime
+// ============================================
+void createSamplerCache(DeviceInfo* deviceInfo) {
+    if (deviceInfo->samplerCache == nullptr) {
+        deviceInfo->samplerCache = new SamplerCache();
+    }
+}
+
+void destroySamplerCache(DeviceInfo* deviceInfo) {
+    SamplerCache* cache = getCache(deviceInfo);
+    if (!cache) return;
+
+    uint32_t referenced = 0;
+    for (auto& entry : cache->samplers) {
+        if (entry.second.refCount > 0) referenced++;
+        vkDestroySampler(deviceInfo->device, entry.second.sampler, nullptr);
+    }
+    LOGI("Sampler cache: %zu samplers, %u hits, %u misses", cache->samplers.size(), cache->hits, cache->misses);
+    if (referenced > 0) {
+        LOGE("Sampler cache: %u samplers still referenced at device destruction", referenced);
+    }
+
+    delete cache;
+    deviceInfo->samplerCache = nullptr;
+}
+
+// ============================================
+// Samplers
+// ============================================
+VkSampler acquireSampler(DeviceInfo* deviceInfo, const VkSamplerCreateInfo& createInfo) {
+    SamplerCache* cache = getCache(deviceInfo);
+    if (!cache) return VK_NULL_HANDLE;
+
+    std::string key;
+    if (!buildKey(createInfo, &key)) return VK_NULL_HANDLE;
+
+    std::lock_guard<std::mutex> lock(cache->mutex);
+    auto it = cache->samplers.find(key);
+    if (it != cache->samplers.end()) {
+        cache->hits++;
+        it->second.refCount++;
+        return it->second.sampler;
+    }
+
+    VkSampler sampler = VK_NULL_HANDLE;
+    VkResult result = vkCreateSampler(deviceInfo->device, &createInfo, nullptr, &sampler);
+    if (!validateResult(result, "vkCreateSampler")) {
+        return VK_NULL_HANDLE;
+    }
+
+    cache->misses++;
+    cache->samplerKeys[samplerHandleKey(sampler)] = key;
+    SamplerCache::Entry& entry = cache->samplers[std::move(key)];
+    entry.sampler = sampler;
+    entry.refCount = 1;
+    LOGI("✓ Sampler created: %p (%zu cached)", (void*)sampler, cache->samplers.size());
+    return sampler;
+}
+
+void releaseSampler(DeviceInfo* deviceInfo, VkSampler sampler) {
+    SamplerCache* cache = getCache(deviceInfo);
+    if (!cache || sampler == VK_NULL_HANDLE) return;
+
+    std::lock_guard<std::mutex> lock(cache->mutex);
+    auto keyIt = cache->samplerKeys.find(samplerHandleKey(sampler));
+    if (keyIt == cache->samplerKeys.end()) return;
+
+    // 引用计数归零也保留：layout 可能把它固化为 immutable sampler
+    SamplerCache::Entry& entry = cache->samplers[keyIt->second];
+    if (entry.refCount > 0) entry.refCount--;
+}
+
+bool getSamplerKey(DeviceInfo* deviceInfo, VkSampler sampler, std::string* key) {
+    SamplerCache* cache = getCache(deviceInfo);
+    if (!cache || sampler == VK_NULL_HANDLE) return false;
+
+    std::lock_guard<std::mutex> lock(cache->mutex);
+    auto it = cache->samplerKeys.find(samplerHandleKey(sampler));
+    if (it == cache->samplerKeys.end()) return false;
+    *key = it->second;
+    return true;
+}
@@ -0,0 +1,41 @@
+//
+// Device-level sampler cache keyed by the full create info, shared immutable samplers.
+//
+// 之前每个滤镜通过自己的 nativeCreateSampler 创建 VkSampler（Affine 两个、Fused、SimpleVulkanFilter、
+// 缩放器各一个），参数几乎相同；测试纹理还会再建一个、而且从不销毁。sampler 是驱动侧的有限资源
+// （maxSamplerAllocationCount，部分移动 GPU 只有 4000），也无法被 pipeline registry 按内容比较。
+//
+// acquireSampler 按完整的 VkSamplerCreateInfo 查找或创建 sampler：
+// - 键先规范化：不影响结果的字段不参与比较（maxLod == minLod == 0 时的 mipmapMode、
+//   未开启各向异性时的 maxAnisotropy、未开启比较时的 compareOp、没有 CLAMP_TO_BORDER 时的 borderColor）；
+// - pNext 链逐个纳入键：VkSamplerYcbcrConversionInfo（按 conversion 句柄）、
+//   VkSamplerReductionModeCreateInfo。链上出现其他结构时拒绝创建，避免把不同的 sampler 当成同一个。
+// 引用计数归零后保留到设备销毁，所以缓存中的句柄不会被销毁后复用：descriptor set layout 可以把它们
+// 作为 immutable sampler 固化（见 acquireReflectedLayout），pipeline registry 也能按内容键比较这些 layout。
+//
+// 带 YCbCr conversion 的 sampler 只能作为 immutable sampler 使用（规范要求），
+// 调用方必须把它传给 acquireReflectedLayout，而不是在写描述符时提供。
+//
+#ifndef VULKAN_SAMPLERS_H
+#define VULKAN_SAMPLERS_H
+
+#include <vulkan/vulkan.h>
+#include <string>
+#include "Vulkantypes.h"
+
+// 创建设备后调用
+void createSamplerCache(DeviceInfo* deviceInfo);
+
+// 销毁所有 sampler；在 destroyLayoutCache 之后调用（layout 引用 immutable sampler）
+void destroySamplerCache(DeviceInfo* deviceInfo);
+
+// 查找或创建与 createInfo 等价的 sampler，引用计数 +1；失败返回 VK_NULL_HANDLE
+VkSampler acquireSampler(DeviceInfo* deviceInfo, const VkSamplerCreateInfo& createInfo);
+
+// 引用计数 -1；sampler 不在缓存中时忽略
+void releaseSampler(DeviceInfo* deviceInfo, VkSampler sampler);
+
+// 缓存中的 sampler 的内容键（规范化的 create info）；不是缓存创建的 sampler 时返回 false
+bool getSamplerKey(DeviceInfo* deviceInfo, VkSampler sampler, std::string* key);
+
+#endif // VULKAN_SAMPLERS_H
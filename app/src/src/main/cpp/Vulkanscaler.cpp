@@ -0,0 +1,603 @@
+//
+// Separable high-quality scaler: two compute passes driven by precomputed weight tables.
+//
+#include "Vulkanjni.h"
+#include "Vulkanscaler.h"
+#include "Vulkanbarriers.h"
+#include "Vulkancompute.h"
+#include "Vulkanpipelineregistry.h"
+#include "Vulkansamplers.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+using namespace VulkanJNI;
+
+extern uint32_t findMemoryType(VkPhysicalDevice physicalDevice, uint32_t typeFilter, VkMemoryPropertyFlags properties);
+
+namespace {
+
+    // 与 scale.comp 的 push constant 块一致
+    struct ScalerPushConstants {
+        int32_t region[4];  // 本次 dispatch 覆盖的输出区域 x, y, width, height
+        int32_t pass[4];    // 方向（0 水平 / 1 垂直）、taps、该方向最大源索引、未使用
+    };
+    static_assert(sizeof(ScalerPushConstants) == 32, "push constant layout");
+
+    // 每个 scaler 最多同时存在的 set（水平：每个输入视图一个；垂直：每个输出视图一个）
+    constexpr uint32_t kMaxSets = 16;
+
+} // anonymous namespace
+
+// ============================================
+// Scaler
+// ============================================
+
+struct Scaler {
+    DeviceInfo* deviceInfo = nullptr;
+    VkDescriptorSetLayout setLayout = VK_NULL_HANDLE;
+    VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
+    VkSampler sampler = VK_NULL_HANDLE;  // texelFetch 不使用过滤，只为满足 combined image sampler
+
+    ScalerKernel kernel = ScalerKernel::Lanczos3;
+
+    // 当前配置（configureScaler 比较这些值决定是否重建）
+    bool configured = false;
+    ScalerKernel configuredKernel = ScalerKernel::Lanczos3;
+    VkExtent2D srcExtent = {0, 0};
+    VkExtent2D dstExtent = {0, 0};
+    float mapping[4] = {};  // scaleX, offsetX, scaleY, offsetY
+
+    // 权重表：0 水平（每个输出列），1 垂直（每个输出行）
+    std::shared_ptr<const ScalerTable> tables[2];
+    VkBuffer tableBuffers[2] = {VK_NULL_HANDLE, VK_NULL_HANDLE};
+    VkDeviceMemory tableMemory[2] = {VK_NULL_HANDLE, VK_NULL_HANDLE};
+
+    // 水平 pass 的结果：dstW × srcH
+    VkImage intermediate = VK_NULL_HANDLE;
+    VkDeviceMemory intermediateMemory = VK_NULL_HANDLE;
+    VkImageView intermediateView = VK_NULL_HANDLE;
+
+    // 光栅化路径的输出（第一次需要时创建）：dstW × dstH
+    VkImage output = VK_NULL_HANDLE;
+    VkDeviceMemory outputMemory = VK_NULL_HANDLE;
+    VkImageView outputView = VK_NULL_HANDLE;
+
+    std::unordered_map<VkImageView, VkDescriptorSet> horizontalSets;  // 输入视图 -> set
+    std::unordered_map<VkImageView, VkDescriptorSet> verticalSets;    // 输出视图 -> set
+};
+
+namespace {
+
+    void destroyTableBuffers(Scaler* scaler) {
+        VkDevice device = scaler->deviceInfo->device;
+        for (int i = 0; i < 2; ++i) {
+            if (scaler->tableBuffers[i] != VK_NULL_HANDLE) vkDestroyBuffer(device, scaler->tableBuffers[i], nullptr);
+            if (scaler->tableMemory[i] != VK_NULL_HANDLE) vkFreeMemory(device, scaler->tableMemory[i], nullptr);
+            scaler->tableBuffers[i] = VK_NULL_HANDLE;
+            scaler->tableMemory[i] = VK_NULL_HANDLE;
+        }
+    }
+
+    // 表只在配置变化时写一次，host-visible 即可（读取量远小于图像）
+    bool uploadTable(Scaler* scaler, int index) {
+        DeviceInfo* deviceInfo = scaler->deviceInfo;
+        const ScalerTable& table = *scaler->tables[index];
+        const VkDeviceSize size = table.data.size() * sizeof(float);
+
+        VkBufferCreateInfo bufferInfo{};
+        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bufferInfo.size = size;
+        bufferInfo.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+        VkResult result = vkCreateBuffer(deviceInfo->device, &bufferInfo, nullptr, &scaler->tableBuffers[index]);
+        if (!validateResult(result, "vkCreateBuffer (scaler table)")) return false;
+
+        VkMemoryRequirements memRequirements;
+        vkGetBufferMemoryRequirements(deviceInfo->device, scaler->tableBuffers[index], &memRequirements);
+
+        VkMemoryAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocInfo.allocationSize = memRequirements.size;
+        allocInfo.memoryTypeIndex = findMemoryType(
+                deviceInfo->physicalDevice,
+                memRequirements.memoryTypeBits,
+                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+        );
+
+        result = vkAllocateMemory(deviceInfo->device, &allocInfo, nullptr, &scaler->tableMemory[index]);
+        if (!validateResult(result, "vkAllocateMemory (scaler table)")) return false;
+        vkBindBufferMemory(deviceInfo->device, scaler->tableBuffers[index], scaler->tableMemory[index], 0);
+
+        void* data = nullptr;
+        result = vkMapMemory(deviceInfo->device, scaler->tableMemory[index], 0, size, 0, &data);
+        if (!validateResult(result, "vkMapMemory (scaler table)")) return false;
+        std::memcpy(data, table.data.data(), static_cast<size_t>(size));
+        vkUnmapMemory(deviceInfo->device, scaler->tableMemory[index]);
+        return true;
+    }
+
+    void resetDescriptorSets(Scaler* scaler) {
+        vkResetDescriptorPool(scaler->deviceInfo->device, scaler->descriptorPool, 0);
+        scaler->horizontalSets.clear();
+        scaler->verticalSets.clear();
+    }
+
+    // binding 0：采样输入；binding 1：存储输出；binding 2：权重表
+    VkDescriptorSet allocateSet(Scaler* scaler, VkImageView inputView, VkImageView outputView, int table) {
+        DeviceInfo* deviceInfo = scaler->deviceInfo;
+
+        VkDescriptorSetAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocInfo.descriptorPool = scaler->descriptorPool;
+        allocInfo.descriptorSetCount = 1;
+        allocInfo.pSetLayouts = &scaler->setLayout;
+
+        VkDescriptorSet set = VK_NULL_HANDLE;
+        VkResult result = vkAllocateDescriptorSets(deviceInfo->device, &allocInfo, &set);
+        if (!validateResult(result, "vkAllocateDescriptorSets (scaler)")) {
+            return VK_NULL_HANDLE;
+        }
+
+        VkDescriptorImageInfo imageInfos[2] = {};
+        imageInfos[0].sampler = scaler->sampler;
+        imageInfos[0].imageView = inputView;
+        imageInfos[0].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        imageInfos[1].imageView = outputView;
+        imageInfos[1].imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+        VkDescriptorBufferInfo bufferInfo{};
+        bufferInfo.buffer = scaler->tableBuffers[table];
+        bufferInfo.offset = 0;
+        bufferInfo.range = VK_WHOLE_SIZE;
+
+        VkWriteDescriptorSet writes[3] = {};
+        for (uint32_t i = 0; i < 3; ++i) {
+            writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writes[i].dstSet = set;
+            writes[i].dstBinding = i;
+            writes[i].descriptorCount = 1;
+        }
+        writes[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        writes[0].pImageInfo = &imageInfos[0];
+        writes[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+        writes[1].pImageInfo = &imageInfos[1];
+        writes[2].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        writes[2].pBufferInfo = &bufferInfo;
+
+        vkUpdateDescriptorSets(deviceInfo->device, 3, writes, 0, nullptr);
+        return set;
+    }
+
+    // 视图只在交换链/输入纹理重建时变化（此时队列已空闲），池满时整体重置
+    VkDescriptorSet findSet(Scaler* scaler, bool vertical, VkImageView key) {
+        auto& sets = vertical ? scaler->verticalSets : scaler->horizontalSets;
+        auto it = sets.find(key);
+        if (it != sets.end()) {
+            return it->second;
+        }
+        if (scaler->horizontalSets.size() + scaler->verticalSets.size() + 2 > kMaxSets) {
+            resetDescriptorSets(scaler);
+        }
+        VkDescriptorSet set = vertical
+                ? allocateSet(scaler, scaler->intermediateView, key, 1)
+                : allocateSet(scaler, key, scaler->intermediateView, 0);
+        if (set != VK_NULL_HANDLE) {
+            sets[key] = set;
+        }
+        return set;
+    }
+
+    // 输出行 [y, y + height) 的垂直 pass 读取的中间图像行（源行）
+    void sourceRows(const ScalerTable& table, uint32_t srcSize, int32_t y, int32_t height,
+                    int32_t* first, int32_t* last) {
+        int64_t lo = INT64_MAX;
+        int64_t hi = INT64_MIN;
+        for (int32_t i = y; i < y + height; ++i) {
+            const int64_t start = static_cast<int64_t>(table.data[static_cast<size_t>(i) * (table.taps + 1)]);
+            lo = std::min(lo, start);
+            hi = std::max(hi, start + static_cast<int64_t>(table.taps) - 1);
+        }
+        const int64_t maxRow = static_cast<int64_t>(srcSize) - 1;
+        *first = static_cast<int32_t>(std::min(std::max(lo, int64_t{0}), maxRow));
+        *last = static_cast<int32_t>(std::min(std::max(hi, int64_t{0}), maxRow));
+    }
+
+    void dispatchPass(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, VkShaderStageFlags stages,
+                      const VkRect2D& region, int32_t vertical, const ScalerTable& table, uint32_t srcSize) {
+        ScalerPushConstants constants{};
+        constants.region[0] = region.offset.x;
+        constants.region[1] = region.offset.y;
+        constants.region[2] = static_cast<int32_t>(region.extent.width);
+        constants.region[3] = static_cast<int32_t>(region.extent.height);
+        constants.pass[0] = vertical;
+        constants.pass[1] = static_cast<int32_t>(table.taps);
+        constants.pass[2] = static_cast<int32_t>(srcSize) - 1;
+        vkCmdPushConstants(commandBuffer, pipelineLayout, stages, 0, sizeof(constants), &constants);
+        vkCmdDispatch(commandBuffer, (region.extent.width + 15) / 16, (region.extent.height + 15) / 16, 1);
+    }
+
+} // anonymous namespace
+
+Scaler* createScaler(DeviceInfo* deviceInfo, VkDescriptorSetLayout setLayout, ScalerKernel kernel) {
+    auto* scaler = new Scaler();
+    scaler->deviceInfo = deviceInfo;
+    scaler->setLayout = setLayout;
+    scaler->kernel = kernel;
+
+    VkDescriptorPoolSize poolSizes[3] = {};
+    poolSizes[0].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    poolSizes[0].descriptorCount = kMaxSets;
+    poolSizes[1].type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    poolSizes[1].descriptorCount = kMaxSets;
+    poolSizes[2].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    poolSizes[2].descriptorCount = kMaxSets;
+
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.maxSets = kMaxSets;
+    poolInfo.poolSizeCount = 3;
+    poolInfo.pPoolSizes = poolSizes;
+
+    VkResult result = vkCreateDescriptorPool(deviceInfo->device, &poolInfo, nullptr, &scaler->descriptorPool);
+    if (!validateResult(result, "vkCreateDescriptorPool (scaler)")) {
+        destroyScaler(scaler);
+        return nullptr;
+    }
+
+    VkSamplerCreateInfo samplerInfo{};
+    samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerInfo.magFilter = VK_FILTER_NEAREST;
+    samplerInfo.minFilter = VK_FILTER_NEAREST;
+    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.maxAnisotropy = 1.0f;
+    samplerInfo.compareOp = VK_COMPARE_OP_ALWAYS;
+    samplerInfo.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
+
+    scaler->sampler = acquireSampler(deviceInfo, samplerInfo);
+    if (scaler->sampler == VK_NULL_HANDLE) {
+        destroyScaler(scaler);
+        return nullptr;
+    }
+    return scaler;
+}
+
+void destroyScaler(Scaler* scaler) {
+    if (!scaler) return;
+    DeviceInfo* deviceInfo = scaler->deviceInfo;
+    destroyTableBuffers(scaler);
+    destroyStorageImage(deviceInfo, &scaler->intermediate, &scaler->intermediateMemory, &scaler->intermediateView);
+    destroyStorageImage(deviceInfo, &scaler->output, &scaler->outputMemory, &scaler->outputView);
+    releaseSampler(deviceInfo, scaler->sampler);
+    if (scaler->descriptorPool != VK_NULL_HANDLE) {
+        vkDestroyDescriptorPool(deviceInfo->device, scaler->descriptorPool, nullptr);
+    }
+    delete scaler;
+}
+
+void setScalerKernel(Scaler* scaler, ScalerKernel kernel) {
+    scaler->kernel = kernel;
+}
+
+bool configureScaler(Scaler* scaler, VkExtent2D srcExtent, VkExtent2D dstExtent, const float matrix[16]) {
+    // u' = m[0] u + m[4] v + m[12]，v' = m[1] u + m[5] v + m[13]：交叉项不为 0 时无法分离
+    constexpr float kEpsilon = 1e-6f;
+    if (std::fabs(matrix[1]) > kEpsilon || std::fabs(matrix[4]) > kEpsilon ||
+        std::fabs(matrix[0]) < kEpsilon || std::fabs(matrix[5]) < kEpsilon) {
+        return false;
+    }
+    if (srcExtent.width == 0 || srcExtent.height == 0 || dstExtent.width == 0 || dstExtent.height == 0) {
+        return false;
+    }
+
+    const float mapping[4] = {matrix[0], matrix[12], matrix[5], matrix[13]};
+    if (scaler->configured && scaler->configuredKernel == scaler->kernel &&
+        scaler->srcExtent.width == srcExtent.width && scaler->srcExtent.height == srcExtent.height &&
+        scaler->dstExtent.width == dstExtent.width && scaler->dstExtent.height == dstExtent.height &&
+        std::memcmp(scaler->mapping, mapping, sizeof(mapping)) == 0) {
+        return true;
+    }
+
+    // 旧的表、中间图像和 set 可能仍被未完成的帧使用
+    DeviceInfo* deviceInfo = scaler->deviceInfo;
+    vkQueueWaitIdle(deviceInfo->graphicsQueue);
+    scaler->configured = false;
+    resetDescriptorSets(scaler);
+    destroyTableBuffers(scaler);
+
+    scaler->tables[0] = getScalerTable(scaler->kernel, srcExtent.width, dstExtent.width, mapping[0], mapping[1]);
+    scaler->tables[1] = getScalerTable(scaler->kernel, srcExtent.height, dstExtent.height, mapping[2], mapping[3]);
+    if (!uploadTable(scaler, 0) || !uploadTable(scaler, 1)) {
+        destroyTableBuffers(scaler);
+        return false;
+    }
+
+    if (scaler->intermediate == VK_NULL_HANDLE ||
+        scaler->dstExtent.width != dstExtent.width || scaler->srcExtent.height != srcExtent.height) {
+        destroyStorageImage(deviceInfo, &scaler->intermediate, &scaler->intermediateMemory, &scaler->intermediateView);
+        if (!createStorageImage(deviceInfo, dstExtent.width, srcExtent.height, VK_IMAGE_USAGE_SAMPLED_BIT,
+                                &scaler->intermediate, &scaler->intermediateMemory, &scaler->intermediateView)) {
+            destroyStorageImage(deviceInfo, &scaler->intermediate, &scaler->intermediateMemory,
+                                &scaler->intermediateView);
+            return false;
+        }
+    }
+    if (scaler->dstExtent.width != dstExtent.width || scaler->dstExtent.height != dstExtent.height) {
+        destroyStorageImage(deviceInfo, &scaler->output, &scaler->outputMemory, &scaler->outputView);
+    }
+
+    scaler->configuredKernel = scaler->kernel;
+    scaler->srcExtent = srcExtent;
+    scaler->dstExtent = dstExtent;
+    std::memcpy(scaler->mapping, mapping, sizeof(mapping));
+    scaler->configured = true;
+    LOGI("Scaler configured: %ux%u -> %ux%u, kernel %d, taps %u x %u",
+         srcExtent.width, srcExtent.height, dstExtent.width, dstExtent.height,
+         static_cast<int32_t>(scaler->kernel), scaler->tables[0]->taps, scaler->tables[1]->taps);
+    return true;
+}
+
+void recordScaler(Scaler* scaler, VkCommandBuffer commandBuffer,
+                  VkPipeline pipeline, VkPipelineLayout pipelineLayout, VkShaderStageFlags pushConstantStages,
+                  VkImageView inputView, VkImageView outputView, const std::vector<VkRect2D>& rects) {
+    if (!scaler->configured) {
+        return;
+    }
+    DeviceInfo* deviceInfo = scaler->deviceInfo;
+    const VkExtent2D src = scaler->srcExtent;
+    const VkExtent2D dst = scaler->dstExtent;
+
+    const bool ownOutput = outputView == VK_NULL_HANDLE;
+    if (ownOutput) {
+        if (scaler->output == VK_NULL_HANDLE &&
+            !createStorageImage(deviceInfo, dst.width, dst.height, VK_IMAGE_USAGE_SAMPLED_BIT,
+                                &scaler->output, &scaler->outputMemory, &scaler->outputView)) {
+            destroyStorageImage(deviceInfo, &scaler->output, &scaler->outputMemory, &scaler->outputView);
+            return;
+        }
+        outputView = scaler->outputView;
+    }
+
+    // 裁剪到输出范围；垂直 pass 的每个矩形需要水平 pass 先算出对应列、对应源行的中间结果
+    std::vector<VkRect2D> verticalRegions;
+    std::vector<VkRect2D> horizontalRegions;
+    bool fullFrame = false;
+    for (const VkRect2D& rect : rects) {
+        const int32_t x0 = std::max(rect.offset.x, 0);
+        const int32_t y0 = std::max(rect.offset.y, 0);
+        const int32_t x1 = std::min(rect.offset.x + static_cast<int32_t>(rect.extent.width),
+                                    static_cast<int32_t>(dst.width));
+        const int32_t y1 = std::min(rect.offset.y + static_cast<int32_t>(rect.extent.height),
+                                    static_cast<int32_t>(dst.height));
+        if (x1 <= x0 || y1 <= y0) continue;
+
+        VkRect2D region = {{x0, y0}, {static_cast<uint32_t>(x1 - x0), static_cast<uint32_t>(y1 - y0)}};
+        verticalRegions.push_back(region);
+        fullFrame = fullFrame || (region.extent.width == dst.width && region.extent.height == dst.height);
+
+        int32_t firstRow = 0;
+        int32_t lastRow = 0;
+        sourceRows(*scaler->tables[1], src.height, y0, y1 - y0, &firstRow, &lastRow);
+        horizontalRegions.push_back({{x0, firstRow}, {region.extent.width, static_cast<uint32_t>(lastRow - firstRow + 1)}});
+    }
+    if (verticalRegions.empty()) {
+        return;
+    }
+
+    VkDescriptorSet horizontalSet = findSet(scaler, false, inputView);
+    VkDescriptorSet verticalSet = findSet(scaler, true, outputView);
+    if (horizontalSet == VK_NULL_HANDLE || verticalSet == VK_NULL_HANDLE) {
+        return;
+    }
+
+    // 中间图像每帧按需重算，不保留内容；自己的输出只有整帧覆盖时才能丢弃
+    ImageBarrierBatch barriers;
+    requireImageUse(deviceInfo, &barriers, scaler->intermediate, ImageUses::kStorageWrite, true);
+    if (ownOutput) {
+        requireImageUse(deviceInfo, &barriers, scaler->output, ImageUses::kStorageWrite, fullFrame);
+    }
+    flushImageBarriers(deviceInfo, &barriers, commandBuffer);
+
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout,
+                            0, 1, &horizontalSet, 0, nullptr);
+    for (const VkRect2D& region : horizontalRegions) {
+        dispatchPass(commandBuffer, pipelineLayout, pushConstantStages, region, 0, *scaler->tables[0], src.width);
+    }
+
+    requireImageUse(deviceInfo, &barriers, scaler->intermediate, ImageUses::kSampled);
+    flushImageBarriers(deviceInfo, &barriers, commandBuffer);
+
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout,
+                            0, 1, &verticalSet, 0, nullptr);
+    for (const VkRect2D& region : verticalRegions) {
+        dispatchPass(commandBuffer, pipelineLayout, pushConstantStages, region, 1, *scaler->tables[1], src.height);
+    }
+
+    if (ownOutput) {
+        requireImageUse(deviceInfo, &barriers, scaler->output, ImageUses::kSampled);
+        flushImageBarriers(deviceInfo, &barriers, commandBuffer);
+    }
+}
+
+VkImageView getScalerOutputView(Scaler* scaler) {
+    return scaler->outputView;
+}
+
+// ============================================
+// JNI
+// ============================================
+
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_genymobile_scrcpy_vulkan_ScalerVulkanFilter_nativeCreateShaderModule(
+        JNIEnv* env, jobject /* this */, jlong deviceHandle, jbyteArray codeArray) {
+
+    DeviceInfo* deviceInfo = getDeviceInfo(deviceHandle);
+    if (!validateHandle(deviceInfo, "device") || !codeArray) {
+        return 0;
+    }
+    const jsize size = env->GetArrayLength(codeArray);
+    if (size < 20 || size % 4 != 0) {
+        LOGE("Invalid SPIR-V size: %d bytes", size);
+        return 0;
+    }
+
+    // 按 uint32_t 对齐复制
+    std::vector<uint32_t> code(size / 4);
+    env->GetByteArrayRegion(codeArray, 0, size, reinterpret_cast<jbyte*>(code.data()));
+
+    VkShaderModuleCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    createInfo.codeSize = static_cast<size_t>(size);
+    createInfo.pCode = code.data();
+
+    VkShaderModule shaderModule = VK_NULL_HANDLE;
+    VkResult result = vkCreateShaderModule(deviceInfo->device, &createInfo, nullptr, &shaderModule);
+    if (!validateResult(result, "vkCreateShaderModule (scaler)")) {
+        return 0;
+    }
+    registerShaderModule(deviceInfo, shaderModule, code.data(), static_cast<size_t>(size));
+    return toHandle(shaderModule);
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_genymobile_scrcpy_vulkan_ScalerVulkanFilter_nativeDestroyShaderModule(
+        JNIEnv* env, jobject /* this */, jlong deviceHandle, jlong shaderModuleHandle) {
+
+    DeviceInfo* deviceInfo = getDeviceInfo(deviceHandle);
+    VkShaderModule shaderModule = fromHandle<VkShaderModule>(shaderModuleHandle);
+    if (validateHandle(deviceInfo, "device") && shaderModule != VK_NULL_HANDLE) {
+        unregisterShaderModule(deviceInfo, shaderModule);
+        vkDestroyShaderModule(deviceInfo->device, shaderModule, nullptr);
+    }
+}
+
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_genymobile_scrcpy_vulkan_ScalerVulkanFilter_nativeCreate(
+        JNIEnv* env, jobject /* this */, jlong deviceHandle, jlong setLayoutHandle, jint kernel) {
+
+    DeviceInfo* deviceInfo = getDeviceInfo(deviceHandle);
+    VkDescriptorSetLayout setLayout = fromHandle<VkDescriptorSetLayout>(setLayoutHandle);
+    if (!validateHandle(deviceInfo, "device") || !validateHandle(setLayout, "descriptorSetLayout")) {
+        return 0;
+    }
+    if (!isValidScalerKernel(kernel)) {
+        LOGE("Invalid scaler kernel: %d", kernel);
+        return 0;
+    }
+    return toHandle(createScaler(deviceInfo, setLayout, static_cast<ScalerKernel>(kernel)));
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_genymobile_scrcpy_vulkan_ScalerVulkanFilter_nativeDestroy(
+        JNIEnv* env, jobject /* this */, jlong scalerHandle) {
+    destroyScaler(fromHandle<Scaler*>(scalerHandle));
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_genymobile_scrcpy_vulkan_ScalerVulkanFilter_nativeSetKernel(
+        JNIEnv* env, jobject /* this */, jlong scalerHandle, jint kernel) {
+
+    Scaler* scaler = fromHandle<Scaler*>(scalerHandle);
+    if (!validateHandle(scaler, "scaler")) {
+        return;
+    }
+    if (!isValidScalerKernel(kernel)) {
+        LOGE("Invalid scaler kernel: %d", kernel);
+        return;
+    }
+    setScalerKernel(scaler, static_cast<ScalerKernel>(kernel));
+}
+
+// matrix：输出 uv → 输入 uv（4x4 列主序）；含旋转/错切时返回 false
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_genymobile_scrcpy_vulkan_ScalerVulkanFilter_nativeConfigure(
+        JNIEnv* env, jobject /* this */,
+        jlong scalerHandle,
+        jint srcWidth,
+        jint srcHeight,
+        jint dstWidth,
+        jint dstHeight,
+        jfloatArray matrixArray) {
+
+    Scaler* scaler = fromHandle<Scaler*>(scalerHandle);
+    if (!validateHandle(scaler, "scaler") || !matrixArray || env->GetArrayLength(matrixArray) < 16 ||
+        srcWidth <= 0 || srcHeight <= 0 || dstWidth <= 0 || dstHeight <= 0) {
+        return JNI_FALSE;
+    }
+
+    float matrix[16];
+    env->GetFloatArrayRegion(matrixArray, 0, 16, matrix);
+    const VkExtent2D src = {static_cast<uint32_t>(srcWidth), static_cast<uint32_t>(srcHeight)};
+    const VkExtent2D dst = {static_cast<uint32_t>(dstWidth), static_cast<uint32_t>(dstHeight)};
+    return configureScaler(scaler, src, dst, matrix) ? JNI_TRUE : JNI_FALSE;
+}
+
+// outputViewHandle 为 0 时写 scaler 自己的输出图像；rects 为 x, y, w, h 序列
+extern "C" JNIEXPORT void JNICALL
+Java_com_genymobile_scrcpy_vulkan_ScalerVulkanFilter_nativeRecord(
+        JNIEnv* env, jobject /* this */,
+        jlong scalerHandle,
+        jlong commandBufferHandle,
+        jlong pipelineHandle,
+        jlong pipelineLayoutHandle,
+        jint stageFlags,
+        jlong inputViewHandle,
+        jlong outputViewHandle,
+        jintArray rectArray) {
+
+    Scaler* scaler = fromHandle<Scaler*>(scalerHandle);
+    VkCommandBuffer commandBuffer = fromHandle<VkCommandBuffer>(commandBufferHandle);
+    VkPipeline pipeline = fromHandle<VkPipeline>(pipelineHandle);
+    VkPipelineLayout pipelineLayout = fromHandle<VkPipelineLayout>(pipelineLayoutHandle);
+    VkImageView inputView = fromHandle<VkImageView>(inputViewHandle);
+    if (!validateHandle(scaler, "scaler") || !validateHandle(commandBuffer, "commandBuffer") ||
+        !validateHandle(pipeline, "pipeline") || !validateHandle(pipelineLayout, "pipelineLayout") ||
+        !validateHandle(inputView, "inputView") || !rectArray) {
+        return;
+    }
+
+    const jsize count = env->GetArrayLength(rectArray);
+    std::vector<jint> values(count);
+    env->GetIntArrayRegion(rectArray, 0, count, values.data());
+
+    std::vector<VkRect2D> rects;
+    for (jsize i = 0; i + 3 < count; i += 4) {
+        if (values[i + 2] <= 0 || values[i + 3] <= 0) continue;
+        rects.push_back({{values[i], values[i + 1]},
+                         {static_cast<uint32_t>(values[i + 2]), static_cast<uint32_t>(values[i + 3])}});
+    }
+
+    recordScaler(scaler, commandBuffer, pipeline, pipelineLayout, static_cast<VkShaderStageFlags>(stageFlags),
+                 inputView, fromHandle<VkImageView>(outputViewHandle), rects);
+}
+
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_genymobile_scrcpy_vulkan_ScalerVulkanFilter_nativeGetOutputView(
+        JNIEnv* env, jobject /* this */, jlong scalerHandle) {
+    Scaler* scaler = fromHandle<Scaler*>(scalerHandle);
+    return validateHandle(scaler, "scaler") ? toHandle(getScalerOutputView(scaler)) : 0;
+}
+
+// 返回 [psnr, aliasing]（dB）；hardwareBilinear 为 true 时忽略 kernel
+extern "C" JNIEXPORT jdoubleArray JNICALL
+Java_com_genymobile_scrcpy_vulkan_ScalerVulkanFilter_nativeMeasureQuality(
+        JNIEnv* env, jobject /* this */, jint kernel, jint srcSize, jint dstSize, jboolean hardwareBilinear) {
+
+    if (!isValidScalerKernel(kernel) || srcSize <= 0 || dstSize <= 0) {
+        return nullptr;
+    }
+    const ScalerQuality quality = measureScalerQuality(static_cast<ScalerKernel>(kernel),
+                                                       static_cast<uint32_t>(srcSize),
+                                                       static_cast<uint32_t>(dstSize),
+                                                       hardwareBilinear == JNI_TRUE);
+    const jdouble values[2] = {quality.psnr, quality.aliasing};
+    jdoubleArray array = env->NewDoubleArray(2);
+    env->SetDoubleArrayRegion(array, 0, 2, values);
+    return array;
+}
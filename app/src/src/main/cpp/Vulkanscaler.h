@@ -0,0 +1,52 @@
+//
+// Separable high-quality scaler: two compute passes driven by precomputed weight tables.
+//
+// 硬件双线性每个输出像素只读 2x2 个源像素，缩小（例如 1440p 手机屏幕缩到小窗口）时大部分源像素
+// 根本没有参与，高频细节折叠成摩尔纹。逐像素在片段着色器里做 Lanczos 又要读 (2R)² 个像素，太慢。
+//
+// 这里把二维卷积拆成两个一维 pass（scale.comp，同一个计算着色器）：
+// - 水平 pass：输入纹理 → 中间图像（dstW × srcH），每个输出列读 taps 个源像素；
+// - 垂直 pass：中间图像 → 输出（dstW × dstH），每个输出行读 taps 个中间像素。
+// 缩小时核函数按缩放比例展宽（taps ≈ 2 × 支撑半径 × 缩放比例），所有源像素都参与滤波。
+//
+// 权重表（Vulkanscalertable.h）在 CPU 上计算一次并归一化，进程内缓存最近使用的几张，
+// 上传到 host-visible 存储缓冲。着色器里没有任何核函数计算，只有乘加。
+//
+// 中间图像是 rgba8：负瓣产生的过冲在水平 pass 之后就被截断，与逐像素实现相比误差在 1 LSB 量级。
+//
+#ifndef VULKAN_SCALER_H
+#define VULKAN_SCALER_H
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "Vulkanscalertable.h"
+#include "Vulkantypes.h"
+
+struct Scaler;
+
+// setLayout 来自 scale.comp 的反射（binding 0 采样输入，1 存储输出，2 权重缓冲）
+Scaler* createScaler(DeviceInfo* deviceInfo, VkDescriptorSetLayout setLayout, ScalerKernel kernel);
+
+// 调用前 GPU 不能再使用它的资源
+void destroyScaler(Scaler* scaler);
+
+// 下一次 configureScaler 时按新的核函数换表
+void setScalerKernel(Scaler* scaler, ScalerKernel kernel);
+
+// 源/目标尺寸和输出 uv → 输入 uv 矩阵（4x4 列主序）。矩阵含旋转/错切时返回 false。
+// 尺寸或映射变化时等待设备空闲后重建中间图像、权重缓冲和 descriptor set（只在窗口尺寸、
+// 变换改变时发生）；没有变化时什么都不做
+bool configureScaler(Scaler* scaler, VkExtent2D srcExtent, VkExtent2D dstExtent, const float matrix[16]);
+
+// 录制两个 pass，只覆盖 rects（x, y, w, h；输出像素）。
+// outputView 为 VK_NULL_HANDLE 时写 scaler 自己的输出图像，之后转换到采样布局（光栅化路径用
+// getScalerOutputView 1:1 绘制）；否则由调用方保证 outputView 已处于 GENERAL（计算输出路径）
+void recordScaler(Scaler* scaler, VkCommandBuffer commandBuffer,
+                  VkPipeline pipeline, VkPipelineLayout pipelineLayout, VkShaderStageFlags pushConstantStages,
+                  VkImageView inputView, VkImageView outputView, const std::vector<VkRect2D>& rects);
+
+VkImageView getScalerOutputView(Scaler* scaler);
+
+#endif // VULKAN_SCALER_H
@@ -0,0 +1,237 @@
+//
+// Scaler weight tables: kernels, per-axis tables and the CPU reference used by Vulkanscaler.
+//
+#include "Vulkanscalertable.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <mutex>
+#include <tuple>
+
+namespace {
+
+    constexpr double kPi = 3.14159265358979323846;
+
+    // ============================================
+    // Kernels
+    // ============================================
+
+    double sinc(double x) {
+        if (std::fabs(x) < 1e-8) return 1.0;
+        const double px = kPi * x;
+        return std::sin(px) / px;
+    }
+
+    // Mitchell-Netravali 两参数三次核
+    double cubic(double x, double b, double c) {
+        x = std::fabs(x);
+        if (x < 1.0) {
+            return ((12.0 - 9.0 * b - 6.0 * c) * x * x * x +
+                    (-18.0 + 12.0 * b + 6.0 * c) * x * x +
+                    (6.0 - 2.0 * b)) / 6.0;
+        }
+        if (x < 2.0) {
+            return ((-b - 6.0 * c) * x * x * x +
+                    (6.0 * b + 30.0 * c) * x * x +
+                    (-12.0 * b - 48.0 * c) * x +
+                    (8.0 * b + 24.0 * c)) / 6.0;
+        }
+        return 0.0;
+    }
+
+    double kernelSupport(ScalerKernel kernel) {
+        switch (kernel) {
+            case ScalerKernel::Bilinear: return 1.0;
+            case ScalerKernel::Lanczos3: return 3.0;
+            default: return 2.0;
+        }
+    }
+
+    double evaluateKernel(ScalerKernel kernel, double x) {
+        switch (kernel) {
+            case ScalerKernel::Bilinear: return std::max(0.0, 1.0 - std::fabs(x));
+            case ScalerKernel::Bicubic: return cubic(x, 0.0, 0.5);
+            case ScalerKernel::Mitchell: return cubic(x, 1.0 / 3.0, 1.0 / 3.0);
+            case ScalerKernel::Lanczos2: return std::fabs(x) < 2.0 ? sinc(x) * sinc(x / 2.0) : 0.0;
+            case ScalerKernel::Lanczos3: return std::fabs(x) < 3.0 ? sinc(x) * sinc(x / 3.0) : 0.0;
+        }
+        return 0.0;
+    }
+
+    // ============================================
+    // Table Cache
+    // ============================================
+
+    uint32_t floatBits(float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    using TableKey = std::tuple<int32_t, uint32_t, uint32_t, uint32_t, uint32_t>;
+
+    // 最近使用的在前；只有几项，线性查找即可
+    struct CachedTable {
+        TableKey key;
+        std::shared_ptr<const ScalerTable> table;
+    };
+
+    std::mutex gTableMutex;
+    std::vector<CachedTable> gTables;
+
+    // ============================================
+    // Quality
+    // ============================================
+
+    // 频率从 0 线性增加到源 Nyquist 的 chirp：位置 x 处的频率为 x / (2 × size) 周期/像素
+    double chirp(double x, uint32_t size) {
+        return 0.5 + 0.5 * std::cos(kPi * x * x / (2.0 * size));
+    }
+
+} // anonymous namespace
+
+bool isValidScalerKernel(int32_t kernel) {
+    return kernel >= static_cast<int32_t>(ScalerKernel::Bilinear) &&
+           kernel <= static_cast<int32_t>(ScalerKernel::Lanczos3);
+}
+
+// ============================================
+// Weight Tables
+// ============================================
+
+std::shared_ptr<ScalerTable> buildScalerTable(ScalerKernel kernel, uint32_t srcSize, uint32_t dstSize,
+                                              float scale, float offset, bool widen) {
+    auto table = std::make_shared<ScalerTable>();
+    if (srcSize == 0 || dstSize == 0) {
+        return table;
+    }
+
+    // 每个输出像素覆盖的源像素数；缩小时核函数按此展宽
+    const double support = kernelSupport(kernel);
+    double factor = widen ? std::max(1.0, std::fabs(static_cast<double>(scale)) * srcSize / dstSize) : 1.0;
+    if (std::ceil(2.0 * support * factor) > kScalerMaxTaps) {
+        factor = kScalerMaxTaps / (2.0 * support);
+    }
+    const double radius = support * factor;
+    const uint32_t taps = static_cast<uint32_t>(std::ceil(2.0 * radius));
+
+    table->taps = taps;
+    table->size = dstSize;
+    table->data.assign(static_cast<size_t>(dstSize) * (taps + 1), 0.0f);
+
+    std::vector<double> weights(taps);
+    for (uint32_t i = 0; i < dstSize; ++i) {
+        float* row = &table->data[static_cast<size_t>(i) * (taps + 1)];
+
+        // 输出像素中心 → 输入 uv；超出 [0, 1] 时整行权重为 0（透明黑色）
+        const double u = scale * (i + 0.5) / dstSize + offset;
+        if (u < 0.0 || u > 1.0) {
+            continue;
+        }
+
+        // 开区间 (x - radius, x + radius) 内的源像素，最多 taps 个
+        const double x = u * srcSize - 0.5;
+        const int64_t first = static_cast<int64_t>(std::floor(x - radius)) + 1;
+        double sum = 0.0;
+        for (uint32_t k = 0; k < taps; ++k) {
+            weights[k] = evaluateKernel(kernel, (first + k - x) / factor);
+            sum += weights[k];
+        }
+
+        row[0] = static_cast<float>(first);
+        if (std::fabs(sum) < 1e-12) {
+            continue;
+        }
+        for (uint32_t k = 0; k < taps; ++k) {
+            row[k + 1] = static_cast<float>(weights[k] / sum);
+        }
+    }
+    return table;
+}
+
+std::shared_ptr<const ScalerTable> getScalerTable(ScalerKernel kernel, uint32_t srcSize, uint32_t dstSize,
+                                                  float scale, float offset) {
+    const TableKey key(static_cast<int32_t>(kernel), srcSize, dstSize, floatBits(scale), floatBits(offset));
+    std::lock_guard<std::mutex> lock(gTableMutex);
+    auto it = std::find_if(gTables.begin(), gTables.end(),
+                           [&key](const CachedTable& cached) { return cached.key == key; });
+    if (it != gTables.end()) {
+        std::rotate(gTables.begin(), it, it + 1);
+        return gTables.front().table;
+    }
+
+    std::shared_ptr<const ScalerTable> table = buildScalerTable(kernel, srcSize, dstSize, scale, offset, true);
+    if (gTables.size() >= kScalerTableCacheSize) {
+        gTables.pop_back();
+    }
+    gTables.insert(gTables.begin(), CachedTable{key, table});
+    return table;
+}
+
+size_t getScalerTableCacheSize() {
+    std::lock_guard<std::mutex> lock(gTableMutex);
+    return gTables.size();
+}
+
+void applyScalerTable(const ScalerTable& table, const float* src, uint32_t srcSize, float* dst) {
+    const int64_t last = static_cast<int64_t>(srcSize) - 1;
+    for (uint32_t i = 0; i < table.size; ++i) {
+        const float* row = &table.data[static_cast<size_t>(i) * (table.taps + 1)];
+        const int64_t first = static_cast<int64_t>(row[0]);
+        float sum = 0.0f;
+        for (uint32_t k = 0; k < table.taps; ++k) {
+            const int64_t index = std::min(std::max(first + static_cast<int64_t>(k), int64_t{0}), last);
+            sum += row[k + 1] * src[index];
+        }
+        dst[i] = sum;
+    }
+}
+
+ScalerQuality measureScalerQuality(ScalerKernel kernel, uint32_t srcSize, uint32_t dstSize, bool hardwareBilinear) {
+    ScalerQuality quality;
+    if (srcSize == 0 || dstSize == 0 || dstSize > srcSize) {
+        return quality;
+    }
+
+    std::vector<float> src(srcSize);
+    for (uint32_t j = 0; j < srcSize; ++j) {
+        src[j] = static_cast<float>(chirp(j + 0.5, srcSize));
+    }
+
+    std::shared_ptr<const ScalerTable> table = hardwareBilinear
+            ? buildScalerTable(ScalerKernel::Bilinear, srcSize, dstSize, 1.0f, 0.0f, false)
+            : getScalerTable(kernel, srcSize, dstSize, 1.0f, 0.0f);
+    std::vector<float> dst(dstSize);
+    applyScalerTable(*table, src.data(), srcSize, dst.data());
+
+    // 输出 Nyquist 对应源位置 x = dstSize；两侧各留 10% 过渡带不计入
+    const double ratio = static_cast<double>(srcSize) / dstSize;
+    double passError = 0.0;
+    double stopError = 0.0;
+    uint32_t passCount = 0;
+    uint32_t stopCount = 0;
+    for (uint32_t i = 0; i < dstSize; ++i) {
+        const double x = (i + 0.5) * ratio;
+        const double value = std::min(std::max(static_cast<double>(dst[i]), 0.0), 1.0);  // rgba8 截断
+        if (x < 0.9 * dstSize) {
+            const double error = value - chirp(x, srcSize);
+            passError += error * error;
+            ++passCount;
+        } else if (x > 1.1 * dstSize) {
+            const double error = value - 0.5;
+            stopError += error * error;
+            ++stopCount;
+        }
+    }
+
+    // psnr 以 1.0 为峰值；aliasing 相对于输入交流分量的 RMS（0.5 / √2）
+    if (passCount > 0) {
+        const double mse = std::max(passError / passCount, 1e-12);
+        quality.psnr = 10.0 * std::log10(1.0 / mse);
+    }
+    if (stopCount > 0) {
+        const double rms = std::max(std::sqrt(stopError / stopCount), 1e-6);
+        quality.aliasing = 20.0 * std::log10(rms / (0.5 / std::sqrt(2.0)));
+    }
+    return quality;
+}
@@ -0,0 +1,69 @@
+//
+// Scaler weight tables: kernels, per-axis tables and the CPU reference used by Vulkanscaler.
+//
+// 权重表：每个输出列/行一项 [第一个 tap 的源索引, w0 .. w(taps-1)]，在 CPU 上按
+// (核函数, 源尺寸, 目标尺寸, 该轴的缩放和平移) 计算一次并归一化。
+// 翻转、裁剪等轴对齐变换直接折算进表中；读取位置超出 [0, 1] 的输出权重全为 0（透明黑色，
+// 与 affine.frag 一致），源索引越界的 tap 按 CLAMP_TO_EDGE 读取边缘像素。
+// 只做纯计算，不依赖 Vulkan / JNI：上传和录制在 Vulkanscaler.h，宿主机测试（bench/）直接链接。
+//
+#ifndef VULKAN_SCALER_TABLE_H
+#define VULKAN_SCALER_TABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// 与 ScalerVulkanFilter.Kernel 的 id 一致
+enum class ScalerKernel : int32_t {
+    Bilinear = 0,   // 三角形核（缩小时展宽，相当于面积加权）
+    Bicubic = 1,    // Catmull-Rom（B = 0, C = 0.5），较锐利
+    Mitchell = 2,   // Mitchell-Netravali（B = C = 1/3），振铃更少
+    Lanczos2 = 3,
+    Lanczos3 = 4,
+};
+
+bool isValidScalerKernel(int32_t kernel);
+
+// 单个方向的权重表
+struct ScalerTable {
+    uint32_t taps = 0;
+    uint32_t size = 0;         // 输出列/行数
+    std::vector<float> data;   // size × (taps + 1)：[first, w0, ..., w(taps-1)]
+};
+
+// 每个输出最多读取的源像素数；缩小比例极大时核函数不再继续展宽（约 10:1 的 Lanczos3）
+constexpr uint32_t kScalerMaxTaps = 64;
+
+// 进程内最多缓存的表数（最近使用的保留）。动画中的变换每帧都是新的 scale / offset，
+// 不限制的话缓存会无限增长；正在使用的表由 Scaler 持有 shared_ptr，淘汰不影响它
+constexpr size_t kScalerTableCacheSize = 8;
+
+// scale / offset：该轴上输出 uv → 输入 uv 的映射 u' = scale × u + offset（翻转时 scale 为负）。
+// widen 为 false 时核函数不随缩小比例展宽（模拟采样器的双线性过滤）。不经过缓存
+std::shared_ptr<ScalerTable> buildScalerTable(ScalerKernel kernel, uint32_t srcSize, uint32_t dstSize,
+                                              float scale, float offset, bool widen = true);
+
+// 同 buildScalerTable（widen 为 true），相同参数返回同一张表（LRU 缓存，可以在任意线程调用）
+std::shared_ptr<const ScalerTable> getScalerTable(ScalerKernel kernel, uint32_t srcSize, uint32_t dstSize,
+                                                  float scale, float offset);
+
+// 当前缓存的表数（测试用）
+size_t getScalerTableCacheSize();
+
+// 与 scale.comp 一致：用 CPU 按表做一维缩放（质量评估和测试用）
+void applyScalerTable(const ScalerTable& table, const float* src, uint32_t srcSize, float* dst);
+
+// 一维 chirp（频率从 0 线性增加到源 Nyquist）缩小后与理想低通结果比较，单位 dB：
+// - psnr：低于输出 Nyquist 的部分（保留细节，越高越好）；
+// - aliasing：高于输出 Nyquist 的部分的残留幅度（应当被滤掉，越低越好）。
+// hardwareBilinear 为 true 时模拟采样器的双线性过滤（核函数不随缩放展宽），作为基准
+struct ScalerQuality {
+    double psnr = 0.0;
+    double aliasing = 0.0;
+};
+ScalerQuality measureScalerQuality(ScalerKernel kernel, uint32_t srcSize, uint32_t dstSize,
+                                   bool hardwareBilinear = false);
+
+#endif // VULKAN_SCALER_TABLE_H
@@ -2,6 +2,8 @@
 // Created by 31483 on 2025/11/29.
 //
 #include "VulkanJNI.h"
+#include "Vulkanpipelineregistry.h"
+#include "Vulkansamplers.h"
 #include <vector>
 #include <cstring>
 
@@ -86,6 +88,7 @@ Java_com_genymobile_scrcpy_vulkan_SimpleVulkanFilter_nativeCreateShaderModule(
     VkResult result = vkCreateShaderModule(device, &createInfo, nullptr, &shaderModule);
 
     if (!validateResult(result, "vkCreateShaderModule")) return 0;
+    registerShaderModule(getDeviceInfo(deviceHandle), shaderModule, alignedCode.data(), codeSize);
 
     LOGI("✓ Shader module created: %p", (void*)shaderModule);
     return toHandle(shaderModule);
@@ -98,8 +101,8 @@ extern "C" JNIEXPORT jlong JNICALL
 Java_com_genymobile_scrcpy_vulkan_SimpleVulkanFilter_nativeCreateSampler(
         JNIEnv* env, jobject /* this */, jlong deviceHandle) {
 
-    VkDevice device = getDevice(deviceHandle);
-    if (!validateHandle(device, "device")) return 0;
+    DeviceInfo* deviceInfo = getDeviceInfo(deviceHandle);
+    if (!validateHandle(deviceInfo, "device")) return 0;
 
     VkSamplerCreateInfo samplerInfo{};
     samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
@@ -116,13 +119,7 @@ Java_com_genymobile_scrcpy_vulkan_SimpleVulkanFilter_nativeCreateSampler(
     samplerInfo.compareOp = VK_COMPARE_OP_ALWAYS;
     samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
 
-    VkSampler sampler;
-    VkResult result = vkCreateSampler(device, &samplerInfo, nullptr, &sampler);
-
-    if (!validateResult(result, "vkCreateSampler")) return 0;
-
-    LOGI("✓ Sampler created: %p", (void*)sampler);
-    return toHandle(sampler);
+    return toHandle(acquireSampler(deviceInfo, samplerInfo));
 }
 
 // ============================================
@@ -136,6 +133,7 @@ Java_com_genymobile_scrcpy_vulkan_SimpleVulkanFilter_nativeDestroyShaderModule(
     VkShaderModule shaderModule = fromHandle<VkShaderModule>(shaderModuleHandle);
 
     if (validateHandle(device, "device") && validateHandle(shaderModule, "shaderModule")) {
+        unregisterShaderModule(getDeviceInfo(deviceHandle), shaderModule);
         vkDestroyShaderModule(device, shaderModule, nullptr);
         LOGD("✓ Shader module destroyed");
     }
@@ -145,11 +143,10 @@ extern "C" JNIEXPORT void JNICALL
 Java_com_genymobile_scrcpy_vulkan_SimpleVulkanFilter_nativeDestroySampler(
         JNIEnv* env, jobject /* this */, jlong deviceHandle, jlong samplerHandle) {
 
-    VkDevice device = getDevice(deviceHandle);
+    DeviceInfo* deviceInfo = getDeviceInfo(deviceHandle);
     VkSampler sampler = fromHandle<VkSampler>(samplerHandle);
 
-    if (validateHandle(device, "device") && validateHandle(sampler, "sampler")) {
-        vkDestroySampler(device, sampler, nullptr);
-        LOGD("✓ Sampler destroyed");
+    if (validateHandle(deviceInfo, "device") && validateHandle(sampler, "sampler")) {
+        releaseSampler(deviceInfo, sampler);
     }
 }
\ No newline at end of file
@@ -0,0 +1,315 @@
+//
+// Shader cost statistics: pipeline statistics queries and pipeline executable statistics.
+//
+#include "Vulkanjni.h"
+#include "Vulkanshaderstats.h"
+#include <algorithm>
+#include <cctype>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace VulkanJNI;
+
+struct ShaderStatistics {
+    bool pipelineStatistics = false;
+    PFN_vkGetPipelineExecutablePropertiesKHR getExecutableProperties = nullptr;
+    PFN_vkGetPipelineExecutableStatisticsKHR getExecutableStatistics = nullptr;
+
+    // 可能在后台编译线程中追加
+    std::mutex mutex;
+    std::vector<PipelineExecutableReport> reports;
+};
+
+namespace {
+
+    // 保留的报告条数上限（pipeline 按变体创建，数量有限；超出后只写日志）
+    constexpr size_t kMaxReports = 512;
+
+    ShaderStatistics* getShaderStatistics(DeviceInfo* deviceInfo) {
+        return deviceInfo ? deviceInfo->shaderStatistics : nullptr;
+    }
+
+    bool hasExtension(VkPhysicalDevice physicalDevice, const char* name) {
+        uint32_t count = 0;
+        vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &count, nullptr);
+        std::vector<VkExtensionProperties> available(count);
+        vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &count, available.data());
+        return std::any_of(available.begin(), available.end(), [name](const VkExtensionProperties& extension) {
+            return strcmp(extension.extensionName, name) == 0;
+        });
+    }
+
+    std::string lower(const char* text) {
+        std::string result(text);
+        std::transform(result.begin(), result.end(), result.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return result;
+    }
+
+    bool statisticValue(const VkPipelineExecutableStatisticKHR& statistic, int64_t* value) {
+        switch (statistic.format) {
+            case VK_PIPELINE_EXECUTABLE_STATISTIC_FORMAT_INT64_KHR:
+                *value = statistic.value.i64;
+                return true;
+            case VK_PIPELINE_EXECUTABLE_STATISTIC_FORMAT_UINT64_KHR:
+                *value = static_cast<int64_t>(statistic.value.u64);
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    void appendStatistic(std::string* details, const VkPipelineExecutableStatisticKHR& statistic) {
+        char value[64];
+        switch (statistic.format) {
+            case VK_PIPELINE_EXECUTABLE_STATISTIC_FORMAT_BOOL32_KHR:
+                snprintf(value, sizeof(value), "%s", statistic.value.b32 ? "true" : "false");
+                break;
+            case VK_PIPELINE_EXECUTABLE_STATISTIC_FORMAT_INT64_KHR:
+                snprintf(value, sizeof(value), "%" PRId64, statistic.value.i64);
+                break;
+            case VK_PIPELINE_EXECUTABLE_STATISTIC_FORMAT_UINT64_KHR:
+                snprintf(value, sizeof(value), "%" PRIu64, statistic.value.u64);
+                break;
+            case VK_PIPELINE_EXECUTABLE_STATISTIC_FORMAT_FLOAT64_KHR:
+                snprintf(value, sizeof(value), "%.3f", statistic.value.f64);
+                break;
+            default:
+                snprintf(value, sizeof(value), "?");
+                break;
+        }
+        if (!details->empty()) details->append(", ");
+        details->append(statistic.name);
+        details->append("=");
+        details->append(value);
+    }
+
+    // 各家驱动的命名不同：AMD "VGPRs"/"SGPRs"/"Spilled VGPRs"，Mesa turnip "Full Registers"，
+    // Mali "Work registers"/"Spilling"，Adreno 专有驱动为 "Register count" 等
+    void summarize(const std::vector<VkPipelineExecutableStatisticKHR>& statistics,
+                   PipelineExecutableReport* report) {
+        int registerPriority = 3;
+        for (const VkPipelineExecutableStatisticKHR& statistic : statistics) {
+            int64_t value;
+            if (!statisticValue(statistic, &value)) continue;
+            const std::string name = lower(statistic.name);
+
+            if (name.find("spill") != std::string::npos) {
+                report->spills = std::max<int64_t>(report->spills, 0) + value;
+                continue;
+            }
+            int priority = 3;
+            if (name.find("vgpr") != std::string::npos) {
+                priority = 0;
+            } else if (name.find("register") != std::string::npos) {
+                priority = 1;
+            } else if (name.find("gpr") != std::string::npos) {
+                priority = 2;
+            }
+            if (priority < registerPriority) {
+                registerPriority = priority;
+                report->registers = value;
+            }
+        }
+    }
+
+} // anonymous namespace
+
+// ============================================
+// Device Setup
+// ============================================
+
+bool queryPipelineStatisticsSupport(VkPhysicalDevice physicalDevice, bool requested,
+                                    VkPhysicalDeviceFeatures* coreFeatures) {
+    if (!requested) return false;
+    VkPhysicalDeviceFeatures supported;
+    vkGetPhysicalDeviceFeatures(physicalDevice, &supported);
+    if (supported.pipelineStatisticsQuery != VK_TRUE) return false;
+    coreFeatures->pipelineStatisticsQuery = VK_TRUE;
+    return true;
+}
+
+bool queryPipelineExecutableInfoSupport(VkPhysicalDevice physicalDevice, bool requested,
+                                        std::vector<const char*>* extensions,
+                                        VkPhysicalDevicePipelineExecutablePropertiesFeaturesKHR* features) {
+    if (!requested) return false;
+    // 与 synchronization2 相同：vkGetPhysicalDeviceFeatures2 需要 Vulkan 1.1
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+    if (properties.apiVersion < VK_API_VERSION_1_1) return false;
+    if (!hasExtension(physicalDevice, VK_KHR_PIPELINE_EXECUTABLE_PROPERTIES_EXTENSION_NAME)) return false;
+
+    VkPhysicalDevicePipelineExecutablePropertiesFeaturesKHR supported{};
+    supported.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PIPELINE_EXECUTABLE_PROPERTIES_FEATURES_KHR;
+
+    VkPhysicalDeviceFeatures2 features2{};
+    features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features2.pNext = &supported;
+    vkGetPhysicalDeviceFeatures2(physicalDevice, &features2);
+    if (supported.pipelineExecutableInfo != VK_TRUE) return false;
+
+    *features = VkPhysicalDevicePipelineExecutablePropertiesFeaturesKHR{};
+    features->sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PIPELINE_EXECUTABLE_PROPERTIES_FEATURES_KHR;
+    features->pipelineExecutableInfo = VK_TRUE;
+
+    extensions->push_back(VK_KHR_PIPELINE_EXECUTABLE_PROPERTIES_EXTENSION_NAME);
+    return true;
+}
+
+void initShaderStatistics(DeviceInfo* deviceInfo, bool pipelineStatistics, bool executableInfo) {
+    deviceInfo->shaderStatistics = nullptr;
+    if (!pipelineStatistics && !executableInfo) return;
+
+    auto* statistics = new ShaderStatistics();
+    statistics->pipelineStatistics = pipelineStatistics;
+    if (executableInfo) {
+        statistics->getExecutableProperties = reinterpret_cast<PFN_vkGetPipelineExecutablePropertiesKHR>(
+                vkGetDeviceProcAddr(deviceInfo->device, "vkGetPipelineExecutablePropertiesKHR"));
+        statistics->getExecutableStatistics = reinterpret_cast<PFN_vkGetPipelineExecutableStatisticsKHR>(
+                vkGetDeviceProcAddr(deviceInfo->device, "vkGetPipelineExecutableStatisticsKHR"));
+        if (!statistics->getExecutableProperties || !statistics->getExecutableStatistics) {
+            statistics->getExecutableProperties = nullptr;
+            statistics->getExecutableStatistics = nullptr;
+        }
+    }
+    deviceInfo->shaderStatistics = statistics;
+}
+
+void destroyShaderStatistics(DeviceInfo* deviceInfo) {
+    delete deviceInfo->shaderStatistics;
+    deviceInfo->shaderStatistics = nullptr;
+}
+
+bool pipelineStatisticsEnabled(DeviceInfo* deviceInfo) {
+    ShaderStatistics* statistics = getShaderStatistics(deviceInfo);
+    return statistics && statistics->pipelineStatistics;
+}
+
+VkPipelineCreateFlags shaderStatisticsCreateFlags(DeviceInfo* deviceInfo) {
+    ShaderStatistics* statistics = getShaderStatistics(deviceInfo);
+    return statistics && statistics->getExecutableStatistics ? VK_PIPELINE_CREATE_CAPTURE_STATISTICS_BIT_KHR : 0;
+}
+
+// ============================================
+// Pipeline Executables
+// ============================================
+
+void capturePipelineExecutableStatistics(DeviceInfo* deviceInfo, VkPipeline pipeline, const char* kind) {
+    ShaderStatistics* statistics = getShaderStatistics(deviceInfo);
+    if (!statistics || !statistics->getExecutableStatistics || pipeline == VK_NULL_HANDLE) return;
+
+    VkPipelineInfoKHR pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_INFO_KHR;
+    pipelineInfo.pipeline = pipeline;
+
+    uint32_t executableCount = 0;
+    if (statistics->getExecutableProperties(deviceInfo->device, &pipelineInfo, &executableCount, nullptr) != VK_SUCCESS) {
+        return;
+    }
+    std::vector<VkPipelineExecutablePropertiesKHR> executables(executableCount);
+    for (VkPipelineExecutablePropertiesKHR& executable : executables) {
+        executable.sType = VK_STRUCTURE_TYPE_PIPELINE_EXECUTABLE_PROPERTIES_KHR;
+    }
+    statistics->getExecutableProperties(deviceInfo->device, &pipelineInfo, &executableCount, executables.data());
+
+    for (uint32_t i = 0; i < executableCount; i++) {
+        VkPipelineExecutableInfoKHR executableInfo{};
+        executableInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_EXECUTABLE_INFO_KHR;
+        executableInfo.pipeline = pipeline;
+        executableInfo.executableIndex = i;
+
+        uint32_t statisticCount = 0;
+        if (statistics->getExecutableStatistics(deviceInfo->device, &executableInfo, &statisticCount, nullptr) != VK_SUCCESS) {
+            continue;
+        }
+        std::vector<VkPipelineExecutableStatisticKHR> values(statisticCount);
+        for (VkPipelineExecutableStatisticKHR& value : values) {
+            value.sType = VK_STRUCTURE_TYPE_PIPELINE_EXECUTABLE_STATISTIC_KHR;
+        }
+        statistics->getExecutableStatistics(deviceInfo->device, &executableInfo, &statisticCount, values.data());
+        values.resize(statisticCount);
+
+        PipelineExecutableReport report;
+        report.pipeline = reinterpret_cast<uint64_t>(pipeline);
+        report.kind = kind;
+        report.executable = executables[i].name;
+        for (const VkPipelineExecutableStatisticKHR& value : values) {
+            appendStatistic(&report.details, value);
+        }
+        summarize(values, &report);
+
+        LOGI("Pipeline %s 0x%" PRIx64 " [%s]: registers %" PRId64 ", spills %" PRId64 " (%s)",
+             kind, report.pipeline, report.executable.c_str(), report.registers, report.spills,
+             report.details.c_str());
+
+        std::lock_guard<std::mutex> lock(statistics->mutex);
+        if (statistics->reports.size() < kMaxReports) {
+            statistics->reports.push_back(std::move(report));
+        }
+    }
+}
+
+bool getPipelineExecutableReports(DeviceInfo* deviceInfo, std::vector<PipelineExecutableReport>* reports) {
+    ShaderStatistics* statistics = getShaderStatistics(deviceInfo);
+    if (!statistics) return false;
+    std::lock_guard<std::mutex> lock(statistics->mutex);
+    *reports = statistics->reports;
+    return true;
+}
+
+// ============================================
+// JNI: VulkanRunner
+// ============================================
+
+// 每个可执行体 3 个字符串：[kind, executable, details, ...]
+extern "C" JNIEXPORT jobjectArray JNICALL
+Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeGetPipelineExecutableStrings(
+        JNIEnv* env, jobject /* this */, jlong deviceHandle) {
+
+    DeviceInfo* deviceInfo = getDeviceInfo(deviceHandle);
+    std::vector<PipelineExecutableReport> reports;
+    if (!deviceInfo || !getPipelineExecutableReports(deviceInfo, &reports)) {
+        return nullptr;
+    }
+
+    jclass stringClass = env->FindClass("java/lang/String");
+    jobjectArray names = env->NewObjectArray(static_cast<jsize>(reports.size() * 3), stringClass, nullptr);
+    for (size_t i = 0; names && i < reports.size(); i++) {
+        const std::string* fields[] = {&reports[i].kind, &reports[i].executable, &reports[i].details};
+        for (size_t j = 0; j < 3; j++) {
+            jstring field = env->NewStringUTF(fields[j]->c_str());
+            env->SetObjectArrayElement(names, static_cast<jsize>(i * 3 + j), field);
+            env->DeleteLocalRef(field);
+        }
+    }
+    return names;
+}
+
+// 每个可执行体 3 个值：[pipeline, registers, spills, ...]，与 nativeGetPipelineExecutableStrings 顺序一致
+extern "C" JNIEXPORT jlongArray JNICALL
+Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeGetPipelineExecutableValues(
+        JNIEnv* env, jobject /* this */, jlong deviceHandle) {
+
+    DeviceInfo* deviceInfo = getDeviceInfo(deviceHandle);
+    std::vector<PipelineExecutableReport> reports;
+    if (!deviceInfo || !getPipelineExecutableReports(deviceInfo, &reports)) {
+        return nullptr;
+    }
+
+    std::vector<jlong> values;
+    values.reserve(reports.size() * 3);
+    for (const PipelineExecutableReport& report : reports) {
+        values.push_back(static_cast<jlong>(report.pipeline));
+        values.push_back(report.registers);
+        values.push_back(report.spills);
+    }
+    jlongArray array = env->NewLongArray(static_cast<jsize>(values.size()));
+    if (array) {
+        env->SetLongArrayRegion(array, 0, static_cast<jsize>(values.size()), values.data());
+    }
+    return array;
+}
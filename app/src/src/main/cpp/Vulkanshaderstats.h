@@ -0,0 +1,70 @@
+//
+// Shader cost statistics: pipeline statistics queries per GPU profiler scope, and per-pipeline
+// register / spill counts from VK_KHR_pipeline_executable_properties.
+//
+// 调 b.frag 和 affine 着色器时只看 GPU 时间不够：时间变长可能是 overdraw（片元调用次数变多），
+// 也可能是寄存器压力导致 spill。runner 以 shaderStatistics 启动时：
+// - 设备支持 pipelineStatisticsQuery 时启用该特性，GPU profiler（Vulkanprofiler.h）给每个叶子 scope
+//   额外包一个 VK_QUERY_TYPE_PIPELINE_STATISTICS 查询，统计裁剪阶段输出的图元数、片元着色器调用次数、
+//   计算着色器调用次数，和 GPU 时间一起按窗口平均后报告；
+//   同类查询不能嵌套，所以外层 scope（"frame"、"prepare"、"render_pass"）不带统计查询，
+//   同一时刻已有统计查询时内层 scope 也不再开始新的查询；
+// - 设备支持 VK_KHR_pipeline_executable_properties 时启用，所有 pipeline 带
+//   VK_PIPELINE_CREATE_CAPTURE_STATISTICS_BIT_KHR 创建，创建后读取每个可执行体（通常每个着色器阶段一个）
+//   的驱动统计，写日志并保存，getPipelineExecutableReports 读取。
+//   统计名称由驱动决定，寄存器数取名称含 "VGPR"/"register"/"GPR" 的项，spill 为名称含 "spill" 的项之和，
+//   驱动没有提供时为 -1；完整的统计列表在 details 中。
+// 不启用时不改变 pipeline 的创建参数（不影响 pipeline 缓存命中）。
+//
+#ifndef VULKAN_SHADER_STATS_H
+#define VULKAN_SHADER_STATS_H
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Vulkantypes.h"
+
+// 统计查询收集的计数器；查询结果按位从低到高排列
+constexpr VkQueryPipelineStatisticFlags kShaderStatisticsFlags =
+        VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT |
+        VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT |
+        VK_QUERY_PIPELINE_STATISTIC_COMPUTE_SHADER_INVOCATIONS_BIT;
+constexpr uint32_t kShaderStatisticsCounters = 3;
+
+struct PipelineExecutableReport {
+    uint64_t pipeline = 0;     // VkPipeline 句柄
+    std::string kind;          // "graphics" / "compute"
+    std::string executable;    // 驱动给出的可执行体名称（例如 "Fragment Shader"）
+    int64_t registers = -1;
+    int64_t spills = -1;
+    std::string details;       // "name=value, ..."
+};
+
+// 创建设备前调用（requested 为 runner 的 shaderStatistics）：
+// 支持时在 coreFeatures 中打开 pipelineStatisticsQuery
+bool queryPipelineStatisticsSupport(VkPhysicalDevice physicalDevice, bool requested,
+                                    VkPhysicalDeviceFeatures* coreFeatures);
+
+// 需要 Vulkan 1.1 和 VK_KHR_pipeline_executable_properties；支持时追加扩展并填好要串进 pNext 的 features
+bool queryPipelineExecutableInfoSupport(VkPhysicalDevice physicalDevice, bool requested,
+                                        std::vector<const char*>* extensions,
+                                        VkPhysicalDevicePipelineExecutablePropertiesFeaturesKHR* features);
+
+// 创建设备后调用；两者都为 false 时 deviceInfo->shaderStatistics 保持为空
+void initShaderStatistics(DeviceInfo* deviceInfo, bool pipelineStatistics, bool executableInfo);
+void destroyShaderStatistics(DeviceInfo* deviceInfo);
+
+// GPU profiler 是否为 scope 创建统计查询池
+bool pipelineStatisticsEnabled(DeviceInfo* deviceInfo);
+
+// pipeline 创建时追加的 flags（未启用时为 0）
+VkPipelineCreateFlags shaderStatisticsCreateFlags(DeviceInfo* deviceInfo);
+
+// pipeline 创建成功后调用：读取各可执行体的统计，写日志并保存
+void capturePipelineExecutableStatistics(DeviceInfo* deviceInfo, VkPipeline pipeline, const char* kind);
+
+// 按创建顺序；未启用时返回 false
+bool getPipelineExecutableReports(DeviceInfo* deviceInfo, std::vector<PipelineExecutableReport>* reports);
+
+#endif // VULKAN_SHADER_STATS_H
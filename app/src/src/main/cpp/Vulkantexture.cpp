@@ -1,11 +1,11 @@
 #include <jni.h>
-#include <android/log.h>
+#include "Vulkanlog.h"
 #include <vulkan/vulkan.h>
 #include "VulkanTypes.h"
 
 #define LOG_TAG "VulkanTexture"
-#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
-#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+#define LOGI(...) VLOGI(LOG_TAG, __VA_ARGS__)
+#define LOGE(...) VLOGE(LOG_TAG, __VA_ARGS__)
 
 // 外部函数声明
 extern uint32_t findMemoryType(VkPhysicalDevice, uint32_t, VkMemoryPropertyFlags);
@@ -0,0 +1,213 @@
+//
+// CPU + GPU timeline recorder, exported as Chrome trace JSON.
+//
+#include "Vulkantrace.h"
+#include "Vulkanlog.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include <sys/prctl.h>
+#include <unistd.h>
+
+std::atomic<bool> traceActive{false};
+
+namespace {
+
+    constexpr const char* kLogTag = "VulkanRenderer";
+
+    struct TraceEvent {
+        const char* name = nullptr;
+        uint64_t beginNs = 0;
+        uint64_t endNs = 0;
+    };
+
+    // 缓冲中的一个事件：dumpTrace 复制时写入线程可能正在覆盖它，字段用 relaxed 原子读写
+    // （ARM64/x86 上与普通读写相同），是否被覆盖由 snapshot 复制后重新检查 head 判断
+    struct TraceSlot {
+        std::atomic<const char*> name{nullptr};
+        std::atomic<uint64_t> beginNs{0};
+        std::atomic<uint64_t> endNs{0};
+    };
+
+    // 单个线程的一条轨道：只有所属线程写入，dumpTrace 读取
+    struct TraceBuffer {
+        int32_t tid = 0;
+        bool gpu = false;
+        char threadName[17] = {};
+        std::atomic<uint64_t> head{0};  // 累计写入的事件数
+        TraceSlot events[kTraceEventsPerThread];
+    };
+
+    // 缓冲一直保留到进程退出：线程结束后事件仍然可以导出，dumpTrace 也不会读到已释放的内存
+    std::mutex registryMutex;
+    std::vector<std::unique_ptr<TraceBuffer>> buffers;
+    std::atomic<uint64_t> traceStartNs{0};
+
+    thread_local TraceBuffer* threadCpuBuffer = nullptr;
+    thread_local TraceBuffer* threadGpuBuffer = nullptr;
+
+    std::mutex namesMutex;
+    std::unordered_set<std::string> names;
+
+    TraceBuffer* createBuffer(bool gpu) {
+        auto buffer = std::make_unique<TraceBuffer>();
+        buffer->tid = static_cast<int32_t>(gettid());
+        buffer->gpu = gpu;
+        prctl(PR_GET_NAME, buffer->threadName, 0, 0, 0);
+
+        std::lock_guard<std::mutex> lock(registryMutex);
+        buffers.push_back(std::move(buffer));
+        return buffers.back().get();
+    }
+
+    // 与 seqlock 相同的顺序：release fence 在改写槽位之前，head 的 release 写在之后。
+    // snapshot 只要读到了这次改写的任何一个字段，之后（acquire fence 之后）读到的 head 至少是 head，
+    // 能判断出这个槽位正在被覆盖
+    void append(TraceBuffer* buffer, const char* name, uint64_t beginNs, uint64_t endNs) {
+        const uint64_t head = buffer->head.load(std::memory_order_relaxed);
+        TraceSlot& slot = buffer->events[head % kTraceEventsPerThread];
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.name.store(name, std::memory_order_relaxed);
+        slot.beginNs.store(beginNs, std::memory_order_relaxed);
+        slot.endNs.store(endNs, std::memory_order_relaxed);
+        buffer->head.store(head + 1, std::memory_order_release);
+    }
+
+    // 复制缓冲中仍然有效的事件；复制期间被写入线程覆盖（或正在覆盖）的部分丢弃
+    std::vector<TraceEvent> snapshot(const TraceBuffer* buffer) {
+        const uint64_t end = buffer->head.load(std::memory_order_acquire);
+        const uint64_t begin = end > kTraceEventsPerThread ? end - kTraceEventsPerThread : 0;
+        std::vector<TraceEvent> events;
+        events.reserve(end - begin);
+        for (uint64_t i = begin; i < end; i++) {
+            const TraceSlot& slot = buffer->events[i % kTraceEventsPerThread];
+            TraceEvent event;
+            event.name = slot.name.load(std::memory_order_relaxed);
+            event.beginNs = slot.beginNs.load(std::memory_order_relaxed);
+            event.endNs = slot.endNs.load(std::memory_order_relaxed);
+            events.push_back(event);
+        }
+
+        // head 为 after 时，事件 after - kTraceEventsPerThread 所在的槽位是下一个要写的，也不可信
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const uint64_t after = buffer->head.load(std::memory_order_relaxed);
+        const uint64_t valid = after >= kTraceEventsPerThread ? after - kTraceEventsPerThread + 1 : 0;
+        if (valid > begin) {
+            events.erase(events.begin(), events.begin() + std::min<uint64_t>(valid - begin, events.size()));
+        }
+        return events;
+    }
+
+    void writeJsonString(FILE* file, const char* text) {
+        fputc('"', file);
+        for (const char* c = text; *c; c++) {
+            if (*c == '"' || *c == '\\') {
+                fputc('\\', file);
+                fputc(*c, file);
+            } else if (static_cast<unsigned char>(*c) < 0x20) {
+                fprintf(file, "\\u%04x", *c);
+            } else {
+                fputc(*c, file);
+            }
+        }
+        fputc('"', file);
+    }
+
+    // GPU 轨道的 tid：与 CPU 线程区分开
+    int32_t trackId(const TraceBuffer* buffer) {
+        return buffer->gpu ? 1000000 + buffer->tid : buffer->tid;
+    }
+
+} // anonymous namespace
+
+// ============================================
+// Recording
+// ============================================
+uint64_t traceNowNs() {
+    timespec now{};
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<uint64_t>(now.tv_sec) * 1000000000ull + static_cast<uint64_t>(now.tv_nsec);
+}
+
+void startTrace() {
+    traceStartNs.store(traceNowNs(), std::memory_order_relaxed);
+    traceActive.store(true, std::memory_order_release);
+    VLOGI(kLogTag, "Trace started");
+}
+
+void stopTrace() {
+    traceActive.store(false, std::memory_order_release);
+    VLOGI(kLogTag, "Trace stopped");
+}
+
+void traceCpuEvent(const char* name, uint64_t beginNs, uint64_t endNs) {
+    if (!threadCpuBuffer) threadCpuBuffer = createBuffer(false);
+    append(threadCpuBuffer, name, beginNs, endNs);
+}
+
+void traceGpuEvent(const char* name, uint64_t beginNs, uint64_t endNs) {
+    if (!threadGpuBuffer) threadGpuBuffer = createBuffer(true);
+    append(threadGpuBuffer, name, beginNs, endNs);
+}
+
+const char* traceInternName(const char* name) {
+    std::lock_guard<std::mutex> lock(namesMutex);
+    return names.emplace(name).first->c_str();
+}
+
+// ============================================
+// Export
+// ============================================
+bool dumpTrace(const char* path) {
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        VLOGE(kLogTag, "Failed to open trace file: %s", path);
+        return false;
+    }
+
+    std::vector<TraceBuffer*> snapshotBuffers;
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        for (const auto& buffer : buffers) snapshotBuffers.push_back(buffer.get());
+    }
+
+    const int pid = getpid();
+    const uint64_t startNs = traceStartNs.load(std::memory_order_relaxed);
+    size_t written = 0;
+    bool first = true;
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+
+    for (const TraceBuffer* buffer : snapshotBuffers) {
+        const std::vector<TraceEvent> events = snapshot(buffer);
+
+        // 轨道名：线程名，GPU 轨道标明来源线程
+        std::string trackName = buffer->gpu ? std::string("GPU (") + buffer->threadName + ")" : buffer->threadName;
+        fprintf(file, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":",
+                first ? "" : ",", pid, trackId(buffer));
+        writeJsonString(file, trackName.c_str());
+        fprintf(file, "}}");
+        first = false;
+
+        for (const TraceEvent& event : events) {
+            if (event.beginNs < startNs || event.endNs < event.beginNs || !event.name) continue;
+            fprintf(file, ",\n{\"name\":");
+            writeJsonString(file, event.name);
+            // ts/dur 单位为微秒
+            fprintf(file, ",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":%d,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                    buffer->gpu ? "gpu" : "cpu", pid, trackId(buffer),
+                    event.beginNs / 1000.0, (event.endNs - event.beginNs) / 1000.0);
+            written++;
+        }
+    }
+
+    fprintf(file, "\n]}\n");
+    const bool ok = fclose(file) == 0;
+    VLOGI(kLogTag, "Trace dumped: %zu events on %zu tracks to %s", written, snapshotBuffers.size(), path);
+    return ok;
+}
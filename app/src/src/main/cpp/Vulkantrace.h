@@ -0,0 +1,73 @@
+//
+// CPU + GPU timeline recorder, exported as Chrome trace JSON (chrome://tracing, ui.perfetto.dev).
+//
+// 帧节奏问题（acquire 阻塞、提交晚了、上传占住渲染线程）从日志里看不出来，需要按时间线看每个线程和 GPU
+// 在做什么。记录器一直编译在内，默认关闭：
+// - CPU scope 用 TraceScope（RAII）或 traceCpuEvent 记录，写入调用线程自己的环形缓冲：单生产者，
+//   写入只有一次 relaxed 读、一个 release fence 和一次 release 写，不加锁；缓冲满了覆盖最旧的事件。
+//   关闭时 TraceScope 只读一次 relaxed 原子标志，不读时钟；
+// - GPU scope 来自 Vulkanprofiler.h 的 timestamp 查询，profiler 读取结果时换算到 CPU 时钟后写入
+//   调用线程的 GPU 缓冲（单独一条 "GPU" 轨道）。换算用 VK_EXT_calibrated_timestamps 同时采样的
+//   设备时钟和 CLOCK_MONOTONIC，记录期间每秒重新校准一次；设备不支持时只有 CPU 轨道；
+// - CPU 时钟为 CLOCK_MONOTONIC，与 Kotlin 的 System.nanoTime() 相同，Kotlin 侧的 scope（VulkanTrace）
+//   直接传入 nanoTime；
+// - dumpTrace 可以在任意线程、记录进行中调用：按 seqlock 的方式复制各缓冲（事件字段为 relaxed 原子，
+//   复制后 acquire fence 再读 head），丢弃复制期间被覆盖或正在覆盖的事件。
+//
+// 事件名必须在整个进程生命周期内有效（字符串字面量或 traceInternName 的返回值）。
+// 记录器本身不依赖 Vulkan 和 JNI（宿主机上的 vkfilter_microbench 直接链接）；GPU 时钟校准和
+// VulkanTrace 的 JNI 在 Vulkantracegpu.h / Vulkantracegpu.cpp。
+//
+#ifndef VULKAN_TRACE_H
+#define VULKAN_TRACE_H
+
+#include <atomic>
+#include <cstdint>
+
+constexpr uint32_t kTraceEventsPerThread = 16384;  // 每个线程每条轨道的环形缓冲容量
+
+// 由 startTrace/stopTrace 设置，读取用 traceEnabled()
+extern std::atomic<bool> traceActive;
+
+inline bool traceEnabled() {
+    return traceActive.load(std::memory_order_relaxed);
+}
+
+// CLOCK_MONOTONIC 纳秒
+uint64_t traceNowNs();
+
+// 开始/停止记录；开始之前的旧事件不再导出
+void startTrace();
+void stopTrace();
+
+// 记录一个完整的事件（调用方负责检查 traceEnabled()）
+void traceCpuEvent(const char* name, uint64_t beginNs, uint64_t endNs);
+void traceGpuEvent(const char* name, uint64_t beginNs, uint64_t endNs);
+
+// 返回与 name 内容相同、进程内一直有效的字符串（相同内容返回同一指针）
+const char* traceInternName(const char* name);
+
+// 写出 Chrome trace JSON（{"traceEvents": [...]}）；打开文件失败时返回 false
+bool dumpTrace(const char* path);
+
+// 作用域计时：构造时记录开始时间，析构时写入事件
+class TraceScope {
+public:
+    explicit TraceScope(const char* name)
+            : name_(name), beginNs_(traceEnabled() ? traceNowNs() : 0) {}
+
+    ~TraceScope() {
+        if (beginNs_ != 0) {
+            traceCpuEvent(name_, beginNs_, traceNowNs());
+        }
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* name_;
+    uint64_t beginNs_;
+};
+
+#endif // VULKAN_TRACE_H
@@ -0,0 +1,136 @@
+//
+// GPU track support for the trace recorder, and the VulkanTrace JNI.
+//
+#include "Vulkanjni.h"
+#include "Vulkantracegpu.h"
+#include <cstring>
+
+using namespace VulkanJNI;
+
+namespace {
+
+    bool hasExtension(VkPhysicalDevice physicalDevice, const char* name) {
+        uint32_t count = 0;
+        vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &count, nullptr);
+        std::vector<VkExtensionProperties> available(count);
+        vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &count, available.data());
+        for (const VkExtensionProperties& extension : available) {
+            if (strcmp(extension.extensionName, name) == 0) return true;
+        }
+        return false;
+    }
+
+} // anonymous namespace
+
+// ============================================
+// GPU Clock Calibration
+// ============================================
+bool queryCalibratedTimestampSupport(VkInstance instance, VkPhysicalDevice physicalDevice,
+                                     std::vector<const char*>* extensions) {
+    if (!hasExtension(physicalDevice, VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME)) return false;
+
+    auto getTimeDomains = reinterpret_cast<PFN_vkGetPhysicalDeviceCalibrateableTimeDomainsEXT>(
+            vkGetInstanceProcAddr(instance, "vkGetPhysicalDeviceCalibrateableTimeDomainsEXT"));
+    if (!getTimeDomains) return false;
+
+    uint32_t count = 0;
+    getTimeDomains(physicalDevice, &count, nullptr);
+    std::vector<VkTimeDomainEXT> domains(count);
+    getTimeDomains(physicalDevice, &count, domains.data());
+
+    bool device = false;
+    bool monotonic = false;
+    for (VkTimeDomainEXT domain : domains) {
+        device = device || domain == VK_TIME_DOMAIN_DEVICE_EXT;
+        monotonic = monotonic || domain == VK_TIME_DOMAIN_CLOCK_MONOTONIC_EXT;
+    }
+    if (!device || !monotonic) return false;
+
+    extensions->push_back(VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME);
+    return true;
+}
+
+void initCalibratedTimestamps(DeviceInfo* deviceInfo, bool enabled) {
+    deviceInfo->getCalibratedTimestamps = nullptr;
+    if (!enabled) return;
+
+    deviceInfo->getCalibratedTimestamps = reinterpret_cast<PFN_vkGetCalibratedTimestampsEXT>(
+            vkGetDeviceProcAddr(deviceInfo->device, "vkGetCalibratedTimestampsEXT"));
+    if (!deviceInfo->getCalibratedTimestamps) {
+        LOGE("vkGetCalibratedTimestampsEXT not found, GPU events will not be traced");
+    }
+}
+
+bool calibrateGpuClock(DeviceInfo* deviceInfo, uint64_t* deviceTicks, uint64_t* cpuNs) {
+    if (!deviceInfo->getCalibratedTimestamps) return false;
+
+    VkCalibratedTimestampInfoEXT infos[2]{};
+    infos[0].sType = VK_STRUCTURE_TYPE_CALIBRATED_TIMESTAMP_INFO_EXT;
+    infos[0].timeDomain = VK_TIME_DOMAIN_DEVICE_EXT;
+    infos[1].sType = VK_STRUCTURE_TYPE_CALIBRATED_TIMESTAMP_INFO_EXT;
+    infos[1].timeDomain = VK_TIME_DOMAIN_CLOCK_MONOTONIC_EXT;
+
+    uint64_t timestamps[2] = {};
+    uint64_t maxDeviation = 0;
+    VkResult result = deviceInfo->getCalibratedTimestamps(deviceInfo->device, 2, infos, timestamps, &maxDeviation);
+    if (result != VK_SUCCESS) {
+        LOGE("vkGetCalibratedTimestampsEXT failed: %d", result);
+        return false;
+    }
+    *deviceTicks = timestamps[0];
+    *cpuNs = timestamps[1];
+    return true;
+}
+
+// ============================================
+// JNI: VulkanTrace
+// ============================================
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_genymobile_scrcpy_vulkan_VulkanTrace_nativeStart(
+        JNIEnv* env, jobject /* this */) {
+    startTrace();
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_genymobile_scrcpy_vulkan_VulkanTrace_nativeStop(
+        JNIEnv* env, jobject /* this */) {
+    stopTrace();
+}
+
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_genymobile_scrcpy_vulkan_VulkanTrace_nativeDump(
+        JNIEnv* env, jobject /* this */, jstring path) {
+
+    if (!path) {
+        return JNI_FALSE;
+    }
+    const char* chars = env->GetStringUTFChars(path, nullptr);
+    const bool ok = dumpTrace(chars);
+    env->ReleaseStringUTFChars(path, chars);
+    return ok ? JNI_TRUE : JNI_FALSE;
+}
+
+// Kotlin 侧的事件名在登记时转换一次，之后按句柄传递
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_genymobile_scrcpy_vulkan_VulkanTrace_nativeName(
+        JNIEnv* env, jobject /* this */, jstring name) {
+
+    if (!name) {
+        return 0;
+    }
+    const char* chars = env->GetStringUTFChars(name, nullptr);
+    const char* interned = traceInternName(chars);
+    env->ReleaseStringUTFChars(name, chars);
+    return toHandle(interned);
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_genymobile_scrcpy_vulkan_VulkanTrace_nativeEvent(
+        JNIEnv* env, jobject /* this */, jlong nameHandle, jlong beginNs, jlong endNs) {
+
+    const char* name = fromHandle<const char*>(nameHandle);
+    if (name && traceEnabled()) {
+        traceCpuEvent(name, static_cast<uint64_t>(beginNs), static_cast<uint64_t>(endNs));
+    }
+}
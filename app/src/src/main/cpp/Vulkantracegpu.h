@@ -0,0 +1,29 @@
+//
+// GPU track support for the trace recorder: VK_EXT_calibrated_timestamps clock calibration.
+//
+// Vulkanprofiler 读取 timestamp 时用这里的对应点把设备时钟换算到 CLOCK_MONOTONIC，写入 Vulkantrace.h 的 GPU 轨道。
+// VulkanTrace（Kotlin）的 JNI 也在 Vulkantracegpu.cpp：记录器本身不依赖 Vulkan 和 JNI。
+//
+#ifndef VULKAN_TRACE_GPU_H
+#define VULKAN_TRACE_GPU_H
+
+#include <vulkan/vulkan.h>
+#include <vector>
+#include "Vulkantypes.h"
+#include "Vulkantrace.h"
+
+// ============================================
+// GPU 时钟校准（VK_EXT_calibrated_timestamps）
+// ============================================
+
+// 创建设备前调用：扩展可用且同时支持 DEVICE 和 CLOCK_MONOTONIC 时间域时追加扩展并返回 true
+bool queryCalibratedTimestampSupport(VkInstance instance, VkPhysicalDevice physicalDevice,
+                                     std::vector<const char*>* extensions);
+
+// 创建设备后调用；enabled 为 false 或函数取不到时 getCalibratedTimestamps 保持为空
+void initCalibratedTimestamps(DeviceInfo* deviceInfo, bool enabled);
+
+// 同时采样设备 timestamp（与 vkCmdWriteTimestamp 同单位）和 CLOCK_MONOTONIC；不支持时返回 false
+bool calibrateGpuClock(DeviceInfo* deviceInfo, uint64_t* deviceTicks, uint64_t* cpuNs);
+
+#endif // VULKAN_TRACE_GPU_H
@@ -0,0 +1,219 @@
+//
+// Transfer fast path: axis-aligned transforms copied or blitted straight into the swapchain image.
+//
+#include "Vulkanjni.h"
+#include "Vulkantransfer.h"
+#include "Vulkanbarriers.h"
+#include <algorithm>
+
+using namespace VulkanJNI;
+
+namespace {
+
+    // 输入纹理的格式（nativeCreateInputTexture）
+    constexpr VkFormat kInputFormat = VK_FORMAT_R8G8B8A8_UNORM;
+
+    bool hasFormatFeatures(DeviceInfo* deviceInfo, VkFormat format, VkFormatFeatureFlags features) {
+        VkFormatProperties properties;
+        vkGetPhysicalDeviceFormatProperties(deviceInfo->physicalDevice, format, &properties);
+        return (properties.optimalTilingFeatures & features) == features;
+    }
+
+} // anonymous namespace
+
+// ============================================
+// Device support
+// ============================================
+bool isTransferSupported(DeviceInfo* deviceInfo, const TransferPlan& plan,
+                         VkFormat srcFormat, VkFormat dstFormat, VkImageUsageFlags dstUsage) {
+    if (plan.path == TransferPath::Shader) return false;
+    if ((dstUsage & VK_IMAGE_USAGE_TRANSFER_DST_BIT) == 0) return false;
+    if (plan.path == TransferPath::Copy) return true;
+
+    VkFormatFeatureFlags srcFeatures = VK_FORMAT_FEATURE_BLIT_SRC_BIT;
+    if (plan.linear) {
+        srcFeatures |= VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+    }
+    return hasFormatFeatures(deviceInfo, srcFormat, srcFeatures) &&
+           hasFormatFeatures(deviceInfo, dstFormat, VK_FORMAT_FEATURE_BLIT_DST_BIT);
+}
+
+// ============================================
+// Recording
+// ============================================
+void recordTransfer(DeviceInfo* deviceInfo, VkCommandBuffer commandBuffer,
+                    VkImage srcImage, SwapchainInfo* swapchainInfo, uint32_t imageIndex,
+                    const TransferPlan& plan, bool load, const std::vector<VkRect2D>& rects) {
+    VkImage swapchainImage = swapchainInfo->images[imageIndex];
+    const bool blit = plan.path == TransferPath::Blit;
+    const bool clear = !load && !plan.covers;
+
+    const VkPipelineStageFlags2KHR transferStage =
+            blit ? VK_PIPELINE_STAGE_2_BLIT_BIT_KHR : VK_PIPELINE_STAGE_2_COPY_BIT_KHR;
+    const ImageUse& sourceUse = blit ? ImageUses::kBlitSrc : ImageUses::kCopySrc;
+    const ImageUse targetUse = {VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, transferStage,
+                                VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR};
+
+    // 输入纹理（上传后处于采样布局）和交换链图像的转换一次提交；
+    // 与 endComputeOutput 相同，以 acquire 信号量的等待阶段为源
+    ImageBarrierBatch barriers;
+    requireImageUse(deviceInfo, &barriers, srcImage, sourceUse);
+    if (clear) {
+        const ImageUse clearUse = {VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_PIPELINE_STAGE_2_CLEAR_BIT_KHR,
+                                   VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR};
+        addImageTransition(&barriers, swapchainImage, VK_IMAGE_LAYOUT_UNDEFINED,
+                           VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR, VK_ACCESS_2_NONE_KHR,
+                           clearUse);
+        flushImageBarriers(deviceInfo, &barriers, commandBuffer);
+
+        // 覆盖区域之外与 affine.frag 的越界像素一致：透明黑色
+        VkClearColorValue transparent{};
+        VkImageSubresourceRange range{};
+        range.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        range.levelCount = 1;
+        range.layerCount = 1;
+        vkCmdClearColorImage(commandBuffer, swapchainImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                             &transparent, 1, &range);
+
+        // 清空和之后的写入区域重叠（WAW），布局不变
+        addImageTransition(&barriers, swapchainImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                           VK_PIPELINE_STAGE_2_CLEAR_BIT_KHR, VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR,
+                           targetUse);
+    } else {
+        addImageTransition(&barriers, swapchainImage,
+                           load ? VK_IMAGE_LAYOUT_PRESENT_SRC_KHR : VK_IMAGE_LAYOUT_UNDEFINED,
+                           VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR, VK_ACCESS_2_NONE_KHR,
+                           targetUse);
+    }
+    flushImageBarriers(deviceInfo, &barriers, commandBuffer);
+
+    VkImageSubresourceLayers subresource{};
+    subresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    subresource.mipLevel = 0;
+    subresource.baseArrayLayer = 0;
+    subresource.layerCount = 1;
+
+    checkImageCommand(deviceInfo, srcImage, sourceUse, blit ? "vkCmdBlitImage" : "vkCmdCopyImage");
+    if (blit) {
+        VkImageBlit region{};
+        region.srcSubresource = subresource;
+        region.srcOffsets[0] = {plan.srcStart.x, plan.srcStart.y, 0};
+        region.srcOffsets[1] = {plan.srcEnd.x, plan.srcEnd.y, 1};
+        region.dstSubresource = subresource;
+        region.dstOffsets[0] = {plan.dstStart.x, plan.dstStart.y, 0};
+        region.dstOffsets[1] = {plan.dstEnd.x, plan.dstEnd.y, 1};
+        vkCmdBlitImage(commandBuffer, srcImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                       swapchainImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                       1, &region, plan.linear ? VK_FILTER_LINEAR : VK_FILTER_NEAREST);
+    } else {
+        // 1:1 映射：脏矩形与覆盖区域求交后按整数偏移对应到源
+        const int32_t dx = plan.srcStart.x - plan.dstStart.x;
+        const int32_t dy = plan.srcStart.y - plan.dstStart.y;
+        std::vector<VkImageCopy> regions;
+        auto addRegion = [&](int32_t x0, int32_t y0, int32_t x1, int32_t y1) {
+            x0 = std::max(x0, plan.dstStart.x);
+            y0 = std::max(y0, plan.dstStart.y);
+            x1 = std::min(x1, plan.dstEnd.x);
+            y1 = std::min(y1, plan.dstEnd.y);
+            if (x1 <= x0 || y1 <= y0) return;
+
+            VkImageCopy region{};
+            region.srcSubresource = subresource;
+            region.srcOffset = {x0 + dx, y0 + dy, 0};
+            region.dstSubresource = subresource;
+            region.dstOffset = {x0, y0, 0};
+            region.extent = {static_cast<uint32_t>(x1 - x0), static_cast<uint32_t>(y1 - y0), 1};
+            regions.push_back(region);
+        };
+        if (load) {
+            regions.reserve(rects.size());
+            for (const VkRect2D& rect : rects) {
+                addRegion(rect.offset.x, rect.offset.y,
+                          rect.offset.x + static_cast<int32_t>(rect.extent.width),
+                          rect.offset.y + static_cast<int32_t>(rect.extent.height));
+            }
+        } else {
+            addRegion(plan.dstStart.x, plan.dstStart.y, plan.dstEnd.x, plan.dstEnd.y);
+        }
+        if (!regions.empty()) {
+            vkCmdCopyImage(commandBuffer, srcImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                           swapchainImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                           static_cast<uint32_t>(regions.size()), regions.data());
+        }
+    }
+
+    // 输入纹理回到采样布局：之后不经过上传的重绘（例如变换改变）可能走 pipeline
+    requireImageUse(deviceInfo, &barriers, srcImage, ImageUses::kSampled);
+    addImageTransition(&barriers, swapchainImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                       transferStage, VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR, ImageUses::kPresent);
+    flushImageBarriers(deviceInfo, &barriers, commandBuffer);
+}
+
+// ============================================
+// JNI: VulkanRunner (transfer fast path)
+// ============================================
+
+// matrix：输出 uv → 输入 uv（VulkanFilter.transferTransform）；rects: [x0, y0, w0, h0, ...]，为 null 表示整张图像。
+// 返回录制的路径（TransferPath），0 表示什么都没有录制，调用方照常走 pipeline
+extern "C" JNIEXPORT jint JNICALL
+Java_com_genymobile_scrcpy_vulkan_VulkanRunner_nativeRecordTransfer(
+        JNIEnv* env, jobject /* this */,
+        jlong deviceHandle,
+        jlong commandBufferHandle,
+        jlong swapchainHandle,
+        jint imageIndex,
+        jlong textureImageHandle,
+        jint textureWidth,
+        jint textureHeight,
+        jfloatArray matrixArray,
+        jboolean load,
+        jintArray rectArray) {
+
+    DeviceInfo* deviceInfo = getDeviceInfo(deviceHandle);
+    VkCommandBuffer commandBuffer = fromHandle<VkCommandBuffer>(commandBufferHandle);
+    SwapchainInfo* swapchainInfo = fromHandle<SwapchainInfo*>(swapchainHandle);
+    VkImage textureImage = fromHandle<VkImage>(textureImageHandle);
+    if (!validateHandle(deviceInfo, "device") || !validateHandle(commandBuffer, "commandBuffer") ||
+        !validateHandle(swapchainInfo, "swapchain") || !validateHandle(textureImage, "textureImage")) {
+        return static_cast<jint>(TransferPath::Shader);
+    }
+    if (imageIndex < 0 || static_cast<size_t>(imageIndex) >= swapchainInfo->images.size()) {
+        LOGE("Invalid image index: %d", imageIndex);
+        return static_cast<jint>(TransferPath::Shader);
+    }
+    if (matrixArray == nullptr || env->GetArrayLength(matrixArray) < 16 || textureWidth <= 0 || textureHeight <= 0) {
+        return static_cast<jint>(TransferPath::Shader);
+    }
+
+    float matrix[16];
+    env->GetFloatArrayRegion(matrixArray, 0, 16, matrix);
+
+    const VkFormat dstFormat = swapchainInfo->format.format;
+    const TransferPlan plan = classifyTransfer(matrix,
+                                               static_cast<uint32_t>(textureWidth), static_cast<uint32_t>(textureHeight),
+                                               swapchainInfo->extent.width, swapchainInfo->extent.height,
+                                               kInputFormat == dstFormat);
+    if (!isTransferSupported(deviceInfo, plan, kInputFormat, dstFormat, swapchainInfo->usage)) {
+        return static_cast<jint>(TransferPath::Shader);
+    }
+
+    std::vector<VkRect2D> rects;
+    if (rectArray != nullptr) {
+        jsize count = env->GetArrayLength(rectArray);
+        std::vector<jint> values(count);
+        env->GetIntArrayRegion(rectArray, 0, count, values.data());
+        for (jsize i = 0; i + 3 < count; i += 4) {
+            if (values[i + 2] <= 0 || values[i + 3] <= 0) continue;
+            VkRect2D rect{};
+            rect.offset = {values[i], values[i + 1]};
+            rect.extent = {static_cast<uint32_t>(values[i + 2]), static_cast<uint32_t>(values[i + 3])};
+            rects.push_back(rect);
+        }
+    }
+
+    // 没有脏矩形就只能整帧写入
+    const bool partial = load == JNI_TRUE && rectArray != nullptr;
+    recordTransfer(deviceInfo, commandBuffer, textureImage, swapchainInfo, static_cast<uint32_t>(imageIndex),
+                   plan, partial, rects);
+    return static_cast<jint>(plan.path);
+}
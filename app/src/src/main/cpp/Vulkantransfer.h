@@ -0,0 +1,34 @@
+//
+// Transfer fast path: axis-aligned transforms copied or blitted straight into the swapchain image.
+//
+// MainActivity 里的 AffineMatrix 多数只是缩放、翻转或整数裁剪（scale / hflip / vflip / reframe），
+// 为此跑一遍完整的 pipeline（全屏三角形 + 采样 + 逐片段边界检查）并不划算。
+// 变换先由 classifyTransfer（Vulkantransferplan.h）分成 Copy / Blit / Shader，这里检查设备支持并录制。
+//
+// 输入坐标超出 [0, 1] 的部分与 affine.frag 一样输出透明黑色：整帧重绘时先清空交换链图像再写入
+// 覆盖区域；局部重绘（load）时覆盖区域之外的内容来自上一帧，变换不变时本来就是透明黑色。
+// Copy 只复制脏矩形；Blit 的脏矩形一般映射不到整数源坐标，整块覆盖区域都重新 blit。
+//
+// 交换链图像需要 TRANSFER_DST 用途（创建交换链时 surface 支持就添加），
+// 输入纹理需要 TRANSFER_SRC 用途；不满足或格式不支持 blit 时一律回到 Shader。
+//
+#ifndef VULKAN_TRANSFER_H
+#define VULKAN_TRANSFER_H
+
+#include <vulkan/vulkan.h>
+#include <vector>
+#include "Vulkantypes.h"
+#include "Vulkantransferplan.h"
+
+// 设备是否能按 plan 执行（格式的 blit / 线性过滤支持、图像用途），不能时调用方回到 Shader。
+// 输入纹理由 nativeCreateInputTexture 创建，总是带 TRANSFER_SRC 用途，这里只检查交换链一侧
+bool isTransferSupported(DeviceInfo* deviceInfo, const TransferPlan& plan,
+                         VkFormat srcFormat, VkFormat dstFormat, VkImageUsageFlags dstUsage);
+
+// 录制复制到交换链图像并转换到 PRESENT_SRC；输入纹理之后回到采样布局（SHADER_READ_ONLY），
+// 光栅化/计算路径照常使用。rects（x, y, w, h）只在 Copy 且 load 时使用
+void recordTransfer(DeviceInfo* deviceInfo, VkCommandBuffer commandBuffer,
+                    VkImage srcImage, SwapchainInfo* swapchainInfo, uint32_t imageIndex,
+                    const TransferPlan& plan, bool load, const std::vector<VkRect2D>& rects);
+
+#endif // VULKAN_TRANSFER_H
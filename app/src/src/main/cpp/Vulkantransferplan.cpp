@@ -0,0 +1,102 @@
+//
+// Transfer classification: which output uv -> input uv transforms can skip the shader.
+//
+#include "Vulkantransferplan.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace {
+
+    // 矩阵中应为 0 的项（旋转/错切/透视）的容差
+    constexpr double kMatrixEpsilon = 1e-6;
+    // 区域边界离整数像素的容差（像素）：float 矩阵乘以 4K 尺寸后的舍入误差远小于此
+    constexpr double kPixelEpsilon = 1.0 / 256.0;
+
+    // 单个坐标轴上的映射：源像素坐标 s = k * d + c（d 为输出像素坐标，均为连续坐标）
+    struct AxisMapping {
+        int32_t srcStart;
+        int32_t srcEnd;    // 翻转时小于 srcStart
+        int32_t dstStart;
+        int32_t dstEnd;
+    };
+
+    bool snapToPixel(double value, int32_t* pixel) {
+        const double rounded = std::round(value);
+        if (std::fabs(value - rounded) > kPixelEpsilon) return false;
+        *pixel = static_cast<int32_t>(rounded);
+        return true;
+    }
+
+    // scale/offset 为矩阵在该轴上的缩放和平移（uv 单位）。
+    // 输出中读取位置落在 [0, srcSize] 内的区间就是需要写入的区域，两端在输出和输入上都必须是整数像素
+    bool mapAxis(double scale, double offset, uint32_t srcSize, uint32_t dstSize, AxisMapping* mapping) {
+        const double k = scale * srcSize / dstSize;
+        const double c = offset * srcSize;
+        if (std::fabs(k) < kMatrixEpsilon) return false;
+
+        double lo = -c / k;
+        double hi = (srcSize - c) / k;
+        if (lo > hi) std::swap(lo, hi);
+        lo = std::max(lo, 0.0);
+        hi = std::min(hi, static_cast<double>(dstSize));
+        if (hi - lo < 1.0 - kPixelEpsilon) return false;  // 不到一个像素（或整个输出都是透明）
+
+        if (!snapToPixel(lo, &mapping->dstStart) || !snapToPixel(hi, &mapping->dstEnd)) return false;
+        if (!snapToPixel(k * mapping->dstStart + c, &mapping->srcStart) ||
+            !snapToPixel(k * mapping->dstEnd + c, &mapping->srcEnd)) {
+            return false;
+        }
+
+        const int32_t maxSrc = static_cast<int32_t>(srcSize);
+        return std::min(mapping->srcStart, mapping->srcEnd) >= 0 &&
+               std::max(mapping->srcStart, mapping->srcEnd) <= maxSrc;
+    }
+
+    bool isUnitScale(const AxisMapping& mapping) {
+        return std::abs(mapping.srcEnd - mapping.srcStart) == mapping.dstEnd - mapping.dstStart;
+    }
+
+} // anonymous namespace
+
+TransferPlan classifyTransfer(const float matrix[16],
+                              uint32_t srcWidth, uint32_t srcHeight,
+                              uint32_t dstWidth, uint32_t dstHeight,
+                              bool sameFormat) {
+    TransferPlan plan;
+    if (srcWidth == 0 || srcHeight == 0 || dstWidth == 0 || dstHeight == 0) {
+        return plan;
+    }
+
+    // u' = m[0] * u + m[4] * v + m[12]，v' = m[1] * u + m[5] * v + m[13]：交叉项不为 0 即旋转或错切
+    if (std::fabs(matrix[1]) > kMatrixEpsilon || std::fabs(matrix[4]) > kMatrixEpsilon) return plan;
+    if (std::fabs(matrix[3]) > kMatrixEpsilon || std::fabs(matrix[7]) > kMatrixEpsilon ||
+        std::fabs(matrix[15] - 1.0) > kMatrixEpsilon) {
+        return plan;
+    }
+
+    AxisMapping x{};
+    AxisMapping y{};
+    if (!mapAxis(matrix[0], matrix[12], srcWidth, dstWidth, &x) ||
+        !mapAxis(matrix[5], matrix[13], srcHeight, dstHeight, &y)) {
+        return plan;
+    }
+
+    plan.srcStart = {x.srcStart, y.srcStart};
+    plan.srcEnd = {x.srcEnd, y.srcEnd};
+    plan.dstStart = {x.dstStart, y.dstStart};
+    plan.dstEnd = {x.dstEnd, y.dstEnd};
+    plan.covers = x.dstStart == 0 && y.dstStart == 0 &&
+                  x.dstEnd == static_cast<int32_t>(dstWidth) &&
+                  y.dstEnd == static_cast<int32_t>(dstHeight);
+
+    const bool unit = isUnitScale(x) && isUnitScale(y);
+    const bool flipped = x.srcEnd < x.srcStart || y.srcEnd < y.srcStart;
+    if (unit && !flipped && sameFormat) {
+        plan.path = TransferPath::Copy;
+    } else {
+        plan.path = TransferPath::Blit;
+        plan.linear = !unit;
+    }
+    return plan;
+}
@@ -0,0 +1,47 @@
+//
+// Transfer classification: which output uv -> input uv transforms can skip the shader.
+//
+// 根据滤镜给出的输出 uv → 输入 uv 矩阵（VulkanFilter.transferTransform）对变换分类：
+// - Copy：1:1 像素映射、整数偏移、不翻转、格式相同 → vkCmdCopyImage（恒等变换、整数裁剪）；
+// - Blit：轴对齐（无旋转/错切），输出和输入的边界都落在整数像素上 → vkCmdBlitImage，
+//   翻转用反向的 offset 表示，1:1 时 NEAREST，否则 LINEAR（与 shader 的双线性采样一致）；
+// - Shader：真正的旋转/错切、透视，或边界落在像素中间（blit 的 offset 只能是整数）。
+// 只做纯计算，不依赖 Vulkan / JNI：录制在 Vulkantransfer.h，宿主机测试（bench/）直接链接。
+//
+#ifndef VULKAN_TRANSFER_PLAN_H
+#define VULKAN_TRANSFER_PLAN_H
+
+#include <cstdint>
+
+enum class TransferPath : int32_t {
+    Shader = 0,  // 需要完整的 pipeline
+    Copy = 1,
+    Blit = 2,
+};
+
+struct TransferPoint {
+    int32_t x;
+    int32_t y;
+};
+
+struct TransferPlan {
+    TransferPath path = TransferPath::Shader;
+
+    // 源和目标上的对应区域（x0, y0）-（x1, y1）；Blit 时源区域可以是反向的（翻转）
+    TransferPoint srcStart = {0, 0};
+    TransferPoint srcEnd = {0, 0};
+    TransferPoint dstStart = {0, 0};
+    TransferPoint dstEnd = {0, 0};
+
+    bool covers = false;  // 目标区域覆盖整张输出图像（否则整帧重绘时需要先清空）
+    bool linear = false;  // Blit 用 LINEAR 过滤（非 1:1），否则 NEAREST
+};
+
+// 对 4x4 列主序矩阵（输出 uv → 输入 uv）分类。sameFormat：源和目标格式相同（Copy 的前提）。
+// 只依赖尺寸，可以在任意线程调用
+TransferPlan classifyTransfer(const float matrix[16],
+                              uint32_t srcWidth, uint32_t srcHeight,
+                              uint32_t dstWidth, uint32_t dstHeight,
+                              bool sameFormat);
+
+#endif // VULKAN_TRANSFER_PLAN_H
@@ -4,6 +4,17 @@
 #include <vulkan/vulkan.h>
 #include <vector>
 
+struct PipelineCacheInfo;  // Vulkanpipelinecache.h
+struct PipelineRegistry;   // Vulkanpipelineregistry.h
+struct PipelineCompiler;   // Vulkanpipelinecompiler.h
+struct LayoutCache;        // Vulkanlayoutcache.h
+struct SamplerCache;       // Vulkansamplers.h
+struct BindlessTable;      // Vulkanbindless.h
+struct ImageStateTracker;  // Vulkanbarriers.h
+struct GpuProfiler;        // Vulkanprofiler.h
+struct FrameStats;         // Vulkanframestats.h
+struct ShaderStatistics;   // Vulkanshaderstats.h
+
 // 交换链信息
 struct SwapchainInfo {
     VkSwapchainKHR swapchain;
@@ -12,6 +23,8 @@ struct SwapchainInfo {
     std::vector<VkFramebuffer> framebuffers;
     VkSurfaceFormatKHR format;
     VkExtent2D extent;
+    // 交换链图像用途（计算输出会额外添加 STORAGE 或 TRANSFER_DST），重建时沿用
+    VkImageUsageFlags usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
 };
 
 // 设备信息
@@ -23,6 +36,66 @@ struct DeviceInfo {
     uint32_t graphicsQueueFamily;
     uint32_t presentQueueFamily;
     VkSurfaceKHR surface;
+
+    // 可选扩展支持情况（创建设备时检测）
+    bool incrementalPresentSupported = false;  // VK_KHR_incremental_present
+
+    // VK_KHR_dynamic_rendering：为 true 时不使用 render pass / framebuffer（见 Vulkanrendering.h）
+    bool dynamicRendering = false;
+    PFN_vkCmdBeginRenderingKHR cmdBeginRendering = nullptr;
+    PFN_vkCmdEndRenderingKHR cmdEndRendering = nullptr;
+
+    // VK_KHR_synchronization2：为 false 时 barrier 回退到 vkCmdPipelineBarrier（见 Vulkanbarriers.h）
+    bool synchronization2 = false;
+    PFN_vkCmdPipelineBarrier2KHR cmdPipelineBarrier2 = nullptr;
+
+    // VK_KHR_push_descriptor：为 true 时 layout 可以把 set 创建为 push set（见 Vulkandescriptors.h）
+    bool pushDescriptors = false;
+    PFN_vkCmdPushDescriptorSetKHR cmdPushDescriptorSet = nullptr;
+
+    // VK_EXT_descriptor_indexing：设备级的 bindless 输入纹理表，不支持时为空（见 Vulkanbindless.h）
+    BindlessTable* bindlessTable = nullptr;
+
+    // 帧序号：runner 每帧等待 in-flight fence 之后加一。最后一次使用落后 framesInFlight 帧以上的
+    // 资源已经不再被 GPU 引用
+    uint64_t frameSerial = 0;
+    uint32_t framesInFlight = 2;
+
+    // 图像布局/访问状态跟踪（创建设备时建立）
+    ImageStateTracker* imageStates = nullptr;
+
+    // 颜色附件格式：创建交换链时更新，render pass、离屏目标和动态渲染 pipeline 都使用它
+    VkFormat colorFormat = VK_FORMAT_B8G8R8A8_UNORM;
+
+    // 所有滤镜共享的 pipeline 缓存（可为空）
+    PipelineCacheInfo* pipelineCache = nullptr;
+
+    // 按状态共享的 pipeline（创建设备时建立，销毁设备时释放）
+    PipelineRegistry* pipelineRegistry = nullptr;
+
+    // 后台 pipeline 编译线程（创建设备时启动）
+    PipelineCompiler* pipelineCompiler = nullptr;
+
+    // 由 SPIR-V 反射生成、按接口去重的 pipeline layout
+    LayoutCache* layoutCache = nullptr;
+
+    // 按完整 create info 去重的 sampler（保留到设备销毁，可作为 immutable sampler）
+    SamplerCache* samplerCache = nullptr;
+
+    // 按 pass 的 GPU timestamp 统计，runner 开启时创建（见 Vulkanprofiler.h）
+    GpuProfiler* gpuProfiler = nullptr;
+
+    // 帧循环各阶段的直方图统计，创建设备时创建（见 Vulkanframestats.h）
+    FrameStats* frameStats = nullptr;
+
+    // pipeline 统计查询 / pipeline 可执行体统计，runner 以 shaderStatistics 启动且设备支持时创建（见 Vulkanshaderstats.h）
+    ShaderStatistics* shaderStatistics = nullptr;
+
+    // VK_EXT_calibrated_timestamps：trace 把 GPU timestamp 换算到 CPU 时钟（见 Vulkantracegpu.h），不支持时为空
+    PFN_vkGetCalibratedTimestampsEXT getCalibratedTimestamps = nullptr;
+
+    // 创建交换链前设置：为计算滤镜选择可写入的交换链格式/用途（见 Vulkancompute.h）
+    bool computeOutputRequested = false;
 };
 
 // 纹理信息
@@ -2,11 +2,11 @@
 // Created by 31483 on 2025/11/28.
 //
 #include "VulkanTypes.h"
-#include <android/log.h>
+#include "Vulkanlog.h"
 
 #define LOG_TAG "VulkanUtils"
-#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
-#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+#define LOGI(...) VLOGI(LOG_TAG, __VA_ARGS__)
+#define LOGE(...) VLOGE(LOG_TAG, __VA_ARGS__)
 
 // 查找队列族
 uint32_t findQueueFamily(VkPhysicalDevice physicalDevice, VkQueueFlags flags,
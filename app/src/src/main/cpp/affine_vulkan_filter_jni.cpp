@@ -4,103 +4,22 @@
 // affine_vulkan_filter_jni.cpp - UNIFIED VERSION
 
 #include <jni.h>
-#include <android/log.h>
+#include "Vulkanlog.h"
 #include <vulkan/vulkan.h>
 #include <vector>
 #include <cstring>
 #include "Vulkantypes.h"
+#include "Vulkanpipelineregistry.h"
+#include "Vulkansamplers.h"
 
 #define LOG_TAG "AffineVulkanFilter-JNI"
-#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
-#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
-#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
-#define LOGW(...) __android_log_print(ANDROID_LOG_WARN, LOG_TAG, __VA_ARGS__)
+#define LOGD(...) VLOGD(LOG_TAG, __VA_ARGS__)
+#define LOGE(...) VLOGE(LOG_TAG, __VA_ARGS__)
+#define LOGI(...) VLOGI(LOG_TAG, __VA_ARGS__)
+#define LOGW(...) VLOGW(LOG_TAG, __VA_ARGS__)
 
 extern "C" {
 
-// ==================== Descriptor Set Layout ====================
-
-JNIEXPORT jlong JNICALL
-Java_com_genymobile_scrcpy_vulkan_AffineVulkanFilter_nativeCreateDescriptorSetLayout(
-        JNIEnv* env, jobject /* this */, jlong deviceHandle) {
-
-    DeviceInfo* deviceInfo = reinterpret_cast<DeviceInfo*>(deviceHandle);
-
-    // Binding 0: Combined image sampler (fragment shader)
-    VkDescriptorSetLayoutBinding samplerLayoutBinding{};
-    samplerLayoutBinding.binding = 0;
-    samplerLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    samplerLayoutBinding.descriptorCount = 1;
-    samplerLayoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
-    samplerLayoutBinding.pImmutableSamplers = nullptr;
-
-    VkDescriptorSetLayoutCreateInfo layoutInfo{};
-    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-    layoutInfo.bindingCount = 1;
-    layoutInfo.pBindings = &samplerLayoutBinding;
-
-    VkDescriptorSetLayout descriptorSetLayout;
-    VkResult result = vkCreateDescriptorSetLayout(
-            deviceInfo->device,
-            &layoutInfo,
-            nullptr,
-            &descriptorSetLayout
-    );
-
-    if (result != VK_SUCCESS) {
-        LOGE("Failed to create descriptor set layout: %d", result);
-        return 0;
-    }
-
-    LOGI("✓ Descriptor set layout created: %p", (void*)descriptorSetLayout);
-    return reinterpret_cast<jlong>(descriptorSetLayout);
-}
-
-// ==================== Pipeline Layout ====================
-
-JNIEXPORT jlong JNICALL
-Java_com_genymobile_scrcpy_vulkan_AffineVulkanFilter_nativeCreatePipelineLayout(
-        JNIEnv* env, jobject /* this */,
-        jlong deviceHandle,
-        jlong descriptorSetLayoutHandle) {
-
-    DeviceInfo* deviceInfo = reinterpret_cast<DeviceInfo*>(deviceHandle);
-    VkDescriptorSetLayout descriptorSetLayout =
-            reinterpret_cast<VkDescriptorSetLayout>(descriptorSetLayoutHandle);
-
-    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
-    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-    pipelineLayoutInfo.setLayoutCount = 1;
-    pipelineLayoutInfo.pSetLayouts = &descriptorSetLayout;
-
-    // Push Constants: 2 个 4x4 矩阵
-    // - mat4 tex_matrix   (64 bytes)
-    // - mat4 user_matrix  (64 bytes)
-    // 总计：128 bytes
-    VkPushConstantRange pushConstantRange{};
-    pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;  // 顶点着色器使用
-    pushConstantRange.offset = 0;
-    pushConstantRange.size = sizeof(float) * 32;  // 2 个 4x4 矩阵 = 32 floats
-    pipelineLayoutInfo.pushConstantRangeCount = 1;
-    pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
-
-    VkPipelineLayout pipelineLayout;
-    VkResult result = vkCreatePipelineLayout(
-            deviceInfo->device,
-            &pipelineLayoutInfo,
-            nullptr,
-            &pipelineLayout
-    );
-
-    if (result != VK_SUCCESS) {
-        LOGE("Failed to create pipeline layout: %d", result);
-        return 0;
-    }
-
-    LOGI("✓ Pipeline layout created with 2x mat4 push constants (128 bytes)");
-    return reinterpret_cast<jlong>(pipelineLayout);
-}
-
 // ==================== Shader Module ====================
 
 JNIEXPORT jlong JNICALL
@@ -169,214 +88,23 @@ Java_com_genymobile_scrcpy_vulkan_AffineVulkanFilter_nativeCreateShaderModule(
         LOGE("vkCreateShaderModule failed: %d", result);
         return 0;
     }
+    registerShaderModule(deviceInfo, shaderModule, alignedCode.data(), codeSize);
 
     LOGI("Shader module created successfully: %p", shaderModule);
     return static_cast<jlong>(reinterpret_cast<uintptr_t>(shaderModule));
 }
 
-// ==================== Graphics Pipeline ====================
-
-JNIEXPORT jlong JNICALL
-Java_com_genymobile_scrcpy_vulkan_AffineVulkanFilter_nativeCreateGraphicsPipeline(
-        JNIEnv* env,
-        jobject thiz,
-        jlong deviceHandle,
-        jlong renderPassHandle,
-        jlong pipelineLayoutHandle,
-        jlong vertShaderModuleHandle,
-        jlong fragShaderModuleHandle
-) {
-    LOGI("=== Creating Graphics Pipeline ===");
-
-    DeviceInfo* deviceInfo = reinterpret_cast<DeviceInfo*>(deviceHandle);
-    VkDevice device = deviceInfo->device;
-    VkRenderPass renderPass = reinterpret_cast<VkRenderPass>(renderPassHandle);
-    VkPipelineLayout pipelineLayout = reinterpret_cast<VkPipelineLayout>(pipelineLayoutHandle);
-    VkShaderModule vertShaderModule = reinterpret_cast<VkShaderModule>(vertShaderModuleHandle);
-    VkShaderModule fragShaderModule = reinterpret_cast<VkShaderModule>(fragShaderModuleHandle);
-
-    // Shader stages
-    VkPipelineShaderStageCreateInfo vertShaderStageInfo{};
-    vertShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-    vertShaderStageInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
-    vertShaderStageInfo.module = vertShaderModule;
-    vertShaderStageInfo.pName = "main";
-
-    VkPipelineShaderStageCreateInfo fragShaderStageInfo{};
-    fragShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-    fragShaderStageInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
-    fragShaderStageInfo.module = fragShaderModule;
-    fragShaderStageInfo.pName = "main";
-
-    VkPipelineShaderStageCreateInfo shaderStages[] = {
-            vertShaderStageInfo,
-            fragShaderStageInfo
-    };
-
-    // Vertex input - 空的（顶点在shader中生成）
-    VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
-    vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-    vertexInputInfo.vertexBindingDescriptionCount = 0;
-    vertexInputInfo.pVertexBindingDescriptions = nullptr;
-    vertexInputInfo.vertexAttributeDescriptionCount = 0;
-    vertexInputInfo.pVertexAttributeDescriptions = nullptr;
-
-    // Input assembly
-    VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
-    inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
-    inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
-    inputAssembly.primitiveRestartEnable = VK_FALSE;
-
-    // Viewport state - 使用动态状态
-    VkPipelineViewportStateCreateInfo viewportState{};
-    viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
-    viewportState.viewportCount = 1;
-    viewportState.scissorCount = 1;
-    // pViewports 和 pScissors 留空（动态设置）
-
-    // Rasterization
-    VkPipelineRasterizationStateCreateInfo rasterizer{};
-    rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
-    rasterizer.depthClampEnable = VK_FALSE;
-    rasterizer.rasterizerDiscardEnable = VK_FALSE;  // 重要！必须 FALSE
-    rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
-    rasterizer.lineWidth = 1.0f;
-    rasterizer.cullMode = VK_CULL_MODE_NONE;  // 先禁用背面剔除测试
-    rasterizer.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
-    rasterizer.depthBiasEnable = VK_FALSE;
-
-    LOGI("Rasterizer: discard=%d, cull=%d, fill=%d",
-         rasterizer.rasterizerDiscardEnable,
-         rasterizer.cullMode,
-         rasterizer.polygonMode);
-
-    // Multisampling
-    VkPipelineMultisampleStateCreateInfo multisampling{};
-    multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
-    multisampling.sampleShadingEnable = VK_FALSE;
-    multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
-
-    // Depth/Stencil - 禁用
-    VkPipelineDepthStencilStateCreateInfo depthStencil{};
-    depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
-    depthStencil.depthTestEnable = VK_FALSE;
-    depthStencil.depthWriteEnable = VK_FALSE;
-    depthStencil.stencilTestEnable = VK_FALSE;
-
-    // Color blending
-    VkPipelineColorBlendAttachmentState colorBlendAttachment{};
-    colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT |
-                                          VK_COLOR_COMPONENT_G_BIT |
-                                          VK_COLOR_COMPONENT_B_BIT |
-                                          VK_COLOR_COMPONENT_A_BIT;
-    colorBlendAttachment.blendEnable = VK_FALSE;
-
-    VkPipelineColorBlendStateCreateInfo colorBlending{};
-    colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
-    colorBlending.logicOpEnable = VK_FALSE;
-    colorBlending.logicOp = VK_LOGIC_OP_COPY;
-    colorBlending.attachmentCount = 1;
-    colorBlending.pAttachments = &colorBlendAttachment;
-    colorBlending.blendConstants[0] = 0.0f;
-    colorBlending.blendConstants[1] = 0.0f;
-    colorBlending.blendConstants[2] = 0.0f;
-    colorBlending.blendConstants[3] = 0.0f;
-
-    LOGI("Color blend: enabled=%d, writeMask=0x%x",
-         colorBlendAttachment.blendEnable,
-         colorBlendAttachment.colorWriteMask);
-
-    // Dynamic states
-    VkDynamicState dynamicStates[] = {
-            VK_DYNAMIC_STATE_VIEWPORT,
-            VK_DYNAMIC_STATE_SCISSOR
-    };
-
-    VkPipelineDynamicStateCreateInfo dynamicState{};
-    dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
-    dynamicState.dynamicStateCount = 2;
-    dynamicState.pDynamicStates = dynamicStates;
-
-    // Create pipeline
-    VkGraphicsPipelineCreateInfo pipelineInfo{};
-    pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-    pipelineInfo.stageCount = 2;
-    pipelineInfo.pStages = shaderStages;
-    pipelineInfo.pVertexInputState = &vertexInputInfo;
-    pipelineInfo.pInputAssemblyState = &inputAssembly;
-    pipelineInfo.pViewportState = &viewportState;
-    pipelineInfo.pRasterizationState = &rasterizer;
-    pipelineInfo.pMultisampleState = &multisampling;
-    pipelineInfo.pDepthStencilState = &depthStencil;  // 重要！不要忘记
-    pipelineInfo.pColorBlendState = &colorBlending;
-    pipelineInfo.pDynamicState = &dynamicState;
-    pipelineInfo.layout = pipelineLayout;
-    pipelineInfo.renderPass = renderPass;
-    pipelineInfo.subpass = 0;
-    pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
-
-    VkPipeline graphicsPipeline;
-    VkResult result = vkCreateGraphicsPipelines(
-            device,
-            VK_NULL_HANDLE,
-            1,
-            &pipelineInfo,
-            nullptr,
-            &graphicsPipeline
-    );
-
-    if (result != VK_SUCCESS) {
-        LOGE("Failed to create graphics pipeline: %d", result);
-        return 0;
-    }
-
-    LOGI("✓ Graphics pipeline created: %p", (void*)graphicsPipeline);
-    return reinterpret_cast<jlong>(graphicsPipeline);
-}
-
-// ==================== Descriptor Pool ====================
-
-JNIEXPORT jlong JNICALL
-Java_com_genymobile_scrcpy_vulkan_AffineVulkanFilter_nativeCreateDescriptorPool(
-        JNIEnv* env,
-        jobject thiz,
-        jlong deviceHandle
-) {
-    DeviceInfo* deviceInfo = reinterpret_cast<DeviceInfo*>(deviceHandle);
-    VkDevice device = deviceInfo->device;
-
-    VkDescriptorPoolSize poolSize = {};
-    poolSize.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    poolSize.descriptorCount = 1;
-
-    VkDescriptorPoolCreateInfo poolInfo = {};
-    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-    poolInfo.poolSizeCount = 1;
-    poolInfo.pPoolSizes = &poolSize;
-    poolInfo.maxSets = 1;
-
-    VkDescriptorPool descriptorPool;
-    VkResult result = vkCreateDescriptorPool(device, &poolInfo, nullptr, &descriptorPool);
-
-    if (result != VK_SUCCESS) {
-        LOGE("Failed to create descriptor pool: VkResult=%d", result);
-        return 0;
-    }
-
-    LOGD("✓ Descriptor pool created: %p", (void*)descriptorPool);
-    return static_cast<jlong>(reinterpret_cast<uintptr_t>(descriptorPool));
-}
-
 // ==================== Sampler ====================
 
+// maxLod 为 0 时只读第 0 级（双线性）；大于 0 时按导数在 mip 链中三线性采样
 JNIEXPORT jlong JNICALL
 Java_com_genymobile_scrcpy_vulkan_AffineVulkanFilter_nativeCreateSampler(
         JNIEnv* env,
         jobject thiz,
-        jlong deviceHandle
+        jlong deviceHandle,
+        jfloat maxLod
 ) {
     DeviceInfo* deviceInfo = reinterpret_cast<DeviceInfo*>(deviceHandle);
-    VkDevice device = deviceInfo->device;
 
     VkSamplerCreateInfo samplerInfo = {};
     samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
@@ -394,107 +122,17 @@ Java_com_genymobile_scrcpy_vulkan_AffineVulkanFilter_nativeCreateSampler(
     samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
     samplerInfo.mipLodBias = 0.0f;
     samplerInfo.minLod = 0.0f;
-    samplerInfo.maxLod = 0.0f;
-
-    VkSampler sampler;
-    VkResult result = vkCreateSampler(device, &samplerInfo, nullptr, &sampler);
+    samplerInfo.maxLod = maxLod;
 
-    if (result != VK_SUCCESS) {
-        LOGE("Failed to create sampler: VkResult=%d", result);
+    // 设备级缓存：参数相同的 sampler（例如其他滤镜的双线性 sampler）共用一个
+    VkSampler sampler = acquireSampler(deviceInfo, samplerInfo);
+    if (sampler == VK_NULL_HANDLE) {
+        LOGE("Failed to create sampler");
         return 0;
     }
-
-    LOGD("✓ Sampler created: %p", (void*)sampler);
     return static_cast<jlong>(reinterpret_cast<uintptr_t>(sampler));
 }
 
-// ==================== Allocate Descriptor Set ====================
-
-JNIEXPORT jlong JNICALL
-Java_com_genymobile_scrcpy_vulkan_AffineVulkanFilter_nativeAllocateDescriptorSet(
-        JNIEnv* env, jobject thiz, jlong deviceHandle, jlong descriptorPoolHandle,
-        jlong descriptorSetLayoutHandle) {
-
-    DeviceInfo* deviceInfo = reinterpret_cast<DeviceInfo*>(deviceHandle);
-    VkDevice device = deviceInfo->device;
-    VkDescriptorPool descriptorPool = reinterpret_cast<VkDescriptorPool>(static_cast<uintptr_t>(descriptorPoolHandle));
-    VkDescriptorSetLayout descriptorSetLayout = reinterpret_cast<VkDescriptorSetLayout>(static_cast<uintptr_t>(descriptorSetLayoutHandle));
-
-    VkDescriptorSetAllocateInfo allocInfo = {};
-    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-    allocInfo.descriptorPool = descriptorPool;
-    allocInfo.descriptorSetCount = 1;
-    allocInfo.pSetLayouts = &descriptorSetLayout;
-
-    VkDescriptorSet descriptorSet;
-    VkResult result = vkAllocateDescriptorSets(device, &allocInfo, &descriptorSet);
-
-    if (result != VK_SUCCESS) {
-        return 0;
-    }
-
-    return static_cast<jlong>(reinterpret_cast<uintptr_t>(descriptorSet));
-}
-
-// ==================== Update Descriptor Set ====================
-
-JNIEXPORT void JNICALL
-Java_com_genymobile_scrcpy_vulkan_AffineVulkanFilter_nativeUpdateDescriptorSet(
-        JNIEnv* env, jobject /* this */,
-        jlong deviceHandle,
-        jlong descriptorSetHandle,
-        jlong imageViewHandle,
-        jlong samplerHandle) {
-
-    DeviceInfo* deviceInfo = reinterpret_cast<DeviceInfo*>(deviceHandle);
-    VkDescriptorSet descriptorSet = reinterpret_cast<VkDescriptorSet>(descriptorSetHandle);
-    VkImageView imageView = reinterpret_cast<VkImageView>(imageViewHandle);
-    VkSampler sampler = reinterpret_cast<VkSampler>(samplerHandle);
-
-    LOGI("=== Updating Descriptor Set ===");
-    LOGI("Device: %p", (void*)deviceInfo->device);
-    LOGI("DescriptorSet: %p", (void*)descriptorSet);
-    LOGI("ImageView: %p", (void*)imageView);
-    LOGI("Sampler: %p", (void*)sampler);
-
-    if (descriptorSet == VK_NULL_HANDLE) {
-        LOGE("Invalid descriptor set!");
-        return;
-    }
-
-    if (imageView == VK_NULL_HANDLE) {
-        LOGE("Invalid image view!");
-        return;
-    }
-
-    if (sampler == VK_NULL_HANDLE) {
-        LOGE("Invalid sampler!");
-        return;
-    }
-
-    // 配置图像描述符
-    VkDescriptorImageInfo imageInfo{};
-    imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-    imageInfo.imageView = imageView;
-    imageInfo.sampler = sampler;
-
-    LOGI("ImageInfo: layout=%d, view=%p, sampler=%p",
-         imageInfo.imageLayout, (void*)imageInfo.imageView, (void*)imageInfo.sampler);
-
-    VkWriteDescriptorSet descriptorWrite{};
-    descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    descriptorWrite.dstSet = descriptorSet;
-    descriptorWrite.dstBinding = 0;  // binding = 0 in shader
-    descriptorWrite.dstArrayElement = 0;
-    descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    descriptorWrite.descriptorCount = 1;
-    descriptorWrite.pImageInfo = &imageInfo;
-
-    vkUpdateDescriptorSets(deviceInfo->device, 1, &descriptorWrite, 0, nullptr);
-
-    LOGI("✓ Descriptor set updated successfully");
-}
-
 // ==================== Command Buffer Operations ====================
 
 JNIEXPORT void JNICALL
@@ -507,8 +145,6 @@ Java_com_genymobile_scrcpy_vulkan_AffineVulkanFilter_nativeBindPipeline(
     VkCommandBuffer commandBuffer = reinterpret_cast<VkCommandBuffer>(commandBufferHandle);
     VkPipeline pipeline = reinterpret_cast<VkPipeline>(pipelineHandle);
 
-    LOGI("Binding pipeline: cmd=%p, pipeline=%p", (void*)commandBuffer, (void*)pipeline);
-
     if (commandBuffer == VK_NULL_HANDLE) {
         LOGE("Invalid command buffer!");
         return;
@@ -520,52 +156,6 @@ Java_com_genymobile_scrcpy_vulkan_AffineVulkanFilter_nativeBindPipeline(
     }
 
     vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
-    LOGI("✓ Pipeline bound successfully");
-}
-
-JNIEXPORT void JNICALL
-Java_com_genymobile_scrcpy_vulkan_AffineVulkanFilter_nativeBindDescriptorSets(
-        JNIEnv* env, jobject /* this */,
-        jlong commandBufferHandle,
-        jlong pipelineLayoutHandle,
-        jlong descriptorSetHandle) {
-
-    VkCommandBuffer commandBuffer = reinterpret_cast<VkCommandBuffer>(commandBufferHandle);
-    VkPipelineLayout pipelineLayout = reinterpret_cast<VkPipelineLayout>(pipelineLayoutHandle);
-    VkDescriptorSet descriptorSet = reinterpret_cast<VkDescriptorSet>(descriptorSetHandle);
-
-    LOGI("Binding descriptor sets:");
-    LOGI("  CommandBuffer: %p", (void*)commandBuffer);
-    LOGI("  PipelineLayout: %p", (void*)pipelineLayout);
-    LOGI("  DescriptorSet: %p", (void*)descriptorSet);
-
-    if (commandBuffer == VK_NULL_HANDLE) {
-        LOGE("Invalid command buffer!");
-        return;
-    }
-
-    if (pipelineLayout == VK_NULL_HANDLE) {
-        LOGE("Invalid pipeline layout!");
-        return;
-    }
-
-    if (descriptorSet == VK_NULL_HANDLE) {
-        LOGE("Invalid descriptor set!");
-        return;
-    }
-
-    vkCmdBindDescriptorSets(
-            commandBuffer,
-            VK_PIPELINE_BIND_POINT_GRAPHICS,
-            pipelineLayout,
-            0,  // firstSet
-            1,  // descriptorSetCount
-            &descriptorSet,
-            0,  // dynamicOffsetCount
-            nullptr
-    );
-
-    LOGI("✓ Descriptor sets bound successfully");
 }
 
 JNIEXPORT void JNICALL
@@ -573,6 +163,7 @@ Java_com_genymobile_scrcpy_vulkan_AffineVulkanFilter_nativePushConstants(
         JNIEnv* env, jobject thiz,
         jlong commandBufferHandle,
         jlong pipelineLayoutHandle,
+        jint stageFlags,
         jfloatArray dataArray) {
 
     VkCommandBuffer commandBuffer = reinterpret_cast<VkCommandBuffer>(
@@ -606,22 +197,12 @@ Java_com_genymobile_scrcpy_vulkan_AffineVulkanFilter_nativePushConstants(
     vkCmdPushConstants(
             commandBuffer,
             pipelineLayout,
-            VK_SHADER_STAGE_VERTEX_BIT,  // 关键：顶点着色器使用矩阵
+            static_cast<VkShaderStageFlags>(stageFlags),  // 反射结果：顶点着色器使用矩阵
             0,
             dataSize * sizeof(float),  // 128 bytes
             data
     );
 
-    // 添加详细日志（可选，用于调试）
-    static int logCounter = 0;
-    if (logCounter++ % 300 == 0) {  // 每300帧打印一次
-        LOGI("Pushed 2x mat4 constants:");
-        LOGI("  tex_matrix[0]: [%.2f, %.2f, %.2f, %.2f]",
-             data[0], data[1], data[2], data[3]);
-        LOGI("  user_matrix[0]: [%.2f, %.2f, %.2f, %.2f]",
-             data[16], data[17], data[18], data[19]);
-    }
-
     env->ReleaseFloatArrayElements(dataArray, data, JNI_ABORT);  // 使用JNI_ABORT因为只读
 }
 
@@ -649,61 +230,75 @@ Java_com_genymobile_scrcpy_vulkan_AffineVulkanFilter_nativeDraw(
 //    LOGI("✓ Draw command recorded");
 }
 
-// ==================== Destruction Functions ====================
+// ==================== Compute Path ====================
 
-JNIEXPORT void JNICALL
-Java_com_genymobile_scrcpy_vulkan_AffineVulkanFilter_nativeDestroyDescriptorPool(
-        JNIEnv* env, jobject thiz, jlong deviceHandle, jlong descriptorPoolHandle
-) {
-    DeviceInfo* deviceInfo = reinterpret_cast<DeviceInfo*>(deviceHandle);
-    VkDevice device = deviceInfo->device;
-    VkDescriptorPool descriptorPool = reinterpret_cast<VkDescriptorPool>(static_cast<uintptr_t>(descriptorPoolHandle));
-    vkDestroyDescriptorPool(device, descriptorPool, nullptr);
-    LOGD("Descriptor pool destroyed");
-}
+// 与 affine.comp 的 push constant 块一致（80 字节）
+struct ComputePushConstants {
+    float uvMatrix[16];   // tex_matrix * user_matrix
+    int32_t region[4];    // x, y, w, h
+};
 
+// 每个矩形一次 dispatch（16x16 工作组），只覆盖脏区域；descriptor 由调用方（DescriptorManager）绑定
 JNIEXPORT void JNICALL
-Java_com_genymobile_scrcpy_vulkan_AffineVulkanFilter_nativeDestroySampler(
-        JNIEnv* env, jobject thiz, jlong deviceHandle, jlong samplerHandle
-) {
-    DeviceInfo* deviceInfo = reinterpret_cast<DeviceInfo*>(deviceHandle);
-    VkDevice device = deviceInfo->device;
-    VkSampler sampler = reinterpret_cast<VkSampler>(static_cast<uintptr_t>(samplerHandle));
-    vkDestroySampler(device, sampler, nullptr);
-    LOGD("Sampler destroyed");
-}
+Java_com_genymobile_scrcpy_vulkan_AffineVulkanFilter_nativeDispatchCompute(
+        JNIEnv* env, jobject thiz,
+        jlong commandBufferHandle,
+        jlong pipelineHandle,
+        jlong pipelineLayoutHandle,
+        jint stageFlags,
+        jfloatArray matrixArray,
+        jintArray rectArray) {
 
-JNIEXPORT void JNICALL
-Java_com_genymobile_scrcpy_vulkan_AffineVulkanFilter_nativeDestroyPipeline(
-        JNIEnv* env, jobject thiz, jlong deviceHandle, jlong pipelineHandle
-) {
-    DeviceInfo* deviceInfo = reinterpret_cast<DeviceInfo*>(deviceHandle);
-    VkDevice device = deviceInfo->device;
-    VkPipeline pipeline = reinterpret_cast<VkPipeline>(static_cast<uintptr_t>(pipelineHandle));
-    vkDestroyPipeline(device, pipeline, nullptr);
-    LOGD("Pipeline destroyed");
-}
+    VkCommandBuffer commandBuffer = reinterpret_cast<VkCommandBuffer>(commandBufferHandle);
+    VkPipeline pipeline = reinterpret_cast<VkPipeline>(pipelineHandle);
+    VkPipelineLayout pipelineLayout = reinterpret_cast<VkPipelineLayout>(pipelineLayoutHandle);
 
-JNIEXPORT void JNICALL
-Java_com_genymobile_scrcpy_vulkan_AffineVulkanFilter_nativeDestroyPipelineLayout(
-        JNIEnv* env, jobject thiz, jlong deviceHandle, jlong pipelineLayoutHandle
-) {
-    DeviceInfo* deviceInfo = reinterpret_cast<DeviceInfo*>(deviceHandle);
-    VkDevice device = deviceInfo->device;
-    VkPipelineLayout pipelineLayout = reinterpret_cast<VkPipelineLayout>(static_cast<uintptr_t>(pipelineLayoutHandle));
-    vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
-    LOGD("Pipeline layout destroyed");
+    if (commandBuffer == VK_NULL_HANDLE || pipeline == VK_NULL_HANDLE || pipelineLayout == VK_NULL_HANDLE) {
+        LOGE("Invalid handles in dispatch");
+        return;
+    }
+    if (!matrixArray || env->GetArrayLength(matrixArray) != 16) {
+        LOGE("Invalid matrix (expected 16 floats)");
+        return;
+    }
+    if (!rectArray) {
+        LOGE("rectArray is null");
+        return;
+    }
+
+    ComputePushConstants constants{};
+    env->GetFloatArrayRegion(matrixArray, 0, 16, constants.uvMatrix);
+
+    jsize count = env->GetArrayLength(rectArray);
+    std::vector<jint> rects(count);
+    env->GetIntArrayRegion(rectArray, 0, count, rects.data());
+
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+
+    for (jsize i = 0; i + 3 < count; i += 4) {
+        const int32_t width = rects[i + 2];
+        const int32_t height = rects[i + 3];
+        if (width <= 0 || height <= 0) continue;
+
+        constants.region[0] = rects[i];
+        constants.region[1] = rects[i + 1];
+        constants.region[2] = width;
+        constants.region[3] = height;
+        vkCmdPushConstants(commandBuffer, pipelineLayout, static_cast<VkShaderStageFlags>(stageFlags),
+                           0, sizeof(constants), &constants);
+        vkCmdDispatch(commandBuffer, (width + 15) / 16, (height + 15) / 16, 1);
+    }
 }
 
+// ==================== Destruction Functions ====================
+
 JNIEXPORT void JNICALL
-Java_com_genymobile_scrcpy_vulkan_AffineVulkanFilter_nativeDestroyDescriptorSetLayout(
-        JNIEnv* env, jobject thiz, jlong deviceHandle, jlong descriptorSetLayoutHandle
+Java_com_genymobile_scrcpy_vulkan_AffineVulkanFilter_nativeDestroySampler(
+        JNIEnv* env, jobject thiz, jlong deviceHandle, jlong samplerHandle
 ) {
     DeviceInfo* deviceInfo = reinterpret_cast<DeviceInfo*>(deviceHandle);
-    VkDevice device = deviceInfo->device;
-    VkDescriptorSetLayout descriptorSetLayout = reinterpret_cast<VkDescriptorSetLayout>(static_cast<uintptr_t>(descriptorSetLayoutHandle));
-    vkDestroyDescriptorSetLayout(device, descriptorSetLayout, nullptr);
-    LOGD("Descriptor set layout destroyed");
+    VkSampler sampler = reinterpret_cast<VkSampler>(static_cast<uintptr_t>(samplerHandle));
+    releaseSampler(deviceInfo, sampler);
 }
 
 JNIEXPORT void JNICALL
@@ -713,6 +308,7 @@ Java_com_genymobile_scrcpy_vulkan_AffineVulkanFilter_nativeDestroyShaderModule(
     DeviceInfo* deviceInfo = reinterpret_cast<DeviceInfo*>(deviceHandle);
     VkDevice device = deviceInfo->device;
     VkShaderModule shaderModule = reinterpret_cast<VkShaderModule>(static_cast<uintptr_t>(shaderModuleHandle));
+    unregisterShaderModule(deviceInfo, shaderModule);
     vkDestroyShaderModule(device, shaderModule, nullptr);
     LOGD("Shader module destroyed");
 }
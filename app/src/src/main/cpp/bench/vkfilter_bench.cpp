@@ -0,0 +1,1067 @@
+//
+// Headless filter benchmark for desktop Linux: throughput of the affine and procedural filters as JSON.
+//
+// 手机上的数字受温控、后台负载、显示同步影响，没法作为基线比较。这个程序不依赖 NDK / JNI，
+// 在桌面 Linux 上用任意 Vulkan 设备（包括 lavapipe 这样的软件 ICD）离屏运行和 App 相同的着色器：
+// - affine：affine.vert + affine.frag，全屏三角形采样一张输入纹理（AffineVulkanFilter 的光栅化路径）；
+// - procedural：b.vert + b.frag，不采样纹理的程序化着色（SimpleVulkanFilter / ShaderLoader）。
+// 着色器由构建从 assets/shaders 下的 GLSL 用 glslc 编译到构建目录（见 CMakeLists.txt）。
+//
+// 对每个 滤镜 × 分辨率 × frames-in-flight 组合：先跑 --warmup 帧，再计时 --frames 帧。
+// 每个在飞帧有自己的输出图像、命令缓冲、fence 和一对 timestamp 查询，与 VulkanRunner 的帧循环相同
+// （等待 fence → 录制 → 提交），只是没有 acquire / present。
+// - fps：计时帧数 / 从第一帧开始录制到最后一帧完成的墙钟时间；
+// - cpuMsPerFrame：每帧录制 + vkQueueSubmit 的 CPU 时间（不含 fence 等待）；
+// - gpuMsPerFrame：命令缓冲首尾 timestamp 之差，队列不支持 timestamp 时为 null。
+//
+// 构建和运行（需要 Vulkan 头文件、loader 和 glslc，例如 libvulkan-dev + glslc + mesa-vulkan-drivers）：
+//   cmake -S app/src/src/main/cpp -B build-bench && cmake --build build-bench
+//   ./build-bench/bench/vkfilter_bench --resolutions 1280x720,1920x1080 --frames-in-flight 1,2,3
+// 只有软件 ICD 时用 VK_ICD_FILENAMES 指定，例如 /usr/share/vulkan/icd.d/lvp_icd.x86_64.json。
+// 结果写到标准输出（或 --output 指定的文件），进度和错误写到标准错误。
+// 输出的 shaderDir 记录实际加载 SPIR-V 的目录。
+// samples/vkfilter_bench_swiftshader.json 是在单核 x86-64 上用 SwiftShader ICD 跑的一次输出
+// （--frames 60 --warmup 10 --frames-in-flight 1,2），只用来说明输出格式，数字不能和真机比较。
+// 那台机器没有 glslc，用的是 --shader-dir 指向仓库里 assets/shaders 下已提交的 .spv（glslc 编译的基线版本，
+// affine.frag / b.frag 还没有特化常量），不是 vkfilter_shaders 从当前 GLSL 编译的输出。
+//
+#include <vulkan/vulkan.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#ifndef VKFILTER_BENCH_SHADER_DIR
+#define VKFILTER_BENCH_SHADER_DIR "shaders"
+#endif
+
+namespace {
+
+// ============================================
+// Options
+// ============================================
+struct Resolution {
+    uint32_t width = 0;
+    uint32_t height = 0;
+};
+
+struct Options {
+    std::vector<std::string> filters = {"affine", "procedural"};
+    std::vector<Resolution> resolutions = {{1280, 720}, {1920, 1080}};
+    std::vector<uint32_t> framesInFlight = {2};
+    Resolution input = {1920, 1080};  // affine 的输入纹理尺寸
+    uint32_t frames = 300;
+    uint32_t warmup = 30;
+    int32_t deviceIndex = -1;         // -1：优先独立显卡，其次第一个设备
+    std::string shaderDir = VKFILTER_BENCH_SHADER_DIR;
+    std::string output;               // 为空时写标准输出
+};
+
+void printUsage(const char* program) {
+    std::fprintf(stderr,
+                 "Usage: %s [options]\n"
+                 "  --filters LIST           affine,procedural (default: both)\n"
+                 "  --resolutions LIST       WxH,... output sizes (default: 1280x720,1920x1080)\n"
+                 "  --frames N               timed frames per run (default: 300)\n"
+                 "  --warmup N               untimed frames before each run (default: 30)\n"
+                 "  --frames-in-flight LIST  e.g. 1,2,3 (default: 2)\n"
+                 "  --input WxH              affine input texture size (default: 1920x1080)\n"
+                 "  --device N               physical device index\n"
+                 "  --shader-dir DIR         directory with *_vert.spv / *_frag.spv\n"
+                 "                           (default: " VKFILTER_BENCH_SHADER_DIR ")\n"
+                 "  --output FILE            write JSON to FILE instead of stdout\n",
+                 program);
+}
+
+std::vector<std::string> splitList(const std::string& value) {
+    std::vector<std::string> items;
+    size_t start = 0;
+    while (start <= value.size()) {
+        const size_t comma = value.find(',', start);
+        const size_t end = comma == std::string::npos ? value.size() : comma;
+        if (end > start) items.push_back(value.substr(start, end - start));
+        if (comma == std::string::npos) break;
+        start = comma + 1;
+    }
+    return items;
+}
+
+bool parseUnsigned(const std::string& text, uint32_t* value) {
+    char* end = nullptr;
+    const unsigned long parsed = std::strtoul(text.c_str(), &end, 10);
+    if (text.empty() || *end != '\0' || parsed > UINT32_MAX) return false;
+    *value = static_cast<uint32_t>(parsed);
+    return true;
+}
+
+bool parseResolution(const std::string& text, Resolution* resolution) {
+    const size_t x = text.find('x');
+    return x != std::string::npos &&
+           parseUnsigned(text.substr(0, x), &resolution->width) &&
+           parseUnsigned(text.substr(x + 1), &resolution->height) &&
+           resolution->width > 0 && resolution->height > 0;
+}
+
+bool parseOptions(int argc, char** argv, Options* options) {
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printUsage(argv[0]);
+            std::exit(0);
+        }
+        if (i + 1 >= argc) {
+            std::fprintf(stderr, "Missing value for %s\n", arg.c_str());
+            return false;
+        }
+        const std::string value = argv[++i];
+
+        bool ok = true;
+        if (arg == "--filters") {
+            options->filters = splitList(value);
+            for (const std::string& filter : options->filters) {
+                ok = ok && (filter == "affine" || filter == "procedural");
+            }
+        } else if (arg == "--resolutions") {
+            options->resolutions.clear();
+            for (const std::string& item : splitList(value)) {
+                Resolution resolution;
+                ok = ok && parseResolution(item, &resolution);
+                options->resolutions.push_back(resolution);
+            }
+        } else if (arg == "--frames-in-flight") {
+            options->framesInFlight.clear();
+            for (const std::string& item : splitList(value)) {
+                uint32_t count = 0;
+                ok = ok && parseUnsigned(item, &count) && count > 0;
+                options->framesInFlight.push_back(count);
+            }
+        } else if (arg == "--frames") {
+            ok = parseUnsigned(value, &options->frames) && options->frames > 0;
+        } else if (arg == "--warmup") {
+            ok = parseUnsigned(value, &options->warmup);
+        } else if (arg == "--input") {
+            ok = parseResolution(value, &options->input);
+        } else if (arg == "--device") {
+            uint32_t index = 0;
+            ok = parseUnsigned(value, &index);
+            options->deviceIndex = static_cast<int32_t>(index);
+        } else if (arg == "--shader-dir") {
+            options->shaderDir = value;
+        } else if (arg == "--output") {
+            options->output = value;
+        } else {
+            std::fprintf(stderr, "Unknown option %s\n", arg.c_str());
+            return false;
+        }
+        if (!ok) {
+            std::fprintf(stderr, "Invalid value for %s: %s\n", arg.c_str(), value.c_str());
+            return false;
+        }
+    }
+    return !options->filters.empty() && !options->resolutions.empty() && !options->framesInFlight.empty();
+}
+
+// ============================================
+// Device
+// ============================================
+bool check(VkResult result, const char* what) {
+    if (result == VK_SUCCESS) return true;
+    std::fprintf(stderr, "%s failed: %d\n", what, result);
+    return false;
+}
+
+struct BenchDevice {
+    VkInstance instance = VK_NULL_HANDLE;
+    VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
+    VkPhysicalDeviceProperties properties{};
+    VkPhysicalDeviceMemoryProperties memoryProperties{};
+    VkDevice device = VK_NULL_HANDLE;
+    VkQueue queue = VK_NULL_HANDLE;
+    uint32_t queueFamily = 0;
+    uint32_t timestampValidBits = 0;
+    VkCommandPool commandPool = VK_NULL_HANDLE;
+};
+
+bool createDevice(const Options& options, BenchDevice* bench) {
+    VkApplicationInfo appInfo{};
+    appInfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
+    appInfo.pApplicationName = "vkfilter_bench";
+    appInfo.apiVersion = VK_API_VERSION_1_1;
+
+    // 离屏渲染，不需要任何 surface 扩展
+    VkInstanceCreateInfo instanceInfo{};
+    instanceInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+    instanceInfo.pApplicationInfo = &appInfo;
+    if (!check(vkCreateInstance(&instanceInfo, nullptr, &bench->instance), "vkCreateInstance")) return false;
+
+    uint32_t count = 0;
+    vkEnumeratePhysicalDevices(bench->instance, &count, nullptr);
+    std::vector<VkPhysicalDevice> devices(count);
+    vkEnumeratePhysicalDevices(bench->instance, &count, devices.data());
+    if (devices.empty()) {
+        std::fprintf(stderr, "No Vulkan devices\n");
+        return false;
+    }
+    if (options.deviceIndex >= 0) {
+        if (static_cast<uint32_t>(options.deviceIndex) >= devices.size()) {
+            std::fprintf(stderr, "Device index %d out of range (%zu devices)\n", options.deviceIndex, devices.size());
+            return false;
+        }
+        bench->physicalDevice = devices[options.deviceIndex];
+    } else {
+        bench->physicalDevice = devices[0];
+        for (VkPhysicalDevice candidate : devices) {
+            VkPhysicalDeviceProperties properties;
+            vkGetPhysicalDeviceProperties(candidate, &properties);
+            if (properties.deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU) {
+                bench->physicalDevice = candidate;
+                break;
+            }
+        }
+    }
+    vkGetPhysicalDeviceProperties(bench->physicalDevice, &bench->properties);
+    vkGetPhysicalDeviceMemoryProperties(bench->physicalDevice, &bench->memoryProperties);
+
+    vkGetPhysicalDeviceQueueFamilyProperties(bench->physicalDevice, &count, nullptr);
+    std::vector<VkQueueFamilyProperties> families(count);
+    vkGetPhysicalDeviceQueueFamilyProperties(bench->physicalDevice, &count, families.data());
+    bool found = false;
+    for (uint32_t i = 0; i < count && !found; i++) {
+        if (families[i].queueFlags & VK_QUEUE_GRAPHICS_BIT) {
+            bench->queueFamily = i;
+            bench->timestampValidBits = families[i].timestampValidBits;
+            found = true;
+        }
+    }
+    if (!found) {
+        std::fprintf(stderr, "%s has no graphics queue\n", bench->properties.deviceName);
+        return false;
+    }
+
+    const float priority = 1.0f;
+    VkDeviceQueueCreateInfo queueInfo{};
+    queueInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+    queueInfo.queueFamilyIndex = bench->queueFamily;
+    queueInfo.queueCount = 1;
+    queueInfo.pQueuePriorities = &priority;
+
+    VkDeviceCreateInfo deviceInfo{};
+    deviceInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+    deviceInfo.queueCreateInfoCount = 1;
+    deviceInfo.pQueueCreateInfos = &queueInfo;
+    if (!check(vkCreateDevice(bench->physicalDevice, &deviceInfo, nullptr, &bench->device), "vkCreateDevice")) {
+        return false;
+    }
+    vkGetDeviceQueue(bench->device, bench->queueFamily, 0, &bench->queue);
+
+    VkCommandPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+    poolInfo.queueFamilyIndex = bench->queueFamily;
+    if (!check(vkCreateCommandPool(bench->device, &poolInfo, nullptr, &bench->commandPool), "vkCreateCommandPool")) {
+        return false;
+    }
+
+    std::fprintf(stderr, "Device: %s (Vulkan %u.%u.%u), timestamps %s\n", bench->properties.deviceName,
+                 VK_VERSION_MAJOR(bench->properties.apiVersion), VK_VERSION_MINOR(bench->properties.apiVersion),
+                 VK_VERSION_PATCH(bench->properties.apiVersion),
+                 bench->timestampValidBits > 0 ? "supported" : "not supported");
+    return true;
+}
+
+void destroyDevice(BenchDevice* bench) {
+    if (bench->device != VK_NULL_HANDLE) {
+        vkDestroyCommandPool(bench->device, bench->commandPool, nullptr);
+        vkDestroyDevice(bench->device, nullptr);
+    }
+    if (bench->instance != VK_NULL_HANDLE) {
+        vkDestroyInstance(bench->instance, nullptr);
+    }
+}
+
+bool findMemoryType(const BenchDevice& bench, uint32_t typeBits, VkMemoryPropertyFlags flags, uint32_t* index) {
+    for (uint32_t i = 0; i < bench.memoryProperties.memoryTypeCount; i++) {
+        if ((typeBits & (1u << i)) && (bench.memoryProperties.memoryTypes[i].propertyFlags & flags) == flags) {
+            *index = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+// ============================================
+// Images
+// ============================================
+constexpr VkFormat kColorFormat = VK_FORMAT_R8G8B8A8_UNORM;
+
+struct BenchImage {
+    VkImage image = VK_NULL_HANDLE;
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    VkImageView view = VK_NULL_HANDLE;
+};
+
+bool createImage(const BenchDevice& bench, Resolution size, VkImageUsageFlags usage, BenchImage* image) {
+    VkImageCreateInfo imageInfo{};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.format = kColorFormat;
+    imageInfo.extent = {size.width, size.height, 1};
+    imageInfo.mipLevels = 1;
+    imageInfo.arrayLayers = 1;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.usage = usage;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    if (!check(vkCreateImage(bench.device, &imageInfo, nullptr, &image->image), "vkCreateImage")) return false;
+
+    VkMemoryRequirements requirements;
+    vkGetImageMemoryRequirements(bench.device, image->image, &requirements);
+    VkMemoryAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.allocationSize = requirements.size;
+    if (!findMemoryType(bench, requirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                        &allocInfo.memoryTypeIndex) &&
+        !findMemoryType(bench, requirements.memoryTypeBits, 0, &allocInfo.memoryTypeIndex)) {
+        std::fprintf(stderr, "No memory type for image\n");
+        return false;
+    }
+    if (!check(vkAllocateMemory(bench.device, &allocInfo, nullptr, &image->memory), "vkAllocateMemory")) return false;
+    vkBindImageMemory(bench.device, image->image, image->memory, 0);
+
+    VkImageViewCreateInfo viewInfo{};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image = image->image;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format = kColorFormat;
+    viewInfo.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+    return check(vkCreateImageView(bench.device, &viewInfo, nullptr, &image->view), "vkCreateImageView");
+}
+
+void destroyImage(const BenchDevice& bench, BenchImage* image) {
+    if (image->view != VK_NULL_HANDLE) vkDestroyImageView(bench.device, image->view, nullptr);
+    if (image->image != VK_NULL_HANDLE) vkDestroyImage(bench.device, image->image, nullptr);
+    if (image->memory != VK_NULL_HANDLE) vkFreeMemory(bench.device, image->memory, nullptr);
+    *image = BenchImage{};
+}
+
+VkCommandBuffer beginOneShot(const BenchDevice& bench) {
+    VkCommandBufferAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocInfo.commandPool = bench.commandPool;
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocInfo.commandBufferCount = 1;
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+    vkAllocateCommandBuffers(bench.device, &allocInfo, &commandBuffer);
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    vkBeginCommandBuffer(commandBuffer, &beginInfo);
+    return commandBuffer;
+}
+
+bool endOneShot(const BenchDevice& bench, VkCommandBuffer commandBuffer) {
+    vkEndCommandBuffer(commandBuffer);
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &commandBuffer;
+    const bool ok = check(vkQueueSubmit(bench.queue, 1, &submitInfo, VK_NULL_HANDLE), "vkQueueSubmit") &&
+                    check(vkQueueWaitIdle(bench.queue), "vkQueueWaitIdle");
+    vkFreeCommandBuffers(bench.device, bench.commandPool, 1, &commandBuffer);
+    return ok;
+}
+
+void imageBarrier(VkCommandBuffer commandBuffer, VkImage image, VkImageLayout oldLayout, VkImageLayout newLayout,
+                  VkAccessFlags srcAccess, VkAccessFlags dstAccess,
+                  VkPipelineStageFlags srcStage, VkPipelineStageFlags dstStage) {
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcAccessMask = srcAccess;
+    barrier.dstAccessMask = dstAccess;
+    barrier.oldLayout = oldLayout;
+    barrier.newLayout = newLayout;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = image;
+    barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+    vkCmdPipelineBarrier(commandBuffer, srcStage, dstStage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+}
+
+// affine 的输入纹理：渐变 + 噪声图案（纯色纹理在有帧缓冲压缩的 GPU 上快得不真实）
+bool createInputTexture(const BenchDevice& bench, Resolution size, BenchImage* texture) {
+    if (!createImage(bench, size, VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT, texture)) {
+        return false;
+    }
+
+    const VkDeviceSize bytes = static_cast<VkDeviceSize>(size.width) * size.height * 4;
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = bytes;
+    bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    VkBuffer staging = VK_NULL_HANDLE;
+    if (!check(vkCreateBuffer(bench.device, &bufferInfo, nullptr, &staging), "vkCreateBuffer")) return false;
+
+    VkMemoryRequirements requirements;
+    vkGetBufferMemoryRequirements(bench.device, staging, &requirements);
+    VkMemoryAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.allocationSize = requirements.size;
+    VkDeviceMemory stagingMemory = VK_NULL_HANDLE;
+    bool ok = findMemoryType(bench, requirements.memoryTypeBits,
+                             VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                             &allocInfo.memoryTypeIndex) &&
+              check(vkAllocateMemory(bench.device, &allocInfo, nullptr, &stagingMemory), "vkAllocateMemory");
+    if (ok) {
+        vkBindBufferMemory(bench.device, staging, stagingMemory, 0);
+        void* mapped = nullptr;
+        ok = check(vkMapMemory(bench.device, stagingMemory, 0, bytes, 0, &mapped), "vkMapMemory");
+        if (ok) {
+            auto* pixels = static_cast<uint8_t*>(mapped);
+            uint32_t noise = 0x12345678u;
+            for (uint32_t y = 0; y < size.height; y++) {
+                for (uint32_t x = 0; x < size.width; x++) {
+                    noise = noise * 1664525u + 1013904223u;
+                    uint8_t* pixel = pixels + (static_cast<size_t>(y) * size.width + x) * 4;
+                    pixel[0] = static_cast<uint8_t>(x * 255 / size.width);
+                    pixel[1] = static_cast<uint8_t>(y * 255 / size.height);
+                    pixel[2] = static_cast<uint8_t>(noise >> 24);
+                    pixel[3] = 255;
+                }
+            }
+            vkUnmapMemory(bench.device, stagingMemory);
+        }
+    }
+
+    if (ok) {
+        VkCommandBuffer commandBuffer = beginOneShot(bench);
+        imageBarrier(commandBuffer, texture->image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                     0, VK_ACCESS_TRANSFER_WRITE_BIT,
+                     VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+        VkBufferImageCopy region{};
+        region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+        region.imageExtent = {size.width, size.height, 1};
+        vkCmdCopyBufferToImage(commandBuffer, staging, texture->image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                               1, &region);
+        imageBarrier(commandBuffer, texture->image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                     VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                     VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
+                     VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+        ok = endOneShot(bench, commandBuffer);
+    }
+
+    vkDestroyBuffer(bench.device, staging, nullptr);
+    if (stagingMemory != VK_NULL_HANDLE) vkFreeMemory(bench.device, stagingMemory, nullptr);
+    return ok;
+}
+
+// ============================================
+// Filters
+// ============================================
+struct BenchFilter {
+    std::string name;
+    bool samplesInput = false;        // affine 采样输入纹理
+    VkShaderStageFlags pushConstantStages = 0;
+    uint32_t pushConstantSize = 0;
+    VkDescriptorSetLayout setLayout = VK_NULL_HANDLE;
+    VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
+    VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+    VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+    VkPipeline pipeline = VK_NULL_HANDLE;
+};
+
+bool loadShader(const BenchDevice& bench, const std::string& path, VkShaderModule* module) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        std::fprintf(stderr, "Cannot open %s (use --shader-dir)\n", path.c_str());
+        return false;
+    }
+    const std::streamsize size = file.tellg();
+    if (size <= 0 || size % 4 != 0) {
+        std::fprintf(stderr, "%s is not SPIR-V\n", path.c_str());
+        return false;
+    }
+    std::vector<uint32_t> code(static_cast<size_t>(size) / 4);
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(code.data()), size);
+
+    VkShaderModuleCreateInfo moduleInfo{};
+    moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    moduleInfo.codeSize = static_cast<size_t>(size);
+    moduleInfo.pCode = code.data();
+    return check(vkCreateShaderModule(bench.device, &moduleInfo, nullptr, module), path.c_str());
+}
+
+// 与 App 的滤镜相同的固定功能状态：全屏三角形、无混合、动态 viewport/scissor（各分辨率共用 pipeline）
+bool createPipeline(const BenchDevice& bench, const Options& options, VkRenderPass renderPass,
+                    const std::string& shaderName, BenchFilter* filter) {
+    VkShaderModule vertexModule = VK_NULL_HANDLE;
+    VkShaderModule fragmentModule = VK_NULL_HANDLE;
+    bool ok = loadShader(bench, options.shaderDir + "/" + shaderName + "_vert.spv", &vertexModule) &&
+              loadShader(bench, options.shaderDir + "/" + shaderName + "_frag.spv", &fragmentModule);
+
+    VkPushConstantRange pushRange{};
+    pushRange.stageFlags = filter->pushConstantStages;
+    pushRange.size = filter->pushConstantSize;
+    VkPipelineLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    layoutInfo.setLayoutCount = filter->setLayout != VK_NULL_HANDLE ? 1 : 0;
+    layoutInfo.pSetLayouts = &filter->setLayout;
+    layoutInfo.pushConstantRangeCount = 1;
+    layoutInfo.pPushConstantRanges = &pushRange;
+    ok = ok && check(vkCreatePipelineLayout(bench.device, &layoutInfo, nullptr, &filter->pipelineLayout),
+                     "vkCreatePipelineLayout");
+
+    if (ok) {
+        VkPipelineShaderStageCreateInfo stages[2]{};
+        stages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        stages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+        stages[0].module = vertexModule;
+        stages[0].pName = "main";
+        stages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        stages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+        stages[1].module = fragmentModule;
+        stages[1].pName = "main";
+
+        VkPipelineVertexInputStateCreateInfo vertexInput{};
+        vertexInput.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+        VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
+        inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+        inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+        VkPipelineViewportStateCreateInfo viewportState{};
+        viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+        viewportState.viewportCount = 1;
+        viewportState.scissorCount = 1;
+        VkPipelineRasterizationStateCreateInfo rasterization{};
+        rasterization.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+        rasterization.polygonMode = VK_POLYGON_MODE_FILL;
+        rasterization.cullMode = VK_CULL_MODE_NONE;
+        rasterization.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+        rasterization.lineWidth = 1.0f;
+        VkPipelineMultisampleStateCreateInfo multisample{};
+        multisample.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+        multisample.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+        VkPipelineColorBlendAttachmentState blendAttachment{};
+        blendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
+                                         VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+        VkPipelineColorBlendStateCreateInfo colorBlend{};
+        colorBlend.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+        colorBlend.attachmentCount = 1;
+        colorBlend.pAttachments = &blendAttachment;
+        const VkDynamicState dynamicStates[] = {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
+        VkPipelineDynamicStateCreateInfo dynamicState{};
+        dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+        dynamicState.dynamicStateCount = 2;
+        dynamicState.pDynamicStates = dynamicStates;
+
+        VkGraphicsPipelineCreateInfo pipelineInfo{};
+        pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+        pipelineInfo.stageCount = 2;
+        pipelineInfo.pStages = stages;
+        pipelineInfo.pVertexInputState = &vertexInput;
+        pipelineInfo.pInputAssemblyState = &inputAssembly;
+        pipelineInfo.pViewportState = &viewportState;
+        pipelineInfo.pRasterizationState = &rasterization;
+        pipelineInfo.pMultisampleState = &multisample;
+        pipelineInfo.pColorBlendState = &colorBlend;
+        pipelineInfo.pDynamicState = &dynamicState;
+        pipelineInfo.layout = filter->pipelineLayout;
+        pipelineInfo.renderPass = renderPass;
+        ok = check(vkCreateGraphicsPipelines(bench.device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr,
+                                             &filter->pipeline), "vkCreateGraphicsPipelines");
+    }
+
+    if (vertexModule != VK_NULL_HANDLE) vkDestroyShaderModule(bench.device, vertexModule, nullptr);
+    if (fragmentModule != VK_NULL_HANDLE) vkDestroyShaderModule(bench.device, fragmentModule, nullptr);
+    return ok;
+}
+
+bool createAffineFilter(const BenchDevice& bench, const Options& options, VkRenderPass renderPass,
+                        VkImageView inputView, VkSampler sampler, BenchFilter* filter) {
+    filter->name = "affine";
+    filter->samplesInput = true;
+    filter->pushConstantStages = VK_SHADER_STAGE_VERTEX_BIT;
+    filter->pushConstantSize = 2 * 16 * sizeof(float);  // tex_matrix + user_matrix
+
+    VkDescriptorSetLayoutBinding binding{};
+    binding.binding = 0;
+    binding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    binding.descriptorCount = 1;
+    binding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+    VkDescriptorSetLayoutCreateInfo setLayoutInfo{};
+    setLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    setLayoutInfo.bindingCount = 1;
+    setLayoutInfo.pBindings = &binding;
+    if (!check(vkCreateDescriptorSetLayout(bench.device, &setLayoutInfo, nullptr, &filter->setLayout),
+               "vkCreateDescriptorSetLayout")) {
+        return false;
+    }
+
+    VkDescriptorPoolSize poolSize{VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1};
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.maxSets = 1;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &poolSize;
+    if (!check(vkCreateDescriptorPool(bench.device, &poolInfo, nullptr, &filter->descriptorPool),
+               "vkCreateDescriptorPool")) {
+        return false;
+    }
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = filter->descriptorPool;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &filter->setLayout;
+    if (!check(vkAllocateDescriptorSets(bench.device, &allocInfo, &filter->descriptorSet),
+               "vkAllocateDescriptorSets")) {
+        return false;
+    }
+    VkDescriptorImageInfo imageInfo{sampler, inputView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+    VkWriteDescriptorSet write{};
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = filter->descriptorSet;
+    write.descriptorCount = 1;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    write.pImageInfo = &imageInfo;
+    vkUpdateDescriptorSets(bench.device, 1, &write, 0, nullptr);
+
+    return createPipeline(bench, options, renderPass, "affine", filter);
+}
+
+bool createProceduralFilter(const BenchDevice& bench, const Options& options, VkRenderPass renderPass,
+                            BenchFilter* filter) {
+    filter->name = "procedural";
+    filter->pushConstantStages = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+    filter->pushConstantSize = 4 * sizeof(float);  // iResolution, iTime, _padding
+    return createPipeline(bench, options, renderPass, "b", filter);
+}
+
+void destroyFilter(const BenchDevice& bench, BenchFilter* filter) {
+    if (filter->pipeline != VK_NULL_HANDLE) vkDestroyPipeline(bench.device, filter->pipeline, nullptr);
+    if (filter->pipelineLayout != VK_NULL_HANDLE) vkDestroyPipelineLayout(bench.device, filter->pipelineLayout, nullptr);
+    if (filter->descriptorPool != VK_NULL_HANDLE) vkDestroyDescriptorPool(bench.device, filter->descriptorPool, nullptr);
+    if (filter->setLayout != VK_NULL_HANDLE) vkDestroyDescriptorSetLayout(bench.device, filter->setLayout, nullptr);
+    *filter = BenchFilter{};
+}
+
+void pushFilterConstants(VkCommandBuffer commandBuffer, const BenchFilter& filter, Resolution size, uint32_t frame) {
+    if (filter.samplesInput) {
+        // 恒等 tex_matrix / user_matrix：与 AffineVulkanFilter 没有设置变换时相同
+        float matrices[32] = {};
+        for (int i = 0; i < 4; i++) {
+            matrices[i * 5] = 1.0f;
+            matrices[16 + i * 5] = 1.0f;
+        }
+        vkCmdPushConstants(commandBuffer, filter.pipelineLayout, filter.pushConstantStages, 0,
+                           sizeof(matrices), matrices);
+    } else {
+        const float constants[4] = {static_cast<float>(size.width), static_cast<float>(size.height),
+                                    static_cast<float>(frame) / 60.0f, 0.0f};
+        vkCmdPushConstants(commandBuffer, filter.pipelineLayout, filter.pushConstantStages, 0,
+                           sizeof(constants), constants);
+    }
+}
+
+// ============================================
+// Runs
+// ============================================
+struct Distribution {
+    double avg = 0.0;
+    double p50 = 0.0;
+    double p99 = 0.0;
+    double max = 0.0;
+};
+
+struct RunResult {
+    std::string filter;
+    Resolution resolution;
+    uint32_t framesInFlight = 0;
+    uint32_t frames = 0;
+    double seconds = 0.0;
+    double fps = 0.0;
+    Distribution cpuMs;
+    bool hasGpu = false;
+    Distribution gpuMs;
+};
+
+Distribution summarize(std::vector<double> samples) {
+    Distribution distribution;
+    if (samples.empty()) return distribution;
+    std::sort(samples.begin(), samples.end());
+    double sum = 0.0;
+    for (double sample : samples) sum += sample;
+    distribution.avg = sum / static_cast<double>(samples.size());
+    distribution.p50 = samples[(samples.size() - 1) / 2];
+    distribution.p99 = samples[std::min(samples.size() - 1, samples.size() * 99 / 100)];
+    distribution.max = samples.back();
+    return distribution;
+}
+
+double elapsedMs(std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end) {
+    return std::chrono::duration<double, std::milli>(end - begin).count();
+}
+
+// 每个在飞帧一套资源：输出图像 + framebuffer、命令缓冲、fence，timestamp 查询 [slot * 2, slot * 2 + 1]
+struct FrameSlot {
+    BenchImage target;
+    VkFramebuffer framebuffer = VK_NULL_HANDLE;
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+    VkFence fence = VK_NULL_HANDLE;
+    bool submitted = false;
+    bool timed = false;  // 提交的是计时帧，读取它的 GPU 时间
+};
+
+bool runFilter(const BenchDevice& bench, const Options& options, VkRenderPass renderPass,
+               const BenchFilter& filter, Resolution size, uint32_t framesInFlight, RunResult* result) {
+    const bool timestamps = bench.timestampValidBits > 0;
+    const uint64_t timestampMask = bench.timestampValidBits >= 64
+                                   ? UINT64_MAX : (uint64_t{1} << bench.timestampValidBits) - 1;
+    std::vector<FrameSlot> slots(framesInFlight);
+    VkQueryPool queryPool = VK_NULL_HANDLE;
+
+    bool ok = true;
+    for (FrameSlot& slot : slots) {
+        ok = ok && createImage(bench, size, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT, &slot.target);
+        if (!ok) break;
+
+        VkFramebufferCreateInfo framebufferInfo{};
+        framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+        framebufferInfo.renderPass = renderPass;
+        framebufferInfo.attachmentCount = 1;
+        framebufferInfo.pAttachments = &slot.target.view;
+        framebufferInfo.width = size.width;
+        framebufferInfo.height = size.height;
+        framebufferInfo.layers = 1;
+        ok = check(vkCreateFramebuffer(bench.device, &framebufferInfo, nullptr, &slot.framebuffer),
+                   "vkCreateFramebuffer");
+
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.commandPool = bench.commandPool;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandBufferCount = 1;
+        ok = ok && check(vkAllocateCommandBuffers(bench.device, &allocInfo, &slot.commandBuffer),
+                         "vkAllocateCommandBuffers");
+
+        VkFenceCreateInfo fenceInfo{};
+        fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+        ok = ok && check(vkCreateFence(bench.device, &fenceInfo, nullptr, &slot.fence), "vkCreateFence");
+    }
+    if (ok && timestamps) {
+        VkQueryPoolCreateInfo queryInfo{};
+        queryInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        queryInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        queryInfo.queryCount = framesInFlight * 2;
+        ok = check(vkCreateQueryPool(bench.device, &queryInfo, nullptr, &queryPool), "vkCreateQueryPool");
+    }
+
+    std::vector<double> cpuSamples;
+    std::vector<double> gpuSamples;
+    cpuSamples.reserve(options.frames);
+    gpuSamples.reserve(options.frames);
+    const double msPerTick = static_cast<double>(bench.properties.limits.timestampPeriod) / 1e6;
+
+    // fence 已等待过：查询结果一定可用
+    auto collectGpuTime = [&](uint32_t index) {
+        FrameSlot& slot = slots[index];
+        if (!timestamps || !slot.timed) return;
+        uint64_t ticks[2] = {};
+        if (vkGetQueryPoolResults(bench.device, queryPool, index * 2, 2, sizeof(ticks), ticks, sizeof(uint64_t),
+                                  VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT) == VK_SUCCESS) {
+            const uint64_t delta = ((ticks[1] & timestampMask) - (ticks[0] & timestampMask)) & timestampMask;
+            gpuSamples.push_back(static_cast<double>(delta) * msPerTick);
+        }
+        slot.timed = false;
+    };
+
+    const uint32_t totalFrames = options.warmup + options.frames;
+    std::chrono::steady_clock::time_point timedStart;
+    for (uint32_t frame = 0; ok && frame < totalFrames; frame++) {
+        const uint32_t index = frame % framesInFlight;
+        FrameSlot& slot = slots[index];
+        const bool timed = frame >= options.warmup;
+        if (frame == options.warmup) {
+            timedStart = std::chrono::steady_clock::now();
+        }
+
+        // 与 VulkanRunner 相同：先等这个槽位上一次提交完成
+        if (slot.submitted) {
+            ok = check(vkWaitForFences(bench.device, 1, &slot.fence, VK_TRUE, UINT64_MAX), "vkWaitForFences");
+            collectGpuTime(index);
+            vkResetFences(bench.device, 1, &slot.fence);
+            slot.submitted = false;
+        }
+        if (!ok) break;
+
+        const auto recordStart = std::chrono::steady_clock::now();
+        VkCommandBuffer commandBuffer = slot.commandBuffer;
+        vkResetCommandBuffer(commandBuffer, 0);
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        vkBeginCommandBuffer(commandBuffer, &beginInfo);
+        if (timestamps) {
+            vkCmdResetQueryPool(commandBuffer, queryPool, index * 2, 2);
+            vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, queryPool, index * 2);
+        }
+
+        VkRenderPassBeginInfo passInfo{};
+        passInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+        passInfo.renderPass = renderPass;
+        passInfo.framebuffer = slot.framebuffer;
+        passInfo.renderArea.extent = {size.width, size.height};
+        vkCmdBeginRenderPass(commandBuffer, &passInfo, VK_SUBPASS_CONTENTS_INLINE);
+        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, filter.pipeline);
+        const VkViewport viewport{0.0f, 0.0f, static_cast<float>(size.width), static_cast<float>(size.height),
+                                  0.0f, 1.0f};
+        const VkRect2D scissor{{0, 0}, {size.width, size.height}};
+        vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+        vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+        if (filter.descriptorSet != VK_NULL_HANDLE) {
+            vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, filter.pipelineLayout,
+                                    0, 1, &filter.descriptorSet, 0, nullptr);
+        }
+        pushFilterConstants(commandBuffer, filter, size, frame);
+        vkCmdDraw(commandBuffer, 3, 1, 0, 0);
+        vkCmdEndRenderPass(commandBuffer);
+
+        if (timestamps) {
+            vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, queryPool, index * 2 + 1);
+        }
+        vkEndCommandBuffer(commandBuffer);
+
+        VkSubmitInfo submitInfo{};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &commandBuffer;
+        ok = check(vkQueueSubmit(bench.queue, 1, &submitInfo, slot.fence), "vkQueueSubmit");
+        const auto recordEnd = std::chrono::steady_clock::now();
+
+        slot.submitted = ok;
+        slot.timed = timed;
+        if (timed) {
+            cpuSamples.push_back(elapsedMs(recordStart, recordEnd));
+        }
+    }
+
+    if (ok) {
+        vkQueueWaitIdle(bench.queue);
+        const auto timedEnd = std::chrono::steady_clock::now();
+        for (uint32_t index = 0; index < framesInFlight; index++) {
+            if (slots[index].submitted) collectGpuTime(index);
+        }
+
+        result->filter = filter.name;
+        result->resolution = size;
+        result->framesInFlight = framesInFlight;
+        result->frames = options.frames;
+        result->seconds = elapsedMs(timedStart, timedEnd) / 1000.0;
+        result->fps = result->seconds > 0.0 ? options.frames / result->seconds : 0.0;
+        result->cpuMs = summarize(cpuSamples);
+        result->hasGpu = !gpuSamples.empty();
+        result->gpuMs = summarize(gpuSamples);
+    } else {
+        vkDeviceWaitIdle(bench.device);
+    }
+
+    if (queryPool != VK_NULL_HANDLE) vkDestroyQueryPool(bench.device, queryPool, nullptr);
+    for (FrameSlot& slot : slots) {
+        if (slot.fence != VK_NULL_HANDLE) vkDestroyFence(bench.device, slot.fence, nullptr);
+        if (slot.commandBuffer != VK_NULL_HANDLE) {
+            vkFreeCommandBuffers(bench.device, bench.commandPool, 1, &slot.commandBuffer);
+        }
+        if (slot.framebuffer != VK_NULL_HANDLE) vkDestroyFramebuffer(bench.device, slot.framebuffer, nullptr);
+        destroyImage(bench, &slot.target);
+    }
+    return ok;
+}
+
+// 输出图像每帧整体覆盖：不读旧内容，结束时保持 COLOR_ATTACHMENT_OPTIMAL
+bool createRenderPass(const BenchDevice& bench, VkRenderPass* renderPass) {
+    VkAttachmentDescription attachment{};
+    attachment.format = kColorFormat;
+    attachment.samples = VK_SAMPLE_COUNT_1_BIT;
+    attachment.loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    attachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    attachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    attachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    attachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    attachment.finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+    VkAttachmentReference colorRef{0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+    VkSubpassDescription subpass{};
+    subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpass.colorAttachmentCount = 1;
+    subpass.pColorAttachments = &colorRef;
+
+    VkSubpassDependency dependency{};
+    dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
+    dependency.dstSubpass = 0;
+    dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+
+    VkRenderPassCreateInfo renderPassInfo{};
+    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+    renderPassInfo.attachmentCount = 1;
+    renderPassInfo.pAttachments = &attachment;
+    renderPassInfo.subpassCount = 1;
+    renderPassInfo.pSubpasses = &subpass;
+    renderPassInfo.dependencyCount = 1;
+    renderPassInfo.pDependencies = &dependency;
+    return check(vkCreateRenderPass(bench.device, &renderPassInfo, nullptr, renderPass), "vkCreateRenderPass");
+}
+
+// ============================================
+// JSON
+// ============================================
+std::string jsonString(const std::string& value) {
+    std::string escaped = "\"";
+    for (char c : value) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+            escaped += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char buffer[8];
+            std::snprintf(buffer, sizeof(buffer), "\\u%04x", static_cast<unsigned>(c));
+            escaped += buffer;
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped + "\"";
+}
+
+std::string jsonDistribution(const Distribution& distribution) {
+    char buffer[160];
+    std::snprintf(buffer, sizeof(buffer), "{\"avg\": %.4f, \"p50\": %.4f, \"p99\": %.4f, \"max\": %.4f}",
+                  distribution.avg, distribution.p50, distribution.p99, distribution.max);
+    return buffer;
+}
+
+std::string toJson(const BenchDevice& bench, const Options& options, const std::vector<RunResult>& results) {
+    const uint32_t api = bench.properties.apiVersion;
+    char header[512];
+    std::snprintf(header, sizeof(header),
+                  "{\n"
+                  "  \"device\": %s,\n"
+                  "  \"apiVersion\": \"%u.%u.%u\",\n"
+                  "  \"driverVersion\": %u,\n"
+                  "  \"timestamps\": %s,\n",
+                  jsonString(bench.properties.deviceName).c_str(),
+                  VK_VERSION_MAJOR(api), VK_VERSION_MINOR(api), VK_VERSION_PATCH(api),
+                  bench.properties.driverVersion, bench.timestampValidBits > 0 ? "true" : "false");
+    std::string json = header;
+    // 结果取决于用的是哪一份 SPIR-V（构建目录里 glslc 的输出，还是 --shader-dir 指定的其他目录）
+    json += "  \"shaderDir\": " + jsonString(options.shaderDir) + ",\n";
+    std::snprintf(header, sizeof(header),
+                  "  \"warmupFrames\": %u,\n"
+                  "  \"input\": {\"width\": %u, \"height\": %u},\n"
+                  "  \"results\": [",
+                  options.warmup, options.input.width, options.input.height);
+    json += header;
+
+    for (size_t i = 0; i < results.size(); i++) {
+        const RunResult& result = results[i];
+        char line[256];
+        std::snprintf(line, sizeof(line),
+                      "%s\n    {\"filter\": %s, \"width\": %u, \"height\": %u, \"framesInFlight\": %u, "
+                      "\"frames\": %u, \"seconds\": %.4f, \"fps\": %.2f, ",
+                      i == 0 ? "" : ",", jsonString(result.filter).c_str(),
+                      result.resolution.width, result.resolution.height, result.framesInFlight,
+                      result.frames, result.seconds, result.fps);
+        json += line;
+        json += "\"cpuMsPerFrame\": " + jsonDistribution(result.cpuMs) + ", ";
+        json += "\"gpuMsPerFrame\": " + (result.hasGpu ? jsonDistribution(result.gpuMs) : std::string("null")) + "}";
+    }
+    json += "\n  ]\n}\n";
+    return json;
+}
+
+} // namespace
+
+// ============================================
+// Main
+// ============================================
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, &options)) {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    BenchDevice bench;
+    VkRenderPass renderPass = VK_NULL_HANDLE;
+    VkSampler sampler = VK_NULL_HANDLE;
+    BenchImage input;
+    std::vector<RunResult> results;
+
+    bool ok = createDevice(options, &bench) && createRenderPass(bench, &renderPass);
+
+    // 与 App 的默认 sampler 相同：双线性、CLAMP_TO_EDGE
+    if (ok) {
+        VkSamplerCreateInfo samplerInfo{};
+        samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+        samplerInfo.magFilter = VK_FILTER_LINEAR;
+        samplerInfo.minFilter = VK_FILTER_LINEAR;
+        samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+        samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        ok = check(vkCreateSampler(bench.device, &samplerInfo, nullptr, &sampler), "vkCreateSampler");
+    }
+
+    for (size_t f = 0; ok && f < options.filters.size(); f++) {
+        BenchFilter filter;
+        if (options.filters[f] == "affine") {
+            ok = (input.image != VK_NULL_HANDLE || createInputTexture(bench, options.input, &input)) &&
+                 createAffineFilter(bench, options, renderPass, input.view, sampler, &filter);
+        } else {
+            ok = createProceduralFilter(bench, options, renderPass, &filter);
+        }
+
+        for (size_t r = 0; ok && r < options.resolutions.size(); r++) {
+            for (size_t i = 0; ok && i < options.framesInFlight.size(); i++) {
+                RunResult result;
+                ok = runFilter(bench, options, renderPass, filter, options.resolutions[r],
+                               options.framesInFlight[i], &result);
+                if (ok) {
+                    std::fprintf(stderr, "%-10s %5ux%-5u fif %u: %8.1f fps, cpu %.3f ms, gpu %s\n",
+                                 result.filter.c_str(), result.resolution.width, result.resolution.height,
+                                 result.framesInFlight, result.fps, result.cpuMs.avg,
+                                 result.hasGpu ? (std::to_string(result.gpuMs.avg) + " ms").c_str() : "n/a");
+                    results.push_back(result);
+                }
+            }
+        }
+        destroyFilter(bench, &filter);
+    }
+
+    if (ok) {
+        const std::string json = toJson(bench, options, results);
+        if (options.output.empty()) {
+            std::fputs(json.c_str(), stdout);
+        } else {
+            std::ofstream file(options.output);
+            file << json;
+            ok = static_cast<bool>(file);
+            if (!ok) std::fprintf(stderr, "Cannot write %s\n", options.output.c_str());
+        }
+    }
+
+    if (bench.device != VK_NULL_HANDLE) {
+        vkDeviceWaitIdle(bench.device);
+        destroyImage(bench, &input);
+        if (sampler != VK_NULL_HANDLE) vkDestroySampler(bench.device, sampler, nullptr);
+        if (renderPass != VK_NULL_HANDLE) vkDestroyRenderPass(bench.device, renderPass, nullptr);
+    }
+    destroyDevice(&bench);
+    return ok ? 0 : 1;
+}
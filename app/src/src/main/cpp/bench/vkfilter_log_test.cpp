@@ -0,0 +1,143 @@
+//
+// Host test for the native logger (Vulkanlog.h): rate limiting, drop accounting, synchronous ERROR.
+//
+// 不依赖测试框架：失败时打印原因并返回非 0，由 ctest 运行：
+//   cmake -S app/src/src/main/cpp -B build-bench && cmake --build build-bench && ctest --test-dir build-bench
+// 参数是日志文件的路径前缀（默认当前目录），每个用例写自己的文件。
+//
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include "Vulkanlog.h"
+
+namespace {
+
+int failures = 0;
+
+#define EXPECT(condition, ...)                                             \
+    do {                                                                   \
+        if (!(condition)) {                                                \
+            fprintf(stderr, "FAILED %s:%d: ", __FILE__, __LINE__);         \
+            fprintf(stderr, __VA_ARGS__);                                  \
+            fputc('\n', stderr);                                           \
+            failures++;                                                    \
+        }                                                                  \
+    } while (0)
+
+std::string readFile(const std::string& path) {
+    std::ifstream in(path);
+    std::stringstream text;
+    text << in.rdbuf();
+    return text.str();
+}
+
+size_t countLines(const std::string& text, const std::string& needle) {
+    size_t count = 0;
+    for (size_t pos = text.find(needle); pos != std::string::npos; pos = text.find(needle, pos + 1)) count++;
+    return count;
+}
+
+// setLogFile 是追加写入，每个用例从空文件开始
+bool openLog(const std::string& path) {
+    std::remove(path.c_str());
+    if (!setLogFile(path.c_str())) {
+        fprintf(stderr, "Cannot open %s\n", path.c_str());
+        failures++;
+        return false;
+    }
+    return true;
+}
+
+// ============================================
+// 限流
+// ============================================
+// 同一个调用点：一个窗口内放行 kLogBurstPerSite 条，下一个窗口的第一条带上被丢弃的条数
+void testRateLimit(const std::string& path) {
+    if (!openLog(path)) return;
+    constexpr uint32_t kMessages = 100;
+    auto emit = [](uint32_t i) { VLOGI("RateTest", "burst message %u", i); };
+
+    for (uint32_t i = 0; i < kMessages; i++) emit(i);
+    flushLog();
+    size_t written = countLines(readFile(path), "I/RateTest: burst message ");
+    EXPECT(written == kLogBurstPerSite, "rate limit passed %zu messages, expected %u", written, kLogBurstPerSite);
+
+    // 窗口 1 秒（粗粒度时钟），等它过期
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+    emit(kMessages);
+    flushLog();
+    const std::string text = readFile(path);
+    const std::string expected = "burst message " + std::to_string(kMessages) + " (" +
+                                 std::to_string(kMessages - kLogBurstPerSite) + " similar messages suppressed)";
+    EXPECT(text.find(expected) != std::string::npos, "missing \"%s\"", expected.c_str());
+}
+
+// ============================================
+// 缓冲满
+// ============================================
+// 每条一个调用点（绕开限流），一次写 4 个缓冲容量：写出的 + 丢弃的 = 提交的，
+// 丢弃的条数全部以汇总行报告
+void testDropCount(const std::string& path) {
+    if (!openLog(path)) return;
+    constexpr uint32_t kRecords = kLogRingRecords * 4;
+    static LogSite sites[kRecords];
+
+    const uint64_t droppedBefore = droppedLogRecords();
+    for (uint32_t i = 0; i < kRecords; i++) {
+        logMessage(&sites[i], VULKAN_LOG_LEVEL_INFO, "DropTest", "drop message %u", i);
+    }
+    flushLog();
+    const uint64_t dropped = droppedLogRecords() - droppedBefore;
+
+    const std::string text = readFile(path);
+    const size_t written = countLines(text, "I/DropTest: drop message ");
+    EXPECT(written + dropped == kRecords, "written %zu + dropped %llu != %u",
+           written, static_cast<unsigned long long>(dropped), kRecords);
+
+    uint64_t reported = 0;
+    std::istringstream lines(text);
+    for (std::string line; std::getline(lines, line);) {
+        const size_t pos = line.find("W/VulkanLog: ");
+        if (pos != std::string::npos && line.find(" log records dropped") != std::string::npos) {
+            reported += std::strtoull(line.c_str() + pos + 13, nullptr, 10);
+        }
+    }
+    EXPECT(reported == dropped, "reported %llu dropped records, counted %llu",
+           static_cast<unsigned long long>(reported), static_cast<unsigned long long>(dropped));
+    printf("drop test: %zu written, %llu dropped\n", written, static_cast<unsigned long long>(dropped));
+}
+
+// ============================================
+// ERROR 同步写出
+// ============================================
+// 不调用 flushLog：错误和它之前缓冲的日志在 VLOGE 返回前已经写进文件
+void testErrorIsSynchronous(const std::string& path) {
+    if (!openLog(path)) return;
+    VLOGI("ErrorTest", "info before error");
+    VLOGE("ErrorTest", "error %s", "written");
+
+    const std::string text = readFile(path);
+    EXPECT(text.find("I/ErrorTest: info before error") != std::string::npos, "buffered INFO not written before ERROR");
+    EXPECT(text.find("E/ErrorTest: error written") != std::string::npos, "ERROR not written synchronously");
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    const std::string prefix = argc > 1 ? argv[1] : "vkfilter_log_test";
+    testRateLimit(prefix + "_rate.log");
+    testDropCount(prefix + "_drop.log");
+    testErrorIsSynchronous(prefix + "_error.log");
+    setLogFile(nullptr);
+
+    if (failures > 0) {
+        fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("All log tests passed\n");
+    return 0;
+}
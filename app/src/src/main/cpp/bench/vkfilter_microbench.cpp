@@ -0,0 +1,456 @@
+//
+// CPU microbenchmarks for the native hot paths (Google Benchmark), runnable on desktop Linux.
+//
+// vkfilter_bench 测的是整帧吞吐量，GPU 时间会盖住 CPU 侧的小开销。这里把每帧都会走的 CPU 路径单独拿出来，
+// 每组都是「当前实现」对比「计划替换的实现」，改动前后各跑一次比较 JSON 基线：
+// - StagingFill：nativeUpdateInputTextureColor 按字节写 staging buffer，对比按 uint32 打包填充；
+// - FormatConvert：RGBA → BGRA 逐字节交换，对比按字交换，memcpy 作为带宽上限；
+// - PushConstants：AffineVulkanFilter 每帧分配 FloatArray(32)、to4x4() 再分配一次、
+//   JNI GetFloatArrayElements 复制一次，对比直接写进栈上 128 字节的结构体；
+// - HandleDecode：fromHandle 的 reinterpret_cast + 空指针检查，对比带代数校验的句柄表查找；
+// - StatsAggregate：GPU profiler 的 computeStats（复制 256 帧窗口、排序、取 p99），
+//   对比 FrameHistogram（Vulkanhistogram.h）O(1) 记录 + 按桶取分位数；
+// - Log：VLOGx（Vulkanlog.h）在调用线程上的单次开销：放行入队、被限流、编译期裁剪；
+// - TraceScope：关闭时（默认）的开销，要求 < 100 ns，对比记录中的开销（Vulkantrace.h）。
+// JNI 和 Kotlin 这一侧的分配、复制在这里用等价的 C++ 代码模拟（不包括 GC 开销），只依赖
+// Vulkanhistogram.cpp、Vulkanlog.cpp 和 Vulkantrace.cpp，不需要 Vulkan 或 NDK。
+//
+// 构建和运行（需要 Google Benchmark，例如 libbenchmark-dev）：
+//   cmake -S app/src/src/main/cpp -B build-bench && cmake --build build-bench
+//   cmake --build build-bench --target microbench_baseline   # 写 build-bench/bench/microbench_baseline.json
+// 也可以直接运行 ./build-bench/bench/vkfilter_microbench --benchmark_filter=StagingFill 等。
+//
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+#include "Vulkanhistogram.h"
+#include "Vulkanlog.h"
+#include "Vulkantrace.h"
+
+namespace {
+
+// 720p / 1080p / 4K
+void resolutionArgs(benchmark::internal::Benchmark* bench) {
+    bench->Args({1280, 720})->Args({1920, 1080})->Args({3840, 2160});
+}
+
+// ============================================
+// Staging fill
+// ============================================
+// 当前实现：与 nativeUpdateInputTextureColor 相同的逐像素逐字节写入
+void BM_StagingFill_PerByte(benchmark::State& state) {
+    const auto width = static_cast<uint32_t>(state.range(0));
+    const auto height = static_cast<uint32_t>(state.range(1));
+    std::vector<uint8_t> staging(static_cast<size_t>(width) * height * 4);
+    const int r = 32, g = 64, b = 128, a = 255;
+
+    for (auto _ : state) {
+        uint8_t* pixels = staging.data();
+        for (uint32_t i = 0; i < width * height; i++) {
+            pixels[i * 4 + 0] = static_cast<uint8_t>(r);
+            pixels[i * 4 + 1] = static_cast<uint8_t>(g);
+            pixels[i * 4 + 2] = static_cast<uint8_t>(b);
+            pixels[i * 4 + 3] = static_cast<uint8_t>(a);
+        }
+        benchmark::DoNotOptimize(pixels);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(staging.size()));
+}
+
+// 计划实现：按内存字节序打包成一个 uint32，再整体填充
+void BM_StagingFill_Packed(benchmark::State& state) {
+    const auto width = static_cast<uint32_t>(state.range(0));
+    const auto height = static_cast<uint32_t>(state.range(1));
+    const size_t pixelCount = static_cast<size_t>(width) * height;
+    std::vector<uint8_t> staging(pixelCount * 4);
+    const uint8_t rgba[4] = {32, 64, 128, 255};
+    uint32_t packed;
+    std::memcpy(&packed, rgba, sizeof(packed));
+
+    for (auto _ : state) {
+        // staging 内存按 4 字节对齐（vkMapMemory 的结果至少按 minMemoryMapAlignment 对齐）
+        auto* pixels = reinterpret_cast<uint32_t*>(staging.data());
+        std::fill_n(pixels, pixelCount, packed);
+        benchmark::DoNotOptimize(pixels);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(staging.size()));
+}
+
+BENCHMARK(BM_StagingFill_PerByte)->Apply(resolutionArgs);
+BENCHMARK(BM_StagingFill_Packed)->Apply(resolutionArgs);
+
+// ============================================
+// Format conversion
+// ============================================
+struct ConvertBuffers {
+    std::vector<uint8_t> src;
+    std::vector<uint8_t> dst;
+
+    explicit ConvertBuffers(const benchmark::State& state) {
+        const size_t size = static_cast<size_t>(state.range(0)) * static_cast<size_t>(state.range(1)) * 4;
+        src.resize(size);
+        dst.resize(size);
+        std::mt19937 rng(1);
+        for (auto& byte : src) byte = static_cast<uint8_t>(rng());
+    }
+};
+
+// 带宽上限：不做转换，只复制
+void BM_FormatConvert_Memcpy(benchmark::State& state) {
+    ConvertBuffers buffers(state);
+    for (auto _ : state) {
+        std::memcpy(buffers.dst.data(), buffers.src.data(), buffers.src.size());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(buffers.src.size()));
+}
+
+// 逐字节交换 R / B
+void BM_FormatConvert_SwizzleBytes(benchmark::State& state) {
+    ConvertBuffers buffers(state);
+    const size_t pixelCount = buffers.src.size() / 4;
+    for (auto _ : state) {
+        const uint8_t* src = buffers.src.data();
+        uint8_t* dst = buffers.dst.data();
+        for (size_t i = 0; i < pixelCount; i++) {
+            dst[i * 4 + 0] = src[i * 4 + 2];
+            dst[i * 4 + 1] = src[i * 4 + 1];
+            dst[i * 4 + 2] = src[i * 4 + 0];
+            dst[i * 4 + 3] = src[i * 4 + 3];
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(buffers.src.size()));
+}
+
+// 按 uint32 交换（小端）：G、A 不动，R、B 互换；编译器可以向量化
+void BM_FormatConvert_SwizzleWords(benchmark::State& state) {
+    ConvertBuffers buffers(state);
+    const size_t pixelCount = buffers.src.size() / 4;
+    for (auto _ : state) {
+        const auto* src = reinterpret_cast<const uint32_t*>(buffers.src.data());
+        auto* dst = reinterpret_cast<uint32_t*>(buffers.dst.data());
+        for (size_t i = 0; i < pixelCount; i++) {
+            const uint32_t p = src[i];
+            dst[i] = (p & 0xFF00FF00u) | ((p >> 16) & 0xFFu) | ((p & 0xFFu) << 16);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(buffers.src.size()));
+}
+
+BENCHMARK(BM_FormatConvert_Memcpy)->Apply(resolutionArgs);
+BENCHMARK(BM_FormatConvert_SwizzleBytes)->Apply(resolutionArgs);
+BENCHMARK(BM_FormatConvert_SwizzleWords)->Apply(resolutionArgs);
+
+// ============================================
+// Push constants
+// ============================================
+// AffineMatrix（Kotlin）的 a..f，列主序 [a c e; b d f]
+struct Affine {
+    double a, b, c, d, e, f;
+};
+
+// AffineMatrix.to4x4(matrix)
+void affineTo4x4(const Affine& m, float* matrix) {
+    matrix[0] = static_cast<float>(m.a);
+    matrix[1] = static_cast<float>(m.b);
+    matrix[2] = 0.0f;
+    matrix[3] = 0.0f;
+    matrix[4] = static_cast<float>(m.c);
+    matrix[5] = static_cast<float>(m.d);
+    matrix[6] = 0.0f;
+    matrix[7] = 0.0f;
+    matrix[8] = 0.0f;
+    matrix[9] = 0.0f;
+    matrix[10] = 1.0f;
+    matrix[11] = 0.0f;
+    matrix[12] = static_cast<float>(m.e);
+    matrix[13] = static_cast<float>(m.f);
+    matrix[14] = 0.0f;
+    matrix[15] = 1.0f;
+}
+
+// 与 affine 着色器的 push constant 布局相同：mat4 tex_matrix + mat4 user_matrix
+struct AffinePushConstants {
+    float texMatrix[16];
+    float userMatrix[16];
+};
+static_assert(sizeof(AffinePushConstants) == 128, "push constant block must be 128 bytes");
+
+// 已经 fromCenter() 合成好的用户变换（旋转 90° 后缩放 0.5）
+constexpr Affine kUserTransform = {0.0, 0.5, -0.5, 0.0, 0.75, 0.25};
+
+// 当前实现：FloatArray(32) + 单位 tex_matrix + to4x4() 新数组 + arraycopy，
+// 然后 nativePushConstants 里 GetFloatArrayElements 再复制一份（ART 对小数组通常复制）
+void BM_PushConstants_FloatArray(benchmark::State& state) {
+    for (auto _ : state) {
+        std::unique_ptr<float[]> pushConstantsData(new float[32]());
+        pushConstantsData[0] = 1.0f;
+        pushConstantsData[5] = 1.0f;
+        pushConstantsData[10] = 1.0f;
+        pushConstantsData[15] = 1.0f;
+
+        std::unique_ptr<float[]> userMatrix(new float[16]());
+        affineTo4x4(kUserTransform, userMatrix.get());
+        std::memcpy(pushConstantsData.get() + 16, userMatrix.get(), 16 * sizeof(float));
+
+        std::unique_ptr<float[]> elements(new float[32]);
+        std::memcpy(elements.get(), pushConstantsData.get(), 32 * sizeof(float));
+        benchmark::DoNotOptimize(elements.get());
+        benchmark::ClobberMemory();
+    }
+}
+
+// 计划实现：native 侧直接写栈上的结构体，交给 vkCmdPushConstants
+void BM_PushConstants_Packed(benchmark::State& state) {
+    for (auto _ : state) {
+        AffinePushConstants constants{};
+        constants.texMatrix[0] = 1.0f;
+        constants.texMatrix[5] = 1.0f;
+        constants.texMatrix[10] = 1.0f;
+        constants.texMatrix[15] = 1.0f;
+        affineTo4x4(kUserTransform, constants.userMatrix);
+        benchmark::DoNotOptimize(&constants);
+        benchmark::ClobberMemory();
+    }
+}
+
+BENCHMARK(BM_PushConstants_FloatArray);
+BENCHMARK(BM_PushConstants_Packed);
+
+// ============================================
+// Handle decode
+// ============================================
+constexpr size_t kHandleObjects = 64;
+constexpr size_t kHandleLookups = 1024;
+
+struct FakeObject {
+    uint64_t payload = 0;
+};
+
+// 每次迭代按随机顺序解码 kHandleLookups 个句柄
+std::vector<uint32_t> lookupOrder() {
+    std::vector<uint32_t> order(kHandleLookups);
+    std::mt19937 rng(2);
+    for (auto& index : order) index = static_cast<uint32_t>(rng() % kHandleObjects);
+    return order;
+}
+
+// 当前实现：VulkanJNI::fromHandle + validateHandle
+void BM_HandleDecode_Cast(benchmark::State& state) {
+    std::vector<FakeObject> objects(kHandleObjects);
+    std::vector<int64_t> handles(kHandleObjects);
+    for (size_t i = 0; i < kHandleObjects; i++) {
+        objects[i].payload = i;
+        handles[i] = static_cast<int64_t>(reinterpret_cast<uintptr_t>(&objects[i]));
+    }
+    const std::vector<uint32_t> order = lookupOrder();
+
+    for (auto _ : state) {
+        uint64_t sum = 0;
+        for (uint32_t index : order) {
+            auto* object = reinterpret_cast<FakeObject*>(static_cast<uintptr_t>(handles[index]));
+            if (object == nullptr) continue;
+            sum += object->payload;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(kHandleLookups));
+}
+
+// 计划实现：句柄 = (代数 << 32) | 槽位；槽位越界或代数不符（对象已销毁）时返回空，而不是访问野指针
+class HandleTable {
+public:
+    int64_t insert(FakeObject* object) {
+        slots_.push_back({object, 1});
+        return encode(static_cast<uint32_t>(slots_.size() - 1), 1);
+    }
+
+    FakeObject* lookup(int64_t handle) const {
+        const auto bits = static_cast<uint64_t>(handle);
+        const auto index = static_cast<uint32_t>(bits);
+        const auto generation = static_cast<uint32_t>(bits >> 32);
+        if (index >= slots_.size()) return nullptr;
+        const Slot& slot = slots_[index];
+        return slot.generation == generation ? slot.object : nullptr;
+    }
+
+private:
+    struct Slot {
+        FakeObject* object;
+        uint32_t generation;
+    };
+
+    static int64_t encode(uint32_t index, uint32_t generation) {
+        return static_cast<int64_t>((static_cast<uint64_t>(generation) << 32) | index);
+    }
+
+    std::vector<Slot> slots_;
+};
+
+void BM_HandleDecode_Table(benchmark::State& state) {
+    std::vector<FakeObject> objects(kHandleObjects);
+    std::vector<int64_t> handles(kHandleObjects);
+    HandleTable table;
+    for (size_t i = 0; i < kHandleObjects; i++) {
+        objects[i].payload = i;
+        handles[i] = table.insert(&objects[i]);
+    }
+    const std::vector<uint32_t> order = lookupOrder();
+
+    for (auto _ : state) {
+        uint64_t sum = 0;
+        for (uint32_t index : order) {
+            FakeObject* object = table.lookup(handles[index]);
+            if (object == nullptr) continue;
+            sum += object->payload;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(kHandleLookups));
+}
+
+BENCHMARK(BM_HandleDecode_Cast);
+BENCHMARK(BM_HandleDecode_Table);
+
+// ============================================
+// Stats aggregation
+// ============================================
+constexpr uint32_t kStatsWindow = 256;  // 与 kGpuProfilerWindow 相同
+
+// 帧时间样本（毫秒），大致是 60 fps 加少量长尾
+std::vector<float> frameSamples(size_t count) {
+    std::vector<float> samples(count);
+    std::mt19937 rng(3);
+    std::lognormal_distribution<float> dist(std::log(16.0f), 0.2f);
+    for (auto& sample : samples) sample = dist(rng);
+    return samples;
+}
+
+// 当前实现：与 Vulkanprofiler.cpp 的 computeStats 相同，每次报告复制整个窗口再排序
+void BM_StatsAggregate_SortWindow(benchmark::State& state) {
+    const std::vector<float> window = frameSamples(kStatsWindow);
+    for (auto _ : state) {
+        std::vector<float> sorted(window.begin(), window.end());
+        std::sort(sorted.begin(), sorted.end());
+        double sum = 0.0;
+        for (float sample : sorted) sum += sample;
+        const auto p99Index = static_cast<size_t>(std::ceil(0.99 * kStatsWindow)) - 1;
+        const float p99 = sorted[std::min(p99Index, sorted.size() - 1)];
+        benchmark::DoNotOptimize(sum);
+        benchmark::DoNotOptimize(p99);
+        benchmark::DoNotOptimize(sorted.front());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * kStatsWindow);
+}
+
+// 计划实现：每帧记录一次（O(1)，不分配）
+void BM_StatsAggregate_HistogramRecord(benchmark::State& state) {
+    std::vector<uint64_t> samplesUs;
+    for (float sample : frameSamples(kStatsWindow)) samplesUs.push_back(static_cast<uint64_t>(sample * 1000.0f));
+    FrameHistogram histogram;
+    for (auto _ : state) {
+        for (uint64_t sample : samplesUs) histogram.record(sample);
+        benchmark::DoNotOptimize(histogram.count());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * kStatsWindow);
+}
+
+// 计划实现：报告时按桶扫描取 p99，不随样本数增长
+void BM_StatsAggregate_HistogramPercentile(benchmark::State& state) {
+    FrameHistogram histogram;
+    for (float sample : frameSamples(kStatsWindow)) histogram.record(static_cast<uint64_t>(sample * 1000.0f));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(histogram.percentile(99.0));
+        benchmark::DoNotOptimize(histogram.mean());
+    }
+}
+
+BENCHMARK(BM_StatsAggregate_SortWindow);
+BENCHMARK(BM_StatsAggregate_HistogramRecord);
+BENCHMARK(BM_StatsAggregate_HistogramPercentile);
+
+// ============================================
+// Log
+// ============================================
+// 放行的日志：限流检查 + 写本线程缓冲（记录格式串指针和参数）。每次用新的调用点绕开限流；
+// 缓冲写满时在计时之外排空，测的是入队而不是缓冲满时更短的丢弃路径（dropped 应接近 0）
+void BM_Log_Enqueue(benchmark::State& state) {
+    setLogFile("/dev/null");
+    const uint64_t droppedBefore = droppedLogRecords();
+    int frame = 0;
+    for (auto _ : state) {
+        LogSite site;
+        logMessage(&site, VULKAN_LOG_LEVEL_INFO, "Bench", "frame %d: %s %.2f ms", frame++, "submit", 1.25);
+        if (frame % kLogRingRecords == 0) {
+            state.PauseTiming();
+            flushLog();
+            state.ResumeTiming();
+        }
+    }
+    flushLog();
+    state.counters["dropped"] = static_cast<double>(droppedLogRecords() - droppedBefore);
+    setLogFile(nullptr);
+}
+
+// 被限流的日志：渲染循环里每帧都打的调用点在第一个窗口放行 kLogBurstPerSite 条之后都走这条路径
+void BM_Log_RateLimited(benchmark::State& state) {
+    setLogFile("/dev/null");
+    static LogSite site;
+    int frame = 0;
+    for (auto _ : state) {
+        logMessage(&site, VULKAN_LOG_LEVEL_INFO, "Bench", "frame %d: %s %.2f ms", frame++, "submit", 1.25);
+    }
+    flushLog();
+    setLogFile(nullptr);
+}
+
+// 低于 VULKAN_LOG_MIN_LEVEL 的级别：VULKAN_LOG_STRIPPED 只保留格式检查，应与空循环相同
+void BM_Log_Stripped(benchmark::State& state) {
+    int frame = 0;
+    for (auto _ : state) {
+        VULKAN_LOG_STRIPPED("frame %d: %s %.2f ms", frame++, "submit", 1.25);
+        benchmark::DoNotOptimize(frame);
+    }
+}
+
+BENCHMARK(BM_Log_Enqueue);
+BENCHMARK(BM_Log_RateLimited);
+BENCHMARK(BM_Log_Stripped);
+
+// ============================================
+// TraceScope
+// ============================================
+// 关闭时：渲染路径上每帧好几个 scope 都走这条路径，只读一次 relaxed 标志，不读时钟
+void BM_TraceScope_Disabled(benchmark::State& state) {
+    stopTrace();
+    for (auto _ : state) {
+        TraceScope scope("bench_scope");
+        benchmark::ClobberMemory();
+    }
+}
+
+// 记录中：两次读时钟 + 写本线程的环形缓冲
+void BM_TraceScope_Enabled(benchmark::State& state) {
+    startTrace();
+    for (auto _ : state) {
+        TraceScope scope("bench_scope");
+        benchmark::ClobberMemory();
+    }
+    stopTrace();
+}
+
+BENCHMARK(BM_TraceScope_Disabled);
+BENCHMARK(BM_TraceScope_Enabled);
+
+} // anonymous namespace
+
+BENCHMARK_MAIN();
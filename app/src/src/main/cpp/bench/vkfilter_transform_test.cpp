@@ -0,0 +1,306 @@
+//
+// Host test for the transform fast paths: transfer classification (Vulkantransferplan.h)
+// and the scaler weight tables (Vulkanscalertable.h).
+//
+// 不依赖测试框架和 Vulkan：失败时打印原因并返回非 0，由 ctest 运行：
+//   cmake -S app/src/src/main/cpp -B build-bench && cmake --build build-bench && ctest --test-dir build-bench
+//
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include "Vulkanscalertable.h"
+#include "Vulkantransferplan.h"
+
+namespace {
+
+int failures = 0;
+
+#define EXPECT(condition, ...)                                             \
+    do {                                                                   \
+        if (!(condition)) {                                                \
+            fprintf(stderr, "FAILED %s:%d: ", __FILE__, __LINE__);         \
+            fprintf(stderr, __VA_ARGS__);                                  \
+            fputc('\n', stderr);                                           \
+            failures++;                                                    \
+        }                                                                  \
+    } while (0)
+
+// ============================================
+// 传输分类
+// ============================================
+// 列主序，输出 uv → 输入 uv：u' = sx * u + tx，v' = sy * v + ty
+struct Matrix {
+    float m[16];
+};
+
+Matrix axisMatrix(float sx, float sy, float tx, float ty) {
+    Matrix matrix{};
+    matrix.m[0] = sx;
+    matrix.m[5] = sy;
+    matrix.m[10] = 1.0f;
+    matrix.m[12] = tx;
+    matrix.m[13] = ty;
+    matrix.m[15] = 1.0f;
+    return matrix;
+}
+
+const char* pathName(TransferPath path) {
+    switch (path) {
+        case TransferPath::Shader: return "Shader";
+        case TransferPath::Copy: return "Copy";
+        case TransferPath::Blit: return "Blit";
+    }
+    return "?";
+}
+
+struct Expected {
+    TransferPath path;
+    TransferPoint srcStart;
+    TransferPoint srcEnd;
+    TransferPoint dstStart;
+    TransferPoint dstEnd;
+    bool covers;
+    bool linear;
+};
+
+bool samePoint(TransferPoint a, TransferPoint b) { return a.x == b.x && a.y == b.y; }
+
+void expectPlan(const char* name, const Matrix& matrix,
+                uint32_t srcWidth, uint32_t srcHeight, uint32_t dstWidth, uint32_t dstHeight,
+                bool sameFormat, const Expected& expected) {
+    const TransferPlan plan = classifyTransfer(matrix.m, srcWidth, srcHeight, dstWidth, dstHeight, sameFormat);
+    EXPECT(plan.path == expected.path, "%s: path %s, expected %s", name, pathName(plan.path), pathName(expected.path));
+    if (plan.path != expected.path || expected.path == TransferPath::Shader) return;
+
+    EXPECT(samePoint(plan.srcStart, expected.srcStart) && samePoint(plan.srcEnd, expected.srcEnd),
+           "%s: source (%d, %d)-(%d, %d), expected (%d, %d)-(%d, %d)", name,
+           plan.srcStart.x, plan.srcStart.y, plan.srcEnd.x, plan.srcEnd.y,
+           expected.srcStart.x, expected.srcStart.y, expected.srcEnd.x, expected.srcEnd.y);
+    EXPECT(samePoint(plan.dstStart, expected.dstStart) && samePoint(plan.dstEnd, expected.dstEnd),
+           "%s: target (%d, %d)-(%d, %d), expected (%d, %d)-(%d, %d)", name,
+           plan.dstStart.x, plan.dstStart.y, plan.dstEnd.x, plan.dstEnd.y,
+           expected.dstStart.x, expected.dstStart.y, expected.dstEnd.x, expected.dstEnd.y);
+    EXPECT(plan.covers == expected.covers, "%s: covers %d, expected %d", name, plan.covers, expected.covers);
+    if (expected.path == TransferPath::Blit) {
+        EXPECT(plan.linear == expected.linear, "%s: linear %d, expected %d", name, plan.linear, expected.linear);
+    }
+}
+
+void expectShader(const char* name, const Matrix& matrix,
+                  uint32_t srcWidth, uint32_t srcHeight, uint32_t dstWidth, uint32_t dstHeight) {
+    expectPlan(name, matrix, srcWidth, srcHeight, dstWidth, dstHeight, true, Expected{TransferPath::Shader});
+}
+
+void testTransferClassification() {
+    constexpr uint32_t W = 1920;
+    constexpr uint32_t H = 1080;
+    constexpr int32_t w = static_cast<int32_t>(W);
+    constexpr int32_t h = static_cast<int32_t>(H);
+
+    // 恒等：格式相同复制，格式不同 1:1 blit
+    expectPlan("identity", axisMatrix(1, 1, 0, 0), W, H, W, H, true,
+               {TransferPath::Copy, {0, 0}, {w, h}, {0, 0}, {w, h}, true, false});
+    expectPlan("identity, format conversion", axisMatrix(1, 1, 0, 0), W, H, W, H, false,
+               {TransferPath::Blit, {0, 0}, {w, h}, {0, 0}, {w, h}, true, false});
+
+    // 翻转：源区域反向，1:1 用 NEAREST
+    expectPlan("hflip", axisMatrix(-1, 1, 1, 0), W, H, W, H, true,
+               {TransferPath::Blit, {w, 0}, {0, h}, {0, 0}, {w, h}, true, false});
+    expectPlan("vflip", axisMatrix(1, -1, 0, 1), W, H, W, H, true,
+               {TransferPath::Blit, {0, h}, {w, 0}, {0, 0}, {w, h}, true, false});
+
+    // 整数裁剪：输出 960x540 取输入中间一块
+    expectPlan("integer crop", axisMatrix(0.5f, 0.5f, 0.25f, 0.25f), W, H, W / 2, H / 2, true,
+               {TransferPath::Copy, {w / 4, h / 4}, {w * 3 / 4, h * 3 / 4}, {0, 0}, {w / 2, h / 2}, true, false});
+
+    // 平移出屏幕一部分：只写读取位置在 [0, 1] 内的区域，其余需要清空
+    expectPlan("crop partly off-screen", axisMatrix(1, 1, -0.25f, 0), W, H, W, H, true,
+               {TransferPath::Copy, {0, 0}, {w * 3 / 4, h}, {w / 4, 0}, {w, h}, false, false});
+    expectShader("crop fully off-screen", axisMatrix(1, 1, 2, 0), W, H, W, H);
+
+    // 2 倍缩放：放大和缩小都是 LINEAR blit
+    expectPlan("2x upscale", axisMatrix(1, 1, 0, 0), W / 2, H / 2, W, H, true,
+               {TransferPath::Blit, {0, 0}, {w / 2, h / 2}, {0, 0}, {w, h}, true, true});
+    expectPlan("2x downscale", axisMatrix(1, 1, 0, 0), W, H, W / 2, H / 2, true,
+               {TransferPath::Blit, {0, 0}, {w, h}, {0, 0}, {w / 2, h / 2}, true, true});
+
+    // 半像素偏移：源边界落在像素中间，blit 表示不了
+    expectShader("half-pixel offset", axisMatrix(1, 1, 0.5f / W, 0), W, H, W, H);
+    // 吸附容差（1/256 像素）以内按整数处理，超出则回到 shader
+    expectPlan("sub-pixel offset within epsilon", axisMatrix(1, 1, (1.0f / 1024) / W, 0), W, H, W, H, true,
+               {TransferPath::Copy, {0, 0}, {w, h}, {0, 0}, {w, h}, true, false});
+    expectShader("sub-pixel offset beyond epsilon", axisMatrix(1, 1, (1.0f / 64) / W, 0), W, H, W, H);
+
+    // 旋转、错切、透视
+    Matrix rotation = axisMatrix(0, 0, 0, 1);
+    rotation.m[1] = -1;  // v' = 1 - u
+    rotation.m[4] = 1;   // u' = v
+    expectShader("rotation 90", rotation, W, H, H, W);
+    Matrix shear = axisMatrix(1, 1, 0, 0);
+    shear.m[4] = 0.1f;
+    expectShader("shear", shear, W, H, W, H);
+    Matrix perspective = axisMatrix(1, 1, 0, 0);
+    perspective.m[3] = 0.1f;
+    expectShader("perspective", perspective, W, H, W, H);
+
+    expectShader("empty source", axisMatrix(1, 1, 0, 0), 0, H, W, H);
+}
+
+// ============================================
+// 缩放权重表
+// ============================================
+const ScalerKernel kKernels[] = {
+    ScalerKernel::Bilinear, ScalerKernel::Bicubic, ScalerKernel::Mitchell,
+    ScalerKernel::Lanczos2, ScalerKernel::Lanczos3,
+};
+
+double kernelSupport(ScalerKernel kernel) {
+    switch (kernel) {
+        case ScalerKernel::Bilinear: return 1.0;
+        case ScalerKernel::Lanczos3: return 3.0;
+        default: return 2.0;
+    }
+}
+
+const float* tableRow(const ScalerTable& table, uint32_t i) {
+    return &table.data[static_cast<size_t>(i) * (table.taps + 1)];
+}
+
+// 读取位置在 [0, 1] 内的行：权重和为 1，taps 覆盖 (x - radius, x + radius) 内的全部源像素，
+// 落在区间外的 tap（taps 向上取整多出的一个）权重为 0；之外的行：权重全为 0
+void expectTable(const char* name, ScalerKernel kernel, uint32_t srcSize, uint32_t dstSize,
+                 float scale, float offset) {
+    const int id = static_cast<int>(kernel);
+    const auto table = buildScalerTable(kernel, srcSize, dstSize, scale, offset);
+    const double factor = std::max(1.0, std::fabs(static_cast<double>(scale)) * srcSize / dstSize);
+    const uint32_t taps = std::min(kScalerMaxTaps,
+                                   static_cast<uint32_t>(std::ceil(2.0 * kernelSupport(kernel) * factor)));
+    EXPECT(table->size == dstSize, "%s (kernel %d): size %u, expected %u", name, id, table->size, dstSize);
+    EXPECT(table->taps == taps, "%s (kernel %d): %u taps, expected %u", name, id, table->taps, taps);
+    EXPECT(table->data.size() == static_cast<size_t>(dstSize) * (taps + 1),
+           "%s (kernel %d): %zu floats", name, id, table->data.size());
+    if (table->size != dstSize || table->taps != taps) return;
+
+    const double radius = taps == kScalerMaxTaps ? kScalerMaxTaps / 2.0 : kernelSupport(kernel) * factor;
+    uint32_t badRows = 0;
+    for (uint32_t i = 0; i < dstSize; ++i) {
+        const float* row = tableRow(*table, i);
+        const double u = scale * (i + 0.5) / dstSize + offset;
+        double sum = 0.0;
+        double magnitude = 0.0;
+        for (uint32_t k = 0; k < taps; ++k) {
+            sum += row[k + 1];
+            magnitude += std::fabs(row[k + 1]);
+        }
+
+        bool ok;
+        if (u < 0.0 || u > 1.0) {
+            ok = magnitude == 0.0;
+        } else {
+            const double x = u * srcSize - 0.5;
+            const double first = row[0];
+            ok = std::fabs(sum - 1.0) < 1e-4 &&
+                 first > x - radius - 1e-6 && first - 1 <= x - radius + 1e-6 &&
+                 first + taps >= x + radius - 1e-6;
+            // 1:1 时区间端点正好是核函数的零点，u 的舍入误差留下 1e-7 量级的权重
+            for (uint32_t k = 0; k < taps; ++k) {
+                ok = ok && (std::fabs(first + k - x) < radius - 1e-6 || std::fabs(row[k + 1]) < 1e-6f);
+            }
+        }
+        if (!ok && badRows++ == 0) {
+            fprintf(stderr, "%s (kernel %d): row %u (u = %f) first %f, sum %f, |w| %f\n",
+                    name, id, i, u, row[0], sum, magnitude);
+        }
+    }
+    EXPECT(badRows == 0, "%s (kernel %d): %u bad rows", name, id, badRows);
+}
+
+void testScalerTables() {
+    for (ScalerKernel kernel : kKernels) {
+        expectTable("1:1", kernel, 1920, 1920, 1, 0);
+        expectTable("2x upscale", kernel, 960, 1920, 1, 0);
+        expectTable("2x downscale", kernel, 1920, 960, 1, 0);
+        expectTable("4.5x downscale", kernel, 1920, 427, 1, 0);
+        expectTable("120x downscale (taps capped)", kernel, 1920, 16, 1, 0);
+        expectTable("flip", kernel, 1920, 960, -1, 1);
+        expectTable("crop", kernel, 1920, 960, 0.5f, 0.25f);
+        expectTable("partly off-screen", kernel, 1920, 1920, 1, -0.25f);
+        expectTable("fully off-screen", kernel, 1920, 1920, 1, 2);
+    }
+
+    // 缩小时核函数按比例展宽：2 倍缩小的 Lanczos3 读 12 个源像素，第 i 列中心 x = 2i + 0.5，
+    // 第一个 tap 是 (x - 6, x + 6) 内最左边的像素 2i - 5
+    const auto lanczos = buildScalerTable(ScalerKernel::Lanczos3, 1920, 960, 1, 0);
+    EXPECT(lanczos->taps == 12, "Lanczos3 2x downscale: %u taps, expected 12", lanczos->taps);
+    EXPECT(tableRow(*lanczos, 0)[0] == -5.0f, "Lanczos3 2x downscale: row 0 starts at %f", tableRow(*lanczos, 0)[0]);
+    EXPECT(tableRow(*lanczos, 100)[0] == 195.0f, "Lanczos3 2x downscale: row 100 starts at %f",
+           tableRow(*lanczos, 100)[0]);
+    // 对称：中心两侧的权重相同
+    const float* center = tableRow(*lanczos, 100);
+    EXPECT(std::fabs(center[1 + 5] - center[1 + 6]) < 1e-6f && std::fabs(center[1] - center[12]) < 1e-6f,
+           "Lanczos3 2x downscale: asymmetric weights");
+
+    // 采样器双线性（不展宽）缩小时仍只读 2 个像素
+    const auto hardware = buildScalerTable(ScalerKernel::Bilinear, 1920, 480, 1, 0, false);
+    EXPECT(hardware->taps == 2, "hardware bilinear: %u taps, expected 2", hardware->taps);
+
+    // 1:1 双线性是恒等映射
+    std::vector<float> src(64);
+    for (size_t i = 0; i < src.size(); ++i) src[i] = static_cast<float>(i * i % 17);
+    std::vector<float> dst(src.size());
+    const auto identity = buildScalerTable(ScalerKernel::Bilinear, 64, 64, 1, 0);
+    applyScalerTable(*identity, src.data(), 64, dst.data());
+    bool same = true;
+    for (size_t i = 0; i < src.size(); ++i) same = same && std::fabs(dst[i] - src[i]) < 1e-5f;
+    EXPECT(same, "bilinear 1:1 does not reproduce the source");
+
+    // 缩小后常数仍是常数（权重归一化）
+    std::fill(src.begin(), src.end(), 0.75f);
+    dst.assign(13, 0.0f);
+    const auto shrink = buildScalerTable(ScalerKernel::Lanczos3, 64, 13, 1, 0);
+    applyScalerTable(*shrink, src.data(), 64, dst.data());
+    same = true;
+    for (float value : dst) same = same && std::fabs(value - 0.75f) < 1e-5f;
+    EXPECT(same, "Lanczos3 downscale does not preserve a constant");
+}
+
+// 缓存只保留最近使用的 kScalerTableCacheSize 张表
+void testScalerTableCache() {
+    const auto first = getScalerTable(ScalerKernel::Lanczos3, 1920, 960, 1, 0);
+    EXPECT(getScalerTable(ScalerKernel::Lanczos3, 1920, 960, 1, 0) == first, "same parameters, different table");
+
+    // 动画：每帧一个新的平移。期间一直使用 first，它不会被淘汰
+    for (int frame = 0; frame < 100; ++frame) {
+        getScalerTable(ScalerKernel::Lanczos3, 1920, 960, 1, frame / 1000.0f);
+        EXPECT(getScalerTable(ScalerKernel::Lanczos3, 1920, 960, 1, 0) == first, "frame %d: recently used table evicted",
+               frame);
+    }
+    EXPECT(getScalerTableCacheSize() == kScalerTableCacheSize, "cache holds %zu tables, expected %zu",
+           getScalerTableCacheSize(), kScalerTableCacheSize);
+
+    // 之后不再使用：被淘汰，但调用方持有的表仍然有效
+    for (uint32_t i = 0; i < kScalerTableCacheSize; ++i) {
+        getScalerTable(ScalerKernel::Bicubic, 1920, 960 + i, 1, 0);
+    }
+    EXPECT(getScalerTableCacheSize() == kScalerTableCacheSize, "cache holds %zu tables, expected %zu",
+           getScalerTableCacheSize(), kScalerTableCacheSize);
+    const auto rebuilt = getScalerTable(ScalerKernel::Lanczos3, 1920, 960, 1, 0);
+    EXPECT(rebuilt != first, "least recently used table not evicted");
+    EXPECT(rebuilt->data == first->data, "rebuilt table differs");
+}
+
+} // anonymous namespace
+
+int main() {
+    testTransferClassification();
+    testScalerTables();
+    testScalerTableCache();
+
+    if (failures > 0) {
+        fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("All transform tests passed\n");
+    return 0;
+}
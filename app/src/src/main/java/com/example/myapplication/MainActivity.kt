@@ -79,8 +79,8 @@ class MainActivity : AppCompatActivity(), SurfaceHolder.Callback {
             val filter = AffineVulkanFilter(this, AffineMatrix.rotate(30.0).fromCenter())
             vulkanFilter = filter
 
-            // 创建 VulkanRunner
-            val runner = VulkanRunner(filter)
+            // 创建 VulkanRunner（滤镜 pipeline 后台编译期间用直通滤镜绘制）
+            val runner = VulkanRunner(filter, cacheDir = cacheDir, placeholder = AffineVulkanFilter(this))
             vulkanRunner = runner
 
             // 启动 runner，获取输入 surface（可能为 null）
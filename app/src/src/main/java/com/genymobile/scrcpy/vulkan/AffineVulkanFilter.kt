@@ -5,6 +5,8 @@ import android.content.Context
 import android.util.Log
 import com.genymobile.scrcpy.util.AffineMatrix
 import java.io.IOException
+import kotlin.math.hypot
+import kotlin.math.max
 
 object AffineShaderLoader {
     @Throws(IOException::class)
@@ -25,6 +27,12 @@ object AffineShaderLoader {
         // 使用支持边界裁剪的片段着色器
         return loadShader(context, "shaders/affine_frag.spv")
     }
+
+    @Throws(IOException::class)
+    fun loadComputeShader(context: Context): ByteArray {
+        // 计算路径：直接写存储图像
+        return loadShader(context, "shaders/affine_comp.spv")
+    }
 }
 
 /**
@@ -52,30 +60,63 @@ object AffineShaderLoader {
  * val transform = AffineMatrix.reframe(0.25, 0.25, 0.5, 0.5)
  * val filter = AffineVulkanFilter(context, transform)
  * ```
+ *
+ * 边界检查是 affine.frag 中的特化常量：默认 [ClipMode.AUTO] 下，
+ * 变换结果不可能超出纹理范围时（恒等、放大裁剪等）使用不带分支的 pipeline 变体。
+ *
+ * runner 开启计算路径时（[enableCompute]）同时编译 affine.comp：按 16x16 工作组把源像素块
+ * 读入共享内存后做双线性插值，直接写输出存储图像，只 dispatch 脏矩形。
+ *
+ * 输入纹理带 mip 链时（VulkanRunner 的 inputMipmaps），用户变换加上输入/输出尺寸使每个输出像素
+ * 覆盖超过 [MIP_MIN_FOOTPRINT] 个纹素时，光栅化路径换用三线性 sampler；其余情况仍只读第 0 级，
+ * 避免轻度缩小时的额外模糊。计算路径总是读第 0 级。
+ *
+ * 描述符由 [DescriptorManager] 管理：输入纹理、sampler 或输出视图变化时不会改写前几帧仍在使用的 set，
+ * 设备支持 VK_KHR_push_descriptor 时直接 push。
  */
 class AffineVulkanFilter(
     private val context: Context,
-    private val userTransform: AffineMatrix = AffineMatrix.IDENTITY
+    private val userTransform: AffineMatrix = AffineMatrix.IDENTITY,
+    private val clipMode: ClipMode = ClipMode.AUTO
 ) : VulkanFilter {
 
+    // 超出 [0, 1] 的纹理坐标如何处理（CLIP_OUT_OF_RANGE 特化常量）
+    enum class ClipMode {
+        AUTO,    // 根据用户变换判断是否需要检查
+        ALWAYS,  // 总是检查，超出部分输出透明
+        NEVER    // 不检查，超出部分按 sampler 的 CLAMP_TO_EDGE 采样
+    }
+
     private var vkDevice: Long = 0
-    private var vkPipeline: Long = 0
+    private var pipelineFuture: PipelineFuture? = null  // 后台编译，完成前 isReady() 为 false
+    private var layout: ReflectedLayout? = null
     private var vkPipelineLayout: Long = 0
-    private var vkDescriptorSetLayout: Long = 0
-    private var vkDescriptorPool: Long = 0
-    private var vkDescriptorSet: Long = 0
+    private var pushConstantStages: Int = 0
+    private var descriptors: DescriptorManager? = null
     private var vkSampler: Long = 0
+    private var vkMipSampler: Long = 0  // 三线性，maxLod 覆盖整条 mip 链
 
     private var vertexShaderModule: Long = 0
     private var fragmentShaderModule: Long = 0
 
+    // 计算路径（enableCompute() 之后 init 创建；任一步失败只保留光栅化路径）
+    private var computeRequested = false
+    private var computeShaderModule: Long = 0
+    private var computeLayout: ReflectedLayout? = null
+    private var computeFuture: PipelineFuture? = null
+    private var computeDescriptors: DescriptorManager? = null
+
     private var isInitialized = false
-    private var currentTextureView: Long = 0
 
     // 添加：表面尺寸（用于裁剪计算，可选）
     private var surfaceWidth: Int = 1920
     private var surfaceHeight: Int = 1080
 
+    // 输入尺寸未知（0）时不使用 mip
+    private var inputWidth: Int = 0
+    private var inputHeight: Int = 0
+    private var useMips = false
+
     override fun init(device: Long, renderPass: Long) {
         if (isInitialized) {
             Log.w(TAG, "Already initialized")
@@ -100,58 +141,56 @@ class AffineVulkanFilter(
             }
             Log.d(TAG, "✓ Shader modules created")
 
-            // 3. Create descriptor set layout
-            vkDescriptorSetLayout = nativeCreateDescriptorSetLayout(device)
-            if (vkDescriptorSetLayout == 0L) {
-                throw VulkanException("Failed to create descriptor set layout")
+            // 3-4. 从 SPIR-V 反射 descriptor set layout 和 pipeline layout（Push Constants 为 2 个 4x4 矩阵）
+            val reflected = ReflectedLayout(device, vertexShaderCode, fragmentShaderCode, pushDescriptorSet = 0)
+            layout = reflected
+            vkPipelineLayout = reflected.pipelineLayout
+            pushConstantStages = reflected.pushConstantStages
+            if (reflected.descriptorSetLayout(0) == 0L) {
+                throw VulkanException("affine.frag does not declare the input texture at set 0")
             }
-            Log.d(TAG, "✓ Descriptor set layout created")
-
-            // 4. Create pipeline layout (包含 2 个 4x4 矩阵的 Push Constants)
-            vkPipelineLayout = nativeCreatePipelineLayout(device, vkDescriptorSetLayout)
-            if (vkPipelineLayout == 0L) {
-                throw VulkanException("Failed to create pipeline layout")
+            if (reflected.pushConstantSize < PUSH_CONSTANT_SIZE) {
+                throw VulkanException("Push constant block is ${reflected.pushConstantSize} bytes, expected $PUSH_CONSTANT_SIZE")
+            }
+            if (SPEC_CLIP_OUT_OF_RANGE !in reflected.specConstants) {
+                Log.w(TAG, "Specialization constant $SPEC_CLIP_OUT_OF_RANGE is not declared in affine.frag")
             }
-            Log.d(TAG, "✓ Pipeline layout created with Push Constants support (2x mat4)")
+            Log.d(TAG, "✓ Pipeline layout reflected: ${reflected.setCount} sets, push constants ${reflected.pushConstantSize} bytes")
 
             // 5. Create graphics pipeline
-            vkPipeline = nativeCreateGraphicsPipeline(
+            val clip = when (clipMode) {
+                ClipMode.ALWAYS -> true
+                ClipMode.NEVER -> false
+                ClipMode.AUTO -> mayLeaveTexture()
+            }
+            val variant = ShaderVariant().with(SPEC_CLIP_OUT_OF_RANGE, clip)
+            pipelineFuture = PipelineFuture(
                 device,
                 renderPass,
                 vkPipelineLayout,
                 vertexShaderModule,
-                fragmentShaderModule
+                fragmentShaderModule,
+                variant
             )
-            if (vkPipeline == 0L) {
-                throw VulkanException("Failed to create graphics pipeline")
-            }
-            Log.d(TAG, "✓ Graphics pipeline created")
+            Log.d(TAG, "✓ Graphics pipeline submitted for compilation (clip=$clip)")
 
-            // 6. Create descriptor pool
-            vkDescriptorPool = nativeCreateDescriptorPool(device)
-            if (vkDescriptorPool == 0L) {
-                throw VulkanException("Failed to create descriptor pool")
-            }
-            Log.d(TAG, "✓ Descriptor pool created")
+            // 6. Descriptor 管理（按输入纹理和 sampler 缓存 set，或 push descriptor）
+            val manager = DescriptorManager(device, reflected)
+            descriptors = manager
+            Log.d(TAG, "✓ Descriptor manager created (push=${manager.usesPushDescriptors})")
 
-            // 7. Create sampler
-            vkSampler = nativeCreateSampler(device)
-            if (vkSampler == 0L) {
+            // 7. Create samplers（设备级缓存；光栅化路径在两者之间切换，所以不固化进 layout）
+            vkSampler = nativeCreateSampler(device, 0f)
+            vkMipSampler = nativeCreateSampler(device, MIP_MAX_LOD)
+            if (vkSampler == 0L || vkMipSampler == 0L) {
                 throw VulkanException("Failed to create sampler")
             }
-            Log.d(TAG, "✓ Sampler created")
+            Log.d(TAG, "✓ Samplers created")
 
-            // 8. Allocate descriptor set
-            vkDescriptorSet = nativeAllocateDescriptorSet(
-                vkDevice,
-                vkDescriptorPool,
-                vkDescriptorSetLayout
-            )
-
-            if (vkDescriptorSet == 0L) {
-                throw VulkanException("Failed to allocate descriptor set")
+            // 8. 计算 pipeline（可选）
+            if (computeRequested) {
+                initCompute(device, variant)
             }
-            Log.d(TAG, "✓ Descriptor set allocated")
 
             isInitialized = true
             Log.i(TAG, "=== AffineVulkanFilter initialized successfully ===")
@@ -164,12 +203,37 @@ class AffineVulkanFilter(
     }
 
     // 添加：设置表面尺寸
-    fun setSurfaceSize(width: Int, height: Int) {
+    override fun setSurfaceSize(width: Int, height: Int) {
         surfaceWidth = width
         surfaceHeight = height
+        updateMipSelection()
+        // 交换链/中间图像随尺寸重建，旧输出视图的句柄可能被复用
+        computeDescriptors?.invalidate()
         Log.d(TAG, "Surface size set: ${width}x${height}")
     }
 
+    override fun setInputSize(width: Int, height: Int) {
+        inputWidth = width
+        inputHeight = height
+        updateMipSelection()
+        // 输入纹理随尺寸重建
+        descriptors?.invalidate()
+        computeDescriptors?.invalidate()
+    }
+
+    // 输出 uv → 输入 uv 的用户变换在两个输出轴上的导数，换算成每个输出像素跨过的纹素数，
+    // 取较大者（与 GPU 选择 LOD 的方式一致）。SurfaceTexture 的 tex_matrix 只做翻转/裁剪，忽略
+    private fun updateMipSelection() {
+        if (inputWidth <= 0 || inputHeight <= 0 || surfaceWidth <= 0 || surfaceHeight <= 0) {
+            useMips = false
+            return
+        }
+        val m = userTransform.to4x4()
+        val footprintX = hypot(m[0] * inputWidth, m[1] * inputHeight) / surfaceWidth
+        val footprintY = hypot(m[4] * inputWidth, m[5] * inputHeight) / surfaceHeight
+        useMips = max(footprintX, footprintY) > MIP_MIN_FOOTPRINT
+    }
+
     override fun draw(commandBuffer: Long, inputTexture: Long, transformMatrix: FloatArray) {
         if (!isInitialized) {
             Log.e(TAG, "Filter not initialized!")
@@ -181,18 +245,20 @@ class AffineVulkanFilter(
             return
         }
 
-        // Update descriptor set if texture changed
-        if (currentTextureView != inputTexture) {
-            Log.d(TAG, "Updating descriptor set with texture: $inputTexture")
-            nativeUpdateDescriptorSet(vkDevice, vkDescriptorSet, inputTexture, vkSampler)
-            currentTextureView = inputTexture
-        }
-
         // Bind pipeline
-        nativeBindPipeline(commandBuffer, vkPipeline)
+        val pipeline = pipelineFuture?.pipeline() ?: 0L
+        if (pipeline == 0L) {
+            Log.e(TAG, "Graphics pipeline not compiled yet")
+            return
+        }
 
-        // Bind descriptor sets
-        nativeBindDescriptorSets(commandBuffer, vkPipelineLayout, vkDescriptorSet)
+        // 输入纹理 + sampler：缓存命中时不写描述符，也不会改写前几帧仍在使用的 set
+        val sampler = if (useMips) vkMipSampler else vkSampler
+        val descriptors = descriptors ?: return
+        if (!descriptors.bind(commandBuffer, false, vkPipelineLayout, inputTexture, sampler)) {
+            return
+        }
+        nativeBindPipeline(commandBuffer, pipeline)
 
         // 准备 Push Constants 数据
         // Push Constants 布局：
@@ -220,15 +286,145 @@ class AffineVulkanFilter(
         System.arraycopy(userMatrix, 0, pushConstantsData, 16, 16)
 
         // 推送矩阵数据到 GPU
-        nativePushConstants(commandBuffer, vkPipelineLayout, pushConstantsData)
+        nativePushConstants(commandBuffer, vkPipelineLayout, pushConstantStages, pushConstantsData)
 
         // Draw fullscreen triangle (3 vertices)
         nativeDraw(commandBuffer, 3, 1, 0, 0)
+    }
+
+    override fun isReady(): Boolean = (pipelineFuture?.pipeline() ?: 0L) != 0L
+
+    override fun enableCompute(): Boolean {
+        computeRequested = true
+        return true
+    }
+
+    override fun isComputeReady(): Boolean = (computeFuture?.pipeline() ?: 0L) != 0L
+
+    private fun initCompute(device: Long, variant: ShaderVariant) {
+        try {
+            val computeShaderCode = AffineShaderLoader.loadComputeShader(context)
+            computeShaderModule = nativeCreateShaderModule(device, computeShaderCode)
+            if (computeShaderModule == 0L) {
+                throw VulkanException("Failed to create compute shader module")
+            }
+
+            // 计算路径始终使用双线性 sampler，固化进 layout
+            val reflected = ReflectedLayout(
+                device, computeShaderCode,
+                pushDescriptorSet = 0,
+                immutableSamplers = listOf(ReflectedLayout.ImmutableSampler(0, 0, vkSampler))
+            )
+            computeLayout = reflected
+            if (reflected.descriptorSetLayout(0) == 0L) {
+                throw VulkanException("affine.comp does not declare its images at set 0")
+            }
+            if (reflected.pushConstantSize < COMPUTE_PUSH_CONSTANT_SIZE) {
+                throw VulkanException("Compute push constant block is ${reflected.pushConstantSize} bytes, expected $COMPUTE_PUSH_CONSTANT_SIZE")
+            }
 
-        frameCount++
-        if (frameCount % 60 == 0) {
-            Log.v(TAG, "Rendered frame $frameCount with transform: $userTransform")
+            computeFuture = PipelineFuture(device, reflected.pipelineLayout, computeShaderModule, variant)
+            computeDescriptors = DescriptorManager(device, reflected)
+            Log.d(TAG, "✓ Compute pipeline submitted for compilation")
+        } catch (e: Exception) {
+            Log.w(TAG, "Compute path unavailable, using graphics pipeline only", e)
+            releaseCompute()
+        }
+    }
+
+    override fun dispatch(
+        commandBuffer: Long,
+        inputTexture: Long,
+        transformMatrix: FloatArray,
+        outputImage: Long,
+        rects: IntArray
+    ) {
+        val computeLayout = computeLayout ?: return
+        val pipeline = computeFuture?.pipeline() ?: 0L
+        if (!isInitialized || pipeline == 0L || inputTexture == 0L || outputImage == 0L) {
+            return
+        }
+
+        val descriptors = computeDescriptors ?: return
+        if (!descriptors.bind(commandBuffer, true, computeLayout.pipelineLayout, inputTexture, vkSampler, outputImage)) {
+            return
+        }
+
+        // affine.comp 的 uv_matrix = tex_matrix * user_matrix（与光栅化路径的顶点着色器一致）
+        val uvMatrix = damageTransform(transformMatrix) ?: userTransform.to4x4()
+        nativeDispatchCompute(
+            commandBuffer,
+            pipeline,
+            computeLayout.pipelineLayout,
+            computeLayout.pushConstantStages,
+            uvMatrix,
+            rects
+        )
+    }
+
+    private fun releaseCompute() {
+        computeDescriptors?.release()
+        computeDescriptors = null
+        computeFuture?.release()
+        computeFuture = null
+        computeLayout?.release()
+        computeLayout = null
+        if (computeShaderModule != 0L) {
+            nativeDestroyShaderModule(vkDevice, computeShaderModule)
+            computeShaderModule = 0L
+        }
+    }
+
+    override fun awaitReady() {
+        pipelineFuture?.await()
+    }
+
+    // shader 中 texCoord = tex_matrix * user_matrix * uv
+    override fun damageTransform(transformMatrix: FloatArray): FloatArray? {
+        if (transformMatrix.size < 16) {
+            return userTransform.to4x4()
+        }
+        return multiply4x4(transformMatrix, userTransform.to4x4())
+    }
+
+    // 输出就是输入在 tex_matrix * user_matrix * uv 处的采样；NEVER 模式下越界部分按 CLAMP_TO_EDGE
+    // 采样，与 copy/blit 的结果不同，只有不越界时才能走快速路径
+    override fun transferTransform(transformMatrix: FloatArray): FloatArray? {
+        if (clipMode == ClipMode.NEVER && mayLeaveTexture()) {
+            return null
         }
+        return damageTransform(transformMatrix)
+    }
+
+    // 用户变换把 [0, 1]² 映射到纹理坐标；四个角都落在 [0, 1]² 内时不会采样到范围外
+    // （tex_matrix 来自 SurfaceTexture，只做翻转/裁剪，本身不会越界）
+    private fun mayLeaveTexture(): Boolean {
+        val m = userTransform.to4x4()
+        for (corner in 0 until 4) {
+            val x = (corner and 1).toFloat()
+            val y = (corner shr 1).toFloat()
+            val u = m[0] * x + m[4] * y + m[12]
+            val v = m[1] * x + m[5] * y + m[13]
+            if (u < -EPSILON || u > 1f + EPSILON || v < -EPSILON || v > 1f + EPSILON) {
+                return true
+            }
+        }
+        return false
+    }
+
+    // 列主序 4x4 矩阵乘法：lhs * rhs
+    private fun multiply4x4(lhs: FloatArray, rhs: FloatArray): FloatArray {
+        val result = FloatArray(16)
+        for (col in 0 until 4) {
+            for (row in 0 until 4) {
+                var sum = 0f
+                for (k in 0 until 4) {
+                    sum += lhs[k * 4 + row] * rhs[col * 4 + k]
+                }
+                result[col * 4 + row] = sum
+            }
+        }
+        return result
     }
 
     override fun release() {
@@ -236,26 +432,25 @@ class AffineVulkanFilter(
 
         Log.d(TAG, "Releasing filter resources")
 
-        if (vkDescriptorPool != 0L) {
-            nativeDestroyDescriptorPool(vkDevice, vkDescriptorPool)
-            vkDescriptorPool = 0L
-        }
+        descriptors?.release()
+        descriptors = null
+        // 计算 set 引用 sampler，先释放
+        releaseCompute()
         if (vkSampler != 0L) {
             nativeDestroySampler(vkDevice, vkSampler)
             vkSampler = 0L
         }
-        if (vkPipeline != 0L) {
-            nativeDestroyPipeline(vkDevice, vkPipeline)
-            vkPipeline = 0L
-        }
-        if (vkPipelineLayout != 0L) {
-            nativeDestroyPipelineLayout(vkDevice, vkPipelineLayout)
-            vkPipelineLayout = 0L
-        }
-        if (vkDescriptorSetLayout != 0L) {
-            nativeDestroyDescriptorSetLayout(vkDevice, vkDescriptorSetLayout)
-            vkDescriptorSetLayout = 0L
+        if (vkMipSampler != 0L) {
+            nativeDestroySampler(vkDevice, vkMipSampler)
+            vkMipSampler = 0L
         }
+        // 先取消/等待编译任务，之后才能销毁它引用的 layout 和 shader module
+        pipelineFuture?.release()
+        pipelineFuture = null
+        // layout 归设备缓存所有，这里只减少引用
+        layout?.release()
+        layout = null
+        vkPipelineLayout = 0L
         if (vertexShaderModule != 0L) {
             nativeDestroyShaderModule(vkDevice, vertexShaderModule)
             vertexShaderModule = 0L
@@ -266,44 +461,18 @@ class AffineVulkanFilter(
         }
 
         isInitialized = false
-        currentTextureView = 0
         Log.d(TAG, "Filter resources released")
     }
 
     // ==================== Native JNI Methods ====================
 
-    private external fun nativeCreateDescriptorSetLayout(device: Long): Long
-    private external fun nativeCreateGraphicsPipeline(
-        device: Long,
-        renderPass: Long,
-        pipelineLayout: Long,
-        vertShaderModule: Long,
-        fragShaderModule: Long
-    ): Long
-    private external fun nativeCreateDescriptorPool(device: Long): Long
-    private external fun nativeCreateSampler(device: Long): Long
+    private external fun nativeCreateSampler(device: Long, maxLod: Float): Long
     private external fun nativeCreateShaderModule(device: Long, code: ByteArray): Long
-    private external fun nativeAllocateDescriptorSet(
-        device: Long,
-        descriptorPool: Long,
-        descriptorSetLayout: Long
-    ): Long
-    private external fun nativeUpdateDescriptorSet(
-        device: Long,
-        descriptorSet: Long,
-        imageView: Long,
-        sampler: Long
-    )
-    private external fun nativeCreatePipelineLayout(device: Long, descriptorSetLayout: Long): Long
     private external fun nativeBindPipeline(commandBuffer: Long, pipeline: Long)
-    private external fun nativeBindDescriptorSets(
-        commandBuffer: Long,
-        pipelineLayout: Long,
-        descriptorSet: Long
-    )
     private external fun nativePushConstants(
         commandBuffer: Long,
         pipelineLayout: Long,
+        stageFlags: Int,
         data: FloatArray
     )
     private external fun nativeDraw(
@@ -313,16 +482,29 @@ class AffineVulkanFilter(
         firstVertex: Int,
         firstInstance: Int
     )
-    private external fun nativeDestroyDescriptorPool(device: Long, descriptorPool: Long)
+    private external fun nativeDispatchCompute(
+        commandBuffer: Long,
+        pipeline: Long,
+        pipelineLayout: Long,
+        stageFlags: Int,
+        uvMatrix: FloatArray,
+        rects: IntArray
+    )
     private external fun nativeDestroySampler(device: Long, sampler: Long)
-    private external fun nativeDestroyPipeline(device: Long, pipeline: Long)
-    private external fun nativeDestroyPipelineLayout(device: Long, pipelineLayout: Long)
-    private external fun nativeDestroyDescriptorSetLayout(device: Long, descriptorSetLayout: Long)
     private external fun nativeDestroyShaderModule(device: Long, shaderModule: Long)
 
     companion object {
         private const val TAG = "AffineVulkanFilter"
-        private var frameCount = 0
+
+        // affine.frag 中的 constant_id
+        private const val SPEC_CLIP_OUT_OF_RANGE = 0
+        private const val PUSH_CONSTANT_SIZE = 128  // tex_matrix + user_matrix
+        private const val COMPUTE_PUSH_CONSTANT_SIZE = 80  // uv_matrix + region
+        private const val EPSILON = 1e-5f
+
+        // 每个输出像素跨过超过 2 个纹素时双线性开始跳过纹素，换用 mip 链
+        private const val MIP_MIN_FOOTPRINT = 2f
+        private const val MIP_MAX_LOD = 16f  // 覆盖边长 65536 以内纹理的完整 mip 链
 
         init {
             System.loadLibrary("myapplication")
@@ -0,0 +1,62 @@
+package com.genymobile.scrcpy.vulkan
+
+/**
+ * 设备级的 bindless 输入纹理表（见 Vulkanbindless.h）
+ *
+ * 设备支持 VK_EXT_descriptor_indexing 时，每个设备有一个 `sampler2D sources[]` 数组的 set。
+ * 每个输入纹理（视图 + sampler）通过 [acquire] 拿到一个稳定的槽号，着色器用 push constant 里的
+ * 槽号选择来源；合成多个来源时每次绘制只 [bind] 一次。[isSupported] 为 false 时调用方回退到
+ * 每个来源一个 set（[DescriptorManager]）。
+ *
+ * 使用示例：
+ * ```
+ * val table = BindlessTable(device)
+ * val layout = ReflectedLayout(device, vertCode, compositeFragCode)   // layout.bindlessSet == 0
+ * val slot = table.acquire(imageView, sampler)
+ * table.bind(commandBuffer, compute = false, layout.pipelineLayout, layout.bindlessSet)
+ * // push constant 中写入 slot，绘制
+ * table.release(slot)   // 视图销毁前释放；槽在 framesInFlight 帧之后才会被改写
+ * ```
+ */
+class BindlessTable(private val device: Long) {
+    // 槽数；设备不支持描述符索引时为 0
+    val capacity: Int = nativeCapacity(device)
+
+    val isSupported: Boolean
+        get() = capacity > 0
+
+    // 录制或准备阶段调用；同一 (视图, sampler) 返回同一个槽并增加引用。表满或不支持时返回 -1
+    fun acquire(imageView: Long, sampler: Long): Int {
+        if (!isSupported || imageView == 0L || sampler == 0L) return -1
+        return nativeAcquire(device, imageView, sampler)
+    }
+
+    fun release(slot: Int) {
+        if (slot >= 0) {
+            nativeRelease(device, slot)
+        }
+    }
+
+    // 把表绑定到 pipelineLayout 的 set（ReflectedLayout.bindlessSet）
+    fun bind(commandBuffer: Long, compute: Boolean, pipelineLayout: Long, set: Int): Boolean {
+        if (!isSupported || set < 0) return false
+        return nativeBind(device, commandBuffer, compute, pipelineLayout, set)
+    }
+
+    private external fun nativeCapacity(device: Long): Int
+    private external fun nativeAcquire(device: Long, imageView: Long, sampler: Long): Int
+    private external fun nativeRelease(device: Long, slot: Int)
+    private external fun nativeBind(
+        device: Long,
+        commandBuffer: Long,
+        compute: Boolean,
+        pipelineLayout: Long,
+        set: Int
+    ): Boolean
+
+    companion object {
+        init {
+            System.loadLibrary("myapplication")
+        }
+    }
+}
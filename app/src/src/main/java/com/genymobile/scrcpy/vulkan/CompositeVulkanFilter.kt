@@ -0,0 +1,299 @@
+package com.genymobile.scrcpy.vulkan
+
+import android.content.Context
+import android.util.Log
+
+/**
+ * 多源合成滤镜：把若干来源按层画到输出的指定矩形里（画中画、拼接）
+ *
+ * 每层的来源是 runner 的输入纹理，或调用方通过 [setSource] 提供的图像视图（采样时必须处于
+ * SHADER_READ_ONLY_OPTIMAL，由调用方保证在 [setSource] 换掉或 [release] 之前有效）。
+ * 层按列表顺序绘制，后面的层覆盖前面的层，层外的像素保持不变。
+ *
+ * 设备支持描述符索引时（[BindlessTable]）所有来源都在设备的纹理表里各占一个槽，
+ * composite.frag 通过 push constant 中的槽号选择来源：每次 draw 只绑定一次 set，
+ * 每层只推送矩阵和槽号，所有层在一次 JNI 调用里录制完。不支持时用 composite_single.frag，
+ * 每层由 [DescriptorManager] 绑定自己的 set。
+ *
+ * 使用示例：
+ * ```
+ * val filter = CompositeVulkanFilter(context, listOf(
+ *     CompositeVulkanFilter.Layer(0f, 0f, 1f, 1f),            // 全屏：runner 输入
+ *     CompositeVulkanFilter.Layer(0.65f, 0.05f, 0.3f, 0.3f)   // 右上角小窗
+ * ))
+ * filter.setSource(1, cameraImageView)
+ * ```
+ */
+class CompositeVulkanFilter(
+    private val context: Context,
+    layers: List<Layer>
+) : VulkanFilter {
+
+    // 输出中的矩形（归一化坐标，与输出 uv 同向），来源默认是 runner 的输入纹理
+    class Layer(val x: Float, val y: Float, val width: Float, val height: Float) {
+        init {
+            require(width > 0f && height > 0f) { "Layer must have a positive size" }
+        }
+
+        // 输出 uv → 本层 uv：(uv - (x, y)) / (width, height)，4x4 列主序
+        internal val userMatrix = FloatArray(16).also {
+            it[0] = 1f / width
+            it[5] = 1f / height
+            it[10] = 1f
+            it[12] = -x / width
+            it[13] = -y / height
+            it[15] = 1f
+        }
+
+        internal var source: Long = 0L  // 0：runner 的输入纹理
+        internal var slot: Int = -1     // bindless 路径下外部来源占用的槽
+    }
+
+    val layers: List<Layer> = layers.toList()
+
+    private var vkDevice: Long = 0
+    private var pipelineFuture: PipelineFuture? = null
+    private var layout: ReflectedLayout? = null
+    private var vkSampler: Long = 0
+
+    private var vertexShaderModule: Long = 0
+    private var fragmentShaderModule: Long = 0
+
+    // bindless 路径；为 null 时每层一个 descriptor set
+    private var table: BindlessTable? = null
+    private var descriptors: DescriptorManager? = null
+
+    // runner 的输入在 input ring 的几个视图之间轮换，每个视图各占一个槽直到输入重建
+    private val inputSlots = HashMap<Long, Int>()
+
+    private var isInitialized = false
+    private val matrices = FloatArray(this.layers.size * 32)
+    private val slots = IntArray(this.layers.size)
+
+    init {
+        require(this.layers.isNotEmpty()) { "Empty composite" }
+    }
+
+    val usesBindless: Boolean
+        get() = table != null
+
+    // 层 index 改用外部图像视图（0 恢复为 runner 的输入）。在渲染线程调用
+    fun setSource(index: Int, imageView: Long) {
+        val layer = layers[index]
+        if (layer.source == imageView) return
+        table?.release(layer.slot)
+        layer.slot = -1
+        layer.source = imageView
+    }
+
+    override fun init(device: Long, renderPass: Long) {
+        if (isInitialized) {
+            Log.w(TAG, "Already initialized")
+            return
+        }
+
+        this.vkDevice = device
+        Log.d(TAG, "=== Initializing CompositeVulkanFilter (${layers.size} layers) ===")
+
+        try {
+            val bindless = BindlessTable(device)
+            val vertexShaderCode = ShaderLoader.loadShader(context, "shaders/affine_vert.spv")
+            val fragmentShaderCode = ShaderLoader.loadShader(
+                context,
+                if (bindless.isSupported) "shaders/composite_frag.spv" else "shaders/composite_single_frag.spv"
+            )
+
+            vertexShaderModule = nativeCreateShaderModule(device, vertexShaderCode)
+            fragmentShaderModule = nativeCreateShaderModule(device, fragmentShaderCode)
+            if (vertexShaderModule == 0L || fragmentShaderModule == 0L) {
+                throw VulkanException("Failed to create shader modules")
+            }
+
+            val reflected = if (bindless.isSupported) {
+                ReflectedLayout(device, vertexShaderCode, fragmentShaderCode)
+            } else {
+                ReflectedLayout(device, vertexShaderCode, fragmentShaderCode, pushDescriptorSet = 0)
+            }
+            layout = reflected
+            if (bindless.isSupported) {
+                if (reflected.bindlessSet != 0) {
+                    throw VulkanException("composite.frag does not declare the texture table at set 0")
+                }
+                if (reflected.pushConstantSize < BINDLESS_PUSH_CONSTANT_SIZE) {
+                    throw VulkanException("Push constant block is ${reflected.pushConstantSize} bytes, expected $BINDLESS_PUSH_CONSTANT_SIZE")
+                }
+                table = bindless
+            } else {
+                if (reflected.descriptorSetLayout(0) == 0L) {
+                    throw VulkanException("composite_single.frag does not declare the input texture at set 0")
+                }
+                descriptors = DescriptorManager(device, reflected)
+            }
+
+            vkSampler = nativeCreateSampler(device)
+            if (vkSampler == 0L) {
+                throw VulkanException("Failed to create sampler")
+            }
+
+            pipelineFuture = PipelineFuture(
+                device,
+                renderPass,
+                reflected.pipelineLayout,
+                vertexShaderModule,
+                fragmentShaderModule
+            )
+
+            isInitialized = true
+            Log.i(TAG, "=== CompositeVulkanFilter initialized (bindless=$usesBindless, ${bindless.capacity} slots) ===")
+
+        } catch (e: Exception) {
+            Log.e(TAG, "Failed to initialize filter", e)
+            release()
+            throw e
+        }
+    }
+
+    override fun setInputSize(width: Int, height: Int) {
+        // 输入纹理随尺寸重建，旧视图的句柄可能被复用
+        releaseInputSlots()
+        descriptors?.invalidate()
+    }
+
+    // 外部来源的内容变化不经过 runner 的脏矩形
+    override fun isAnimated(): Boolean = layers.any { it.source != 0L }
+
+    override fun draw(commandBuffer: Long, inputTexture: Long, transformMatrix: FloatArray) {
+        val layout = layout ?: return
+        val pipeline = pipelineFuture?.pipeline() ?: 0L
+        if (!isInitialized || pipeline == 0L) {
+            return
+        }
+
+        // 输入层用 runner 的 tex_matrix，外部来源按原样采样
+        for ((index, layer) in layers.withIndex()) {
+            val texMatrix = if (layer.source == 0L && transformMatrix.size >= 16) transformMatrix else IDENTITY
+            System.arraycopy(texMatrix, 0, matrices, index * 32, 16)
+            System.arraycopy(layer.userMatrix, 0, matrices, index * 32 + 16, 16)
+        }
+
+        nativeBindPipeline(commandBuffer, pipeline)
+        val table = table
+        if (table != null) {
+            for ((index, layer) in layers.withIndex()) {
+                slots[index] = slotFor(table, layer, inputTexture)
+            }
+            // 整个合成只绑定一次 set
+            if (!table.bind(commandBuffer, false, layout.pipelineLayout, layout.bindlessSet)) {
+                return
+            }
+            nativeDrawLayers(commandBuffer, layout.pipelineLayout, layout.pushConstantStages, matrices, slots)
+            return
+        }
+
+        // 回退：每层绑定自己的 set
+        val descriptors = descriptors ?: return
+        for ((index, layer) in layers.withIndex()) {
+            val view = if (layer.source != 0L) layer.source else inputTexture
+            if (view == 0L ||
+                !descriptors.bind(commandBuffer, false, layout.pipelineLayout, view, vkSampler)) {
+                continue
+            }
+            nativeDrawLayers(
+                commandBuffer, layout.pipelineLayout, layout.pushConstantStages,
+                matrices.copyOfRange(index * 32, index * 32 + 32), null
+            )
+        }
+    }
+
+    // 来源的槽号；没有来源或表满时为 -1（该层不绘制）
+    private fun slotFor(table: BindlessTable, layer: Layer, inputTexture: Long): Int {
+        if (layer.source != 0L) {
+            if (layer.slot < 0) {
+                layer.slot = table.acquire(layer.source, vkSampler)
+            }
+            return layer.slot
+        }
+        if (inputTexture == 0L) return -1
+        return inputSlots.getOrPut(inputTexture) { table.acquire(inputTexture, vkSampler) }
+    }
+
+    private fun releaseInputSlots() {
+        val table = table
+        if (table != null) {
+            inputSlots.values.forEach { table.release(it) }
+        }
+        inputSlots.clear()
+    }
+
+    override fun isReady(): Boolean = (pipelineFuture?.pipeline() ?: 0L) != 0L
+
+    override fun awaitReady() {
+        pipelineFuture?.await()
+    }
+
+    override fun release() {
+        Log.d(TAG, "Releasing filter resources")
+
+        // 槽在 framesInFlight 帧之后才会被改写，不需要等待 GPU
+        releaseInputSlots()
+        for (layer in layers) {
+            table?.release(layer.slot)
+            layer.slot = -1
+        }
+        table = null
+        descriptors?.release()
+        descriptors = null
+        if (vkSampler != 0L) {
+            nativeDestroySampler(vkDevice, vkSampler)
+            vkSampler = 0L
+        }
+        // 先取消/等待编译任务，之后才能销毁它引用的 layout 和 shader module
+        pipelineFuture?.release()
+        pipelineFuture = null
+        layout?.release()
+        layout = null
+        if (vertexShaderModule != 0L) {
+            nativeDestroyShaderModule(vkDevice, vertexShaderModule)
+            vertexShaderModule = 0L
+        }
+        if (fragmentShaderModule != 0L) {
+            nativeDestroyShaderModule(vkDevice, fragmentShaderModule)
+            fragmentShaderModule = 0L
+        }
+
+        isInitialized = false
+    }
+
+    // ==================== Native JNI Methods ====================
+
+    private external fun nativeCreateShaderModule(device: Long, code: ByteArray): Long
+    private external fun nativeDestroyShaderModule(device: Long, shaderModule: Long)
+    private external fun nativeCreateSampler(device: Long): Long
+    private external fun nativeDestroySampler(device: Long, sampler: Long)
+    private external fun nativeBindPipeline(commandBuffer: Long, pipeline: Long)
+    private external fun nativeDrawLayers(
+        commandBuffer: Long,
+        pipelineLayout: Long,
+        stageFlags: Int,
+        matrices: FloatArray,
+        slots: IntArray?
+    )
+
+    companion object {
+        private const val TAG = "CompositeVulkanFilter"
+
+        // tex_matrix + user_matrix + 槽号
+        private const val BINDLESS_PUSH_CONSTANT_SIZE = 132
+
+        private val IDENTITY = floatArrayOf(
+            1f, 0f, 0f, 0f,
+            0f, 1f, 0f, 0f,
+            0f, 0f, 1f, 0f,
+            0f, 0f, 0f, 1f
+        )
+
+        init {
+            System.loadLibrary("myapplication")
+        }
+    }
+}
@@ -0,0 +1,77 @@
+package com.genymobile.scrcpy.vulkan
+
+/**
+ * 滤镜 pass 的 descriptor 绑定（见 Vulkandescriptors.h）
+ *
+ * set 0 约定为 binding 0 采样输入、可选的 binding 1 存储输出。set 按 (输入视图, sampler, 输出视图)
+ * 缓存，只改写至少 framesInFlight 帧没有绑定过的 set，所以切换输入槽、sampler 时不会更新
+ * GPU 可能仍在读取的 set。layout 的 set 0 是 push set 时（[ReflectedLayout.pushDescriptorSet]）
+ * 直接把描述符写进命令缓冲。
+ *
+ * 使用示例：
+ * ```
+ * val layout = ReflectedLayout(device, vertCode, fragCode, pushDescriptorSet = 0)
+ * val descriptors = DescriptorManager(device, layout)
+ * descriptors.bind(commandBuffer, compute = false, layout.pipelineLayout, inputTexture, sampler)
+ * ```
+ */
+class DescriptorManager(device: Long, layout: ReflectedLayout) {
+    private var handle: Long = nativeCreate(device, layout.descriptorSetLayout(0), layout.pushDescriptorSet == 0)
+
+    init {
+        if (handle == 0L) {
+            throw VulkanException("Failed to create descriptor manager")
+        }
+    }
+
+    val usesPushDescriptors: Boolean
+        get() = handle != 0L && nativeUsesPushDescriptors(handle)
+
+    // 录制阶段调用；outputView 为 0 时只写 binding 0。失败时不绑定任何东西并返回 false
+    fun bind(
+        commandBuffer: Long,
+        compute: Boolean,
+        pipelineLayout: Long,
+        inputView: Long,
+        sampler: Long,
+        outputView: Long = 0L
+    ): Boolean {
+        if (handle == 0L) return false
+        return nativeBind(handle, commandBuffer, compute, pipelineLayout, inputView, sampler, outputView)
+    }
+
+    // 输入纹理或输出图像重建后调用：旧视图的句柄可能被新视图复用，不能再按句柄命中
+    fun invalidate() {
+        if (handle != 0L) {
+            nativeReset(handle)
+        }
+    }
+
+    // 调用前 GPU 不能再使用这里的 set
+    fun release() {
+        if (handle != 0L) {
+            nativeDestroy(handle)
+            handle = 0L
+        }
+    }
+
+    private external fun nativeCreate(device: Long, descriptorSetLayout: Long, pushDescriptors: Boolean): Long
+    private external fun nativeDestroy(manager: Long)
+    private external fun nativeReset(manager: Long)
+    private external fun nativeUsesPushDescriptors(manager: Long): Boolean
+    private external fun nativeBind(
+        manager: Long,
+        commandBuffer: Long,
+        compute: Boolean,
+        pipelineLayout: Long,
+        inputView: Long,
+        sampler: Long,
+        outputView: Long
+    ): Boolean
+
+    companion object {
+        init {
+            System.loadLibrary("myapplication")
+        }
+    }
+}
@@ -0,0 +1,208 @@
+package com.genymobile.scrcpy.vulkan
+
+import android.content.Context
+import android.util.Log
+import kotlin.math.roundToInt
+
+/**
+ * 动态分辨率滤镜：包装任意 [VulkanFilter]
+ *
+ * 内部滤镜先渲染到离屏图像的左上角 (scale × 输出尺寸)，再由 [AffineVulkanFilter]
+ * 双线性放大到交换链图像。缩放比例由 [ResolutionGovernor] 根据离屏 pass 的 GPU 时间决定。
+ *
+ * 使用示例：
+ * ```
+ * val filter = DynamicResolutionFilter(context, SimpleVulkanFilter(context))
+ * val runner = VulkanRunner(filter)
+ * ```
+ */
+class DynamicResolutionFilter @JvmOverloads constructor(
+    context: Context,
+    private val inner: VulkanFilter,
+    val governor: ResolutionGovernor = ResolutionGovernor()
+) : VulkanFilter {
+
+    private val upscaler = AffineVulkanFilter(context)
+
+    private var vkDevice: Long = 0
+    private var renderTarget: Long = 0
+    private var renderTargetView: Long = 0
+    private var targetWidth: Int = 0   // 离屏图像分配尺寸
+    private var targetHeight: Int = 0
+
+    private var outputWidth: Int = 1920
+    private var outputHeight: Int = 1080
+    private var renderWidth: Int = 0
+    private var renderHeight: Int = 0
+
+    // 控制器在第 N 帧决定的比例在第 N+1 帧生效，使 isAnimated() 能提前触发整帧重绘
+    private var pendingScale: Float = governor.scale
+    private var appliedScale: Float = 0f
+
+    private val upscaleMatrix = FloatArray(16)
+    private var isInitialized = false
+
+    override fun setSurfaceSize(width: Int, height: Int) {
+        outputWidth = width
+        outputHeight = height
+        // 强制下一帧重新计算渲染尺寸
+        appliedScale = 0f
+    }
+
+    // 内部滤镜读取的仍是 runner 的输入纹理
+    override fun setInputSize(width: Int, height: Int) {
+        inner.setInputSize(width, height)
+    }
+
+    override fun init(device: Long, renderPass: Long) {
+        if (isInitialized) {
+            Log.w(TAG, "Already initialized")
+            return
+        }
+
+        this.vkDevice = device
+        Log.d(TAG, "=== Initializing DynamicResolutionFilter ===")
+
+        try {
+            // 按最大比例分配，比例变化时不需要重新创建图像
+            targetWidth = governor.maxLength(outputWidth)
+            targetHeight = governor.maxLength(outputHeight)
+            renderTarget = nativeCreateRenderTarget(device, targetWidth, targetHeight)
+            if (renderTarget == 0L) {
+                throw VulkanException("Failed to create render target")
+            }
+            renderTargetView = nativeGetRenderTargetView(renderTarget)
+            Log.d(TAG, "✓ Render target created: ${targetWidth}x${targetHeight}")
+
+            // 离屏 render pass 与交换链 render pass 兼容，两个 pipeline 都基于 renderPass 创建
+            // （动态渲染时 renderPass 为 0，离屏图像与交换链格式相同）
+            inner.init(device, renderPass)
+            upscaler.init(device, renderPass)
+
+            isInitialized = true
+            Log.i(TAG, "=== DynamicResolutionFilter initialized successfully ===")
+
+        } catch (e: Exception) {
+            Log.e(TAG, "Failed to initialize filter", e)
+            release()
+            throw e
+        }
+    }
+
+    override fun prepare(commandBuffer: Long, inputTexture: Long, transformMatrix: FloatArray) {
+        if (!isInitialized) {
+            return
+        }
+
+        applyScale(pendingScale)
+
+        // 读取之前帧的 GPU 时间（不等待）
+        val gpuTimeMs = nativeReadGpuTime(vkDevice, renderTarget)
+        if (gpuTimeMs >= 0.0) {
+            pendingScale = governor.update(gpuTimeMs)
+            if (pendingScale != appliedScale) {
+                Log.i(TAG, "Render scale ${"%.3f".format(appliedScale)} -> ${"%.3f".format(pendingScale)} " +
+                        "(gpu ${"%.2f".format(governor.smoothedGpuTimeMs)} ms, budget ${governor.frameBudgetMs} ms)")
+            }
+        }
+
+        nativeBeginRenderTargetPass(commandBuffer, renderTarget, renderWidth, renderHeight)
+        inner.prepare(commandBuffer, inputTexture, transformMatrix)
+        inner.draw(commandBuffer, inputTexture, transformMatrix)
+        nativeEndRenderTargetPass(commandBuffer, renderTarget)
+    }
+
+    override fun draw(commandBuffer: Long, inputTexture: Long, transformMatrix: FloatArray) {
+        if (!isInitialized) {
+            Log.e(TAG, "Filter not initialized!")
+            return
+        }
+        upscaler.draw(commandBuffer, renderTargetView, upscaleMatrix)
+    }
+
+    // 放大不改变输出到输入的映射（忽略半像素偏移）
+    override fun damageTransform(transformMatrix: FloatArray): FloatArray? {
+        return inner.damageTransform(transformMatrix)
+    }
+
+    override fun setQualityLevel(level: Int) {
+        inner.setQualityLevel(level)
+    }
+
+    // prepare() 会调用 inner.draw()，两个滤镜都编译完成才能切换
+    override fun isReady(): Boolean = isInitialized && inner.isReady() && upscaler.isReady()
+
+    override fun awaitReady() {
+        inner.awaitReady()
+        upscaler.awaitReady()
+    }
+
+    // 比例改变时整帧都要重绘
+    override fun isAnimated(): Boolean {
+        return inner.isAnimated() || pendingScale != appliedScale
+    }
+
+    override fun release() {
+        Log.d(TAG, "Releasing filter resources")
+
+        inner.release()
+        upscaler.release()
+
+        if (renderTarget != 0L) {
+            nativeDestroyRenderTarget(vkDevice, renderTarget)
+            renderTarget = 0L
+            renderTargetView = 0L
+        }
+
+        isInitialized = false
+        appliedScale = 0f
+        Log.d(TAG, "Filter resources released")
+    }
+
+    private fun applyScale(scale: Float) {
+        if (scale == appliedScale) {
+            return
+        }
+        appliedScale = scale
+        renderWidth = (outputWidth * scale).roundToInt().coerceIn(1, targetWidth)
+        renderHeight = (outputHeight * scale).roundToInt().coerceIn(1, targetHeight)
+        inner.setSurfaceSize(renderWidth, renderHeight)
+        updateUpscaleMatrix()
+    }
+
+    // 输出纹理坐标 [0, 1] -> 离屏图像中已渲染区域的首尾像素中心，避免双线性采样读到区域外
+    private fun updateUpscaleMatrix() {
+        val width = targetWidth.toFloat()
+        val height = targetHeight.toFloat()
+
+        upscaleMatrix.fill(0f)
+        upscaleMatrix[0] = (renderWidth - 1) / width
+        upscaleMatrix[5] = (renderHeight - 1) / height
+        upscaleMatrix[10] = 1f
+        upscaleMatrix[12] = 0.5f / width
+        upscaleMatrix[13] = 0.5f / height
+        upscaleMatrix[15] = 1f
+    }
+
+    // ==================== Native JNI Methods ====================
+
+    private external fun nativeCreateRenderTarget(device: Long, width: Int, height: Int): Long
+    private external fun nativeDestroyRenderTarget(device: Long, renderTarget: Long)
+    private external fun nativeGetRenderTargetView(renderTarget: Long): Long
+    private external fun nativeBeginRenderTargetPass(
+        commandBuffer: Long,
+        renderTarget: Long,
+        width: Int,
+        height: Int
+    )
+    private external fun nativeEndRenderTargetPass(commandBuffer: Long, renderTarget: Long)
+    private external fun nativeReadGpuTime(device: Long, renderTarget: Long): Double
+
+    companion object {
+        private const val TAG = "DynamicResolutionFilter"
+
+        init {
+            System.loadLibrary("myapplication")
+        }
+    }
+}
@@ -0,0 +1,321 @@
+package com.genymobile.scrcpy.vulkan
+
+import android.util.Log
+import kotlin.math.roundToInt
+
+/**
+ * 多 pass 滤镜图：把多个 [VulkanFilter] 组合成一个滤镜交给 [VulkanRunner]
+ *
+ * 每个 pass 声明输入和输出（按名字），[INPUT] 是 runner 的输入纹理，[OUTPUT] 是交换链。
+ * 中间图像由 native 端（Vulkanfiltergraph.h）从池中分配，生命周期不重叠的中间结果共用图像，
+ * 写入前后只插入必要的同步。所有 pass 录制在 runner 的同一个命令缓冲中：
+ * 写中间图像的 pass 在 [prepare] 中执行，写 [OUTPUT] 的 pass 在 [draw] 中执行。
+ *
+ * 节点可以是任意 [VulkanFilter]（例如 [AffineVulkanFilter]、[DynamicResolutionFilter]）。
+ * 读取中间图像的节点收到单位矩阵作为纹理变换。
+ *
+ * 使用示例：
+ * ```
+ * // 缩放 → 锐化 → 调色
+ * val graph = FilterGraph.chain(
+ *     AffineVulkanFilter(context, AffineMatrix.scale(0.5, 0.5).fromCenter()),
+ *     sharpen,
+ *     colorCorrect
+ * )
+ *
+ * // 显式声明：半分辨率的中间结果
+ * val graph = FilterGraph()
+ *     .addPass(downscale, FilterGraph.INPUT, "half", scale = 0.5f)
+ *     .addPass(blur, "half", FilterGraph.OUTPUT)
+ * val runner = VulkanRunner(graph)
+ * ```
+ */
+class FilterGraph : VulkanFilter {
+
+    private class Node(
+        val filter: VulkanFilter,
+        val input: String,
+        val output: String,
+        val scale: Float  // 输出相对于交换链的尺寸（只对中间图像有效）
+    ) {
+        var pass: Int = -1
+        var width: Int = 0
+        var height: Int = 0
+    }
+
+    private val nodes = ArrayList<Node>()
+    private val views = HashMap<String, Long>()  // 中间资源名 -> image view（compile 之后）
+
+    private var vkDevice: Long = 0
+    private var graph: Long = 0
+    private var surfaceWidth: Int = 1920
+    private var surfaceHeight: Int = 1080
+    private var inputWidth: Int = 0
+    private var inputHeight: Int = 0
+    private var isInitialized = false
+
+    /**
+     * 添加 pass。必须按执行顺序添加：input 只能是 [INPUT] 或前面 pass 的输出；
+     * 每个名字只能被写一次，恰好一个 pass 写 [OUTPUT]
+     */
+    fun addPass(filter: VulkanFilter, input: String, output: String, scale: Float = 1f): FilterGraph {
+        check(!isInitialized) { "Cannot add passes after init()" }
+        require(output != INPUT) { "Cannot write the graph input" }
+        require(scale > 0f) { "Invalid scale: $scale" }
+        nodes.add(Node(filter, input, output, scale))
+        return this
+    }
+
+    override fun init(device: Long, renderPass: Long) {
+        if (isInitialized) {
+            Log.w(TAG, "Already initialized")
+            return
+        }
+        vkDevice = device
+        Log.d(TAG, "=== Initializing FilterGraph (${nodes.size} passes) ===")
+
+        try {
+            graph = nativeCreate(device)
+            if (graph == 0L) {
+                throw VulkanException("Failed to create filter graph")
+            }
+            build()
+
+            // 中间图像与交换链格式相同，所有节点都基于 renderPass 创建 pipeline
+            for (node in nodes) {
+                node.filter.setSurfaceSize(node.width, node.height)
+                forwardInputSize(node)
+                node.filter.init(device, renderPass)
+            }
+
+            isInitialized = true
+            Log.i(TAG, "=== FilterGraph initialized successfully ===")
+
+        } catch (e: Exception) {
+            Log.e(TAG, "Failed to initialize filter graph", e)
+            releaseResources()
+            throw e
+        }
+    }
+
+    // 声明资源和 pass 并编译；尺寸变化时重新执行（池中相同尺寸的图像会被复用）
+    private fun build() {
+        nativeReset(graph)
+        views.clear()
+
+        val resources = HashMap<String, Int>()
+        resources[INPUT] = GRAPH_INPUT
+        resources[OUTPUT] = GRAPH_OUTPUT
+
+        for (node in nodes) {
+            val input = resources[node.input]
+                ?: throw VulkanException("Pass reads '${node.input}' before it is written")
+
+            if (node.output == OUTPUT) {
+                node.width = surfaceWidth
+                node.height = surfaceHeight
+            } else {
+                node.width = (surfaceWidth * node.scale).roundToInt().coerceAtLeast(1)
+                node.height = (surfaceHeight * node.scale).roundToInt().coerceAtLeast(1)
+                if (node.output in resources) {
+                    throw VulkanException("Resource '${node.output}' is written twice")
+                }
+                val resource = nativeAddResource(graph, node.width, node.height)
+                if (resource < 0) {
+                    throw VulkanException("Failed to declare resource '${node.output}'")
+                }
+                resources[node.output] = resource
+            }
+
+            node.pass = nativeAddPass(graph, intArrayOf(input), resources.getValue(node.output))
+            if (node.pass < 0) {
+                throw VulkanException("Invalid pass ${node.input} -> ${node.output}")
+            }
+        }
+
+        if (!nativeCompile(graph)) {
+            throw VulkanException("Failed to compile filter graph")
+        }
+        for ((name, resource) in resources) {
+            if (resource > GRAPH_INPUT) {
+                views[name] = nativeGetResourceView(graph, resource)
+            }
+        }
+    }
+
+    override fun setSurfaceSize(width: Int, height: Int) {
+        if (width == surfaceWidth && height == surfaceHeight) {
+            return
+        }
+        surfaceWidth = width
+        surfaceHeight = height
+        if (isInitialized) {
+            build()
+            for (node in nodes) {
+                node.filter.setSurfaceSize(node.width, node.height)
+                forwardInputSize(node)
+            }
+        }
+    }
+
+    override fun setInputSize(width: Int, height: Int) {
+        inputWidth = width
+        inputHeight = height
+    }
+
+    // 读 [INPUT] 的节点收到 runner 的输入尺寸，读中间图像的节点收到写它的节点的输出尺寸
+    private fun forwardInputSize(node: Node) {
+        if (node.input == INPUT) {
+            node.filter.setInputSize(inputWidth, inputHeight)
+        } else {
+            nodes.firstOrNull { it.output == node.input }?.let {
+                node.filter.setInputSize(it.width, it.height)
+            }
+        }
+    }
+
+    private fun inputView(node: Node, inputTexture: Long): Long {
+        return if (node.input == INPUT) inputTexture else views[node.input] ?: 0L
+    }
+
+    private fun inputMatrix(node: Node, transformMatrix: FloatArray): FloatArray {
+        return if (node.input == INPUT) transformMatrix else IDENTITY
+    }
+
+    override fun prepare(commandBuffer: Long, inputTexture: Long, transformMatrix: FloatArray) {
+        if (!isInitialized) {
+            return
+        }
+
+        for (node in nodes) {
+            if (!nativeIsPassActive(graph, node.pass)) {
+                continue
+            }
+            val view = inputView(node, inputTexture)
+            val matrix = inputMatrix(node, transformMatrix)
+
+            // 节点自己的离屏 pass 必须在图的 pass 之外录制
+            node.filter.prepare(commandBuffer, view, matrix)
+            if (node.output == OUTPUT) {
+                continue
+            }
+            nativeBeginPass(commandBuffer, graph, node.pass)
+            node.filter.draw(commandBuffer, view, matrix)
+            nativeEndPass(commandBuffer, graph, node.pass)
+        }
+    }
+
+    override fun draw(commandBuffer: Long, inputTexture: Long, transformMatrix: FloatArray) {
+        if (!isInitialized) {
+            Log.e(TAG, "Filter graph not initialized!")
+            return
+        }
+        val node = nodes.firstOrNull { it.output == OUTPUT } ?: return
+        node.filter.draw(commandBuffer, inputView(node, inputTexture), inputMatrix(node, transformMatrix))
+    }
+
+    // 从输出沿输入链逐级组合；任一节点返回 null 时只能整帧重绘
+    override fun damageTransform(transformMatrix: FloatArray): FloatArray? {
+        var node = nodes.firstOrNull { it.output == OUTPUT } ?: return null
+        var result = node.filter.damageTransform(inputMatrix(node, transformMatrix)) ?: return null
+        while (node.input != INPUT) {
+            node = nodes.firstOrNull { it.output == node.input } ?: return null
+            val inner = node.filter.damageTransform(inputMatrix(node, transformMatrix)) ?: return null
+            result = multiply4x4(inner, result)
+        }
+        return result
+    }
+
+    override fun isAnimated(): Boolean = nodes.any { it.filter.isAnimated() }
+
+    override fun setQualityLevel(level: Int) {
+        nodes.forEach { it.filter.setQualityLevel(level) }
+    }
+
+    override fun isReady(): Boolean = isInitialized && nodes.all { it.filter.isReady() }
+
+    override fun awaitReady() {
+        nodes.forEach { it.filter.awaitReady() }
+    }
+
+    override fun release() {
+        if (!isInitialized) return
+        Log.d(TAG, "Releasing filter graph")
+        releaseResources()
+        isInitialized = false
+    }
+
+    // 节点先释放（它们的 descriptor set 引用中间图像），再销毁图和图像池
+    private fun releaseResources() {
+        nodes.forEach { it.filter.release() }
+        if (graph != 0L) {
+            nativeDestroy(graph)
+            graph = 0L
+        }
+        views.clear()
+    }
+
+    // 列主序 4x4 矩阵乘法：lhs * rhs
+    private fun multiply4x4(lhs: FloatArray, rhs: FloatArray): FloatArray {
+        val result = FloatArray(16)
+        for (col in 0 until 4) {
+            for (row in 0 until 4) {
+                var sum = 0f
+                for (k in 0 until 4) {
+                    sum += lhs[k * 4 + row] * rhs[col * 4 + k]
+                }
+                result[col * 4 + row] = sum
+            }
+        }
+        return result
+    }
+
+    // ==================== Native JNI Methods ====================
+
+    private external fun nativeCreate(device: Long): Long
+    private external fun nativeDestroy(graph: Long)
+    private external fun nativeReset(graph: Long)
+    private external fun nativeAddResource(graph: Long, width: Int, height: Int): Int
+    private external fun nativeAddPass(graph: Long, inputs: IntArray, output: Int): Int
+    private external fun nativeCompile(graph: Long): Boolean
+    private external fun nativeIsPassActive(graph: Long, pass: Int): Boolean
+    private external fun nativeGetResourceView(graph: Long, resource: Int): Long
+    private external fun nativeBeginPass(commandBuffer: Long, graph: Long, pass: Int)
+    private external fun nativeEndPass(commandBuffer: Long, graph: Long, pass: Int)
+
+    companion object {
+        private const val TAG = "FilterGraph"
+
+        const val INPUT = "input"
+        const val OUTPUT = "output"
+
+        // 与 Vulkanfiltergraph.h 中的 kGraphInput / kGraphOutput 一致
+        private const val GRAPH_INPUT = 0
+        private const val GRAPH_OUTPUT = -1
+
+        private val IDENTITY = floatArrayOf(
+            1f, 0f, 0f, 0f,
+            0f, 1f, 0f, 0f,
+            0f, 0f, 1f, 0f,
+            0f, 0f, 0f, 1f
+        )
+
+        // 线性链：INPUT → filters[0] → ... → filters[n-1] → OUTPUT，中间结果与输出同尺寸
+        @JvmStatic
+        fun chain(vararg filters: VulkanFilter): FilterGraph {
+            require(filters.isNotEmpty()) { "Empty filter chain" }
+            val graph = FilterGraph()
+            var input = INPUT
+            filters.forEachIndexed { index, filter ->
+                val output = if (index == filters.lastIndex) OUTPUT else "pass$index"
+                graph.addPass(filter, input, output)
+                input = output
+            }
+            return graph
+        }
+
+        init {
+            System.loadLibrary("myapplication")
+        }
+    }
+}
@@ -0,0 +1,482 @@
+package com.genymobile.scrcpy.vulkan
+
+import android.content.Context
+import android.util.Log
+import com.genymobile.scrcpy.util.AffineMatrix
+import java.io.File
+
+/**
+ * 融合链中的一个逐像素阶段（GLSL 约定见 Vulkanfusion.h）
+ *
+ * - [uv]：`vec2 f(vec2 uv)` 的函数体，uv 是本阶段输出像素的坐标，返回读取上一阶段的坐标；null 表示不变
+ * - [color]：`vec4 f(vec4 color, vec2 uv)` 的函数体，返回本阶段的输出颜色；null 表示不变
+ * - [params]：函数体中用 param(0)、param(1)... 读取的 vec4（长度为 4 的倍数）。每帧推送，
+ *   直接修改数组内容即可调参，不需要重新编译
+ * - [uvMatrix]：uv 是仿射变换时给出它的 4x4 列主序矩阵，用于脏矩形映射；
+ *   自定义 uv 没有给出矩阵时只能整帧重绘
+ */
+class FusionStage(
+    val name: String,
+    val uv: String? = null,
+    val color: String? = null,
+    val params: FloatArray = FloatArray(0),
+    val uvMatrix: FloatArray? = null
+) {
+    init {
+        require(params.size % 4 == 0) { "Parameters of stage '$name' must be whole vec4s" }
+    }
+
+    val paramCount: Int
+        get() = params.size / 4
+
+    companion object {
+        // 亮度（加）、对比度（围绕 0.5 缩放）、饱和度（与亮度混合）
+        @JvmStatic
+        fun color(brightness: Float = 0f, contrast: Float = 1f, saturation: Float = 1f) = FusionStage(
+            "color",
+            color = """
+                vec3 c = (color.rgb - 0.5) * param(0).y + 0.5 + param(0).x;
+                float luma = dot(c, vec3(0.2126, 0.7152, 0.0722));
+                return vec4(clamp(mix(vec3(luma), c, param(0).z), 0.0, 1.0), color.a);
+            """.trimIndent(),
+            params = floatArrayOf(brightness, contrast, saturation, 0f)
+        )
+
+        // 与 AffineVulkanFilter 的 userTransform 含义相同：输出坐标 -> 输入坐标
+        @JvmStatic
+        fun affine(transform: AffineMatrix): FusionStage {
+            val m = transform.to4x4()
+            return FusionStage(
+                "affine",
+                uv = "return vec2(dot(param(0).xyz, vec3(uv, 1.0)), dot(param(1).xyz, vec3(uv, 1.0)));",
+                params = floatArrayOf(m[0], m[4], m[12], 0f, m[1], m[5], m[13], 0f),
+                uvMatrix = m
+            )
+        }
+
+        // 暗角：到中心的归一化距离超过 radius 后在 softness 内逐渐变暗到 1 - strength
+        @JvmStatic
+        fun vignette(strength: Float = 0.5f, radius: Float = 0.5f, softness: Float = 0.5f) = FusionStage(
+            "vignette",
+            color = """
+                float d = distance(uv, vec2(0.5)) * 1.41421356;
+                float v = 1.0 - param(0).x * smoothstep(param(0).y, param(0).y + param(0).z, d);
+                return vec4(color.rgb * v, color.a);
+            """.trimIndent(),
+            params = floatArrayOf(strength, radius, softness, 0f)
+        )
+    }
+}
+
+/**
+ * 融合滤镜：把一串逐像素阶段合并成一个着色器，一个 pass 完成整条链
+ *
+ * 逐级执行（[unfused]）时每一级都要把整帧写入中间图像再读回；融合后只读一次输入、写一次输出。
+ * 着色器在 init 时运行时生成并编译（Vulkanfusion.h），SPIR-V 按链的 hash 缓存在
+ * `cacheDir/fusion`，同一条链之后启动直接加载。参数（[FusionStage.params]）每帧推送，调参不需要重新编译。
+ * shaderc 随 native 库一起构建（CMakeLists.txt 固定版本）；native 库不含融合滤镜时（旧版本）[isAvailable] 为 false。
+ *
+ * 支持计算路径（[enableCompute]）：同一条链生成计算着色器，按脏矩形 dispatch 直接写输出图像。
+ *
+ * 使用示例：
+ * ```
+ * val filter = FusedVulkanFilter(context, listOf(
+ *     FusionStage.color(contrast = 1.1f, saturation = 1.2f),
+ *     FusionStage.affine(AffineMatrix.scale(0.5, 0.5).fromCenter()),
+ *     FusionStage.vignette(strength = 0.4f)
+ * ))
+ * val runner = VulkanRunner(filter)
+ *
+ * // 与逐级执行对比带宽（见 VulkanBenchmarks.benchmarkFusion）
+ * VulkanBenchmarks(runner).benchmarkFusion(FusedVulkanFilter(context, filter.stages))
+ * ```
+ */
+class FusedVulkanFilter(
+    private val context: Context,
+    stages: List<FusionStage>
+) : VulkanFilter {
+
+    val stages: List<FusionStage> = stages.toList()
+
+    // 各阶段参数在 push constant params[] 中的起始下标
+    private val paramOffsets: IntArray
+
+    private var vkDevice: Long = 0
+    private var pipelineFuture: PipelineFuture? = null
+    private var layout: ReflectedLayout? = null
+    private var descriptors: DescriptorManager? = null
+    private var vkSampler: Long = 0
+
+    private var vertexShaderModule: Long = 0
+    private var fragmentShaderModule: Long = 0
+
+    // 计算路径（enableCompute() 之后 init 创建；任一步失败只保留光栅化路径）
+    private var computeRequested = false
+    private var computeShaderModule: Long = 0
+    private var computeLayout: ReflectedLayout? = null
+    private var computeFuture: PipelineFuture? = null
+    private var computeDescriptors: DescriptorManager? = null
+
+    private var isInitialized = false
+    private val constants = FloatArray(PUSH_CONSTANT_SIZE / 4)
+
+    init {
+        require(this.stages.isNotEmpty()) { "Empty fusion chain" }
+        var offset = 0
+        paramOffsets = IntArray(this.stages.size) { index ->
+            val start = offset
+            offset += this.stages[index].paramCount
+            start
+        }
+        require(offset <= MAX_PARAMS) { "Fusion chain uses $offset parameters, at most $MAX_PARAMS supported" }
+    }
+
+    // 逐级执行的等价滤镜图（每个阶段单独一个 pass），用于对比和不能融合时的参考
+    fun unfused(): FilterGraph {
+        val filters = stages.map { FusedVulkanFilter(context, listOf(it)) }
+        return FilterGraph.chain(*filters.toTypedArray())
+    }
+
+    override fun init(device: Long, renderPass: Long) {
+        if (isInitialized) {
+            Log.w(TAG, "Already initialized")
+            return
+        }
+
+        this.vkDevice = device
+        Log.d(TAG, "=== Initializing FusedVulkanFilter (${describe()}) ===")
+        if (!isAvailable) {
+            throw VulkanException("Filter fusion not available: native library built without Vulkanfusion.cpp")
+        }
+
+        try {
+            // 1. 生成并编译（或从缓存加载）融合着色器
+            val vertexShaderCode = compile(KIND_VERTEX)
+            val fragmentShaderCode = compile(KIND_FRAGMENT)
+            Log.d(TAG, "✓ Fused shaders ready: vert=${vertexShaderCode.size} bytes, frag=${fragmentShaderCode.size} bytes")
+
+            // 2. Create shader modules
+            vertexShaderModule = nativeCreateShaderModule(device, vertexShaderCode)
+            fragmentShaderModule = nativeCreateShaderModule(device, fragmentShaderCode)
+            if (vertexShaderModule == 0L || fragmentShaderModule == 0L) {
+                throw VulkanException("Failed to create shader modules")
+            }
+
+            // 3. sampler 固定不变，先创建再固化进 layout
+            vkSampler = nativeCreateSampler(device)
+            if (vkSampler == 0L) {
+                throw VulkanException("Failed to create sampler")
+            }
+
+            // 4. 反射 layout（输入纹理在 set 0，push constant 固定 128 字节）
+            val reflected = ReflectedLayout(
+                device, vertexShaderCode, fragmentShaderCode,
+                pushDescriptorSet = 0,
+                immutableSamplers = listOf(ReflectedLayout.ImmutableSampler(0, 0, vkSampler))
+            )
+            layout = reflected
+            if (reflected.descriptorSetLayout(0) == 0L) {
+                throw VulkanException("Fused shader does not declare the input texture at set 0")
+            }
+            if (reflected.pushConstantSize < PUSH_CONSTANT_SIZE) {
+                throw VulkanException("Push constant block is ${reflected.pushConstantSize} bytes, expected $PUSH_CONSTANT_SIZE")
+            }
+
+            // 5. 后台编译 pipeline
+            pipelineFuture = PipelineFuture(
+                device,
+                renderPass,
+                reflected.pipelineLayout,
+                vertexShaderModule,
+                fragmentShaderModule,
+                ShaderVariant()
+            )
+
+            // 6. Descriptor 管理
+            descriptors = DescriptorManager(device, reflected)
+
+            // 7. 计算 pipeline（可选）
+            if (computeRequested) {
+                initCompute(device)
+            }
+
+            isInitialized = true
+            Log.i(TAG, "=== FusedVulkanFilter initialized successfully ===")
+
+        } catch (e: Exception) {
+            Log.e(TAG, "Failed to initialize fused filter", e)
+            releaseResources()
+            throw e
+        }
+    }
+
+    private fun compile(kind: Int): ByteArray {
+        return nativeCompile(
+            cacheDirectory()?.absolutePath,
+            stages.map { it.uv }.toTypedArray(),
+            stages.map { it.color }.toTypedArray(),
+            paramOffsets,
+            stages.map { it.paramCount }.toIntArray(),
+            kind
+        ) ?: throw VulkanException("Failed to compile fused shader (${describe()})")
+    }
+
+    private fun cacheDirectory(): File? {
+        val dir = File(context.cacheDir, CACHE_DIR)
+        return if (dir.isDirectory || dir.mkdirs()) dir else null
+    }
+
+    private fun describe(): String = stages.joinToString(" → ") { it.name }
+
+    override fun draw(commandBuffer: Long, inputTexture: Long, transformMatrix: FloatArray) {
+        if (!isInitialized) {
+            Log.e(TAG, "Filter not initialized!")
+            return
+        }
+        if (inputTexture == 0L) {
+            Log.e(TAG, "Invalid input texture: 0")
+            return
+        }
+
+        val layout = layout ?: return
+        val pipeline = pipelineFuture?.pipeline() ?: 0L
+        if (pipeline == 0L) {
+            Log.e(TAG, "Graphics pipeline not compiled yet")
+            return
+        }
+
+        val descriptors = descriptors ?: return
+        if (!descriptors.bind(commandBuffer, false, layout.pipelineLayout, inputTexture, vkSampler)) {
+            return
+        }
+        packConstants(transformMatrix)
+        nativeDraw(commandBuffer, pipeline, layout.pipelineLayout, layout.pushConstantStages, constants)
+    }
+
+    // tex_transform 取 SurfaceTexture 矩阵的前两行（只有 2D 仿射部分），region 由 native 端按矩形填写
+    private fun packConstants(transformMatrix: FloatArray) {
+        val m = if (transformMatrix.size >= 16) transformMatrix else IDENTITY
+        constants.fill(0f)
+        constants[0] = m[0]; constants[1] = m[4]; constants[2] = m[12]
+        constants[4] = m[1]; constants[5] = m[5]; constants[6] = m[13]
+        stages.forEachIndexed { index, stage ->
+            System.arraycopy(stage.params, 0, constants, PARAMS_OFFSET + paramOffsets[index] * 4, stage.params.size)
+        }
+    }
+
+    // 输出图像随尺寸重建，旧视图的句柄可能被新视图复用
+    override fun setSurfaceSize(width: Int, height: Int) {
+        computeDescriptors?.invalidate()
+    }
+
+    override fun setInputSize(width: Int, height: Int) {
+        descriptors?.invalidate()
+        computeDescriptors?.invalidate()
+    }
+
+    override fun isReady(): Boolean = (pipelineFuture?.pipeline() ?: 0L) != 0L
+
+    override fun awaitReady() {
+        pipelineFuture?.await()
+    }
+
+    override fun enableCompute(): Boolean {
+        computeRequested = true
+        return true
+    }
+
+    override fun isComputeReady(): Boolean = (computeFuture?.pipeline() ?: 0L) != 0L
+
+    private fun initCompute(device: Long) {
+        try {
+            val computeShaderCode = compile(KIND_COMPUTE)
+            computeShaderModule = nativeCreateShaderModule(device, computeShaderCode)
+            if (computeShaderModule == 0L) {
+                throw VulkanException("Failed to create compute shader module")
+            }
+
+            val reflected = ReflectedLayout(
+                device, computeShaderCode,
+                pushDescriptorSet = 0,
+                immutableSamplers = listOf(ReflectedLayout.ImmutableSampler(0, 0, vkSampler))
+            )
+            computeLayout = reflected
+            if (reflected.descriptorSetLayout(0) == 0L) {
+                throw VulkanException("Fused compute shader does not declare its images at set 0")
+            }
+
+            computeFuture = PipelineFuture(device, reflected.pipelineLayout, computeShaderModule, ShaderVariant())
+            computeDescriptors = DescriptorManager(device, reflected)
+            Log.d(TAG, "✓ Fused compute pipeline submitted for compilation")
+        } catch (e: Exception) {
+            Log.w(TAG, "Compute path unavailable, using graphics pipeline only", e)
+            releaseCompute()
+        }
+    }
+
+    override fun dispatch(
+        commandBuffer: Long,
+        inputTexture: Long,
+        transformMatrix: FloatArray,
+        outputImage: Long,
+        rects: IntArray
+    ) {
+        val computeLayout = computeLayout ?: return
+        val pipeline = computeFuture?.pipeline() ?: 0L
+        if (!isInitialized || pipeline == 0L || inputTexture == 0L || outputImage == 0L) {
+            return
+        }
+
+        val descriptors = computeDescriptors ?: return
+        if (!descriptors.bind(commandBuffer, true, computeLayout.pipelineLayout, inputTexture, vkSampler, outputImage)) {
+            return
+        }
+        packConstants(transformMatrix)
+        nativeDispatch(commandBuffer, pipeline, computeLayout.pipelineLayout, computeLayout.pushConstantStages,
+            constants, rects)
+    }
+
+    // 输入坐标 = tex_matrix * M0 * M1 * ... * M(n-1) * 输出坐标（各阶段的 uv 逆序作用于输出坐标）
+    override fun damageTransform(transformMatrix: FloatArray): FloatArray? {
+        var result = if (transformMatrix.size >= 16) transformMatrix else IDENTITY
+        for (stage in stages) {
+            if (stage.uv != null) {
+                val m = stage.uvMatrix ?: return null
+                result = multiply4x4(result, m)
+            }
+        }
+        return result
+    }
+
+    // 列主序 4x4 矩阵乘法：lhs * rhs
+    private fun multiply4x4(lhs: FloatArray, rhs: FloatArray): FloatArray {
+        val result = FloatArray(16)
+        for (col in 0 until 4) {
+            for (row in 0 until 4) {
+                var sum = 0f
+                for (k in 0 until 4) {
+                    sum += lhs[k * 4 + row] * rhs[col * 4 + k]
+                }
+                result[col * 4 + row] = sum
+            }
+        }
+        return result
+    }
+
+    override fun release() {
+        if (!isInitialized) return
+        Log.d(TAG, "Releasing fused filter")
+        releaseResources()
+        isInitialized = false
+    }
+
+    private fun releaseCompute() {
+        computeDescriptors?.release()
+        computeDescriptors = null
+        computeFuture?.release()
+        computeFuture = null
+        computeLayout?.release()
+        computeLayout = null
+        if (computeShaderModule != 0L) {
+            nativeDestroyShaderModule(vkDevice, computeShaderModule)
+            computeShaderModule = 0L
+        }
+    }
+
+    private fun releaseResources() {
+        descriptors?.release()
+        descriptors = null
+        // 计算 set 引用 sampler，先释放（sampler 本身由设备级缓存保留到设备销毁，layout 中的引用始终有效）
+        releaseCompute()
+        if (vkSampler != 0L) {
+            nativeDestroySampler(vkDevice, vkSampler)
+            vkSampler = 0L
+        }
+        // 先取消/等待编译任务，之后才能销毁它引用的 layout 和 shader module
+        pipelineFuture?.release()
+        pipelineFuture = null
+        layout?.release()
+        layout = null
+        if (vertexShaderModule != 0L) {
+            nativeDestroyShaderModule(vkDevice, vertexShaderModule)
+            vertexShaderModule = 0L
+        }
+        if (fragmentShaderModule != 0L) {
+            nativeDestroyShaderModule(vkDevice, fragmentShaderModule)
+            fragmentShaderModule = 0L
+        }
+    }
+
+    // ==================== Native JNI Methods ====================
+
+    private external fun nativeCompile(
+        cacheDir: String?,
+        uvSnippets: Array<String?>,
+        colorSnippets: Array<String?>,
+        paramOffsets: IntArray,
+        paramCounts: IntArray,
+        kind: Int
+    ): ByteArray?
+    private external fun nativeCreateShaderModule(device: Long, code: ByteArray): Long
+    private external fun nativeDestroyShaderModule(device: Long, shaderModule: Long)
+    private external fun nativeCreateSampler(device: Long): Long
+    private external fun nativeDestroySampler(device: Long, sampler: Long)
+    private external fun nativeDraw(
+        commandBuffer: Long,
+        pipeline: Long,
+        pipelineLayout: Long,
+        stageFlags: Int,
+        constants: FloatArray
+    )
+    private external fun nativeDispatch(
+        commandBuffer: Long,
+        pipeline: Long,
+        pipelineLayout: Long,
+        stageFlags: Int,
+        constants: FloatArray,
+        rects: IntArray
+    )
+
+    companion object {
+        private const val TAG = "FusedVulkanFilter"
+
+        /**
+         * native 库是否包含融合滤镜：当前的 CMakeLists.txt 总是编译它，
+         * 加载的 native 库里没有这个方法时为 false，不能创建融合滤镜
+         */
+        @JvmStatic
+        val isAvailable: Boolean by lazy {
+            try {
+                nativeIsCompilerAvailable()
+            } catch (e: UnsatisfiedLinkError) {
+                false
+            }
+        }
+
+        @JvmStatic
+        private external fun nativeIsCompilerAvailable(): Boolean
+
+        private const val CACHE_DIR = "fusion"
+
+        // 与 Vulkanfusion.h 的 FusionShaderKind 一致
+        private const val KIND_VERTEX = 0
+        private const val KIND_FRAGMENT = 1
+        private const val KIND_COMPUTE = 2
+
+        // 与 Vulkanfusion.h 的 kFusionPushConstantSize / kFusionMaxParams 一致
+        private const val PUSH_CONSTANT_SIZE = 128
+        private const val PARAMS_OFFSET = 12  // tex_transform[2] + region 之后（float 下标）
+        const val MAX_PARAMS = 5
+
+        private val IDENTITY = floatArrayOf(
+            1f, 0f, 0f, 0f,
+            0f, 1f, 0f, 0f,
+            0f, 0f, 1f, 0f,
+            0f, 0f, 0f, 1f
+        )
+
+        init {
+            System.loadLibrary("myapplication")
+        }
+    }
+}
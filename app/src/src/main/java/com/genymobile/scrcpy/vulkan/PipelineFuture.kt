@@ -0,0 +1,130 @@
+package com.genymobile.scrcpy.vulkan
+
+/**
+ * 在设备的后台编译线程上创建的滤镜 pipeline（全屏三角形图形 pipeline 或计算 pipeline）
+ *
+ * 构造时只提交任务，不等待驱动编译 shader。渲染线程每帧用 [pipeline] 查询，
+ * 返回 0 表示还没编译好（此时 runner 用直通滤镜绘制）。
+ * pipeline 归 future 所有，由 [release] 释放；引用的 render pass / layout / shader module
+ * 必须在 [release] 之后才能销毁。renderPass 为 0 时按动态渲染创建（见 VulkanFilter.init）。
+ *
+ * 使用示例：
+ * ```
+ * val future = PipelineFuture(device, renderPass, pipelineLayout, vert, frag, variant)
+ * ...
+ * val pipeline = future.pipeline()
+ * if (pipeline != 0L) nativeBindPipeline(commandBuffer, pipeline)
+ *
+ * // 计算滤镜：只需要 layout 和 compute shader module
+ * val computeFuture = PipelineFuture(device, pipelineLayout, compute, variant)
+ * ```
+ */
+class PipelineFuture private constructor(
+    private val device: Long,
+    request: Request
+) {
+    private sealed class Request(val pipelineLayout: Long, val variant: ShaderVariant) {
+        class Fullscreen(
+            val renderPass: Long,
+            pipelineLayout: Long,
+            val vertShaderModule: Long,
+            val fragShaderModule: Long,
+            variant: ShaderVariant
+        ) : Request(pipelineLayout, variant)
+
+        class Compute(
+            pipelineLayout: Long,
+            val computeShaderModule: Long,
+            variant: ShaderVariant
+        ) : Request(pipelineLayout, variant)
+    }
+
+    constructor(
+        device: Long,
+        renderPass: Long,
+        pipelineLayout: Long,
+        vertShaderModule: Long,
+        fragShaderModule: Long,
+        variant: ShaderVariant = ShaderVariant()
+    ) : this(device, Request.Fullscreen(renderPass, pipelineLayout, vertShaderModule, fragShaderModule, variant))
+
+    constructor(
+        device: Long,
+        pipelineLayout: Long,
+        computeShaderModule: Long,
+        variant: ShaderVariant = ShaderVariant()
+    ) : this(device, Request.Compute(pipelineLayout, computeShaderModule, variant))
+
+    private var handle: Long = when (request) {
+        is Request.Fullscreen -> nativeCompileFullscreen(
+            device,
+            request.renderPass,
+            request.pipelineLayout,
+            request.vertShaderModule,
+            request.fragShaderModule,
+            request.variant.toIntArray()
+        )
+        is Request.Compute -> nativeCompileCompute(
+            device,
+            request.pipelineLayout,
+            request.computeShaderModule,
+            request.variant.toIntArray()
+        )
+    }
+
+    init {
+        if (handle == 0L) {
+            throw VulkanException("Failed to submit pipeline compilation")
+        }
+    }
+
+    // 编译完成（成功或失败）
+    val isDone: Boolean
+        get() = handle == 0L || nativeGetState(handle) != STATE_PENDING
+
+    val isFailed: Boolean
+        get() = handle == 0L || nativeGetState(handle) == STATE_FAILED
+
+    // 不阻塞：编译完成前返回 0
+    fun pipeline(): Long = if (handle == 0L) 0L else nativeGetPipeline(handle)
+
+    // 阻塞直到编译完成，失败返回 0
+    fun await(): Long = if (handle == 0L) 0L else nativeWait(handle)
+
+    // 取消或等待正在进行的编译，释放 pipeline
+    fun release() {
+        if (handle != 0L) {
+            nativeDestroy(device, handle)
+            handle = 0L
+        }
+    }
+
+    private external fun nativeCompileFullscreen(
+        device: Long,
+        renderPass: Long,
+        pipelineLayout: Long,
+        vertShaderModule: Long,
+        fragShaderModule: Long,
+        specConstants: IntArray?
+    ): Long
+    private external fun nativeCompileCompute(
+        device: Long,
+        pipelineLayout: Long,
+        computeShaderModule: Long,
+        specConstants: IntArray?
+    ): Long
+    private external fun nativeGetState(future: Long): Int
+    private external fun nativeGetPipeline(future: Long): Long
+    private external fun nativeWait(future: Long): Long
+    private external fun nativeDestroy(device: Long, future: Long)
+
+    companion object {
+        // 与 Vulkanpipelinecompiler.h 中的 PipelineFutureState 一致
+        private const val STATE_PENDING = 0
+        private const val STATE_FAILED = 2
+
+        init {
+            System.loadLibrary("myapplication")
+        }
+    }
+}
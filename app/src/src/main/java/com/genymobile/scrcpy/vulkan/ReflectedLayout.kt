@@ -0,0 +1,120 @@
+package com.genymobile.scrcpy.vulkan
+
+/**
+ * 从 SPIR-V 反射得到的 pipeline layout
+ *
+ * 滤镜不再手写 descriptor set layout 和 push constant 范围：把各 stage 的 SPIR-V 字节码
+ * 交给 native 层解析，按接口签名在设备级缓存中查找或创建 layout。
+ * 接口相同的滤镜共享同一个 VkPipelineLayout。layout 归设备缓存所有，[release] 只减少引用。
+ *
+ * [pushDescriptorSet] 请求把某个 set 创建为 push set（VK_KHR_push_descriptor）；设备不支持时照常创建，
+ * 实际结果见同名属性（-1 表示没有 push set），[DescriptorManager] 据此选择绑定方式。
+ *
+ * [immutableSamplers] 把固定不变的 sampler 固化进 set layout（必须来自各滤镜的 nativeCreateSampler，
+ * 它们由设备级 sampler 缓存持有，见 Vulkansamplers.h）。sampler 在 layout 之前创建。
+ *
+ * shader 声明 `uniform sampler2D sources[]`（set 内唯一的 binding 0）时该 set 使用设备的 bindless 表，
+ * 见 [bindlessSet] 和 [BindlessTable]；设备不支持描述符索引时创建失败。
+ *
+ * 使用示例：
+ * ```
+ * val layout = ReflectedLayout(device, vertCode, fragCode)
+ * val setLayout = layout.descriptorSetLayout(0)   // 没有 set 0 时为 0
+ * nativePushConstants(commandBuffer, layout.pipelineLayout, layout.pushConstantStages, data)
+ * ```
+ */
+class ReflectedLayout(
+    private val device: Long,
+    vararg spirv: ByteArray,
+    pushDescriptorSet: Int = -1,
+    immutableSamplers: List<ImmutableSampler> = emptyList()
+) {
+    // (set, binding) 上固化的 sampler；binding 必须是单个 sampler 或 combined image sampler
+    data class ImmutableSampler(val set: Int, val binding: Int, val sampler: Long)
+
+    private var handle: Long = 0L
+
+    var pipelineLayout: Long = 0L
+        private set
+
+    // vkCmdPushConstants 必须使用的 stage 标志
+    var pushConstantStages: Int = 0
+        private set
+
+    var pushConstantSize: Int = 0
+        private set
+
+    private var setLayouts: LongArray = LongArray(0)
+
+    // 以 push descriptor 方式更新的 set；没有时为 -1
+    var pushDescriptorSet: Int = -1
+        private set
+
+    // 使用 bindless 表 layout 的 set（由 [BindlessTable.bind] 绑定）；没有时为 -1
+    var bindlessSet: Int = -1
+        private set
+
+    // shader 声明的特化常量：constant_id → 默认值（32 位位模式）
+    var specConstants: Map<Int, Int> = emptyMap()
+        private set
+
+    init {
+        val samplerTriples = LongArray(immutableSamplers.size * 3)
+        immutableSamplers.forEachIndexed { i, entry ->
+            samplerTriples[i * 3] = entry.set.toLong()
+            samplerTriples[i * 3 + 1] = entry.binding.toLong()
+            samplerTriples[i * 3 + 2] = entry.sampler
+        }
+        val values = nativeAcquire(device, arrayOf(*spirv), pushDescriptorSet, samplerTriples)
+            ?: throw VulkanException("Failed to create pipeline layout from SPIR-V reflection")
+
+        var index = 0
+        handle = values[index++]
+        pipelineLayout = values[index++]
+        pushConstantStages = values[index++].toInt()
+        pushConstantSize = values[index++].toInt()
+
+        val setCount = values[index++].toInt()
+        setLayouts = LongArray(setCount) { values[index + it] }
+        index += setCount
+
+        val specCount = values[index++].toInt()
+        val constants = LinkedHashMap<Int, Int>(specCount)
+        repeat(specCount) {
+            constants[values[index].toInt()] = values[index + 1].toInt()
+            index += 2
+        }
+        specConstants = constants
+        this.pushDescriptorSet = values[index++].toInt()
+        bindlessSet = values[index].toInt()
+    }
+
+    val setCount: Int
+        get() = setLayouts.size
+
+    // set 号对应的 descriptor set layout，shader 未使用该 set 时返回 0
+    fun descriptorSetLayout(set: Int): Long = setLayouts.getOrElse(set) { 0L }
+
+    fun release() {
+        if (handle != 0L) {
+            nativeRelease(device, handle)
+            handle = 0L
+            pipelineLayout = 0L
+            setLayouts = LongArray(0)
+        }
+    }
+
+    private external fun nativeAcquire(
+        device: Long,
+        spirvModules: Array<ByteArray>,
+        pushDescriptorSet: Int,
+        immutableSamplers: LongArray
+    ): LongArray?
+    private external fun nativeRelease(device: Long, layout: Long)
+
+    companion object {
+        init {
+            System.loadLibrary("myapplication")
+        }
+    }
+}
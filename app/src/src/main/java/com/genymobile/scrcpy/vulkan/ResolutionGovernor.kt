@@ -0,0 +1,152 @@
+package com.genymobile.scrcpy.vulkan
+
+import kotlin.math.max
+import kotlin.math.min
+import kotlin.math.roundToInt
+import kotlin.math.sqrt
+
+/**
+ * 动态分辨率控制器：根据测得的 GPU 帧时间调整渲染缩放比例
+ *
+ * 纯策略逻辑，不依赖 Vulkan，可以用合成的时间序列做单元测试。
+ *
+ * - GPU 时间先做指数平滑
+ * - 平滑值超过 [highWatermark] × 预算连续 [downFrames] 帧则降分辨率，
+ *   低于 [lowWatermark] × 预算连续 [upFrames] 帧则升分辨率，两者之间不动（滞回）
+ * - 着色开销近似与像素数（scale²）成正比，据此直接估算使负载回到 [targetLoad] 的比例
+ * - 每次调整后忽略 [cooldownFrames] 个样本：在途的帧仍是旧分辨率
+ *
+ * 使用示例：
+ * ```
+ * val governor = ResolutionGovernor(frameBudgetMs = 16.6)
+ * val scale = governor.update(gpuTimeMs)
+ * val width = governor.scaledLength(outputWidth)
+ * ```
+ */
+class ResolutionGovernor @JvmOverloads constructor(
+    val frameBudgetMs: Double = 16.6,
+    val minScale: Float = 0.5f,
+    val maxScale: Float = 1.0f,
+    private val targetLoad: Double = 0.8,
+    private val highWatermark: Double = 0.95,
+    private val lowWatermark: Double = 0.6,
+    private val downFrames: Int = 3,
+    private val upFrames: Int = 30,
+    private val cooldownFrames: Int = 4,
+    private val smoothing: Double = 0.25
+) {
+    init {
+        require(frameBudgetMs > 0) { "frameBudgetMs must be positive" }
+        require(minScale > 0f && minScale <= maxScale) { "Invalid scale range [$minScale, $maxScale]" }
+        require(lowWatermark < targetLoad && targetLoad < highWatermark) {
+            "targetLoad must lie between the watermarks"
+        }
+    }
+
+    /** 当前渲染缩放比例 */
+    var scale: Float = maxScale
+        private set
+
+    /** 平滑后的 GPU 时间（毫秒），尚无样本时为 0 */
+    var smoothedGpuTimeMs: Double = 0.0
+        private set
+
+    private var hasSample = false
+    private var overCount = 0
+    private var underCount = 0
+    private var cooldown = 0
+
+    /**
+     * 输入一帧的 GPU 时间（毫秒），返回新的缩放比例
+     * 负数或 NaN 表示本帧没有测量结果，忽略
+     */
+    fun update(gpuTimeMs: Double): Float {
+        if (gpuTimeMs.isNaN() || gpuTimeMs < 0.0) {
+            return scale
+        }
+        if (cooldown > 0) {
+            cooldown--
+            return scale
+        }
+
+        smoothedGpuTimeMs = if (hasSample) {
+            smoothedGpuTimeMs + smoothing * (gpuTimeMs - smoothedGpuTimeMs)
+        } else {
+            gpuTimeMs
+        }
+        hasSample = true
+
+        val load = smoothedGpuTimeMs / frameBudgetMs
+        when {
+            load > highWatermark -> {
+                overCount++
+                underCount = 0
+            }
+            load < lowWatermark -> {
+                underCount++
+                overCount = 0
+            }
+            else -> {
+                overCount = 0
+                underCount = 0
+            }
+        }
+
+        if (overCount >= downFrames && scale > minScale) {
+            adjust(load, down = true)
+        } else if (underCount >= upFrames && scale < maxScale) {
+            adjust(load, down = false)
+        }
+        return scale
+    }
+
+    /** 按当前比例缩放一个输出尺寸，至少为 1 */
+    fun scaledLength(length: Int): Int {
+        return max(1, (length * scale).roundToInt())
+    }
+
+    /** 按最大比例缩放一个输出尺寸（离屏图像的分配尺寸），至少为 1 */
+    fun maxLength(length: Int): Int {
+        return max(1, (length * maxScale).roundToInt())
+    }
+
+    fun reset() {
+        scale = maxScale
+        smoothedGpuTimeMs = 0.0
+        hasSample = false
+        overCount = 0
+        underCount = 0
+        cooldown = 0
+    }
+
+    private fun adjust(load: Double, down: Boolean) {
+        val ideal = scale * sqrt(targetLoad / max(load, 1e-3)).toFloat()
+        var next = if (down) {
+            min(quantize(ideal), scale - STEP)
+        } else {
+            // 升分辨率保守一些，避免一步越过预算
+            max(quantize(min(ideal, scale + MAX_STEP_UP)), scale + STEP)
+        }
+        next = next.coerceIn(minScale, maxScale)
+
+        if (next != scale) {
+            // 平滑值按像素数比例换算到新分辨率，避免冷却结束后用旧数据再次调整
+            val ratio = next / scale
+            smoothedGpuTimeMs *= (ratio * ratio).toDouble()
+            scale = next
+            cooldown = cooldownFrames
+        }
+        overCount = 0
+        underCount = 0
+    }
+
+    private fun quantize(value: Float): Float {
+        return (value / STEP).roundToInt() * STEP
+    }
+
+    companion object {
+        // 缩放比例的粒度，避免微小变化导致频繁重建状态
+        private const val STEP = 1f / 32f
+        private const val MAX_STEP_UP = 0.25f
+    }
+}
@@ -26,18 +26,17 @@ object ShaderLoader {
 
 class SimpleVulkanFilter(private val context: Context) : VulkanFilter {
     private var vkDevice: Long = 0
-    private var vkPipeline: Long = 0
+    private var vkRenderPass: Long = 0
+    private var layout: ReflectedLayout? = null
     private var vkPipelineLayout: Long = 0
-    private var vkDescriptorSetLayout: Long = 0
-    private var vkDescriptorPool: Long = 0
-    private var vkDescriptorSet: Long = 0
+    private var pushConstantStages: Int = 0
+    private var descriptors: DescriptorManager? = null  // b.frag 不采样输入纹理时为 null
     private var vkSampler: Long = 0
 
     private var vertexShaderModule: Long = 0
     private var fragmentShaderModule: Long = 0
 
     private var isInitialized = false
-    private var currentTextureView: Long = 0
 
     // 添加：时间跟踪
     private val startTimeNanos = System.nanoTime()
@@ -46,6 +45,14 @@ class SimpleVulkanFilter(private val context: Context) : VulkanFilter {
     private var surfaceWidth: Int = 1920
     private var surfaceHeight: Int = 1080
 
+    // 特化常量变体：每个变体的 pipeline 在第一次使用时提交到后台编译，之后切换不再编译
+    private val pipelines = HashMap<ShaderVariant, PipelineFuture>()
+    private var lastPipeline: Long = 0  // 最近一个已编译好的变体，新变体编译期间继续使用
+    private var qualityLevel = VulkanFilter.QUALITY_HIGH
+
+    // 调试用：显示平铺边框（SHOW_TILING 特化常量），可以随时切换
+    var showTiling: Boolean = false
+
     override fun init(device: Long, renderPass: Long) {
         if (isInitialized) {
             Log.w(TAG, "Already initialized")
@@ -53,6 +60,7 @@ class SimpleVulkanFilter(private val context: Context) : VulkanFilter {
         }
 
         this.vkDevice = device
+        this.vkRenderPass = renderPass
         Log.d(TAG, "=== Initializing SimpleVulkanFilter ===")
 
         try {
@@ -70,58 +78,21 @@ class SimpleVulkanFilter(private val context: Context) : VulkanFilter {
             }
             Log.d(TAG, "✓ Shader modules created")
 
-            // 3. Create descriptor set layout
-            vkDescriptorSetLayout = nativeCreateDescriptorSetLayout(device)
-            if (vkDescriptorSetLayout == 0L) {
-                throw VulkanException("Failed to create descriptor set layout")
-            }
-            Log.d(TAG, "✓ Descriptor set layout created")
-
-            // 4. Create pipeline layout (修改：包含Push Constants配置)
-            vkPipelineLayout =  nativeCreatePipelineLayout(device, vkDescriptorSetLayout)
-            if (vkPipelineLayout == 0L) {
-                throw VulkanException("Failed to create pipeline layout")
-            }
-            Log.d(TAG, "✓ Pipeline layout created with Push Constants support")
+            // 3-4. 从 SPIR-V 反射 descriptor set layout 和 pipeline layout（含 Push Constants 范围）
+            val reflected = ReflectedLayout(device, vertexShaderCode, fragmentShaderCode, pushDescriptorSet = 0)
+            layout = reflected
+            vkPipelineLayout = reflected.pipelineLayout
+            pushConstantStages = reflected.pushConstantStages
+            checkSpecConstants(reflected)
+            Log.d(TAG, "✓ Pipeline layout reflected: ${reflected.setCount} sets, push constants ${reflected.pushConstantSize} bytes")
 
-            // 5. Create graphics pipeline
-            vkPipeline = nativeCreateGraphicsPipeline(
-                device,
-                renderPass,
-                vkPipelineLayout,
-                vertexShaderModule,
-                fragmentShaderModule
-            )
-            if (vkPipeline == 0L) {
-                throw VulkanException("Failed to create graphics pipeline")
-            }
-            Log.d(TAG, "✓ Graphics pipeline created")
+            // 5. 提交当前画质档位变体的编译任务（后台线程，不等待）
+            pipelineFor(currentVariant())
 
-            // 6. Create descriptor pool
-            vkDescriptorPool = nativeCreateDescriptorPool(device)
-            if (vkDescriptorPool == 0L) {
-                throw VulkanException("Failed to create descriptor pool")
+            // 6-8. 只有 shader 采样输入纹理时才需要 descriptor
+            if (reflected.descriptorSetLayout(0) != 0L) {
+                createDescriptors(reflected)
             }
-            Log.d(TAG, "✓ Descriptor pool created")
-
-            // 7. Create sampler
-            vkSampler = nativeCreateSampler(device)
-            if (vkSampler == 0L) {
-                throw VulkanException("Failed to create sampler")
-            }
-            Log.d(TAG, "✓ Sampler created")
-
-            // 8. Allocate descriptor set
-            vkDescriptorSet = nativeAllocateDescriptorSet(
-                vkDevice,
-                vkDescriptorPool,
-                vkDescriptorSetLayout
-            )
-
-            if (vkDescriptorSet == 0L) {
-                throw VulkanException("Failed to allocate descriptor set")
-            }
-            Log.d(TAG, "✓ Descriptor set allocated")
 
             isInitialized = true
             Log.i(TAG, "=== SimpleVulkanFilter initialized successfully ===")
@@ -133,13 +104,39 @@ class SimpleVulkanFilter(private val context: Context) : VulkanFilter {
         }
     }
 
+    private fun createDescriptors(reflected: ReflectedLayout) {
+        val manager = DescriptorManager(vkDevice, reflected)
+        descriptors = manager
+        Log.d(TAG, "✓ Descriptor manager created (push=${manager.usesPushDescriptors})")
+
+        vkSampler = nativeCreateSampler(vkDevice)
+        if (vkSampler == 0L) {
+            throw VulkanException("Failed to create sampler")
+        }
+        Log.d(TAG, "✓ Sampler created")
+    }
+
+    // ShaderVariant 中的 constant_id 必须在 shader 里声明，否则特化不会生效
+    private fun checkSpecConstants(reflected: ReflectedLayout) {
+        for (id in intArrayOf(SPEC_MAX_ITER, SPEC_SHOW_TILING)) {
+            if (id !in reflected.specConstants) {
+                Log.w(TAG, "Specialization constant $id is not declared in b.frag")
+            }
+        }
+    }
+
     // 添加：设置表面尺寸
-    fun setSurfaceSize(width: Int, height: Int) {
+    override fun setSurfaceSize(width: Int, height: Int) {
         surfaceWidth = width
         surfaceHeight = height
         Log.d(TAG, "Surface size set: ${width}x${height}")
     }
 
+    // 输入纹理随尺寸重建，旧视图的句柄可能被新视图复用
+    override fun setInputSize(width: Int, height: Int) {
+        descriptors?.invalidate()
+    }
+
     override fun draw(commandBuffer: Long, inputTexture: Long, transformMatrix: FloatArray) {
         if (!isInitialized) {
             Log.e(TAG, "Filter not initialized!")
@@ -151,18 +148,19 @@ class SimpleVulkanFilter(private val context: Context) : VulkanFilter {
             return
         }
 
-        // Update descriptor set if texture changed
-        if (currentTextureView != inputTexture) {
-            Log.d(TAG, "Updating descriptor set with texture: $inputTexture")
-            nativeUpdateDescriptorSet(vkDevice, vkDescriptorSet, inputTexture, vkSampler)
-            currentTextureView = inputTexture
-        }
-
         // Bind pipeline
-        nativeBindPipeline(commandBuffer, vkPipeline)
+        val pipeline = currentPipeline()
+        if (pipeline == 0L) {
+            Log.e(TAG, "No pipeline compiled yet for variant ${currentVariant()}")
+            return
+        }
 
-        // Bind descriptor sets
-        nativeBindDescriptorSets(commandBuffer, vkPipelineLayout, vkDescriptorSet)
+        // 输入纹理：缓存命中时不写描述符，也不会改写前几帧仍在使用的 set
+        val descriptors = descriptors
+        if (descriptors != null && !descriptors.bind(commandBuffer, false, vkPipelineLayout, inputTexture, vkSampler)) {
+            return
+        }
+        nativeBindPipeline(commandBuffer, pipeline)
 
         // 添加：Push Constants (resolution + time)
         if (surfaceWidth > 0 && surfaceHeight > 0) {
@@ -174,12 +172,7 @@ class SimpleVulkanFilter(private val context: Context) : VulkanFilter {
                 0.0f                      // padding
             )
 
-            // 每100帧打印一次日志
-            if (frameCount++ % 100 == 0) {
-                Log.d(TAG, "Push Constants: ${surfaceWidth}x${surfaceHeight}, time=${"%.2f".format(currentTime)}")
-            }
-
-            nativePushConstants(commandBuffer, vkPipelineLayout, pushConstantsData)
+            nativePushConstants(commandBuffer, vkPipelineLayout, pushConstantStages, pushConstantsData)
         } else {
             Log.w(TAG, "Surface size not set, skipping Push Constants")
         }
@@ -189,31 +182,71 @@ class SimpleVulkanFilter(private val context: Context) : VulkanFilter {
         nativeDraw(commandBuffer, 3, 1, 0, 0)
     }
 
+    // 输出随时间变化，每帧都需要整帧重绘
+    override fun isAnimated(): Boolean = true
+
+    override fun setQualityLevel(level: Int) {
+        qualityLevel = level.coerceIn(VulkanFilter.QUALITY_LOW, VulkanFilter.QUALITY_HIGH)
+    }
+
+    private fun currentVariant(): ShaderVariant {
+        return ShaderVariant()
+            .with(SPEC_MAX_ITER, ITERATIONS[qualityLevel])
+            .with(SPEC_SHOW_TILING, showTiling)
+    }
+
+    private fun pipelineFor(variant: ShaderVariant): PipelineFuture {
+        return pipelines.getOrPut(variant) {
+            Log.d(TAG, "Pipeline variant $variant submitted for compilation")
+            PipelineFuture(
+                vkDevice,
+                vkRenderPass,
+                vkPipelineLayout,
+                vertexShaderModule,
+                fragmentShaderModule,
+                variant
+            )
+        }
+    }
+
+    // 当前变体编译好之前返回上一个已编译的变体，切换画质档位不会卡顿
+    private fun currentPipeline(): Long {
+        val pipeline = pipelineFor(currentVariant()).pipeline()
+        if (pipeline != 0L) {
+            lastPipeline = pipeline
+        }
+        return lastPipeline
+    }
+
+    override fun isReady(): Boolean = isInitialized && currentPipeline() != 0L
+
+    override fun awaitReady() {
+        if (isInitialized) {
+            pipelineFor(currentVariant()).await()
+        }
+    }
+
     override fun release() {
         if (!isInitialized) return
 
         Log.d(TAG, "Releasing filter resources")
 
-        if (vkDescriptorPool != 0L) {
-            nativeDestroyDescriptorPool(vkDevice, vkDescriptorPool)
-            vkDescriptorPool = 0L
-        }
+        descriptors?.release()
+        descriptors = null
         if (vkSampler != 0L) {
             nativeDestroySampler(vkDevice, vkSampler)
             vkSampler = 0L
         }
-        if (vkPipeline != 0L) {
-            nativeDestroyPipeline(vkDevice, vkPipeline)
-            vkPipeline = 0L
-        }
-        if (vkPipelineLayout != 0L) {
-            nativeDestroyPipelineLayout(vkDevice, vkPipelineLayout)
-            vkPipelineLayout = 0L
-        }
-        if (vkDescriptorSetLayout != 0L) {
-            nativeDestroyDescriptorSetLayout(vkDevice, vkDescriptorSetLayout)
-            vkDescriptorSetLayout = 0L
+        // 先取消/等待编译任务，之后才能销毁它引用的 layout 和 shader module
+        for (future in pipelines.values) {
+            future.release()
         }
+        pipelines.clear()
+        lastPipeline = 0L
+        // layout 归设备缓存所有，这里只减少引用
+        layout?.release()
+        layout = null
+        vkPipelineLayout = 0L
         if (vertexShaderModule != 0L) {
             nativeDestroyShaderModule(vkDevice, vertexShaderModule)
             vertexShaderModule = 0L
@@ -224,47 +257,19 @@ class SimpleVulkanFilter(private val context: Context) : VulkanFilter {
         }
 
         isInitialized = false
-        currentTextureView = 0
         Log.d(TAG, "Filter resources released")
     }
 
     // Native methods
-    private external fun nativeCreateDescriptorSetLayout(device: Long): Long
-
-
-    private external fun nativeCreateGraphicsPipeline(
-        device: Long,
-        renderPass: Long,
-        pipelineLayout: Long,
-        vertShaderModule: Long,
-        fragShaderModule: Long
-    ): Long
-    private external fun nativeCreateDescriptorPool(device: Long): Long
     private external fun nativeCreateSampler(device: Long): Long
     private external fun nativeCreateShaderModule(device: Long, code: ByteArray): Long
-    private external fun nativeAllocateDescriptorSet(
-        device: Long,
-        descriptorPool: Long,
-        descriptorSetLayout: Long
-    ): Long
-    private external fun nativeUpdateDescriptorSet(
-        device: Long,
-        descriptorSet: Long,
-        imageView: Long,
-        sampler: Long
-    )
-    private external fun nativeCreatePipelineLayout(device: Long, descriptorSetLayout: Long): Long
     private external fun nativeBindPipeline(commandBuffer: Long, pipeline: Long)
-    private external fun nativeBindDescriptorSets(
-        commandBuffer: Long,
-        pipelineLayout: Long,
-        descriptorSet: Long
-    )
 
     // 添加：Push Constants方法
     private external fun nativePushConstants(
         commandBuffer: Long,
         pipelineLayout: Long,
+        stageFlags: Int,
         data: FloatArray
     )
 
@@ -275,16 +280,18 @@ class SimpleVulkanFilter(private val context: Context) : VulkanFilter {
         firstVertex: Int,
         firstInstance: Int
     )
-    private external fun nativeDestroyDescriptorPool(device: Long, descriptorPool: Long)
     private external fun nativeDestroySampler(device: Long, sampler: Long)
-    private external fun nativeDestroyPipeline(device: Long, pipeline: Long)
-    private external fun nativeDestroyPipelineLayout(device: Long, pipelineLayout: Long)
-    private external fun nativeDestroyDescriptorSetLayout(device: Long, descriptorSetLayout: Long)
     private external fun nativeDestroyShaderModule(device: Long, shaderModule: Long)
 
     companion object {
         const val TAG = "SimpleVulkanFilter"
-        private var frameCount = 0  // 添加：帧计数器，用于日志控制
+
+        // b.frag 中的 constant_id
+        private const val SPEC_MAX_ITER = 0
+        private const val SPEC_SHOW_TILING = 1
+
+        // 各画质档位的湍流迭代次数，QUALITY_HIGH 与 shader 默认值一致
+        private val ITERATIONS = intArrayOf(3, 4, 5)
 
         init {
             System.loadLibrary("myapplication")
@@ -0,0 +1,49 @@
+package com.genymobile.scrcpy.vulkan
+
+/**
+ * 一组特化常量（constant_id -> 32 位值），创建 pipeline 时通过 VkSpecializationInfo 传给驱动
+ *
+ * 同一份 SPIR-V 按不同常量值编译成不同的 pipeline 变体：循环次数、开关分支在驱动后端
+ * 成为编译期常量，不需要为每个画质档位单独打包 shader。
+ * 不可变，可以直接作为 Map 的键缓存各变体的 pipeline。
+ *
+ * 使用示例：
+ * ```
+ * val variant = ShaderVariant()
+ *     .with(SPEC_MAX_ITER, 3)
+ *     .with(SPEC_SHOW_TILING, false)
+ * val future = PipelineFuture(device, renderPass, pipelineLayout, vert, frag, variant)
+ * ```
+ */
+data class ShaderVariant(private val constants: Map<Int, Int> = emptyMap()) {
+
+    fun with(constantId: Int, value: Int): ShaderVariant {
+        require(constantId >= 0) { "Invalid constant_id: $constantId" }
+        return ShaderVariant(constants + (constantId to value))
+    }
+
+    // bool 特化常量是 32 位的 VkBool32
+    fun with(constantId: Int, value: Boolean): ShaderVariant = with(constantId, if (value) 1 else 0)
+
+    fun with(constantId: Int, value: Float): ShaderVariant = with(constantId, value.toRawBits())
+
+    /**
+     * 传给 native 的 [id0, value0, id1, value1, ...]，按 id 排序；没有常量时返回 null
+     */
+    fun toIntArray(): IntArray? {
+        if (constants.isEmpty()) {
+            return null
+        }
+        val result = IntArray(constants.size * 2)
+        var i = 0
+        for ((id, value) in constants.toSortedMap()) {
+            result[i++] = id
+            result[i++] = value
+        }
+        return result
+    }
+
+    override fun toString(): String {
+        return constants.toSortedMap().entries.joinToString(prefix = "{", postfix = "}") { "${it.key}=${it.value}" }
+    }
+}
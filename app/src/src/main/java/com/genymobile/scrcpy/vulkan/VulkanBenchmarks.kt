@@ -0,0 +1,463 @@
+package com.genymobile.scrcpy.vulkan
+
+import android.util.Log
+import kotlin.random.Random
+
+/**
+ * 离屏 GPU 基准测试：在 [runner] 的设备上对比计算/光栅化路径、融合滤镜、可分离缩放器和 mip 链。
+ *
+ * 每个入口都阻塞到测试完成（通过 [VulkanRunner.runBenchmark] 在渲染线程上执行），
+ * runner 未启动或已停止时返回空结果。结果同时写入日志。
+ *
+ * 使用示例：
+ * ```
+ * val benchmarks = VulkanBenchmarks(runner)
+ * benchmarks.benchmarkComputeBackend()
+ * benchmarks.benchmarkScaler(ScalerVulkanFilter(context), AffineVulkanFilter(context))
+ * ```
+ */
+class VulkanBenchmarks(private val runner: VulkanRunner) {
+
+    /**
+     * 在离屏目标上对比 runner 滤镜的光栅化和计算路径（GPU timestamp）。
+     * 需要以 preferCompute 启动并且两条 pipeline 都已编译完成，否则返回空列表。
+     * 日志：每帧毫秒数和 Mpix/s
+     */
+    fun benchmarkComputeBackend(iterations: Int = 100): List<BackendTiming> {
+        val results = ArrayList<BackendTiming>()
+        runOnTarget("Compute") { target -> runComputeBenchmark(target, iterations, results) }
+        return results
+    }
+
+    private fun runComputeBenchmark(target: VulkanRunner.BenchmarkTarget, iterations: Int, results: MutableList<BackendTiming>) {
+        val filter = target.filter
+        if (!filter.isReady() || !filter.isComputeReady()) {
+            Log.w(TAG, "Cannot run benchmark - filter graphics/compute pipelines not ready")
+            return
+        }
+        val textureImageView = target.inputImageView
+        if (textureImageView == 0L) {
+            Log.w(TAG, "Cannot run benchmark - no input texture")
+            return
+        }
+        val matrix = target.transformMatrix
+
+        for ((width, height) in BENCHMARK_SIZES) {
+            val bench = nativeCreateComputeBenchmark(target.device, width, height)
+            if (bench == 0L) {
+                Log.e(TAG, "Failed to create benchmark target ${width}x$height")
+                continue
+            }
+            try {
+                val rects = intArrayOf(0, 0, width, height)
+                val commandBuffer = nativeBeginComputeBenchmark(bench)
+                filter.setSurfaceSize(width, height)
+                repeat(iterations) {
+                    nativeBeginBenchmarkRasterPass(bench)
+                    filter.draw(commandBuffer, textureImageView, matrix)
+                    nativeEndBenchmarkRasterPass(bench)
+                }
+                repeat(iterations) {
+                    val outputView = nativeBeginBenchmarkComputePass(bench)
+                    filter.dispatch(commandBuffer, textureImageView, matrix, outputView, rects)
+                }
+                val times = nativeFinishComputeBenchmark(target.device, bench) ?: continue
+
+                val timing = BackendTiming(width, height, times[0] / iterations, times[1] / iterations)
+                results.add(timing)
+                Log.i(TAG, "Benchmark ${width}x$height: raster %.3f ms (%.0f Mpix/s), compute %.3f ms (%.0f Mpix/s)".format(
+                    timing.rasterMs, timing.rasterMpixPerSecond, timing.computeMs, timing.computeMpixPerSecond))
+            } finally {
+                nativeDestroyComputeBenchmark(target.device, bench)
+            }
+        }
+    }
+
+    // 每帧 GPU 时间（毫秒）
+    data class BackendTiming(val width: Int, val height: Int, val rasterMs: Double, val computeMs: Double) {
+        val rasterMpixPerSecond: Double
+            get() = width.toDouble() * height / 1000.0 / rasterMs
+        val computeMpixPerSecond: Double
+            get() = width.toDouble() * height / 1000.0 / computeMs
+    }
+
+    /**
+     * 在离屏目标上对比融合滤镜与逐级执行（[FusedVulkanFilter.unfused]）的 GPU 时间和带宽。
+     * [fused] 必须是没有交给 runner 的新实例：测试期间在渲染线程上 init，结束后和逐级版本一起 release。
+     * 带宽按每个 pass 读写一张输出尺寸的 RGBA8 图像估算
+     */
+    fun benchmarkFusion(fused: FusedVulkanFilter, iterations: Int = 100): List<FusionTiming> {
+        if (!FusedVulkanFilter.isAvailable) {
+            Log.w(TAG, "Cannot run fusion benchmark - native library built without Vulkanfusion.cpp")
+            return emptyList()
+        }
+        val results = ArrayList<FusionTiming>()
+        runOnTarget("Fusion") { target -> runFusionBenchmark(target, fused, iterations, results) }
+        return results
+    }
+
+    private fun runFusionBenchmark(
+        target: VulkanRunner.BenchmarkTarget,
+        fused: FusedVulkanFilter,
+        iterations: Int,
+        results: MutableList<FusionTiming>
+    ) {
+        val textureImageView = target.inputImageView
+        if (textureImageView == 0L) {
+            Log.w(TAG, "Cannot run benchmark - no input texture")
+            return
+        }
+        val matrix = target.transformMatrix
+        val unfused = fused.unfused()
+
+        try {
+            for (candidate in listOf(fused, unfused)) {
+                candidate.setSurfaceSize(target.surfaceSize.width, target.surfaceSize.height)
+                candidate.init(target.device, target.renderPass)
+                candidate.awaitReady()
+            }
+            if (!fused.isReady() || !unfused.isReady()) {
+                Log.w(TAG, "Cannot run benchmark - pipelines failed to compile")
+                return
+            }
+
+            for ((width, height) in BENCHMARK_SIZES) {
+                val bench = nativeCreateComputeBenchmark(target.device, width, height)
+                if (bench == 0L) {
+                    Log.e(TAG, "Failed to create benchmark target ${width}x$height")
+                    continue
+                }
+                try {
+                    unfused.setSurfaceSize(width, height)
+                    fused.setSurfaceSize(width, height)
+                    val commandBuffer = nativeBeginComputeBenchmark(bench)
+
+                    // 第一段：逐级执行（中间 pass 在 prepare 中录制），第二段：融合
+                    repeat(iterations) {
+                        unfused.prepare(commandBuffer, textureImageView, matrix)
+                        nativeBeginBenchmarkRasterPass(bench)
+                        unfused.draw(commandBuffer, textureImageView, matrix)
+                        nativeEndBenchmarkRasterPass(bench)
+                    }
+                    nativeMarkBenchmarkSplit(bench)
+                    repeat(iterations) {
+                        nativeBeginBenchmarkRasterPass(bench)
+                        fused.draw(commandBuffer, textureImageView, matrix)
+                        nativeEndBenchmarkRasterPass(bench)
+                    }
+                    val times = nativeFinishComputeBenchmark(target.device, bench) ?: continue
+
+                    val timing = FusionTiming(width, height, fused.stages.size,
+                        times[0] / iterations, times[1] / iterations)
+                    results.add(timing)
+                    Log.i(TAG, ("Fusion ${width}x$height (${timing.passes} passes): unfused %.3f ms (%.1f MB, %.1f GB/s), " +
+                            "fused %.3f ms (%.1f MB, %.1f GB/s), speedup %.2fx").format(
+                        timing.unfusedMs, timing.unfusedBytes / 1e6, timing.unfusedGBps,
+                        timing.fusedMs, timing.fusedBytes / 1e6, timing.fusedGBps, timing.speedup))
+                } finally {
+                    nativeDestroyComputeBenchmark(target.device, bench)
+                }
+            }
+        } finally {
+            target.waitIdle()
+            fused.release()
+            unfused.release()
+        }
+    }
+
+    // 每帧 GPU 时间（毫秒）和估算的显存流量：每个 pass 读、写各一张输出尺寸的 RGBA8 图像
+    data class FusionTiming(val width: Int, val height: Int, val passes: Int, val unfusedMs: Double, val fusedMs: Double) {
+        private val bytesPerPass: Double
+            get() = width.toDouble() * height * 4 * 2
+        val unfusedBytes: Double
+            get() = bytesPerPass * passes
+        val fusedBytes: Double
+            get() = bytesPerPass
+        val unfusedGBps: Double
+            get() = unfusedBytes / (unfusedMs * 1e6)
+        val fusedGBps: Double
+            get() = fusedBytes / (fusedMs * 1e6)
+        val speedup: Double
+            get() = unfusedMs / fusedMs
+    }
+
+    /**
+     * 在离屏目标上对比可分离缩放器的各个核函数与硬件双线性（[bilinear]，通常是恒等变换的
+     * [AffineVulkanFilter]）：输入缩小到 1/2 和 1/4，记录每帧 GPU 时间和一维 chirp 测试的画质。
+     * 两个滤镜都必须是没有交给 runner 的新实例：测试期间在渲染线程上 init，结束后 release
+     */
+    fun benchmarkScaler(scaler: ScalerVulkanFilter, bilinear: VulkanFilter, iterations: Int = 100): List<ScalerTiming> {
+        val results = ArrayList<ScalerTiming>()
+        runOnTarget("Scaler") { target -> runScalerBenchmark(target, scaler, bilinear, iterations, results) }
+        return results
+    }
+
+    private fun runScalerBenchmark(
+        target: VulkanRunner.BenchmarkTarget,
+        scaler: ScalerVulkanFilter,
+        bilinear: VulkanFilter,
+        iterations: Int,
+        results: MutableList<ScalerTiming>
+    ) {
+        val textureImageView = target.inputImageView
+        if (textureImageView == 0L) {
+            Log.w(TAG, "Cannot run benchmark - no input texture")
+            return
+        }
+        val matrix = target.transformMatrix
+        val inputWidth = target.inputWidth
+        val inputHeight = target.inputHeight
+
+        try {
+            for (candidate in listOf(scaler, bilinear)) {
+                candidate.setInputSize(inputWidth, inputHeight)
+                candidate.setSurfaceSize(target.surfaceSize.width, target.surfaceSize.height)
+                candidate.init(target.device, target.renderPass)
+                candidate.awaitReady()
+            }
+            if (!scaler.isComputeReady() || !bilinear.isReady()) {
+                Log.w(TAG, "Cannot run benchmark - pipelines failed to compile")
+                return
+            }
+
+            for (divisor in SCALER_DIVISORS) {
+                val width = (inputWidth / divisor).coerceAtLeast(1)
+                val height = (inputHeight / divisor).coerceAtLeast(1)
+                val rects = intArrayOf(0, 0, width, height)
+                scaler.setSurfaceSize(width, height)
+                bilinear.setSurfaceSize(width, height)
+                val bilinearQuality = scaler.measureQuality(ScalerVulkanFilter.Kernel.BILINEAR,
+                    inputWidth, width, hardwareBilinear = true) ?: continue
+
+                // 换核函数会重建权重缓冲，每个核函数单独提交一次
+                for (kernel in ScalerVulkanFilter.Kernel.values()) {
+                    val quality = scaler.measureQuality(kernel, inputWidth, width) ?: continue
+                    scaler.kernel = kernel
+                    val bench = nativeCreateComputeBenchmark(target.device, width, height)
+                    if (bench == 0L) {
+                        Log.e(TAG, "Failed to create benchmark target ${width}x$height")
+                        continue
+                    }
+                    try {
+                        val commandBuffer = nativeBeginComputeBenchmark(bench)
+                        repeat(iterations) {
+                            nativeBeginBenchmarkRasterPass(bench)
+                            bilinear.draw(commandBuffer, textureImageView, matrix)
+                            nativeEndBenchmarkRasterPass(bench)
+                        }
+                        repeat(iterations) {
+                            val outputView = nativeBeginBenchmarkComputePass(bench)
+                            scaler.dispatch(commandBuffer, textureImageView, matrix, outputView, rects)
+                        }
+                        val times = nativeFinishComputeBenchmark(target.device, bench) ?: continue
+
+                        val timing = ScalerTiming(width, height, kernel.name,
+                            times[0] / iterations, times[1] / iterations,
+                            bilinearQuality[0], bilinearQuality[1], quality[0], quality[1])
+                        results.add(timing)
+                        Log.i(TAG, ("Scaler ${inputWidth}x$inputHeight -> ${width}x$height ${timing.kernel}: " +
+                                "bilinear %.3f ms (PSNR %.1f dB, aliasing %.1f dB), " +
+                                "separable %.3f ms (PSNR %.1f dB, aliasing %.1f dB), cost %.2fx").format(
+                            timing.bilinearMs, timing.bilinearPsnr, timing.bilinearAliasing,
+                            timing.scalerMs, timing.scalerPsnr, timing.scalerAliasing, timing.cost))
+                    } finally {
+                        nativeDestroyComputeBenchmark(target.device, bench)
+                    }
+                }
+            }
+        } finally {
+            target.waitIdle()
+            scaler.release()
+            bilinear.release()
+        }
+    }
+
+    // 每帧 GPU 时间（毫秒）和画质（dB）：psnr 越高越好，aliasing 越低越好
+    data class ScalerTiming(
+        val width: Int,
+        val height: Int,
+        val kernel: String,
+        val bilinearMs: Double,
+        val scalerMs: Double,
+        val bilinearPsnr: Double,
+        val bilinearAliasing: Double,
+        val scalerPsnr: Double,
+        val scalerAliasing: Double
+    ) {
+        val cost: Double
+            get() = scalerMs / bilinearMs
+    }
+
+    /**
+     * 在离屏目标上测量 mip 链对大幅缩小的影响：[candidate]（通常是恒等变换的新 [AffineVulkanFilter]，
+     * 缩小超过 2 倍时自动换用三线性 sampler）把输入尺寸的纹理画到 1/[MIPMAP_DIVISOR]，
+     * 分别读取单级纹理和带 mip 链的纹理（内容相同的随机图案），记录每帧 GPU 时间、
+     * 每次上传后生成 mip 链的 GPU 时间，以及估算的纹理缓存取数量和利用率（Vulkanmips.h）。
+     * [candidate] 必须是没有交给 runner 的新实例：测试期间在渲染线程上 init，结束后 release。
+     * 设备不支持生成 mip 时返回 null
+     */
+    fun benchmarkMipmaps(candidate: VulkanFilter, iterations: Int = 100): MipmapTiming? {
+        var result: MipmapTiming? = null
+        runOnTarget("Mipmap") { target -> result = runMipmapBenchmark(target, candidate, iterations) }
+        return result
+    }
+
+    private fun runMipmapBenchmark(target: VulkanRunner.BenchmarkTarget, candidate: VulkanFilter, iterations: Int): MipmapTiming? {
+        val inputWidth = target.inputWidth
+        val inputHeight = target.inputHeight
+        val width = (inputWidth / MIPMAP_DIVISOR).coerceAtLeast(1)
+        val height = (inputHeight / MIPMAP_DIVISOR).coerceAtLeast(1)
+        val matrix = target.transformMatrix
+
+        val plain = target.createInputTexture(inputWidth, inputHeight, false)
+        val mipmapped = target.createInputTexture(inputWidth, inputHeight, true)
+        try {
+            if (plain == 0L || mipmapped == 0L) {
+                Log.e(TAG, "Failed to create benchmark textures ${inputWidth}x$inputHeight")
+                return null
+            }
+            val mipLevels = target.textureMipLevels(mipmapped)
+            if (mipLevels <= 1) {
+                Log.w(TAG, "Cannot run benchmark - device cannot generate mips for the input format")
+                return null
+            }
+
+            // 随机图案：纯色或平滑内容的取数差异会被纹理压缩和缓存掩盖
+            val pattern = ByteArray(inputWidth * inputHeight * 4)
+            Random(MIPMAP_PATTERN_SEED).nextBytes(pattern)
+            for (i in 3 until pattern.size step 4) {
+                pattern[i] = 0xFF.toByte()
+            }
+            target.uploadTexture(plain, pattern)
+            target.uploadTexture(mipmapped, pattern)
+
+            candidate.setInputSize(inputWidth, inputHeight)
+            candidate.setSurfaceSize(width, height)
+            candidate.init(target.device, target.renderPass)
+            candidate.awaitReady()
+            if (!candidate.isReady()) {
+                Log.w(TAG, "Cannot run benchmark - pipelines failed to compile")
+                return null
+            }
+
+            // [单级纹理每帧, 带 mip 链每帧, 生成 mip 链]。滤镜只有一个 descriptor set，
+            // 同一命令缓冲里换纹理会改写已录制的绑定，所以每个纹理单独提交一次
+            val times = DoubleArray(3)
+            for ((index, texture) in listOf(plain, mipmapped).withIndex()) {
+                val textureImageView = target.textureImageView(texture)
+                val bench = nativeCreateComputeBenchmark(target.device, width, height)
+                if (bench == 0L) {
+                    Log.e(TAG, "Failed to create benchmark target ${width}x$height")
+                    return null
+                }
+                try {
+                    val commandBuffer = nativeBeginComputeBenchmark(bench)
+                    repeat(iterations) {
+                        nativeBeginBenchmarkRasterPass(bench)
+                        candidate.draw(commandBuffer, textureImageView, matrix)
+                        nativeEndBenchmarkRasterPass(bench)
+                    }
+                    // 第二段：单级纹理什么都不录制
+                    nativeMarkBenchmarkSplit(bench)
+                    repeat(iterations) {
+                        target.recordTextureMips(texture, commandBuffer)
+                    }
+                    val segments = nativeFinishComputeBenchmark(target.device, bench) ?: return null
+                    times[index] = segments[0] / iterations
+                    if (texture == mipmapped) {
+                        times[2] = segments[1] / iterations
+                    }
+                } finally {
+                    nativeDestroyComputeBenchmark(target.device, bench)
+                }
+            }
+
+            val plainFootprint = nativeEstimateTextureFootprint(inputWidth, inputHeight, width, height, 1)
+                ?: return null
+            val mipFootprint = nativeEstimateTextureFootprint(inputWidth, inputHeight, width, height, mipLevels)
+                ?: return null
+
+            val timing = MipmapTiming(width, height, mipLevels, times[0], times[1], times[2],
+                plainFootprint[1], mipFootprint[1], plainFootprint[2], mipFootprint[2])
+            Log.i(TAG, ("Mipmaps ${inputWidth}x$inputHeight -> ${width}x$height ($mipLevels levels, LOD %.2f): " +
+                    "bilinear %.3f ms (%.1f B/px, cache %.0f%%), " +
+                    "trilinear %.3f ms (%.1f B/px, cache %.0f%%) + generation %.3f ms, speedup %.2fx").format(
+                mipFootprint[0],
+                timing.bilinearMs, timing.bilinearBytesPerPixel, timing.bilinearCacheEfficiency * 100,
+                timing.trilinearMs, timing.trilinearBytesPerPixel, timing.trilinearCacheEfficiency * 100,
+                timing.generationMs, timing.speedup))
+            return timing
+        } finally {
+            target.waitIdle()
+            candidate.release()
+            if (plain != 0L) {
+                target.destroyTexture(plain)
+            }
+            if (mipmapped != 0L) {
+                target.destroyTexture(mipmapped)
+            }
+        }
+    }
+
+    // 每帧 GPU 时间（毫秒）；取数量（每个输出像素的字节数）和缓存利用率为估算值（见 Vulkanmips.h）
+    data class MipmapTiming(
+        val width: Int,
+        val height: Int,
+        val mipLevels: Int,
+        val bilinearMs: Double,
+        val trilinearMs: Double,
+        val generationMs: Double,
+        val bilinearBytesPerPixel: Double,
+        val trilinearBytesPerPixel: Double,
+        val bilinearCacheEfficiency: Double,
+        val trilinearCacheEfficiency: Double
+    ) {
+        // 每帧都上传新画面时 mip 链也要每帧生成
+        val speedup: Double
+            get() = bilinearMs / (trilinearMs + generationMs)
+    }
+
+    // 测试失败只记日志，已经得到的结果照常返回
+    private fun runOnTarget(name: String, block: (VulkanRunner.BenchmarkTarget) -> Unit) {
+        try {
+            runner.runBenchmark(block)
+        } catch (e: Exception) {
+            Log.e(TAG, "$name benchmark failed", e)
+        }
+    }
+
+    // ========== Native（Vulkancompute.cpp / Vulkanmips.cpp） ==========
+
+    private external fun nativeCreateComputeBenchmark(device: Long, width: Int, height: Int): Long
+    private external fun nativeDestroyComputeBenchmark(device: Long, bench: Long)
+    private external fun nativeBeginComputeBenchmark(bench: Long): Long
+    private external fun nativeBeginBenchmarkRasterPass(bench: Long)
+    private external fun nativeEndBenchmarkRasterPass(bench: Long)
+    private external fun nativeBeginBenchmarkComputePass(bench: Long): Long
+    private external fun nativeMarkBenchmarkSplit(bench: Long)
+    private external fun nativeFinishComputeBenchmark(device: Long, bench: Long): DoubleArray?
+    private external fun nativeEstimateTextureFootprint(
+        srcWidth: Int,
+        srcHeight: Int,
+        dstWidth: Int,
+        dstHeight: Int,
+        mipLevels: Int
+    ): DoubleArray?
+
+    companion object {
+        private const val TAG = "VulkanBenchmarks"
+
+        private val BENCHMARK_SIZES = listOf(1920 to 1080, 3840 to 2160)
+
+        // benchmarkScaler：输出为输入尺寸的 1/2、1/4
+        private val SCALER_DIVISORS = listOf(2, 4)
+
+        // benchmarkMipmaps：4:1 缩小，图案固定以便多次运行对比
+        private const val MIPMAP_DIVISOR = 4
+        private const val MIPMAP_PATTERN_SEED = 40
+
+        init {
+            System.loadLibrary("myapplication")
+        }
+    }
+}
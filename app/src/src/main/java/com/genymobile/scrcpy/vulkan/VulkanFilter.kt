@@ -2,7 +2,58 @@ package com.genymobile.scrcpy.vulkan
 
 // Filter interface for Vulkan
 interface VulkanFilter {
+    // renderPass 为 0 表示设备使用动态渲染（VK_KHR_dynamic_rendering），照常传给 PipelineFuture 即可
     fun init(device: Long, renderPass: Long)
     fun draw(commandBuffer: Long, inputTexture: Long, transformMatrix: FloatArray)
     fun release()
+
+    // 输出尺寸，在 init() 之前调用；动态分辨率下每次渲染尺寸变化也会调用
+    fun setSurfaceSize(width: Int, height: Int) {}
+
+    // 输入纹理尺寸（像素），在 init() 之前调用。只有按源像素计算的滤镜需要（例如 ScalerVulkanFilter）
+    fun setInputSize(width: Int, height: Int) {}
+
+    // 在交换链 render pass 开始之前调用，可以在这里录制离屏 pass
+    fun prepare(commandBuffer: Long, inputTexture: Long, transformMatrix: FloatArray) {}
+
+    // 输出纹理坐标 -> 输入纹理坐标的 4x4 列主序矩阵，用于把输入脏矩形映射到输出。
+    // 返回 null 表示输入任意变化都会影响整个输出（只能整帧重绘）
+    fun damageTransform(transformMatrix: FloatArray): FloatArray? = null
+
+    // 输出是否恰好等于输入在 M * uv 处的双线性采样（超出 [0, 1] 为透明黑色），是则返回 M（4x4 列主序）。
+    // runner 据此对变换分类（见 Vulkantransfer.h）：恒等/整数裁剪走 vkCmdCopyImage，缩放/翻转走
+    // vkCmdBlitImage，都不经过 pipeline；返回 null 或变换含旋转/错切时照常 prepare()/draw()
+    fun transferTransform(transformMatrix: FloatArray): FloatArray? = null
+
+    // 输出随时间变化（与输入无关）的滤镜每帧都需要整帧重绘
+    fun isAnimated(): Boolean = false
+
+    // 画质档位 [QUALITY_LOW, QUALITY_HIGH]，在渲染线程调用，可以在 init() 前后任意时刻切换。
+    // 滤镜通过特化常量选择对应的 pipeline 变体（见 ShaderVariant），没有档位的滤镜忽略
+    fun setQualityLevel(level: Int) {}
+
+    // pipeline 是否已经编译完成（见 PipelineFuture）。返回 false 时 runner 不调用 prepare()/draw()，
+    // 改用直通滤镜绘制，编译完成后自动切换
+    fun isReady(): Boolean = true
+
+    // 阻塞直到编译完成（成功或失败）；runner 对直通滤镜、以及没有直通滤镜时对滤镜本身调用
+    fun awaitReady() {}
+
+    // 计算路径（见 Vulkancompute.h）：在 init() 之前调用，返回 true 表示滤镜会同时准备计算 pipeline，
+    // runner 据此为交换链请求存储/传输用途。不支持的滤镜保持默认
+    fun enableCompute(): Boolean = false
+
+    // 计算 pipeline 是否已经编译完成；返回 false 时 runner 走光栅化路径
+    fun isComputeReady(): Boolean = false
+
+    // 在 render pass 之外调用：把输入写入 outputImage（GENERAL 布局的 rgba8 存储视图），
+    // 只需覆盖 rects 中的矩形（x, y, w, h，像素）
+    fun dispatch(commandBuffer: Long, inputTexture: Long, transformMatrix: FloatArray,
+                 outputImage: Long, rects: IntArray) {}
+
+    companion object {
+        const val QUALITY_LOW = 0
+        const val QUALITY_MEDIUM = 1
+        const val QUALITY_HIGH = 2
+    }
 }
\ No newline at end of file
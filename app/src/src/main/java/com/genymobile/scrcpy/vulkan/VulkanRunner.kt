@@ -5,18 +5,38 @@ import android.util.Size
 import android.view.Surface
 import android.os.Handler
 import android.os.HandlerThread
+import java.io.File
 import java.util.concurrent.Semaphore
 import java.util.concurrent.atomic.AtomicBoolean
 
 class VulkanRunner @JvmOverloads constructor(
     private val filter: VulkanFilter,
-    private val overrideTransformMatrix: FloatArray? = null
+    private val overrideTransformMatrix: FloatArray? = null,
+    private val cacheDir: File? = null,  // 持久化 pipeline 缓存的目录（通常是 Context.cacheDir）
+    // 滤镜 pipeline 在后台编译期间代替它绘制的直通滤镜（通常是 AffineVulkanFilter(context)），
+    // 在 start() 中同步编译。为 null 时 start() 等待滤镜编译完成
+    private val placeholder: VulkanFilter? = null,
+    // 设备支持 VK_KHR_dynamic_rendering 时不创建 render pass / framebuffer；false 强制使用 render pass
+    private val allowDynamicRendering: Boolean = true,
+    // 滤镜支持时（VulkanFilter.enableCompute）用计算着色器直接写输出图像，代替全屏三角形光栅化
+    private val preferCompute: Boolean = false,
+    // 输入纹理带完整 mip 链，每次上传后重新生成（见 Vulkanmips.h）；大幅缩小的滤镜可以三线性采样
+    private val inputMipmaps: Boolean = false,
+    // 每帧用 GPU timestamp 给各个 pass 计时（见 Vulkanprofiler.h），结果通过 getGpuProfile() 读取
+    private val gpuProfiling: Boolean = false,
+    // 着色器开销统计（见 Vulkanshaderstats.h）：配合 gpuProfiling 给各 pass 加上片元/计算着色器调用次数，
+    // 并读取每个 pipeline 的寄存器数和 spill（getShaderExecutableStats()）。改变 pipeline 创建参数，只用于调优
+    private val shaderStatistics: Boolean = false
 ) {
     // Vulkan handles
     private var vkInstance: Long = 0
     private var vkDevice: Long = 0
-    private var vkRenderPass: Long = 0
+    private var vkRenderPass: Long = 0      // 动态渲染时为 0，滤镜按颜色附件格式创建 pipeline
+    private var vkLoadRenderPass: Long = 0  // 保留上一帧内容，只重绘脏区域
+    private var dynamicRendering = false
     private var vkSwapchain: Long = 0
+    private var computeOutput: Long = 0     // 非 0：计算路径可用（见 Vulkancompute.h）
+    private var surfaceSize = Size(0, 0)
     private var vkCommandPool: Long = 0
     private var vkCommandBuffers: LongArray = LongArray(0)
 
@@ -30,6 +50,28 @@ class VulkanRunner @JvmOverloads constructor(
     private var inputSurface: Surface? = null
     private var inputTexture: Long = 0
 
+    // Damage tracking (incremental present)
+    private var damageTracker: Long = 0
+    private var inputWidth = 0
+    private var inputHeight = 0
+    private var shadedFractionSum = 0.0
+    private var renderedFrames = 0
+    private var skippedFrames = 0
+
+    // copy/blit 快速路径（见 Vulkantransfer.h）
+    private var transferPath = TRANSFER_SHADER
+    private var transferFrames = 0
+
+    // 异步 pipeline 编译
+    private var filterReady = false
+    private var startTimeNanos = 0L
+    private var firstFramePresented = false
+
+    // GPU profiler：scope 名字 → id，滤镜 scope 按实例缓存，录制时不拼接字符串
+    private var gpuProfilerEnabled = false
+    private val gpuScopeIds = HashMap<String, Int>()
+    private val filterScopeIds = HashMap<VulkanFilter, Int>()
+
     private var stopped = false
     private val isInitialized = AtomicBoolean(false)
 
@@ -38,41 +80,21 @@ class VulkanRunner @JvmOverloads constructor(
     fun start(inputSize: Size, outputSize: Size, outputSurface: Surface): Surface? {
         initOnce()
 
-        val sem = Semaphore(0)
-        val throwableRef = arrayOfNulls<Throwable>(1)
-        val surfaceRef = arrayOfNulls<Surface>(1)
-
-        handler!!.post {
-            try {
-                surfaceRef[0] = run(inputSize, outputSize, outputSurface)
-            } catch (throwable: Throwable) {
-                throwableRef[0] = throwable
-            } finally {
-                sem.release()
-            }
-        }
-
-        try {
-            sem.acquire()
-        } catch (e: InterruptedException) {
-            Thread.currentThread().interrupt()
-        }
-
-        val throwable = throwableRef[0]
-        if (throwable != null) {
-            if (throwable is VulkanException) {
-                throw throwable
-            }
-            throw VulkanException("Asynchronous Vulkan runner init failed", throwable)
-        }
-
         // 🔥 允许返回 null（表示直接使用纹理，不需要输入 Surface）
-        return surfaceRef[0]
+        return try {
+            runOnRenderThread { run(inputSize, outputSize, outputSurface) }
+        } catch (e: VulkanException) {
+            throw e
+        } catch (e: Throwable) {
+            throw VulkanException("Asynchronous Vulkan runner init failed", e)
+        }
     }
 
     @Throws(VulkanException::class)
     private fun run(inputSize: Size, outputSize: Size, outputSurface: Surface): Surface? {
         Log.d(TAG, "=== Initializing Vulkan Runner ===")
+        startTimeNanos = System.nanoTime()
+        surfaceSize = outputSize
 
         // 1. Create Vulkan instance
         vkInstance = nativeCreateInstance()
@@ -81,32 +103,50 @@ class VulkanRunner @JvmOverloads constructor(
         }
 
         // 2. Create device
-        vkDevice = nativeCreateDevice(vkInstance, outputSurface)
+        vkDevice = nativeCreateDevice(vkInstance, outputSurface, allowDynamicRendering, shaderStatistics)
         if (!validateHandle(vkDevice, "Device")) {
             cleanup()
             throw VulkanException("Failed to create Vulkan device")
         }
 
-        // 3. Create render pass
-        vkRenderPass = nativeCreateRenderPass(vkDevice)
-        if (!validateHandle(vkRenderPass, "RenderPass")) {
-            cleanup()
-            throw VulkanException("Failed to create render pass")
+        // 2.1 Pipeline cache（所有滤镜共享，失败不影响渲染）
+        val cachePath = cacheDir?.let { File(it, PIPELINE_CACHE_FILE).absolutePath }
+        if (!nativeCreatePipelineCache(vkDevice, cachePath)) {
+            Log.w(TAG, "Pipeline cache unavailable")
+        }
+
+        // 2.2 GPU profiler（队列不支持 timestamp 时保持关闭）
+        if (gpuProfiling) {
+            gpuProfilerEnabled = nativeEnableGpuProfiler(vkDevice, MAX_FRAMES_IN_FLIGHT)
+            if (!gpuProfilerEnabled) {
+                Log.w(TAG, "GPU profiler unavailable")
+            }
         }
 
-        // 4. Create swapchain
+        // 2.3 计算路径需要在创建交换链前确定格式和图像用途
+        val computeRequested = preferCompute && filter.enableCompute()
+        nativeRequestComputeOutput(vkDevice, computeRequested)
+
+        // 3. Create swapchain（确定颜色附件格式，render pass 和 pipeline 都使用它）
         vkSwapchain = nativeCreateSwapchain(vkDevice, outputSurface)
         if (!validateHandle(vkSwapchain, "Swapchain")) {
             cleanup()
             throw VulkanException("Failed to create swapchain")
         }
+        if (computeRequested) {
+            computeOutput = nativeCreateComputeOutput(vkDevice, vkSwapchain)
+            if (computeOutput == 0L) {
+                Log.w(TAG, "Compute output unavailable, using graphics pipeline")
+            }
+        }
 
-        // 5. Create framebuffers
-        if (!nativeCreateFramebuffers(vkDevice, vkSwapchain, vkRenderPass)) {
-            cleanup()
-            throw VulkanException("Failed to create framebuffers")
+        // 4-5. 动态渲染直接在交换链 image view 上渲染，不需要 render pass 和 framebuffer
+        dynamicRendering = nativeIsDynamicRenderingEnabled(vkDevice)
+        if (dynamicRendering) {
+            Log.i(TAG, "Using dynamic rendering")
+        } else {
+            createRenderPasses()
         }
-        Log.d(TAG, "✓ Framebuffers created")
 
         // 6. Create command pool
         vkCommandPool = nativeCreateCommandPool(vkDevice)
@@ -142,12 +182,21 @@ class VulkanRunner @JvmOverloads constructor(
         Log.d(TAG, "✓ Sync objects created")
 
         // 9. Create input texture
-        inputTexture = nativeCreateInputTexture(vkDevice, inputSize.width, inputSize.height)
+        inputTexture = nativeCreateInputTexture(vkDevice, inputSize.width, inputSize.height, inputMipmaps)
         if (!validateHandle(inputTexture, "InputTexture")) {
             cleanup()
             throw VulkanException("Failed to create input texture")
         }
 
+        // 9.1 Create damage tracker
+        inputWidth = inputSize.width
+        inputHeight = inputSize.height
+        damageTracker = nativeCreateDamageTracker(vkSwapchain, inputWidth, inputHeight)
+        if (!validateHandle(damageTracker, "DamageTracker")) {
+            cleanup()
+            throw VulkanException("Failed to create damage tracker")
+        }
+
         // 10. Create input Surface (可能返回 null)
         inputSurface = nativeCreateSurfaceFromTexture(inputTexture)
 
@@ -158,18 +207,40 @@ class VulkanRunner @JvmOverloads constructor(
             Log.i(TAG, "Input surface created successfully")
         }
 
-        // 11. Initialize filter
+        // 11. Initialize filter：直通滤镜很小（通常命中缓存），同步等待编译；
+        // 滤镜的 pipeline 提交到后台编译，第一帧不等待
         try {
+            placeholder?.let {
+                it.setInputSize(inputWidth, inputHeight)
+                it.setSurfaceSize(outputSize.width, outputSize.height)
+                it.init(vkDevice, vkRenderPass)
+                it.awaitReady()
+            }
+            filter.setInputSize(inputWidth, inputHeight)
+            filter.setSurfaceSize(outputSize.width, outputSize.height)
             filter.init(vkDevice, vkRenderPass)
+            if (placeholder == null) {
+                filter.awaitReady()
+            }
         } catch (e: Exception) {
             cleanup()
             throw VulkanException("Failed to initialize filter", e)
         }
+        filterReady = filter.isReady()
+        if (!filterReady) {
+            Log.i(TAG, "Filter pipelines compiling in background, drawing with placeholder")
+            pollFilterReady(outputSize)
+        } else {
+            logPipelineCacheStats()
+        }
 
         // 12. Set up frame callback (如果需要)
         if (inputSurface != null) {
             nativeSetFrameCallback(inputTexture) {
                 if (!stopped) {
+                    nativeMarkFrameInput(vkDevice, System.nanoTime())
+                    // SurfaceTexture 不提供脏区域：整张输入都视为变化
+                    nativeAddInputDamage(damageTracker, 0, 0, inputWidth, inputHeight)
                     render(outputSize)
                 }
             }
@@ -217,8 +288,11 @@ class VulkanRunner @JvmOverloads constructor(
             return
         }
 
+        val arrivalNanos = System.nanoTime()
         handler?.post {
+            nativeMarkFrameInput(vkDevice, arrivalNanos)
             nativeUpdateInputTextureColor(vkDevice, inputTexture, r, g, b, a)
+            nativeAddInputDamage(damageTracker, 0, 0, inputWidth, inputHeight)
         }
     }
     /**
@@ -231,13 +305,327 @@ class VulkanRunner @JvmOverloads constructor(
             return
         }
 
+        val arrivalNanos = System.nanoTime()
         handler?.post {
+            nativeMarkFrameInput(vkDevice, arrivalNanos)
             nativeUpdateInputTexture(vkDevice, inputTexture, data)
+            nativeAddInputDamage(damageTracker, 0, 0, inputWidth, inputHeight)
         }
     }
 
+    /**
+     * 更新输入纹理，并只标记变化的区域
+     * @param data RGBA 格式的像素数据，大小必须匹配纹理尺寸
+     * @param dirtyRects 输入像素坐标的脏矩形，每 4 个元素为一组 (x, y, width, height)
+     */
+    fun updateInputTexture(data: ByteArray, dirtyRects: IntArray) {
+        if (!isInitialized.get()) {
+            Log.w(TAG, "Cannot update texture - not initialized")
+            return
+        }
+
+        val arrivalNanos = System.nanoTime()
+        handler?.post {
+            nativeMarkFrameInput(vkDevice, arrivalNanos)
+            nativeUpdateInputTexture(vkDevice, inputTexture, data)
+            addInputDamageInternal(dirtyRects)
+        }
+    }
 
+    /**
+     * 标记输入纹理中发生变化的区域（输入像素坐标），下一帧只重绘受影响的输出区域
+     */
+    fun addInputDamage(x: Int, y: Int, width: Int, height: Int) {
+        if (!isInitialized.get()) {
+            return
+        }
 
+        handler?.post {
+            nativeAddInputDamage(damageTracker, x, y, width, height)
+        }
+    }
+
+    /**
+     * 切换滤镜画质档位（[VulkanFilter.QUALITY_LOW] ~ [VulkanFilter.QUALITY_HIGH]）
+     * 低档位使用更便宜的特化常量变体；每个变体的 pipeline 只在第一次使用时创建
+     */
+    fun setQualityLevel(level: Int) {
+        if (!isInitialized.get()) {
+            Log.w(TAG, "Cannot set quality level - not initialized")
+            return
+        }
+
+        handler?.post {
+            filter.setQualityLevel(level)
+            nativeInvalidateDamage(damageTracker)
+        }
+    }
+
+    /**
+     * 上一帧实际着色的像素比例 [0, 1]，1 表示整帧重绘
+     */
+    fun getShadedFraction(): Float {
+        if (!isInitialized.get()) {
+            return 1f
+        }
+        return nativeGetShadedFraction(damageTracker)
+    }
+
+    // 一个 scope 最近若干帧的 GPU 时间（毫秒）
+    data class GpuScopeTiming(
+        val name: String,
+        val samples: Int,
+        val lastMs: Double,
+        val minMs: Double,
+        val avgMs: Double,
+        val p99Ms: Double,
+        // 以 shaderStatistics 启动且设备支持 pipeline 统计查询时，最近若干帧的平均值；
+        // 外层 scope（"frame"、"prepare"、"render_pass"）不统计，statisticsSamples 为 0
+        val statisticsSamples: Int = 0,
+        val fragmentInvocations: Double = 0.0,
+        val computeInvocations: Double = 0.0,
+        val clippingPrimitives: Double = 0.0,
+        // 片元着色器调用次数 / 输出像素数：全屏滤镜约为 1，明显更大说明有 overdraw
+        val overdraw: Double = 0.0
+    )
+
+    /**
+     * 以 gpuProfiling 启动时各个 scope 的滚动统计："frame"（整个命令缓冲）、"prepare"、"render_pass"、
+     * "filter:<类名>"、"transfer"、"compute"、"upload"，以及滤镜图的 "graph pass N"。
+     * 没有启用或设备不支持 timestamp 时返回空列表
+     */
+    fun getGpuProfile(): List<GpuScopeTiming> {
+        if (!isInitialized.get() || !gpuProfilerEnabled) {
+            return emptyList()
+        }
+        val names = nativeGetGpuProfileNames(vkDevice) ?: return emptyList()
+        val values = nativeGetGpuProfileValues(vkDevice) ?: return emptyList()
+        // scope 只会追加，两次调用之间新增的 scope 忽略
+        val pixels = surfaceSize.width.toDouble() * surfaceSize.height
+        return (0 until minOf(names.size, values.size / GPU_PROFILE_PER_SCOPE)).map { i ->
+            val base = i * GPU_PROFILE_PER_SCOPE
+            GpuScopeTiming(
+                names[i],
+                values[base].toInt(),
+                values[base + 1],
+                values[base + 2],
+                values[base + 3],
+                values[base + 4],
+                statisticsSamples = values[base + 5].toInt(),
+                fragmentInvocations = values[base + 6],
+                computeInvocations = values[base + 7],
+                clippingPrimitives = values[base + 8],
+                overdraw = if (pixels > 0) values[base + 6] / pixels else 0.0
+            )
+        }
+    }
+
+    // pipeline 的一个可执行体（通常是一个着色器阶段）的驱动统计；驱动没有提供的项为 -1
+    data class ShaderExecutableStats(
+        val pipeline: Long,
+        val kind: String,        // "graphics" / "compute"
+        val executable: String,  // 例如 "Fragment Shader"
+        val registers: Long,
+        val spills: Long,
+        val details: String      // 驱动给出的全部统计 "name=value, ..."
+    )
+
+    /**
+     * 以 shaderStatistics 启动且设备支持 VK_KHR_pipeline_executable_properties 时，
+     * 按创建顺序返回所有 pipeline 的可执行体统计；否则返回空列表
+     */
+    fun getShaderExecutableStats(): List<ShaderExecutableStats> {
+        if (!isInitialized.get() || !shaderStatistics) {
+            return emptyList()
+        }
+        val strings = nativeGetPipelineExecutableStrings(vkDevice) ?: return emptyList()
+        val values = nativeGetPipelineExecutableValues(vkDevice) ?: return emptyList()
+        return (0 until minOf(strings.size / 3, values.size / 3)).map { i ->
+            ShaderExecutableStats(
+                pipeline = values[i * 3],
+                kind = strings[i * 3],
+                executable = strings[i * 3 + 1],
+                registers = values[i * 3 + 1],
+                spills = values[i * 3 + 2],
+                details = strings[i * 3 + 2]
+            )
+        }
+    }
+
+    // 一项帧统计的分布（毫秒），来自固定大小的对数直方图，分位数的相对误差在 3% 以内
+    data class FrameTiming(
+        val count: Long,
+        val minMs: Double,
+        val avgMs: Double,
+        val p50Ms: Double,
+        val p90Ms: Double,
+        val p99Ms: Double,
+        val maxMs: Double
+    )
+
+    /**
+     * 帧统计快照（见 Vulkanframestats.h），从创建设备或上次 [resetFrameStats] 起累计。
+     * droppedFrames = 被更新输入覆盖的输入帧 + acquire 失败 + present OUT_OF_DATE/错误；
+     * inputToPresent 从 updateInputTexture/updateTextureColor 调用或 SurfaceTexture 帧回调算起，
+     * 到 vkQueuePresentKHR 返回；gpu 只在以 gpuProfiling 启动时有数据
+     */
+    data class FrameStats(
+        val presentedFrames: Long,
+        val elapsedSeconds: Double,
+        val fps: Double,
+        val inputFrames: Long,
+        val coalescedInputs: Long,
+        val acquireFailures: Long,
+        val presentSuboptimal: Long,
+        val presentOutOfDate: Long,
+        val presentErrors: Long,
+        val droppedFrames: Long,
+        val fenceWait: FrameTiming,
+        val acquireWait: FrameTiming,
+        val cpuRecord: FrameTiming,
+        val cpuSubmit: FrameTiming,
+        val present: FrameTiming,
+        val gpu: FrameTiming,
+        val inputToPresent: FrameTiming,
+        val frameInterval: FrameTiming
+    )
+
+    // 只在调用时分配；渲染路径上的统计不分配内存
+    fun getFrameStats(): FrameStats? {
+        if (!isInitialized.get()) {
+            return null
+        }
+        val v = nativeGetFrameStats(vkDevice) ?: return null
+        fun timing(index: Int): FrameTiming {
+            val base = FRAME_STATS_HEADER + index * FRAME_STATS_PER_METRIC
+            return FrameTiming(v[base].toLong(), v[base + 1], v[base + 2], v[base + 3],
+                v[base + 4], v[base + 5], v[base + 6])
+        }
+        return FrameStats(
+            presentedFrames = v[0].toLong(),
+            elapsedSeconds = v[1],
+            fps = v[2],
+            inputFrames = v[3].toLong(),
+            coalescedInputs = v[4].toLong(),
+            acquireFailures = v[5].toLong(),
+            presentSuboptimal = v[6].toLong(),
+            presentOutOfDate = v[7].toLong(),
+            presentErrors = v[8].toLong(),
+            droppedFrames = v[9].toLong(),
+            fenceWait = timing(0),
+            acquireWait = timing(1),
+            cpuRecord = timing(2),
+            cpuSubmit = timing(3),
+            present = timing(4),
+            gpu = timing(5),
+            inputToPresent = timing(6),
+            frameInterval = timing(7)
+        )
+    }
+
+    fun resetFrameStats() {
+        if (isInitialized.get()) {
+            nativeResetFrameStats(vkDevice)
+        }
+    }
+
+    // statistics 为 false：scope 内还有其他 scope（pipeline 统计查询不能嵌套）
+    private fun beginGpuScope(commandBuffer: Long, name: String, statistics: Boolean = true): Int {
+        if (!gpuProfilerEnabled) return -1
+        val id = gpuScopeIds.getOrPut(name) { nativeGpuScopeId(vkDevice, name, statistics) }
+        return nativeBeginGpuScope(vkDevice, commandBuffer, id)
+    }
+
+    private fun beginFilterGpuScope(commandBuffer: Long, active: VulkanFilter): Int {
+        if (!gpuProfilerEnabled) return -1
+        val id = filterScopeIds.getOrPut(active) {
+            nativeGpuScopeId(vkDevice, "filter:" + active.javaClass.simpleName, true)
+        }
+        return nativeBeginGpuScope(vkDevice, commandBuffer, id)
+    }
+
+    private fun endGpuScope(commandBuffer: Long, token: Int) {
+        if (token >= 0) {
+            nativeEndGpuScope(vkDevice, commandBuffer, token)
+        }
+    }
+
+    // 帧命令缓冲的结尾：先写入整帧 timestamp
+    private fun endFrameCommandBuffer(commandBuffer: Long) {
+        if (gpuProfilerEnabled) {
+            nativeEndGpuFrame(vkDevice, commandBuffer)
+        }
+        nativeEndCommandBuffer(commandBuffer)
+    }
+
+    private fun addInputDamageInternal(dirtyRects: IntArray) {
+        var i = 0
+        while (i + 3 < dirtyRects.size) {
+            nativeAddInputDamage(
+                damageTracker,
+                dirtyRects[i],
+                dirtyRects[i + 1],
+                dirtyRects[i + 2],
+                dirtyRects[i + 3]
+            )
+            i += 4
+        }
+    }
+
+
+
+
+    private fun logPipelineCacheStats() {
+        // [warm, pipelinesCreated, totalCreateMs, loadedBytes]
+        // 设备随 runner 重建，pipeline registry 不跨重启：重启后 pipeline 仍会重新创建，
+        // 只是从磁盘缓存命中（"warm cache hit"），创建耗时应明显低于首次启动
+        val stats = nativeGetPipelineCacheStats(vkDevice)
+        Log.i(TAG, "Pipelines: %d created in %.2f ms (%s, %d bytes cached)".format(
+            stats[1].toInt(), stats[2], if (stats[0] != 0.0) "warm cache hit" else "cold cache", stats[3].toLong()))
+    }
+
+    private fun createRenderPasses() {
+        vkRenderPass = nativeCreateRenderPass(vkDevice)
+        if (!validateHandle(vkRenderPass, "RenderPass")) {
+            cleanup()
+            throw VulkanException("Failed to create render pass")
+        }
+
+        // 与 vkRenderPass 兼容（仅 loadOp 不同），可共用 framebuffer 和 pipeline
+        vkLoadRenderPass = nativeCreateLoadRenderPass(vkDevice)
+        if (!validateHandle(vkLoadRenderPass, "LoadRenderPass")) {
+            cleanup()
+            throw VulkanException("Failed to create load render pass")
+        }
+
+        if (!nativeCreateFramebuffers(vkDevice, vkSwapchain, vkRenderPass)) {
+            cleanup()
+            throw VulkanException("Failed to create framebuffers")
+        }
+        Log.d(TAG, "✓ Framebuffers created")
+    }
+
+    // 整帧重绘用 CLEAR，否则 LOAD 保留图像中未变化的内容
+    private fun beginOutputPass(commandBuffer: Long, imageIndex: Int, load: Boolean) {
+        if (dynamicRendering) {
+            nativeBeginRendering(vkDevice, commandBuffer, vkSwapchain, imageIndex, load)
+        } else {
+            nativeBeginRenderPass(
+                commandBuffer,
+                if (load) vkLoadRenderPass else vkRenderPass,
+                imageIndex,
+                vkSwapchain
+            )
+        }
+    }
+
+    private fun endOutputPass(commandBuffer: Long, imageIndex: Int) {
+        if (dynamicRendering) {
+            nativeEndRendering(vkDevice, commandBuffer, vkSwapchain, imageIndex)
+        } else {
+            nativeEndRenderPass(commandBuffer)
+        }
+    }
 
     private fun validateHandle(handle: Long, resourceName: String): Boolean {
         return if (handle == 0L) {
@@ -255,8 +643,34 @@ class VulkanRunner @JvmOverloads constructor(
         }
 
         try {
+            // Get transform matrix
+            val matrix: FloatArray = if (overrideTransformMatrix != null) {
+                overrideTransformMatrix
+            } else {
+                nativeGetTextureTransformMatrix(inputTexture)
+            }
+
+            val active = activeFilter()
+
+            // 变换改变时 tracker 会自动整帧失效
+            nativeSetDamageTransform(damageTracker, active.damageTransform(matrix))
+            if (active.isAnimated()) {
+                nativeInvalidateDamage(damageTracker)
+            }
+
+            // 没有任何变化：不获取图像，不提交，不 present
+            if (!nativeHasPendingDamage(damageTracker)) {
+                skippedFrames++
+                return
+            }
+
+            // trace：整帧（等待 fence 到 present）和录制两个 CPU scope，其余在 native 侧记录
+            val frameBegin = if (VulkanTrace.isEnabled) System.nanoTime() else 0L
+
             // Wait for the previous frame to finish
             nativeWaitForFence(vkDevice, inFlightFences[currentFrame])
+            // 之后滤镜才能复用 MAX_FRAMES_IN_FLIGHT 帧之前绑定过的 descriptor set
+            nativeBeginDescriptorFrame(vkDevice, MAX_FRAMES_IN_FLIGHT)
 
             // Acquire next image
             val result = nativeAcquireNextImageWithSemaphore(
@@ -277,7 +691,11 @@ class VulkanRunner @JvmOverloads constructor(
             nativeResetFence(vkDevice, inFlightFences[currentFrame])
 
             // Record command buffer
-            recordCommandBuffer(imageIndex, outputSize)
+            val recordBegin = if (frameBegin != 0L) System.nanoTime() else 0L
+            recordCommandBuffer(active, imageIndex, outputSize, matrix)
+            if (recordBegin != 0L) {
+                VulkanTrace.event(TRACE_RECORD, recordBegin, System.nanoTime())
+            }
 
             // Submit command buffer
             nativeSubmitCommandBufferWithSync(
@@ -288,66 +706,277 @@ class VulkanRunner @JvmOverloads constructor(
                 inFlightFences[currentFrame]
             )
 
-            // Present
-            val timestamp = nativeGetTextureTimestamp(inputTexture)
-            nativePresentImageWithSyncAndTimestamp(
+            // Present (附带脏区域，设备支持 VK_KHR_incremental_present 时生效)
+            nativePresentImageWithDamage(
                 vkDevice,
                 vkSwapchain,
                 imageIndex,
                 renderFinishedSemaphores[currentFrame],
-                timestamp
+                damageTracker
             )
 
             currentFrame = (currentFrame + 1) % MAX_FRAMES_IN_FLIGHT
+            if (frameBegin != 0L) {
+                VulkanTrace.event(TRACE_FRAME, frameBegin, System.nanoTime())
+            }
+
+            if (!firstFramePresented) {
+                firstFramePresented = true
+                Log.i(TAG, "First frame presented %.1f ms after start (%s)".format(
+                    elapsedSinceStartMs(), if (active === filter) "filter" else "placeholder"))
+            }
+
+            shadedFractionSum += nativeGetShadedFraction(damageTracker)
+            renderedFrames++
+            if (renderedFrames % 300 == 0) {
+                Log.i(TAG, "Damage: avg shaded %.1f%% over %d frames, %d skipped, %d via copy/blit".format(
+                    shadedFractionSum * 100.0 / renderedFrames, renderedFrames, skippedFrames, transferFrames))
+            }
 
         } catch (e: Exception) {
             Log.e(TAG, "Error rendering frame", e)
         }
     }
 
-    private fun recordCommandBuffer(imageIndex: Int, outputSize: Size) {
+    // 滤镜的 pipeline 编译完成前用直通滤镜绘制；切换时整帧重绘
+    private fun activeFilter(): VulkanFilter {
+        if (!filterReady && filter.isReady()) {
+            filterReady = true
+            nativeInvalidateDamage(damageTracker)
+            Log.i(TAG, "Filter pipelines ready %.1f ms after start".format(elapsedSinceStartMs()))
+            logPipelineCacheStats()
+        }
+        return if (filterReady) filter else placeholder ?: filter
+    }
+
+    // 输入静止时没有帧回调触发 render()，编译完成后主动重绘一次
+    private fun pollFilterReady(outputSize: Size) {
+        handler?.postDelayed(object : Runnable {
+            override fun run() {
+                if (stopped || !isInitialized.get() || filterReady) {
+                    return
+                }
+                if (filter.isReady()) {
+                    render(outputSize)
+                } else {
+                    handler?.postDelayed(this, READY_POLL_INTERVAL_MS)
+                }
+            }
+        }, READY_POLL_INTERVAL_MS)
+    }
+
+    private fun elapsedSinceStartMs(): Double = (System.nanoTime() - startTimeNanos) / 1_000_000.0
+
+    private fun recordCommandBuffer(active: VulkanFilter, imageIndex: Int, outputSize: Size, matrix: FloatArray) {
         val commandBuffer = vkCommandBuffers[imageIndex]
 
+        // [full, x0, y0, w0, h0, ...]
+        val damage = nativeBeginDamageFrame(damageTracker, vkSwapchain, imageIndex)
+        val fullFrame = damage.isEmpty() || damage[0] != 0
+
         // Reset and begin command buffer
         nativeResetCommandBuffer(commandBuffer)
         nativeBeginCommandBuffer(commandBuffer)
-
-        // Set viewport
-        nativeSetViewport(commandBuffer, 0, 0, outputSize.width, outputSize.height)
-
-        // Begin render pass
-        nativeBeginRenderPass(commandBuffer, vkRenderPass, imageIndex, vkSwapchain)
+        if (gpuProfilerEnabled) {
+            // 查询按 in-flight 槽位轮换：该槽位的 fence 刚等待过，上次的结果已经可读
+            nativeBeginGpuFrame(vkDevice, commandBuffer, currentFrame)
+        }
 
         // Get texture image view
         val textureImageView = nativeGetTextureImageView(inputTexture)
         if (textureImageView == 0L) {
             Log.e(TAG, "Invalid texture image view!")
-            nativeEndRenderPass(commandBuffer)
-            nativeEndCommandBuffer(commandBuffer)
+            // 仍然需要一个 pass 把图像转换到 PRESENT_SRC 布局
+            nativeSetViewport(commandBuffer, 0, 0, outputSize.width, outputSize.height)
+            beginOutputPass(commandBuffer, imageIndex, load = false)
+            endOutputPass(commandBuffer, imageIndex)
+            endFrameCommandBuffer(commandBuffer)
+            nativeInvalidateDamage(damageTracker)
             return
         }
 
-        // Get transform matrix
-        val matrix: FloatArray = if (overrideTransformMatrix != null) {
-            overrideTransformMatrix
-        } else {
-            nativeGetTextureTransformMatrix(inputTexture)
+        // 缩放/翻转/整数裁剪：不经过 pipeline，直接 copy/blit 到交换链图像
+        if (recordTransferCommands(active, commandBuffer, imageIndex, matrix, damage, fullFrame)) {
+            return
+        }
+
+        if (computeOutput != 0L && active === filter && filter.isComputeReady()) {
+            recordComputeCommands(commandBuffer, textureImageView, imageIndex, outputSize, matrix, damage, fullFrame)
+            return
         }
 
+        // 离屏 pass（例如动态分辨率）必须在交换链 render pass 之外录制
+        val prepareScope = beginGpuScope(commandBuffer, "prepare", statistics = false)
+        active.prepare(commandBuffer, textureImageView, matrix)
+        endGpuScope(commandBuffer, prepareScope)
+
+        // Set viewport (prepare 可能修改了 viewport/scissor)
+        nativeSetViewport(commandBuffer, 0, 0, outputSize.width, outputSize.height)
+
+        // Begin render pass / dynamic rendering
+        val passScope = beginGpuScope(commandBuffer, "render_pass", statistics = false)
+        beginOutputPass(commandBuffer, imageIndex, load = !fullFrame)
+
         // Draw with filter
-        filter.draw(commandBuffer, textureImageView, matrix)
+        val filterScope = beginFilterGpuScope(commandBuffer, active)
+        if (fullFrame) {
+            active.draw(commandBuffer, textureImageView, matrix)
+        } else {
+            // 每个脏矩形一次 draw，scissor 限制着色范围
+            var i = 1
+            while (i + 3 < damage.size) {
+                nativeSetScissor(commandBuffer, damage[i], damage[i + 1], damage[i + 2], damage[i + 3])
+                active.draw(commandBuffer, textureImageView, matrix)
+                i += 4
+            }
+        }
+        endGpuScope(commandBuffer, filterScope)
 
         // End render pass and command buffer
-        nativeEndRenderPass(commandBuffer)
-        nativeEndCommandBuffer(commandBuffer)
+        endOutputPass(commandBuffer, imageIndex)
+        endGpuScope(commandBuffer, passScope)
+        endFrameCommandBuffer(commandBuffer)
     }
 
-    fun stopAndRelease() {
-        val sem = Semaphore(0)
+    // 快速路径：滤镜给出的变换是轴对齐的、边界落在整数像素上时由 native 录制 copy/blit，
+    // 返回 false 表示什么都没有录制（需要旋转/错切，或设备不支持），照常走 pipeline
+    private fun recordTransferCommands(
+        active: VulkanFilter,
+        commandBuffer: Long,
+        imageIndex: Int,
+        matrix: FloatArray,
+        damage: IntArray,
+        fullFrame: Boolean
+    ): Boolean {
+        val transform = active.transferTransform(matrix)
+        val textureImage = if (transform != null) nativeGetTextureImage(inputTexture) else 0L
+        val path = if (transform == null || textureImage == 0L) {
+            TRANSFER_SHADER
+        } else {
+            val rects = if (fullFrame) null else damage.copyOfRange(1, damage.size)
+            val scope = beginGpuScope(commandBuffer, "transfer")
+            val recorded = nativeRecordTransfer(vkDevice, commandBuffer, vkSwapchain, imageIndex, textureImage,
+                inputWidth, inputHeight, transform, !fullFrame, rects)
+            endGpuScope(commandBuffer, scope)
+            recorded
+        }
 
-        handler!!.post {
-            stopped = true
-            cleanup()
+        if (path != transferPath) {
+            Log.i(TAG, "Output path: ${transferPathName(transferPath)} -> ${transferPathName(path)}")
+            transferPath = path
+        }
+        if (path == TRANSFER_SHADER) {
+            return false
+        }
+        endFrameCommandBuffer(commandBuffer)
+        transferFrames++
+        return true
+    }
+
+    private fun transferPathName(path: Int): String = when (path) {
+        TRANSFER_COPY -> "copy"
+        TRANSFER_BLIT -> "blit"
+        else -> "shader"
+    }
+
+    // 计算路径：不开 render pass，滤镜按脏矩形 dispatch 写输出图像
+    private fun recordComputeCommands(
+        commandBuffer: Long,
+        textureImageView: Long,
+        imageIndex: Int,
+        outputSize: Size,
+        matrix: FloatArray,
+        damage: IntArray,
+        fullFrame: Boolean
+    ) {
+        val rects = if (fullFrame) {
+            intArrayOf(0, 0, outputSize.width, outputSize.height)
+        } else {
+            damage.copyOfRange(1, damage.size)
+        }
+
+        val scope = beginGpuScope(commandBuffer, "compute")
+        val outputView = nativeBeginComputeOutput(vkDevice, commandBuffer, vkSwapchain, imageIndex,
+            computeOutput, !fullFrame)
+        if (outputView != 0L) {
+            filter.dispatch(commandBuffer, textureImageView, matrix, outputView, rects)
+        } else {
+            nativeInvalidateDamage(damageTracker)
+        }
+        nativeEndComputeOutput(vkDevice, commandBuffer, vkSwapchain, imageIndex, computeOutput,
+            !fullFrame, rects)
+        endGpuScope(commandBuffer, scope)
+        endFrameCommandBuffer(commandBuffer)
+    }
+
+    /**
+     * 基准测试（[VulkanBenchmarks]）看到的 runner 状态：当前设备、render pass、滤镜和输入纹理。
+     * 只在 [runBenchmark] 的回调里（渲染线程上）有效
+     */
+    internal inner class BenchmarkTarget {
+        val device: Long get() = vkDevice
+        val renderPass: Long get() = vkRenderPass
+        val filter: VulkanFilter get() = this@VulkanRunner.filter
+        val inputWidth: Int get() = this@VulkanRunner.inputWidth
+        val inputHeight: Int get() = this@VulkanRunner.inputHeight
+        val surfaceSize: Size get() = this@VulkanRunner.surfaceSize
+        val inputImageView: Long get() = nativeGetTextureImageView(inputTexture)
+        val transformMatrix: FloatArray
+            get() = overrideTransformMatrix ?: nativeGetTextureTransformMatrix(inputTexture)
+
+        fun waitIdle() = nativeDeviceWaitIdle(vkDevice)
+
+        // 测试自己的纹理，调用方负责 destroyTexture
+        fun createInputTexture(width: Int, height: Int, mipmapped: Boolean): Long =
+            nativeCreateInputTexture(vkDevice, width, height, mipmapped)
+        fun uploadTexture(texture: Long, data: ByteArray) = nativeUpdateInputTexture(vkDevice, texture, data)
+        fun textureImageView(texture: Long): Long = nativeGetTextureImageView(texture)
+        fun textureMipLevels(texture: Long): Int = nativeGetTextureMipLevels(texture)
+        fun recordTextureMips(texture: Long, commandBuffer: Long) = nativeRecordTextureMips(vkDevice, texture, commandBuffer)
+        fun destroyTexture(texture: Long) = nativeDestroyTexture(vkDevice, texture)
+    }
+
+    /**
+     * 在渲染线程上运行一次基准测试，阻塞直到完成；未启动或已停止时不运行，返回 null。
+     * 开始前等待渲染循环的帧执行完，结束后恢复滤镜的输出尺寸并整帧重绘
+     */
+    @Throws(VulkanException::class)
+    internal fun <T> runBenchmark(block: (BenchmarkTarget) -> T): T? {
+        if (!isInitialized.get()) {
+            Log.w(TAG, "Cannot run benchmark - not initialized")
+            return null
+        }
+        return runOnRenderThread {
+            if (stopped) {
+                null
+            } else {
+                nativeDeviceWaitIdle(vkDevice)
+                try {
+                    block(BenchmarkTarget())
+                } finally {
+                    nativeDeviceWaitIdle(vkDevice)
+                    filter.setSurfaceSize(surfaceSize.width, surfaceSize.height)
+                    nativeInvalidateDamage(damageTracker)
+                }
+            }
+        }
+    }
+
+    /**
+     * 在渲染线程上执行 [block] 并阻塞等待结果，[block] 抛出的异常原样抛给调用方。
+     * 已经在渲染线程上时直接执行：post 之后再等待自己会死锁
+     */
+    @Throws(VulkanException::class)
+    internal fun <T> runOnRenderThread(block: () -> T): T {
+        val renderHandler = handler ?: throw VulkanException("Vulkan runner thread not started")
+        if (renderHandler.looper.isCurrentThread) {
+            return block()
+        }
+
+        val sem = Semaphore(0)
+        var result: Result<T>? = null
+        renderHandler.post {
+            result = runCatching(block)
             sem.release()
         }
 
@@ -355,6 +984,15 @@ class VulkanRunner @JvmOverloads constructor(
             sem.acquire()
         } catch (e: InterruptedException) {
             Thread.currentThread().interrupt()
+            throw VulkanException("Interrupted while waiting for the Vulkan runner thread", e)
+        }
+        return result!!.getOrThrow()
+    }
+
+    fun stopAndRelease() {
+        runOnRenderThread {
+            stopped = true
+            cleanup()
         }
     }
 
@@ -375,12 +1013,15 @@ class VulkanRunner @JvmOverloads constructor(
             nativeDeviceWaitIdle(vkDevice)
         }
 
-        // Release filter
+        // Release filter（取消或等待后台编译任务）
         try {
             filter.release()
+            placeholder?.release()
         } catch (e: Exception) {
             Log.e(TAG, "Error releasing filter", e)
         }
+        filterReady = false
+        firstFramePresented = false
 
         // Destroy synchronization objects
         if (inFlightFences.isNotEmpty()) {
@@ -403,6 +1044,10 @@ class VulkanRunner @JvmOverloads constructor(
             nativeDestroyTexture(vkDevice, it)
         }
 
+        destroyResource(damageTracker, "DamageTracker") {
+            nativeDestroyDamageTracker(it)
+        }
+
         // Free command buffers
         if (vkCommandBuffers.isNotEmpty()) {
             nativeFreeCommandBuffers(vkDevice, vkCommandPool, vkCommandBuffers)
@@ -413,12 +1058,22 @@ class VulkanRunner @JvmOverloads constructor(
         destroyResource(vkCommandPool, "CommandPool") {
             nativeDestroyCommandPool(vkDevice, it)
         }
+        destroyResource(computeOutput, "ComputeOutput") {
+            nativeDestroyComputeOutput(vkDevice, it)
+        }
         destroyResource(vkSwapchain, "Swapchain") {
             nativeDestroySwapchain(vkDevice, it)
         }
         destroyResource(vkRenderPass, "RenderPass") {
             nativeDestroyRenderPass(vkDevice, it)
         }
+        destroyResource(vkLoadRenderPass, "LoadRenderPass") {
+            nativeDestroyRenderPass(vkDevice, it)
+        }
+        // 写回 pipeline 缓存（所有 pipeline 已创建完毕）
+        destroyResource(vkDevice, "PipelineCache") {
+            nativeDestroyPipelineCache(it)
+        }
         destroyResource(vkDevice, "Device") {
             nativeDestroyDevice(it)
         }
@@ -428,9 +1083,16 @@ class VulkanRunner @JvmOverloads constructor(
 
         // Reset handles
         inputTexture = 0
+        damageTracker = 0
         vkCommandPool = 0
         vkSwapchain = 0
+        computeOutput = 0
         vkRenderPass = 0
+        vkLoadRenderPass = 0
+        dynamicRendering = false
+        gpuProfilerEnabled = false
+        gpuScopeIds.clear()
+        filterScopeIds.clear()
         vkDevice = 0
         vkInstance = 0
 
@@ -465,8 +1127,18 @@ class VulkanRunner @JvmOverloads constructor(
     // ========== Native Methods ==========
 
     private external fun nativeCreateInstance(): Long
-    private external fun nativeCreateDevice(instance: Long, surface: Surface): Long
+    private external fun nativeCreateDevice(
+        instance: Long,
+        surface: Surface,
+        allowDynamicRendering: Boolean,
+        shaderStatistics: Boolean
+    ): Long
+    private external fun nativeIsDynamicRenderingEnabled(device: Long): Boolean
+    private external fun nativeCreatePipelineCache(device: Long, path: String?): Boolean
+    private external fun nativeDestroyPipelineCache(device: Long)
+    private external fun nativeGetPipelineCacheStats(device: Long): DoubleArray
     private external fun nativeCreateRenderPass(device: Long): Long
+    private external fun nativeCreateLoadRenderPass(device: Long): Long
     private external fun nativeCreateSwapchain(device: Long, surface: Surface): Long
     private external fun nativeCreateCommandPool(device: Long): Long
     private external fun nativeCreateFramebuffers(
@@ -494,16 +1166,21 @@ class VulkanRunner @JvmOverloads constructor(
     private external fun nativeCreateInputTexture(
         device: Long,
         width: Int,
-        height: Int
+        height: Int,
+        mipmapped: Boolean
     ): Long
 
     private external fun nativeCreateSurfaceFromTexture(texture: Long): Surface?
     private external fun nativeSetFrameCallback(texture: Long, callback: (() -> Unit)?)
     private external fun nativeGetTextureImageView(texture: Long): Long
+    private external fun nativeGetTextureImage(texture: Long): Long
+    private external fun nativeGetTextureMipLevels(texture: Long): Int
+    private external fun nativeRecordTextureMips(device: Long, texture: Long, commandBuffer: Long)
     private external fun nativeGetTextureTransformMatrix(texture: Long): FloatArray
     private external fun nativeGetTextureTimestamp(texture: Long): Long
 
     private external fun nativeWaitForFence(device: Long, fence: Long)
+    private external fun nativeBeginDescriptorFrame(device: Long, framesInFlight: Int)
     private external fun nativeResetFence(device: Long, fence: Long)
 
     private external fun nativeAcquireNextImageWithSemaphore(
@@ -528,6 +1205,19 @@ class VulkanRunner @JvmOverloads constructor(
         swapchain: Long
     )
     private external fun nativeEndRenderPass(commandBuffer: Long)
+    private external fun nativeBeginRendering(
+        device: Long,
+        commandBuffer: Long,
+        swapchain: Long,
+        imageIndex: Int,
+        load: Boolean
+    )
+    private external fun nativeEndRendering(
+        device: Long,
+        commandBuffer: Long,
+        swapchain: Long,
+        imageIndex: Int
+    )
     private external fun nativeEndCommandBuffer(commandBuffer: Long)
 
     private external fun nativeSubmitCommandBufferWithSync(
@@ -546,6 +1236,45 @@ class VulkanRunner @JvmOverloads constructor(
         timestamp: Long
     )
 
+    // ========== Damage Tracking ==========
+
+    private external fun nativeCreateDamageTracker(
+        swapchain: Long,
+        inputWidth: Int,
+        inputHeight: Int
+    ): Long
+    private external fun nativeDestroyDamageTracker(tracker: Long)
+    private external fun nativeSetDamageTransform(tracker: Long, matrix: FloatArray?)
+    private external fun nativeAddInputDamage(
+        tracker: Long,
+        x: Int,
+        y: Int,
+        width: Int,
+        height: Int
+    )
+    private external fun nativeInvalidateDamage(tracker: Long)
+    private external fun nativeHasPendingDamage(tracker: Long): Boolean
+    private external fun nativeBeginDamageFrame(
+        tracker: Long,
+        swapchain: Long,
+        imageIndex: Int
+    ): IntArray
+    private external fun nativeGetShadedFraction(tracker: Long): Float
+    private external fun nativeSetScissor(
+        commandBuffer: Long,
+        x: Int,
+        y: Int,
+        width: Int,
+        height: Int
+    )
+    private external fun nativePresentImageWithDamage(
+        device: Long,
+        swapchain: Long,
+        imageIndex: Int,
+        waitSemaphore: Long,
+        tracker: Long
+    )
+
     private external fun nativeDeviceWaitIdle(device: Long)
 
     private external fun nativeDestroySyncObjects(
@@ -562,13 +1291,85 @@ class VulkanRunner @JvmOverloads constructor(
     )
     private external fun nativeDestroyCommandPool(device: Long, commandPool: Long)
     private external fun nativeDestroySwapchain(device: Long, swapchain: Long)
+    private external fun nativeRequestComputeOutput(device: Long, enabled: Boolean)
+    private external fun nativeCreateComputeOutput(device: Long, swapchain: Long): Long
+    private external fun nativeDestroyComputeOutput(device: Long, output: Long)
+    private external fun nativeBeginComputeOutput(
+        device: Long,
+        commandBuffer: Long,
+        swapchain: Long,
+        imageIndex: Int,
+        output: Long,
+        load: Boolean
+    ): Long
+    private external fun nativeEndComputeOutput(
+        device: Long,
+        commandBuffer: Long,
+        swapchain: Long,
+        imageIndex: Int,
+        output: Long,
+        load: Boolean,
+        rects: IntArray?
+    )
+    // 返回 TRANSFER_*；TRANSFER_SHADER 表示没有录制任何命令
+    private external fun nativeRecordTransfer(
+        device: Long,
+        commandBuffer: Long,
+        swapchain: Long,
+        imageIndex: Int,
+        textureImage: Long,
+        textureWidth: Int,
+        textureHeight: Int,
+        matrix: FloatArray,
+        load: Boolean,
+        rects: IntArray?
+    ): Int
     private external fun nativeDestroyRenderPass(device: Long, renderPass: Long)
+
+    // ========== GPU Profiler ==========
+
+    private external fun nativeEnableGpuProfiler(device: Long, framesInFlight: Int): Boolean
+    private external fun nativeBeginGpuFrame(device: Long, commandBuffer: Long, frameSlot: Int)
+    private external fun nativeEndGpuFrame(device: Long, commandBuffer: Long)
+    private external fun nativeGpuScopeId(device: Long, name: String, statistics: Boolean): Int
+    private external fun nativeBeginGpuScope(device: Long, commandBuffer: Long, scopeId: Int): Int
+    private external fun nativeEndGpuScope(device: Long, commandBuffer: Long, token: Int)
+    private external fun nativeGetGpuProfileNames(device: Long): Array<String>?
+    private external fun nativeGetGpuProfileValues(device: Long): DoubleArray?
+
+    // ========== Shader Statistics ==========
+
+    private external fun nativeGetPipelineExecutableStrings(device: Long): Array<String>?
+    private external fun nativeGetPipelineExecutableValues(device: Long): LongArray?
+
+    // ========== Frame Stats ==========
+
+    private external fun nativeMarkFrameInput(device: Long, timeNanos: Long)
+    private external fun nativeResetFrameStats(device: Long)
+    private external fun nativeGetFrameStats(device: Long): DoubleArray?
+
     private external fun nativeDestroyDevice(device: Long)
     private external fun nativeDestroyInstance(instance: Long)
 
     companion object {
         private const val TAG = "VulkanRunner"
         private const val MAX_FRAMES_IN_FLIGHT = 2
+        private const val PIPELINE_CACHE_FILE = "vulkan_pipeline_cache.bin"
+        private const val READY_POLL_INTERVAL_MS = 16L
+
+        // VulkanTrace 事件名
+        private val TRACE_FRAME = VulkanTrace.name("frame")
+        private val TRACE_RECORD = VulkanTrace.name("record")
+
+        // nativeGetFrameStats 的布局：10 个汇总值，之后每项 7 个值（FrameMetric 顺序）
+        private const val FRAME_STATS_HEADER = 10
+        private const val FRAME_STATS_PER_METRIC = 7
+        private const val GPU_PROFILE_PER_SCOPE = 9  // 与 nativeGetGpuProfileValues 一致
+
+        // 与 Vulkantransfer.h 中的 TransferPath 一致
+        private const val TRANSFER_SHADER = 0
+        private const val TRANSFER_COPY = 1
+        private const val TRANSFER_BLIT = 2
 
         private var handlerThread: HandlerThread? = null
         private var handler: Handler? = null
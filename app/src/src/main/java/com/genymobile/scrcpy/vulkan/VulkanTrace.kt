@@ -0,0 +1,58 @@
+package com.genymobile.scrcpy.vulkan
+
+import java.io.File
+
+/**
+ * 进程级的 CPU + GPU 时间线记录器（见 Vulkantrace.h），导出为 Chrome trace JSON，
+ * 可以直接拖进 chrome://tracing 或 ui.perfetto.dev。
+ *
+ * 一直编译在内，默认关闭；关闭时 [event] 只读一个 volatile 标志。native 侧的 scope（wait_fence、
+ * acquire、submit、present、upload、后台编译）和 GPU profiler 的 scope 自动记录，GPU 轨道需要
+ * runner 以 gpuProfiling 启动并且设备支持 VK_EXT_calibrated_timestamps。
+ *
+ * 使用示例：
+ * ```
+ * VulkanTrace.start()
+ * // ... 运行几秒 ...
+ * VulkanTrace.stop()
+ * VulkanTrace.dump(File(context.cacheDir, "vulkan_trace.json"))
+ * ```
+ */
+object VulkanTrace {
+    @Volatile
+    var isEnabled = false
+        private set
+
+    fun start() {
+        nativeStart()
+        isEnabled = true
+    }
+
+    fun stop() {
+        isEnabled = false
+        nativeStop()
+    }
+
+    // 可以在记录进行中调用；返回 false 表示文件写入失败
+    fun dump(file: File): Boolean = nativeDump(file.absolutePath)
+
+    // 事件名句柄：登记一次，之后每次 [event] 不再传字符串
+    fun name(name: String): Long = nativeName(name)
+
+    // 时间为 System.nanoTime()（与 native 侧同为 CLOCK_MONOTONIC）
+    fun event(name: Long, beginNanos: Long, endNanos: Long) {
+        if (isEnabled) {
+            nativeEvent(name, beginNanos, endNanos)
+        }
+    }
+
+    private external fun nativeStart()
+    private external fun nativeStop()
+    private external fun nativeDump(path: String): Boolean
+    private external fun nativeName(name: String): Long
+    private external fun nativeEvent(name: Long, beginNanos: Long, endNanos: Long)
+
+    init {
+        System.loadLibrary("myapplication")
+    }
+}
@@ -0,0 +1,94 @@
+package com.genymobile.scrcpy.vulkan
+
+import org.junit.Test
+
+import org.junit.Assert.*
+
+/**
+ * ResolutionGovernor 策略测试，使用合成的 GPU 时间序列
+ */
+class ResolutionGovernorTest {
+    @Test
+    fun overBudget_scalesDownAfterConsecutiveFrames() {
+        val governor = ResolutionGovernor(frameBudgetMs = 10.0)
+
+        assertEquals(1.0f, governor.update(20.0), 0f)
+        assertEquals(1.0f, governor.update(20.0), 0f)
+        // 第 3 帧：load = 2.0，按 scale² 估算 sqrt(0.8 / 2.0) ≈ 0.632，量化到 1/32
+        assertEquals(0.625f, governor.update(20.0), 1e-6f)
+    }
+
+    @Test
+    fun singleSpike_isIgnored() {
+        val governor = ResolutionGovernor(frameBudgetMs = 10.0)
+
+        repeat(10) { governor.update(5.0) }
+        governor.update(30.0)
+        repeat(10) { governor.update(5.0) }
+
+        assertEquals(1.0f, governor.scale, 0f)
+    }
+
+    @Test
+    fun underBudget_scalesUpSlowly() {
+        val governor = ResolutionGovernor(frameBudgetMs = 10.0)
+
+        var frames = 0
+        while (governor.scale > governor.minScale && frames < 100) {
+            governor.update(40.0)
+            frames++
+        }
+        assertEquals(governor.minScale, governor.scale, 0f)
+
+        // 冷却 + 连续 30 帧低负载之前不升
+        repeat(20) { governor.update(1.0) }
+        assertEquals(governor.minScale, governor.scale, 0f)
+
+        repeat(200) { governor.update(1.0) }
+        assertEquals(governor.maxScale, governor.scale, 0f)
+    }
+
+    @Test
+    fun pixelCostModel_convergesWithoutOscillation() {
+        val budget = 16.6
+        val governor = ResolutionGovernor(frameBudgetMs = budget)
+
+        // GPU 时间与像素数成正比：全分辨率 30ms
+        fun gpuTime(scale: Float) = 30.0 * scale * scale
+
+        repeat(100) { governor.update(gpuTime(governor.scale)) }
+        val settled = governor.scale
+        assertTrue(settled < 1.0f)
+
+        var changes = 0
+        var last = settled
+        repeat(500) {
+            val scale = governor.update(gpuTime(governor.scale))
+            if (scale != last) changes++
+            last = scale
+        }
+        assertEquals(0, changes)
+
+        val load = gpuTime(settled) / budget
+        assertTrue("load $load should be inside the hysteresis band", load > 0.6 && load < 0.95)
+    }
+
+    @Test
+    fun invalidSamples_areIgnored() {
+        val governor = ResolutionGovernor()
+
+        governor.update(-1.0)
+        governor.update(Double.NaN)
+
+        assertEquals(1.0f, governor.scale, 0f)
+        assertEquals(0.0, governor.smoothedGpuTimeMs, 0.0)
+    }
+
+    @Test
+    fun scaledLength_neverZero() {
+        val governor = ResolutionGovernor(minScale = 0.25f)
+
+        assertEquals(1920, governor.scaledLength(1920))
+        assertEquals(1, governor.scaledLength(1))
+    }
+}